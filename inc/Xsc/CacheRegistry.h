@@ -0,0 +1,166 @@
+/*
+ * CacheRegistry.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_CACHE_REGISTRY_H
+#define XSC_CACHE_REGISTRY_H
+
+
+#include "Export.h"
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+
+namespace Xsc
+{
+
+
+/**
+\brief Base class of all caches whose memory is governed by the cache registry.
+\remarks A managed cache registers itself on construction and reports every stored and removed
+entry to the registry, which maintains the per-cache accounts against the global memory budget.
+When the budget is exceeded, the registry assigns each cache the number of bytes it must free;
+the cache settles this eviction debt at the begin of its next store operation on its owning
+thread, by removing its least recently used entries (cooperative eviction, so the registry never
+mutates a cache from a foreign thread).
+\see CacheRegistry
+*/
+class XSC_EXPORT ManagedCache
+{
+
+    public:
+
+        virtual ~ManagedCache() = default;
+
+        /* --- Internal use by the cache registry --- */
+
+        //! Returns the display name of this cache (used in the cache accounts).
+        virtual const char* CacheName() const = 0;
+
+        //! Evicts the least recently used entries until at least the specified number of bytes is freed, or the cache is empty.
+        virtual void EvictOldest(std::size_t bytesToFree) = 0;
+
+};
+
+/**
+\brief Registry over all long-lived caches, with a global memory budget and LRU/priority eviction.
+\remarks Without a budget every cache grows unbounded, which is fine for batch compilations but not
+for a long-lived server process. The registry keeps per-cache byte and entry accounts, and once the
+total exceeds the configured budget, it distributes the excess as eviction debts over the caches:
+caches with a lower eviction priority (i.e. cheaper to refill, such as the include file cache) are
+drained first, and each cache evicts its own least recently used entries. The accounts can be
+queried for stats reporting (e.g. the "stats" control line of the server mode prints them).
+\see ManagedCache
+\see CompileCache
+\see MemoryOutputCache
+*/
+class XSC_EXPORT CacheRegistry
+{
+
+    public:
+
+        //! Accounting figures of one registered cache.
+        struct CacheAccount
+        {
+            //! Display name of the cache.
+            std::string name;
+
+            //! Eviction priority of the cache (caches with a lower priority are drained first).
+            int         evictionPriority    = 0;
+
+            //! Current number of entries in the cache.
+            std::size_t numEntries          = 0;
+
+            //! Current number of accounted bytes of the cache.
+            std::size_t numBytes            = 0;
+
+            //! Total number of entries evicted from the cache due to the memory budget.
+            std::size_t numEvictions        = 0;
+        };
+
+        CacheRegistry(const CacheRegistry&) = delete;
+        CacheRegistry& operator = (const CacheRegistry&) = delete;
+
+        //! Returns the process-wide registry instance.
+        static CacheRegistry& Instance();
+
+        //! Sets the global memory budget (in bytes) over all registered caches; 0 means unbounded, which is the default.
+        void SetMemoryBudget(std::size_t maxBytes);
+
+        //! Returns the global memory budget in bytes (0 if unbounded).
+        std::size_t MemoryBudget() const;
+
+        //! Returns the current total number of accounted bytes over all registered caches.
+        std::size_t TotalBytes() const;
+
+        //! Returns the accounting figures of all registered caches, in registration order.
+        std::vector<CacheAccount> QueryAccounts() const;
+
+        /* --- Internal use by the managed caches --- */
+
+        //! Registers the specified cache with its eviction priority (caches with a lower priority are drained first).
+        void Register(ManagedCache& cache, int evictionPriority);
+
+        //! Unregisters the specified cache and drops its account.
+        void Unregister(ManagedCache& cache);
+
+        //! Returns the next value of the global access counter, used to stamp cache entries for the LRU order.
+        std::uint64_t NextAccessTick();
+
+        //! Accounts a stored cache entry of the specified size, and re-distributes the eviction debts if the budget is exceeded.
+        void AddEntry(ManagedCache& cache, std::size_t numBytes);
+
+        //! Accounts a removed cache entry of the specified size ('evicted' distinguishes budget evictions from regular removals).
+        void RemoveEntry(ManagedCache& cache, std::size_t numBytes, bool evicted);
+
+        //! Drops the entry and byte account of the specified cache (e.g. after its "Clear" function).
+        void ClearEntries(ManagedCache& cache);
+
+        //! Evicts the pending eviction debt of the specified cache, if it has one (called by the cache on its owning thread).
+        void SettleEvictionDebt(ManagedCache& cache);
+
+    private:
+
+        //! Account record of one registered cache.
+        struct CacheRecord
+        {
+            ManagedCache*   cache               = nullptr;
+            int             evictionPriority    = 0;
+            std::size_t     numEntries          = 0;
+            std::size_t     numBytes            = 0;
+            std::size_t     numEvictions        = 0;
+            std::size_t     evictionDebtBytes   = 0;
+        };
+
+        CacheRegistry() = default;
+
+        CacheRecord* FindRecord(ManagedCache& cache);
+
+        //! Distributes the bytes above the budget as eviction debts over the caches (must be called with the mutex locked).
+        void AssignEvictionDebts();
+
+        mutable std::mutex          mutex_;
+        std::vector<CacheRecord>    records_;
+        std::atomic<std::uint64_t>  accessTick_ { 0 };
+        std::size_t                 maxBytes_   = 0;
+        std::size_t                 totalBytes_ = 0;
+
+};
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
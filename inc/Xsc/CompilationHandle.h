@@ -0,0 +1,70 @@
+/*
+ * CompilationHandle.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_COMPILATION_HANDLE_H
+#define XSC_COMPILATION_HANDLE_H
+
+
+#include "Export.h"
+
+#include <memory>
+
+
+namespace Xsc
+{
+
+
+/**
+\brief Handle for an asynchronous compilation (see CompileShaderAsync).
+\remarks The handle is copyable; all copies refer to the same compilation.
+A default constructed handle refers to no compilation and behaves like a finished, failed one.
+\see CompileShaderAsync
+*/
+class XSC_EXPORT CompilationHandle
+{
+
+    public:
+
+        CompilationHandle() = default;
+
+        CompilationHandle(const CompilationHandle&) = default;
+        CompilationHandle& operator = (const CompilationHandle&) = default;
+
+        //! Blocks until the compilation has finished, and returns its result (false if it failed or was cancelled).
+        bool Wait();
+
+        //! Returns true if the compilation has finished (successfully, with errors, or cancelled).
+        bool Finished() const;
+
+        //! Requests cancellation; a running compilation stops at the next pass boundary, a pending one is not started.
+        void Cancel();
+
+        //! Returns true if cancellation has been requested (see Cancel).
+        bool Cancelled() const;
+
+        /* --- Internal use by the compiler --- */
+
+        //! Shared state between the handle and the background compilation job.
+        struct State;
+
+        explicit CompilationHandle(const std::shared_ptr<State>& state);
+
+    private:
+
+        std::shared_ptr<State> state_;
+
+};
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,100 @@
+/*
+ * CompileCache.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_COMPILE_CACHE_H
+#define XSC_COMPILE_CACHE_H
+
+
+#include "Export.h"
+#include "CacheRegistry.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+
+
+namespace Xsc
+{
+
+
+/**
+\brief Opt-in cache for repeated compilations, e.g. when several entry points are compiled from the same source file.
+\remarks Pass an instance via "ShaderInput::cache" and keep it alive across "CompileShader" calls.
+Entries are keyed on a content hash of the source code (which covers pre-defined macros written into the source),
+and are validated against the content hashes of the include closure before they are used.
+This class is not thread-safe; use one instance per thread.
+The memory of all instances is governed by the global cache registry (see CacheRegistry).
+\see ShaderInput::cache
+\see CacheRegistry
+*/
+class XSC_EXPORT CompileCache : public ManagedCache
+{
+
+    public:
+
+        CompileCache();
+        ~CompileCache();
+
+        CompileCache(const CompileCache&) = delete;
+        CompileCache& operator = (const CompileCache&) = delete;
+
+        //! Reference to an included file: filename, content hash, and whether search paths were preferred.
+        struct IncludeReference
+        {
+            std::string     filename;
+            std::uint64_t   contentHash         = 0;
+            bool            useSearchPathsFirst = false;
+        };
+
+        //! Cache entry for a preprocessed source: include closure, defined macros, and preprocessor output.
+        struct PreProcessedSource
+        {
+            std::vector<IncludeReference>   includes;
+            std::vector<std::string>        macros;
+            std::string                     output;
+        };
+
+        //! Removes all entries from the cache.
+        void Clear();
+
+        /* --- Internal use by the compiler --- */
+
+        //! Returns the cached preprocessed source for the specified source content hash, or null if there is no such entry.
+        const PreProcessedSource* FetchPreProcessedSource(std::uint64_t sourceHash) const;
+
+        //! Stores the preprocessed source for the specified source content hash.
+        void StorePreProcessedSource(std::uint64_t sourceHash, PreProcessedSource&& entry);
+
+        /* --- Internal use by the cache registry --- */
+
+        const char* CacheName() const override;
+        void EvictOldest(std::size_t bytesToFree) override;
+
+    private:
+
+        //! Cache entry with its accounting figures (the access stamp maintains the LRU order, see CacheRegistry).
+        struct Entry
+        {
+            PreProcessedSource      source;
+            std::size_t             numBytes    = 0;
+            mutable std::uint64_t   lastAccess  = 0;
+        };
+
+        std::map<std::uint64_t, Entry> preProcessedSources_;
+
+};
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,84 @@
+/*
+ * CompilerContext.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_COMPILER_CONTEXT_H
+#define XSC_COMPILER_CONTEXT_H
+
+
+#include "Export.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+
+namespace Xsc
+{
+
+
+/**
+\brief Persistent context for incremental recompilation, e.g. for hot-reloading shaders in an editor.
+\remarks Pass an instance to the "CompileShader" overload that takes a context, and keep it alive across calls.
+The context retains a content hash per top-level declaration of the preprocessed code, together with the
+generated output of the last successful compilation. When none of the declarations changed (i.e. only white
+spaces or commentaries were edited), the retained output is written out directly and the entire parsing,
+analysis, and code generation is skipped.
+This class is not thread-safe; use one instance per compiled shader permutation (entry point and output version).
+\see CompileShader
+*/
+class XSC_EXPORT CompilerContext
+{
+
+    public:
+
+        //! Removes all retained state from the context.
+        void Clear();
+
+        //! Returns the number of top-level declarations that changed in the last compilation call (zero when the retained output was reused).
+        inline std::size_t NumChangedDeclarations() const
+        {
+            return numChangedDeclarations_;
+        }
+
+        /* --- Internal use by the compiler --- */
+
+        /**
+        \brief Returns true if the specified configuration and declaration hashes match the retained state, i.e. the retained output is up-to-date.
+        \remarks As a side effect, the number of changed declarations is updated (see NumChangedDeclarations).
+        */
+        bool MatchDeclarationHashes(std::uint64_t configHash, const std::vector<std::uint64_t>& declHashes);
+
+        //! Returns the retained output code of the last successful compilation.
+        inline const std::string& RetainedOutput() const
+        {
+            return outputCode_;
+        }
+
+        //! Stores the configuration hash, declaration hashes, and output code of a successful compilation.
+        void StoreCompilation(std::uint64_t configHash, std::vector<std::uint64_t>&& declHashes, std::string&& outputCode);
+
+    private:
+
+        std::uint64_t               configHash_             = 0;
+        std::vector<std::uint64_t>  declHashes_;
+        std::string                 outputCode_;
+
+        std::size_t                 numChangedDeclarations_ = 0;
+        bool                        valid_                  = false;
+
+};
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
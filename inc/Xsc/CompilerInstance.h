@@ -0,0 +1,66 @@
+/*
+ * CompilerInstance.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_COMPILER_INSTANCE_H
+#define XSC_COMPILER_INSTANCE_H
+
+
+#include "Export.h"
+#include "Xsc.h"
+
+#include <memory>
+
+
+namespace Xsc
+{
+
+
+/**
+\brief Reusable compiler instance that retains internal allocations across compilation calls.
+\remarks The free "CompileShader" function sets up and tears down its internal memory
+(the per-compile arena pages and the string interning table) on every call. For services that
+issue many small compilations in a row (e.g. an in-engine compile server during shader iteration),
+this instance retains that memory and rewinds it between calls instead of reconstructing it.
+This class is not thread-safe; use one instance per thread.
+\see CompileShader
+*/
+class XSC_EXPORT CompilerInstance
+{
+
+    public:
+
+        CompilerInstance();
+        ~CompilerInstance();
+
+        CompilerInstance(const CompilerInstance&) = delete;
+        CompilerInstance& operator = (const CompilerInstance&) = delete;
+
+        //! Equivalent to the free "CompileShader" function, but reuses the retained memory of this instance.
+        bool CompileShader(const ShaderInput& inputDesc, const ShaderOutput& outputDesc, Log* log = nullptr);
+
+        //! Equivalent to the free "CompileShader" overload with a compiler context, but reuses the retained memory of this instance.
+        bool CompileShader(const ShaderInput& inputDesc, const ShaderOutput& outputDesc, Log* log, CompilerContext& context);
+
+        //! Releases all memory retained across compilation calls.
+        void Clear();
+
+    private:
+
+        struct State;
+        std::unique_ptr<State> state_;
+
+};
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
@@ -67,7 +67,8 @@ class ScopedColor
     
         /**
         \brief Constructor with output stream and front color flags.
-        \param[in,out] stream Specifies the output stream for which the scope is to be changed. This is only used for Unix systems.
+        \param[in,out] stream Specifies the output stream for which the scope is to be changed.
+        On Unix systems the color codes are embedded into this stream; on Windows it is flushed before the console state changes.
         \param[in] front Specifies the front color flags. This can be a bitwise OR combination of the entries of the ColorFlags enumeration.
         \see ColorFlags
         \see PushColor(std::ostream&, long)
@@ -80,7 +81,8 @@ class ScopedColor
 
         /**
         \brief Constructor with output stream, and front- and back color flags.
-        \param[in,out] stream Specifies the output stream for which the scope is to be changed. This is only used for Unix systems.
+        \param[in,out] stream Specifies the output stream for which the scope is to be changed.
+        On Unix systems the color codes are embedded into this stream; on Windows it is flushed before the console state changes.
         \param[in] front Specifies the front color flags. This can be a bitwise OR combination of the entries of the ColorFlags enumeration.
         \param[in] back Specifies the back color flags. This can be a bitwise OR combination of the entries of the ColorFlags enumeration.
         \see ColorFlags
@@ -38,7 +38,35 @@ class XSC_EXPORT IncludeHandler
         \return Unique pointer to the new input stream.
         */
         virtual std::unique_ptr<std::istream> Include(const std::string& filename, bool useSearchPathsFirst);
-        
+
+        /**
+        \brief Invalidates the process-lifetime include-file cache of the default implementation.
+        \param[in] path Specifies the file path whose cache entry is to be removed.
+        If this is empty, the entire cache is cleared. By default empty.
+        \remarks Call this when include files may have changed on disk, e.g. in long-running editor sessions.
+        */
+        static void InvalidateCache(const std::string& path = "");
+
+        /**
+        \brief Registers an in-memory virtual file for the default implementation, consulted before the filesystem.
+        \param[in] path Specifies the file path to overlay. It must equal the path the compiler resolves for the
+        include directive, i.e. the plain include name or the name joined with one of the search paths.
+        \param[in] content Specifies the file content.
+        \remarks Use this e.g. to compile unsaved editor buffers without writing temporary files.
+        This function is thread safe, and replacing a buffer does not disturb running compiles:
+        they keep reading the snapshot they fetched, while subsequent include resolutions see the new content.
+        \see RemoveVirtualFile
+        */
+        static void SetVirtualFile(const std::string& path, std::string content);
+
+        /**
+        \brief Removes a virtual file again, so the path is resolved on the filesystem.
+        \param[in] path Specifies the file path whose virtual file is to be removed.
+        If this is empty, all virtual files are removed. By default empty.
+        \see SetVirtualFile
+        */
+        static void RemoveVirtualFile(const std::string& path = "");
+
         //! List of search paths.
         std::vector<std::string> searchPaths;
 
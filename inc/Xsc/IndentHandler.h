@@ -11,7 +11,8 @@
 
 #include "Export.h"
 #include <string>
-#include <stack>
+#include <vector>
+#include <cstddef>
 
 
 namespace Xsc
@@ -21,9 +22,9 @@ namespace Xsc
 //! Indentation handler base class.
 class XSC_EXPORT IndentHandler
 {
-    
+
     public:
-        
+
         IndentHandler(const std::string& initialIndent = std::string(2, ' '));
 
         //! Sets the next indentation string. By default two spaces.
@@ -38,14 +39,20 @@ class XSC_EXPORT IndentHandler
         //! Returns the current full indentation string.
         inline const std::string& FullIndent() const
         {
-            return indentFull_;
+            return indentTable_[indentLevel_];
         }
 
     private:
 
-        std::string                         indent_;
-        std::string                         indentFull_;
-        std::stack<std::string::size_type>  indentStack_;
+        std::string                 indent_;
+
+        /**
+        \brief Materialized indentation prefix for each indentation level.
+        \remarks The table grows on demand and is rebuilt when the indentation string changes,
+        so each emitted line reuses a precomputed prefix string instead of assembling one.
+        */
+        std::vector<std::string>    indentTable_;
+        std::size_t                 indentLevel_    = 0;
 
 };
 
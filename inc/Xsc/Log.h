@@ -13,6 +13,9 @@
 #include "Report.h"
 #include <vector>
 #include <string>
+#include <mutex>
+#include <unordered_map>
+#include <cstddef>
 
 
 namespace Xsc
@@ -62,24 +65,44 @@ class XSC_EXPORT Log
 
 };
 
-//! Standard output log (uses std::cout to submit a report).
+/**
+\brief Standard output log (uses std::cout to submit a report).
+\remarks Reports can be submitted concurrently from multiple threads.
+They are buffered per log instance, and "PrintAll" writes each flush to the standard
+output as one uninterrupted block, so the reports of concurrent compilation units
+do not interleave when every unit uses its own log instance.
+The indentation functions are not synchronized and must only be used by the thread that owns the log.
+*/
 class XSC_EXPORT StdLog : public Log
 {
 
     public:
 
-        //! Implements the base class interface.
+        //! Implements the base class interface. This function is thread safe.
         void SumitReport(const Report& report) override;
 
         //! Prints all submitted reports to the standard output.
         void PrintAll(bool verbose = true, bool warnings = true);
 
+        /**
+        \brief Enables or disables report deduplication. By default disabled.
+        \remarks When enabled, a report whose type, context, and message equal an already buffered report
+        only increments the occurrence count of that report, instead of being buffered again.
+        The count is printed together with the report, e.g. when the permutations
+        of one shader all raise the same warning from a shared header.
+        */
+        inline void SetReportDeduplication(bool enabled)
+        {
+            dedupReports_ = enabled;
+        }
+
     private:
 
         struct IndentReport
         {
             std::string indent;
             Report      report;
+            std::size_t occurrences;
         };
 
         using IndentReportList = std::vector<IndentReport>;
@@ -91,6 +114,12 @@ class XSC_EXPORT StdLog : public Log
         IndentReportList warnings_;
         IndentReportList errors_;
 
+        std::mutex       reportMutex_;
+
+        //! Maps a report key onto the index of its first occurrence in the respective report list (see SetReportDeduplication).
+        std::unordered_map<std::string, std::size_t> dedupIndices_;
+        bool             dedupReports_ = false;
+
 };
 
 
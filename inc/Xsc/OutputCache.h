@@ -0,0 +1,127 @@
+/*
+ * OutputCache.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_OUTPUT_CACHE_H
+#define XSC_OUTPUT_CACHE_H
+
+
+#include "Export.h"
+#include "CacheRegistry.h"
+
+#include <string>
+#include <map>
+#include <cstdint>
+
+
+namespace Xsc
+{
+
+
+/**
+\brief Content-addressed store interface for the end-to-end output cache.
+\remarks Pass an implementation via "ShaderInput::outputCache" and keep it alive across "CompileShader" calls.
+The compiler consults the store before any compilation stage runs, keyed on a 64-bit fingerprint over the
+source code, the predefined macro set, the entry point, and all output settings that influence the generated
+code. Entries are opaque binary blobs containing the generated GLSL, the reflection data, and the content
+hashes of the include closure (which are re-validated on every hit, so edits to headers invalidate entries).
+A store may evict entries at any time; eviction only costs a recompilation.
+\see ShaderInput::outputCache
+\see MemoryOutputCache
+\see FileOutputCache
+*/
+class XSC_EXPORT OutputCacheStore
+{
+
+    public:
+
+        virtual ~OutputCacheStore() = default;
+
+        //! Fetches the entry for the specified key into the output blob. Returns false if there is no such entry.
+        virtual bool Fetch(std::uint64_t key, std::string& entry) = 0;
+
+        //! Stores the entry blob for the specified key (replacing any previous entry).
+        virtual void Store(std::uint64_t key, const std::string& entry) = 0;
+
+};
+
+/**
+\brief In-memory output cache store, e.g. for repeated compilations within one build process.
+\remarks This class is not thread-safe; use one instance per thread, or synchronize externally.
+The memory of all instances is governed by the global cache registry (see CacheRegistry).
+\see OutputCacheStore
+\see CacheRegistry
+*/
+class XSC_EXPORT MemoryOutputCache : public OutputCacheStore, public ManagedCache
+{
+
+    public:
+
+        MemoryOutputCache();
+        ~MemoryOutputCache();
+
+        MemoryOutputCache(const MemoryOutputCache&) = delete;
+        MemoryOutputCache& operator = (const MemoryOutputCache&) = delete;
+
+        bool Fetch(std::uint64_t key, std::string& entry) override;
+        void Store(std::uint64_t key, const std::string& entry) override;
+
+        //! Removes all entries from the cache.
+        void Clear();
+
+        /* --- Internal use by the cache registry --- */
+
+        const char* CacheName() const override;
+        void EvictOldest(std::size_t bytesToFree) override;
+
+    private:
+
+        //! Cache entry with its access stamp for the LRU order (see CacheRegistry).
+        struct Entry
+        {
+            std::string     blob;
+            std::uint64_t   lastAccess  = 0;
+        };
+
+        std::map<std::uint64_t, Entry> entries_;
+
+};
+
+/**
+\brief On-disk output cache store, e.g. for incremental builds across processes.
+\remarks Each entry is stored as one file in the cache directory, named by the hexadecimal key.
+The directory must already exist; a failed read or write only costs a recompilation.
+\see OutputCacheStore
+*/
+class XSC_EXPORT FileOutputCache : public OutputCacheStore
+{
+
+    public:
+
+        //! Specifies the directory where the entry files are stored.
+        FileOutputCache(const std::string& directory);
+
+        bool Fetch(std::uint64_t key, std::string& entry) override;
+        void Store(std::uint64_t key, const std::string& entry) override;
+
+    private:
+
+        //! Returns the filename for the specified entry key.
+        std::string EntryPath(std::uint64_t key) const;
+
+        std::string directory_;
+
+};
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
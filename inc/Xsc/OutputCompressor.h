@@ -0,0 +1,60 @@
+/*
+ * OutputCompressor.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_OUTPUT_COMPRESSOR_H
+#define XSC_OUTPUT_COMPRESSOR_H
+
+
+#include "Export.h"
+#include <cstddef>
+
+
+namespace Xsc
+{
+
+
+/**
+\brief Interface for a streaming compressor of the generated output code.
+\remarks Pass an implementation via "ShaderOutput::outputCompressor" to produce the compressed
+artifact directly during code generation: the code writer flushes its buffer through "WriteChunk"
+at line boundaries while generation is still running, and calls "Finish" once after the final
+chunk, so the host does not pay a second pass over the generated text. The compression scheme
+itself is host-defined (e.g. an LZ4 or zlib stream, or an archive writer that frames the chunks).
+The chunks concatenated in call order form the complete output code.
+\see ShaderOutput::outputCompressor
+*/
+class XSC_EXPORT OutputCompressor
+{
+
+    public:
+
+        virtual ~OutputCompressor();
+
+        /**
+        \brief Consumes the next chunk of generated output code.
+        \param[in] chunk Pointer to the chunk data. The pointer is only valid for the duration of the call.
+        \param[in] size Specifies the size (in bytes) of the chunk.
+        */
+        virtual void WriteChunk(const char* chunk, std::size_t size) = 0;
+
+        /**
+        \brief Finishes the compressed artifact after the final chunk (e.g. writes the end-of-stream frame).
+        \remarks Called exactly once per compilation, also when no chunk was produced. The default implementation does nothing.
+        */
+        virtual void Finish();
+
+};
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,189 @@
+/*
+ * Reflection.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_REFLECTION_H
+#define XSC_REFLECTION_H
+
+
+#include "Export.h"
+#include <string>
+#include <vector>
+#include <ostream>
+#include <istream>
+#include <cstddef>
+
+
+namespace Xsc
+{
+
+//! Shader code reflection namespace.
+namespace Reflection
+{
+
+
+//! Field of a constant buffer.
+struct Field
+{
+    //! Field identifier.
+    std::string name;
+
+    //! Field type as declared in the input code (e.g. "float4x4").
+    std::string type;
+
+    /**
+    \brief True if the field is referenced by the compiled entry point. By default true.
+    \remarks Unreferenced fields can be skipped in uniform uploads,
+    and trailing unreferenced fields can be removed from the output code.
+    \see Options::trimUniforms
+    */
+    bool        referenced = true;
+};
+
+//! Constant buffer ("cbuffer" or "tbuffer" in HLSL).
+struct ConstantBuffer
+{
+    //! Buffer identifier.
+    std::string         name;
+
+    //! Zero-based binding slot, or -1 if the buffer has no register for the compiled shader target.
+    int                 binding = -1;
+
+    //! Buffer fields in declaration order.
+    std::vector<Field>  fields;
+};
+
+//! Texture or buffer resource.
+struct Resource
+{
+    //! Resource identifier.
+    std::string name;
+
+    //! Resource type as declared in the input code (e.g. "Texture2D").
+    std::string type;
+
+    //! Zero-based binding slot, or -1 if the resource has no register for the compiled shader target.
+    int         binding = -1;
+};
+
+//! Sampler state object.
+struct Sampler
+{
+    //! Sampler identifier.
+    std::string name;
+
+    //! Zero-based binding slot, or -1 if the sampler has no register for the compiled shader target.
+    int         binding = -1;
+};
+
+//! Input or output attribute of the shader entry point.
+struct Attribute
+{
+    //! Attribute identifier.
+    std::string name;
+
+    //! Attribute type as declared in the input code (e.g. "float3").
+    std::string type;
+
+    //! HLSL semantic of the attribute (e.g. "SV_Position" or "TEXCOORD0").
+    std::string semantic;
+};
+
+/**
+\brief Estimated runtime cost metrics of one function.
+\remarks Collected over the decorated AST, so intrinsic calls are classified by their
+intrinsic ID and only functions reachable from the entry point are reported. The metrics
+are static estimates (no trip counts or occupancy), meant to gate expensive shader
+permutations in build pipelines before they reach a GPU.
+\see ReflectionData::functionCosts
+*/
+struct FunctionCost
+{
+    //! Function identifier.
+    std::string name;
+
+    //! True if this function is the compiled entry point.
+    bool        entryPoint              = false;
+
+    //! Number of arithmetic operators and cheap ALU intrinsic calls in the function body.
+    std::size_t numAluOps               = 0;
+
+    //! Number of transcendental intrinsic calls (trigonometry, exponentials, roots).
+    std::size_t numTranscendentalOps    = 0;
+
+    //! Number of texture fetch intrinsic calls (sampling and loads).
+    std::size_t numTextureFetches       = 0;
+
+    //! Number of branch decisions ('if', 'switch', and ternary conditions).
+    std::size_t numBranches             = 0;
+
+    //! Deepest loop nesting depth of the function body.
+    std::size_t maxLoopDepth            = 0;
+
+    /**
+    \brief Weighted scalar cost estimate of the function, including the cost of all called functions.
+    \remarks Loop bodies are counted once (trip counts are generally unknown); use "maxLoopDepth" to weight them.
+    */
+    std::size_t totalCost               = 0;
+};
+
+/**
+\brief Shader code reflection data structure.
+\remarks Collected from the decorated AST during code generation, so the identifiers
+match the input code and only declarations reachable from the entry point are reported.
+\see ShaderOutput::reflectionData
+*/
+struct ReflectionData
+{
+    //! Constant buffers, in declaration order.
+    std::vector<ConstantBuffer> constantBuffers;
+
+    //! Texture and buffer resources, in declaration order.
+    std::vector<Resource>       resources;
+
+    //! Sampler states, in declaration order.
+    std::vector<Sampler>        samplers;
+
+    //! Input attributes of the entry point.
+    std::vector<Attribute>      inputAttributes;
+
+    //! Output attributes of the entry point.
+    std::vector<Attribute>      outputAttributes;
+
+    //! Estimated cost metrics of all reachable functions (entry point included), in declaration order.
+    std::vector<FunctionCost>   functionCosts;
+};
+
+
+/**
+\brief Serializes the specified reflection data into a compact binary blob.
+\param[in] reflection Specifies the reflection data to serialize.
+\param[in,out] stream Specifies the binary output stream.
+\remarks The format is versioned; use "DeserializeReflection" to read the blob back.
+\see DeserializeReflection
+*/
+XSC_EXPORT void SerializeReflection(const ReflectionData& reflection, std::ostream& stream);
+
+/**
+\brief Deserializes reflection data from a binary blob (see "SerializeReflection").
+\param[in,out] stream Specifies the binary input stream.
+\param[out] reflection Specifies the output reflection data.
+\return True on success, or false if the stream does not contain a valid reflection blob.
+\see SerializeReflection
+*/
+XSC_EXPORT bool DeserializeReflection(std::istream& stream, ReflectionData& reflection);
+
+
+} // /namespace Reflection
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
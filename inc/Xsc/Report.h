@@ -13,12 +13,32 @@
 #include <stdexcept>
 #include <string>
 #include <vector>
+#include <memory>
 
 
 namespace Xsc
 {
 
 
+/**
+\brief Interface to fetch the printable source line and caret marker of a report on demand (internal use by the compiler).
+\remarks This defers the string building for the line marker until a report is actually printed,
+so reports that a log implementation filters out (e.g. warnings) never pay for it.
+\see Report::Line
+*/
+class XSC_EXPORT ReportLineMarker
+{
+
+    public:
+
+        virtual ~ReportLineMarker();
+
+        //! Fetches the source line and the marker string that highlights the report area.
+        virtual bool FetchLineMarker(std::string& line, std::string& marker) = 0;
+
+};
+
+
 //! Report exception class.
 class XSC_EXPORT Report : public std::exception
 {
@@ -38,6 +58,7 @@ class XSC_EXPORT Report : public std::exception
 
         Report(const Types type, const std::string& message, const std::string& context = "");
         Report(const Types type, const std::string& message, const std::string& line, const std::string& marker, const std::string& context = "");
+        Report(const Types type, const std::string& message, const std::shared_ptr<ReportLineMarker>& lineMarker, const std::string& context = "");
 
         //! Overrides the 'std::exception::what' function.
         const char* what() const throw() override;
@@ -63,17 +84,14 @@ class XSC_EXPORT Report : public std::exception
             return message_;
         }
 
-        //! Returns the line string where the report occured. This line never has new-line characters at its end.
-        inline const std::string& Line() const
-        {
-            return line_;
-        }
+        /**
+        \brief Returns the line string where the report occured. This line never has new-line characters at its end.
+        \remarks The line is fetched from the source code on first access (see ReportLineMarker).
+        */
+        const std::string& Line() const;
 
         //! Returns the line marker string to highlight the area where the report occured.
-        inline const std::string& Marker() const
-        {
-            return marker_;
-        }
+        const std::string& Marker() const;
 
         //! Returns the list of optional hints of the report.
         inline const std::vector<std::string>& GetHints() const
@@ -86,19 +104,21 @@ class XSC_EXPORT Report : public std::exception
         \see Line
         \see Marker
         */
-        inline bool HasLine() const
-        {
-            return (!line_.empty());
-        }
+        bool HasLine() const;
 
     private:
 
-        Types                       type_       = Types::Info;
-        std::string                 context_;
-        std::string                 message_;
-        std::string                 line_;
-        std::string                 marker_;
-        std::vector<std::string>    hints_;
+        void ResolveLineMarker() const;
+
+        Types                                       type_       = Types::Info;
+        std::string                                 context_;
+        std::string                                 message_;
+        std::vector<std::string>                    hints_;
+
+        /* Line and marker strings are fetched deferred on first access (see ResolveLineMarker) */
+        mutable std::shared_ptr<ReportLineMarker>   lineMarker_;
+        mutable std::string                         line_;
+        mutable std::string                         marker_;
 
 };
 
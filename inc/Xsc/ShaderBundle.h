@@ -0,0 +1,130 @@
+/*
+ * ShaderBundle.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_SHADER_BUNDLE_H
+#define XSC_SHADER_BUNDLE_H
+
+
+#include "Export.h"
+
+#include <string>
+#include <map>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+
+
+namespace Xsc
+{
+
+
+/**
+\brief Content-addressed archive of compiled shader outputs.
+\remarks Collects the generated code and reflection blobs of many shader permutations into a single
+archive file, instead of one file per permutation. Identical blobs are stored only once across all
+entries (permutations frequently compile to the same code), and the archive carries a sorted index,
+so a runtime loader can look up entries by name directly on a memory-mapped file (see ShaderBundleView).
+Adding an entry with an existing name replaces that entry, and "Load" merges the entries of an existing
+archive, so a bundle can be extended across tool invocations.
+\see ShaderBundleView
+*/
+class XSC_EXPORT ShaderBundle
+{
+
+    public:
+
+        //! Adds the shader entry with the specified name, generated code, and optional binary reflection blob.
+        void AddShader(const std::string& name, std::string code, std::string reflection = "");
+
+        /**
+        \brief Merges the entries of the specified archive file into this bundle.
+        \return True if the file was read and parsed successfully. A missing file is not an error
+        when 'ignoreMissingFile' is enabled (the common case of the first tool invocation).
+        */
+        bool Load(const std::string& filename, bool ignoreMissingFile = true);
+
+        //! Serializes the bundle into the specified stream (which must be opened in binary mode).
+        void Write(std::ostream& stream) const;
+
+        //! Saves the bundle to the specified archive file. Returns false if the file cannot be written.
+        bool Save(const std::string& filename) const;
+
+        //! Removes all entries from the bundle.
+        void Clear();
+
+        //! Returns the number of shader entries.
+        std::size_t NumShaders() const;
+
+        //! Returns true if the bundle has no entries.
+        bool Empty() const;
+
+    private:
+
+        //! Shader entry: generated code and binary reflection blob (may be empty).
+        struct Entry
+        {
+            std::string code;
+            std::string reflection;
+        };
+
+        //! Entries by name; the map order matches the sorted index of the archive format.
+        std::map<std::string, Entry> entries_;
+
+};
+
+/**
+\brief Zero-copy view of a serialized shader bundle, e.g. over a memory-mapped archive file.
+\remarks The view only reads the index and returns pointers into the parsed buffer, which must
+stay alive (and unmodified) for the lifetime of the view and all shader records obtained from it.
+\see ShaderBundle
+*/
+class XSC_EXPORT ShaderBundleView
+{
+
+    public:
+
+        //! Record of one shader entry; all pointers refer into the parsed buffer.
+        struct Shader
+        {
+            const char* name            = nullptr;
+            std::size_t nameSize        = 0;
+            const char* code            = nullptr;
+            std::size_t codeSize        = 0;
+            const char* reflection      = nullptr;  //!< Null if the entry has no reflection blob.
+            std::size_t reflectionSize  = 0;
+        };
+
+        //! Parses the archive index in the specified buffer. Returns false for a malformed or truncated archive.
+        bool Parse(const char* data, std::size_t size);
+
+        //! Returns the number of shader entries, or 0 if no archive was parsed.
+        std::size_t NumShaders() const;
+
+        //! Fetches the shader entry at the specified index (in name order). Returns false if the index is out of bounds.
+        bool GetShader(std::size_t index, Shader& shader) const;
+
+        //! Fetches the shader entry with the specified name (binary search). Returns false if there is no such entry.
+        bool FindShader(const std::string& name, Shader& shader) const;
+
+    private:
+
+        const char*     data_       = nullptr;
+        std::size_t     size_       = 0;
+        std::uint32_t   numShaders_ = 0;
+        std::uint32_t   numBlobs_   = 0;
+
+};
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,145 @@
+/*
+ * ShaderJob.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_SHADER_JOB_H
+#define XSC_SHADER_JOB_H
+
+
+#include "Export.h"
+#include "Xsc.h"
+#include "CompileCache.h"
+#include "Report.h"
+#include "Log.h"
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <istream>
+#include <cstdint>
+
+
+namespace Xsc
+{
+
+
+/**
+\brief Self-contained description of one compilation, for distributing shader builds across machines.
+\remarks A job carries the source text, the input and output settings, and the fingerprints of the
+source and its include closure; the include files themselves are not shipped. A worker with the
+include tree on disk validates the fingerprints before compiling, so a stale tree fails loudly
+instead of producing output from outdated headers. Jobs and results travel in a versioned binary
+format (see EncodeShaderJob and EncodeShaderJobResult).
+\see ExecuteShaderJob
+*/
+struct ShaderJob
+{
+    //! Filename of the input shader code (a hint for reports, like ShaderInput::filename).
+    std::string                                 filename;
+
+    //! Complete HLSL source text of the job.
+    std::string                                 source;
+
+    //! Input shader version. By default InputShaderVersion::HLSL5.
+    InputShaderVersion                          inputVersion        = InputShaderVersion::HLSL5;
+
+    //! HLSL shader entry point.
+    std::string                                 entryPoint;
+
+    //! Target shader (Vertex, Fragment etc.). By default ShaderTarget::Undefined.
+    ShaderTarget                                shaderTarget        = ShaderTarget::Undefined;
+
+    //! Predefined macros, defined before pre-processing starts (see ShaderInput::predefinedMacros).
+    std::vector<PredefinedMacro>                predefinedMacros;
+
+    //! Include search paths, resolved against the include tree of the executing worker.
+    std::vector<std::string>                    searchPaths;
+
+    //! Output shader version. By default OutputShaderVersion::GLSL.
+    OutputShaderVersion                         outputVersion       = OutputShaderVersion::GLSL;
+
+    //! Output code formatting descriptor.
+    Formatting                                  formatting;
+
+    //! Additional options to configure the code generation.
+    Options                                     options;
+
+    /**
+    \brief Fingerprint over the source text and the predefined macro set (see ShaderJobFingerprint). By default 0 (unchecked).
+    \remarks Fill this when emitting a job; the executing worker recomputes and compares it,
+    so a corrupted or mismatched job fails before any compilation stage runs.
+    */
+    std::uint64_t                               sourceFingerprint   = 0;
+
+    /**
+    \brief Expected include closure of the job: filenames and content hashes. By default empty (unchecked).
+    \remarks The executing worker re-hashes each file from its local include tree and refuses the job
+    on a mismatch, so remote caches stay warm without re-shipping the include tree on every job.
+    */
+    std::vector<CompileCache::IncludeReference> includes;
+};
+
+/**
+\brief Result blob of one executed shader job.
+\see ExecuteShaderJob
+*/
+struct ShaderJobResult
+{
+    //! True if the job compiled successfully.
+    bool                succeeded = false;
+
+    //! Generated GLSL code (empty if the job failed or was executed in validate-only mode).
+    std::string         code;
+
+    //! Binary reflection blob (see Reflection::SerializeReflection); may be empty.
+    std::string         reflection;
+
+    //! All reports submitted during the job, with their line markers resolved.
+    std::vector<Report> reports;
+
+    //! Output statistics of the job. Static sampler states are not transported by the result format.
+    Statistics          statistics;
+};
+
+/**
+\brief Returns the source fingerprint of the specified job: a 64-bit hash over the source text and the predefined macro set.
+\see ShaderJob::sourceFingerprint
+*/
+XSC_EXPORT std::uint64_t ShaderJobFingerprint(const ShaderJob& job);
+
+//! Serializes the job into the specified stream (which must be opened in binary mode).
+XSC_EXPORT void EncodeShaderJob(const ShaderJob& job, std::ostream& stream);
+
+//! Deserializes a job from the specified stream. Returns false for a malformed, truncated, or unsupported-version stream.
+XSC_EXPORT bool DecodeShaderJob(ShaderJob& job, std::istream& stream);
+
+//! Serializes the job result into the specified stream (which must be opened in binary mode).
+XSC_EXPORT void EncodeShaderJobResult(const ShaderJobResult& result, std::ostream& stream);
+
+//! Deserializes a job result from the specified stream. Returns false for a malformed, truncated, or unsupported-version stream.
+XSC_EXPORT bool DecodeShaderJobResult(ShaderJobResult& result, std::istream& stream);
+
+/**
+\brief Executes the specified compile job and fills the result.
+\param[in] job Job to execute. The source fingerprint and the include closure are validated first
+(when filled in); a mismatch fails the job with an error report instead of compiling.
+\param[out] result Result of the job: output code, reflection blob, reports, and statistics.
+\param[in] log Optional pointer to an output log, which additionally receives all reports of the job.
+\return True if the job compiled successfully (same as 'result.succeeded').
+\see ShaderJob
+\see ShaderJobResult
+*/
+XSC_EXPORT bool ExecuteShaderJob(const ShaderJob& job, ShaderJobResult& result, Log* log = nullptr);
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
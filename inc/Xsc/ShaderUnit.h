@@ -0,0 +1,107 @@
+/*
+ * ShaderUnit.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_SHADER_UNIT_H
+#define XSC_SHADER_UNIT_H
+
+
+#include "Export.h"
+#include "Xsc.h"
+#include "Log.h"
+
+#include <memory>
+#include <vector>
+
+
+namespace Xsc
+{
+
+
+/**
+\brief Parsed translation unit of a shader library (see ParseShaderUnit).
+\remarks A shader unit retains the pre-processed and parsed form of one source file, so a library
+that is split across files is pre-processed, scanned, and syntax-checked only once, no matter in
+how many combinations it appears (see CompileLinkedShader). The unit owns the memory of its tokens
+and AST, so it must outlive all linked compilations that use it.
+This class is not thread-safe; do not link with the same unit from several threads concurrently.
+\see ParseShaderUnit
+\see CompileLinkedShader
+*/
+class XSC_EXPORT ShaderUnit
+{
+
+    public:
+
+        ShaderUnit();
+        ~ShaderUnit();
+
+        ShaderUnit(const ShaderUnit&) = delete;
+        ShaderUnit& operator = (const ShaderUnit&) = delete;
+
+        //! Returns the filename of the unit (as specified in the shader input descriptor).
+        const std::string& Filename() const;
+
+        /* --- Internal use by the compiler --- */
+
+        //! Retained pre-processed and parsed state of the unit.
+        struct State;
+
+        State& GetState();
+        const State& GetState() const;
+
+    private:
+
+        std::unique_ptr<State> state_;
+
+};
+
+using ShaderUnitPtr = std::unique_ptr<ShaderUnit>;
+
+/**
+\brief Pre-processes and parses the specified source file into a reusable shader unit.
+\param[in] inputDesc Input shader code descriptor. The entry point and shader target are ignored;
+only the source code, filename, pre-defined macros, and include settings are used.
+\param[in] log Optional pointer to an output log, which receives the reports of the unit
+(so syntax errors of a shared library file are reported once, not once per combination).
+\return The parsed unit, or null if pre-processing or parsing failed.
+\see CompileLinkedShader
+*/
+XSC_EXPORT ShaderUnitPtr ParseShaderUnit(const ShaderInput& inputDesc, Log* log = nullptr);
+
+/**
+\brief Cross compiles the combination of the specified shader units, as if their sources were one file.
+\param[in] units Translation units in declaration order (declarations of earlier units are visible to
+later ones). All units are analyzed in one shared symbol environment, so cross-unit references
+(functions, structures, constant buffers) resolve exactly like in a single concatenated source.
+\param[in] inputDesc Input shader code descriptor, providing the entry point and shader target.
+The source code fields are ignored; the input comes from the units.
+\param[in] outputDesc Output shader code descriptor.
+\param[in] log Optional pointer to an output log. Inherit from the "Log" class interface.
+\return True if the code has been compiled successfully.
+\remarks The combine step shares the retained token streams of the units without copying them;
+only parsing, analysis, and code generation run per combination, since both decoration and GLSL
+conversion mutate the AST in place and a decorated AST can therefore not be shared across
+combinations. Line markers of reports refer to the unit in which the report originated.
+\throws std::invalid_argument If 'units' is empty or contains a null element.
+\see ParseShaderUnit
+*/
+XSC_EXPORT bool CompileLinkedShader(
+    const std::vector<ShaderUnit*>& units,
+    const ShaderInput&              inputDesc,
+    const ShaderOutput&             outputDesc,
+    Log*                            log = nullptr
+);
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,91 @@
+/*
+ * WrapperPreamble.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_WRAPPER_PREAMBLE_H
+#define XSC_WRAPPER_PREAMBLE_H
+
+
+#include "Export.h"
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <cstddef>
+
+
+namespace Xsc
+{
+
+
+/**
+\brief Shared preamble unit of intrinsic wrapper functions.
+\remarks The code generator emits wrapper functions for special intrinsics (e.g. "clip") into every
+shader that uses them. When many shaders are compiled in a batch, the identical wrappers are duplicated
+across all outputs and re-generated each compile. With a wrapper preamble attached to the shader output
+descriptor, the generator registers each required wrapper here exactly once instead of writing it inline,
+and the preamble code is emitted into a single shared unit which is prepended to the per-shader outputs
+at load time (plain text concatenation; the wrappers are self-contained GLSL functions).
+\remarks Registration is thread-safe, so one preamble can be shared across parallel compile jobs.
+\see ShaderOutput::wrapperPreamble
+*/
+class XSC_EXPORT WrapperPreamble
+{
+
+    public:
+
+        /**
+        \brief Adds the wrapper function with the specified key (e.g. its signature) and GLSL code.
+        \return True if the wrapper was newly added, or false if the key was already registered
+        (the code of a registered wrapper is never replaced).
+        */
+        bool AddWrapper(const std::string& key, const std::string& code);
+
+        //! Returns true if a wrapper with the specified key is registered.
+        bool HasWrapper(const std::string& key) const;
+
+        /**
+        \brief Merges the wrappers of the specified preamble file into this preamble.
+        \return True if the file was read and parsed successfully. A missing file is not an error
+        when 'ignoreMissingFile' is enabled (the common case of the first tool invocation).
+        */
+        bool Load(const std::string& filename, bool ignoreMissingFile = true);
+
+        //! Writes all registered wrappers (in key order) to the specified stream.
+        void Write(std::ostream& stream) const;
+
+        //! Saves the preamble to the specified file. Returns false if the file cannot be written.
+        bool Save(const std::string& filename) const;
+
+        //! Removes all registered wrappers.
+        void Clear();
+
+        //! Returns the number of registered wrappers.
+        std::size_t NumWrappers() const;
+
+        //! Returns true if the preamble has no wrappers.
+        bool Empty() const;
+
+    private:
+
+        //! Wrapper code by key; the map order fixes the output order, so the preamble is deterministic.
+        std::map<std::string, std::string>  wrappers_;
+
+        //! Guards the wrappers against concurrent registration from parallel compile jobs.
+        mutable std::mutex                  wrappersMutex_;
+
+};
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
@@ -12,16 +12,25 @@
 #include "Export.h"
 #include "Log.h"
 #include "IncludeHandler.h"
+#include "CompileCache.h"
+#include "OutputCache.h"
+#include "OutputCompressor.h"
+#include "WrapperPreamble.h"
+#include "CompilerContext.h"
+#include "CompilationHandle.h"
 #include "Targets.h"
 #include "Version.h"
 #include "SamplerState.h"
+#include "Reflection.h"
 
 #include <string>
 #include <vector>
 #include <map>
+#include <cstddef>
 #include <istream>
 #include <ostream>
 #include <memory>
+#include <functional>
 
 
 /**
@@ -96,6 +105,16 @@ struct Formatting
 
     //! If true, the '{'-braces for an open scope gets its own line. If false, braces are written like in Java coding conventions. By default false.
     bool        newLineOpenScope    = true;
+
+    /**
+    \brief If true, the output code is minified. By default false.
+    \remarks Minified output contains no comments, no indentation, and no blank lines; new-line characters
+    are only written after preprocessor directives, and a single space is kept where adjacent tokens would
+    otherwise merge. Mangled identifiers use short generated names (e.g. "_a") instead of the 'prefix' scheme,
+    so avoid identifiers of the form "_[a-z]+" in code that is compiled with this profile. This is meant for
+    shipping builds where the GLSL source is parsed on the target device at load time.
+    */
+    bool        minify              = false;
 };
 
 //! Structure for additional translation options.
@@ -110,21 +129,56 @@ struct Options
     //! If true, only the preprocessed source code will be written out. By default false.
     bool preprocessOnly     = false;
 
-    //! If true, the source code is only validated, but no output code will be generated. By default false.
+    /**
+    \brief If true, the source code is only validated, but no output code will be generated. By default false.
+    \remarks The pipeline stops after context analysis, i.e. optimization and code generation are skipped
+    entirely; no output code, reflection data, or output statistics are produced in this mode.
+    */
     bool validateOnly       = false;
 
+    /**
+    \brief If true, only the shader metadata is extracted, but no output code will be generated. By default false.
+    \remarks The pipeline stops after context analysis, and function bodies are neither parsed nor analyzed,
+    so scanning many shaders for their metadata does not pay the full compilation cost. The metadata is
+    reported through the output statistics: sampler states, technique names, and the identifiers of all
+    global functions as entry-point candidates. The entry point of the input descriptor may name a function
+    that does not exist in this mode.
+    \see Statistics::samplerStates
+    \see Statistics::techniques
+    \see Statistics::entryPoints
+    */
+    bool metadataOnly       = false;
+
     //! If true, the shader output may contain GLSL extensions, if the target shader version is too low. By default false.
     bool allowExtensions    = false;
     
     //! If true, explicit binding slots are enabled. By default false.
     bool explicitBinding    = false;
 
+    /**
+    \brief If true, unreferenced members at the end of a constant buffer are removed from the output code. By default false.
+    \remarks Only trailing members are removed, so the offsets of the remaining members are not affected.
+    Unreferenced members in front of a referenced member are kept as padding. The reflection data still
+    reports all members together with their reference state.
+    \see Reflection::Field::referenced
+    */
+    bool trimUniforms       = false;
+
     //! If true, commentaries are preserved for each statement. By default false.
     bool preserveComments   = false;
 
     //! If true, intrinsics are prefered to be implemented as wrappers (instead of inlining). By default false.
     bool preferWrappers     = false;
 
+    /**
+    \brief If true, the output is guaranteed to be byte-identical for identical inputs. By default false.
+    \remarks This suppresses the generation timestamp comment, which is the only run-varying piece of the
+    output code; all other emission points iterate canonically ordered containers (the extension list and
+    the macro statistics are sorted, intrinsic wrappers are emitted in a fixed order). Enable this when the
+    output feeds a content-addressed cache or a reproducible-build pipeline.
+    */
+    bool deterministicOutput = false;
+
     //! If true, the AST (Abstract Syntax Tree) will be written to the log output. By default false.
     bool showAST            = false;
 
@@ -158,9 +212,115 @@ struct Statistics
 
     //! Static sampler states (identifier, states).
     std::map<std::string, SamplerState> samplerStates;
+
+    //! Technique identifiers in declaration order (only filled in metadata extraction mode; see Options::metadataOnly).
+    std::vector<std::string>            techniques;
+
+    //! Identifiers of all global functions, i.e. the entry-point candidates (only filled in metadata extraction mode; see Options::metadataOnly).
+    std::vector<std::string>            entryPoints;
+
+    /**
+    \brief Estimated output code size (in bytes), by which the output buffer was preallocated.
+    \remarks The estimate is derived from the number of AST nodes. Compare against 'actualOutputSize'
+    to verify the estimate quality (an estimate below the actual size implies buffer reallocations).
+    \see actualOutputSize
+    */
+    std::size_t                         estimatedOutputSize = 0;
+
+    //! Actual output code size (in bytes).
+    std::size_t                         actualOutputSize    = 0;
+};
+
+/**
+\brief Structure for compiler instrumentation statistics.
+\remarks In contrast to the binding oriented "Statistics" structure, these are machine readable
+performance numbers (pass timings and hot-path counters), meant to track down regression-heavy
+shaders in build telemetry.
+\see ShaderOutput::compileStats
+*/
+struct CompileStats
+{
+    //! Heap allocation counters of one compilation pass (see allocationStats).
+    struct AllocationStats
+    {
+        //! Name of the compilation pass ("preprocess", "parse", "analyze", "optimize", or "generate").
+        std::string stage;
+
+        //! Number of tracked allocations during this pass.
+        std::size_t numAllocations  = 0;
+
+        //! Number of bytes allocated during this pass.
+        std::size_t numBytes        = 0;
+
+        //! High-water mark of live tracked bytes during this pass.
+        std::size_t peakBytes       = 0;
+    };
+
+    //! Wall clock time (in microseconds) of the pre-processing pass.
+    std::uint64_t                       preProcessingTime   = 0;
+
+    //! Wall clock time (in microseconds) of the parsing pass.
+    std::uint64_t                       parsingTime         = 0;
+
+    //! Wall clock time (in microseconds) of the context analysis pass.
+    std::uint64_t                       analysisTime        = 0;
+
+    //! Wall clock time (in microseconds) of the optimization pass (0 if optimization is disabled).
+    std::uint64_t                       optimizationTime    = 0;
+
+    //! Wall clock time (in microseconds) of the code generation pass.
+    std::uint64_t                       generationTime      = 0;
+
+    //! Number of tokens scanned, accumulated over all passes (pre-processing and parsing).
+    std::size_t                         numTokens           = 0;
+
+    //! Number of macro expansions performed during pre-processing.
+    std::size_t                         macroExpansions     = 0;
+
+    //! Number of symbol table lookups performed during parsing and context analysis.
+    std::size_t                         symbolTableFetches  = 0;
+
+    //! Number of symbol table lookups served from the identifier resolution cache (see "symbolTableFetches").
+    std::size_t                         symbolTableCacheHits = 0;
+
+    //! Number of AST nodes by node type name, counted on the final AST after all compilation passes.
+    std::map<std::string, std::size_t>  astNodeCounts;
+
+    /**
+    \brief Number of bytes allocated from the per-compile memory arena.
+    \remarks This is 0 if the compiler was built without the memory pool (see XSC_ENABLE_MEMORY_POOL).
+    */
+    std::size_t                         arenaBytes          = 0;
+
+    //! Number of pages of the per-compile memory arena (0 without the memory pool).
+    std::size_t                         arenaPages          = 0;
+
+    //! Total page capacity (in bytes) of the per-compile memory arena (0 without the memory pool).
+    std::size_t                         arenaCapacityBytes  = 0;
+
+    //! Number of bytes of the generated output code.
+    std::size_t                         outputBytes         = 0;
+
+    /**
+    \brief Per-pass heap allocation counters, in pipeline order.
+    \remarks Only filled when the compiler was built with allocation tracking
+    (see the XSC_ALLOC_TRACKING build option); empty otherwise.
+    \see AllocationStats
+    */
+    std::vector<AllocationStats>        allocationStats;
 };
 
 //! Shader input descriptor structure.
+//! Predefined macro structure: equivalent to a heading '#define IDENT VALUE' line in the source code.
+struct PredefinedMacro
+{
+    //! Macro identifier.
+    std::string ident;
+
+    //! Optional macro value; may be empty.
+    std::string value;
+};
+
 struct ShaderInput
 {
     //! Specifies the filename of the input shader code. This is an optional attribute, and only a hint to the compiler.
@@ -169,6 +329,16 @@ struct ShaderInput
     //! Specifies the input stream. This must be valid HLSL code.
     std::shared_ptr<std::istream>   sourceCode;
 
+    /**
+    \brief Optional pointer to a raw source code buffer (e.g. a memory mapped file). By default null.
+    \remarks If this is non-null, it takes precedence over 'sourceCode'. No copy of the buffer is made,
+    thus it must remain valid for the entire compilation call.
+    */
+    const char*                     sourceCodeBuffer        = nullptr;
+
+    //! Specifies the size (in bytes) of the raw source code buffer (see "sourceCodeBuffer").
+    std::size_t                     sourceCodeBufferSize    = 0;
+
     //! Specifies the input shader version (e.g. InputShaderVersion::HLSL5 for "HLSL 5"). By default InputShaderVersion::HLSL5.
     InputShaderVersion              shaderVersion   = InputShaderVersion::HLSL5;
 
@@ -178,13 +348,99 @@ struct ShaderInput
     //! Specifies the target shader (Vertex, Fragment etc.). By default ShaderTarget::Undefined.
     ShaderTarget                    shaderTarget    = ShaderTarget::Undefined;
 
+    /**
+    \brief Maximum number of error reports before the current compilation pass is aborted. By default 0 (unlimited).
+    \remarks A broken common header can produce thousands of cascading errors; with a limit, the pass stops
+    cleanly once the limit is hit, and a final "too many errors" report is submitted. Warnings do not count.
+    */
+    std::size_t                     maxErrors       = 0;
+
+    /**
+    \brief Maximum wall-clock compilation time in milliseconds. By default 0 (unlimited).
+    \remarks Pathological inputs — usually machine generated shaders with deep macro recursion or
+    enormous expressions — can wedge a compilation for minutes. The budgets ('maxCompileTime',
+    'maxArenaBytes', 'maxTokens') are checked at cheap checkpoints: at the pass boundaries, and
+    amortized over the served tokens inside the frontend loops. An exceeded budget aborts the
+    compilation with a "compile budget exceeded" error report, like any other compilation error.
+    \see maxArenaBytes
+    \see maxTokens
+    */
+    std::size_t                     maxCompileTime  = 0;
+
+    /**
+    \brief Maximum number of bytes allocated from the per-compile memory arena. By default 0 (unlimited).
+    \remarks Only effective when the compiler is built with the XSC_ENABLE_MEMORY_POOL option,
+    since the arena usage counter is read from the active memory pool.
+    \see maxCompileTime
+    */
+    std::size_t                     maxArenaBytes   = 0;
+
+    /**
+    \brief Maximum number of tokens served to the frontend, whether scanned from the source or expanded from macros. By default 0 (unlimited).
+    \remarks This is the budget that stops runaway macro recursion, which produces tokens much faster than it consumes source text.
+    \see maxCompileTime
+    */
+    std::size_t                     maxTokens       = 0;
+
+    /**
+    \brief Enables the scanner/parser overlap on two threads. By default false.
+    \remarks If true, large sources are lexed on a second thread while the parser already consumes the
+    tokens, so character classification overlaps with AST construction. This helps single huge sources,
+    where compiling several files in parallel (see the shell option "--jobs") offers no parallelism.
+    Small sources are still lexed in place, since the thread start-up would outweigh the overlap.
+    */
+    bool                            concurrentLexing = false;
+
     /**
     \brief Optional pointer to the implementation of the "IncludeHandler" interface. By default null.
     \remarks If this is null, the default include handler will be used, which will include files with the STL input file streams.
     */
     IncludeHandler*                 includeHandler  = nullptr;
+
+    /**
+    \brief Optional pointer to a compilation cache, to reuse results across "CompileShader" calls. By default null.
+    \remarks This is meant for compiling several entry points or output versions from the same source.
+    \see CompileCache
+    */
+    CompileCache*                   cache           = nullptr;
+
+    /**
+    \brief Optional pointer to an end-to-end output cache store. By default null.
+    \remarks The store is consulted before any compilation stage runs, keyed on a fingerprint over the source
+    code, the predefined macro set, the entry point, and the output settings. On a hit, the cached GLSL code
+    and reflection data are written out directly (the include closure is re-validated first, so edits to
+    headers invalidate entries); output statistics are not populated on a hit. Ignored in preprocess-only
+    and validate-only mode.
+    \see OutputCacheStore
+    */
+    OutputCacheStore*               outputCache     = nullptr;
+
+    /**
+    \brief Optional list of predefined macros, defined before pre-processing starts. By default empty.
+    \remarks This avoids splicing '#define'-lines into the source text; only the macro values are tokenized.
+    \see PredefinedMacro
+    \see DefineSetFingerprint
+    */
+    std::vector<PredefinedMacro>    predefinedMacros;
+
+    /**
+    \brief Optional map from include filenames to precompiled token module files. By default empty.
+    \remarks When an '#include'-directive names a key of this map, the precompiled module is spliced into
+    the token stream instead of loading and scanning the include file (see PrecompileHeader). It is the
+    caller's responsibility to rebuild a module whenever its header changes.
+    \see PrecompileHeader
+    */
+    std::map<std::string, std::string> headerModules;
 };
 
+/**
+\brief Returns a 64-bit content hash over the predefined macro set of the specified shader input.
+\remarks This is meant to key a compilation cache (together with a hash of the source code),
+without concatenating the macros into a string.
+\see ShaderInput::predefinedMacros
+*/
+XSC_EXPORT std::uint64_t DefineSetFingerprint(const ShaderInput& inputDesc);
+
 //! Shader output descriptor structure.
 struct ShaderOutput
 {
@@ -194,6 +450,36 @@ struct ShaderOutput
     //! Specifies the output stream. This will contain the output GLSL code. This must not be null when passed to the "CompileShader" function!
     std::ostream*       sourceCode      = nullptr;
 
+    /**
+    \brief Optional pointer to a string that receives the output GLSL code. By default null.
+    \remarks If this is non-null, it takes precedence over 'sourceCode', and the internal
+    output buffer is moved into the string, i.e. without an intermediate stream copy.
+    */
+    std::string*        sourceCodeString = nullptr;
+
+    /**
+    \brief Optional callback that receives the output GLSL code in chunks. By default null.
+    \remarks If this is non-null, it takes precedence over 'sourceCode' and 'sourceCodeString'.
+    The code writer flushes its buffer to the callback at line boundaries whenever at least
+    'outputChunkSize' bytes are buffered, with a final flush at the end of code generation,
+    so the caller can hash, compress or upload the code while generation is still running.
+    The chunks concatenated in call order form the complete output code.
+    */
+    std::function<void(const char* chunk, std::size_t size)> sourceCodeCallback;
+
+    //! Number of buffered bytes at which 'sourceCodeCallback' or 'outputCompressor' is invoked. By default 65536.
+    std::size_t         outputChunkSize = 65536;
+
+    /**
+    \brief Optional pointer to a streaming compressor for the output GLSL code. By default null.
+    \remarks If this is non-null, it takes precedence over 'sourceCode', 'sourceCodeString', and
+    'sourceCodeCallback': the code writer flushes the generated code through the compressor in
+    chunks (see 'outputChunkSize') while generation is still running, so the compressed artifact
+    is produced without a second pass over the output text.
+    \see OutputCompressor
+    */
+    OutputCompressor*   outputCompressor = nullptr;
+
     //! Specifies the output shader version. By default OutputShaderVersion::GLSL (to auto-detect minimum required version).
     OutputShaderVersion shaderVersion   = OutputShaderVersion::GLSL;
 
@@ -205,6 +491,63 @@ struct ShaderOutput
 
     //! Optional output statistics. By default null.
     Statistics*         statistics      = nullptr;
+
+    /**
+    \brief Optional instrumentation statistics. By default null.
+    \remarks Filled by the "CompileShader" functions; the hot-path counters are only
+    accumulated while this is non-null, so the instrumentation is free by default.
+    \see CompileStats
+    */
+    CompileStats*       compileStats    = nullptr;
+
+    /**
+    \brief Optional output for shader code reflection data. By default null.
+    \remarks Filled during code generation; only declarations reachable from the entry
+    point are reported (see "Reflection::SerializeReflection" for the binary form).
+    \see Reflection::ReflectionData
+    */
+    Reflection::ReflectionData* reflectionData = nullptr;
+
+    /**
+    \brief Optional pointer to a shared preamble of intrinsic wrapper functions. By default null.
+    \remarks If this is non-null, the code generator registers the wrapper functions for special
+    intrinsics (e.g. "clip") in the preamble instead of writing them into the output code, so a batch
+    of shaders shares one copy of each wrapper. The caller must prepend the preamble code to the
+    generated shader code (e.g. at bundle load time) for the output to compile.
+    \see WrapperPreamble
+    */
+    WrapperPreamble*    wrapperPreamble = nullptr;
+
+    /**
+    \brief Optional output for the include dependencies of the compilation. By default null.
+    \remarks Filled by the "CompileShader" functions with one entry per resolved '#include' directive,
+    in inclusion order, each carrying the include filename and a content hash of the file. Use this to
+    drive minimal rebuilds in a build system: re-compile when a dependency's content hash changed.
+    The filenames are the names as requested by the directives; resolve them against
+    "IncludeHandler::searchPaths" to obtain filesystem paths.
+    \see CompileCache::IncludeReference
+    */
+    std::vector<CompileCache::IncludeReference>* includeDependencies = nullptr;
+
+    /**
+    \brief Optional output stream for Chrome trace-event JSON spans of the compilation pipeline. By default null.
+    \remarks Only served when the compiler is built with the XSC_TRACE_EVENTS build option; otherwise the
+    instrumentation points compile to nothing and this stream remains untouched. The emitted JSON covers the
+    pipeline stages, the code generation passes, the parsed function declarations and the include reads,
+    and can be loaded into the "chrome://tracing" viewer to inspect where the compilation time of a shader goes.
+    */
+    std::ostream*       traceOutput     = nullptr;
+
+    /**
+    \brief Optional output stream for a binary dump of the abstract syntax tree. By default null.
+    \remarks Written after the analysis stage, i.e. it covers the same decorated tree the "showAST"
+    option prints as text. The dump consists of fixed-width node records in depth-first pre-order
+    (node type tag, subtree size, interned info string, source position) followed by a deduplicated
+    string table, so analysis tooling can memory-map the file and skip subtrees by record count
+    instead of parsing the indented text report. The stream must be opened in binary mode.
+    \see Options::showAST
+    */
+    std::ostream*       astDumpOutput   = nullptr;
 };
 
 /**
@@ -224,6 +567,103 @@ XSC_EXPORT bool CompileShader(
     Log* log = nullptr
 );
 
+/**
+\brief Cross compiles the shader code incrementally, reusing the retained output of the specified context when possible.
+\param[in] inputDesc Input shader code descriptor.
+\param[in] outputDesc Output shader code descriptor.
+\param[in] log Optional pointer to an output log. Inherit from the "Log" class interface.
+\param[in,out] context Persistent compiler context; keep it alive across calls (e.g. for a hot-reload loop).
+\return True if the code has been translated successfully.
+\remarks The preprocessed code is split into top-level declarations and a content hash is computed per declaration.
+If no declaration changed since the last successful compilation with this context (i.e. only white spaces or
+commentaries were edited), the retained output is written out directly and the compilation stages are skipped.
+The context is ignored in preprocess-only mode and when a compile cache is attached (see ShaderInput::cache).
+\throw std::invalid_argument If either the input or output streams are null.
+\see CompilerContext
+\see CompileShader
+*/
+XSC_EXPORT bool CompileShader(
+    const ShaderInput& inputDesc,
+    const ShaderOutput& outputDesc,
+    Log* log,
+    CompilerContext& context
+);
+
+/**
+\brief Precompiles the specified shader header into a binary token module, analogous to a precompiled header.
+\param[in] inputDesc Input shader code descriptor; only the source code fields are used.
+\param[out] moduleStream Output stream for the binary module; must be opened in binary mode.
+\param[in] log Optional pointer to an output log. Inherit from the "Log" class interface.
+\return True if the header has been precompiled successfully.
+\remarks The module stores the pre-lexed token stream of the header, so including compiles skip the file
+loading and scanning of the header. Macro expansion and directive handling still run per compile, since
+they depend on the macro state of the including file; for the same reason the module does not store a
+decorated syntax tree, whose declarations would be specific to one compile. Register modules for a compile
+via "ShaderInput::headerModules". The module format is an internal build artifact: it is not portable
+across library versions or byte orders.
+\throw std::invalid_argument If the input stream is null.
+\see ShaderInput::headerModules
+*/
+XSC_EXPORT bool PrecompileHeader(
+    const ShaderInput& inputDesc,
+    std::ostream& moduleStream,
+    Log* log = nullptr
+);
+
+/**
+\brief Starts the compilation on a background thread and returns immediately.
+\param[in] inputDesc Input shader code descriptor.
+\param[in] outputDesc Output shader code descriptor.
+\param[in] log Optional pointer to an output log. Inherit from the "Log" class interface.
+\return Handle to wait for, poll, or cancel the compilation.
+\remarks The compilation runs on an internal worker-thread pool, so several permutations can be compiled
+concurrently (e.g. on file-save in an editor). The descriptors are copied, but the streams and strings they
+point to remain owned by the caller and must stay alive and untouched until the handle reports completion.
+The log (if any) is invoked from the worker thread and must be thread-safe with respect to the caller.
+Cancellation is checked between the compilation passes (preprocessing, parsing, analysis, code generation),
+so an abandoned compilation releases its memory quickly without being torn down mid-pass.
+\see CompilationHandle
+\see CompileShader
+*/
+XSC_EXPORT CompilationHandle CompileShaderAsync(
+    const ShaderInput& inputDesc,
+    const ShaderOutput& outputDesc,
+    Log* log = nullptr
+);
+
+/**
+\brief Cross compiles the shader code into several output variants (e.g. multiple GLSL versions), sharing the frontend work.
+\param[in] inputDesc Input shader code descriptor.
+\param[in] outputDescs Output shader code descriptors, one for each variant.
+\param[in] log Optional pointer to an output log. Inherit from the "Log" class interface.
+\return True if the code has been translated successfully for all variants.
+\remarks The input is preprocessed only once (include resolution and macro expansion), and all variants
+are compiled from the in-memory preprocessed source. Each variant builds its own AST, since code
+generation transforms the AST and a shared tree would leak state between variants.
+\throw std::invalid_argument If the input stream or any of the output streams are null.
+\see CompileShader
+*/
+XSC_EXPORT bool CompileShaderVariants(
+    const ShaderInput& inputDesc,
+    const std::vector<ShaderOutput>& outputDescs,
+    Log* log = nullptr
+);
+
+class CompilerInstance;
+
+/**
+\brief Forces all lazily initialized internal structures, so the first user-visible compile runs at steady-state speed.
+\param[in] instance Optional pointer to a reusable compiler instance to warm up through. This additionally
+pre-faults the retained memory of the instance (the per-compile arena and the string interning table).
+\return True if the warm-up compile succeeded (it always should; a failure indicates a broken build).
+\remarks The keyword, intrinsic, and semantic tables of the compiler initialize lazily on first use,
+which makes the first compilation after process start measurably slower than steady state. This function
+compiles a small built-in shader through the full pipeline (vertex and fragment stage) and discards the
+output, touching all of those tables. Call it from a background thread at application startup.
+\see CompilerInstance
+*/
+XSC_EXPORT bool Warmup(CompilerInstance* instance = nullptr);
+
 
 } // /namespace Xsc
 
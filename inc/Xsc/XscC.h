@@ -0,0 +1,153 @@
+/*
+ * XscC.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_XSC_C_H
+#define XSC_XSC_C_H
+
+
+#include "Export.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*
+This is the plain C binding of the compiler, meant for foreign build tools (e.g. C# or Python orchestrators)
+that cannot use the C++ interface of "Xsc.h". Input buffers are passed as pointer + length and are not copied,
+output buffers are owned by the caller, and all failures are reported as error codes instead of exceptions.
+*/
+
+/* ----- Enumerations ----- */
+
+/** Result codes of the "XscCompileShader" function. */
+enum
+{
+    XSC_RESULT_SUCCESS          = 0, /**< Compilation succeeded. */
+    XSC_RESULT_COMPILE_FAILED   = 1, /**< Compilation failed; see the report buffer for details. */
+    XSC_RESULT_INVALID_ARGUMENT = 2, /**< An argument of the call was invalid (e.g. a null descriptor or source buffer). */
+    XSC_RESULT_INTERNAL_ERROR   = 3, /**< An unexpected internal error occurred. */
+};
+
+/** Shader targets (mirrors Xsc::ShaderTarget). */
+enum
+{
+    XSC_TARGET_UNDEFINED                = 0,
+    XSC_TARGET_VERTEX_SHADER            = 1,
+    XSC_TARGET_TESS_CONTROL_SHADER      = 2,
+    XSC_TARGET_TESS_EVALUATION_SHADER   = 3,
+    XSC_TARGET_GEOMETRY_SHADER          = 4,
+    XSC_TARGET_FRAGMENT_SHADER          = 5,
+    XSC_TARGET_COMPUTE_SHADER           = 6,
+};
+
+/** Input shader versions (mirrors Xsc::InputShaderVersion). */
+enum
+{
+    XSC_INPUT_HLSL3 = 3,
+    XSC_INPUT_HLSL4 = 4,
+    XSC_INPUT_HLSL5 = 5,
+};
+
+/** Output shader versions (mirrors Xsc::OutputShaderVersion); XSC_OUTPUT_GLSL_AUTO detects the minimal required version. */
+enum
+{
+    XSC_OUTPUT_GLSL_AUTO    = 0,
+    XSC_OUTPUT_GLSL130      = 130,
+    XSC_OUTPUT_GLSL140      = 140,
+    XSC_OUTPUT_GLSL150      = 150,
+    XSC_OUTPUT_GLSL330      = 330,
+    XSC_OUTPUT_GLSL400      = 400,
+    XSC_OUTPUT_GLSL410      = 410,
+    XSC_OUTPUT_GLSL420      = 420,
+    XSC_OUTPUT_GLSL430      = 430,
+    XSC_OUTPUT_GLSL440      = 440,
+    XSC_OUTPUT_GLSL450      = 450,
+};
+
+/** Option bit flags (mirrors the boolean members of Xsc::Options). */
+enum
+{
+    XSC_OPTION_OPTIMIZE          = (1 << 0), /**< Enables the AST optimizer. */
+    XSC_OPTION_ALLOW_EXTENSIONS  = (1 << 1), /**< Allows GLSL extensions for otherwise unsupported features. */
+    XSC_OPTION_EXPLICIT_BINDING  = (1 << 2), /**< Enables explicit binding slots. */
+    XSC_OPTION_PRESERVE_COMMENTS = (1 << 3), /**< Preserves the comments of the input code. */
+    XSC_OPTION_PREPROCESS_ONLY   = (1 << 4), /**< Only the preprocessed code is returned. */
+    XSC_OPTION_VALIDATE_ONLY     = (1 << 5), /**< Only validates the code; no output code is returned. */
+};
+
+
+/* ----- Structures ----- */
+
+/** Predefined macro (mirrors Xsc::PredefinedMacro); 'value' may be NULL. */
+struct XscMacro
+{
+    const char* ident;
+    const char* value;
+};
+
+/** Compilation input descriptor. All strings are null terminated; the source buffer is not copied and must remain valid during the call. */
+struct XscShaderInput
+{
+    const char*             filename;           /**< Optional filename hint for reports; may be NULL. */
+    const char*             sourceCode;         /**< HLSL source code buffer (pointer + length; no null terminator required). */
+    size_t                  sourceCodeSize;     /**< Size of the source code buffer in bytes. */
+    const char*             entryPoint;         /**< Shader entry point, e.g. "main". */
+    int                     shaderTarget;       /**< One of the XSC_TARGET_... values. */
+    int                     inputVersion;       /**< One of the XSC_INPUT_... values. */
+    const struct XscMacro*  macros;             /**< Optional array of predefined macros; may be NULL. */
+    size_t                  numMacros;          /**< Number of entries in 'macros'. */
+    const char* const*      includePaths;       /**< Optional array of include search paths; may be NULL. */
+    size_t                  numIncludePaths;    /**< Number of entries in 'includePaths'. */
+};
+
+/** Compilation output descriptor. */
+struct XscShaderOutput
+{
+    int             outputVersion;  /**< One of the XSC_OUTPUT_... values; XSC_OUTPUT_GLSL_AUTO detects the minimal required version. */
+    unsigned int    options;        /**< Combination of the XSC_OPTION_... bit flags. */
+    const char*     namePrefix;     /**< Optional name mangling prefix; NULL uses the default prefix. */
+};
+
+/** Compilation result. Both buffers are owned by the caller and must be released with "XscFreeShaderResult". */
+struct XscShaderResult
+{
+    char*   code;       /**< Output GLSL code, or NULL on failure. Null terminated for convenience; 'codeSize' excludes the terminator. */
+    size_t  codeSize;   /**< Size of the output code in bytes. */
+    char*   report;     /**< All compiler reports as '\n' separated lines, or NULL if there were none. Null terminated. */
+    size_t  reportSize; /**< Size of the report text in bytes. */
+};
+
+
+/* ----- Functions ----- */
+
+/**
+Cross compiles the specified HLSL code to GLSL (see Xsc::CompileShader).
+Returns one of the XSC_RESULT_... codes; the result structure is filled on every return path,
+and must be released with "XscFreeShaderResult" (which is also safe on failure results).
+*/
+XSC_EXPORT int XscCompileShader(
+    const struct XscShaderInput* input,
+    const struct XscShaderOutput* output,
+    struct XscShaderResult* result
+);
+
+/** Releases the buffers of the specified compilation result, and resets its fields. Null fields are ignored. */
+XSC_EXPORT void XscFreeShaderResult(struct XscShaderResult* result);
+
+
+#ifdef __cplusplus
+} /* /extern "C" */
+#endif
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,745 @@
+/*
+ * Bench.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Xsc/Xsc.h>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+
+/*
+Benchmark harness over the HLSL test shader corpus (and user-supplied files or directories).
+Each shader is compiled through the full pipeline several times, and the per-pass medians
+(see Xsc::CompileStats) are reported as a table and optionally as JSON for CI tracking.
+*/
+
+/* ----- Corpus collection ----- */
+
+static bool HasHLSLExtension(const std::string& filename)
+{
+    const std::string ext = ".hlsl";
+    return (filename.size() > ext.size() && filename.compare(filename.size() - ext.size(), ext.size(), ext) == 0);
+}
+
+#if defined(_WIN32)
+
+static bool IsDirectory(const std::string& path)
+{
+    auto attribs = GetFileAttributesA(path.c_str());
+    return (attribs != INVALID_FILE_ATTRIBUTES && (attribs & FILE_ATTRIBUTE_DIRECTORY) != 0);
+}
+
+static void CollectShaderFiles(const std::string& dirPath, std::vector<std::string>& filenames)
+{
+    WIN32_FIND_DATAA findData;
+    auto findHandle = FindFirstFileA((dirPath + "\\*").c_str(), &findData);
+
+    if (findHandle != INVALID_HANDLE_VALUE)
+    {
+        do
+        {
+            if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0 && HasHLSLExtension(findData.cFileName))
+                filenames.push_back(dirPath + "\\" + findData.cFileName);
+        }
+        while (FindNextFileA(findHandle, &findData) != 0);
+        FindClose(findHandle);
+    }
+}
+
+#else
+
+static bool IsDirectory(const std::string& path)
+{
+    struct stat fileStat;
+    return (stat(path.c_str(), &fileStat) == 0 && S_ISDIR(fileStat.st_mode));
+}
+
+static void CollectShaderFiles(const std::string& dirPath, std::vector<std::string>& filenames)
+{
+    if (auto dir = opendir(dirPath.c_str()))
+    {
+        while (auto entry = readdir(dir))
+        {
+            std::string filename = entry->d_name;
+            if (HasHLSLExtension(filename) && !IsDirectory(dirPath + "/" + filename))
+                filenames.push_back(dirPath + "/" + filename);
+        }
+        closedir(dir);
+    }
+}
+
+#endif
+
+/* ----- Benchmark ----- */
+
+struct BenchEntry
+{
+    std::string         filename;
+    std::string         sourceCode;
+    std::string         entryPoint;
+    Xsc::ShaderTarget   shaderTarget    = Xsc::ShaderTarget::Undefined;
+    Xsc::CompileStats   medianStats;
+};
+
+static const char* ShaderTargetToString(const Xsc::ShaderTarget target)
+{
+    switch (target)
+    {
+        case Xsc::ShaderTarget::VertexShader:   return "vert";
+        case Xsc::ShaderTarget::FragmentShader: return "frag";
+        case Xsc::ShaderTarget::ComputeShader:  return "comp";
+        default:                                return "";
+    }
+}
+
+static bool CompileEntry(BenchEntry& entry, Xsc::CompileStats* stats, std::string* outputCapture = nullptr)
+{
+    Xsc::ShaderInput inputDesc;
+    inputDesc.sourceCodeBuffer      = entry.sourceCode.data();
+    inputDesc.sourceCodeBufferSize  = entry.sourceCode.size();
+    inputDesc.filename              = entry.filename;
+    inputDesc.entryPoint            = entry.entryPoint;
+    inputDesc.shaderTarget          = entry.shaderTarget;
+
+    std::string outputCode;
+
+    Xsc::ShaderOutput outputDesc;
+    outputDesc.sourceCodeString     = (outputCapture != nullptr ? outputCapture : &outputCode);
+    outputDesc.compileStats         = stats;
+
+    /* The determinism check compares output bytes, so the timestamp comment must be suppressed */
+    if (outputCapture != nullptr)
+        outputDesc.options.deterministicOutput = true;
+
+    try
+    {
+        return Xsc::CompileShader(inputDesc, outputDesc);
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+}
+
+// Determines a compilable entry point and shader target for the specified shader (or returns false if there is none).
+static bool ProbeEntryPoint(BenchEntry& entry)
+{
+    struct EntryPointCandidate
+    {
+        const char*         entryPoint;
+        Xsc::ShaderTarget   shaderTarget;
+    };
+
+    const std::vector<EntryPointCandidate> candidates
+    {
+        { "VS",   Xsc::ShaderTarget::VertexShader   },
+        { "PS",   Xsc::ShaderTarget::FragmentShader },
+        { "CS",   Xsc::ShaderTarget::ComputeShader  },
+        { "main", Xsc::ShaderTarget::VertexShader   },
+        { "main", Xsc::ShaderTarget::FragmentShader },
+    };
+
+    for (const auto& candidate : candidates)
+    {
+        entry.entryPoint    = candidate.entryPoint;
+        entry.shaderTarget  = candidate.shaderTarget;
+
+        if (CompileEntry(entry, nullptr))
+            return true;
+    }
+
+    return false;
+}
+
+template <typename T>
+static T Median(std::vector<T>& values)
+{
+    if (values.empty())
+        return T(0);
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+static void RunBenchmark(BenchEntry& entry, std::size_t numRuns)
+{
+    std::vector<Xsc::CompileStats> runStats(numRuns);
+
+    for (std::size_t i = 0; i < numRuns; ++i)
+        CompileEntry(entry, &runStats[i]);
+
+    /* Reduce each measure to its median over all runs */
+    auto MedianOf = [&runStats](std::uint64_t Xsc::CompileStats::* member)
+    {
+        std::vector<std::uint64_t> values;
+        for (const auto& stats : runStats)
+            values.push_back(stats.*member);
+        return Median(values);
+    };
+
+    auto MedianOfSize = [&runStats](std::size_t Xsc::CompileStats::* member)
+    {
+        std::vector<std::size_t> values;
+        for (const auto& stats : runStats)
+            values.push_back(stats.*member);
+        return Median(values);
+    };
+
+    auto& medianStats = entry.medianStats;
+
+    medianStats.preProcessingTime   = MedianOf(&Xsc::CompileStats::preProcessingTime);
+    medianStats.parsingTime         = MedianOf(&Xsc::CompileStats::parsingTime);
+    medianStats.analysisTime        = MedianOf(&Xsc::CompileStats::analysisTime);
+    medianStats.optimizationTime    = MedianOf(&Xsc::CompileStats::optimizationTime);
+    medianStats.generationTime      = MedianOf(&Xsc::CompileStats::generationTime);
+
+    medianStats.numTokens           = MedianOfSize(&Xsc::CompileStats::numTokens);
+    medianStats.macroExpansions     = MedianOfSize(&Xsc::CompileStats::macroExpansions);
+    medianStats.symbolTableFetches  = MedianOfSize(&Xsc::CompileStats::symbolTableFetches);
+    medianStats.symbolTableCacheHits = MedianOfSize(&Xsc::CompileStats::symbolTableCacheHits);
+    medianStats.arenaBytes          = MedianOfSize(&Xsc::CompileStats::arenaBytes);
+    medianStats.outputBytes         = MedianOfSize(&Xsc::CompileStats::outputBytes);
+}
+
+/* ----- Report output ----- */
+
+static std::string EscapeJSONString(const std::string& str)
+{
+    std::string escaped;
+    for (auto chr : str)
+    {
+        if (chr == '"' || chr == '\\')
+            escaped += '\\';
+        escaped += chr;
+    }
+    return escaped;
+}
+
+static void WriteJSONStats(std::ostream& stream, const Xsc::CompileStats& stats, const std::string& indent)
+{
+    stream << indent << "\"preProcessingTime\": "  << stats.preProcessingTime  << ",\n";
+    stream << indent << "\"parsingTime\": "        << stats.parsingTime        << ",\n";
+    stream << indent << "\"analysisTime\": "       << stats.analysisTime       << ",\n";
+    stream << indent << "\"optimizationTime\": "   << stats.optimizationTime   << ",\n";
+    stream << indent << "\"generationTime\": "     << stats.generationTime     << ",\n";
+    stream << indent << "\"numTokens\": "          << stats.numTokens          << ",\n";
+    stream << indent << "\"macroExpansions\": "    << stats.macroExpansions    << ",\n";
+    stream << indent << "\"symbolTableFetches\": " << stats.symbolTableFetches << ",\n";
+    stream << indent << "\"symbolTableCacheHits\": " << stats.symbolTableCacheHits << ",\n";
+    stream << indent << "\"arenaBytes\": "         << stats.arenaBytes         << ",\n";
+    stream << indent << "\"outputBytes\": "        << stats.outputBytes        << "\n";
+}
+
+static void WriteJSONReport(std::ostream& stream, const std::vector<BenchEntry>& entries, const Xsc::CompileStats& totals, std::size_t numRuns)
+{
+    stream << "{\n";
+    stream << "  \"runs\": " << numRuns << ",\n";
+    stream << "  \"files\": [\n";
+
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+        const auto& entry = entries[i];
+        stream << "    {\n";
+        stream << "      \"file\": \""   << EscapeJSONString(entry.filename) << "\",\n";
+        stream << "      \"entry\": \""  << entry.entryPoint                 << "\",\n";
+        stream << "      \"target\": \"" << ShaderTargetToString(entry.shaderTarget) << "\",\n";
+        WriteJSONStats(stream, entry.medianStats, "      ");
+        stream << "    }" << (i + 1 < entries.size() ? "," : "") << "\n";
+    }
+
+    stream << "  ],\n";
+    stream << "  \"totals\": {\n";
+    WriteJSONStats(stream, totals, "    ");
+    stream << "  }\n";
+    stream << "}\n";
+}
+
+static void PrintSummary(const std::vector<BenchEntry>& entries, const Xsc::CompileStats& totals, std::size_t numRuns)
+{
+    std::cout << "benchmark over " << entries.size() << " shaders, " << numRuns << " runs each (median times in microseconds):" << std::endl;
+
+    for (const auto& entry : entries)
+    {
+        const auto& stats = entry.medianStats;
+        std::cout
+            << "  " << entry.filename << " (" << entry.entryPoint << ", " << ShaderTargetToString(entry.shaderTarget) << "):"
+            << " pp=" << stats.preProcessingTime
+            << " parse=" << stats.parsingTime
+            << " analyze=" << stats.analysisTime
+            << " optimize=" << stats.optimizationTime
+            << " generate=" << stats.generationTime
+            << " tokens=" << stats.numTokens
+            << " arena=" << stats.arenaBytes
+            << std::endl;
+    }
+
+    std::cout
+        << "total:"
+        << " pp=" << totals.preProcessingTime
+        << " parse=" << totals.parsingTime
+        << " analyze=" << totals.analysisTime
+        << " optimize=" << totals.optimizationTime
+        << " generate=" << totals.generationTime
+        << " tokens=" << totals.numTokens
+        << " arena=" << totals.arenaBytes
+        << std::endl;
+}
+
+/* ----- Determinism verification ----- */
+
+// Compiles each shader twice in deterministic mode and byte-compares the outputs; returns the number of mismatches.
+static std::size_t VerifyDeterministicOutput(std::vector<BenchEntry>& entries)
+{
+    std::size_t numMismatches = 0;
+
+    for (auto& entry : entries)
+    {
+        std::string firstOutput, secondOutput;
+
+        if (!CompileEntry(entry, nullptr, &firstOutput) || !CompileEntry(entry, nullptr, &secondOutput))
+        {
+            std::cout << "  " << entry.filename << " (" << entry.entryPoint << "): compilation failed during determinism check" << std::endl;
+            ++numMismatches;
+        }
+        else if (firstOutput != secondOutput)
+        {
+            std::cout << "  " << entry.filename << " (" << entry.entryPoint << "): output differs between identical compilations" << std::endl;
+            ++numMismatches;
+        }
+    }
+
+    if (numMismatches > 0)
+        std::cout << numMismatches << " shader(s) produced non-deterministic output" << std::endl;
+    else
+        std::cout << "deterministic output verified over " << entries.size() << " shaders" << std::endl;
+
+    return numMismatches;
+}
+
+/* ----- Baseline comparison ----- */
+
+// Benchmark measure: report field name, whether an increase gates the comparison, and the
+// minimum absolute increase that counts (times are noisy below a few ticks, counters are exact).
+struct BenchMetric
+{
+    const char*     name;
+    bool            gated;
+    std::uint64_t   minDelta;
+};
+
+static const std::vector<BenchMetric> benchMetrics_
+{
+    { "preProcessingTime",    true,  50 },
+    { "parsingTime",          true,  50 },
+    { "analysisTime",         true,  50 },
+    { "optimizationTime",     true,  50 },
+    { "generationTime",       true,  50 },
+    { "numTokens",            true,  0  },
+    { "macroExpansions",      true,  0  },
+    { "symbolTableFetches",   true,  0  },
+    { "symbolTableCacheHits", false, 0  },  // more cache hits are an improvement, so do not gate on them
+    { "arenaBytes",           true,  0  },
+    { "outputBytes",          true,  0  },
+};
+
+using BenchValueMap = std::map<std::string, std::uint64_t>;
+
+static BenchValueMap StatsToValues(const Xsc::CompileStats& stats)
+{
+    return
+    {
+        { "preProcessingTime",    stats.preProcessingTime    },
+        { "parsingTime",          stats.parsingTime          },
+        { "analysisTime",         stats.analysisTime         },
+        { "optimizationTime",     stats.optimizationTime     },
+        { "generationTime",       stats.generationTime       },
+        { "numTokens",            stats.numTokens            },
+        { "macroExpansions",      stats.macroExpansions      },
+        { "symbolTableFetches",   stats.symbolTableFetches   },
+        { "symbolTableCacheHits", stats.symbolTableCacheHits },
+        { "arenaBytes",           stats.arenaBytes           },
+        { "outputBytes",          stats.outputBytes          },
+    };
+}
+
+// Returns the baseline lookup key of a benchmark entry.
+static std::string BenchEntryKey(const std::string& filename, const std::string& entryPoint, const std::string& target)
+{
+    return (filename + "|" + entryPoint + "|" + target);
+}
+
+/*
+Parses the JSON reports this tool writes itself (see WriteJSONReport): one "name": value pair per
+line, with the "totals" object after the per-file entries. This is not a general JSON parser.
+*/
+static bool LoadBaselineReport(const std::string& filename, std::map<std::string, BenchValueMap>& entries, BenchValueMap& totals)
+{
+    std::ifstream file(filename);
+    if (!file.good())
+        return false;
+
+    std::string line, entryFile, entryPoint, entryTarget;
+    BenchValueMap values;
+    bool inTotals = false;
+
+    auto FlushEntry = [&]()
+    {
+        if (!entryFile.empty())
+        {
+            entries[BenchEntryKey(entryFile, entryPoint, entryTarget)] = std::move(values);
+            values.clear();
+            entryFile.clear();
+        }
+    };
+
+    while (std::getline(file, line))
+    {
+        /* Extract the quoted key of the line (lines without one carry no values) */
+        auto keyBegin = line.find('"');
+        if (keyBegin == std::string::npos)
+            continue;
+        auto keyEnd = line.find('"', keyBegin + 1);
+        if (keyEnd == std::string::npos)
+            continue;
+
+        const auto key = line.substr(keyBegin + 1, keyEnd - keyBegin - 1);
+
+        auto valueBegin = line.find(':', keyEnd);
+        if (valueBegin == std::string::npos)
+            continue;
+        ++valueBegin;
+
+        if (key == "totals")
+        {
+            FlushEntry();
+            inTotals = true;
+        }
+        else if (key == "file" || key == "entry" || key == "target")
+        {
+            /* Extract the quoted string value (the report escapes only '"' and '\') */
+            std::string value;
+            bool inString = false, escaped = false;
+
+            for (auto i = valueBegin; i < line.size(); ++i)
+            {
+                const auto chr = line[i];
+                if (escaped)
+                {
+                    value += chr;
+                    escaped = false;
+                }
+                else if (chr == '\\')
+                    escaped = true;
+                else if (chr == '"')
+                {
+                    if (inString)
+                        break;
+                    inString = true;
+                }
+                else if (inString)
+                    value += chr;
+            }
+
+            if (key == "file")
+            {
+                FlushEntry();
+                entryFile = value;
+            }
+            else if (key == "entry")
+                entryPoint = value;
+            else
+                entryTarget = value;
+        }
+        else if (key != "runs")
+        {
+            /* Numeric measure of the current per-file entry or of the totals object */
+            const auto value = static_cast<std::uint64_t>(std::strtoull(line.c_str() + valueBegin, nullptr, 10));
+            (inTotals ? totals : values)[key] = value;
+        }
+    }
+
+    FlushEntry();
+
+    return !(entries.empty() && totals.empty());
+}
+
+// Returns the signed delta of the specified measure in percent (against a baseline of at least 1).
+static double DeltaPercent(std::uint64_t baseValue, std::uint64_t currentValue)
+{
+    const auto base = static_cast<double>(baseValue > 0 ? baseValue : 1);
+    return (static_cast<double>(currentValue) - static_cast<double>(baseValue)) * 100.0 / base;
+}
+
+// Returns true if the specified measure regressed beyond the threshold.
+static bool IsRegression(const BenchMetric& metric, std::uint64_t baseValue, std::uint64_t currentValue, double thresholdPercent)
+{
+    if (!metric.gated || currentValue <= baseValue)
+        return false;
+    if (currentValue - baseValue < metric.minDelta)
+        return false;
+    return (DeltaPercent(baseValue, currentValue) > thresholdPercent);
+}
+
+static void PrintDeltaLine(const std::string& indent, const char* name, std::uint64_t baseValue, std::uint64_t currentValue, bool regressed)
+{
+    const auto delta = DeltaPercent(baseValue, currentValue);
+
+    std::cout
+        << indent << name << ": " << baseValue << " -> " << currentValue
+        << " (" << (delta >= 0.0 ? "+" : "") << std::fixed;
+    std::cout.precision(1);
+    std::cout << delta << "%)" << (regressed ? "  REGRESSION" : "") << std::endl;
+}
+
+// Compares the benchmark results against the baseline report and returns the number of regressions beyond the threshold.
+static std::size_t CompareAgainstBaseline(
+    const std::string& baselineFilename, const std::vector<BenchEntry>& entries,
+    const Xsc::CompileStats& totals, double thresholdPercent)
+{
+    std::map<std::string, BenchValueMap> baselineEntries;
+    BenchValueMap baselineTotals;
+
+    if (!LoadBaselineReport(baselineFilename, baselineEntries, baselineTotals))
+    {
+        std::cerr << "failed to load baseline report: " << baselineFilename << std::endl;
+        return 1;
+    }
+
+    std::cout.precision(1);
+    std::cout << "comparison against baseline \"" << baselineFilename << "\" (threshold ";
+    std::cout << std::fixed << thresholdPercent << "%):" << std::endl;
+
+    std::size_t numRegressions = 0;
+
+    /* Report per-file regressions (matched by filename, entry point, and target) */
+    for (const auto& entry : entries)
+    {
+        auto it = baselineEntries.find(BenchEntryKey(entry.filename, entry.entryPoint, ShaderTargetToString(entry.shaderTarget)));
+        if (it == baselineEntries.end())
+        {
+            std::cout << "  " << entry.filename << " (" << entry.entryPoint << "): not in baseline" << std::endl;
+            continue;
+        }
+
+        const auto currentValues = StatsToValues(entry.medianStats);
+        bool headerPrinted = false;
+
+        for (const auto& metric : benchMetrics_)
+        {
+            auto baseIt = it->second.find(metric.name);
+            if (baseIt == it->second.end())
+                continue;
+
+            const auto currentValue = currentValues.at(metric.name);
+            if (IsRegression(metric, baseIt->second, currentValue, thresholdPercent))
+            {
+                if (!headerPrinted)
+                {
+                    std::cout << "  " << entry.filename << " (" << entry.entryPoint << ", " << ShaderTargetToString(entry.shaderTarget) << "):" << std::endl;
+                    headerPrinted = true;
+                }
+                PrintDeltaLine("    ", metric.name, baseIt->second, currentValue, true);
+                ++numRegressions;
+            }
+        }
+    }
+
+    /* Always report the full per-pass delta table of the totals */
+    std::cout << "  totals:" << std::endl;
+
+    const auto currentTotals = StatsToValues(totals);
+
+    for (const auto& metric : benchMetrics_)
+    {
+        auto baseIt = baselineTotals.find(metric.name);
+        if (baseIt == baselineTotals.end())
+            continue;
+
+        const auto currentValue = currentTotals.at(metric.name);
+        const auto regressed    = IsRegression(metric, baseIt->second, currentValue, thresholdPercent);
+
+        PrintDeltaLine("    ", metric.name, baseIt->second, currentValue, regressed);
+
+        if (regressed)
+            ++numRegressions;
+    }
+
+    if (numRegressions > 0)
+        std::cout << numRegressions << " measure(s) regressed beyond the threshold" << std::endl;
+    else
+        std::cout << "no regressions beyond the threshold" << std::endl;
+
+    return numRegressions;
+}
+
+/* ----- Main ----- */
+
+int main(int argc, char** argv)
+{
+    std::size_t                 numRuns             = 8;
+    std::string                 outputFilename;
+    std::string                 baselineFilename;
+    double                      thresholdPercent    = 3.0;
+    bool                        verifyDeterminism   = false;
+    std::vector<std::string>    inputs;
+
+    /* Parse program arguments */
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h")
+        {
+            std::cout << "Usage:" << std::endl;
+            std::cout << "  xsc_bench [OPTION+] [FILE/DIR+]" << std::endl;
+            std::cout << "Options:" << std::endl;
+            std::cout << "  -n, --runs N ........... Number of compilation runs per shader; default=8" << std::endl;
+            std::cout << "  -o, --output FILE ...... Writes the benchmark report as JSON to FILE" << std::endl;
+            std::cout << "  -c, --compare FILE ..... Compares against the baseline JSON report FILE; exits 2 on regression" << std::endl;
+            std::cout << "  -t, --threshold P ...... Regression threshold in percent (e.g. '3' or '3%'); default=3" << std::endl;
+            std::cout << "  --verify-deterministic . Compiles each shader twice and byte-compares the outputs; exits 2 on mismatch" << std::endl;
+            std::cout << "Remarks:" << std::endl;
+            std::cout << "  Without input files or directories, the \"test\" corpus directory is used." << std::endl;
+            std::cout << "  Record a baseline with '-o baseline.json', then gate with '--compare baseline.json'." << std::endl;
+            return 0;
+        }
+        else if ((arg == "--runs" || arg == "-n") && i + 1 < argc)
+            numRuns = static_cast<std::size_t>(std::max(1, std::atoi(argv[++i])));
+        else if ((arg == "--output" || arg == "-o") && i + 1 < argc)
+            outputFilename = argv[++i];
+        else if ((arg == "--compare" || arg == "-c") && i + 1 < argc)
+            baselineFilename = argv[++i];
+        else if ((arg == "--threshold" || arg == "-t") && i + 1 < argc)
+            thresholdPercent = std::max(0.0, std::atof(argv[++i]));
+        else if (arg == "--verify-deterministic")
+            verifyDeterminism = true;
+        else
+            inputs.push_back(arg);
+    }
+
+    if (inputs.empty())
+        inputs.push_back("test");
+
+    /* Collect shader corpus */
+    std::vector<std::string> filenames;
+
+    for (const auto& input : inputs)
+    {
+        if (IsDirectory(input))
+            CollectShaderFiles(input, filenames);
+        else
+            filenames.push_back(input);
+    }
+
+    std::sort(filenames.begin(), filenames.end());
+
+    if (filenames.empty())
+    {
+        std::cerr << "no shader files found" << std::endl;
+        return 1;
+    }
+
+    /* Probe a compilable entry point per shader, and benchmark all compilable shaders */
+    std::vector<BenchEntry> entries;
+
+    for (const auto& filename : filenames)
+    {
+        BenchEntry entry;
+        entry.filename = filename;
+
+        std::ifstream file(filename);
+        if (!file.good())
+        {
+            std::cerr << "skipped (failed to read file): " << filename << std::endl;
+            continue;
+        }
+
+        std::stringstream fileContent;
+        fileContent << file.rdbuf();
+        entry.sourceCode = fileContent.str();
+
+        if (!ProbeEntryPoint(entry))
+        {
+            std::cerr << "skipped (no compilable entry point): " << filename << std::endl;
+            continue;
+        }
+
+        RunBenchmark(entry, numRuns);
+        entries.push_back(std::move(entry));
+    }
+
+    if (entries.empty())
+    {
+        std::cerr << "no compilable shader files found" << std::endl;
+        return 1;
+    }
+
+    /* Accumulate totals over all shaders */
+    Xsc::CompileStats totals;
+
+    for (const auto& entry : entries)
+    {
+        const auto& stats = entry.medianStats;
+        totals.preProcessingTime    += stats.preProcessingTime;
+        totals.parsingTime          += stats.parsingTime;
+        totals.analysisTime         += stats.analysisTime;
+        totals.optimizationTime     += stats.optimizationTime;
+        totals.generationTime       += stats.generationTime;
+        totals.numTokens            += stats.numTokens;
+        totals.macroExpansions      += stats.macroExpansions;
+        totals.symbolTableFetches   += stats.symbolTableFetches;
+        totals.symbolTableCacheHits += stats.symbolTableCacheHits;
+        totals.arenaBytes           += stats.arenaBytes;
+        totals.outputBytes          += stats.outputBytes;
+    }
+
+    PrintSummary(entries, totals, numRuns);
+
+    /* Write JSON report */
+    if (!outputFilename.empty())
+    {
+        std::ofstream reportFile(outputFilename);
+        if (reportFile.good())
+            WriteJSONReport(reportFile, entries, totals, numRuns);
+        else
+        {
+            std::cerr << "failed to write report file: " << outputFilename << std::endl;
+            return 1;
+        }
+    }
+
+    /* Compare against the baseline report (if enabled) and gate on regressions */
+    if (!baselineFilename.empty())
+    {
+        if (CompareAgainstBaseline(baselineFilename, entries, totals, thresholdPercent) > 0)
+            return 2;
+    }
+
+    /* Verify byte-identical output across repeated compilations (if enabled) */
+    if (verifyDeterminism)
+    {
+        if (VerifyDeterministicOutput(entries) > 0)
+            return 2;
+    }
+
+    return 0;
+}
+
+
+
+// ================================================================================
@@ -9,37 +9,58 @@
 #include "Exception.h"
 #include "HLSLIntrinsics.h"
 #include "Variant.h"
-
-#ifdef XSC_ENABLE_MEMORY_POOL
-#include "MemoryPool.h"
-#endif
+#include "Helper.h"
 
 
 namespace Xsc
 {
 
 
-/* ----- AST ----- */
+#ifdef XSC_ENABLE_AST_NODE_AUDIT
 
-AST::~AST()
-{
-    // dummy
-}
+/* ----- AST node size audit ----- */
 
-#ifdef XSC_ENABLE_MEMORY_POOL
+/*
+Static size budgets for the AST node classes (in bytes, for a 64-bit build). AST residency is the
+memory ceiling when many compiles run in parallel, so growing a high-population node class
+(every expression carries the base and typed-base overhead) must be a deliberate decision:
+raise the budget here in the same change that grows the node. If a budget is exceeded, the
+compile error reports the actual size and the budget via the template arguments of "ASTNodeSize".
+*/
+template <std::size_t Size, std::size_t Budget>
+struct ASTNodeSize
+{
+    static_assert(Size <= Budget, "AST node class exceeds its size budget (actual size and budget appear as the template arguments above)");
+    static const bool value = true;
+};
+
+#define XSC_AUDIT_AST_NODE(CLASS_NAME, BUDGET) \
+    static_assert(ASTNodeSize<sizeof(CLASS_NAME), BUDGET>::value, "audit " #CLASS_NAME)
+
+/* Base classes (every node pays for these) */
+XSC_AUDIT_AST_NODE( AST,             32 );
+XSC_AUDIT_AST_NODE( TypedAST,        48 );
+XSC_AUDIT_AST_NODE( Expr,            48 );
+
+/* Highest-population node classes */
+XSC_AUDIT_AST_NODE( VarIdent,       128 );
+XSC_AUDIT_AST_NODE( LiteralExpr,     88 );
+XSC_AUDIT_AST_NODE( BinaryExpr,      88 );
+XSC_AUDIT_AST_NODE( UnaryExpr,       72 );
+XSC_AUDIT_AST_NODE( VarAccessExpr,   88 );
+XSC_AUDIT_AST_NODE( FunctionCall,   104 );
+
+#undef XSC_AUDIT_AST_NODE
 
-void* AST::operator new (std::size_t count)
-{
-    return MemoryPool::Instance().Alloc(count);
-}
+#endif
 
-void AST::operator delete (void* ptr)
-{
-    MemoryPool::Instance().Free(ptr);
-}
 
-#endif
+/* ----- AST ----- */
 
+AST::~AST()
+{
+    // dummy
+}
 
 /* ----- TypedAST ----- */
 
@@ -111,14 +132,14 @@ TypeDenoterPtr VarIdent::GetExplicitTypeDenoter(bool recursive)
             case AST::Types::TextureDecl:
             {
                 auto textureDecl = static_cast<TextureDecl*>(symbolRef);
-                return std::make_shared<TextureTypeDenoter>(textureDecl);
+                return MakeShared<TextureTypeDenoter>(textureDecl);
             }
             break;
 
             case AST::Types::SamplerDecl:
             {
                 auto samplerDecl = static_cast<SamplerDecl*>(symbolRef);
-                return std::make_shared<SamplerTypeDenoter>(samplerDecl);
+                return MakeShared<SamplerTypeDenoter>(samplerDecl);
             }
             break;
 
@@ -163,6 +184,9 @@ void VarIdent::PopFront()
         arrayIndices    = nextVarIdent->arrayIndices;
         next            = nextVarIdent->next;
         symbolRef       = nextVarIdent->symbolRef;
+
+        /* Identifier and symbol reference changed, so the memoized type denoter is stale */
+        ResetBufferedTypeDenoter();
     }
 }
 
@@ -276,7 +300,7 @@ TypeDenoterPtr VarDecl::DeriveTypeDenoter()
 
 TypeDenoterPtr TextureDecl::DeriveTypeDenoter()
 {
-    return std::make_shared<TextureTypeDenoter>(this);
+    return MakeShared<TextureTypeDenoter>(this);
 }
 
 
@@ -284,7 +308,7 @@ TypeDenoterPtr TextureDecl::DeriveTypeDenoter()
 
 TypeDenoterPtr SamplerDecl::DeriveTypeDenoter()
 {
-    return std::make_shared<SamplerTypeDenoter>(this);
+    return MakeShared<SamplerTypeDenoter>(this);
 }
 
 
@@ -323,7 +347,7 @@ VarDecl* StructDecl::Fetch(const std::string& ident) const
 
 TypeDenoterPtr StructDecl::DeriveTypeDenoter()
 {
-    return std::make_shared<StructTypeDenoter>(this);
+    return MakeShared<StructTypeDenoter>(this);
 }
 
 bool StructDecl::HasNonSystemValueMembers() const
@@ -564,7 +588,7 @@ TypeDenoterPtr NullExpr::DeriveTypeDenoter()
     Return 'int' as type, because null expressions are only
     used as dynamic array dimensions (which must be integral types)
     */
-    return std::make_shared<BaseTypeDenoter>(DataType::Int);
+    return GetCanonicalBaseTypeDenoter(DataType::Int);
 }
 
 
@@ -581,7 +605,7 @@ TypeDenoterPtr ListExpr::DeriveTypeDenoter()
 
 TypeDenoterPtr LiteralExpr::DeriveTypeDenoter()
 {
-    return std::make_shared<BaseTypeDenoter>(dataType);
+    return GetCanonicalBaseTypeDenoter(dataType);
 }
 
 void LiteralExpr::ConvertDataType(const DataType type)
@@ -683,7 +707,7 @@ TypeDenoterPtr BinaryExpr::DeriveTypeDenoter()
     }
 
     if (IsBooleanOp(op))
-        return std::make_shared<BaseTypeDenoter>(DataType::Bool);
+        return GetCanonicalBaseTypeDenoter(DataType::Bool);
     else
         return lhsTypeDen;
 }
@@ -696,7 +720,7 @@ TypeDenoterPtr UnaryExpr::DeriveTypeDenoter()
     const auto& typeDen = expr->GetTypeDenoter();
 
     if (IsLogicalOp(op))
-        return std::make_shared<BaseTypeDenoter>(DataType::Bool);
+        return GetCanonicalBaseTypeDenoter(DataType::Bool);
     else
         return typeDen;
 }
@@ -798,7 +822,7 @@ TypeDenoterPtr InitializerExpr::DeriveTypeDenoter()
 {
     if (exprs.empty())
         RuntimeErr("can not derive type of initializer list with no elements", this);
-    return std::make_shared<ArrayTypeDenoter>(exprs.front()->GetTypeDenoter(), std::vector<ExprPtr>{ nullptr });
+    return MakeShared<ArrayTypeDenoter>(exprs.front()->GetTypeDenoter(), std::vector<ExprPtr>{ nullptr });
 }
 
 unsigned int InitializerExpr::NumElements() const
@@ -817,6 +841,15 @@ unsigned int InitializerExpr::NumElements() const
 }
 
 
+/* ----- LiteralBlobExpr ----- */
+
+TypeDenoterPtr LiteralBlobExpr::DeriveTypeDenoter()
+{
+    /* Same shape as InitializerExpr::DeriveTypeDenoter: array of the first element's type */
+    return MakeShared<ArrayTypeDenoter>(GetCanonicalBaseTypeDenoter(dataType), std::vector<ExprPtr>{ nullptr });
+}
+
+
 } // /namespace Xsc
 
 
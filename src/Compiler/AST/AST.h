@@ -58,6 +58,7 @@ class Visitor;
     using ALIAS         = BASE;     \
     using ALIAS##Ptr    = BASE##Ptr
 
+// Flag bit indices must stay below 16: the upper half of the flags word holds the generation tag (see Flags).
 #define FLAG_ENUM \
     enum : unsigned int
 
@@ -122,6 +123,7 @@ struct AST
         CastExpr,
         VarAccessExpr,
         InitializerExpr,
+        LiteralBlobExpr,
     };
 
     virtual ~AST();
@@ -129,17 +131,10 @@ struct AST
     virtual Types Type() const = 0;
     virtual void Visit(Visitor* visitor, void* args = nullptr) = 0;
 
-    #ifdef XSC_ENABLE_MEMORY_POOL
-
-    void* operator new (std::size_t count);
-    void operator delete (void* ptr);
-
-    #endif
-
     FLAG_ENUM
     {
-        FLAG( isReachable, 30 ), // This AST node is reachable from the main entry point (i.e. the use-count >= 1).
-        FLAG( isDeadCode,  29 ), // This AST node is dead code (after return path).
+        FLAG( isReachable, 15 ), // This AST node is reachable from the main entry point (i.e. the use-count >= 1).
+        FLAG( isDeadCode,  14 ), // This AST node is dead code (after return path).
     };
 
     // Returns this AST node as the specified sub class if this AST node has the correct type. Otherwise, null is returned.
@@ -167,15 +162,22 @@ struct TypedAST : public AST
 
     public:
 
-        // Returns a type denoter for AST or throws an std::runtime_error if a type denoter can not be derived.
+        /*
+        Returns a type denoter for AST or throws an std::runtime_error if a type denoter can not be derived.
+        The type denoter is derived once and memoized, so the backend passes reuse what the analyzer established.
+        */
         const TypeDenoterPtr& GetTypeDenoter();
 
+        /*
+        Invalidates the memoized type denoter.
+        Any pass that rewrites this node in a way that changes its type (e.g. the GLSL converter) must call this.
+        */
+        void ResetBufferedTypeDenoter();
+
     protected:
 
         virtual TypeDenoterPtr DeriveTypeDenoter() = 0;
 
-        void ResetBufferedTypeDenoter();
-
     private:
     
         TypeDenoterPtr bufferedTypeDenoter_;
@@ -188,22 +190,38 @@ struct Expr : public TypedAST {};
 // Declaration AST base class.
 struct Decl : public TypedAST {};
 
+/*
+Version independent GLSL extension requirement of a program.
+Collected once during the GLSL conversion, and resolved against each output shader version
+by a plain array scan instead of a renewed AST traversal (see GLSLExtensionAgent).
+*/
+struct GLSLExtensionUsage
+{
+    const char*         extensionName;                  // Extension name as string literal (see GLSLExtension).
+    OutputShaderVersion requiredVersion;                // Minimum GLSL version that covers the feature without the extension.
+    bool                onlyWithExplicitBinding;        // True if the extension is only required when explicit bindings are enabled.
+};
+
 // Program AST root.
 struct Program : public AST
-{   
+{
     AST_INTERFACE(Program)
 
     FLAG_ENUM
     {
         FLAG( hasSM3ScreenSpace, 0 ), // This shader program uses the Shader Model (SM) 3 screen space (VPOS vs. SV_Position).
         FLAG( isFragCoordUsed,   1 ), // This shader program makes use of the fragment coordinate (SV_Position, gl_FragCoord).
+        FLAG( isConvertedGLSL,   2 ), // This shader program has already been converted for GLSL code generation (see GLSLConverter).
     };
 
     std::vector<StmntPtr>               globalStmnts;               // Global declaration statements
+    std::vector<StmntPtr>               prunedGlobalStmnts;         // Detached unreachable global statements; only kept alive, since reachable nodes may still reference them (see GLSLGenerator::PruneUnreachableGlobalStmnts).
 
     SourceCodePtr                       sourceCode;                 // Preprocessed source code
     FunctionDecl*                       entryPointRef   = nullptr;  // Reference to the entry point function declaration.
     std::map<Intrinsic, IntrinsicUsage> usedIntrinsics;             // Set of all used intrinsic (filled by the reference analyzer).
+    std::vector<GLSLExtensionUsage>     glslExtensionUsage;         // Version independent GLSL extension requirements (filled by the extension agent; see isConvertedGLSL).
+    std::vector<std::string>            techniqueIdents;            // Identifiers of the (otherwise ignored) technique declarations (see Options::metadataOnly).
 };
 
 // Code block.
@@ -868,6 +886,22 @@ struct InitializerExpr : public Expr
     std::vector<ExprPtr> exprs;
 };
 
+/*
+Homogeneous literal initializer blob. A giant constant array initializer (e.g. a baked data table
+with thousands of literal elements) is stored as one raw text blob instead of one AST node per
+literal (see HLSLParser::ParseInitializerExpr); the generator writes the blob through verbatim.
+*/
+struct LiteralBlobExpr : public Expr
+{
+    AST_INTERFACE(LiteralBlobExpr);
+
+    TypeDenoterPtr DeriveTypeDenoter() override;
+
+    DataType        dataType    = DataType::Undefined;  // Data type of the first literal element
+    std::string     values;                             // All literal values, separated by ", ", as they were spelled in the source
+    unsigned int    numElements = 0;                    // Number of literal elements in the blob
+};
+
 #undef AST_INTERFACE
 #undef DECL_AST_ALIAS
 #undef FLAG_ENUM
@@ -8,7 +8,6 @@
 #include "ASTEnums.h"
 #include "Exception.h"
 #include "Token.h"
-#include <map>
 
 
 namespace Xsc
@@ -23,22 +22,27 @@ static void MapFailed(const std::string& from, const std::string& to)
     throw std::invalid_argument("failed to map " + from + " to " + to);
 }
 
-template <typename T>
-std::string TypeToString(const std::map<T, std::string>& typeMap, const T& type, const char* typeName)
+/*
+The operator enums are dense (beginning with 'Undefined' = 0), so their spellings are stored in
+plain arrays of string literals indexed by the enum value. These tables require no initialization
+code at process startup, as opposed to the previously used std::map objects.
+*/
+template <typename T, std::size_t N>
+std::string TypeToString(const char* const (&spellTable)[N], const T type, const char* typeName)
 {
-    auto it = typeMap.find(type);
-    if (it != typeMap.end())
-        return it->second;
+    const auto idx = static_cast<std::size_t>(type);
+    if (idx < N && spellTable[idx] != nullptr)
+        return spellTable[idx];
     MapFailed(typeName, "string");
 }
 
-template <typename T>
-T StringToType(const std::map<T, std::string>& typeMap, const std::string& str, const char* typeName)
+template <typename T, std::size_t N>
+T StringToType(const char* const (&spellTable)[N], const std::string& str, const char* typeName)
 {
-     for (const auto& entry : typeMap)
+     for (std::size_t i = 0; i < N; ++i)
      {
-         if (entry.second == str)
-             return entry.first;
+         if (spellTable[i] != nullptr && str == spellTable[i])
+             return static_cast<T>(i);
      }
      MapFailed("string", typeName);
 }
@@ -46,29 +50,30 @@ T StringToType(const std::map<T, std::string>& typeMap, const std::string& str,
 
 /* ----- AssignOp Enum ----- */
 
-static const std::map<AssignOp, std::string> g_mapAssignOp
-{
-    { AssignOp::Set,    "="   },
-    { AssignOp::Add,    "+="  },
-    { AssignOp::Sub,    "-="  },
-    { AssignOp::Mul,    "*="  },
-    { AssignOp::Div,    "/="  },
-    { AssignOp::Mod,    "%="  },
-    { AssignOp::LShift, "<<=" },
-    { AssignOp::RShift, ">>=" },
-    { AssignOp::Or,     "|="  },
-    { AssignOp::And,    "&="  },
-    { AssignOp::Xor,    "^="  },
+static const char* const g_assignOpSpells[] =
+{
+    nullptr,    // Undefined
+    "=",        // Set
+    "+=",       // Add
+    "-=",       // Sub
+    "*=",       // Mul
+    "/=",       // Div
+    "%=",       // Mod
+    "<<=",      // LShift
+    ">>=",      // RShift
+    "|=",       // Or
+    "&=",       // And
+    "^=",       // Xor
 };
 
 std::string AssignOpToString(const AssignOp o)
 {
-    return TypeToString(g_mapAssignOp, o, "AssignOp");
+    return TypeToString(g_assignOpSpells, o, "AssignOp");
 }
 
 AssignOp StringToAssignOp(const std::string& s)
 {
-    return StringToType(g_mapAssignOp, s, "AssignOp");
+    return StringToType<AssignOp>(g_assignOpSpells, s, "AssignOp");
 }
 
 bool IsBitwiseOp(const AssignOp o)
@@ -79,36 +84,37 @@ bool IsBitwiseOp(const AssignOp o)
 
 /* ----- BinaryOp Enum ----- */
 
-static const std::map<BinaryOp, std::string> g_mapBinaryOp
-{
-    { BinaryOp::LogicalAnd,     "&&" },
-    { BinaryOp::LogicalOr,      "||" },
-    { BinaryOp::Or,             "|"  },
-    { BinaryOp::Xor,            "^"  },
-    { BinaryOp::And,            "&"  },
-    { BinaryOp::LShift,         "<<" },
-    { BinaryOp::RShift,         ">>" },
-    { BinaryOp::Add,            "+"  },
-    { BinaryOp::Sub,            "-"  },
-    { BinaryOp::Mul,            "*"  },
-    { BinaryOp::Div,            "/"  },
-    { BinaryOp::Mod,            "%"  },
-    { BinaryOp::Equal,          "==" },
-    { BinaryOp::NotEqual,       "!=" },
-    { BinaryOp::Less,           "<"  },
-    { BinaryOp::Greater,        ">"  },
-    { BinaryOp::LessEqual,      "<=" },
-    { BinaryOp::GreaterEqual,   ">=" },
+static const char* const g_binaryOpSpells[] =
+{
+    nullptr,    // Undefined
+    "&&",       // LogicalAnd
+    "||",       // LogicalOr
+    "|",        // Or
+    "^",        // Xor
+    "&",        // And
+    "<<",       // LShift
+    ">>",       // RShift
+    "+",        // Add
+    "-",        // Sub
+    "*",        // Mul
+    "/",        // Div
+    "%",        // Mod
+    "==",       // Equal
+    "!=",       // NotEqual
+    "<",        // Less
+    ">",        // Greater
+    "<=",       // LessEqual
+    ">=",       // GreaterEqual
 };
 
 std::string BinaryOpToString(const BinaryOp o)
 {
-    return TypeToString(g_mapBinaryOp, o, "BinaryOp");
+    return TypeToString(g_binaryOpSpells, o, "BinaryOp");
 }
 
 BinaryOp StringToBinaryOp(const std::string& s)
 {
-    return StringToType(g_mapBinaryOp, s, "BinaryOp");
+    return StringToType<BinaryOp>(g_binaryOpSpells, s, "BinaryOp");
 }
 
 bool IsLogicalOp(const BinaryOp o)
@@ -129,24 +135,25 @@ bool IsBooleanOp(const BinaryOp o)
 
 /* ----- UnaryOp Enum ----- */
 
-static const std::map<UnaryOp, std::string> g_mapUnaryOp
+static const char* const g_unaryOpSpells[] =
 {
-    { UnaryOp::LogicalNot,  "!"  },
-    { UnaryOp::Not,         "~"  },
-    { UnaryOp::Nop,         "+"  },
-    { UnaryOp::Negate,      "-"  },
-    { UnaryOp::Inc,         "++" },
-    { UnaryOp::Dec,         "--" },
+    nullptr,    // Undefined
+    "!",        // LogicalNot
+    "~",        // Not
+    "+",        // Nop
+    "-",        // Negate
+    "++",       // Inc
+    "--",       // Dec
 };
 
 std::string UnaryOpToString(const UnaryOp o)
 {
-    return TypeToString(g_mapUnaryOp, o, "UnaryOp");
+    return TypeToString(g_unaryOpSpells, o, "UnaryOp");
 }
 
 UnaryOp StringToUnaryOp(const std::string& s)
 {
-    return StringToType(g_mapUnaryOp, s, "UnaryOp");
+    return StringToType<UnaryOp>(g_unaryOpSpells, s, "UnaryOp");
 }
 
 bool IsLogicalOp(const UnaryOp o)
@@ -162,60 +169,74 @@ bool IsBitwiseOp(const UnaryOp o)
 
 /* ----- CtrlTransfer Enum ----- */
 
-static const std::map<CtrlTransfer, std::string> g_mapCtrlTransfer
+static const char* const g_ctrlTransferSpells[] =
 {
-    { CtrlTransfer::Break,      "break"    },
-    { CtrlTransfer::Continue,   "continue" },
-    { CtrlTransfer::Discard,    "discard"  },
+    nullptr,        // Undefined
+    "break",        // Break
+    "continue",     // Continue
+    "discard",      // Discard
 };
 
 std::string CtrlTransformToString(const CtrlTransfer ct)
 {
-    return TypeToString(g_mapCtrlTransfer, ct, "CtrlTransfer");
+    return TypeToString(g_ctrlTransferSpells, ct, "CtrlTransfer");
 }
 
 CtrlTransfer StringToCtrlTransfer(const std::string& s)
 {
-    return StringToType(g_mapCtrlTransfer, s, "CtrlTransfer");
+    return StringToType<CtrlTransfer>(g_ctrlTransferSpells, s, "CtrlTransfer");
 }
 
 
 /* ----- DataType Enum ----- */
 
+// Spelling of a data type (without template syntax), indexed by the DataType enum value.
+#define SPELL_VECTORS(SPELL) \
+    SPELL "2", SPELL "3", SPELL "4"
+
+#define SPELL_MATRICES(SPELL)                   \
+    SPELL "2x2", SPELL "2x3", SPELL "2x4",      \
+    SPELL "3x2", SPELL "3x3", SPELL "3x4",      \
+    SPELL "4x2", SPELL "4x3", SPELL "4x4"
+
+static const char* g_dataTypeSpells[] =
+{
+    "<undefined>",
+    "string",
+
+    "bool", "int", "uint", "half", "float", "double",
+
+    SPELL_VECTORS( "bool"   ),
+    SPELL_VECTORS( "int"    ),
+    SPELL_VECTORS( "uint"   ),
+    SPELL_VECTORS( "half"   ),
+    SPELL_VECTORS( "float"  ),
+    SPELL_VECTORS( "double" ),
+
+    SPELL_MATRICES( "bool"   ),
+    SPELL_MATRICES( "int"    ),
+    SPELL_MATRICES( "uint"   ),
+    SPELL_MATRICES( "half"   ),
+    SPELL_MATRICES( "float"  ),
+    SPELL_MATRICES( "double" ),
+};
+
+#undef SPELL_VECTORS
+#undef SPELL_MATRICES
+
 std::string DataTypeToString(const DataType t, bool useTemplateSyntax)
 {
-    if (t == DataType::String)
-        return "string";
-    else if (IsScalarType(t))
-    {
-        switch (t)
-        {
-            case DataType::Bool:    return "bool";
-            case DataType::Int:     return "int";
-            case DataType::UInt:    return "uint";
-            case DataType::Half:    return "half";
-            case DataType::Float:   return "float";
-            case DataType::Double:  return "double";
-            default:                break;
-        }
-    }
-    else if (IsVectorType(t))
+    if (useTemplateSyntax && IsVectorType(t))
     {
         auto dim = VectorTypeDim(t);
-        if (useTemplateSyntax)
-            return "vector<" + DataTypeToString(BaseDataType(t)) + ", " + std::to_string(dim) + ">";
-        else
-            return DataTypeToString(BaseDataType(t)) + std::to_string(dim);
+        return "vector<" + DataTypeToString(BaseDataType(t)) + ", " + std::to_string(dim) + ">";
     }
-    else if (IsMatrixType(t))
+    else if (useTemplateSyntax && IsMatrixType(t))
     {
         auto dim = MatrixTypeDim(t);
-        if (useTemplateSyntax)
-            return "matrix<" + DataTypeToString(BaseDataType(t)) + ", " + std::to_string(dim.first) + ", " + std::to_string(dim.second) + ">";
-        else
-            return DataTypeToString(BaseDataType(t)) + std::to_string(dim.first) + "x" + std::to_string(dim.second);
+        return "matrix<" + DataTypeToString(BaseDataType(t)) + ", " + std::to_string(dim.first) + ", " + std::to_string(dim.second) + ">";
     }
-    return "<undefined>";
+    return g_dataTypeSpells[static_cast<int>(t)];
 }
 
 bool IsScalarType(const DataType t)
@@ -283,224 +304,129 @@ bool IsUIntType(const DataType t)
     );
 }
 
-int VectorTypeDim(const DataType t)
+static constexpr int Idx(const DataType t)
 {
-    switch (t)
-    {
-        case DataType::Bool:
-        case DataType::Int:
-        case DataType::UInt:
-        case DataType::Half:
-        case DataType::Float:
-        case DataType::Double:
-            return 1;
-    
-        case DataType::Bool2:
-        case DataType::Int2:
-        case DataType::UInt2:
-        case DataType::Half2:
-        case DataType::Float2:
-        case DataType::Double2:
-            return 2;
-
-        case DataType::Bool3:
-        case DataType::Int3:
-        case DataType::UInt3:
-        case DataType::Half3:
-        case DataType::Float3:
-        case DataType::Double3:
-            return 3;
-
-        case DataType::Bool4:
-        case DataType::Int4:
-        case DataType::UInt4:
-        case DataType::Half4:
-        case DataType::Float4:
-        case DataType::Double4:
-            return 4;
+    return static_cast<int>(t);
+};
 
-        default:
-            break;
-    }
-    return 0;
-}
+/*
+Dense (de-)composition tables for the scalar/vector/matrix data types.
+The DataType enum lays out all variants contiguously (grouped by base type),
+so both directions are plain table lookups instead of switch cascades.
+*/
 
-std::pair<int, int> MatrixTypeDim(const DataType t)
+// Scalar base type and dimensions of a data type, indexed by the DataType enum value.
+struct DataTypeShape
 {
-    switch (t)
-    {
-        case DataType::Bool:
-        case DataType::Int:
-        case DataType::UInt:
-        case DataType::Half:
-        case DataType::Float:
-        case DataType::Double:
-            return { 1, 1 };
-    
-        case DataType::Bool2:
-        case DataType::Int2:
-        case DataType::UInt2:
-        case DataType::Half2:
-        case DataType::Float2:
-        case DataType::Double2:
-            return { 2, 1 };
-
-        case DataType::Bool3:
-        case DataType::Int3:
-        case DataType::UInt3:
-        case DataType::Half3:
-        case DataType::Float3:
-        case DataType::Double3:
-            return { 3, 1 };
-
-        case DataType::Bool4:
-        case DataType::Int4:
-        case DataType::UInt4:
-        case DataType::Half4:
-        case DataType::Float4:
-        case DataType::Double4:
-            return { 4, 1 };
-
-        case DataType::Bool2x2:
-        case DataType::Int2x2:
-        case DataType::UInt2x2:
-        case DataType::Half2x2:
-        case DataType::Float2x2:
-        case DataType::Double2x2:
-            return { 2, 2 };
-
-        case DataType::Bool2x3:
-        case DataType::Int2x3:
-        case DataType::UInt2x3:
-        case DataType::Half2x3:
-        case DataType::Float2x3:
-        case DataType::Double2x3:
-            return { 2, 3 };
-
-        case DataType::Bool2x4:
-        case DataType::Int2x4:
-        case DataType::UInt2x4:
-        case DataType::Half2x4:
-        case DataType::Float2x4:
-        case DataType::Double2x4:
-            return { 2, 4 };
-
-        case DataType::Bool3x2:
-        case DataType::Int3x2:
-        case DataType::UInt3x2:
-        case DataType::Half3x2:
-        case DataType::Float3x2:
-        case DataType::Double3x2:
-            return { 3, 2 };
-
-        case DataType::Bool3x3:
-        case DataType::Int3x3:
-        case DataType::UInt3x3:
-        case DataType::Half3x3:
-        case DataType::Float3x3:
-        case DataType::Double3x3:
-            return { 3, 3 };
-
-        case DataType::Bool3x4:
-        case DataType::Int3x4:
-        case DataType::UInt3x4:
-        case DataType::Half3x4:
-        case DataType::Float3x4:
-        case DataType::Double3x4:
-            return { 3, 4 };
-
-        case DataType::Bool4x2:
-        case DataType::Int4x2:
-        case DataType::UInt4x2:
-        case DataType::Half4x2:
-        case DataType::Float4x2:
-        case DataType::Double4x2:
-            return { 4, 2 };
-
-        case DataType::Bool4x3:
-        case DataType::Int4x3:
-        case DataType::UInt4x3:
-        case DataType::Half4x3:
-        case DataType::Float4x3:
-        case DataType::Double4x3:
-            return { 4, 3 };
-
-        case DataType::Bool4x4:
-        case DataType::Int4x4:
-        case DataType::UInt4x4:
-        case DataType::Half4x4:
-        case DataType::Float4x4:
-        case DataType::Double4x4:
-            return { 4, 4 };
+    DataType    baseType;
+    int         rows;
+    int         cols;
+};
 
-        default:
-            break;
+#define SHAPE_SCALAR(TYPENAME)  \
+    { DataType::TYPENAME, 1, 1 }
+
+#define SHAPE_VECTORS(TYPENAME)     \
+    { DataType::TYPENAME, 2, 1 },   \
+    { DataType::TYPENAME, 3, 1 },   \
+    { DataType::TYPENAME, 4, 1 }
+
+#define SHAPE_MATRICES(TYPENAME)    \
+    { DataType::TYPENAME, 2, 2 },   \
+    { DataType::TYPENAME, 2, 3 },   \
+    { DataType::TYPENAME, 2, 4 },   \
+    { DataType::TYPENAME, 3, 2 },   \
+    { DataType::TYPENAME, 3, 3 },   \
+    { DataType::TYPENAME, 3, 4 },   \
+    { DataType::TYPENAME, 4, 2 },   \
+    { DataType::TYPENAME, 4, 3 },   \
+    { DataType::TYPENAME, 4, 4 }
+
+static const DataTypeShape g_dataTypeShapes[] =
+{
+    { DataType::Undefined, 0, 0 },
+    { DataType::String,    0, 0 },
+
+    SHAPE_SCALAR( Bool   ),
+    SHAPE_SCALAR( Int    ),
+    SHAPE_SCALAR( UInt   ),
+    SHAPE_SCALAR( Half   ),
+    SHAPE_SCALAR( Float  ),
+    SHAPE_SCALAR( Double ),
+
+    SHAPE_VECTORS( Bool   ),
+    SHAPE_VECTORS( Int    ),
+    SHAPE_VECTORS( UInt   ),
+    SHAPE_VECTORS( Half   ),
+    SHAPE_VECTORS( Float  ),
+    SHAPE_VECTORS( Double ),
+
+    SHAPE_MATRICES( Bool   ),
+    SHAPE_MATRICES( Int    ),
+    SHAPE_MATRICES( UInt   ),
+    SHAPE_MATRICES( Half   ),
+    SHAPE_MATRICES( Float  ),
+    SHAPE_MATRICES( Double ),
+};
+
+#undef SHAPE_SCALAR
+#undef SHAPE_VECTORS
+#undef SHAPE_MATRICES
+
+static_assert(
+    sizeof(g_dataTypeShapes)/sizeof(g_dataTypeShapes[0]) == Idx(DataType::Double4x4) + 1,
+    "data type shape table does not cover the DataType enumeration"
+);
+
+// Composed data type, indexed by (base type - Bool, rows - 1, cols - 1); one dimension of 1 yields a vector, both yield the scalar.
+#define COMPOSE_TYPES(TYPENAME)                                                                             \
+    {                                                                                                       \
+        { DataType::TYPENAME,      DataType::TYPENAME##2,   DataType::TYPENAME##3,   DataType::TYPENAME##4   }, \
+        { DataType::TYPENAME##2,   DataType::TYPENAME##2x2, DataType::TYPENAME##2x3, DataType::TYPENAME##2x4 }, \
+        { DataType::TYPENAME##3,   DataType::TYPENAME##3x2, DataType::TYPENAME##3x3, DataType::TYPENAME##3x4 }, \
+        { DataType::TYPENAME##4,   DataType::TYPENAME##4x2, DataType::TYPENAME##4x3, DataType::TYPENAME##4x4 }, \
     }
-    return { 0, 0 };
-}
 
-DataType BaseDataType(const DataType t)
+static const DataType g_composedDataTypes[6][4][4] =
 {
-    #define FIND_BASETYPE(TYPENAME)                                                 \
-        if ( ( t >= DataType::TYPENAME##2   && t <= DataType::TYPENAME##4   ) ||    \
-             ( t >= DataType::TYPENAME##2x2 && t <= DataType::TYPENAME##4x4 ) )     \
-        {                                                                           \
-            return DataType::TYPENAME;                                              \
-        }
+    COMPOSE_TYPES( Bool   ),
+    COMPOSE_TYPES( Int    ),
+    COMPOSE_TYPES( UInt   ),
+    COMPOSE_TYPES( Half   ),
+    COMPOSE_TYPES( Float  ),
+    COMPOSE_TYPES( Double ),
+};
 
-    FIND_BASETYPE( Bool   );
-    FIND_BASETYPE( Int    );
-    FIND_BASETYPE( UInt   );
-    FIND_BASETYPE( Half   );
-    FIND_BASETYPE( Float  );
-    FIND_BASETYPE( Double );
+#undef COMPOSE_TYPES
 
-    return t;
+int VectorTypeDim(const DataType t)
+{
+    const auto& shape = g_dataTypeShapes[Idx(t)];
+    return (shape.cols > 1 ? 0 : shape.rows);
+}
 
-    #undef FIND_BASETYPE
+std::pair<int, int> MatrixTypeDim(const DataType t)
+{
+    const auto& shape = g_dataTypeShapes[Idx(t)];
+    return { shape.rows, shape.cols };
 }
 
-static int Idx(const DataType t)
+DataType BaseDataType(const DataType t)
 {
-    return static_cast<int>(t);
-};
+    return g_dataTypeShapes[Idx(t)].baseType;
+}
 
 DataType VectorDataType(const DataType baseDataType, int vectorSize)
 {
-    if (IsScalarType(baseDataType))
-    {
-        if (vectorSize >= 2 && vectorSize <= 4)
-        {
-            auto offset = (Idx(baseDataType) - Idx(DataType::Bool));
-            auto idx    = Idx(DataType::Bool2) + offset*3 + (vectorSize - 2);
-
-            return static_cast<DataType>(idx);
-        }
-        else if (vectorSize == 1)
-            return baseDataType;
-    }
+    if (IsScalarType(baseDataType) && vectorSize >= 1 && vectorSize <= 4)
+        return g_composedDataTypes[Idx(baseDataType) - Idx(DataType::Bool)][0][vectorSize - 1];
     return DataType::Undefined;
 }
 
 DataType MatrixDataType(const DataType baseDataType, int rows, int columns)
 {
-    if (IsScalarType(baseDataType))
-    {
-        if (rows == 1 && columns == 1)
-            return baseDataType;
-        if (rows == 1)
-            return VectorDataType(baseDataType, columns);
-        if (columns == 1)
-            return VectorDataType(baseDataType, rows);
-
-        if (rows >= 2 && rows <= 4 && columns >= 2 && columns <= 4)
-        {
-            auto offset = (Idx(baseDataType) - Idx(DataType::Bool));
-            auto idx    = Idx(DataType::Bool2x2) + offset*9 + (rows - 2)*3 + (columns - 2);
-
-            return static_cast<DataType>(idx);
-        }
-    }
+    if (IsScalarType(baseDataType) && rows >= 1 && rows <= 4 && columns >= 1 && columns <= 4)
+        return g_composedDataTypes[Idx(baseDataType) - Idx(DataType::Bool)][rows - 1][columns - 1];
     return DataType::Undefined;
 }
 
@@ -676,6 +602,38 @@ bool IsInterpolationModifier(const StorageClass s)
 
 /* ----- BufferType Enum ----- */
 
+std::string BufferTypeToString(const BufferType t)
+{
+    switch (t)
+    {
+        case BufferType::Undefined:                 break;
+        case BufferType::Buffer:                    return "Buffer";
+        case BufferType::StucturedBuffer:           return "StructuredBuffer";
+        case BufferType::ByteAddressBuffer:         return "ByteAddressBuffer";
+        case BufferType::RWBuffer:                  return "RWBuffer";
+        case BufferType::RWStucturedBuffer:         return "RWStructuredBuffer";
+        case BufferType::RWByteAddressBuffer:       return "RWByteAddressBuffer";
+        case BufferType::AppendStructuredBuffer:    return "AppendStructuredBuffer";
+        case BufferType::ConsumeStructuredBuffer:   return "ConsumeStructuredBuffer";
+        case BufferType::RWTexture1D:               return "RWTexture1D";
+        case BufferType::RWTexture1DArray:          return "RWTexture1DArray";
+        case BufferType::RWTexture2D:               return "RWTexture2D";
+        case BufferType::RWTexture2DArray:          return "RWTexture2DArray";
+        case BufferType::RWTexture3D:               return "RWTexture3D";
+        case BufferType::Texture1D:                 return "Texture1D";
+        case BufferType::Texture1DArray:            return "Texture1DArray";
+        case BufferType::Texture2D:                 return "Texture2D";
+        case BufferType::Texture2DArray:            return "Texture2DArray";
+        case BufferType::Texture3D:                 return "Texture3D";
+        case BufferType::TextureCube:               return "TextureCube";
+        case BufferType::TextureCubeArray:          return "TextureCubeArray";
+        case BufferType::Texture2DMS:               return "Texture2DMS";
+        case BufferType::Texture2DMSArray:          return "Texture2DMSArray";
+        case BufferType::GenericTexture:            return "texture";
+    }
+    return "";
+}
+
 bool IsStorageBufferType(const BufferType t)
 {
     return (t >= BufferType::Buffer && t <= BufferType::ConsumeStructuredBuffer);
@@ -766,6 +724,44 @@ bool IsTextureIntrinsic(const Intrinsic t)
     return (t >= Intrinsic::Texture_GetDimensions && t <= Intrinsic::Texture_SampleLevel_5);
 }
 
+bool IsTranscendentalIntrinsic(const Intrinsic t)
+{
+    switch (t)
+    {
+        case Intrinsic::ACos:
+        case Intrinsic::ASin:
+        case Intrinsic::ATan:
+        case Intrinsic::ATan2:
+        case Intrinsic::Cos:
+        case Intrinsic::CosH:
+        case Intrinsic::Exp:
+        case Intrinsic::Exp2:
+        case Intrinsic::Log:
+        case Intrinsic::Log10:
+        case Intrinsic::Log2:
+        case Intrinsic::Pow:
+        case Intrinsic::RSqrt:
+        case Intrinsic::Sin:
+        case Intrinsic::SinCos:
+        case Intrinsic::SinH:
+        case Intrinsic::Sqrt:
+        case Intrinsic::Tan:
+        case Intrinsic::TanH:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool IsTextureFetchIntrinsic(const Intrinsic t)
+{
+    return
+    (
+        ( t >= Intrinsic::Tex1D_2        && t <= Intrinsic::TexCubeProj           ) ||
+        ( t >= Intrinsic::Texture_Load_1 && t <= Intrinsic::Texture_SampleLevel_5 )
+    );
+}
+
 
 /* ----- IndexedSemantic Class ----- */
 
@@ -354,6 +354,9 @@ enum class BufferType
     GenericTexture,             // Texture of unspecified dimension (used in DX9 effect files: "texture" keyword).
 };
 
+// Returns the string representation of the specified BufferType value (e.g. "Texture2D").
+std::string BufferTypeToString(const BufferType t);
+
 // Returns true if the specified buffer type is a storage buffer type (e.g. BufferType::Buffer, or BufferType::RWStructuredBuffer).
 bool IsStorageBufferType(const BufferType t);
 
@@ -612,6 +615,12 @@ bool IsGlobalIntrinsic(const Intrinsic t);
 // Returns true if the speciifed intrinsic belongs to a texture object.
 bool IsTextureIntrinsic(const Intrinsic t);
 
+// Returns true if the specified intrinsic is a transcendental operation (trigonometry, exponentials, roots).
+bool IsTranscendentalIntrinsic(const Intrinsic t);
+
+// Returns true if the specified intrinsic fetches from a texture (sampling and loads, including the legacy "tex*" intrinsics).
+bool IsTextureFetchIntrinsic(const Intrinsic t);
+
 
 /* ----- Semantic Enum ----- */
 
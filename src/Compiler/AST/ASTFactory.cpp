@@ -78,6 +78,20 @@ FunctionCallExprPtr MakeIntrinsicCallExpr(
     return ast;
 }
 
+FunctionCallExprPtr MakeTypeConstructorCallExpr(const TypeDenoterPtr& typeDenoter, const std::vector<ExprPtr>& arguments)
+{
+    auto ast = MakeAST<FunctionCallExpr>();
+    {
+        auto funcCall = MakeAST<FunctionCall>();
+        {
+            funcCall->typeDenoter   = typeDenoter;
+            funcCall->arguments     = arguments;
+        }
+        ast->call = funcCall;
+    }
+    return ast;
+}
+
 ListExprPtr MakeSeparatedSinCosFunctionCalls(FunctionCall& funcCall)
 {
     if (funcCall.arguments.size() == 3)
@@ -133,14 +147,19 @@ CastExprPtr MakeCastExpr(const TypeDenoterPtr& typeDenoter, const ExprPtr& value
     return ast;
 }
 
-CastExprPtr MakeLiteralCastExpr(const TypeDenoterPtr& typeDenoter, const DataType literalType, const std::string& literalValue)
+LiteralExprPtr MakeLiteralExpr(const DataType literalType, const std::string& literalValue)
 {
-    auto literalExpr = MakeAST<LiteralExpr>();
+    auto ast = MakeAST<LiteralExpr>();
     {
-        literalExpr->dataType   = literalType;
-        literalExpr->value      = literalValue;
+        ast->dataType   = literalType;
+        ast->value      = literalValue;
     }
-    return MakeCastExpr(typeDenoter, literalExpr);
+    return ast;
+}
+
+CastExprPtr MakeLiteralCastExpr(const TypeDenoterPtr& typeDenoter, const DataType literalType, const std::string& literalValue)
+{
+    return MakeCastExpr(typeDenoter, MakeLiteralExpr(literalType, literalValue));
 }
 
 ExprPtr ConvertExprBaseType(const DataType dataType, const ExprPtr& subExpr)
@@ -158,7 +177,7 @@ ExprPtr ConvertExprBaseType(const DataType dataType, const ExprPtr& subExpr)
         auto ast = MakeShared<CastExpr>(subExpr->area);
         {
             ast->typeExpr               = MakeAST<TypeNameExpr>();
-            ast->typeExpr->typeDenoter  = MakeShared<BaseTypeDenoter>(dataType);
+            ast->typeExpr->typeDenoter  = GetCanonicalBaseTypeDenoter(dataType);
             ast->expr                   = subExpr;
         }
         return ast;
@@ -172,7 +191,7 @@ AliasDeclStmntPtr MakeBaseTypeAlias(const DataType dataType, const std::string&
         auto aliasDecl = MakeAST<AliasDecl>();
         {
             aliasDecl->ident        = ident;
-            aliasDecl->typeDenoter  = MakeShared<BaseTypeDenoter>(dataType);
+            aliasDecl->typeDenoter  = GetCanonicalBaseTypeDenoter(dataType);
             aliasDecl->declStmntRef = ast.get();
         }
         ast->aliasDecls.push_back(aliasDecl);
@@ -184,7 +203,7 @@ VarTypePtr MakeVarType(const DataType dataType)
 {
     auto ast = MakeAST<VarType>();
     {
-        ast->typeDenoter = MakeShared<BaseTypeDenoter>(dataType);
+        ast->typeDenoter = GetCanonicalBaseTypeDenoter(dataType);
     }
     return ast;
 }
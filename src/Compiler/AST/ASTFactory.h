@@ -31,9 +31,14 @@ FunctionCallExprPtr MakeIntrinsicCallExpr(
     const TypeDenoterPtr& typeDenoter, const std::vector<ExprPtr>& arguments
 );
 
+// Makes a type constructor call expression (e.g. "float4(...)").
+FunctionCallExprPtr MakeTypeConstructorCallExpr(const TypeDenoterPtr& typeDenoter, const std::vector<ExprPtr>& arguments);
+
 // Converts the specified function call from "sincos(x, s, c)" to "s = sin(x), c = cos(x)".
 ListExprPtr MakeSeparatedSinCosFunctionCalls(FunctionCall& funcCall);
 
+LiteralExprPtr MakeLiteralExpr(const DataType literalType, const std::string& literalValue);
+
 CastExprPtr MakeCastExpr(const TypeDenoterPtr& typeDenoter, const ExprPtr& valueExpr);
 CastExprPtr MakeLiteralCastExpr(const TypeDenoterPtr& typeDenoter, const DataType literalType, const std::string& literalValue);
 
@@ -249,6 +249,8 @@ IMPLEMENT_VISIT_PROC_DEFAULT(VarAccessExpr)
 
 IMPLEMENT_VISIT_PROC_DEFAULT(InitializerExpr)
 
+IMPLEMENT_VISIT_PROC_DEFAULT(LiteralBlobExpr)
+
 #undef IMPLEMENT_VISIT_PROC_DEFAULT
 #undef IMPLEMENT_VISIT_PROC
 #undef DEFAULT_VISITOR
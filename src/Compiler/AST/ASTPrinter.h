@@ -86,6 +86,7 @@ class ASTPrinter : private Visitor
         DECL_VISIT_PROC( CastExpr          );
         DECL_VISIT_PROC( VarAccessExpr     );
         DECL_VISIT_PROC( InitializerExpr   );
+        DECL_VISIT_PROC( LiteralBlobExpr   );
 
         /* --- Helper functions --- */
 
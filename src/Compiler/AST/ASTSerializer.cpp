@@ -0,0 +1,385 @@
+/*
+ * ASTSerializer.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "ASTSerializer.h"
+#include "AST.h"
+
+
+namespace Xsc
+{
+
+
+/*
+Binary AST dump file format ("XSAD", version 1):
+
+All integers are stored in native byte order with the fixed widths given below,
+so a tool on the same machine can read the dump by memory-mapping the file and
+casting the record arrays in place.
+
+Header
+    uint32      magic number ("XSAD" = 0x58534144)
+    uint32      format version (currently 1)
+    uint32      number of node records
+    uint32      number of interned strings
+
+Node records (one fixed-width record per AST node, in depth-first pre-order)
+    uint32      node type tag (value of the "AST::Types" enumeration)
+    uint32      subtree size (number of records including this one; the next sibling starts that many records later)
+    uint32      string index (into the string records, or 0xFFFFFFFF if the node carries no info string)
+    uint32      source row (1-based, 0 if the node has no source position)
+    uint32      source column (1-based, 0 if the node has no source position)
+    uint32      reserved (must be 0)
+
+String records (one fixed-width record per interned string)
+    uint64      offset of the string within the string data section
+    uint32      string size (in bytes, strings are not null-terminated)
+    uint32      reserved (must be 0)
+
+String data section
+    Raw string bytes, referenced by the string records. Strings are deduplicated,
+    i.e. all nodes with the same info string share one record.
+*/
+
+static const std::uint32_t magicNumberXSAD_     = 0x58534144;
+static const std::uint32_t formatVersionXSAD_   = 1;
+static const std::uint32_t invalidStringIndex_  = 0xFFFFFFFF;
+
+static void WriteU32(std::ostream& stream, std::uint32_t value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void WriteU64(std::ostream& stream, std::uint64_t value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void ASTSerializer::SerializeAST(Program* program, std::ostream& stream)
+{
+    /* Collect node records and interned strings in a pre-order traversal */
+    nodes_.clear();
+    strings_.clear();
+    stringIndices_.clear();
+
+    Visit(program);
+
+    /* Write header */
+    WriteU32(stream, magicNumberXSAD_);
+    WriteU32(stream, formatVersionXSAD_);
+    WriteU32(stream, static_cast<std::uint32_t>(nodes_.size()));
+    WriteU32(stream, static_cast<std::uint32_t>(strings_.size()));
+
+    /* Write node records */
+    for (const auto& node : nodes_)
+    {
+        WriteU32(stream, node.typeTag);
+        WriteU32(stream, node.subtreeSize);
+        WriteU32(stream, node.stringIndex);
+        WriteU32(stream, node.row);
+        WriteU32(stream, node.column);
+        WriteU32(stream, node.reserved);
+    }
+
+    /* Write string records */
+    std::uint64_t offset = 0;
+    for (const auto& str : strings_)
+    {
+        WriteU64(stream, offset);
+        WriteU32(stream, static_cast<std::uint32_t>(str.size()));
+        WriteU32(stream, 0);
+        offset += str.size();
+    }
+
+    /* Write string data section */
+    for (const auto& str : strings_)
+        stream.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+
+/*
+ * ======= Private: =======
+ */
+
+/*
+Patches the subtree size of a node record once all children have been appended.
+The record index must be captured on scope entry, because the records vector
+grows (and may reallocate) while the children are visited.
+*/
+class ASTSerializer::ScopedNode
+{
+    public:
+
+        inline ScopedNode(ASTSerializer& serializer, AST* ast, const std::string& info = "") :
+            serializer_ { serializer                       },
+            nodeIndex_  { serializer.BeginNode(ast, info)  }
+        {
+        }
+
+        inline ~ScopedNode()
+        {
+            auto& node = serializer_.nodes_[nodeIndex_];
+            node.subtreeSize = static_cast<std::uint32_t>(serializer_.nodes_.size() - nodeIndex_);
+        }
+
+    private:
+
+        ASTSerializer&  serializer_;
+        std::size_t     nodeIndex_;
+
+};
+
+#define DEFAULT_VISITOR(AST_NAME) \
+    Visitor::Visit##AST_NAME(ast, args)
+
+#define IMPLEMENT_VISIT_PROC_DEFAULT(AST_NAME)  \
+    IMPLEMENT_VISIT_PROC(AST_NAME)              \
+    {                                           \
+        ScopedNode node(*this, ast);            \
+        DEFAULT_VISITOR(AST_NAME);              \
+    }
+
+/* ------- Visit functions ------- */
+
+#define IMPLEMENT_VISIT_PROC(AST_NAME) \
+    void ASTSerializer::Visit##AST_NAME(AST_NAME* ast, void* args)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(Program)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(CodeBlock)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(FunctionCall)
+
+IMPLEMENT_VISIT_PROC(Attribute)
+{
+    ScopedNode node(*this, ast, ast->ident);
+    DEFAULT_VISITOR(Attribute);
+}
+
+IMPLEMENT_VISIT_PROC_DEFAULT(SwitchCase)
+
+IMPLEMENT_VISIT_PROC(SamplerValue)
+{
+    ScopedNode node(*this, ast, ast->name);
+    DEFAULT_VISITOR(SamplerValue);
+}
+
+IMPLEMENT_VISIT_PROC(Register)
+{
+    ScopedNode node(*this, ast, ast->ToString());
+    DEFAULT_VISITOR(Register);
+}
+
+IMPLEMENT_VISIT_PROC(PackOffset)
+{
+    ScopedNode node(*this, ast, ast->ToString());
+    DEFAULT_VISITOR(PackOffset);
+}
+
+IMPLEMENT_VISIT_PROC(VarType)
+{
+    ScopedNode node(*this, ast, (ast->typeDenoter ? ast->typeDenoter->ToString() : ""));
+    DEFAULT_VISITOR(VarType);
+}
+
+IMPLEMENT_VISIT_PROC(VarIdent)
+{
+    ScopedNode node(*this, ast, ast->ident);
+    DEFAULT_VISITOR(VarIdent);
+}
+
+/* --- Declaration --- */
+
+IMPLEMENT_VISIT_PROC(VarDecl)
+{
+    ScopedNode node(*this, ast, ast->ident);
+    DEFAULT_VISITOR(VarDecl);
+}
+
+IMPLEMENT_VISIT_PROC(TextureDecl)
+{
+    ScopedNode node(*this, ast, ast->ident);
+    DEFAULT_VISITOR(TextureDecl);
+}
+
+IMPLEMENT_VISIT_PROC(SamplerDecl)
+{
+    ScopedNode node(*this, ast, ast->ident);
+    DEFAULT_VISITOR(SamplerDecl);
+}
+
+IMPLEMENT_VISIT_PROC(StructDecl)
+{
+    auto info = ast->ident;
+    if (!ast->baseStructName.empty())
+        info += " : " + ast->baseStructName;
+
+    ScopedNode node(*this, ast, info);
+    DEFAULT_VISITOR(StructDecl);
+}
+
+IMPLEMENT_VISIT_PROC(AliasDecl)
+{
+    ScopedNode node(*this, ast, ast->ident);
+    DEFAULT_VISITOR(AliasDecl);
+}
+
+/* --- Declaration statements --- */
+
+IMPLEMENT_VISIT_PROC(FunctionDecl)
+{
+    ScopedNode node(*this, ast, ast->ident);
+    DEFAULT_VISITOR(FunctionDecl);
+}
+
+IMPLEMENT_VISIT_PROC_DEFAULT(VarDeclStmnt)
+
+IMPLEMENT_VISIT_PROC(BufferDeclStmnt)
+{
+    ScopedNode node(*this, ast, ast->ToString());
+    DEFAULT_VISITOR(BufferDeclStmnt);
+}
+
+IMPLEMENT_VISIT_PROC_DEFAULT(TextureDeclStmnt)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(SamplerDeclStmnt)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(StructDeclStmnt)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(AliasDeclStmnt)
+
+/* --- Statements --- */
+
+IMPLEMENT_VISIT_PROC_DEFAULT(NullStmnt)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(CodeBlockStmnt)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(ForLoopStmnt)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(WhileLoopStmnt)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(DoWhileLoopStmnt)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(IfStmnt)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(ElseStmnt)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(SwitchStmnt)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(ExprStmnt)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(ReturnStmnt)
+
+IMPLEMENT_VISIT_PROC(CtrlTransferStmnt)
+{
+    ScopedNode node(*this, ast, CtrlTransformToString(ast->transfer));
+    DEFAULT_VISITOR(CtrlTransferStmnt);
+}
+
+/* --- Expressions --- */
+
+IMPLEMENT_VISIT_PROC_DEFAULT(NullExpr)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(ListExpr)
+
+IMPLEMENT_VISIT_PROC(LiteralExpr)
+{
+    ScopedNode node(*this, ast, ast->value);
+    DEFAULT_VISITOR(LiteralExpr);
+}
+
+IMPLEMENT_VISIT_PROC(TypeNameExpr)
+{
+    ScopedNode node(*this, ast, ast->typeDenoter->ToString());
+    DEFAULT_VISITOR(TypeNameExpr);
+}
+
+IMPLEMENT_VISIT_PROC_DEFAULT(TernaryExpr)
+
+IMPLEMENT_VISIT_PROC(BinaryExpr)
+{
+    ScopedNode node(*this, ast, BinaryOpToString(ast->op));
+    DEFAULT_VISITOR(BinaryExpr);
+}
+
+IMPLEMENT_VISIT_PROC(UnaryExpr)
+{
+    ScopedNode node(*this, ast, UnaryOpToString(ast->op));
+    DEFAULT_VISITOR(UnaryExpr);
+}
+
+IMPLEMENT_VISIT_PROC(PostUnaryExpr)
+{
+    ScopedNode node(*this, ast, UnaryOpToString(ast->op));
+    DEFAULT_VISITOR(PostUnaryExpr);
+}
+
+IMPLEMENT_VISIT_PROC_DEFAULT(FunctionCallExpr)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(BracketExpr)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(SuffixExpr)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(ArrayAccessExpr)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(CastExpr)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(VarAccessExpr)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(InitializerExpr)
+
+IMPLEMENT_VISIT_PROC_DEFAULT(LiteralBlobExpr)
+
+#undef IMPLEMENT_VISIT_PROC_DEFAULT
+#undef IMPLEMENT_VISIT_PROC
+#undef DEFAULT_VISITOR
+
+/* --- Helper functions --- */
+
+std::size_t ASTSerializer::BeginNode(AST* ast, const std::string& info)
+{
+    NodeRecord node;
+
+    node.typeTag        = static_cast<std::uint32_t>(ast->Type());
+    node.subtreeSize    = 1;
+    node.stringIndex    = (info.empty() ? invalidStringIndex_ : InternString(info));
+    node.reserved       = 0;
+
+    /* Unlike the text printer, nodes without a source position are kept, so the parent/child structure stays intact */
+    if (ast->area.Pos().IsValid())
+    {
+        node.row    = static_cast<std::uint32_t>(ast->area.Pos().Row());
+        node.column = static_cast<std::uint32_t>(ast->area.Pos().Column());
+    }
+    else
+    {
+        node.row    = 0;
+        node.column = 0;
+    }
+
+    nodes_.push_back(node);
+
+    return (nodes_.size() - 1);
+}
+
+std::uint32_t ASTSerializer::InternString(const std::string& str)
+{
+    auto it = stringIndices_.find(str);
+    if (it != stringIndices_.end())
+        return it->second;
+
+    auto index = static_cast<std::uint32_t>(strings_.size());
+    strings_.push_back(str);
+    stringIndices_[str] = index;
+
+    return index;
+}
+
+
+} // /namespace Xsc
+
+
+// ================================================================================
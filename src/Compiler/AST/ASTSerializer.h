@@ -0,0 +1,134 @@
+/*
+ * ASTSerializer.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_AST_SERIALIZER_H
+#define XSC_AST_SERIALIZER_H
+
+
+#include <Xsc/Xsc.h>
+#include "Visitor.h"
+
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+
+namespace Xsc
+{
+
+
+/*
+Binary AST dump writer for external analysis tooling (the counterpart of the textual ASTPrinter).
+The tree is serialized in pre-order with fixed-width node records (type tag, subtree size, interned
+info string, source position), so tools can reconstruct or skip subtrees directly on a memory-mapped
+dump instead of parsing the indented text report (see the format comment in ASTSerializer.cpp).
+*/
+class ASTSerializer : private Visitor
+{
+
+    public:
+
+        void SerializeAST(Program* program, std::ostream& stream);
+
+    private:
+
+        // Fixed-width node record of the dump format (pre-order; the subtree size is patched after the children).
+        struct NodeRecord
+        {
+            std::uint32_t typeTag;
+            std::uint32_t subtreeSize;
+            std::uint32_t stringIndex;
+            std::uint32_t row;
+            std::uint32_t column;
+            std::uint32_t reserved;
+        };
+
+        class ScopedNode;
+
+        /* --- Visitor implementation --- */
+
+        DECL_VISIT_PROC( Program           );
+        DECL_VISIT_PROC( CodeBlock         );
+        DECL_VISIT_PROC( FunctionCall      );
+        DECL_VISIT_PROC( Attribute         );
+        DECL_VISIT_PROC( SwitchCase        );
+        DECL_VISIT_PROC( SamplerValue      );
+        DECL_VISIT_PROC( Register          );
+        DECL_VISIT_PROC( PackOffset        );
+        DECL_VISIT_PROC( VarType           );
+        DECL_VISIT_PROC( VarIdent          );
+
+        DECL_VISIT_PROC( VarDecl           );
+        DECL_VISIT_PROC( TextureDecl       );
+        DECL_VISIT_PROC( SamplerDecl       );
+        DECL_VISIT_PROC( StructDecl        );
+        DECL_VISIT_PROC( AliasDecl         );
+
+        DECL_VISIT_PROC( FunctionDecl      );
+        DECL_VISIT_PROC( VarDeclStmnt      );
+        DECL_VISIT_PROC( BufferDeclStmnt   );
+        DECL_VISIT_PROC( TextureDeclStmnt  );
+        DECL_VISIT_PROC( SamplerDeclStmnt  );
+        DECL_VISIT_PROC( StructDeclStmnt   );
+        DECL_VISIT_PROC( AliasDeclStmnt    );
+
+        DECL_VISIT_PROC( NullStmnt         );
+        DECL_VISIT_PROC( CodeBlockStmnt    );
+        DECL_VISIT_PROC( ForLoopStmnt      );
+        DECL_VISIT_PROC( WhileLoopStmnt    );
+        DECL_VISIT_PROC( DoWhileLoopStmnt  );
+        DECL_VISIT_PROC( IfStmnt           );
+        DECL_VISIT_PROC( ElseStmnt         );
+        DECL_VISIT_PROC( SwitchStmnt       );
+        DECL_VISIT_PROC( ExprStmnt         );
+        DECL_VISIT_PROC( ReturnStmnt       );
+        DECL_VISIT_PROC( CtrlTransferStmnt );
+
+        DECL_VISIT_PROC( NullExpr          );
+        DECL_VISIT_PROC( ListExpr          );
+        DECL_VISIT_PROC( LiteralExpr       );
+        DECL_VISIT_PROC( TypeNameExpr      );
+        DECL_VISIT_PROC( TernaryExpr       );
+        DECL_VISIT_PROC( BinaryExpr        );
+        DECL_VISIT_PROC( UnaryExpr         );
+        DECL_VISIT_PROC( PostUnaryExpr     );
+        DECL_VISIT_PROC( FunctionCallExpr  );
+        DECL_VISIT_PROC( BracketExpr       );
+        DECL_VISIT_PROC( SuffixExpr        );
+        DECL_VISIT_PROC( ArrayAccessExpr   );
+        DECL_VISIT_PROC( CastExpr          );
+        DECL_VISIT_PROC( VarAccessExpr     );
+        DECL_VISIT_PROC( InitializerExpr   );
+        DECL_VISIT_PROC( LiteralBlobExpr   );
+
+        /* --- Helper functions --- */
+
+        // Appends the node record for the specified AST node and returns its index (see ScopedNode).
+        std::size_t BeginNode(AST* ast, const std::string& info);
+
+        // Returns the index of the specified info string in the interned string table (strings are deduplicated).
+        std::uint32_t InternString(const std::string& str);
+
+        /* === Members === */
+
+        std::vector<NodeRecord>                         nodes_;
+        std::vector<std::string>                        strings_;
+        std::unordered_map<std::string, std::uint32_t>  stringIndices_;
+
+};
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
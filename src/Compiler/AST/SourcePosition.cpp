@@ -7,17 +7,69 @@
 
 #include "SourcePosition.h"
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
 
 namespace Xsc
 {
 
 
+/*
+Leaky process-lifetime pool, so interned origins stay valid forever and positions can refer
+to them by a dense 32-bit ID (index into the pool; ID 0 is reserved for "no origin").
+*/
+struct SourceOriginPool
+{
+    static SourceOriginPool& Instance()
+    {
+        static auto instance = new SourceOriginPool();
+        return *instance;
+    }
+
+    std::mutex                                                          mutex;
+    std::map<std::pair<std::string, int>, std::uint32_t>                ids;
+    std::vector<std::unique_ptr<SourceOrigin>>                          origins;
+};
+
+std::uint32_t SourceOrigin::Intern(const std::string& filename, int lineOffset)
+{
+    auto& pool = SourceOriginPool::Instance();
+
+    std::lock_guard<std::mutex> guard(pool.mutex);
+
+    auto& id = pool.ids[{ filename, lineOffset }];
+    if (id == 0)
+    {
+        pool.origins.emplace_back(new SourceOrigin { filename, lineOffset });
+        id = static_cast<std::uint32_t>(pool.origins.size());
+    }
+
+    return id;
+}
+
+const SourceOrigin* SourceOrigin::Get(std::uint32_t id)
+{
+    auto& pool = SourceOriginPool::Instance();
+
+    std::lock_guard<std::mutex> guard(pool.mutex);
+
+    if (id >= 1 && id <= pool.origins.size())
+        return pool.origins[id - 1].get();
+
+    return nullptr;
+}
+
+
 const SourcePosition SourcePosition::ignore {};
 
-SourcePosition::SourcePosition(unsigned int row, unsigned int column, const SourceOriginPtr& origin) :
-    row_   { row    },
-    column_{ column },
-    origin_{ origin }
+SourcePosition::SourcePosition(unsigned int row, unsigned int column, std::uint32_t originId) :
+    row_     { row      },
+    column_  { column   },
+    originId_{ originId }
 {
 }
 
@@ -28,14 +80,16 @@ std::string SourcePosition::ToString(bool printFilename) const
     auto r = row_;
     auto c = column_;
 
-    if (printFilename && origin_)
+    const SourceOrigin* origin = (printFilename ? SourceOrigin::Get(originId_) : nullptr);
+
+    if (origin)
     {
-        if (!origin_->filename.empty())
+        if (!origin->filename.empty())
         {
-            s += origin_->filename;
+            s += origin->filename;
             s += ':';
         }
-        s += std::to_string(static_cast<int>(r) + origin_->lineOffset);
+        s += std::to_string(static_cast<int>(r) + origin->lineOffset);
     }
     else
         s += std::to_string(r);
@@ -57,6 +111,11 @@ void SourcePosition::IncColumn()
     ++column_;
 }
 
+void SourcePosition::IncColumn(unsigned int count)
+{
+    column_ += count;
+}
+
 bool SourcePosition::IsValid() const
 {
     return (row_ > 0 && column_ > 0);
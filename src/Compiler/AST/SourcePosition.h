@@ -9,8 +9,8 @@
 #define XSC_SOURCE_POSITION_H
 
 
+#include <cstdint>
 #include <string>
-#include <memory>
 
 
 namespace Xsc
@@ -21,15 +21,23 @@ namespace Xsc
 Source code origin with filename and line offset.
 This is used to track the filename and correct source position line for each AST within a pre-processed source code.
 This is necessary because the pre-processsor eliminates all include directives.
+Origins are interned with process lifetime (see Intern), and source positions refer to them by a 32-bit ID
+(0 denotes "no origin"), so a position is 12 bytes instead of 16 and copying it
+(into every token and AST source area) stays trivial. This keeps the per-node source area small,
+since every AST node carries one (see the node size audit in AST.cpp).
 */
 struct SourceOrigin
 {
+    // Returns the ID of the interned origin for the specified filename and line offset (thread-safe); IDs start at 1.
+    static std::uint32_t Intern(const std::string& filename, int lineOffset);
+
+    // Returns the interned origin for the specified ID, or null if the ID is 0 (or unknown).
+    static const SourceOrigin* Get(std::uint32_t id);
+
     std::string filename;
     int         lineOffset;
 };
 
-using SourceOriginPtr = std::shared_ptr<SourceOrigin>;
-
 
 // This class stores the position in a source code file.
 class SourcePosition
@@ -41,7 +49,7 @@ class SourcePosition
         static const SourcePosition ignore;
 
         SourcePosition() = default;
-        SourcePosition(unsigned int row, unsigned int column, const SourceOriginPtr& origin = nullptr);
+        SourcePosition(unsigned int row, unsigned int column, std::uint32_t originId = 0);
 
         // Returns the source position as string in the format "Row:Column", e.g. "75:10".
         std::string ToString(bool printFilename = true) const;
@@ -52,6 +60,9 @@ class SourcePosition
         // Increases the column by 1.
         void IncColumn();
 
+        // Increases the column by the specified amount.
+        void IncColumn(unsigned int count);
+
         // Returns ture if this is a valid source position. False if row and column are 0.
         bool IsValid() const;
 
@@ -70,18 +81,18 @@ class SourcePosition
             return column_;
         }
 
-        // Sets the new source origin.
-        inline void SetOrigin(const SourceOriginPtr& origin)
+        // Sets the new source origin by its interned ID (see SourceOrigin::Intern).
+        inline void SetOrigin(std::uint32_t originId)
         {
-            origin_ = origin;
+            originId_ = originId;
         }
 
     private:
-        
-        unsigned int    row_    = 0,
-                        column_ = 0;
 
-        SourceOriginPtr origin_;
+        unsigned int    row_        = 0,
+                        column_     = 0;
+
+        std::uint32_t   originId_   = 0;
 
 };
 
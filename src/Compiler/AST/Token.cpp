@@ -7,19 +7,17 @@
 
 #include "Token.h"
 
-#ifdef XSC_ENABLE_MEMORY_POOL
-#include "MemoryPool.h"
-#endif
-
 
 namespace Xsc
 {
 
 
 Token::Token(Token&& other) :
-    type_   { other.type_             },
-    pos_    { other.pos_              },
-    spell_  { std::move(other.spell_) }
+    type_           { other.type_             },
+    pos_            { other.pos_              },
+    spellView_      { other.spellView_        },
+    spellViewSize_  { other.spellViewSize_    },
+    spell_          { std::move(other.spell_) }
 {
 }
 
@@ -43,13 +41,30 @@ Token::Token(const SourcePosition& pos, const Types type, std::string&& spell) :
 {
 }
 
+Token::Token(const SourcePosition& pos, const Types type, const char* spellView, std::size_t spellViewSize) :
+    type_           { type          },
+    pos_            { pos           },
+    spellView_      { spellView     },
+    spellViewSize_  { spellViewSize }
+{
+}
+
+Token::Token(const SourcePosition& pos, const Types type, const Token& spellSource) :
+    type_           { type                        },
+    pos_            { pos                         },
+    spellView_      { spellSource.spellView_      },
+    spellViewSize_  { spellSource.spellViewSize_  },
+    spell_          { spellSource.spell_          }
+{
+}
+
 SourceArea Token::Area() const
 {
     /* Initialize source area by token position and length of spelling */
     return
     {
         Pos(),
-        static_cast<unsigned int>(Spell().size())
+        static_cast<unsigned int>(SpellSize())
     };
 }
 
@@ -124,6 +139,13 @@ std::string Token::TypeToString(const Types type)
     return "";
 }
 
+//private
+void Token::MaterializeSpell() const
+{
+    spell_.assign(spellView_, spellViewSize_);
+    spellView_ = nullptr;
+}
+
 std::string Token::SpellContent() const
 {
     if (Type() == Types::StringLiteral && Spell().size() >= 2)
@@ -132,21 +154,6 @@ std::string Token::SpellContent() const
         return Spell();
 }
 
-#ifdef XSC_ENABLE_MEMORY_POOL
-
-void* Token::operator new (std::size_t count)
-{
-    return MemoryPool::Instance().Alloc(count);
-}
-
-void Token::operator delete (void* ptr)
-{
-    MemoryPool::Instance().Free(ptr);
-}
-
-#endif
-
-
 } // /namespace Xsc
 
 
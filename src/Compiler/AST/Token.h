@@ -18,7 +18,11 @@ namespace Xsc
 {
 
 
-// Token classes used by the scanner and parser.
+/*
+Token classes used by the scanner and parser.
+The token spelling is either stored as owned string, or as view into the contiguous source buffer
+(see Scanner::MakeView), in which case it is materialized on the first access (see Spell).
+*/
 class Token
 {
     
@@ -145,6 +149,12 @@ class Token
         Token(const SourcePosition& pos, const Types type, const std::string& spell);
         Token(const SourcePosition& pos, const Types type, std::string&& spell);
 
+        // Stores the spelling as view into the source buffer, which must outlive this token (see Scanner::MakeView).
+        Token(const SourcePosition& pos, const Types type, const char* spellView, std::size_t spellViewSize);
+
+        // Shares the spelling (view or owned string) of the specified token, e.g. for token re-classification.
+        Token(const SourcePosition& pos, const Types type, const Token& spellSource);
+
         // Returns the source area of this token.
         SourceArea Area() const;
 
@@ -166,24 +176,39 @@ class Token
             return pos_;
         }
 
-        // Returns the token spelling.
+        // Returns the token spelling (a spelling view is materialized into the owned string on the first access).
         inline const std::string& Spell() const
         {
+            if (spellView_ != nullptr)
+                MaterializeSpell();
             return spell_;
         }
 
-        #ifdef XSC_ENABLE_MEMORY_POOL
-
-        void* operator new (std::size_t count);
-        void operator delete (void* ptr);
+        // Returns a pointer to the spelling characters without materializing a spelling view (not null terminated, see SpellSize).
+        inline const char* SpellData() const
+        {
+            return (spellView_ != nullptr ? spellView_ : spell_.data());
+        }
 
-        #endif
+        // Returns the size (in bytes) of the token spelling without materializing a spelling view.
+        inline std::size_t SpellSize() const
+        {
+            return (spellView_ != nullptr ? spellViewSize_ : spell_.size());
+        }
 
     private:
 
-        Types           type_;  // Type of this token.
-        SourcePosition  pos_;   // Source area of this token.
-        std::string     spell_; // Token spelling.
+        // Copies the spelling view into the owned spelling string (see Spell).
+        void MaterializeSpell() const;
+
+        Types                   type_;                  // Type of this token.
+        SourcePosition          pos_;                   // Source area of this token.
+
+        // Spelling view into the source buffer (null if the spelling is stored in the owned string).
+        mutable const char*     spellView_      = nullptr;
+        std::size_t             spellViewSize_  = 0;
+
+        mutable std::string     spell_;                 // Owned token spelling.
 
 };
 
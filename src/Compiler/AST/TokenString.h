@@ -1,6 +1,6 @@
 /*
  * TokenString.h
- * 
+ *
  * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
  * See "LICENSE.txt" for license information.
  */
@@ -11,7 +11,10 @@
 
 #include "Token.h"
 #include <vector>
+#include <memory>
+#include <iterator>
 #include <ostream>
+#include <cstring>
 
 
 namespace Xsc
@@ -25,15 +28,116 @@ This class is mainly used by the preprocessor, because the preprocessor must kee
 'TokenType' should be either from type 'Token*' or 'TokenPtr'.
 'TokenOfInterestFunctor' must be a type with a static function of the following interface:
 "bool IsOfInterest(const TokenType& token)"
+
+The tokens are stored as segments, i.e. index ranges into shared token pools:
+appending one token string to another only shares the pools of the source segments,
+so macro expansion splices entire macro bodies and arguments around without copying
+(and reference counting) the individual tokens.
 */
 template <typename TokenType, typename TokenOfInterestFunctor>
 class BasicTokenString
 {
-    
+
     public:
-        
-        using ValueType = TokenType;
-        using Container = std::vector<TokenType>;
+
+        using ValueType     = TokenType;
+        using Container     = std::vector<TokenType>;
+        using ContainerPtr  = std::shared_ptr<Container>;
+
+        // Contiguous run of tokens [begin, end) inside a shared token pool.
+        struct Segment
+        {
+            ContainerPtr    pool;
+            std::size_t     begin;
+            std::size_t     end;
+        };
+
+        using SegmentList = std::vector<Segment>;
+
+        /*
+        Iterator over all tokens of a token string (including tokens that are not of interest).
+        Like the previous plain vector iterators, it refers to the heap storage of the string,
+        so it remains valid when the string object is moved, but not when tokens are appended.
+        */
+        class RawConstIterator
+        {
+
+            public:
+
+                RawConstIterator() = default;
+
+                RawConstIterator(const RawConstIterator&) = default;
+                RawConstIterator& operator = (const RawConstIterator&) = default;
+
+                RawConstIterator(const Segment* seg, const Segment* segEnd, std::size_t index) :
+                    seg_    { seg    },
+                    segEnd_ { segEnd },
+                    index_  { index  }
+                {
+                }
+
+                RawConstIterator& operator ++ ()
+                {
+                    if (++index_ == seg_->end)
+                    {
+                        ++seg_;
+                        index_ = (seg_ != segEnd_ ? seg_->begin : 0);
+                    }
+                    return *this;
+                }
+
+                RawConstIterator operator ++ (int)
+                {
+                    RawConstIterator tmp = *this;
+                    operator ++ ();
+                    return tmp;
+                }
+
+                RawConstIterator& operator -- ()
+                {
+                    if (seg_ == segEnd_ || index_ == seg_->begin)
+                    {
+                        --seg_;
+                        index_ = seg_->end;
+                    }
+                    --index_;
+                    return *this;
+                }
+
+                RawConstIterator operator -- (int)
+                {
+                    RawConstIterator tmp = *this;
+                    operator -- ();
+                    return tmp;
+                }
+
+                const ValueType& operator * () const
+                {
+                    return (*seg_->pool)[index_];
+                }
+
+                const ValueType* operator -> () const
+                {
+                    return &(*seg_->pool)[index_];
+                }
+
+            private:
+
+                friend bool operator == (const RawConstIterator& lhs, const RawConstIterator& rhs)
+                {
+                    return (lhs.seg_ == rhs.seg_ && lhs.index_ == rhs.index_);
+                }
+
+                friend bool operator != (const RawConstIterator& lhs, const RawConstIterator& rhs)
+                {
+                    return !(lhs == rhs);
+                }
+
+                const Segment*  seg_    = nullptr;
+                const Segment*  segEnd_ = nullptr;
+                std::size_t     index_  = 0;
+
+        };
 
         class ConstIterator
         {
@@ -45,7 +149,7 @@ class BasicTokenString
                 ConstIterator(const ConstIterator&) = default;
                 ConstIterator& operator = (const ConstIterator&) = default;
 
-                ConstIterator(const typename Container::const_iterator& it, const typename Container::const_iterator& itEnd) :
+                ConstIterator(const RawConstIterator& it, const RawConstIterator& itEnd) :
                     it_     { it    },
                     itEnd_  { itEnd }
                 {
@@ -78,12 +182,12 @@ class BasicTokenString
                 {
                     return *it_;
                 }
-                
-                typename Container::const_iterator operator -> ()
+
+                const ValueType* operator -> ()
                 {
-                    return it_;
+                    return &(*it_);
                 }
-                
+
             private:
 
                 void NextTokenOfInterest()
@@ -92,7 +196,7 @@ class BasicTokenString
                         ++it_;
                 }
 
-                typename Container::const_iterator it_, itEnd_;
+                RawConstIterator it_, itEnd_;
 
         };
 
@@ -100,64 +204,154 @@ class BasicTokenString
         BasicTokenString(const BasicTokenString&) = default;
         BasicTokenString& operator = (const BasicTokenString&) = default;
 
+        BasicTokenString(BasicTokenString&& rhs) :
+            segments_   { std::move(rhs.segments_) },
+            size_       { rhs.size_                }
+        {
+            rhs.segments_.clear();
+            rhs.size_ = 0;
+        }
+
+        BasicTokenString& operator = (BasicTokenString&& rhs)
+        {
+            if (&rhs != this)
+            {
+                segments_   = std::move(rhs.segments_);
+                size_       = rhs.size_;
+                rhs.segments_.clear();
+                rhs.size_ = 0;
+            }
+            return *this;
+        }
+
         BasicTokenString(const TokenType& token)
         {
             PushBack(token);
         }
-        
+
         ConstIterator Begin() const
         {
-            return ConstIterator(tokens_.begin(), tokens_.end());
+            return ConstIterator(begin(), end());
         }
 
         ConstIterator End() const
         {
-            return ConstIterator(tokens_.end(), tokens_.end());
+            return ConstIterator(end(), end());
+        }
+
+        // Returns the raw iterator to the first token (including tokens that are not of interest).
+        RawConstIterator begin() const
+        {
+            auto seg = segments_.data();
+            return RawConstIterator(seg, seg + segments_.size(), (segments_.empty() ? 0 : seg->begin));
+        }
+
+        // Returns the raw iterator after the last token (including tokens that are not of interest).
+        RawConstIterator end() const
+        {
+            auto segEnd = segments_.data() + segments_.size();
+            return RawConstIterator(segEnd, segEnd, 0);
         }
 
         void PushBack(const TokenType& token)
         {
-            tokens_.push_back(token);
+            if (!segments_.empty())
+            {
+                /* Append to the tail pool when this string is its only owner and the segment covers the pool end */
+                auto& tail = segments_.back();
+                if (tail.pool.use_count() == 1 && tail.end == tail.pool->size())
+                {
+                    tail.pool->push_back(token);
+                    ++tail.end;
+                    ++size_;
+                    return;
+                }
+            }
+
+            /* Otherwise start a new owned tail pool */
+            auto pool = std::make_shared<Container>();
+            pool->push_back(token);
+            segments_.push_back({ std::move(pool), 0, 1 });
+            ++size_;
         }
 
+        // Appends the specified token string by sharing its token pools, without copying the individual tokens.
         void PushBack(const BasicTokenString& tokenString)
         {
-            tokens_.insert(tokens_.end(), tokenString.tokens_.begin(), tokenString.tokens_.end());
+            segments_.insert(segments_.end(), tokenString.segments_.begin(), tokenString.segments_.end());
+            size_ += tokenString.size_;
+        }
+
+        // Appends the specified token string by moving its segments, to avoid the pool reference counting as well.
+        void PushBack(BasicTokenString&& tokenString)
+        {
+            if (segments_.empty())
+                segments_ = std::move(tokenString.segments_);
+            else
+            {
+                segments_.insert(
+                    segments_.end(),
+                    std::make_move_iterator(tokenString.segments_.begin()),
+                    std::make_move_iterator(tokenString.segments_.end())
+                );
+            }
+            size_ += tokenString.size_;
+            tokenString.segments_.clear();
+            tokenString.size_ = 0;
         }
 
         void PopFront()
         {
-            tokens_.erase(tokens_.begin());
+            auto& seg = segments_.front();
+            if (++seg.begin == seg.end)
+                segments_.erase(segments_.begin());
+            --size_;
         }
 
         void PopBack()
         {
-            tokens_.pop_back();
+            auto& seg = segments_.back();
+            if (seg.pool.use_count() == 1 && seg.end == seg.pool->size())
+            {
+                /* Also truncate the owned tail pool, so the storage can be reused by the next PushBack */
+                seg.pool->pop_back();
+            }
+            if (--seg.end == seg.begin)
+                segments_.pop_back();
+            --size_;
         }
-        
+
         const ValueType& Front() const
         {
-            return tokens_.front();
+            const auto& seg = segments_.front();
+            return (*seg.pool)[seg.begin];
         }
 
         const ValueType& Back() const
         {
-            return tokens_.back();
+            const auto& seg = segments_.back();
+            return (*seg.pool)[seg.end - 1];
         }
 
         bool Empty() const
         {
-            return tokens_.empty();
+            return segments_.empty();
         }
 
-        const Container& GetTokens() const
+        std::size_t Size() const
         {
-            return tokens_;
+            return size_;
         }
 
-        Container& GetTokens()
+        // Reserves storage for the specified number of additional token segments.
+        void Reserve(std::size_t count)
         {
-            return tokens_;
+            segments_.reserve(segments_.size() + count);
+        }
+
+        const SegmentList& GetSegments() const
+        {
+            return segments_;
         }
 
         // Removes all tokens that are not of interest for the specified token string from the front.
@@ -176,7 +370,8 @@ class BasicTokenString
 
     private:
 
-        Container tokens_;
+        SegmentList segments_;
+        std::size_t size_ = 0;
 
 };
 
@@ -200,8 +395,10 @@ bool operator == (const BasicTokenString<TokenType, TokenOfInterestFunctor>& lhs
         if (lhsTkn->Type() != rhsTkn->Type())
             return false;
 
-        /* Compare values */
-        if (lhsTkn->Spell() != rhsTkn->Spell())
+        /* Compare values (via SpellData, so spelling views are not materialized just for the comparison) */
+        if (lhsTkn->SpellSize() != rhsTkn->SpellSize())
+            return false;
+        if (std::memcmp(lhsTkn->SpellData(), rhsTkn->SpellData(), lhsTkn->SpellSize()) != 0)
             return false;
     }
 
@@ -218,8 +415,8 @@ bool operator != (const BasicTokenString<TokenType, TokenOfInterestFunctor>& lhs
 template <typename TokenType, typename TokenOfInterestFunctor>
 std::ostream& operator << (std::ostream& lhs, const BasicTokenString<TokenType, TokenOfInterestFunctor>& rhs)
 {
-    for (const auto& tkn : rhs.GetTokens())
-        lhs << tkn->Spell();
+    for (const auto& tkn : rhs)
+        lhs.write(tkn->SpellData(), static_cast<std::streamsize>(tkn->SpellSize()));
     return lhs;
 }
 
@@ -241,4 +438,4 @@ using TokenPtrString = BasicTokenString<TokenPtr, PreProcessorTokenOfInterestFun
 
 
 
-// ================================================================================
\ No newline at end of file
+// ================================================================================
@@ -8,6 +8,8 @@
 #include "TypeDenoter.h"
 #include "Exception.h"
 #include "AST.h"
+#include "Helper.h"
+#include <vector>
 
 
 namespace Xsc
@@ -76,13 +78,22 @@ bool TypeDenoter::IsArray() const
     return (Type() == Types::Array);
 }
 
+std::uint32_t TypeDenoter::TypeId() const
+{
+    return (static_cast<std::uint32_t>(Type()) << 16);
+}
+
 bool TypeDenoter::Equals(const TypeDenoter& rhs) const
 {
+    if (this == &rhs)
+        return true;
     return (GetAliased().Type() == rhs.GetAliased().Type());
 }
 
 bool TypeDenoter::IsCastableTo(const TypeDenoter& targetType) const
 {
+    if (this == &targetType)
+        return true;
     return (GetAliased().Type() == targetType.GetAliased().Type());
 }
 
@@ -127,7 +138,7 @@ TypeDenoterPtr TypeDenoter::AsArray(const std::vector<ExprPtr>& arrayDims)
     if (arrayDims.empty())
         return shared_from_this();
     else
-        return std::make_shared<ArrayTypeDenoter>(shared_from_this(), arrayDims);
+        return MakeShared<ArrayTypeDenoter>(shared_from_this(), arrayDims);
 }
 
 
@@ -167,6 +178,11 @@ std::string BaseTypeDenoter::ToString() const
     return DataTypeToString(dataType);
 }
 
+std::uint32_t BaseTypeDenoter::TypeId() const
+{
+    return ((static_cast<std::uint32_t>(Types::Base) << 16) | static_cast<std::uint32_t>(dataType));
+}
+
 bool BaseTypeDenoter::IsScalar() const
 {
     return IsScalarType(dataType);
@@ -184,7 +200,12 @@ bool BaseTypeDenoter::IsMatrix() const
 
 bool BaseTypeDenoter::Equals(const TypeDenoter& rhs) const
 {
-    return (rhs.Type() == Types::Base && dataType == static_cast<const BaseTypeDenoter&>(rhs).dataType);
+    /* Identity shortcut: canonical denoters of the same data type are the same object (see GetCanonicalBaseTypeDenoter) */
+    if (this == &rhs)
+        return true;
+
+    /* The compact type-id covers both the type kind and the base data type */
+    return (TypeId() == rhs.TypeId());
 }
 
 // see https://msdn.microsoft.com/en-us/library/windows/desktop/bb172396(v=vs.85).aspx
@@ -225,7 +246,7 @@ TypeDenoterPtr BaseTypeDenoter::Get(const VarIdent* varIdent)
         try
         {
             auto subscriptDataType = SubscriptDataType(dataType, varIdent->ident);
-            auto subscriptTypeDenoter = std::make_shared<BaseTypeDenoter>(subscriptDataType);
+            auto subscriptTypeDenoter = GetCanonicalBaseTypeDenoter(subscriptDataType);
             return subscriptTypeDenoter->Get(varIdent->next.get());
         }
         catch (const ASTRuntimeError& e)
@@ -250,7 +271,7 @@ TypeDenoterPtr BaseTypeDenoter::GetFromArray(std::size_t numArrayIndices, const
             /* Return scalar type */
             if (numArrayIndices > 1)
                 RuntimeErr("too many array dimensions for vector type");
-            return std::make_shared<BaseTypeDenoter>(BaseDataType(dataType));
+            return GetCanonicalBaseTypeDenoter(BaseDataType(dataType));
         }
         else if (IsMatrixType(dataType))
         {
@@ -258,10 +279,10 @@ TypeDenoterPtr BaseTypeDenoter::GetFromArray(std::size_t numArrayIndices, const
             if (numArrayIndices == 1)
             {
                 auto matrixDim = MatrixTypeDim(dataType);
-                return std::make_shared<BaseTypeDenoter>(VectorDataType(BaseDataType(dataType), matrixDim.second));
+                return GetCanonicalBaseTypeDenoter(VectorDataType(BaseDataType(dataType), matrixDim.second));
             }
             if (numArrayIndices == 2)
-                return std::make_shared<BaseTypeDenoter>(BaseDataType(dataType));
+                return GetCanonicalBaseTypeDenoter(BaseDataType(dataType));
             if (numArrayIndices > 2)
                 RuntimeErr("too many array dimensions for matrix type");
         }
@@ -271,6 +292,24 @@ TypeDenoterPtr BaseTypeDenoter::GetFromArray(std::size_t numArrayIndices, const
     return Get(varIdent);
 }
 
+BaseTypeDenoterPtr GetCanonicalBaseTypeDenoter(const DataType dataType)
+{
+    static const auto canonicalDenoters = []() -> std::vector<BaseTypeDenoterPtr>
+    {
+        /* Generate one immutable denoter for each base data type (from the global heap, not from a per-compile pool) */
+        std::vector<BaseTypeDenoterPtr> denoters(static_cast<std::size_t>(DataType::Double4x4) + 1);
+
+        for (std::size_t i = 0; i < denoters.size(); ++i)
+            denoters[i] = std::make_shared<BaseTypeDenoter>(static_cast<DataType>(i));
+
+        return denoters;
+    }();
+
+    const auto idx = static_cast<std::size_t>(dataType);
+    return (idx < canonicalDenoters.size() ? canonicalDenoters[idx] : std::make_shared<BaseTypeDenoter>(dataType));
+}
+
+
 /* ----- BufferTypeDenoter ----- */
 
 TypeDenoter::Types BufferTypeDenoter::Type() const
@@ -308,6 +347,11 @@ std::string TextureTypeDenoter::ToString() const
     return "texture";
 }
 
+std::uint32_t TextureTypeDenoter::TypeId() const
+{
+    return ((static_cast<std::uint32_t>(Types::Texture) << 16) | static_cast<std::uint32_t>(textureType));
+}
+
 
 /* ----- SamplerTypeDenoter ----- */
 
@@ -483,6 +527,11 @@ std::string ArrayTypeDenoter::ToString() const
     return typeName;
 }
 
+std::uint32_t ArrayTypeDenoter::TypeId() const
+{
+    return ((static_cast<std::uint32_t>(Types::Array) << 16) | (static_cast<std::uint32_t>(arrayDims.size()) & 0xffff));
+}
+
 TypeDenoterPtr ArrayTypeDenoter::Get(const VarIdent* varIdent)
 {
     if (varIdent)
@@ -507,6 +556,9 @@ TypeDenoterPtr ArrayTypeDenoter::GetFromArray(std::size_t numArrayIndices, const
 
 bool ArrayTypeDenoter::Equals(const TypeDenoter& rhs) const
 {
+    if (this == &rhs)
+        return true;
+
     const auto& rhsAliased = rhs.GetAliased();
     if (rhsAliased.Type() == Types::Array)
     {
@@ -544,7 +596,7 @@ TypeDenoterPtr ArrayTypeDenoter::GetWithIndices(std::size_t numArrayIndices, con
         /* Make new array type denoter with less dimensions */
         auto subArrayDims = arrayDims;
         subArrayDims.resize(numDims - numArrayIndices);
-        return std::make_shared<ArrayTypeDenoter>(baseTypeDenoter, subArrayDims);
+        return MakeShared<ArrayTypeDenoter>(baseTypeDenoter, subArrayDims);
     }
 
     /* Get base type denoter with next identifier */
@@ -11,6 +11,7 @@
 
 #include "Visitor.h"
 #include "ASTEnums.h"
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -63,6 +64,13 @@ struct TypeDenoter : std::enable_shared_from_this<TypeDenoter>
     // Returns a simple string representation of this type denoter (e.g. "scalar type").
     virtual std::string ToString() const = 0;
 
+    /*
+    Returns a compact structural type-id of this type denoter: the type kind in the upper bits and the
+    primary payload (e.g. the base data type) in the lower bits. Type comparisons and fingerprints can
+    thereby start with plain integer operations; strings are only built when a diagnostic actually prints.
+    */
+    virtual std::uint32_t TypeId() const;
+
     virtual bool IsScalar() const;
     virtual bool IsVector() const;
     virtual bool IsMatrix() const;
@@ -140,6 +148,7 @@ struct BaseTypeDenoter : public TypeDenoter
 
     Types Type() const override;
     std::string ToString() const override;
+    std::uint32_t TypeId() const override;
 
     bool IsScalar() const override;
     bool IsVector() const override;
@@ -154,6 +163,12 @@ struct BaseTypeDenoter : public TypeDenoter
     DataType dataType = DataType::Undefined;
 };
 
+/*
+Returns the canonical shared denoter for the specified base data type (flyweight).
+The canonical denoters are immutable and shared across all compiles; they must not be modified.
+*/
+BaseTypeDenoterPtr GetCanonicalBaseTypeDenoter(const DataType dataType);
+
 // Buffer type denoter.
 struct BufferTypeDenoter : public TypeDenoter
 {
@@ -176,6 +191,7 @@ struct TextureTypeDenoter : public TypeDenoter
 
     Types Type() const override;
     std::string ToString() const override;
+    std::uint32_t TypeId() const override;
 
     BufferType      textureType     = BufferType::Undefined;
     TextureDecl*    textureDeclRef  = nullptr;
@@ -254,6 +270,8 @@ struct ArrayTypeDenoter : public TypeDenoter
     // Throws std::runtime_error if 'baseTypeDenoter' is null.
     std::string ToString() const override;
 
+    std::uint32_t TypeId() const override;
+
     TypeDenoterPtr Get(const VarIdent* varIdent = nullptr) override;
     TypeDenoterPtr GetFromArray(std::size_t numArrayIndices, const VarIdent* varIdent = nullptr) override;
 
@@ -1,6 +1,6 @@
 /*
  * ConstExprEvaluator.cpp
- * 
+ *
  * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
  * See "LICENSE.txt" for license information.
  */
@@ -8,7 +8,6 @@
 #include "ConstExprEvaluator.h"
 #include "AST.h"
 #include "Helper.h"
-#include <sstream>
 
 
 namespace Xsc
@@ -17,54 +16,393 @@ namespace Xsc
 
 Variant ConstExprEvaluator::EvaluateExpr(Expr& ast, const OnVarAccessCallback& onVarAccessCallback)
 {
-    onVarAccessCallback_ = (onVarAccessCallback ? onVarAccessCallback : [](VarAccessExpr* ast) { return Variant(Variant::IntType(0)); });
-    Visit(&ast);
+    onVarAccessCallback_    = (onVarAccessCallback ? onVarAccessCallback : [](VarAccessExpr* ast) { return Variant(Variant::IntType(0)); });
+    throwOnFailure_         = true;
+
+    EvaluateExprTree(ast);
+
     return Pop();
 }
 
+bool ConstExprEvaluator::TryEvaluateExpr(Expr& ast, Variant& result, const OnTryVarAccessCallback& onTryVarAccessCallback)
+{
+    onTryVarAccessCallback_ = onTryVarAccessCallback;
+    throwOnFailure_         = false;
+
+    try
+    {
+        EvaluateExprTree(ast);
+    }
+    catch (const std::exception&)
+    {
+        /* The variant arithmetic may still throw (e.g. a division by a zero that only the operand
+           promotion produces); the probe must record such an expression as failed, not propagate */
+        failed_ = true;
+    }
+
+    if (failed_)
+        return false;
+
+    result = Pop();
+    return true;
+}
+
 
 /*
  * ======= Private: =======
  */
 
-[[noreturn]]
-static void IllegalExpr(const std::string& exprName)
+void ConstExprEvaluator::EvaluateExprTree(Expr& ast)
+{
+    frameStack_.clear();
+    variantStack_.clear();
+    failed_ = false;
+
+    /* Evaluate iteratively: each frame schedules its sub expressions before it is reduced to a value */
+    frameStack_.push_back({ &ast, 0 });
+
+    while (!frameStack_.empty() && !failed_)
+        EvaluateTopFrame();
+}
+
+void ConstExprEvaluator::Fail(const std::string& exprName)
+{
+    if (throwOnFailure_)
+        throw std::runtime_error("illegal " + exprName + " in constant expression");
+    failed_ = true;
+}
+
+// Returns true if the specified variant is an integral zero, i.e. a division by it would throw (see Variant::operator /=).
+static bool IsZeroDivisor(const Variant& divisor)
+{
+    return (divisor.Type() == Variant::Types::Int && divisor.Int() == 0);
+}
+
+Variant ConstExprEvaluator::ApplyBinaryOp(const BinaryOp op, Variant lhs, Variant rhs)
+{
+    switch (op)
+    {
+        case BinaryOp::Undefined:
+            Fail("binary operator");
+            break;
+        case BinaryOp::LogicalAnd:
+            return (lhs.ToBool() && rhs.ToBool());
+        case BinaryOp::LogicalOr:
+            return (lhs.ToBool() || rhs.ToBool());
+        case BinaryOp::Or:
+            return (lhs | rhs);
+        case BinaryOp::Xor:
+            return (lhs ^ rhs);
+        case BinaryOp::And:
+            return (lhs & rhs);
+        case BinaryOp::LShift:
+            return (lhs << rhs);
+        case BinaryOp::RShift:
+            return (lhs >> rhs);
+        case BinaryOp::Add:
+            return (lhs + rhs);
+        case BinaryOp::Sub:
+            return (lhs - rhs);
+        case BinaryOp::Mul:
+            return (lhs * rhs);
+        case BinaryOp::Div:
+            /* A zero divisor is not a constant value; the expression is left unfolded for the runtime */
+            if (IsZeroDivisor(rhs))
+            {
+                Fail("division by zero");
+                break;
+            }
+            return (lhs / rhs);
+        case BinaryOp::Mod:
+            if (IsZeroDivisor(rhs))
+            {
+                Fail("division by zero");
+                break;
+            }
+            return (lhs % rhs);
+        case BinaryOp::Equal:
+            return (lhs == rhs);
+        case BinaryOp::NotEqual:
+            return (lhs != rhs);
+        case BinaryOp::Less:
+            return (lhs < rhs);
+        case BinaryOp::Greater:
+            return (lhs > rhs);
+        case BinaryOp::LessEqual:
+            return (lhs <= rhs);
+        case BinaryOp::GreaterEqual:
+            return (lhs >= rhs);
+    }
+    return Variant();
+}
+
+Variant ConstExprEvaluator::ApplyUnaryOp(const UnaryOp op, Variant rhs)
 {
-    throw std::runtime_error("illegal " + exprName + " in constant expression");
+    switch (op)
+    {
+        case UnaryOp::Undefined:
+            Fail("unary operator");
+            break;
+        case UnaryOp::LogicalNot:
+            return (!rhs.ToBool());
+        case UnaryOp::Not:
+            return ~rhs;
+        case UnaryOp::Nop:
+            return rhs;
+        case UnaryOp::Negate:
+            return -rhs;
+        case UnaryOp::Inc:
+            return ++rhs;
+        case UnaryOp::Dec:
+            return --rhs;
+    }
+    return Variant();
 }
 
 void ConstExprEvaluator::Push(const Variant& v)
 {
-    variantStack_.push(v);
+    variantStack_.push_back(v);
 }
 
 Variant ConstExprEvaluator::Pop()
 {
     if (variantStack_.empty())
         throw std::runtime_error("stack underflow in expression evaluator");
-    auto v = variantStack_.top();
-    variantStack_.pop();
+    auto v = variantStack_.back();
+    variantStack_.pop_back();
     return v;
 }
 
-/* --- Expressions --- */
+void ConstExprEvaluator::EvaluateTopFrame()
+{
+    auto& frame = frameStack_.back();
+    auto expr = frame.expr;
 
-#define IMPLEMENT_VISIT_PROC(AST_NAME) \
-    void ConstExprEvaluator::Visit##AST_NAME(AST_NAME* ast, void* args)
+    if (!expr)
+        throw std::runtime_error("stack underflow in expression evaluator");
 
-IMPLEMENT_VISIT_PROC(NullExpr)
-{
-    IllegalExpr("dynamic array dimension");
-}
+    switch (expr->Type())
+    {
+        case AST::Types::NullExpr:
+        {
+            Fail("dynamic array dimension");
+            return;
+        }
+        break;
 
-IMPLEMENT_VISIT_PROC(ListExpr)
-{
-    /* Only visit first sub-expression (when used as condExpr) */
-    Visit(ast->firstExpr);
-    //Visit(ast->nextExpr);
+        case AST::Types::ListExpr:
+        {
+            auto ast = static_cast<ListExpr*>(expr);
+
+            /*
+            A list with a tail must not be reduced to its head in the probe mode: the optimizer would
+            replace the entire list by the head's value and drop the side effects of the tail
+            (e.g. "5 + 2, ++mask"). Only a lone head is evaluated (when used as condExpr).
+            */
+            if (!throwOnFailure_ && ast->nextExpr != nullptr)
+            {
+                Fail("list expression");
+                return;
+            }
+
+            /* Only evaluate first sub-expression (when used as condExpr) */
+            frame.expr = ast->firstExpr.get();
+        }
+        break;
+
+        case AST::Types::LiteralExpr:
+        {
+            EvaluateLiteral(static_cast<LiteralExpr*>(expr));
+            frameStack_.pop_back();
+        }
+        break;
+
+        case AST::Types::TypeNameExpr:
+        {
+            Fail("type specifier");
+            return;
+        }
+        break;
+
+        case AST::Types::TernaryExpr:
+        {
+            auto ast = static_cast<TernaryExpr*>(expr);
+            if (frame.state == 0)
+            {
+                frame.state = 1;
+                frameStack_.push_back({ ast->condExpr.get(), 0 });
+            }
+            else
+            {
+                /* Reduce this frame to the selected branch */
+                auto cond = Pop();
+                frame.expr  = (cond.ToBool() ? ast->thenExpr.get() : ast->elseExpr.get());
+                frame.state = 0;
+            }
+        }
+        break;
+
+        case AST::Types::BinaryExpr:
+        {
+            auto ast = static_cast<BinaryExpr*>(expr);
+            if (frame.state == 0)
+            {
+                frame.state = 1;
+                frameStack_.push_back({ ast->lhsExpr.get(), 0 });
+            }
+            else if (frame.state == 1)
+            {
+                frame.state = 2;
+                frameStack_.push_back({ ast->rhsExpr.get(), 0 });
+            }
+            else
+            {
+                auto rhs = Pop();
+                auto lhs = Pop();
+                Push(ApplyBinaryOp(ast->op, lhs, rhs));
+                frameStack_.pop_back();
+            }
+        }
+        break;
+
+        case AST::Types::UnaryExpr:
+        {
+            auto ast = static_cast<UnaryExpr*>(expr);
+            if (frame.state == 0)
+            {
+                frame.state = 1;
+                frameStack_.push_back({ ast->expr.get(), 0 });
+            }
+            else
+            {
+                Push(ApplyUnaryOp(ast->op, Pop()));
+                frameStack_.pop_back();
+            }
+        }
+        break;
+
+        case AST::Types::PostUnaryExpr:
+        {
+            auto ast = static_cast<PostUnaryExpr*>(expr);
+            if (frame.state == 0)
+            {
+                frame.state = 1;
+                frameStack_.push_back({ ast->expr.get(), 0 });
+            }
+            else
+            {
+                if (ast->op != UnaryOp::Inc && ast->op != UnaryOp::Dec)
+                {
+                    Fail("unary operator '" + UnaryOpToString(ast->op) + "'");
+                    return;
+                }
+
+                /* Only keep original value (post inc/dec will return the value BEFORE the operation) */
+                frameStack_.pop_back();
+            }
+        }
+        break;
+
+        case AST::Types::FunctionCallExpr:
+        {
+            auto ast = static_cast<FunctionCallExpr*>(expr);
+            auto call = ast->call.get();
+
+            /* Only base type constructor calls (e.g. "float4(1, 2, 3, 4)") can be folded */
+            if (!call || !call->typeDenoter || !call->typeDenoter->As<BaseTypeDenoter>() || call->arguments.empty())
+            {
+                Fail("function call");
+                return;
+            }
+
+            if (frame.state < call->arguments.size())
+            {
+                auto argExpr = call->arguments[frame.state].get();
+                ++frame.state;
+                frameStack_.push_back({ argExpr, 0 });
+            }
+            else
+            {
+                EvaluateTypeConstructor(ast);
+                frameStack_.pop_back();
+            }
+        }
+        break;
+
+        case AST::Types::BracketExpr:
+        {
+            frame.expr = static_cast<BracketExpr*>(expr)->expr.get();
+        }
+        break;
+
+        case AST::Types::SuffixExpr:
+        {
+            /*
+            Reduce to the sub expression: a swizzle of a broadcast scalar has the same value on all
+            components, and vector values fail later when they are converted to a scalar.
+            */
+            frame.expr = static_cast<SuffixExpr*>(expr)->expr.get();
+        }
+        break;
+
+        case AST::Types::ArrayAccessExpr:
+        {
+            Fail("array access");
+            return;
+        }
+        break;
+
+        case AST::Types::CastExpr:
+        {
+            frame.expr = static_cast<CastExpr*>(expr)->expr.get();
+        }
+        break;
+
+        case AST::Types::VarAccessExpr:
+        {
+            auto ast = static_cast<VarAccessExpr*>(expr);
+            if (throwOnFailure_)
+                Push(onVarAccessCallback_(ast));
+            else
+            {
+                /* Probe mode: a non-constant variable access fails the probe instead of throwing (see TryEvaluateExpr) */
+                Variant value;
+                if (onTryVarAccessCallback_ && onTryVarAccessCallback_(ast, value))
+                    Push(value);
+                else
+                {
+                    Fail("variable access");
+                    return;
+                }
+            }
+            frameStack_.pop_back();
+        }
+        break;
+
+        case AST::Types::InitializerExpr:
+        {
+            Fail("initializer list");
+            return;
+        }
+        break;
+
+        case AST::Types::LiteralBlobExpr:
+        {
+            Fail("initializer list");
+            return;
+        }
+        break;
+
+        default:
+        {
+            Fail("expression");
+            return;
+        }
+        break;
+    }
 }
 
-IMPLEMENT_VISIT_PROC(LiteralExpr)
+void ConstExprEvaluator::EvaluateLiteral(LiteralExpr* ast)
 {
     switch (ast->dataType)
     {
@@ -75,7 +413,7 @@ IMPLEMENT_VISIT_PROC(LiteralExpr)
             else if (ast->value == "false")
                 Push(false);
             else
-                IllegalExpr("boolean literal value '" + ast->value + "'");
+                Fail("boolean literal value '" + ast->value + "'");
         }
         break;
 
@@ -101,181 +439,74 @@ IMPLEMENT_VISIT_PROC(LiteralExpr)
 
         default:
         {
-            IllegalExpr("literal type '" + DataTypeToString(ast->dataType) + "'");
+            Fail("literal type '" + DataTypeToString(ast->dataType) + "'");
         }
         break;
     }
 }
 
-IMPLEMENT_VISIT_PROC(TypeNameExpr)
-{
-    IllegalExpr("type specifier");
-}
-
-IMPLEMENT_VISIT_PROC(TernaryExpr)
-{
-    Visit(ast->condExpr);
-    auto cond = Pop();
-
-    if (cond.ToBool())
-        Visit(ast->thenExpr);
-    else
-        Visit(ast->elseExpr);
-}
-
-// EXPR OP EXPR
-IMPLEMENT_VISIT_PROC(BinaryExpr)
+// Folds an already evaluated base type constructor call (e.g. "float4(1, 2, 3, 4)") into a vector variant.
+void ConstExprEvaluator::EvaluateTypeConstructor(FunctionCallExpr* ast)
 {
-    Visit(ast->lhsExpr);
-    Visit(ast->rhsExpr);
+    auto call = ast->call.get();
+    auto baseTypeDen = call->typeDenoter->As<BaseTypeDenoter>();
 
-    auto rhs = Pop();
-    auto lhs = Pop();
+    auto typeDim = MatrixTypeDim(baseTypeDen->dataType);
+    auto numComps = static_cast<std::size_t>(typeDim.first * typeDim.second);
 
-    switch (ast->op)
+    if (numComps < 2 || numComps > Variant::VecType().size())
     {
-        case BinaryOp::Undefined:
-            IllegalExpr("binary operator");
-            break;
-        case BinaryOp::LogicalAnd:
-            Push(lhs.ToBool() && rhs.ToBool());
-            break;
-        case BinaryOp::LogicalOr:
-            Push(lhs.ToBool() || rhs.ToBool());
-            break;
-        case BinaryOp::Or:
-            Push(lhs | rhs);
-            break;
-        case BinaryOp::Xor:
-            Push(lhs ^ rhs);
-            break;
-        case BinaryOp::And:
-            Push(lhs & rhs);
-            break;
-        case BinaryOp::LShift:
-            Push(lhs << rhs);
-            break;
-        case BinaryOp::RShift:
-            Push(lhs >> rhs);
-            break;
-        case BinaryOp::Add:
-            Push(lhs + rhs);
-            break;
-        case BinaryOp::Sub:
-            Push(lhs - rhs);
-            break;
-        case BinaryOp::Mul:
-            Push(lhs * rhs);
-            break;
-        case BinaryOp::Div:
-            Push(lhs / rhs);
-            break;
-        case BinaryOp::Mod:
-            Push(lhs % rhs);
-            break;
-        case BinaryOp::Equal:
-            Push(lhs == rhs);
-            break;
-        case BinaryOp::NotEqual:
-            Push(lhs != rhs);
-            break;
-        case BinaryOp::Less:
-            Push(lhs < rhs);
-            break;
-        case BinaryOp::Greater:
-            Push(lhs > rhs);
-            break;
-        case BinaryOp::LessEqual:
-            Push(lhs <= rhs);
-            break;
-        case BinaryOp::GreaterEqual:
-            Push(lhs >= rhs);
-            break;
+        Fail("function call");
+        return;
     }
-}
 
-// OP EXPR
-IMPLEMENT_VISIT_PROC(UnaryExpr)
-{
-    Visit(ast->expr);
+    /* Pop the argument values (in reverse evaluation order) and flatten them into the component list */
+    const auto numArgs = call->arguments.size();
 
-    auto rhs = Pop();
+    std::vector<Variant> args(numArgs);
+    for (std::size_t i = 0; i < numArgs; ++i)
+        args[numArgs - i - 1u] = Pop();
 
-    switch (ast->op)
+    Variant::VecType components = {{ }};
+    std::size_t numArgComps = 0;
+
+    for (auto& value : args)
     {
-        case UnaryOp::Undefined:
-            IllegalExpr("unary operator");
-            break;
-        case UnaryOp::LogicalNot:
-            Push(!rhs.ToBool());
-            break;
-        case UnaryOp::Not:
-            Push(~rhs);
-            break;
-        case UnaryOp::Nop:
-            Push(rhs);
-            break;
-        case UnaryOp::Negate:
-            Push(-rhs);
-            break;
-        case UnaryOp::Inc:
-            Push(++rhs);
-            break;
-        case UnaryOp::Dec:
-            Push(--rhs);
-            break;
+        if (value.Type() == Variant::Types::RealVec)
+        {
+            if (numArgComps + value.VecSize() > numComps)
+            {
+                Fail("number of components in type constructor");
+                return;
+            }
+            for (std::size_t i = 0; i < value.VecSize(); ++i)
+                components[numArgComps++] = value.Vec()[i];
+        }
+        else
+        {
+            if (numArgComps + 1 > numComps)
+            {
+                Fail("number of components in type constructor");
+                return;
+            }
+            components[numArgComps++] = value.ToReal();
+        }
     }
-}
 
-// EXPR OP
-IMPLEMENT_VISIT_PROC(PostUnaryExpr)
-{
-    Visit(ast->expr);
-
-    auto lhs = Pop();
-
-    switch (ast->op)
+    if (numArgComps == 1)
     {
-        case UnaryOp::Inc:
-        case UnaryOp::Dec:
-            /* Only return original value (post inc/dec will return the value BEFORE the operation) */
-            Push(lhs);
-            break;
-        default:
-            IllegalExpr("unary operator '" + UnaryOpToString(ast->op) + "'");
-            break;
+        /* Broadcast single scalar argument to all components */
+        components.fill(components[0]);
+    }
+    else if (numArgComps != numComps)
+    {
+        Fail("number of components in type constructor");
+        return;
     }
-}
-
-IMPLEMENT_VISIT_PROC(FunctionCallExpr)
-{
-    IllegalExpr("function call");
-    //Visit(ast->call);
-}
-
-IMPLEMENT_VISIT_PROC(BracketExpr)
-{
-    Visit(ast->expr);
-}
-
-IMPLEMENT_VISIT_PROC(CastExpr)
-{
-    //Visit(ast->typeExpr);
-    Visit(ast->expr);
-}
-
-IMPLEMENT_VISIT_PROC(VarAccessExpr)
-{
-    Push(onVarAccessCallback_(ast));
-}
 
-IMPLEMENT_VISIT_PROC(InitializerExpr)
-{
-    IllegalExpr("initializer list");
+    Push(Variant(components, numComps));
 }
 
-#undef IMPLEMENT_VISIT_PROC
-
 
 } // /namespace Xsc
 
@@ -1,6 +1,6 @@
 /*
  * ConstExprEvaluator.h
- * 
+ *
  * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
  * See "LICENSE.txt" for license information.
  */
@@ -11,7 +11,8 @@
 
 #include "Visitor.h"
 #include "Variant.h"
-#include <stack>
+#include "ASTEnums.h"
+#include <vector>
 #include <functional>
 
 
@@ -19,13 +20,18 @@ namespace Xsc
 {
 
 
-// Constant expression evaluator AST visitor.
-class ConstExprEvaluator : private Visitor
+/*
+Constant expression evaluator. The expression tree is evaluated iteratively with an explicit
+work list and value stack, so the evaluation of large machine-generated expression chains is
+linear and independent of the native stack size.
+*/
+class ConstExprEvaluator
 {
-    
+
     public:
-        
-        using OnVarAccessCallback = std::function<Variant(VarAccessExpr* ast)>;
+
+        using OnVarAccessCallback       = std::function<Variant(VarAccessExpr* ast)>;
+        using OnTryVarAccessCallback    = std::function<bool(VarAccessExpr* ast, Variant& value)>;
 
         /*
         Evaluates the specified expression and returns the result as variante.
@@ -33,34 +39,58 @@ class ConstExprEvaluator : private Visitor
         */
         Variant EvaluateExpr(Expr& ast, const OnVarAccessCallback& onVarAccessCallback = nullptr);
 
+        /*
+        Exception-free probe: evaluates the specified expression and returns false instead of
+        throwing if it is not constant. Speculative folding passes probe almost exclusively
+        non-constant expressions, so this path must not pay the throw/unwind cost per probe
+        (see Optimizer::TryEvaluateConstExpr); exceptions remain for invariant violations only.
+        */
+        bool TryEvaluateExpr(Expr& ast, Variant& result, const OnTryVarAccessCallback& onTryVarAccessCallback = nullptr);
+
     private:
-        
+
+        /* === Structures === */
+
+        // Work-list entry: an expression node together with the number of its sub expressions that are already evaluated.
+        struct Frame
+        {
+            Expr*       expr;
+            std::size_t state;
+        };
+
         /* === Functions === */
 
         void Push(const Variant& v);
         Variant Pop();
 
-        /* --- Visitor implementation --- */
-
-        DECL_VISIT_PROC( NullExpr         );
-        DECL_VISIT_PROC( ListExpr         );
-        DECL_VISIT_PROC( LiteralExpr      );
-        DECL_VISIT_PROC( TypeNameExpr     );
-        DECL_VISIT_PROC( TernaryExpr      );
-        DECL_VISIT_PROC( BinaryExpr       );
-        DECL_VISIT_PROC( UnaryExpr        );
-        DECL_VISIT_PROC( PostUnaryExpr    );
-        DECL_VISIT_PROC( FunctionCallExpr );
-        DECL_VISIT_PROC( BracketExpr      );
-        DECL_VISIT_PROC( CastExpr         );
-        DECL_VISIT_PROC( VarAccessExpr    );
-        DECL_VISIT_PROC( InitializerExpr  );
+        // Runs the work-list loop over the specified expression tree (stops early once a probe failed).
+        void EvaluateExprTree(Expr& ast);
+
+        // Signals a non-constant expression: throws in the evaluation mode, or marks the probe as failed (see TryEvaluateExpr).
+        void Fail(const std::string& exprName);
+
+        // Processes the top work-list frame: either schedules the next sub expression or reduces the node to a value.
+        void EvaluateTopFrame();
+
+        Variant ApplyBinaryOp(const BinaryOp op, Variant lhs, Variant rhs);
+        Variant ApplyUnaryOp(const UnaryOp op, Variant rhs);
+
+        void EvaluateLiteral(LiteralExpr* ast);
+        void EvaluateTypeConstructor(FunctionCallExpr* ast);
 
         /* === Members === */
 
-        std::stack<Variant> variantStack_;
+        std::vector<Frame>      frameStack_;
+        std::vector<Variant>    variantStack_;
+
+        OnVarAccessCallback     onVarAccessCallback_;
+        OnTryVarAccessCallback  onTryVarAccessCallback_;
+
+        // True if a non-constant expression throws; the probe mode records the failure instead (see TryEvaluateExpr).
+        bool                    throwOnFailure_         = true;
 
-        OnVarAccessCallback onVarAccessCallback_;
+        // True if the probe hit a non-constant expression (see Fail).
+        bool                    failed_                 = false;
 
 };
 
@@ -72,4 +102,4 @@ class ConstExprEvaluator : private Visitor
 
 
 
-// ================================================================================
\ No newline at end of file
+// ================================================================================
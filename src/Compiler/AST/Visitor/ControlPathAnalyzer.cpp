@@ -1,6 +1,6 @@
 /*
  * ControlPathAnalyzer.cpp
- * 
+ *
  * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
  * See "LICENSE.txt" for license information.
  */
@@ -18,7 +18,7 @@ void ControlPathAnalyzer::MarkControlPaths(Program& program)
     for (auto& stmnt : program.globalStmnts)
     {
         if (stmnt->Type() == AST::Types::FunctionDecl)
-            Visit(stmnt);
+            MarkFunctionControlPaths(static_cast<FunctionDecl*>(stmnt.get()));
     }
 }
 
@@ -27,190 +27,218 @@ void ControlPathAnalyzer::MarkControlPaths(Program& program)
  * ======= Private: =======
  */
 
-void ControlPathAnalyzer::PushReturnPath(bool returnPath)
+void ControlPathAnalyzer::PushFrame(Stmnt* stmnt)
 {
-    returnPathStack_.push(returnPath);
+    frameStack_.push_back({ stmnt, nullptr, 0, false });
 }
 
-bool ControlPathAnalyzer::PopReturnPath()
+void ControlPathAnalyzer::PushFrame(const std::vector<StmntPtr>& stmnts)
 {
-    if (!returnPathStack_.empty())
-    {
-        auto v = returnPathStack_.top();
-        returnPathStack_.pop();
-        return v;
-    }
-    return false;
+    frameStack_.push_back({ nullptr, &stmnts, 0, false });
 }
 
-void ControlPathAnalyzer::VisitStmntList(const std::vector<StmntPtr>& stmnts)
+void ControlPathAnalyzer::Push(bool returnPath)
 {
-    /* Search for return statement */
-    bool hasReturnPath = false;
-
-    for (auto& ast : stmnts)
-    {
-        if (hasReturnPath)
-        {
-            /* Mark all statmenets after return path as dead code */
-            ast->flags << AST::isDeadCode;
-        }
-        else
-        {
-            /* Search in statement for return path */
-            Visit(ast);
-            if (PopReturnPath())
-                hasReturnPath = true;
-        }
-    }
-
-    PushReturnPath(hasReturnPath);
+    returnPaths_.push_back(returnPath);
 }
 
-/* ------- Visit functions ------- */
-
-#define IMPLEMENT_VISIT_PROC(AST_NAME) \
-    void ControlPathAnalyzer::Visit##AST_NAME(AST_NAME* ast, void* args)
-
-IMPLEMENT_VISIT_PROC(CodeBlock)
+bool ControlPathAnalyzer::Pop()
 {
-    VisitStmntList(ast->stmnts);
+    if (returnPaths_.empty())
+        return false;
+    auto v = returnPaths_.back();
+    returnPaths_.pop_back();
+    return v;
 }
 
-/* --- Declaration statements --- */
-
-IMPLEMENT_VISIT_PROC(FunctionDecl)
+void ControlPathAnalyzer::ProcessTopFrame()
 {
-    Visit(ast->codeBlock);
+    auto& frame = frameStack_.back();
 
-    /* Return statement found in all control paths? */
-    if (!PopReturnPath())
+    if (frame.stmnts)
     {
-        if (!ast->returnType->typeDenoter->IsVoid() && !ast->IsForwardDecl())
+        /* Fold statement list: all statements after the first return path are dead code */
+        const auto& stmnts = *frame.stmnts;
+
+        if (frame.state > 0 && Pop())
         {
-            /* Mark function with non-return-path flag */
-            ast->flags << FunctionDecl::hasNonReturnControlPath;
+            /* Mark all statements after the return path as dead code */
+            for (auto i = frame.state; i < stmnts.size(); ++i)
+                stmnts[i]->flags << AST::isDeadCode;
+
+            Push(true);
+            frameStack_.pop_back();
+        }
+        else if (frame.state < stmnts.size())
+        {
+            /* Search next statement for a return path */
+            auto stmnt = stmnts[frame.state].get();
+            ++frame.state;
+            PushFrame(stmnt);
         }
+        else
+        {
+            /* No statement with a return path found */
+            Push(false);
+            frameStack_.pop_back();
+        }
+        return;
     }
-}
 
-IMPLEMENT_VISIT_PROC(BufferDeclStmnt)
-{
-    PushReturnPath(false);
-}
+    auto stmnt = frame.stmnt;
 
-IMPLEMENT_VISIT_PROC(TextureDeclStmnt)
-{
-    PushReturnPath(false);
-}
-
-IMPLEMENT_VISIT_PROC(SamplerDeclStmnt)
-{
-    PushReturnPath(false);
-}
-
-IMPLEMENT_VISIT_PROC(StructDeclStmnt)
-{
-    PushReturnPath(false);
-}
+    if (!stmnt)
+    {
+        Push(false);
+        frameStack_.pop_back();
+        return;
+    }
 
-IMPLEMENT_VISIT_PROC(VarDeclStmnt)
-{
-    PushReturnPath(false);
-}
+    switch (stmnt->Type())
+    {
+        case AST::Types::CodeBlockStmnt:
+        {
+            auto ast = static_cast<CodeBlockStmnt*>(stmnt);
+            frameStack_.pop_back();
+            if (ast->codeBlock)
+                PushFrame(ast->codeBlock->stmnts);
+            else
+                Push(false);
+        }
+        break;
 
-IMPLEMENT_VISIT_PROC(AliasDeclStmnt)
-{
-    PushReturnPath(false);
-}
+        case AST::Types::ForLoopStmnt:
+        {
+            auto bodyStmnt = static_cast<ForLoopStmnt*>(stmnt)->bodyStmnt.get();
+            frameStack_.pop_back();
+            PushFrame(bodyStmnt);
+        }
+        break;
 
-/* --- Statements --- */
+        case AST::Types::WhileLoopStmnt:
+        {
+            auto bodyStmnt = static_cast<WhileLoopStmnt*>(stmnt)->bodyStmnt.get();
+            frameStack_.pop_back();
+            PushFrame(bodyStmnt);
+        }
+        break;
 
-IMPLEMENT_VISIT_PROC(NullStmnt)
-{
-    PushReturnPath(false);
-}
+        case AST::Types::DoWhileLoopStmnt:
+        {
+            auto bodyStmnt = static_cast<DoWhileLoopStmnt*>(stmnt)->bodyStmnt.get();
+            frameStack_.pop_back();
+            PushFrame(bodyStmnt);
+        }
+        break;
 
-IMPLEMENT_VISIT_PROC(CodeBlockStmnt)
-{
-    Visit(ast->codeBlock);
-}
+        case AST::Types::IfStmnt:
+        {
+            auto ast = static_cast<IfStmnt*>(stmnt);
+            if (frame.state == 0)
+            {
+                frame.state = 1;
+                PushFrame(ast->bodyStmnt.get());
+            }
+            else if (frame.state == 1)
+            {
+                /* The 'if'-statement only covers all paths when both branches have a return path */
+                frame.flag = Pop();
+                if (ast->elseStmnt)
+                {
+                    frame.state = 2;
+                    PushFrame(ast->elseStmnt->bodyStmnt.get());
+                }
+                else
+                {
+                    Push(false);
+                    frameStack_.pop_back();
+                }
+            }
+            else
+            {
+                auto elsePath = Pop();
+                Push(frame.flag && elsePath);
+                frameStack_.pop_back();
+            }
+        }
+        break;
 
-IMPLEMENT_VISIT_PROC(ForLoopStmnt)
-{
-    Visit(ast->bodyStmnt);
-}
+        case AST::Types::SwitchStmnt:
+        {
+            auto ast = static_cast<SwitchStmnt*>(stmnt);
+            if (frame.state > 0 && !Pop())
+            {
+                /* This case has a non-return-path, so the remaining cases are not inspected */
+                Push(false);
+                frameStack_.pop_back();
+            }
+            else if (frame.state < ast->cases.size())
+            {
+                /* Search next case for a return path */
+                const auto& stmnts = ast->cases[frame.state]->stmnts;
+                ++frame.state;
+                PushFrame(stmnts);
+            }
+            else
+            {
+                /* All cases have a return path, but the switch only covers all control paths with a default case */
+                auto hasDefaultCase = false;
+                for (const auto& switchCase : ast->cases)
+                {
+                    if (switchCase->IsDefaultCase())
+                        hasDefaultCase = true;
+                }
+                Push(hasDefaultCase);
+                frameStack_.pop_back();
+            }
+        }
+        break;
 
-IMPLEMENT_VISIT_PROC(WhileLoopStmnt)
-{
-    Visit(ast->bodyStmnt);
-}
+        case AST::Types::ReturnStmnt:
+        {
+            /* Found return statement */
+            Push(true);
+            frameStack_.pop_back();
+        }
+        break;
 
-IMPLEMENT_VISIT_PROC(DoWhileLoopStmnt)
-{
-    Visit(ast->bodyStmnt);
+        default:
+        {
+            /* All other statements have no return path */
+            Push(false);
+            frameStack_.pop_back();
+        }
+        break;
+    }
 }
 
-IMPLEMENT_VISIT_PROC(IfStmnt)
+void ControlPathAnalyzer::MarkFunctionControlPaths(FunctionDecl* funcDecl)
 {
-    Visit(ast->bodyStmnt);
-    auto thenPath = PopReturnPath();
+    if (!funcDecl->codeBlock)
+        return;
 
-    Visit(ast->elseStmnt);
-    auto elsePath = PopReturnPath();
+    frameStack_.clear();
+    returnPaths_.clear();
 
-    PushReturnPath(thenPath && elsePath);
-}
+    PushFrame(funcDecl->codeBlock->stmnts);
 
-IMPLEMENT_VISIT_PROC(ElseStmnt)
-{
-    Visit(ast->bodyStmnt);
-}
+    while (!frameStack_.empty())
+        ProcessTopFrame();
 
-IMPLEMENT_VISIT_PROC(SwitchStmnt)
-{
-    bool hasDefaultCase = false;
-
-    for (auto& switchCase : ast->cases)
+    /* Return statement found in all control paths? */
+    if (!Pop())
     {
-        /* Has the switch statement a default case? */
-        if (switchCase->IsDefaultCase())
-            hasDefaultCase = true;
-
-        /* Has this case a non-return-path? */
-        VisitStmntList(switchCase->stmnts);
-        if (!PopReturnPath())
+        if (!funcDecl->returnType->typeDenoter->IsVoid() && !funcDecl->IsForwardDecl())
         {
-            PushReturnPath(false);
-            return;
+            /* Mark function with non-return-path flag */
+            funcDecl->flags << FunctionDecl::hasNonReturnControlPath;
         }
     }
-
-    /* All cases have a return path, but has the switch statement a default case? */
-    PushReturnPath(hasDefaultCase);
 }
 
-IMPLEMENT_VISIT_PROC(ExprStmnt)
-{
-    PushReturnPath(false);
-}
-
-IMPLEMENT_VISIT_PROC(ReturnStmnt)
-{
-    /* Found return statement */
-    PushReturnPath(true);
-}
-
-IMPLEMENT_VISIT_PROC(CtrlTransferStmnt)
-{
-    PushReturnPath(false);
-}
-
-#undef IMPLEMENT_VISIT_PROC
-
 
 } // /namespace Xsc
 
 
 
-// ================================================================================
\ No newline at end of file
+// ================================================================================
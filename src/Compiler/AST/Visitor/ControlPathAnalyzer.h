@@ -1,6 +1,6 @@
 /*
  * ControlPathAnalyzer.h
- * 
+ *
  * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
  * See "LICENSE.txt" for license information.
  */
@@ -10,7 +10,8 @@
 
 
 #include "Visitor.h"
-#include <stack>
+#include <vector>
+#include <cstddef>
 
 
 namespace Xsc
@@ -18,52 +19,50 @@ namespace Xsc
 
 
 /*
-Control path analyzer (must implement visitors for all statements).
-This helper class for the context analyzer marks all functions
+Control path analyzer.
+This helper class for the code generator marks all functions
 where not all control paths return a value (if the function is declared to have a return value).
 It also marks all statements as dead code, when they appear after a return path.
+The analysis runs on an explicit work list over the statement tree, so the work is linear in the
+number of statements and independent of the nesting depth and the native stack size.
 */
-class ControlPathAnalyzer : private Visitor
+class ControlPathAnalyzer
 {
-    
+
     public:
-        
+
         void MarkControlPaths(Program& program);
 
     private:
-        
-        void PushReturnPath(bool returnPath);
-        bool PopReturnPath();
-
-        void VisitStmntList(const std::vector<StmntPtr>& stmnts);
-
-        /* ----- Visitor implementation ----- */
-
-        DECL_VISIT_PROC( CodeBlock         );
-
-        DECL_VISIT_PROC( FunctionDecl      );
-        DECL_VISIT_PROC( BufferDeclStmnt   );
-        DECL_VISIT_PROC( TextureDeclStmnt  );
-        DECL_VISIT_PROC( SamplerDeclStmnt  );
-        DECL_VISIT_PROC( StructDeclStmnt   );
-        DECL_VISIT_PROC( VarDeclStmnt      );
-        DECL_VISIT_PROC( AliasDeclStmnt    );
-
-        DECL_VISIT_PROC( NullStmnt         );
-        DECL_VISIT_PROC( CodeBlockStmnt    );
-        DECL_VISIT_PROC( ForLoopStmnt      );
-        DECL_VISIT_PROC( WhileLoopStmnt    );
-        DECL_VISIT_PROC( DoWhileLoopStmnt  );
-        DECL_VISIT_PROC( IfStmnt           );
-        DECL_VISIT_PROC( ElseStmnt         );
-        DECL_VISIT_PROC( SwitchStmnt       );
-        DECL_VISIT_PROC( ExprStmnt         );
-        DECL_VISIT_PROC( ReturnStmnt       );
-        DECL_VISIT_PROC( CtrlTransferStmnt );
+
+        /* === Structures === */
+
+        // Work-list entry: either a single statement, or a statement list (when 'stmnts' is set) that is folded element-wise.
+        struct Frame
+        {
+            Stmnt*                          stmnt;
+            const std::vector<StmntPtr>*    stmnts;
+            std::size_t                     state;
+            bool                            flag;   // Intermediate result (e.g. return path of the 'then'-branch)
+        };
+
+        /* === Functions === */
+
+        void PushFrame(Stmnt* stmnt);
+        void PushFrame(const std::vector<StmntPtr>& stmnts);
+
+        void Push(bool returnPath);
+        bool Pop();
+
+        // Processes the top work-list frame: either schedules the next sub statement or folds the frame into a return-path value.
+        void ProcessTopFrame();
+
+        void MarkFunctionControlPaths(FunctionDecl* funcDecl);
 
         /* === Members === */
 
-        std::stack<bool> returnPathStack_;
+        std::vector<Frame>  frameStack_;
+        std::vector<bool>   returnPaths_;
 
 };
 
@@ -75,4 +74,4 @@ class ControlPathAnalyzer : private Visitor
 
 
 
-// ================================================================================
\ No newline at end of file
+// ================================================================================
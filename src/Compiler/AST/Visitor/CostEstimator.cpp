@@ -0,0 +1,234 @@
+/*
+ * CostEstimator.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "CostEstimator.h"
+#include "AST.h"
+#include <algorithm>
+
+
+namespace Xsc
+{
+
+
+/*
+Weights of the per-function metrics for the accumulated total cost.
+These are rough relative latencies of the operation classes on current GPUs,
+not measurements for any particular architecture.
+*/
+static const std::size_t costWeightAlu_             = 1;
+static const std::size_t costWeightBranch_          = 2;
+static const std::size_t costWeightTranscendental_  = 4;
+static const std::size_t costWeightTextureFetch_    = 16;
+
+
+void CostEstimator::EstimateCosts(Program& program, std::vector<Reflection::FunctionCost>& functionCosts)
+{
+    records_.clear();
+    recordOrder_.clear();
+
+    /* Collect the local metrics of all reachable function definitions */
+    for (const auto& stmnt : program.globalStmnts)
+    {
+        if (stmnt->Type() == AST::Types::FunctionDecl)
+        {
+            auto funcDecl = static_cast<FunctionDecl*>(stmnt.get());
+            if (funcDecl->codeBlock && (funcDecl->flags(AST::isReachable) || funcDecl->flags(FunctionDecl::isEntryPoint)))
+            {
+                auto& record = records_[funcDecl];
+
+                record.cost.name        = funcDecl->ident;
+                record.cost.entryPoint  = funcDecl->flags(FunctionDecl::isEntryPoint);
+
+                recordOrder_.push_back(funcDecl);
+
+                CollectLocalMetrics(funcDecl, record);
+            }
+        }
+    }
+
+    /* Accumulate the total costs over the call graph */
+    for (auto funcDecl : recordOrder_)
+        ResolveTotalCost(records_[funcDecl]);
+
+    /* Report the costs in declaration order */
+    for (auto funcDecl : recordOrder_)
+        functionCosts.push_back(records_[funcDecl].cost);
+}
+
+
+/*
+ * ======= Private: =======
+ */
+
+void CostEstimator::CollectLocalMetrics(FunctionDecl* funcDecl, FunctionRecord& record)
+{
+    current_    = &record;
+    loopDepth_  = 0;
+
+    Visit(funcDecl->codeBlock);
+
+    current_ = nullptr;
+}
+
+std::size_t CostEstimator::ResolveTotalCost(FunctionRecord& record)
+{
+    /*
+    Resolve the call graph with an explicit stack instead of recursive descent,
+    so long call chains (e.g. from generated stress shaders) are independent of the
+    native stack size. Call graph cycles are broken by the 'inProgress' guard;
+    the back edge of a recursive call then contributes no additional cost.
+    */
+    std::vector<FunctionRecord*> recordStack { &record };
+
+    while (!recordStack.empty())
+    {
+        auto rec = recordStack.back();
+
+        if (rec->resolved)
+        {
+            recordStack.pop_back();
+            continue;
+        }
+
+        if (!rec->inProgress)
+        {
+            /* First encounter: resolve all callees before this record */
+            rec->inProgress = true;
+            for (auto callee : rec->callees)
+            {
+                auto it = records_.find(callee);
+                if (it != records_.end() && !it->second.resolved && !it->second.inProgress)
+                    recordStack.push_back(&(it->second));
+            }
+            continue;
+        }
+
+        /* Second encounter: all resolvable callees are done, so accumulate the total cost */
+        auto totalCost = LocalCost(rec->cost);
+
+        for (auto callee : rec->callees)
+        {
+            auto it = records_.find(callee);
+            if (it != records_.end() && it->second.resolved)
+                totalCost += it->second.cost.totalCost;
+        }
+
+        rec->cost.totalCost = totalCost;
+        rec->resolved       = true;
+        rec->inProgress     = false;
+
+        recordStack.pop_back();
+    }
+
+    return record.cost.totalCost;
+}
+
+std::size_t CostEstimator::LocalCost(const Reflection::FunctionCost& cost) const
+{
+    return
+    (
+        cost.numAluOps            * costWeightAlu_            +
+        cost.numTranscendentalOps * costWeightTranscendental_ +
+        cost.numTextureFetches    * costWeightTextureFetch_   +
+        cost.numBranches          * costWeightBranch_
+    );
+}
+
+
+/* ------- Visit functions ------- */
+
+#define IMPLEMENT_VISIT_PROC(AST_NAME) \
+    void CostEstimator::Visit##AST_NAME(AST_NAME* ast, void* args)
+
+IMPLEMENT_VISIT_PROC(FunctionCall)
+{
+    if (ast->intrinsic != Intrinsic::Undefined)
+    {
+        /* Classify the intrinsic call by its intrinsic ID */
+        if (IsTextureFetchIntrinsic(ast->intrinsic))
+            ++current_->cost.numTextureFetches;
+        else if (IsTranscendentalIntrinsic(ast->intrinsic))
+            ++current_->cost.numTranscendentalOps;
+        else
+            ++current_->cost.numAluOps;
+    }
+    else if (ast->funcDeclRef)
+    {
+        /* Record the call edge; each call site adds the callee cost once */
+        current_->callees.push_back(ast->funcDeclRef);
+    }
+    VISIT_DEFAULT(FunctionCall);
+}
+
+IMPLEMENT_VISIT_PROC(ForLoopStmnt)
+{
+    ++loopDepth_;
+    current_->cost.maxLoopDepth = std::max(current_->cost.maxLoopDepth, loopDepth_);
+    VISIT_DEFAULT(ForLoopStmnt);
+    --loopDepth_;
+}
+
+IMPLEMENT_VISIT_PROC(WhileLoopStmnt)
+{
+    ++loopDepth_;
+    current_->cost.maxLoopDepth = std::max(current_->cost.maxLoopDepth, loopDepth_);
+    VISIT_DEFAULT(WhileLoopStmnt);
+    --loopDepth_;
+}
+
+IMPLEMENT_VISIT_PROC(DoWhileLoopStmnt)
+{
+    ++loopDepth_;
+    current_->cost.maxLoopDepth = std::max(current_->cost.maxLoopDepth, loopDepth_);
+    VISIT_DEFAULT(DoWhileLoopStmnt);
+    --loopDepth_;
+}
+
+IMPLEMENT_VISIT_PROC(IfStmnt)
+{
+    ++current_->cost.numBranches;
+    VISIT_DEFAULT(IfStmnt);
+}
+
+IMPLEMENT_VISIT_PROC(SwitchStmnt)
+{
+    ++current_->cost.numBranches;
+    VISIT_DEFAULT(SwitchStmnt);
+}
+
+IMPLEMENT_VISIT_PROC(TernaryExpr)
+{
+    ++current_->cost.numBranches;
+    VISIT_DEFAULT(TernaryExpr);
+}
+
+IMPLEMENT_VISIT_PROC(BinaryExpr)
+{
+    ++current_->cost.numAluOps;
+    VISIT_DEFAULT(BinaryExpr);
+}
+
+IMPLEMENT_VISIT_PROC(UnaryExpr)
+{
+    ++current_->cost.numAluOps;
+    VISIT_DEFAULT(UnaryExpr);
+}
+
+IMPLEMENT_VISIT_PROC(PostUnaryExpr)
+{
+    ++current_->cost.numAluOps;
+    VISIT_DEFAULT(PostUnaryExpr);
+}
+
+#undef IMPLEMENT_VISIT_PROC
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
@@ -0,0 +1,89 @@
+/*
+ * CostEstimator.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_COST_ESTIMATOR_H
+#define XSC_COST_ESTIMATOR_H
+
+
+#include <Xsc/Reflection.h>
+#include "Visitor.h"
+#include <map>
+#include <vector>
+#include <cstddef>
+
+
+namespace Xsc
+{
+
+
+/*
+Shader cost estimator.
+This helper class for the code generator estimates the runtime cost of all functions
+reachable from the entry point: ALU, transcendental, and texture fetch operation counts,
+branch counts, and loop nesting depth (see Reflection::FunctionCost). The per-function
+metrics are then accumulated over the call graph into a weighted total cost.
+*/
+class CostEstimator : private Visitor
+{
+
+    public:
+
+        // Estimates the cost of all reachable functions in the specified program.
+        void EstimateCosts(Program& program, std::vector<Reflection::FunctionCost>& functionCosts);
+
+    private:
+
+        // Per-function record with the collected metrics and the outgoing call edges.
+        struct FunctionRecord
+        {
+            Reflection::FunctionCost    cost;
+            std::vector<FunctionDecl*>  callees;
+            bool                        resolved    = false;    // True if 'cost.totalCost' has been accumulated over the callees.
+            bool                        inProgress  = false;    // Cycle guard for the call graph traversal.
+        };
+
+        // Collects the local metrics of the specified function body.
+        void CollectLocalMetrics(FunctionDecl* funcDecl, FunctionRecord& record);
+
+        // Accumulates the total cost of the specified record over its call graph (recursive calls are counted once).
+        std::size_t ResolveTotalCost(FunctionRecord& record);
+
+        // Returns the weighted local cost of the specified metrics (without callees).
+        std::size_t LocalCost(const Reflection::FunctionCost& cost) const;
+
+        /* ----- Visitor implementation ----- */
+
+        DECL_VISIT_PROC( FunctionCall     );
+
+        DECL_VISIT_PROC( ForLoopStmnt     );
+        DECL_VISIT_PROC( WhileLoopStmnt   );
+        DECL_VISIT_PROC( DoWhileLoopStmnt );
+        DECL_VISIT_PROC( IfStmnt          );
+        DECL_VISIT_PROC( SwitchStmnt      );
+
+        DECL_VISIT_PROC( TernaryExpr      );
+        DECL_VISIT_PROC( BinaryExpr       );
+        DECL_VISIT_PROC( UnaryExpr        );
+        DECL_VISIT_PROC( PostUnaryExpr    );
+
+        std::map<FunctionDecl*, FunctionRecord> records_;
+        std::vector<FunctionDecl*>              recordOrder_;
+
+        FunctionRecord*                         current_    = nullptr;
+        std::size_t                             loopDepth_  = 0;
+
+};
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
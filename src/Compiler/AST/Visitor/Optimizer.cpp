@@ -1,37 +1,1396 @@
 /*
  * Optimizer.cpp
- * 
+ *
  * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
  * See "LICENSE.txt" for license information.
  */
 
 #include "Optimizer.h"
+#include "ConstExprEvaluator.h"
+#include "ASTFactory.h"
+#include "TypeDenoter.h"
 #include "AST.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
 
 
 namespace Xsc
 {
 
 
-void Optimizer::Optimize(Program& program)
+void Optimizer::Optimize(Program& program, const std::string& nameManglingPrefix)
 {
+    nameManglingPrefix_ = nameManglingPrefix;
     Visit(&program);
 }
 
 
+/*
+ * Internal helper functions for loop-invariant extraction
+ */
+
+// Returns true if the specified intrinsic is a pure function, i.e. it has no side effects and no output parameters,
+// and does not depend on implicit state (e.g. texture sampling or partial derivatives).
+static bool IsHoistableIntrinsic(const Intrinsic intrinsic)
+{
+    static const std::set<Intrinsic> hoistableIntrinsics
+    {
+        Intrinsic::Abs,             Intrinsic::ACos,            Intrinsic::All,             Intrinsic::Any,
+        Intrinsic::AsDouble,        Intrinsic::AsFloat,         Intrinsic::ASin,            Intrinsic::AsInt,
+        Intrinsic::AsUInt_1,        Intrinsic::ATan,            Intrinsic::ATan2,           Intrinsic::Ceil,
+        Intrinsic::Clamp,           Intrinsic::Cos,             Intrinsic::CosH,            Intrinsic::CountBits,
+        Intrinsic::Cross,           Intrinsic::Degrees,         Intrinsic::Determinant,     Intrinsic::Distance,
+        Intrinsic::Dot,             Intrinsic::Dst,             Intrinsic::Exp,             Intrinsic::Exp2,
+        Intrinsic::F16toF32,        Intrinsic::F32toF16,        Intrinsic::FaceForward,     Intrinsic::FirstBitHigh,
+        Intrinsic::FirstBitLow,     Intrinsic::Floor,           Intrinsic::FMA,             Intrinsic::FMod,
+        Intrinsic::Frac,            Intrinsic::IsFinite,        Intrinsic::IsInf,           Intrinsic::IsNaN,
+        Intrinsic::LdExp,           Intrinsic::Length,          Intrinsic::Lerp,            Intrinsic::Lit,
+        Intrinsic::Log,             Intrinsic::Log10,           Intrinsic::Log2,            Intrinsic::MAD,
+        Intrinsic::Max,             Intrinsic::Min,             Intrinsic::Mul,             Intrinsic::Normalize,
+        Intrinsic::Pow,             Intrinsic::Radians,         Intrinsic::Rcp,             Intrinsic::Reflect,
+        Intrinsic::Refract,         Intrinsic::ReverseBits,     Intrinsic::Round,           Intrinsic::RSqrt,
+        Intrinsic::Saturate,        Intrinsic::Sign,            Intrinsic::Sin,             Intrinsic::SinH,
+        Intrinsic::SmoothStep,      Intrinsic::Sqrt,            Intrinsic::Step,            Intrinsic::Tan,
+        Intrinsic::TanH,            Intrinsic::Transpose,       Intrinsic::Trunc,
+    };
+    return (hoistableIntrinsics.find(intrinsic) != hoistableIntrinsics.end());
+}
+
+// Returns true if the specified intrinsic writes to (some of) its arguments.
+static bool IntrinsicHasOutputParams(const Intrinsic intrinsic)
+{
+    return
+    (
+        intrinsic == Intrinsic::SinCos ||
+        intrinsic == Intrinsic::ModF ||
+        intrinsic == Intrinsic::FrExp ||
+        intrinsic == Intrinsic::AsUInt_3 ||
+        intrinsic == Intrinsic::Texture_GetDimensions ||
+        ( intrinsic >= Intrinsic::InterlockedAdd && intrinsic <= Intrinsic::InterlockedXor ) ||
+        ( intrinsic >= Intrinsic::Process2DQuadTessFactorsAvg && intrinsic <= Intrinsic::ProcessTriTessFactorsMin )
+    );
+}
+
+// Collects all variables that are written to (or declared) inside a loop statement.
+class LoopWriteCollector : private StaticVisitor<LoopWriteCollector>
+{
+
+    public:
+
+        std::set<const VarDecl*> CollectWrittenVars(Stmnt& loopStmnt)
+        {
+            Visit(&loopStmnt);
+            return std::move(writtenVars_);
+        }
+
+    private:
+
+        friend StaticVisitorT;
+
+        void MarkVarIdent(VarIdent* varIdent)
+        {
+            if (varIdent && varIdent->symbolRef && varIdent->symbolRef->Type() == AST::Types::VarDecl)
+                writtenVars_.insert(static_cast<VarDecl*>(varIdent->symbolRef));
+        }
+
+        void MarkVarAccess(Expr* expr)
+        {
+            if (auto varIdent = ASTFactory::FindSingleVarIdent(expr))
+                MarkVarIdent(varIdent.get());
+        }
+
+        /* ----- Visitor implementation ----- */
+
+        DECL_STATIC_VISIT_PROC( FunctionCall )
+        {
+            if (ast->intrinsic == Intrinsic::Undefined)
+            {
+                if (auto funcDecl = ast->funcDeclRef)
+                {
+                    /* Mark all arguments that are bound to output parameters */
+                    for (std::size_t i = 0; i < ast->arguments.size() && i < funcDecl->parameters.size(); ++i)
+                    {
+                        if (funcDecl->parameters[i]->IsOutput())
+                            MarkVarAccess(ast->arguments[i].get());
+                    }
+                }
+                else if (!ast->typeDenoter)
+                {
+                    /* Unknown function signature -> conservatively mark all arguments
+                       (type constructors like "float4(...)" never write to their arguments) */
+                    for (const auto& arg : ast->arguments)
+                        MarkVarAccess(arg.get());
+                }
+            }
+            else if (IntrinsicHasOutputParams(ast->intrinsic))
+            {
+                /* Conservatively mark all arguments of intrinsics with output parameters */
+                for (const auto& arg : ast->arguments)
+                    MarkVarAccess(arg.get());
+            }
+
+            STATIC_VISIT_DEFAULT(FunctionCall);
+        }
+
+        DECL_STATIC_VISIT_PROC( VarDecl )
+        {
+            /* A variable declared inside the loop is re-initialized on every iteration */
+            writtenVars_.insert(ast);
+
+            STATIC_VISIT_DEFAULT(VarDecl);
+        }
+
+        DECL_STATIC_VISIT_PROC( UnaryExpr )
+        {
+            if (ast->op == UnaryOp::Inc || ast->op == UnaryOp::Dec)
+                MarkVarAccess(ast->expr.get());
+
+            STATIC_VISIT_DEFAULT(UnaryExpr);
+        }
+
+        DECL_STATIC_VISIT_PROC( PostUnaryExpr )
+        {
+            if (ast->op == UnaryOp::Inc || ast->op == UnaryOp::Dec)
+                MarkVarAccess(ast->expr.get());
+
+            STATIC_VISIT_DEFAULT(PostUnaryExpr);
+        }
+
+        DECL_STATIC_VISIT_PROC( VarAccessExpr )
+        {
+            if (ast->assignOp != AssignOp::Undefined)
+                MarkVarIdent(ast->varIdent.get());
+
+            STATIC_VISIT_DEFAULT(VarAccessExpr);
+        }
+
+        /* === Members === */
+
+        std::set<const VarDecl*> writtenVars_;
+
+};
+
+static bool IsInvariantExpr(const Expr* expr, const std::set<const VarDecl*>& writtenVars);
+
+// Returns true if the root identifier refers to a variable that is not written to inside the loop, and all array indices are invariant.
+static bool IsInvariantVarIdent(const VarIdent* varIdent, const std::set<const VarDecl*>& writtenVars)
+{
+    if (!varIdent)
+        return false;
+
+    auto symbolRef = varIdent->symbolRef;
+    if (!symbolRef || symbolRef->Type() != AST::Types::VarDecl)
+        return false;
+
+    if (writtenVars.find(static_cast<const VarDecl*>(symbolRef)) != writtenVars.end())
+        return false;
+
+    for (auto ident = varIdent; ident != nullptr; ident = ident->next.get())
+    {
+        for (const auto& arrayIndex : ident->arrayIndices)
+        {
+            if (!IsInvariantExpr(arrayIndex.get(), writtenVars))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+// Returns true if the specified expression yields the same value on every loop iteration.
+static bool IsInvariantExpr(const Expr* expr, const std::set<const VarDecl*>& writtenVars)
+{
+    if (!expr)
+        return false;
+
+    switch (expr->Type())
+    {
+        case AST::Types::LiteralExpr:
+        {
+            return true;
+        }
+        case AST::Types::VarAccessExpr:
+        {
+            auto varAccessExpr = static_cast<const VarAccessExpr*>(expr);
+            return (varAccessExpr->assignOp == AssignOp::Undefined && IsInvariantVarIdent(varAccessExpr->varIdent.get(), writtenVars));
+        }
+        case AST::Types::BracketExpr:
+        {
+            return IsInvariantExpr(static_cast<const BracketExpr*>(expr)->expr.get(), writtenVars);
+        }
+        case AST::Types::CastExpr:
+        {
+            return IsInvariantExpr(static_cast<const CastExpr*>(expr)->expr.get(), writtenVars);
+        }
+        case AST::Types::UnaryExpr:
+        {
+            auto unaryExpr = static_cast<const UnaryExpr*>(expr);
+            return (unaryExpr->op != UnaryOp::Inc && unaryExpr->op != UnaryOp::Dec && IsInvariantExpr(unaryExpr->expr.get(), writtenVars));
+        }
+        case AST::Types::BinaryExpr:
+        {
+            auto binaryExpr = static_cast<const BinaryExpr*>(expr);
+            return (IsInvariantExpr(binaryExpr->lhsExpr.get(), writtenVars) && IsInvariantExpr(binaryExpr->rhsExpr.get(), writtenVars));
+        }
+        case AST::Types::TernaryExpr:
+        {
+            auto ternaryExpr = static_cast<const TernaryExpr*>(expr);
+            return
+            (
+                IsInvariantExpr(ternaryExpr->condExpr.get(), writtenVars) &&
+                IsInvariantExpr(ternaryExpr->thenExpr.get(), writtenVars) &&
+                IsInvariantExpr(ternaryExpr->elseExpr.get(), writtenVars)
+            );
+        }
+        case AST::Types::FunctionCallExpr:
+        {
+            auto call = static_cast<const FunctionCallExpr*>(expr)->call.get();
+            if (!call || !IsHoistableIntrinsic(call->intrinsic))
+                return false;
+            for (const auto& arg : call->arguments)
+            {
+                if (!IsInvariantExpr(arg.get(), writtenVars))
+                    return false;
+            }
+            return true;
+        }
+        default:
+        {
+            return false;
+        }
+    }
+}
+
+// Appends a structural key of the specified expression, so identical expressions can share a single hoisted temporary.
+static void AppendExprKey(const Expr* expr, std::string& key)
+{
+    switch (expr->Type())
+    {
+        case AST::Types::LiteralExpr:
+        {
+            auto literalExpr = static_cast<const LiteralExpr*>(expr);
+            key += 'L';
+            key += std::to_string(static_cast<int>(literalExpr->dataType));
+            key += ':';
+            key += literalExpr->value;
+        }
+        break;
+
+        case AST::Types::VarAccessExpr:
+        {
+            auto varAccessExpr = static_cast<const VarAccessExpr*>(expr);
+            auto varIdent = varAccessExpr->varIdent.get();
+            key += 'V';
+            key += std::to_string(reinterpret_cast<std::uintptr_t>(varIdent->symbolRef));
+            for (auto ident = varIdent; ident != nullptr; ident = ident->next.get())
+            {
+                key += '.';
+                key += ident->ident;
+                for (const auto& arrayIndex : ident->arrayIndices)
+                {
+                    key += '[';
+                    AppendExprKey(arrayIndex.get(), key);
+                    key += ']';
+                }
+            }
+        }
+        break;
+
+        case AST::Types::BracketExpr:
+        {
+            AppendExprKey(static_cast<const BracketExpr*>(expr)->expr.get(), key);
+        }
+        break;
+
+        case AST::Types::CastExpr:
+        {
+            auto castExpr = static_cast<const CastExpr*>(expr);
+            key += "cast<" + castExpr->typeExpr->typeDenoter->ToString() + ">(";
+            AppendExprKey(castExpr->expr.get(), key);
+            key += ')';
+        }
+        break;
+
+        case AST::Types::UnaryExpr:
+        {
+            auto unaryExpr = static_cast<const UnaryExpr*>(expr);
+            key += '(';
+            key += UnaryOpToString(unaryExpr->op);
+            AppendExprKey(unaryExpr->expr.get(), key);
+            key += ')';
+        }
+        break;
+
+        case AST::Types::BinaryExpr:
+        {
+            auto binaryExpr = static_cast<const BinaryExpr*>(expr);
+            key += '(';
+            AppendExprKey(binaryExpr->lhsExpr.get(), key);
+            key += BinaryOpToString(binaryExpr->op);
+            AppendExprKey(binaryExpr->rhsExpr.get(), key);
+            key += ')';
+        }
+        break;
+
+        case AST::Types::TernaryExpr:
+        {
+            auto ternaryExpr = static_cast<const TernaryExpr*>(expr);
+            key += '(';
+            AppendExprKey(ternaryExpr->condExpr.get(), key);
+            key += '?';
+            AppendExprKey(ternaryExpr->thenExpr.get(), key);
+            key += ':';
+            AppendExprKey(ternaryExpr->elseExpr.get(), key);
+            key += ')';
+        }
+        break;
+
+        case AST::Types::FunctionCallExpr:
+        {
+            auto call = static_cast<const FunctionCallExpr*>(expr)->call.get();
+            key += 'C';
+            key += std::to_string(static_cast<int>(call->intrinsic));
+            key += '(';
+            for (const auto& arg : call->arguments)
+            {
+                AppendExprKey(arg.get(), key);
+                key += ',';
+            }
+            key += ')';
+        }
+        break;
+
+        default:
+        break;
+    }
+}
+
+
+/*
+ * Internal helper functions for mul-chain reassociation
+ */
+
+// Operand of a 'mul' intrinsic chain with its decorated dimensions (a vector counts as 1xN or Nx1 matrix, depending on its side).
+struct MulChainOperand
+{
+    ExprPtr     expr;
+    std::size_t rows = 0;
+    std::size_t cols = 0;
+};
+
+// Returns the 'mul' intrinsic call of the specified expression (brackets are looked through), or null if it is not a binary 'mul' call.
+static FunctionCall* GetMulIntrinsicCall(Expr* expr)
+{
+    while (expr != nullptr && expr->Type() == AST::Types::BracketExpr)
+        expr = static_cast<BracketExpr*>(expr)->expr.get();
+
+    if (expr != nullptr && expr->Type() == AST::Types::FunctionCallExpr)
+    {
+        auto call = static_cast<FunctionCallExpr*>(expr)->call.get();
+        if (call != nullptr && call->intrinsic == Intrinsic::Mul && call->arguments.size() == 2)
+            return call;
+    }
+
+    return nullptr;
+}
+
+// Flattens a chain of nested 'mul' intrinsic calls into its operands, in evaluation order.
+static void FlattenMulChain(const ExprPtr& expr, std::vector<MulChainOperand>& operands)
+{
+    if (auto call = GetMulIntrinsicCall(expr.get()))
+    {
+        FlattenMulChain(call->arguments[0], operands);
+        FlattenMulChain(call->arguments[1], operands);
+    }
+    else
+        operands.push_back({ expr, 0, 0 });
+}
+
+/*
+Derives the matrix dimensions of the flattened chain operands from their decorated types, and returns
+false if the chain is not a pure matrix product (a vector is only allowed as the first operand, as row
+vector, or as the last operand, as column vector; scalar operands scale component-wise and are rejected).
+*/
+static bool DeriveMulChainDims(std::vector<MulChainOperand>& operands)
+{
+    for (std::size_t i = 0; i < operands.size(); ++i)
+    {
+        auto& operand = operands[i];
+
+        DataType dataType = DataType::Undefined;
+        try
+        {
+            auto typeDen = operand.expr->GetTypeDenoter()->Get();
+            if (auto baseTypeDen = typeDen->As<BaseTypeDenoter>())
+                dataType = baseTypeDen->dataType;
+        }
+        catch (const std::exception&)
+        {
+            /* Undecorated operand -> the chain must not be reordered */
+            return false;
+        }
+
+        if (IsMatrixType(dataType))
+        {
+            auto dims = MatrixTypeDim(dataType);
+            operand.rows = static_cast<std::size_t>(dims.first);
+            operand.cols = static_cast<std::size_t>(dims.second);
+        }
+        else if (IsVectorType(dataType) && i == 0)
+        {
+            /* Leading vector multiplies as row vector */
+            operand.rows = 1;
+            operand.cols = static_cast<std::size_t>(VectorTypeDim(dataType));
+        }
+        else if (IsVectorType(dataType) && i + 1 == operands.size())
+        {
+            /* Trailing vector multiplies as column vector */
+            operand.rows = static_cast<std::size_t>(VectorTypeDim(dataType));
+            operand.cols = 1;
+        }
+        else
+            return false;
+    }
+
+    /* The inner dimensions must agree (they do in a decorated program, unless a 'mul' overload was misjudged) */
+    for (std::size_t i = 0; i + 1 < operands.size(); ++i)
+    {
+        if (operands[i].cols != operands[i + 1].rows)
+            return false;
+    }
+
+    return true;
+}
+
+/*
+Accumulates the scalar multiplication count of the written association by walking the 'mul' tree
+(a product of an MxN by an NxP operand costs M*N*P multiplications); returns the operand index
+behind the sub-tree, and yields the dimensions of its product.
+*/
+static std::size_t AccumulateMulTreeCost(
+    const ExprPtr& expr, const std::vector<MulChainOperand>& operands, std::size_t index,
+    std::size_t& rows, std::size_t& cols, std::size_t& cost)
+{
+    if (auto call = GetMulIntrinsicCall(expr.get()))
+    {
+        std::size_t lhsRows = 0, lhsCols = 0, rhsRows = 0, rhsCols = 0;
+
+        index = AccumulateMulTreeCost(call->arguments[0], operands, index, lhsRows, lhsCols, cost);
+        index = AccumulateMulTreeCost(call->arguments[1], operands, index, rhsRows, rhsCols, cost);
+
+        cost += lhsRows * lhsCols * rhsCols;
+        rows = lhsRows;
+        cols = rhsCols;
+    }
+    else
+    {
+        rows = operands[index].rows;
+        cols = operands[index].cols;
+        ++index;
+    }
+
+    return index;
+}
+
+// Rebuilds the operand range [first, last] as nested 'mul' intrinsic calls along the optimal split points.
+static ExprPtr BuildMulTree(
+    const std::vector<MulChainOperand>& operands, const std::vector<std::vector<std::size_t>>& splits,
+    std::size_t first, std::size_t last, const SourceArea& area)
+{
+    if (first == last)
+        return operands[first].expr;
+
+    auto split = splits[first][last];
+
+    auto callExpr = ASTFactory::MakeIntrinsicCallExpr(
+        Intrinsic::Mul, "mul", nullptr,
+        {
+            BuildMulTree(operands, splits, first, split, area),
+            BuildMulTree(operands, splits, split + 1, last, area),
+        }
+    );
+    callExpr->area       = area;
+    callExpr->call->area = area;
+
+    return callExpr;
+}
+
+
+/*
+ * Internal helper functions for loop unrolling
+ */
+
+// Maximum number of statements an unrolled loop may expand to (without the 'unroll' attribute).
+static const std::size_t maxAutoUnrollStmnts = 64;
+
+// Maximum number of statements an unrolled loop may expand to with the 'unroll' attribute.
+static const std::size_t maxAttribUnrollStmnts = 2048;
+
+// Maximum number of loop iterations that are evaluated before the unrolling is abandoned.
+static const std::size_t maxUnrollIterations = 1024;
+
+// Returns true if the specified expression is a plain read access to the specified variable (i.e. no members, array indices, or assignment).
+static bool IsPlainVarAccess(const Expr* expr, const VarDecl* varDecl)
+{
+    if (expr && expr->Type() == AST::Types::VarAccessExpr)
+    {
+        auto varAccessExpr = static_cast<const VarAccessExpr*>(expr);
+        auto varIdent = varAccessExpr->varIdent.get();
+        return
+        (
+            varAccessExpr->assignOp == AssignOp::Undefined &&
+            varIdent != nullptr && varIdent->next == nullptr &&
+            varIdent->arrayIndices.empty() && varIdent->symbolRef == varDecl
+        );
+    }
+    return false;
+}
+
+// Returns the number of statements of the specified statement (with recursion), as a measure for the unrolling size budget.
+static std::size_t CountStmnts(const Stmnt* stmnt)
+{
+    if (!stmnt)
+        return 0;
+
+    std::size_t n = 1;
+
+    switch (stmnt->Type())
+    {
+        case AST::Types::CodeBlockStmnt:
+        {
+            for (const auto& subStmnt : static_cast<const CodeBlockStmnt*>(stmnt)->codeBlock->stmnts)
+                n += CountStmnts(subStmnt.get());
+        }
+        break;
+
+        case AST::Types::ForLoopStmnt:
+        {
+            auto forLoopStmnt = static_cast<const ForLoopStmnt*>(stmnt);
+            n += CountStmnts(forLoopStmnt->initSmnt.get());
+            n += CountStmnts(forLoopStmnt->bodyStmnt.get());
+        }
+        break;
+
+        case AST::Types::WhileLoopStmnt:
+        {
+            n += CountStmnts(static_cast<const WhileLoopStmnt*>(stmnt)->bodyStmnt.get());
+        }
+        break;
+
+        case AST::Types::DoWhileLoopStmnt:
+        {
+            n += CountStmnts(static_cast<const DoWhileLoopStmnt*>(stmnt)->bodyStmnt.get());
+        }
+        break;
+
+        case AST::Types::IfStmnt:
+        {
+            auto ifStmnt = static_cast<const IfStmnt*>(stmnt);
+            n += CountStmnts(ifStmnt->bodyStmnt.get());
+            n += CountStmnts(ifStmnt->elseStmnt.get());
+        }
+        break;
+
+        case AST::Types::ElseStmnt:
+        {
+            n += CountStmnts(static_cast<const ElseStmnt*>(stmnt)->bodyStmnt.get());
+        }
+        break;
+
+        case AST::Types::SwitchStmnt:
+        {
+            for (const auto& switchCase : static_cast<const SwitchStmnt*>(stmnt)->cases)
+            {
+                for (const auto& subStmnt : switchCase->stmnts)
+                    n += CountStmnts(subStmnt.get());
+            }
+        }
+        break;
+
+        default:
+        break;
+    }
+
+    return n;
+}
+
+// Returns true if the specified loop body contains a 'break' or 'continue' that refers to the enclosing loop
+// (control transfers inside nested loops, and 'break' inside nested 'switch'-statements, refer to the inner statement).
+static bool HasLoopCtrlTransfer(const Stmnt* stmnt, bool insideSwitch)
+{
+    if (!stmnt)
+        return false;
+
+    switch (stmnt->Type())
+    {
+        case AST::Types::CtrlTransferStmnt:
+        {
+            auto transfer = static_cast<const CtrlTransferStmnt*>(stmnt)->transfer;
+            return (transfer == CtrlTransfer::Continue || (transfer == CtrlTransfer::Break && !insideSwitch));
+        }
+
+        case AST::Types::CodeBlockStmnt:
+        {
+            for (const auto& subStmnt : static_cast<const CodeBlockStmnt*>(stmnt)->codeBlock->stmnts)
+            {
+                if (HasLoopCtrlTransfer(subStmnt.get(), insideSwitch))
+                    return true;
+            }
+            return false;
+        }
+
+        case AST::Types::IfStmnt:
+        {
+            auto ifStmnt = static_cast<const IfStmnt*>(stmnt);
+            return
+            (
+                HasLoopCtrlTransfer(ifStmnt->bodyStmnt.get(), insideSwitch) ||
+                HasLoopCtrlTransfer(ifStmnt->elseStmnt.get(), insideSwitch)
+            );
+        }
+
+        case AST::Types::ElseStmnt:
+        {
+            return HasLoopCtrlTransfer(static_cast<const ElseStmnt*>(stmnt)->bodyStmnt.get(), insideSwitch);
+        }
+
+        case AST::Types::SwitchStmnt:
+        {
+            for (const auto& switchCase : static_cast<const SwitchStmnt*>(stmnt)->cases)
+            {
+                for (const auto& subStmnt : switchCase->stmnts)
+                {
+                    if (HasLoopCtrlTransfer(subStmnt.get(), true))
+                        return true;
+                }
+            }
+            return false;
+        }
+
+        default:
+        {
+            /* Control transfers inside nested loops refer to the inner loop */
+            return false;
+        }
+    }
+}
+
+/*
+Creates per-iteration deep copies of a loop body, where plain read accesses to the induction
+variable are replaced by the literal value of the current iteration. Variables declared inside
+the body are cloned as well, and all references to them are remapped to the cloned declarations,
+so each unrolled iteration declares its own locals.
+*/
+class LoopBodyCloner
+{
+
+    public:
+
+        LoopBodyCloner(const VarDecl* inductionVar, const DataType literalType) :
+            inductionVar_   { inductionVar },
+            literalType_    { literalType  }
+        {
+        }
+
+        // Returns a deep copy of the loop body for the specified iteration value, or null if the body contains an unsupported AST node.
+        StmntPtr CloneForIteration(const Stmnt& bodyStmnt, const Variant& value)
+        {
+            try
+            {
+                value_ = value;
+                varDeclMap_.clear();
+                return CloneStmnt(&bodyStmnt);
+            }
+            catch (const std::exception&)
+            {
+                /* Loop body can not be cloned */
+                return nullptr;
+            }
+        }
+
+    private:
+
+        template <typename T>
+        std::shared_ptr<T> MakeClone(const T* src)
+        {
+            auto clone = std::make_shared<T>(src->area);
+            clone->flags = src->flags;
+            return clone;
+        }
+
+        // Makes a literal expression with the iteration value of the induction variable.
+        ExprPtr MakeIterationValueExpr(const SourceArea& area)
+        {
+            auto literalExpr = ASTFactory::MakeLiteralExpr(DataType::Int, value_.ToString());
+            literalExpr->ConvertDataType(literalType_);
+            literalExpr->area = area;
+            return literalExpr;
+        }
+
+        StmntPtr CloneStmnt(const Stmnt* stmnt)
+        {
+            if (!stmnt)
+                return nullptr;
+
+            StmntPtr clone;
+
+            switch (stmnt->Type())
+            {
+                case AST::Types::NullStmnt:
+                {
+                    clone = MakeClone(static_cast<const NullStmnt*>(stmnt));
+                }
+                break;
+
+                case AST::Types::CodeBlockStmnt:
+                {
+                    auto src = static_cast<const CodeBlockStmnt*>(stmnt);
+                    auto ast = MakeClone(src);
+                    ast->codeBlock = CloneCodeBlock(src->codeBlock.get());
+                    clone = ast;
+                }
+                break;
+
+                case AST::Types::ForLoopStmnt:
+                {
+                    auto src = static_cast<const ForLoopStmnt*>(stmnt);
+                    auto ast = MakeClone(src);
+                    ast->attribs    = CloneAttribs(src->attribs);
+                    ast->initSmnt   = CloneStmnt(src->initSmnt.get());
+                    ast->condition  = CloneExpr(src->condition.get());
+                    ast->iteration  = CloneExpr(src->iteration.get());
+                    ast->bodyStmnt  = CloneStmnt(src->bodyStmnt.get());
+                    clone = ast;
+                }
+                break;
+
+                case AST::Types::WhileLoopStmnt:
+                {
+                    auto src = static_cast<const WhileLoopStmnt*>(stmnt);
+                    auto ast = MakeClone(src);
+                    ast->attribs    = CloneAttribs(src->attribs);
+                    ast->condition  = CloneExpr(src->condition.get());
+                    ast->bodyStmnt  = CloneStmnt(src->bodyStmnt.get());
+                    clone = ast;
+                }
+                break;
+
+                case AST::Types::DoWhileLoopStmnt:
+                {
+                    auto src = static_cast<const DoWhileLoopStmnt*>(stmnt);
+                    auto ast = MakeClone(src);
+                    ast->attribs    = CloneAttribs(src->attribs);
+                    ast->bodyStmnt  = CloneStmnt(src->bodyStmnt.get());
+                    ast->condition  = CloneExpr(src->condition.get());
+                    clone = ast;
+                }
+                break;
+
+                case AST::Types::IfStmnt:
+                {
+                    auto src = static_cast<const IfStmnt*>(stmnt);
+                    auto ast = MakeClone(src);
+                    ast->attribs    = CloneAttribs(src->attribs);
+                    ast->condition  = CloneExpr(src->condition.get());
+                    ast->bodyStmnt  = CloneStmnt(src->bodyStmnt.get());
+                    ast->elseStmnt  = std::static_pointer_cast<ElseStmnt>(CloneStmnt(src->elseStmnt.get()));
+                    clone = ast;
+                }
+                break;
+
+                case AST::Types::ElseStmnt:
+                {
+                    auto src = static_cast<const ElseStmnt*>(stmnt);
+                    auto ast = MakeClone(src);
+                    ast->bodyStmnt = CloneStmnt(src->bodyStmnt.get());
+                    clone = ast;
+                }
+                break;
+
+                case AST::Types::SwitchStmnt:
+                {
+                    auto src = static_cast<const SwitchStmnt*>(stmnt);
+                    auto ast = MakeClone(src);
+                    ast->attribs    = CloneAttribs(src->attribs);
+                    ast->selector   = CloneExpr(src->selector.get());
+                    for (const auto& switchCase : src->cases)
+                    {
+                        auto caseClone = MakeClone(switchCase.get());
+                        caseClone->expr = CloneExpr(switchCase->expr.get());
+                        for (const auto& subStmnt : switchCase->stmnts)
+                            caseClone->stmnts.push_back(CloneStmnt(subStmnt.get()));
+                        ast->cases.push_back(caseClone);
+                    }
+                    clone = ast;
+                }
+                break;
+
+                case AST::Types::VarDeclStmnt:
+                {
+                    auto src = static_cast<const VarDeclStmnt*>(stmnt);
+                    auto ast = MakeClone(src);
+                    ast->inputModifier  = src->inputModifier;
+                    ast->storageClasses = src->storageClasses;
+                    ast->typeModifiers  = src->typeModifiers;
+                    ast->varType        = CloneVarType(src->varType.get());
+                    for (const auto& varDecl : src->varDecls)
+                    {
+                        auto varDeclClone = CloneVarDecl(varDecl.get());
+                        varDeclClone->declStmntRef = ast.get();
+                        ast->varDecls.push_back(varDeclClone);
+                    }
+                    clone = ast;
+                }
+                break;
+
+                case AST::Types::ExprStmnt:
+                {
+                    auto src = static_cast<const ExprStmnt*>(stmnt);
+                    auto ast = MakeClone(src);
+                    ast->expr = CloneExpr(src->expr.get());
+                    clone = ast;
+                }
+                break;
+
+                case AST::Types::ReturnStmnt:
+                {
+                    auto src = static_cast<const ReturnStmnt*>(stmnt);
+                    auto ast = MakeClone(src);
+                    ast->expr = CloneExpr(src->expr.get());
+                    clone = ast;
+                }
+                break;
+
+                case AST::Types::CtrlTransferStmnt:
+                {
+                    auto src = static_cast<const CtrlTransferStmnt*>(stmnt);
+                    auto ast = MakeClone(src);
+                    ast->transfer = src->transfer;
+                    clone = ast;
+                }
+                break;
+
+                default:
+                {
+                    /* Local type, texture, or sampler declarations are not cloned (they must remain unique) */
+                    throw std::runtime_error("unsupported statement in loop body");
+                }
+            }
+
+            clone->comment = stmnt->comment;
+
+            return clone;
+        }
+
+        ExprPtr CloneExpr(const Expr* expr)
+        {
+            if (!expr)
+                return nullptr;
+
+            /* Substitute plain read accesses to the induction variable by the current iteration value */
+            if (IsPlainVarAccess(expr, inductionVar_))
+                return MakeIterationValueExpr(expr->area);
+
+            switch (expr->Type())
+            {
+                case AST::Types::NullExpr:
+                {
+                    return MakeClone(static_cast<const NullExpr*>(expr));
+                }
+
+                case AST::Types::ListExpr:
+                {
+                    auto src = static_cast<const ListExpr*>(expr);
+                    auto ast = MakeClone(src);
+                    ast->firstExpr  = CloneExpr(src->firstExpr.get());
+                    ast->nextExpr   = CloneExpr(src->nextExpr.get());
+                    return ast;
+                }
+
+                case AST::Types::LiteralExpr:
+                {
+                    auto src = static_cast<const LiteralExpr*>(expr);
+                    auto ast = MakeClone(src);
+                    ast->dataType   = src->dataType;
+                    ast->value      = src->value;
+                    return ast;
+                }
+
+                case AST::Types::TypeNameExpr:
+                {
+                    auto src = static_cast<const TypeNameExpr*>(expr);
+                    auto ast = MakeClone(src);
+                    ast->typeDenoter = src->typeDenoter;
+                    return ast;
+                }
+
+                case AST::Types::TernaryExpr:
+                {
+                    auto src = static_cast<const TernaryExpr*>(expr);
+                    auto ast = MakeClone(src);
+                    ast->condExpr   = CloneExpr(src->condExpr.get());
+                    ast->thenExpr   = CloneExpr(src->thenExpr.get());
+                    ast->elseExpr   = CloneExpr(src->elseExpr.get());
+                    return ast;
+                }
+
+                case AST::Types::BinaryExpr:
+                {
+                    auto src = static_cast<const BinaryExpr*>(expr);
+                    auto ast = MakeClone(src);
+                    ast->lhsExpr    = CloneExpr(src->lhsExpr.get());
+                    ast->op         = src->op;
+                    ast->rhsExpr    = CloneExpr(src->rhsExpr.get());
+                    return ast;
+                }
+
+                case AST::Types::UnaryExpr:
+                {
+                    auto src = static_cast<const UnaryExpr*>(expr);
+                    auto ast = MakeClone(src);
+                    ast->op     = src->op;
+                    ast->expr   = CloneExpr(src->expr.get());
+                    return ast;
+                }
+
+                case AST::Types::PostUnaryExpr:
+                {
+                    auto src = static_cast<const PostUnaryExpr*>(expr);
+                    auto ast = MakeClone(src);
+                    ast->expr   = CloneExpr(src->expr.get());
+                    ast->op     = src->op;
+                    return ast;
+                }
+
+                case AST::Types::FunctionCallExpr:
+                {
+                    auto src = static_cast<const FunctionCallExpr*>(expr);
+                    auto ast = MakeClone(src);
+                    ast->call = CloneFunctionCall(src->call.get());
+                    return ast;
+                }
+
+                case AST::Types::BracketExpr:
+                {
+                    auto src = static_cast<const BracketExpr*>(expr);
+                    auto ast = MakeClone(src);
+                    ast->expr = CloneExpr(src->expr.get());
+                    return ast;
+                }
+
+                case AST::Types::SuffixExpr:
+                {
+                    auto src = static_cast<const SuffixExpr*>(expr);
+                    auto ast = MakeClone(src);
+                    ast->expr       = CloneExpr(src->expr.get());
+                    ast->varIdent   = CloneVarIdent(src->varIdent.get());
+                    return ast;
+                }
+
+                case AST::Types::ArrayAccessExpr:
+                {
+                    auto src = static_cast<const ArrayAccessExpr*>(expr);
+                    auto ast = MakeClone(src);
+                    ast->expr = CloneExpr(src->expr.get());
+                    for (const auto& arrayIndex : src->arrayIndices)
+                        ast->arrayIndices.push_back(CloneExpr(arrayIndex.get()));
+                    return ast;
+                }
+
+                case AST::Types::CastExpr:
+                {
+                    auto src = static_cast<const CastExpr*>(expr);
+                    auto ast = MakeClone(src);
+                    ast->typeExpr   = std::static_pointer_cast<TypeNameExpr>(CloneExpr(src->typeExpr.get()));
+                    ast->expr       = CloneExpr(src->expr.get());
+                    return ast;
+                }
+
+                case AST::Types::VarAccessExpr:
+                {
+                    auto src = static_cast<const VarAccessExpr*>(expr);
+                    auto ast = MakeClone(src);
+                    ast->varIdent   = CloneVarIdent(src->varIdent.get());
+                    ast->assignOp   = src->assignOp;
+                    ast->assignExpr = CloneExpr(src->assignExpr.get());
+                    return ast;
+                }
+
+                case AST::Types::InitializerExpr:
+                {
+                    auto src = static_cast<const InitializerExpr*>(expr);
+                    auto ast = MakeClone(src);
+                    for (const auto& subExpr : src->exprs)
+                        ast->exprs.push_back(CloneExpr(subExpr.get()));
+                    return ast;
+                }
+
+                case AST::Types::LiteralBlobExpr:
+                {
+                    auto src = static_cast<const LiteralBlobExpr*>(expr);
+                    auto ast = MakeClone(src);
+                    ast->dataType       = src->dataType;
+                    ast->values         = src->values;
+                    ast->numElements    = src->numElements;
+                    return ast;
+                }
+
+                default:
+                {
+                    throw std::runtime_error("unsupported expression in loop body");
+                }
+            }
+        }
+
+        CodeBlockPtr CloneCodeBlock(const CodeBlock* codeBlock)
+        {
+            auto ast = MakeClone(codeBlock);
+            for (const auto& subStmnt : codeBlock->stmnts)
+                ast->stmnts.push_back(CloneStmnt(subStmnt.get()));
+            return ast;
+        }
+
+        VarIdentPtr CloneVarIdent(const VarIdent* varIdent)
+        {
+            if (!varIdent)
+                return nullptr;
+
+            /* All plain read accesses were already substituted, so any remaining reference to the induction variable is unsupported */
+            if (varIdent->symbolRef == inductionVar_)
+                throw std::runtime_error("unsupported access to loop induction variable");
+
+            auto ast = MakeClone(varIdent);
+            ast->ident = varIdent->ident;
+            for (const auto& arrayIndex : varIdent->arrayIndices)
+                ast->arrayIndices.push_back(CloneExpr(arrayIndex.get()));
+            ast->next = CloneVarIdent(varIdent->next.get());
+
+            /* Remap references to variables that were declared (and thus cloned) inside the loop body */
+            auto it = varDeclMap_.find(varIdent->symbolRef);
+            ast->symbolRef = (it != varDeclMap_.end() ? it->second : varIdent->symbolRef);
+
+            return ast;
+        }
+
+        VarDeclPtr CloneVarDecl(const VarDecl* varDecl)
+        {
+            auto ast = MakeClone(varDecl);
+
+            ast->ident = varDecl->ident;
+            for (const auto& arrayDim : varDecl->arrayDims)
+                ast->arrayDims.push_back(CloneExpr(arrayDim.get()));
+            ast->semantic       = varDecl->semantic;
+            ast->packOffset     = varDecl->packOffset;
+            ast->annotations    = varDecl->annotations;
+            ast->initializer    = CloneExpr(varDecl->initializer.get());
+            ast->bufferDeclRef  = varDecl->bufferDeclRef;
+
+            varDeclMap_[varDecl] = ast.get();
+
+            return ast;
+        }
+
+        VarTypePtr CloneVarType(const VarType* varType)
+        {
+            /* Anonymous structure declarations must remain unique and prevent the unrolling */
+            if (varType->structDecl)
+                throw std::runtime_error("unsupported type in loop body");
+
+            auto ast = MakeClone(varType);
+            ast->typeDenoter    = varType->typeDenoter;
+            ast->symbolRef      = varType->symbolRef;
+
+            return ast;
+        }
+
+        FunctionCallPtr CloneFunctionCall(const FunctionCall* call)
+        {
+            if (!call)
+                return nullptr;
+
+            auto ast = MakeClone(call);
+
+            ast->varIdent       = CloneVarIdent(call->varIdent.get());
+            ast->typeDenoter    = call->typeDenoter;
+            for (const auto& arg : call->arguments)
+                ast->arguments.push_back(CloneExpr(arg.get()));
+            ast->funcDeclRef    = call->funcDeclRef;
+            ast->intrinsic      = call->intrinsic;
+
+            return ast;
+        }
+
+        std::vector<AttributePtr> CloneAttribs(const std::vector<AttributePtr>& attribs)
+        {
+            std::vector<AttributePtr> clones;
+            clones.reserve(attribs.size());
+
+            for (const auto& attrib : attribs)
+            {
+                auto ast = MakeClone(attrib.get());
+                ast->ident = attrib->ident;
+                for (const auto& arg : attrib->arguments)
+                    ast->arguments.push_back(CloneExpr(arg.get()));
+                clones.push_back(ast);
+            }
+
+            return clones;
+        }
+
+        /* === Members === */
+
+        const VarDecl*                      inductionVar_   = nullptr;
+        DataType                            literalType_    = DataType::Int;
+        Variant                             value_;
+
+        // Maps variable declarations inside the loop body to their clones of the current iteration.
+        std::map<const AST*, VarDecl*>      varDeclMap_;
+
+};
+
+
 /*
  * ======= Private: =======
  */
 
+struct Optimizer::HoistContext
+{
+    std::set<const VarDecl*>        writtenVars;    // Variables that are written to (or declared) inside the loop.
+    std::map<std::string, VarDecl*> tempVars;       // Maps expression keys to hoisted temporary variables.
+    std::vector<StmntPtr>           hoistedStmnts;  // Declaration statements of the hoisted temporary variables.
+};
+
 void Optimizer::OptimizeStmntList(std::vector<StmntPtr>& stmnts)
 {
-    /* Remove null statements */
-    for (auto it = stmnts.begin(); it != stmnts.end();)
+    for (std::size_t i = 0; i < stmnts.size();)
+    {
+        /* Collapse 'if'-statements with constant condition */
+        CollapseStmnt(stmnts[i]);
+
+        /* Remove null statements */
+        if (!stmnts[i] || CanRemoveStmnt(*stmnts[i]))
+        {
+            stmnts.erase(stmnts.begin() + i);
+            continue;
+        }
+
+        /* Unroll 'for'-loops with a constant trip count */
+        auto stmntType = stmnts[i]->Type();
+        if (stmntType == AST::Types::ForLoopStmnt)
+        {
+            std::vector<StmntPtr> unrolledStmnts;
+            if (UnrollForLoop(static_cast<ForLoopStmnt&>(*stmnts[i]), unrolledStmnts))
+            {
+                /* Replace the loop by the statements of its iterations, and re-process them (e.g. collapse constant 'if'-statements) */
+                stmnts.erase(stmnts.begin() + i);
+                stmnts.insert(stmnts.begin() + i, unrolledStmnts.begin(), unrolledStmnts.end());
+                continue;
+            }
+        }
+
+        /* Hoist loop-invariant expressions into temporary variables in front of the loop */
+        if ( stmntType == AST::Types::ForLoopStmnt ||
+             stmntType == AST::Types::WhileLoopStmnt ||
+             stmntType == AST::Types::DoWhileLoopStmnt )
+        {
+            auto hoistedStmnts = HoistLoopInvariants(*stmnts[i]);
+            if (!hoistedStmnts.empty())
+            {
+                stmnts.insert(stmnts.begin() + i, hoistedStmnts.begin(), hoistedStmnts.end());
+                i += hoistedStmnts.size();
+            }
+        }
+
+        ++i;
+    }
+}
+
+void Optimizer::OptimizeExpr(ExprPtr& expr)
+{
+    if (!expr)
+        return;
+
+    /* Reorder 'mul' intrinsic chains before folding (the reordered chain may still fold to a constant) */
+    OptimizeMulChain(expr);
+
+    /* Only compound expressions must be folded (a lone literal is already in its final form) */
+    if (expr->Type() == AST::Types::LiteralExpr || expr->Type() == AST::Types::NullExpr)
+        return;
+
+    Variant value;
+    if (!TryEvaluateConstExpr(*expr, value))
+        return;
+
+    /* Vector constants are replaced by a type constructor with literal components */
+    if (value.Type() == Variant::Types::RealVec)
+    {
+        ReplaceByVectorConstructor(expr, value);
+        return;
+    }
+
+    /* Never fold non-finite real results (e.g. division by zero), since they have no literal representation */
+    if (value.Type() == Variant::Types::Real && !std::isfinite(value.Real()))
+        return;
+
+    /*
+    The evaluator unwraps casts transparently, so e.g. "(float4x4)0" or "(TestStruct)0" evaluates to the
+    scalar 0; only replace the expression when its decorated type actually is a scalar base type, since
+    GLSL has no implicit scalar-to-composite conversion.
+    */
+    DataType exprDataType = DataType::Undefined;
+    try
+    {
+        auto typeDen = expr->GetTypeDenoter()->Get();
+        if (auto baseTypeDen = typeDen->As<BaseTypeDenoter>())
+            exprDataType = baseTypeDen->dataType;
+        else
+            return;
+
+        if (!IsScalarType(exprDataType))
+            return;
+    }
+    catch (const std::exception&)
+    {
+        /* Undecorated expression (e.g. an array dimension) -> keep the natural type of the evaluated value */
+    }
+
+    /* Replace the expression by a literal with the evaluated value */
+    DataType dataType = DataType::Undefined;
+
+    switch (value.Type())
+    {
+        case Variant::Types::Bool:
+            dataType = DataType::Bool;
+            break;
+        case Variant::Types::Int:
+            dataType = DataType::Int;
+            break;
+        case Variant::Types::Real:
+            dataType = DataType::Double;
+            break;
+        case Variant::Types::RealVec:
+            break;
+    }
+
+    auto literalExpr = ASTFactory::MakeLiteralExpr(dataType, value.ToString());
+    literalExpr->area = expr->area;
+
+    /* Keep the scalar type of the original expression (e.g. a folded 'uint' expression remains 'uint') */
+    try
+    {
+        auto typeDen = expr->GetTypeDenoter()->Get();
+        if (auto baseTypeDen = typeDen->As<BaseTypeDenoter>())
+        {
+            /*
+            Never truncate a real value to an integral literal; the deduced type prefers the l.h.s. operand,
+            so an expression like "1 + 2.5" derives 'int' although its value is real
+            */
+            if ( IsScalarType(baseTypeDen->dataType) &&
+                 !( value.Type() == Variant::Types::Real && !IsRealType(baseTypeDen->dataType) ) )
+            {
+                literalExpr->ConvertDataType(baseTypeDen->dataType);
+            }
+        }
+    }
+    catch (const std::exception&)
+    {
+        /* Undecorated expression -> keep the natural type of the evaluated value */
+    }
+
+    expr = literalExpr;
+}
+
+void Optimizer::ReplaceByVectorConstructor(ExprPtr& expr, const Variant& value)
+{
+    /* Ignore expressions which are already plain type constructor calls with literal arguments */
+    if (auto funcCallExpr = expr->As<FunctionCallExpr>())
+    {
+        auto call = funcCallExpr->call.get();
+        if (call && call->typeDenoter)
+        {
+            auto allLiterals = std::all_of(
+                call->arguments.begin(), call->arguments.end(),
+                [](const ExprPtr& arg) { return (arg->Type() == AST::Types::LiteralExpr); }
+            );
+            if (allLiterals)
+                return;
+        }
+    }
+
+    /* The replacement requires the decorated vector type of the expression */
+    DataType dataType = DataType::Undefined;
+    try
+    {
+        auto typeDen = expr->GetTypeDenoter()->Get();
+        if (auto baseTypeDen = typeDen->As<BaseTypeDenoter>())
+            dataType = baseTypeDen->dataType;
+    }
+    catch (const std::exception&)
+    {
+        return;
+    }
+
+    /* Only replace vector types whose dimension matches the evaluated value (matrices keep their sub-expressions) */
+    if (!IsVectorType(dataType) || static_cast<std::size_t>(VectorTypeDim(dataType)) != value.VecSize())
+        return;
+
+    /* Never fold non-finite components (e.g. division by zero), since they have no literal representation */
+    for (std::size_t i = 0; i < value.VecSize(); ++i)
+    {
+        if (!std::isfinite(value.Vec()[i]))
+            return;
+    }
+
+    /* Make the literal components with the scalar type of the vector (e.g. 'int' literals for an 'int4' constructor) */
+    auto scalarType = BaseDataType(dataType);
+
+    std::vector<ExprPtr> arguments;
+    arguments.reserve(value.VecSize());
+
+    for (std::size_t i = 0; i < value.VecSize(); ++i)
+    {
+        auto literalExpr = ASTFactory::MakeLiteralExpr(DataType::Double, Variant(value.Vec()[i]).ToString());
+        literalExpr->ConvertDataType(scalarType);
+        literalExpr->area = expr->area;
+        arguments.push_back(literalExpr);
+    }
+
+    auto ctorExpr = ASTFactory::MakeTypeConstructorCallExpr(GetCanonicalBaseTypeDenoter(dataType), arguments);
+    ctorExpr->area = expr->area;
+
+    expr = ctorExpr;
+}
+
+void Optimizer::CollapseStmnt(StmntPtr& stmnt)
+{
+    /* Collapse 'if'-statements with constant condition (repeatedly, to also collapse constant 'else-if' chains) */
+    while (stmnt && stmnt->Type() == AST::Types::IfStmnt)
     {
-        if (CanRemoveStmnt(**it))
-            it = stmnts.erase(it);
+        auto ifStmnt = static_cast<IfStmnt*>(stmnt.get());
+
+        Variant condValue;
+        if (!TryEvaluateConstExpr(*ifStmnt->condition, condValue))
+            break;
+
+        if (condValue.ToBool())
+        {
+            /* Replace the 'if'-statement by its body (the 'else'-branch is dead code) */
+            auto bodyStmnt = ifStmnt->bodyStmnt;
+            stmnt = bodyStmnt;
+        }
+        else if (ifStmnt->elseStmnt)
+        {
+            /* Replace the 'if'-statement by its 'else'-branch (the body is dead code) */
+            auto elseBodyStmnt = ifStmnt->elseStmnt->bodyStmnt;
+            stmnt = elseBodyStmnt;
+        }
         else
-            ++it;
+        {
+            /* Remove the entire statement (the body is dead code and there is no 'else'-branch) */
+            stmnt.reset();
+        }
     }
 }
 
@@ -53,6 +1412,661 @@ bool Optimizer::CanRemoveStmnt(const Stmnt& ast) const
     return false;
 }
 
+bool Optimizer::TryEvaluateConstExpr(Expr& expr, Variant& result)
+{
+    /* Probe exception-free: almost all probed expressions are not constant, so a failure must not throw (see ConstExprEvaluator) */
+    ConstExprEvaluator exprEvaluator;
+    return exprEvaluator.TryEvaluateExpr(
+        expr, result,
+        [this](VarAccessExpr* ast, Variant& value)
+        {
+            return TryFetchConstVarValue(*ast, value);
+        }
+    );
+}
+
+bool Optimizer::TryFetchConstVarValue(VarAccessExpr& varAccessExpr, Variant& value)
+{
+    /* Only a plain read access can be propagated */
+    if (varAccessExpr.assignOp != AssignOp::Undefined)
+        return false;
+
+    auto varIdent = varAccessExpr.varIdent.get();
+    if (!varIdent || varIdent->next != nullptr || !varIdent->arrayIndices.empty())
+        return false;
+
+    /* Fetch variable declaration of a scalar 'static const' variable with an initializer */
+    auto symbolRef = varIdent->symbolRef;
+    if (!symbolRef || symbolRef->Type() != AST::Types::VarDecl)
+        return false;
+
+    auto varDecl = static_cast<VarDecl*>(symbolRef);
+    auto declStmnt = varDecl->declStmntRef;
+
+    if ( !varDecl->arrayDims.empty() || !varDecl->initializer || !declStmnt ||
+         std::find(declStmnt->storageClasses.begin(), declStmnt->storageClasses.end(), StorageClass::Static) == declStmnt->storageClasses.end() ||
+         std::find(declStmnt->typeModifiers.begin(), declStmnt->typeModifiers.end(), "const") == declStmnt->typeModifiers.end() )
+    {
+        return false;
+    }
+
+    /* Guard against cyclic initializers before the initializer is evaluated */
+    if (propagatedVarDecls_.find(varDecl) != propagatedVarDecls_.end())
+        return false;
+
+    /* Return memoized value, so the initializer is only evaluated for the first access */
+    auto it = constVarValues_.find(varDecl);
+    if (it != constVarValues_.end())
+    {
+        value = it->second;
+        return true;
+    }
+
+    propagatedVarDecls_.insert(varDecl);
+
+    auto isConst = TryEvaluateConstExpr(*varDecl->initializer, value);
+
+    propagatedVarDecls_.erase(varDecl);
+
+    if (!isConst)
+        return false;
+
+    constVarValues_[varDecl] = value;
+
+    return true;
+}
+
+/* ----- Mul-chain reassociation ----- */
+
+void Optimizer::OptimizeMulChain(ExprPtr& expr)
+{
+    /* Only chains of at least three operands have more than one association */
+    auto call = GetMulIntrinsicCall(expr.get());
+    if (!call || (!GetMulIntrinsicCall(call->arguments[0].get()) && !GetMulIntrinsicCall(call->arguments[1].get())))
+        return;
+
+    std::vector<MulChainOperand> operands;
+    FlattenMulChain(expr, operands);
+
+    if (operands.size() < 3 || !DeriveMulChainDims(operands))
+        return;
+
+    /* Compute the scalar multiplication count of the written association */
+    std::size_t rows = 0, cols = 0;
+    std::size_t writtenCost = 0;
+    AccumulateMulTreeCost(expr, operands, 0, rows, cols, writtenCost);
+
+    /* Find the cheapest association by the classic matrix-chain ordering (the chains are short, so the cubic time is negligible) */
+    const auto n = operands.size();
+
+    std::vector<std::vector<std::size_t>> costs(n, std::vector<std::size_t>(n, 0));
+    std::vector<std::vector<std::size_t>> splits(n, std::vector<std::size_t>(n, 0));
+
+    for (std::size_t len = 2; len <= n; ++len)
+    {
+        for (std::size_t i = 0; i + len <= n; ++i)
+        {
+            auto j = i + len - 1;
+            costs[i][j] = ~std::size_t(0);
+
+            for (auto k = i; k < j; ++k)
+            {
+                auto cost = costs[i][k] + costs[k + 1][j] + operands[i].rows * operands[k].cols * operands[j].cols;
+                if (cost < costs[i][j])
+                {
+                    costs[i][j]     = cost;
+                    splits[i][j]    = k;
+                }
+            }
+        }
+    }
+
+    /* Rebuild the chain only if the optimal association is strictly cheaper (reassociation changes rounding) */
+    if (costs[0][n - 1] < writtenCost)
+        expr = BuildMulTree(operands, splits, 0, n - 1, expr->area);
+}
+
+/* ----- Loop unrolling ----- */
+
+bool Optimizer::UnrollForLoop(ForLoopStmnt& ast, std::vector<StmntPtr>& unrolledStmnts)
+{
+    if (!ast.bodyStmnt)
+        return false;
+
+    /* Never unroll loops the shader author explicitly marked with the 'loop' attribute */
+    const Attribute* unrollAttrib = nullptr;
+
+    for (const auto& attrib : ast.attribs)
+    {
+        if (attrib->ident == "loop")
+            return false;
+        if (attrib->ident == "unroll")
+            unrollAttrib = attrib.get();
+    }
+
+    /* The loop must declare a single integral induction variable with a constant initializer */
+    if (!ast.initSmnt || ast.initSmnt->Type() != AST::Types::VarDeclStmnt)
+        return false;
+
+    auto declStmnt = static_cast<VarDeclStmnt*>(ast.initSmnt.get());
+    if (declStmnt->varDecls.size() != 1)
+        return false;
+
+    auto inductionVar = declStmnt->varDecls.front().get();
+    if (!inductionVar->arrayDims.empty() || !inductionVar->initializer)
+        return false;
+
+    DataType literalType = DataType::Int;
+    try
+    {
+        auto typeDen = inductionVar->GetTypeDenoter()->Get();
+        auto baseTypeDen = typeDen->As<BaseTypeDenoter>();
+        if ( !baseTypeDen || !IsScalarType(baseTypeDen->dataType) ||
+             !( IsIntType(baseTypeDen->dataType) || IsUIntType(baseTypeDen->dataType) ) )
+        {
+            return false;
+        }
+        literalType = baseTypeDen->dataType;
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+
+    /* The loop body must not write to the induction variable, and must not break or continue at this level */
+    LoopWriteCollector writeCollector;
+    auto writtenVars = writeCollector.CollectWrittenVars(*ast.bodyStmnt);
+    if (writtenVars.find(inductionVar) != writtenVars.end())
+        return false;
+
+    if (HasLoopCtrlTransfer(ast.bodyStmnt.get(), false))
+        return false;
+
+    /* Compute the value of the induction variable for each iteration */
+    std::vector<Variant> iterationValues;
+    if (!EvaluateLoopIterationValues(ast, inductionVar, iterationValues))
+        return false;
+
+    /* Respect the size budget: the 'unroll' attribute raises the limit, its optional argument caps the trip count */
+    auto maxStmnts = maxAutoUnrollStmnts;
+
+    if (unrollAttrib)
+    {
+        maxStmnts = maxAttribUnrollStmnts;
+        if (unrollAttrib->arguments.size() == 1)
+        {
+            Variant maxTrips;
+            if ( TryEvaluateConstExpr(*unrollAttrib->arguments.front(), maxTrips) &&
+                 maxTrips.Type() == Variant::Types::Int &&
+                 iterationValues.size() > static_cast<std::size_t>(std::max<Variant::IntType>(maxTrips.Int(), 0)) )
+            {
+                return false;
+            }
+        }
+    }
+
+    auto bodyStmnts = CountStmnts(ast.bodyStmnt.get());
+    if (iterationValues.size() * std::max<std::size_t>(bodyStmnts, 1u) > maxStmnts)
+        return false;
+
+    /* Clone the loop body for each iteration, with the induction variable substituted by its value */
+    LoopBodyCloner cloner(inductionVar, literalType);
+
+    std::vector<StmntPtr> stmnts;
+    stmnts.reserve(iterationValues.size());
+
+    for (const auto& value : iterationValues)
+    {
+        auto iterationStmnt = cloner.CloneForIteration(*ast.bodyStmnt, value);
+        if (!iterationStmnt)
+            return false;
+
+        /* Keep the variables of a single-statement declaration body in their own scope */
+        if (iterationStmnt->Type() == AST::Types::VarDeclStmnt)
+        {
+            auto codeBlockStmnt = std::make_shared<CodeBlockStmnt>(iterationStmnt->area);
+            codeBlockStmnt->codeBlock = std::make_shared<CodeBlock>(iterationStmnt->area);
+            codeBlockStmnt->codeBlock->stmnts.push_back(iterationStmnt);
+            iterationStmnt = codeBlockStmnt;
+        }
+
+        stmnts.push_back(iterationStmnt);
+    }
+
+    /* Fold the substituted iteration values in the cloned statements (e.g. constant array indices) */
+    for (const auto& stmnt : stmnts)
+        Visit(stmnt);
+
+    unrolledStmnts = std::move(stmnts);
+
+    return true;
+}
+
+bool Optimizer::EvaluateLoopIterationValues(ForLoopStmnt& ast, const VarDecl* inductionVar, std::vector<Variant>& values)
+{
+    /* An unbounded loop relies on 'break' to terminate and is never unrolled */
+    if (!ast.condition || !ast.iteration)
+        return false;
+
+    /* Evaluate the initial value of the induction variable */
+    Variant value;
+    if (!TryEvaluateConstExpr(*inductionVar->initializer, value) || value.Type() != Variant::Types::Int)
+        return false;
+
+    /* Simulate the loop until the condition fails (or the iteration limit is exceeded) */
+    while (values.size() <= maxUnrollIterations)
+    {
+        Variant condValue;
+        if (!TryEvaluateConstExprWithVar(*ast.condition, inductionVar, value, condValue) || condValue.Type() == Variant::Types::RealVec)
+            return false;
+
+        if (!condValue.ToBool())
+            return true;
+
+        values.push_back(value);
+
+        if (!ApplyLoopIteration(*ast.iteration, inductionVar, value) || value.Type() != Variant::Types::Int)
+            return false;
+    }
+
+    /* Trip count exceeds the iteration limit */
+    return false;
+}
+
+bool Optimizer::ApplyLoopIteration(Expr& iteration, const VarDecl* inductionVar, Variant& value)
+{
+    switch (iteration.Type())
+    {
+        case AST::Types::UnaryExpr:
+        {
+            auto& unaryExpr = static_cast<UnaryExpr&>(iteration);
+            if (IsPlainVarAccess(unaryExpr.expr.get(), inductionVar))
+            {
+                if (unaryExpr.op == UnaryOp::Inc)
+                {
+                    ++value;
+                    return true;
+                }
+                if (unaryExpr.op == UnaryOp::Dec)
+                {
+                    --value;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        case AST::Types::PostUnaryExpr:
+        {
+            auto& postUnaryExpr = static_cast<PostUnaryExpr&>(iteration);
+            if (IsPlainVarAccess(postUnaryExpr.expr.get(), inductionVar))
+            {
+                if (postUnaryExpr.op == UnaryOp::Inc)
+                {
+                    ++value;
+                    return true;
+                }
+                if (postUnaryExpr.op == UnaryOp::Dec)
+                {
+                    --value;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        case AST::Types::VarAccessExpr:
+        {
+            /* Assignment to the induction variable (e.g. "i += 2"), where the r.h.s. may refer to the current value */
+            auto& varAccessExpr = static_cast<VarAccessExpr&>(iteration);
+            auto varIdent = varAccessExpr.varIdent.get();
+
+            if ( varAccessExpr.assignOp == AssignOp::Undefined || !varAccessExpr.assignExpr ||
+                 !varIdent || varIdent->next != nullptr || !varIdent->arrayIndices.empty() ||
+                 varIdent->symbolRef != inductionVar )
+            {
+                return false;
+            }
+
+            Variant rhsValue;
+            if (!TryEvaluateConstExprWithVar(*varAccessExpr.assignExpr, inductionVar, value, rhsValue) || rhsValue.Type() == Variant::Types::RealVec)
+                return false;
+
+            try
+            {
+                switch (varAccessExpr.assignOp)
+                {
+                    case AssignOp::Set:
+                        value = rhsValue;
+                        break;
+                    case AssignOp::Add:
+                        value += rhsValue;
+                        break;
+                    case AssignOp::Sub:
+                        value -= rhsValue;
+                        break;
+                    case AssignOp::Mul:
+                        value *= rhsValue;
+                        break;
+                    case AssignOp::Div:
+                        value /= rhsValue;
+                        break;
+                    case AssignOp::Mod:
+                        value %= rhsValue;
+                        break;
+                    case AssignOp::LShift:
+                        value <<= rhsValue;
+                        break;
+                    case AssignOp::RShift:
+                        value >>= rhsValue;
+                        break;
+                    case AssignOp::Or:
+                        value |= rhsValue;
+                        break;
+                    case AssignOp::And:
+                        value &= rhsValue;
+                        break;
+                    case AssignOp::Xor:
+                        value ^= rhsValue;
+                        break;
+                    default:
+                        return false;
+                }
+            }
+            catch (const std::exception&)
+            {
+                return false;
+            }
+
+            return true;
+        }
+
+        default:
+        {
+            return false;
+        }
+    }
+}
+
+bool Optimizer::TryEvaluateConstExprWithVar(Expr& expr, const VarDecl* varDecl, const Variant& varValue, Variant& result)
+{
+    ConstExprEvaluator exprEvaluator;
+    return exprEvaluator.TryEvaluateExpr(
+        expr, result,
+        [&](VarAccessExpr* ast, Variant& value)
+        {
+            /* Substitute the current iteration value for the induction variable */
+            if (IsPlainVarAccess(ast, varDecl))
+            {
+                value = varValue;
+                return true;
+            }
+            return TryFetchConstVarValue(*ast, value);
+        }
+    );
+}
+
+/* ----- Loop-invariant extraction ----- */
+
+std::vector<StmntPtr> Optimizer::HoistLoopInvariants(Stmnt& loopStmnt)
+{
+    HoistContext context;
+
+    /* Collect all variables the loop writes to (hoistable expressions must not depend on them) */
+    LoopWriteCollector writeCollector;
+    context.writtenVars = writeCollector.CollectWrittenVars(loopStmnt);
+
+    /* Move all invariant expressions into temporary variables in front of the loop */
+    HoistScanStmnt(&loopStmnt, context);
+
+    return std::move(context.hoistedStmnts);
+}
+
+void Optimizer::HoistScanStmnt(Stmnt* stmnt, HoistContext& context)
+{
+    if (!stmnt)
+        return;
+
+    switch (stmnt->Type())
+    {
+        case AST::Types::CodeBlockStmnt:
+        {
+            for (auto& subStmnt : static_cast<CodeBlockStmnt*>(stmnt)->codeBlock->stmnts)
+                HoistScanStmnt(subStmnt.get(), context);
+        }
+        break;
+
+        case AST::Types::ForLoopStmnt:
+        {
+            auto forLoopStmnt = static_cast<ForLoopStmnt*>(stmnt);
+            HoistScanStmnt(forLoopStmnt->initSmnt.get(), context);
+            HoistScanExpr(forLoopStmnt->condition, context);
+            HoistScanExpr(forLoopStmnt->iteration, context);
+            HoistScanStmnt(forLoopStmnt->bodyStmnt.get(), context);
+        }
+        break;
+
+        case AST::Types::WhileLoopStmnt:
+        {
+            auto whileLoopStmnt = static_cast<WhileLoopStmnt*>(stmnt);
+            HoistScanExpr(whileLoopStmnt->condition, context);
+            HoistScanStmnt(whileLoopStmnt->bodyStmnt.get(), context);
+        }
+        break;
+
+        case AST::Types::DoWhileLoopStmnt:
+        {
+            auto doWhileLoopStmnt = static_cast<DoWhileLoopStmnt*>(stmnt);
+            HoistScanStmnt(doWhileLoopStmnt->bodyStmnt.get(), context);
+            HoistScanExpr(doWhileLoopStmnt->condition, context);
+        }
+        break;
+
+        case AST::Types::IfStmnt:
+        {
+            auto ifStmnt = static_cast<IfStmnt*>(stmnt);
+            HoistScanExpr(ifStmnt->condition, context);
+            HoistScanStmnt(ifStmnt->bodyStmnt.get(), context);
+            HoistScanStmnt(ifStmnt->elseStmnt.get(), context);
+        }
+        break;
+
+        case AST::Types::ElseStmnt:
+        {
+            HoistScanStmnt(static_cast<ElseStmnt*>(stmnt)->bodyStmnt.get(), context);
+        }
+        break;
+
+        case AST::Types::SwitchStmnt:
+        {
+            auto switchStmnt = static_cast<SwitchStmnt*>(stmnt);
+            HoistScanExpr(switchStmnt->selector, context);
+            for (auto& switchCase : switchStmnt->cases)
+            {
+                for (auto& subStmnt : switchCase->stmnts)
+                    HoistScanStmnt(subStmnt.get(), context);
+            }
+        }
+        break;
+
+        case AST::Types::VarDeclStmnt:
+        {
+            for (auto& varDecl : static_cast<VarDeclStmnt*>(stmnt)->varDecls)
+                HoistScanExpr(varDecl->initializer, context);
+        }
+        break;
+
+        case AST::Types::ExprStmnt:
+        {
+            HoistScanExpr(static_cast<ExprStmnt*>(stmnt)->expr, context);
+        }
+        break;
+
+        case AST::Types::ReturnStmnt:
+        {
+            HoistScanExpr(static_cast<ReturnStmnt*>(stmnt)->expr, context);
+        }
+        break;
+
+        default:
+        break;
+    }
+}
+
+void Optimizer::HoistScanExpr(ExprPtr& expr, HoistContext& context)
+{
+    if (!expr)
+        return;
+
+    /* Hoist invariant compound expressions with a base type (scalars, vectors, and matrices) */
+    if ( ( expr->Type() == AST::Types::BinaryExpr || expr->Type() == AST::Types::FunctionCallExpr ) &&
+         IsInvariantExpr(expr.get(), context.writtenVars) )
+    {
+        DataType dataType = DataType::Undefined;
+        try
+        {
+            auto typeDen = expr->GetTypeDenoter()->Get();
+            if (auto baseTypeDen = typeDen->As<BaseTypeDenoter>())
+                dataType = baseTypeDen->dataType;
+        }
+        catch (const std::exception&)
+        {
+            /* Undecorated expression -> must not be hoisted */
+        }
+
+        if (dataType != DataType::Undefined && dataType != DataType::String)
+        {
+            /* Fetch the temporary variable for this expression (identical expressions share a single temporary) */
+            std::string key;
+            AppendExprKey(expr.get(), key);
+
+            VarDecl* tempVarDecl = nullptr;
+
+            auto it = context.tempVars.find(key);
+            if (it != context.tempVars.end())
+                tempVarDecl = it->second;
+            else
+            {
+                /* Declare a new temporary variable that is initialized with the hoisted expression */
+                auto declStmnt = ASTFactory::MakeVarDeclStmnt(dataType, nameManglingPrefix_ + "cse" + std::to_string(numHoistedVars_++));
+                {
+                    declStmnt->typeModifiers.push_back("const");
+                    declStmnt->varDecls.front()->initializer = expr;
+                }
+                tempVarDecl = declStmnt->varDecls.front().get();
+
+                context.hoistedStmnts.push_back(declStmnt);
+                context.tempVars[key] = tempVarDecl;
+            }
+
+            /* Replace the expression by an access to the temporary variable */
+            auto varAccessExpr = ASTFactory::MakeVarAccessExpr(tempVarDecl->ident, tempVarDecl);
+            varAccessExpr->area = expr->area;
+
+            expr = varAccessExpr;
+            return;
+        }
+    }
+
+    /* Continue the search in the sub expressions */
+    switch (expr->Type())
+    {
+        case AST::Types::ListExpr:
+        {
+            auto listExpr = static_cast<ListExpr*>(expr.get());
+            HoistScanExpr(listExpr->firstExpr, context);
+            HoistScanExpr(listExpr->nextExpr, context);
+        }
+        break;
+
+        case AST::Types::TernaryExpr:
+        {
+            auto ternaryExpr = static_cast<TernaryExpr*>(expr.get());
+            HoistScanExpr(ternaryExpr->condExpr, context);
+            HoistScanExpr(ternaryExpr->thenExpr, context);
+            HoistScanExpr(ternaryExpr->elseExpr, context);
+        }
+        break;
+
+        case AST::Types::BinaryExpr:
+        {
+            auto binaryExpr = static_cast<BinaryExpr*>(expr.get());
+            HoistScanExpr(binaryExpr->lhsExpr, context);
+            HoistScanExpr(binaryExpr->rhsExpr, context);
+        }
+        break;
+
+        case AST::Types::UnaryExpr:
+        {
+            /* Sub expressions of increment and decrement operators are l-values and must not be hoisted */
+            auto unaryExpr = static_cast<UnaryExpr*>(expr.get());
+            if (unaryExpr->op != UnaryOp::Inc && unaryExpr->op != UnaryOp::Dec)
+                HoistScanExpr(unaryExpr->expr, context);
+        }
+        break;
+
+        case AST::Types::FunctionCallExpr:
+        {
+            auto call = static_cast<FunctionCallExpr*>(expr.get())->call.get();
+            if (call)
+            {
+                for (auto& arg : call->arguments)
+                    HoistScanExpr(arg, context);
+            }
+        }
+        break;
+
+        case AST::Types::BracketExpr:
+        {
+            HoistScanExpr(static_cast<BracketExpr*>(expr.get())->expr, context);
+        }
+        break;
+
+        case AST::Types::SuffixExpr:
+        {
+            HoistScanExpr(static_cast<SuffixExpr*>(expr.get())->expr, context);
+        }
+        break;
+
+        case AST::Types::ArrayAccessExpr:
+        {
+            auto arrayAccessExpr = static_cast<ArrayAccessExpr*>(expr.get());
+            HoistScanExpr(arrayAccessExpr->expr, context);
+            for (auto& arrayIndex : arrayAccessExpr->arrayIndices)
+                HoistScanExpr(arrayIndex, context);
+        }
+        break;
+
+        case AST::Types::CastExpr:
+        {
+            HoistScanExpr(static_cast<CastExpr*>(expr.get())->expr, context);
+        }
+        break;
+
+        case AST::Types::VarAccessExpr:
+        {
+            auto varAccessExpr = static_cast<VarAccessExpr*>(expr.get());
+            for (auto varIdent = varAccessExpr->varIdent.get(); varIdent != nullptr; varIdent = varIdent->next.get())
+            {
+                for (auto& arrayIndex : varIdent->arrayIndices)
+                    HoistScanExpr(arrayIndex, context);
+            }
+            HoistScanExpr(varAccessExpr->assignExpr, context);
+        }
+        break;
+
+        case AST::Types::InitializerExpr:
+        {
+            for (auto& subExpr : static_cast<InitializerExpr*>(expr.get())->exprs)
+                HoistScanExpr(subExpr, context);
+        }
+        break;
+
+        default:
+        break;
+    }
+}
+
 /* ------- Visit functions ------- */
 
 #define IMPLEMENT_VISIT_PROC(AST_NAME) \
@@ -60,20 +2074,172 @@ bool Optimizer::CanRemoveStmnt(const Stmnt& ast) const
 
 IMPLEMENT_VISIT_PROC(CodeBlock)
 {
-    VISIT_DEFAULT(CodeBlock);
+    STATIC_VISIT_DEFAULT(CodeBlock);
 
     /* Optimize statement list */
     OptimizeStmntList(ast->stmnts);
 }
 
+IMPLEMENT_VISIT_PROC(FunctionCall)
+{
+    for (auto& arg : ast->arguments)
+        OptimizeExpr(arg);
+
+    STATIC_VISIT_DEFAULT(FunctionCall);
+}
+
 IMPLEMENT_VISIT_PROC(SwitchCase)
 {
-    VISIT_DEFAULT(SwitchCase);
+    STATIC_VISIT_DEFAULT(SwitchCase);
 
     /* Optimize statement list */
     OptimizeStmntList(ast->stmnts);
 }
 
+IMPLEMENT_VISIT_PROC(VarIdent)
+{
+    for (auto& arrayIndex : ast->arrayIndices)
+        OptimizeExpr(arrayIndex);
+
+    STATIC_VISIT_DEFAULT(VarIdent);
+}
+
+/* --- Declarations --- */
+
+IMPLEMENT_VISIT_PROC(VarDecl)
+{
+    for (auto& arrayDim : ast->arrayDims)
+        OptimizeExpr(arrayDim);
+
+    OptimizeExpr(ast->initializer);
+
+    STATIC_VISIT_DEFAULT(VarDecl);
+}
+
+/* --- Statements --- */
+
+IMPLEMENT_VISIT_PROC(ForLoopStmnt)
+{
+    OptimizeExpr(ast->condition);
+
+    STATIC_VISIT_DEFAULT(ForLoopStmnt);
+}
+
+IMPLEMENT_VISIT_PROC(WhileLoopStmnt)
+{
+    OptimizeExpr(ast->condition);
+
+    STATIC_VISIT_DEFAULT(WhileLoopStmnt);
+}
+
+IMPLEMENT_VISIT_PROC(DoWhileLoopStmnt)
+{
+    OptimizeExpr(ast->condition);
+
+    STATIC_VISIT_DEFAULT(DoWhileLoopStmnt);
+}
+
+IMPLEMENT_VISIT_PROC(IfStmnt)
+{
+    OptimizeExpr(ast->condition);
+
+    STATIC_VISIT_DEFAULT(IfStmnt);
+
+    /* Collapse a constant 'if'-statement in the 'else'-branch (statements in code blocks are collapsed in "OptimizeStmntList") */
+    if (ast->elseStmnt)
+    {
+        CollapseStmnt(ast->elseStmnt->bodyStmnt);
+        if (!ast->elseStmnt->bodyStmnt)
+            ast->elseStmnt.reset();
+    }
+}
+
+IMPLEMENT_VISIT_PROC(SwitchStmnt)
+{
+    OptimizeExpr(ast->selector);
+
+    STATIC_VISIT_DEFAULT(SwitchStmnt);
+}
+
+IMPLEMENT_VISIT_PROC(ExprStmnt)
+{
+    OptimizeExpr(ast->expr);
+
+    STATIC_VISIT_DEFAULT(ExprStmnt);
+}
+
+IMPLEMENT_VISIT_PROC(ReturnStmnt)
+{
+    OptimizeExpr(ast->expr);
+
+    STATIC_VISIT_DEFAULT(ReturnStmnt);
+}
+
+/* --- Expressions --- */
+
+IMPLEMENT_VISIT_PROC(TernaryExpr)
+{
+    OptimizeExpr(ast->condExpr);
+    OptimizeExpr(ast->thenExpr);
+    OptimizeExpr(ast->elseExpr);
+
+    STATIC_VISIT_DEFAULT(TernaryExpr);
+}
+
+IMPLEMENT_VISIT_PROC(BinaryExpr)
+{
+    OptimizeExpr(ast->lhsExpr);
+    OptimizeExpr(ast->rhsExpr);
+
+    STATIC_VISIT_DEFAULT(BinaryExpr);
+}
+
+IMPLEMENT_VISIT_PROC(UnaryExpr)
+{
+    /* Sub expressions of increment and decrement operators are l-values and must not be folded */
+    if (ast->op != UnaryOp::Inc && ast->op != UnaryOp::Dec)
+        OptimizeExpr(ast->expr);
+
+    STATIC_VISIT_DEFAULT(UnaryExpr);
+}
+
+IMPLEMENT_VISIT_PROC(BracketExpr)
+{
+    OptimizeExpr(ast->expr);
+
+    STATIC_VISIT_DEFAULT(BracketExpr);
+}
+
+IMPLEMENT_VISIT_PROC(ArrayAccessExpr)
+{
+    for (auto& arrayIndex : ast->arrayIndices)
+        OptimizeExpr(arrayIndex);
+
+    STATIC_VISIT_DEFAULT(ArrayAccessExpr);
+}
+
+IMPLEMENT_VISIT_PROC(CastExpr)
+{
+    OptimizeExpr(ast->expr);
+
+    STATIC_VISIT_DEFAULT(CastExpr);
+}
+
+IMPLEMENT_VISIT_PROC(VarAccessExpr)
+{
+    OptimizeExpr(ast->assignExpr);
+
+    STATIC_VISIT_DEFAULT(VarAccessExpr);
+}
+
+IMPLEMENT_VISIT_PROC(InitializerExpr)
+{
+    for (auto& expr : ast->exprs)
+        OptimizeExpr(expr);
+
+    STATIC_VISIT_DEFAULT(InitializerExpr);
+}
+
 #undef IMPLEMENT_VISIT_PROC
 
 
@@ -81,4 +2247,4 @@ IMPLEMENT_VISIT_PROC(SwitchCase)
 
 
 
-// ================================================================================
\ No newline at end of file
+// ================================================================================
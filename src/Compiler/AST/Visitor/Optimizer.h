@@ -1,6 +1,6 @@
 /*
  * Optimizer.h
- * 
+ *
  * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
  * See "LICENSE.txt" for license information.
  */
@@ -9,33 +9,132 @@
 #define XSC_OPTIMIZER_H
 
 
-#include "Visitor.h"
+#include "StaticVisitor.h"
+#include "Variant.h"
 #include <vector>
+#include <map>
+#include <set>
+#include <string>
 
 
 namespace Xsc
 {
 
 
-// This AST optimizer supports only little optimizations such as null-statement removal.
-class Optimizer : private Visitor
+/*
+This AST optimizer performs the following transformations:
+- Folds constant expressions into literals, including the propagation of 'static const' variables.
+- Collapses 'if'-statements with a constant condition into the live branch (the dead branch is removed).
+- Unrolls 'for'-loops with a constant trip count into the statements of their iterations,
+  honoring the 'unroll' and 'loop' attributes, within a size budget (see UnrollForLoop).
+- Hoists loop-invariant expressions into temporary variables in front of the loop,
+  where identical invariant expressions share a single temporary (common-subexpression extraction).
+- Reassociates chains of the 'mul' intrinsic to the grouping with the fewest scalar multiplications,
+  e.g. "mul(mul(proj, view), pos)" becomes "mul(proj, mul(view, pos))", which trades a matrix-matrix
+  product for a matrix-vector product (see OptimizeMulChain).
+- Removes null statements and empty code block statements.
+*/
+class Optimizer : private StaticVisitor<Optimizer>
 {
-    
+
     public:
-        
-        // Optimizes the specified program AST.
-        void Optimize(Program& program);
+
+        // Optimizes the specified program AST. The name mangling prefix is used for the hoisted temporary variables.
+        void Optimize(Program& program, const std::string& nameManglingPrefix = "xsc_");
 
     private:
-        
+
+        friend StaticVisitorT;
+
         void OptimizeStmntList(std::vector<StmntPtr>& stmnts);
 
+        // Replaces the specified expression by a literal, if it can be evaluated at compile time.
+        void OptimizeExpr(ExprPtr& expr);
+
+        // Replaces the specified expression by a vector type constructor with literal components.
+        void ReplaceByVectorConstructor(ExprPtr& expr, const Variant& value);
+
+        // Collapses an 'if'-statement with a constant condition into the respective branch (the statement is null if the branch is empty).
+        void CollapseStmnt(StmntPtr& stmnt);
+
         bool CanRemoveStmnt(const Stmnt& ast) const;
 
+        // Evaluates the specified expression exception-free and returns true on success, i.e. the expression is constant.
+        bool TryEvaluateConstExpr(Expr& expr, Variant& result);
+
+        // Fetches the propagated value of a 'static const' variable access; returns false if the access is not constant.
+        bool TryFetchConstVarValue(VarAccessExpr& varAccessExpr, Variant& value);
+
+        /*
+        Reorders a chain of nested 'mul' intrinsic calls to the association with the fewest scalar
+        multiplications (matrix-chain ordering over the decorated matrix/vector dimensions), without
+        changing the order of the operands themselves. The expression is replaced only if the optimal
+        association is strictly cheaper than the written one.
+        */
+        void OptimizeMulChain(ExprPtr& expr);
+
+        /* ----- Loop unrolling ----- */
+
+        // Unrolls the specified 'for'-loop into the statements of its iterations, if it has a constant trip count within the size budget.
+        bool UnrollForLoop(ForLoopStmnt& ast, std::vector<StmntPtr>& unrolledStmnts);
+
+        // Computes the value of the induction variable for each loop iteration, and returns false if the trip count is not a compile-time constant.
+        bool EvaluateLoopIterationValues(ForLoopStmnt& ast, const VarDecl* inductionVar, std::vector<Variant>& values);
+
+        // Applies one evaluation of the loop iteration expression (e.g. "++i" or "i += 2") to the induction variable value.
+        bool ApplyLoopIteration(Expr& iteration, const VarDecl* inductionVar, Variant& value);
+
+        // Like TryEvaluateConstExpr, but substitutes the specified value for plain read accesses to the specified variable.
+        bool TryEvaluateConstExprWithVar(Expr& expr, const VarDecl* varDecl, const Variant& varValue, Variant& result);
+
+        /* ----- Loop-invariant extraction ----- */
+
+        struct HoistContext;
+
+        // Hoists loop-invariant expressions out of the specified loop statement and returns the hoisted declaration statements.
+        std::vector<StmntPtr> HoistLoopInvariants(Stmnt& loopStmnt);
+
+        void HoistScanStmnt(Stmnt* stmnt, HoistContext& context);
+        void HoistScanExpr(ExprPtr& expr, HoistContext& context);
+
         /* ----- Visitor implementation ----- */
 
-        DECL_VISIT_PROC( CodeBlock  );
-        DECL_VISIT_PROC( SwitchCase );
+        DECL_STATIC_VISIT_PROC( CodeBlock        );
+        DECL_STATIC_VISIT_PROC( FunctionCall     );
+        DECL_STATIC_VISIT_PROC( SwitchCase       );
+        DECL_STATIC_VISIT_PROC( VarIdent         );
+
+        DECL_STATIC_VISIT_PROC( VarDecl          );
+
+        DECL_STATIC_VISIT_PROC( ForLoopStmnt     );
+        DECL_STATIC_VISIT_PROC( WhileLoopStmnt   );
+        DECL_STATIC_VISIT_PROC( DoWhileLoopStmnt );
+        DECL_STATIC_VISIT_PROC( IfStmnt          );
+        DECL_STATIC_VISIT_PROC( SwitchStmnt      );
+        DECL_STATIC_VISIT_PROC( ExprStmnt        );
+        DECL_STATIC_VISIT_PROC( ReturnStmnt      );
+
+        DECL_STATIC_VISIT_PROC( TernaryExpr      );
+        DECL_STATIC_VISIT_PROC( BinaryExpr       );
+        DECL_STATIC_VISIT_PROC( UnaryExpr        );
+        DECL_STATIC_VISIT_PROC( BracketExpr      );
+        DECL_STATIC_VISIT_PROC( ArrayAccessExpr  );
+        DECL_STATIC_VISIT_PROC( CastExpr         );
+        DECL_STATIC_VISIT_PROC( VarAccessExpr    );
+        DECL_STATIC_VISIT_PROC( InitializerExpr  );
+
+        /* === Members === */
+
+        std::string nameManglingPrefix_;
+
+        // Variables whose initializers are currently being evaluated (to guard against cyclic propagation).
+        std::set<const VarDecl*> propagatedVarDecls_;
+
+        // Memoized values of propagated 'static const' variables, so shared initializers are evaluated only once.
+        std::map<const VarDecl*, Variant> constVarValues_;
+
+        // Counter for unique identifiers of hoisted temporary variables.
+        unsigned int numHoistedVars_ = 0;
 
 };
 
@@ -47,4 +146,4 @@ class Optimizer : private Visitor
 
 
 
-// ================================================================================
\ No newline at end of file
+// ================================================================================
@@ -16,7 +16,9 @@ namespace Xsc
 void ReferenceAnalyzer::MarkReferencesFromEntryPoint(Program& program)
 {
     program_ = &program;
-    Visit(program.entryPointRef);
+
+    /* All visit procedures are pre-order, so the depth-independent heap-stack traversal can be used */
+    VisitDeep(program.entryPointRef);
 }
 
 
@@ -136,7 +138,18 @@ IMPLEMENT_VISIT_PROC(FunctionDecl)
 IMPLEMENT_VISIT_PROC(BufferDeclStmnt)
 {
     if (Reachable(ast))
-        VISIT_DEFAULT(BufferDeclStmnt);
+    {
+        /*
+        Visit only the member types and array dimensions: the members themselves become reachable
+        through their own references, so unreferenced members can be distinguished (see Options::trimUniforms)
+        */
+        for (auto& member : ast->members)
+        {
+            Visit(member->varType);
+            for (auto& varDecl : member->varDecls)
+                Visit(varDecl->arrayDims);
+        }
+    }
 }
 
 IMPLEMENT_VISIT_PROC(TextureDeclStmnt)
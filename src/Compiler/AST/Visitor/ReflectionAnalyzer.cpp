@@ -0,0 +1,153 @@
+/*
+ * ReflectionAnalyzer.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "ReflectionAnalyzer.h"
+#include "AST.h"
+
+
+namespace Xsc
+{
+
+
+void ReflectionAnalyzer::CollectReflection(Program& program, const ShaderTarget shaderTarget, Reflection::ReflectionData& reflectionData)
+{
+    shaderTarget_   = shaderTarget;
+    data_           = &reflectionData;
+
+    /* Collect resource declarations from the global statements */
+    Visit(program.globalStmnts);
+
+    /* Collect the input and output attributes of the entry point */
+    if (auto entryPoint = program.entryPointRef)
+    {
+        CollectAttributes(entryPoint->inputSemantics.varDeclRefs, data_->inputAttributes);
+        CollectAttributes(entryPoint->inputSemantics.varDeclRefsSV, data_->inputAttributes);
+
+        CollectAttributes(entryPoint->outputSemantics.varDeclRefs, data_->outputAttributes);
+        CollectAttributes(entryPoint->outputSemantics.varDeclRefsSV, data_->outputAttributes);
+
+        /* The return value semantic of the entry point is an output attribute as well */
+        if (entryPoint->semantic != Semantic::Undefined)
+        {
+            Reflection::Attribute attrib;
+
+            attrib.name     = entryPoint->ident;
+            attrib.semantic = entryPoint->semantic.ToString();
+
+            if (entryPoint->returnType)
+                attrib.type = entryPoint->returnType->ToString();
+
+            data_->outputAttributes.push_back(attrib);
+        }
+    }
+}
+
+
+/*
+ * ======= Private: =======
+ */
+
+int ReflectionAnalyzer::GetBindingSlot(const std::vector<RegisterPtr>& slotRegisters) const
+{
+    if (auto slotRegister = Register::GetForTarget(slotRegisters, shaderTarget_))
+        return slotRegister->slot;
+    return -1;
+}
+
+void ReflectionAnalyzer::CollectAttributes(const std::vector<VarDecl*>& varDeclRefs, std::vector<Reflection::Attribute>& attributes)
+{
+    for (auto varDecl : varDeclRefs)
+    {
+        Reflection::Attribute attrib;
+
+        attrib.name     = varDecl->ident;
+        attrib.semantic = varDecl->semantic.ToString();
+
+        if (varDecl->declStmntRef && varDecl->declStmntRef->varType)
+            attrib.type = varDecl->declStmntRef->varType->ToString();
+
+        attributes.push_back(attrib);
+    }
+}
+
+
+/* ------- Visit functions ------- */
+
+#define IMPLEMENT_VISIT_PROC(AST_NAME) \
+    void ReflectionAnalyzer::Visit##AST_NAME(AST_NAME* ast, void* args)
+
+IMPLEMENT_VISIT_PROC(BufferDeclStmnt)
+{
+    if (!ast->flags(AST::isReachable))
+        return;
+
+    Reflection::ConstantBuffer constantBuffer;
+
+    constantBuffer.name     = ast->ident;
+    constantBuffer.binding  = GetBindingSlot(ast->slotRegisters);
+
+    /* Collect all fields of the buffer members */
+    for (const auto& member : ast->members)
+    {
+        for (const auto& varDecl : member->varDecls)
+        {
+            Reflection::Field field;
+
+            field.name = varDecl->ident;
+            if (member->varType)
+                field.type = member->varType->ToString();
+            field.referenced = varDecl->flags(AST::isReachable);
+
+            constantBuffer.fields.push_back(field);
+        }
+    }
+
+    data_->constantBuffers.push_back(constantBuffer);
+}
+
+IMPLEMENT_VISIT_PROC(TextureDeclStmnt)
+{
+    if (!ast->flags(AST::isReachable))
+        return;
+
+    for (const auto& texDecl : ast->textureDecls)
+    {
+        if (texDecl->flags(AST::isReachable))
+        {
+            Reflection::Resource resource;
+
+            resource.name       = texDecl->ident;
+            resource.type       = BufferTypeToString(ast->textureType);
+            resource.binding    = GetBindingSlot(texDecl->slotRegisters);
+
+            data_->resources.push_back(resource);
+        }
+    }
+}
+
+IMPLEMENT_VISIT_PROC(SamplerDeclStmnt)
+{
+    /* The reference analyzer does not track sampler objects, so all sampler declarations are reported */
+    for (const auto& samplerDecl : ast->samplerDecls)
+    {
+        Reflection::Sampler sampler;
+
+        sampler.name    = samplerDecl->ident;
+        sampler.binding = GetBindingSlot(samplerDecl->slotRegisters);
+
+        data_->samplers.push_back(sampler);
+    }
+}
+
+#undef IMPLEMENT_VISIT_PROC
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
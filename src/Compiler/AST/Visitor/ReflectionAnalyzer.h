@@ -0,0 +1,62 @@
+/*
+ * ReflectionAnalyzer.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_REFLECTION_ANALYZER_H
+#define XSC_REFLECTION_ANALYZER_H
+
+
+#include <Xsc/Reflection.h>
+#include <Xsc/Targets.h>
+#include "Visitor.h"
+
+
+namespace Xsc
+{
+
+
+/*
+Shader code reflection analyzer.
+This helper class for the code generator collects the reflection data of all reachable
+resource declarations (constant buffers, textures, samplers) and of the entry point
+interface (see Reflection::ReflectionData).
+*/
+class ReflectionAnalyzer : private Visitor
+{
+
+    public:
+
+        // Collects the reflection data of all reachable declarations in the specified program.
+        void CollectReflection(Program& program, const ShaderTarget shaderTarget, Reflection::ReflectionData& reflectionData);
+
+    private:
+
+        // Returns the binding slot of the first register for the current shader target, or -1 if there is no such register.
+        int GetBindingSlot(const std::vector<RegisterPtr>& slotRegisters) const;
+
+        // Appends the attributes of the specified entry point parameters to the output list.
+        void CollectAttributes(const std::vector<VarDecl*>& varDeclRefs, std::vector<Reflection::Attribute>& attributes);
+
+        /* ----- Visitor implementation ----- */
+
+        DECL_VISIT_PROC( BufferDeclStmnt  );
+        DECL_VISIT_PROC( TextureDeclStmnt );
+        DECL_VISIT_PROC( SamplerDeclStmnt );
+
+        ShaderTarget                shaderTarget_   = ShaderTarget::Undefined;
+        Reflection::ReflectionData* data_           = nullptr;
+
+};
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
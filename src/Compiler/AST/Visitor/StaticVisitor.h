@@ -0,0 +1,435 @@
+/*
+ * StaticVisitor.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_STATIC_VISITOR_H
+#define XSC_STATIC_VISITOR_H
+
+
+#include "AST.h"
+
+
+namespace Xsc
+{
+
+
+// Static visitor interface
+
+#define DECL_STATIC_VISIT_PROC(CLASS_NAME) \
+    void Visit##CLASS_NAME(CLASS_NAME* ast, void* args)
+
+#define STATIC_VISIT_DEFAULT(CLASS_NAME) \
+    this->StaticVisitorT::Visit##CLASS_NAME(ast, args)
+
+/*
+CRTP alternative to the virtual "Visitor" class: the node dispatch is a switch over "AST::Type()"
+and the Visit* calls are direct (non-virtual) calls into the derived class, so the compiler can inline them.
+The derived class must declare "friend StaticVisitorT" (or make its Visit* functions public)
+and hides the default Visit* functions it is interested in (see Optimizer for an example).
+*/
+template <typename Derived>
+class StaticVisitor
+{
+
+    protected:
+
+        using StaticVisitorT = StaticVisitor<Derived>;
+
+        template <typename T>
+        void Visit(const T& ast, void* args = nullptr)
+        {
+            if (ast)
+                DispatchVisit(&(*ast), args);
+        }
+
+        template <typename T>
+        void Visit(const std::vector<T>& astList, void* args = nullptr)
+        {
+            for (const auto& ast : astList)
+                Visit(ast, args);
+        }
+
+        // Called before each node is dispatched to its Visit* function; the derived class can hide this to observe every node.
+        void OnDispatchNode(AST* ast, void* args)
+        {
+            // do nothing
+        }
+
+        /* ----- Default visit functions (visit all sub nodes) ----- */
+
+        DECL_STATIC_VISIT_PROC( Program )
+        {
+            Visit(ast->globalStmnts, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( CodeBlock )
+        {
+            Visit(ast->stmnts, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( FunctionCall )
+        {
+            Visit(ast->varIdent, args);
+            Visit(ast->arguments, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( Attribute )
+        {
+            Visit(ast->arguments, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( SwitchCase )
+        {
+            Visit(ast->expr, args);
+            Visit(ast->stmnts, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( SamplerValue )
+        {
+            Visit(ast->value, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( Register )
+        {
+            // do nothing
+        }
+
+        DECL_STATIC_VISIT_PROC( PackOffset )
+        {
+            // do nothing
+        }
+
+        DECL_STATIC_VISIT_PROC( VarType )
+        {
+            Visit(ast->structDecl, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( VarIdent )
+        {
+            Visit(ast->arrayIndices, args);
+            Visit(ast->next, args);
+        }
+
+        /* --- Declarations --- */
+
+        DECL_STATIC_VISIT_PROC( VarDecl )
+        {
+            Visit(ast->arrayDims, args);
+            Visit(ast->packOffset, args);
+            Visit(ast->annotations, args);
+            Visit(ast->initializer, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( TextureDecl )
+        {
+            Visit(ast->arrayDims, args);
+            Visit(ast->slotRegisters, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( SamplerDecl )
+        {
+            Visit(ast->arrayDims, args);
+            Visit(ast->slotRegisters, args);
+            Visit(ast->samplerValues, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( StructDecl )
+        {
+            Visit(ast->members, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( AliasDecl )
+        {
+            // do nothing
+        }
+
+        /* --- Declaration statements --- */
+
+        DECL_STATIC_VISIT_PROC( FunctionDecl )
+        {
+            Visit(ast->attribs, args);
+            Visit(ast->returnType, args);
+            Visit(ast->parameters, args);
+            Visit(ast->annotations, args);
+            Visit(ast->codeBlock, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( BufferDeclStmnt )
+        {
+            Visit(ast->members, args);
+            Visit(ast->slotRegisters, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( TextureDeclStmnt )
+        {
+            Visit(ast->textureDecls, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( SamplerDeclStmnt )
+        {
+            Visit(ast->samplerDecls, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( StructDeclStmnt )
+        {
+            Visit(ast->structDecl, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( VarDeclStmnt )
+        {
+            Visit(ast->varType, args);
+            Visit(ast->varDecls, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( AliasDeclStmnt )
+        {
+            Visit(ast->structDecl, args);
+            Visit(ast->aliasDecls, args);
+        }
+
+        /* --- Statements --- */
+
+        DECL_STATIC_VISIT_PROC( NullStmnt )
+        {
+            // do nothing
+        }
+
+        DECL_STATIC_VISIT_PROC( CodeBlockStmnt )
+        {
+            Visit(ast->codeBlock, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( ForLoopStmnt )
+        {
+            Visit(ast->attribs, args);
+            Visit(ast->initSmnt, args);
+            Visit(ast->condition, args);
+            Visit(ast->iteration, args);
+            Visit(ast->bodyStmnt, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( WhileLoopStmnt )
+        {
+            Visit(ast->attribs, args);
+            Visit(ast->condition, args);
+            Visit(ast->bodyStmnt, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( DoWhileLoopStmnt )
+        {
+            Visit(ast->attribs, args);
+            Visit(ast->bodyStmnt, args);
+            Visit(ast->condition, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( IfStmnt )
+        {
+            Visit(ast->attribs, args);
+            Visit(ast->condition, args);
+            Visit(ast->bodyStmnt, args);
+            Visit(ast->elseStmnt, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( ElseStmnt )
+        {
+            Visit(ast->bodyStmnt, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( SwitchStmnt )
+        {
+            Visit(ast->attribs, args);
+            Visit(ast->selector, args);
+            Visit(ast->cases, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( ExprStmnt )
+        {
+            Visit(ast->expr, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( ReturnStmnt )
+        {
+            Visit(ast->expr, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( CtrlTransferStmnt )
+        {
+            // do nothing
+        }
+
+        /* --- Expressions --- */
+
+        DECL_STATIC_VISIT_PROC( NullExpr )
+        {
+            // do nothing
+        }
+
+        DECL_STATIC_VISIT_PROC( ListExpr )
+        {
+            Visit(ast->firstExpr, args);
+            Visit(ast->nextExpr, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( LiteralExpr )
+        {
+            // do nothing
+        }
+
+        DECL_STATIC_VISIT_PROC( TypeNameExpr )
+        {
+            // do nothing
+        }
+
+        DECL_STATIC_VISIT_PROC( TernaryExpr )
+        {
+            Visit(ast->condExpr, args);
+            Visit(ast->thenExpr, args);
+            Visit(ast->elseExpr, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( BinaryExpr )
+        {
+            Visit(ast->lhsExpr, args);
+            Visit(ast->rhsExpr, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( UnaryExpr )
+        {
+            Visit(ast->expr, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( PostUnaryExpr )
+        {
+            Visit(ast->expr, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( FunctionCallExpr )
+        {
+            Visit(ast->call, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( BracketExpr )
+        {
+            Visit(ast->expr, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( SuffixExpr )
+        {
+            Visit(ast->expr, args);
+            Visit(ast->varIdent, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( ArrayAccessExpr )
+        {
+            Visit(ast->expr, args);
+            Visit(ast->arrayIndices, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( CastExpr )
+        {
+            Visit(ast->typeExpr, args);
+            Visit(ast->expr, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( VarAccessExpr )
+        {
+            Visit(ast->varIdent, args);
+            Visit(ast->assignExpr, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( InitializerExpr )
+        {
+            Visit(ast->exprs, args);
+        }
+
+        DECL_STATIC_VISIT_PROC( LiteralBlobExpr )
+        {
+            // no sub nodes
+        }
+
+    private:
+
+        #define XSC_STATIC_DISPATCH_CASE(CLASS_NAME)                                                    \
+            case AST::Types::CLASS_NAME:                                                                \
+                static_cast<Derived*>(this)->Visit##CLASS_NAME(static_cast<CLASS_NAME*>(ast), args);    \
+                break
+
+        // Dispatches to the derived Visit* function by the node type (no virtual call involved).
+        void DispatchVisit(AST* ast, void* args)
+        {
+            static_cast<Derived*>(this)->OnDispatchNode(ast, args);
+
+            switch (ast->Type())
+            {
+                XSC_STATIC_DISPATCH_CASE( Program           );
+                XSC_STATIC_DISPATCH_CASE( CodeBlock         );
+                XSC_STATIC_DISPATCH_CASE( FunctionCall      );
+                XSC_STATIC_DISPATCH_CASE( Attribute         );
+                XSC_STATIC_DISPATCH_CASE( SwitchCase        );
+                XSC_STATIC_DISPATCH_CASE( SamplerValue      );
+                XSC_STATIC_DISPATCH_CASE( Register          );
+                XSC_STATIC_DISPATCH_CASE( PackOffset        );
+                XSC_STATIC_DISPATCH_CASE( VarType           );
+                XSC_STATIC_DISPATCH_CASE( VarIdent          );
+
+                XSC_STATIC_DISPATCH_CASE( VarDecl           );
+                XSC_STATIC_DISPATCH_CASE( TextureDecl       );
+                XSC_STATIC_DISPATCH_CASE( SamplerDecl       );
+                XSC_STATIC_DISPATCH_CASE( StructDecl        );
+                XSC_STATIC_DISPATCH_CASE( AliasDecl         );
+
+                XSC_STATIC_DISPATCH_CASE( FunctionDecl      );
+                XSC_STATIC_DISPATCH_CASE( BufferDeclStmnt   );
+                XSC_STATIC_DISPATCH_CASE( TextureDeclStmnt  );
+                XSC_STATIC_DISPATCH_CASE( SamplerDeclStmnt  );
+                XSC_STATIC_DISPATCH_CASE( StructDeclStmnt   );
+                XSC_STATIC_DISPATCH_CASE( VarDeclStmnt      );
+                XSC_STATIC_DISPATCH_CASE( AliasDeclStmnt    );
+
+                XSC_STATIC_DISPATCH_CASE( NullStmnt         );
+                XSC_STATIC_DISPATCH_CASE( CodeBlockStmnt    );
+                XSC_STATIC_DISPATCH_CASE( ForLoopStmnt      );
+                XSC_STATIC_DISPATCH_CASE( WhileLoopStmnt    );
+                XSC_STATIC_DISPATCH_CASE( DoWhileLoopStmnt  );
+                XSC_STATIC_DISPATCH_CASE( IfStmnt           );
+                XSC_STATIC_DISPATCH_CASE( ElseStmnt         );
+                XSC_STATIC_DISPATCH_CASE( SwitchStmnt       );
+                XSC_STATIC_DISPATCH_CASE( ExprStmnt         );
+                XSC_STATIC_DISPATCH_CASE( ReturnStmnt       );
+                XSC_STATIC_DISPATCH_CASE( CtrlTransferStmnt );
+
+                XSC_STATIC_DISPATCH_CASE( NullExpr          );
+                XSC_STATIC_DISPATCH_CASE( ListExpr          );
+                XSC_STATIC_DISPATCH_CASE( LiteralExpr       );
+                XSC_STATIC_DISPATCH_CASE( TypeNameExpr      );
+                XSC_STATIC_DISPATCH_CASE( TernaryExpr       );
+                XSC_STATIC_DISPATCH_CASE( BinaryExpr        );
+                XSC_STATIC_DISPATCH_CASE( UnaryExpr         );
+                XSC_STATIC_DISPATCH_CASE( PostUnaryExpr     );
+                XSC_STATIC_DISPATCH_CASE( FunctionCallExpr  );
+                XSC_STATIC_DISPATCH_CASE( BracketExpr       );
+                XSC_STATIC_DISPATCH_CASE( SuffixExpr        );
+                XSC_STATIC_DISPATCH_CASE( ArrayAccessExpr   );
+                XSC_STATIC_DISPATCH_CASE( CastExpr          );
+                XSC_STATIC_DISPATCH_CASE( VarAccessExpr     );
+                XSC_STATIC_DISPATCH_CASE( InitializerExpr   );
+                XSC_STATIC_DISPATCH_CASE( LiteralBlobExpr   );
+            }
+        }
+
+        #undef XSC_STATIC_DISPATCH_CASE
+
+};
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
@@ -9,6 +9,14 @@
 #include "AST.h"
 
 
+/* Prefetch hint for the heap-stack traversal (see Visitor::VisitDeep) */
+#if defined(__GNUC__) || defined(__clang__)
+#   define XSC_PREFETCH(ADDR) __builtin_prefetch(ADDR)
+#else
+#   define XSC_PREFETCH(ADDR)
+#endif
+
+
 namespace Xsc
 {
 
@@ -22,6 +30,48 @@ Visitor::~Visitor()
     // dummy
 }
 
+void Visitor::Fuse(Visitor* visitor)
+{
+    if (visitor)
+        fusedVisitors_.push_back(visitor);
+}
+
+void Visitor::VisitDeep(AST* ast, void* args)
+{
+    if (!ast)
+        return;
+
+    std::vector<AST*> nodeStack;
+    nodeStack.push_back(ast);
+
+    deepTraversal_ = true;
+
+    while (!nodeStack.empty())
+    {
+        auto node = nodeStack.back();
+        nodeStack.pop_back();
+
+        /* Prefetch the next pending node while the current one is dispatched */
+        if (!nodeStack.empty())
+            XSC_PREFETCH(nodeStack.back());
+
+        /* Dispatch node: its visit procedure records the sub-node visits instead of descending */
+        deepChildren_.clear();
+        node->Visit(this, args);
+
+        /* Notify all fused visitors about the dispatched node */
+        for (auto fusedVisitor : fusedVisitors_)
+            node->Visit(fusedVisitor, args);
+
+        /* Push the recorded sub nodes in reverse, so they are dispatched in declaration order */
+        for (auto it = deepChildren_.rbegin(); it != deepChildren_.rend(); ++it)
+            nodeStack.push_back(*it);
+    }
+
+    deepTraversal_ = false;
+    deepChildren_.clear();
+}
+
 IMPLEMENT_VISIT_PROC(Program)
 {
     Visit(ast->globalStmnts);
@@ -307,6 +357,11 @@ IMPLEMENT_VISIT_PROC(InitializerExpr)
     Visit(ast->exprs);
 }
 
+IMPLEMENT_VISIT_PROC(LiteralBlobExpr)
+{
+    // do nothing
+}
+
 
 #undef IMPLEMENT_VISIT_PROC
 
@@ -79,6 +79,7 @@ DECL_PTR( ArrayAccessExpr   );
 DECL_PTR( CastExpr          );
 DECL_PTR( VarAccessExpr     );
 DECL_PTR( InitializerExpr   );
+DECL_PTR( LiteralBlobExpr   );
 
 #undef DECL_PTR
 
@@ -97,9 +98,27 @@ class Visitor
 {
     
     public:
-        
+
         virtual ~Visitor();
 
+        /*
+        Attaches another visitor that is invoked for every node this visitor dispatches,
+        which fuses multiple passes into a single AST traversal. A fused visitor only
+        observes the host traversal, so its visit procedures must not visit sub nodes.
+        */
+        void Fuse(Visitor* visitor);
+
+        /*
+        Visits the specified AST with an explicit heap stack instead of recursive descent,
+        so the traversal depth is independent of the native stack size (e.g. for generated
+        expression chains with thousands of nested binary expressions). The visit procedures
+        are dispatched as usual, but their sub-node visits are recorded and dispatched by the
+        engine afterwards. This mode is therefore only valid for pre-order passes, i.e. visit
+        procedures that perform all their work before (or independent of) their sub-node
+        visits; the specified 'args' pointer is passed to every dispatched node.
+        */
+        void VisitDeep(AST* ast, void* args = nullptr);
+
         VISITOR_VISIT_PROC( Program           );
         VISITOR_VISIT_PROC( CodeBlock         );
         VISITOR_VISIT_PROC( FunctionCall      );
@@ -152,6 +171,7 @@ class Visitor
         VISITOR_VISIT_PROC( CastExpr          );
         VISITOR_VISIT_PROC( VarAccessExpr     );
         VISITOR_VISIT_PROC( InitializerExpr   );
+        VISITOR_VISIT_PROC( LiteralBlobExpr   );
 
     protected:
         
@@ -159,7 +179,20 @@ class Visitor
         void Visit(T ast, void* args = nullptr)
         {
             if (ast)
+            {
+                if (deepTraversal_)
+                {
+                    /* Only record the sub node; the heap-stack engine dispatches it afterwards (see VisitDeep) */
+                    deepChildren_.push_back(&(*ast));
+                    return;
+                }
+
                 ast->Visit(this, args);
+
+                /* Notify all fused visitors about the dispatched node */
+                for (auto fusedVisitor : fusedVisitors_)
+                    ast->Visit(fusedVisitor, args);
+            }
         }
 
         template <typename T>
@@ -169,6 +202,14 @@ class Visitor
                 Visit(ast, args);
         }
 
+    private:
+
+        std::vector<Visitor*>   fusedVisitors_;
+
+        /* Heap-stack traversal state (see VisitDeep) */
+        std::vector<AST*>       deepChildren_;
+        bool                    deepTraversal_  = false;
+
 };
 
 #undef VISITOR_VISIT_PROC
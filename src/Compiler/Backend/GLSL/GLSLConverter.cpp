@@ -11,6 +11,7 @@
 #include "ASTFactory.h"
 #include "Exception.h"
 #include "Helper.h"
+#include "StringInterner.h"
 
 
 namespace Xsc
@@ -18,11 +19,12 @@ namespace Xsc
 
 
 void GLSLConverter::Convert(
-    Program& program, const ShaderTarget shaderTarget, const std::string& nameManglingPrefix)
+    Program& program, const ShaderTarget shaderTarget, const std::string& nameManglingPrefix, bool shortNameMangling)
 {
     /* Store settings */
     shaderTarget_       = shaderTarget;
     nameManglingPrefix_ = nameManglingPrefix;
+    shortNameMangling_  = shortNameMangling;
 
     /* Visit program AST */
     Visit(&program);
@@ -156,6 +158,10 @@ IMPLEMENT_VISIT_PROC(VarIdent)
             }
         }
     }
+
+    /* Visit the array index expressions of the entire identifier chain (the chain itself is maintained above) */
+    for (auto varIdent = ast; varIdent != nullptr; varIdent = varIdent->next.get())
+        Visit(varIdent->arrayIndices);
 }
 
 /* --- Declarations --- */
@@ -194,7 +200,9 @@ IMPLEMENT_VISIT_PROC(StructDecl)
     if (ast->members.empty())
     {
         /* Add dummy member if the structure is empty (GLSL does not support empty structures) */
-        auto dummyMember = ASTFactory::MakeVarDeclStmnt(DataType::Int, nameManglingPrefix_ + "dummy");
+        auto dummyMember = ASTFactory::MakeVarDeclStmnt(
+            DataType::Int, (shortNameMangling_ ? NextShortMangledIdent() : nameManglingPrefix_ + "dummy")
+        );
         ast->members.push_back(dummyMember);
     }
 }
@@ -203,6 +211,10 @@ IMPLEMENT_VISIT_PROC(StructDecl)
 
 IMPLEMENT_VISIT_PROC(FunctionDecl)
 {
+    /* Skip functions that are unreachable from the entry point (their bodies are not decorated) */
+    if (!ast->flags(AST::isReachable))
+        return;
+
     currentFunctionDecl_ = ast;
 
     if (ast->flags(FunctionDecl::isEntryPoint))
@@ -319,6 +331,7 @@ IMPLEMENT_VISIT_PROC(LiteralExpr)
         {
             s.back() = 'f';
             ast->dataType = DataType::Float;
+            ast->ResetBufferedTypeDenoter();
         }
     }
 
@@ -445,15 +458,50 @@ bool GLSLConverter::MustRenameVarDecl(VarDecl* ast) const
 void GLSLConverter::RenameVarDecl(VarDecl* ast)
 {
     /* Set new identifier for this variable */
-    ast->ident = nameManglingPrefix_ + ast->ident;
+    ast->ident = (shortNameMangling_ ? NextShortMangledIdent() : nameManglingPrefix_ + ast->ident);
     ast->flags << VarDecl::wasRenamed;
 }
 
+std::string GLSLConverter::NextShortMangledIdent()
+{
+    /* All declared identifiers of the compile were interned during parsing and analysis,
+       so the interner doubles as program-wide collision check for the generated names */
+    auto interner = StringInterner::Active();
+
+    for (;;)
+    {
+        /* Encode the counter in base 26 under a leading underscore (see Formatting::minify) */
+        std::string ident = "_";
+
+        auto counter = shortNameCounter_++;
+        do
+        {
+            ident += static_cast<char>('a' + counter % 26);
+            counter /= 26;
+        }
+        while (counter > 0);
+
+        if (interner == nullptr)
+            return ident;
+
+        /* Skip names the program already uses; claim the chosen name, so later symbol
+           operations share its pooled string (the counter keeps the result deterministic) */
+        if (interner->Find(ident) == nullptr)
+        {
+            interner->Intern(ident);
+            return ident;
+        }
+    }
+}
+
 void GLSLConverter::LabelAnonymousStructDecl(StructDecl* ast)
 {
     if (ast->IsAnonymous())
     {
-        ast->ident = nameManglingPrefix_ + "anonymous_struct" + std::to_string(anonymousStructCounter_);
+        if (shortNameMangling_)
+            ast->ident = NextShortMangledIdent();
+        else
+            ast->ident = nameManglingPrefix_ + "anonymous_struct" + std::to_string(anonymousStructCounter_);
         ++anonymousStructCounter_;
     }
 }
@@ -30,7 +30,8 @@ class GLSLConverter : public Visitor
         void Convert(
             Program& program,
             const ShaderTarget shaderTarget,
-            const std::string& nameManglingPrefix
+            const std::string& nameManglingPrefix,
+            bool shortNameMangling = false
         );
 
     private:
@@ -86,6 +87,9 @@ class GLSLConverter : public Visitor
         // Renames the specified variable declaration with name mangling.
         void RenameVarDecl(VarDecl* ast);
 
+        // Returns the next short generated identifier for the minified name mangling (e.g. "_a", "_b", ..., "_aa").
+        std::string NextShortMangledIdent();
+
         // Labels the specified anonymous structure.
         void LabelAnonymousStructDecl(StructDecl* ast);
 
@@ -127,6 +131,11 @@ class GLSLConverter : public Visitor
 
         std::string             nameManglingPrefix_;
 
+        // If enabled, mangled identifiers use short generated names instead of the prefix scheme (see Formatting::minify).
+        bool                    shortNameMangling_      = false;
+
+        std::size_t             shortNameCounter_       = 0;
+
         /*
         List of all variables with reserved identifiers that come from a structure that must be resolved.
         If a local variable uses a name from this list, it name must be modified with name mangling.
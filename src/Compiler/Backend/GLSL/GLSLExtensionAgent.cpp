@@ -60,31 +60,59 @@ static OutputShaderVersion GetMinGLSLVersionForTarget(const ShaderTarget shaderT
     return OutputShaderVersion::GLSL130; // actually 110, but this compiler does not support GLSL < 130
 }
 
-std::set<std::string> GLSLExtensionAgent::DetermineRequiredExtensions(
-    Program& program, OutputShaderVersion& targetGLSLVersion,
-    const ShaderTarget shaderTarget, bool allowExtensions, bool explicitBinding)
+void GLSLExtensionAgent::PrepareCollection(
+    const OutputShaderVersion targetGLSLVersion, const ShaderTarget shaderTarget, bool allowExtensions, bool explicitBinding)
 {
     shaderTarget_       = shaderTarget;
     targetGLSLVersion_  = targetGLSLVersion;
     minGLSLVersion_     = GetMinGLSLVersionForTarget(shaderTarget);
     allowExtensions_    = allowExtensions;
     explicitBinding_    = explicitBinding;
+}
 
-    Visit(&program);
+void GLSLExtensionAgent::CollectExtensionsFromUsage(const Program& program)
+{
+    /* Resolve the recorded requirements against the current target version (a plain array scan instead of an AST traversal) */
+    for (const auto& usage : program.glslExtensionUsage)
+        AcquireExtension({ usage.extensionName, usage.requiredVersion }, usage.onlyWithExplicitBinding);
+}
 
+std::set<std::string> GLSLExtensionAgent::CollectedExtensions(OutputShaderVersion& targetGLSLVersion)
+{
     if (targetGLSLVersion == OutputShaderVersion::GLSL)
         targetGLSLVersion = minGLSLVersion_;
 
     return std::move(extensions_);
 }
 
+void GLSLExtensionAgent::StoreExtensionUsage(Program& program)
+{
+    program.glslExtensionUsage = std::move(usageRecord_);
+}
+
 
 /*
  * ======= Private: =======
  */
 
-void GLSLExtensionAgent::AcquireExtension(const GLSLExtension& extension)
+void GLSLExtensionAgent::AcquireExtension(const GLSLExtension& extension, bool onlyWithExplicitBinding)
 {
+    /* Record the requirement occurrence independently of the current target version (see StoreExtensionUsage) */
+    auto it = std::find_if(
+        usageRecord_.begin(), usageRecord_.end(),
+        [&](const GLSLExtensionUsage& usage)
+        {
+            return (usage.extensionName == extension.extensionName && usage.onlyWithExplicitBinding == onlyWithExplicitBinding);
+        }
+    );
+
+    if (it == usageRecord_.end())
+        usageRecord_.push_back({ extension.extensionName, extension.requiredVersion, onlyWithExplicitBinding });
+
+    /* Extensions for explicit binding points are only required if explicit bindings are enabled */
+    if (onlyWithExplicitBinding && !explicitBinding_)
+        return;
+
     if (targetGLSLVersion_ == OutputShaderVersion::GLSL)
     {
         /* Store minimum required GLSL version */
@@ -101,7 +129,7 @@ void GLSLExtensionAgent::AcquireExtension(const GLSLExtension& extension)
         {
             /* Extensions not allowed -> runtime error */
             RuntimeErr(
-                "GLSL extension '" + extension.extensionName +
+                "GLSL extension '" + std::string(extension.extensionName) +
                 "' or shader output version '" + ShaderVersionToString(extension.requiredVersion) + "' required"
             );
         }
@@ -109,7 +137,11 @@ void GLSLExtensionAgent::AcquireExtension(const GLSLExtension& extension)
 }
 
 
-/* ------- Visit functions ------- */
+/*
+------- Visit functions -------
+The agent observes the traversal of the host visitor it is fused with (see Visitor::Fuse),
+so none of these procedures visits any sub nodes.
+*/
 
 #define IMPLEMENT_VISIT_PROC(AST_NAME) \
     void GLSLExtensionAgent::Visit##AST_NAME(AST_NAME* ast, void* args)
@@ -123,9 +155,6 @@ IMPLEMENT_VISIT_PROC(FunctionCall)
         if (it != intrinsicExtMap_.end())
             AcquireExtension(it->second);
     }
-
-    /* Default visitor */
-    Visitor::VisitFunctionCall(ast, args);
 }
 
 IMPLEMENT_VISIT_PROC(Attribute)
@@ -144,55 +173,32 @@ IMPLEMENT_VISIT_PROC(VarDecl)
     /* Check for packoffsets */
     if (ast->packOffset)
         AcquireExtension(GLSLEXT_GL_ARB_enhanced_layouts);
-
-    /* Default visitor */
-    Visitor::VisitVarDecl(ast, args);
-}
-
-IMPLEMENT_VISIT_PROC(FunctionDecl)
-{
-    if (ast->flags(AST::isReachable))
-    {
-        Visit(ast->attribs);
-
-        /* Default visitor */
-        Visitor::VisitFunctionDecl(ast, args);
-    }
 }
 
 IMPLEMENT_VISIT_PROC(BufferDeclStmnt)
 {
     AcquireExtension(GLSLEXT_GL_ARB_uniform_buffer_object);
 
-    /* Check for explicit binding point */
-    if (explicitBinding_)
-    {
-        if (Register::GetForTarget(ast->slotRegisters, shaderTarget_) != nullptr)
-            AcquireExtension(GLSLEXT_GL_ARB_shading_language_420pack);
-    }
-
-    /* Default visitor */
-    Visitor::VisitBufferDeclStmnt(ast, args);
+    /* Check for explicit binding point (only required if explicit bindings are enabled; see AcquireExtension) */
+    if (Register::GetForTarget(ast->slotRegisters, shaderTarget_) != nullptr)
+        AcquireExtension(GLSLEXT_GL_ARB_shading_language_420pack, true);
 }
 
 IMPLEMENT_VISIT_PROC(TextureDeclStmnt)
 {
-    /* Check for explicit binding point */
-    if (explicitBinding_)
+    /* Check for explicit binding point (only required if explicit bindings are enabled; see AcquireExtension) */
+    for (auto& texDecl : ast->textureDecls)
     {
-        for (auto& texDecl : ast->textureDecls)
+        if (Register::GetForTarget(texDecl->slotRegisters, shaderTarget_) != nullptr)
         {
-            if (Register::GetForTarget(texDecl->slotRegisters, shaderTarget_) != nullptr)
-                AcquireExtension(GLSLEXT_GL_ARB_shading_language_420pack);
+            AcquireExtension(GLSLEXT_GL_ARB_shading_language_420pack, true);
+            break;
         }
     }
 
     /* Check for multi-sampled textures */
     if (IsTextureMSBufferType(ast->textureType))
         AcquireExtension(GLSLEXT_GL_ARB_texture_multisample);
-
-    /* Default visitor */
-    Visitor::VisitTextureDeclStmnt(ast, args);
 }
 
 IMPLEMENT_VISIT_PROC(BinaryExpr)
@@ -200,9 +206,6 @@ IMPLEMENT_VISIT_PROC(BinaryExpr)
     /* Check if bitwise operators are used -> requires "GL_EXT_gpu_shader4" extensions */
     if (IsBitwiseOp(ast->op) || ast->op == BinaryOp::Mod)
         AcquireExtension(GLSLEXT_GL_EXT_gpu_shader4);
-
-    /* Default visitor */
-    Visitor::VisitBinaryExpr(ast, args);
 }
 
 IMPLEMENT_VISIT_PROC(UnaryExpr)
@@ -210,9 +213,6 @@ IMPLEMENT_VISIT_PROC(UnaryExpr)
     /* Check if bitwise operators are used -> requires "GL_EXT_gpu_shader4" extensions */
     if (IsBitwiseOp(ast->op))
         AcquireExtension(GLSLEXT_GL_EXT_gpu_shader4);
-
-    /* Default visitor */
-    Visitor::VisitUnaryExpr(ast, args);
 }
 
 IMPLEMENT_VISIT_PROC(VarAccessExpr)
@@ -220,17 +220,16 @@ IMPLEMENT_VISIT_PROC(VarAccessExpr)
     /* Check if bitwise operators are used -> requires "GL_EXT_gpu_shader4" extensions */
     if (IsBitwiseOp(ast->assignOp) || ast->assignOp == AssignOp::Mod)
         AcquireExtension(GLSLEXT_GL_EXT_gpu_shader4);
-
-    /* Default visitor */
-    Visitor::VisitVarAccessExpr(ast, args);
 }
 
 IMPLEMENT_VISIT_PROC(InitializerExpr)
 {
     AcquireExtension(GLSLEXT_GL_ARB_shading_language_420pack);
+}
 
-    /* Default visitor */
-    Visitor::VisitInitializerExpr(ast, args);
+IMPLEMENT_VISIT_PROC(LiteralBlobExpr)
+{
+    AcquireExtension(GLSLEXT_GL_ARB_shading_language_420pack);
 }
 
 #undef IMPLEMENT_VISIT_PROC
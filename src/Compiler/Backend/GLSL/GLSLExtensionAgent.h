@@ -11,10 +11,12 @@
 
 #include <Xsc/Targets.h>
 #include "Visitor.h"
+#include "AST.h"
 #include "ASTEnums.h"
 #include <set>
 #include <string>
 #include <map>
+#include <vector>
 
 
 namespace Xsc
@@ -24,30 +26,46 @@ namespace Xsc
 // GLSL extension type with name and minimum required GLSL version.
 struct GLSLExtension
 {
-    std::string         extensionName;
+    // Extension name as string literal, so the internal extension objects need no startup initialization.
+    const char*         extensionName;
     OutputShaderVersion requiredVersion;
 };
 
-// GLSL extension agent visitor. Determines which GLSL extension are required for a given GLSL target version.
-class GLSLExtensionAgent : private Visitor
+/*
+GLSL extension agent visitor. Determines which GLSL extension are required for a given GLSL target version.
+The agent does not run its own AST walk: it is fused into the GLSL converter traversal (see Visitor::Fuse),
+so its visit procedures only inspect the dispatched node and never visit sub nodes.
+While collecting, the agent also records all requirement occurrences independently of the target version,
+so further output versions resolve their extensions from the record instead of a renewed traversal
+(see CollectExtensionsFromUsage).
+*/
+class GLSLExtensionAgent : public Visitor
 {
-    
+
     public:
-        
+
         GLSLExtensionAgent();
 
-        // Returns a set of strings with all required extensions for the specified program and target output GLSL version.
-        std::set<std::string> DetermineRequiredExtensions(
-            Program& program,
-            OutputShaderVersion& targetGLSLVersion,
+        // Prepares the agent to collect the required extensions during the host traversal it is fused with.
+        void PrepareCollection(
+            const OutputShaderVersion targetGLSLVersion,
             const ShaderTarget shaderTarget,
             bool allowExtensions,
             bool explicitBinding
         );
 
+        // Collects the required extensions from the recorded usage of an already converted program (see Program::glslExtensionUsage).
+        void CollectExtensionsFromUsage(const Program& program);
+
+        // Returns the set of collected extensions, and reduces the target GLSL version to the minimum required one if it is auto-detect.
+        std::set<std::string> CollectedExtensions(OutputShaderVersion& targetGLSLVersion);
+
+        // Stores the version independent extension usage record in the program, for the emission of further output versions.
+        void StoreExtensionUsage(Program& program);
+
     private:
-        
-        void AcquireExtension(const GLSLExtension& extension);
+
+        void AcquireExtension(const GLSLExtension& extension, bool onlyWithExplicitBinding = false);
 
         /* --- Visitor implementation --- */
 
@@ -56,7 +74,6 @@ class GLSLExtensionAgent : private Visitor
 
         DECL_VISIT_PROC( VarDecl          );
 
-        DECL_VISIT_PROC( FunctionDecl     );
         DECL_VISIT_PROC( BufferDeclStmnt  );
         DECL_VISIT_PROC( TextureDeclStmnt );
 
@@ -64,6 +81,7 @@ class GLSLExtensionAgent : private Visitor
         DECL_VISIT_PROC( UnaryExpr        );
         DECL_VISIT_PROC( VarAccessExpr    );
         DECL_VISIT_PROC( InitializerExpr  );
+        DECL_VISIT_PROC( LiteralBlobExpr  );
 
         /* === Members === */
 
@@ -84,6 +102,9 @@ class GLSLExtensionAgent : private Visitor
         // Intrinsic name to GLSL extension map.
         std::map<Intrinsic, GLSLExtension>  intrinsicExtMap_;
 
+        // Version independent record of all extension requirement occurrences (see StoreExtensionUsage).
+        std::vector<GLSLExtensionUsage>     usageRecord_;
+
 };
 
 
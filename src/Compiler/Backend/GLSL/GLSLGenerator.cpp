@@ -13,10 +13,13 @@
 #include "GLSLHelper.h"
 #include "ReferenceAnalyzer.h"
 #include "ControlPathAnalyzer.h"
+#include "ReflectionAnalyzer.h"
+#include "CostEstimator.h"
 #include "TypeDenoter.h"
 #include "AST.h"
 #include "Exception.h"
 #include "Helper.h"
+#include "TraceEvents.h"
 #include <initializer_list>
 #include <algorithm>
 #include <cctype>
@@ -40,33 +43,118 @@ void GLSLGenerator::GenerateCodePrimary(
     versionOut_         = outputDesc.shaderVersion;
     allowExtensions_    = outputDesc.options.allowExtensions;
     explicitBinding_    = outputDesc.options.explicitBinding;
-    preserveComments_   = outputDesc.options.preserveComments;
-    allowLineMarks_     = outputDesc.formatting.lineMarks;
+    trimUniforms_       = outputDesc.options.trimUniforms;
+    minify_             = outputDesc.formatting.minify;
+    preserveComments_   = (outputDesc.options.preserveComments && !minify_);
+    allowLineMarks_     = (outputDesc.formatting.lineMarks && !minify_);
     compactWrappers_    = outputDesc.formatting.compactWrappers;
     newLineOpenScope_   = outputDesc.formatting.newLineOpenScope;
     nameManglingPrefix_ = outputDesc.formatting.prefix;
     stats_              = outputDesc.statistics;
+    wrapperPreamble_    = outputDesc.wrapperPreamble;
 
     if (program.entryPointRef)
     {
         try
         {
-            /* Mark all control paths */
+            if (!program.flags(Program::isConvertedGLSL))
             {
-                ControlPathAnalyzer pathAnalyzer;
-                pathAnalyzer.MarkControlPaths(program);
-            }
+                /* Mark all control paths first, so the reference marking can skip dead code (the pass needs no type decoration) */
+                {
+                    TraceSpan traceSpan("mark control paths");
+                    ControlPathAnalyzer pathAnalyzer;
+                    pathAnalyzer.MarkControlPaths(program);
+                }
 
-            /* Convert AST for GLSL code generation */
-            {
-                GLSLConverter converter;
-                converter.Convert(program, inputDesc.shaderTarget, outputDesc.formatting.prefix);
-            }
+                /* Mark all reachable AST nodes, so the conversion can skip unreachable (and undecorated) functions */
+                {
+                    TraceSpan traceSpan("mark references");
+                    ReferenceAnalyzer refAnalyzer;
+                    refAnalyzer.MarkReferencesFromEntryPoint(program);
+                }
 
-            /* Mark all reachable AST nodes */
+                /* Collect reflection data (if requested) before the conversion,
+                   since the conversion removes the separate sampler objects (GLSL uses combined texture samplers) */
+                if (outputDesc.reflectionData)
+                {
+                    ReflectionAnalyzer reflectionAnalyzer;
+                    reflectionAnalyzer.CollectReflection(program, shaderTarget_, *outputDesc.reflectionData);
+
+                    CostEstimator costEstimator;
+                    costEstimator.EstimateCosts(program, outputDesc.reflectionData->functionCosts);
+                }
+
+                /* Convert AST for GLSL code generation, with the extension agent fused into the same traversal */
+                {
+                    TraceSpan traceSpan("convert ast");
+                    GLSLConverter converter;
+                    GLSLExtensionAgent extensionAgent;
+
+                    extensionAgent.PrepareCollection(versionOut_, shaderTarget_, allowExtensions_, explicitBinding_);
+                    converter.Fuse(&extensionAgent);
+
+                    /*
+                    Detach all unreachable global declarations, so the remaining passes only traverse live code.
+                    The detached resource declarations still count for the extension and version requirements
+                    (e.g. an unused constant buffer raises the minimum GLSL version), so they are dispatched to
+                    the extension agent directly; unlike function bodies, their members are fully decorated.
+                    */
+                    PruneUnreachableGlobalStmnts(program);
+
+                    for (const auto& stmnt : program.prunedGlobalStmnts)
+                    {
+                        if (auto bufferDeclStmnt = stmnt->As<BufferDeclStmnt>())
+                        {
+                            stmnt->Visit(&extensionAgent);
+                            for (const auto& member : bufferDeclStmnt->members)
+                                member->Visit(&extensionAgent);
+                        }
+                        else if (stmnt->Type() == AST::Types::TextureDeclStmnt)
+                            stmnt->Visit(&extensionAgent);
+                    }
+
+                    converter.Convert(program, inputDesc.shaderTarget, outputDesc.formatting.prefix, minify_);
+
+                    requiredExtensions_ = extensionAgent.CollectedExtensions(versionOut_);
+
+                    /* Keep the version independent extension requirements, so further output versions need no renewed traversal */
+                    extensionAgent.StoreExtensionUsage(program);
+                }
+
+                /* Mark all AST nodes that became reachable through the conversion */
+                {
+                    TraceSpan traceSpan("re-mark references");
+                    ReferenceAnalyzer refAnalyzer;
+                    refAnalyzer.MarkReferencesFromEntryPoint(program);
+                }
+
+                /*
+                The conversion is independent of the output shader version, so further generator runs
+                (e.g. for other GLSL versions) emit from the already converted program (see CompileShaderVariants)
+                */
+                program.flags << Program::isConvertedGLSL;
+            }
+            else
             {
-                ReferenceAnalyzer refAnalyzer;
-                refAnalyzer.MarkReferencesFromEntryPoint(program);
+                /* The program was already converted (e.g. for another output version) -> only resolve
+                   the recorded extension requirements against the new target version */
+                GLSLExtensionAgent extensionAgent;
+
+                extensionAgent.PrepareCollection(versionOut_, shaderTarget_, allowExtensions_, explicitBinding_);
+                extensionAgent.CollectExtensionsFromUsage(program);
+
+                requiredExtensions_ = extensionAgent.CollectedExtensions(versionOut_);
+
+                /* Collect reflection data on a best-effort basis;
+                   the separate sampler objects were already removed by the conversion */
+                if (outputDesc.reflectionData)
+                {
+                    ReflectionAnalyzer reflectionAnalyzer;
+                    reflectionAnalyzer.CollectReflection(program, shaderTarget_, *outputDesc.reflectionData);
+
+                    CostEstimator costEstimator;
+                    costEstimator.EstimateCosts(program, outputDesc.reflectionData->functionCosts);
+                }
             }
 
             /* Write header */
@@ -77,10 +165,13 @@ void GLSLGenerator::GenerateCodePrimary(
         
             WriteComment("Generated by XShaderCompiler");
 
-            WriteComment(TimePoint());
+            /* The timestamp is the only run-varying piece of the output, so the deterministic mode omits it */
+            if (!outputDesc.options.deterministicOutput)
+                WriteComment(TimePoint());
             Blank();
 
             /* Visit program AST */
+            TraceSpan traceSpan("emit glsl");
             Visit(&program);
         }
         catch (const Report& e)
@@ -105,6 +196,61 @@ void GLSLGenerator::GenerateCodePrimary(
  * ======= Private: =======
  */
 
+void GLSLGenerator::PruneUnreachableGlobalStmnts(Program& program)
+{
+    auto IsUnreachable = [&](const StmntPtr& stmnt) -> bool
+    {
+        switch (stmnt->Type())
+        {
+            case AST::Types::FunctionDecl:
+            {
+                auto funcDecl = static_cast<FunctionDecl*>(stmnt.get());
+                if (funcDecl->flags(AST::isReachable))
+                    return false;
+
+                /* Check for valid control paths before the declaration is detached */
+                if (funcDecl->flags(FunctionDecl::hasNonReturnControlPath))
+                    Warning("not all control paths in unreferenced function '" + funcDecl->ident + "' return a value", funcDecl);
+
+                return true;
+            }
+            case AST::Types::BufferDeclStmnt:
+            case AST::Types::TextureDeclStmnt:
+            {
+                return (!stmnt->flags(AST::isReachable));
+            }
+            case AST::Types::StructDeclStmnt:
+            {
+                auto structDeclStmnt = static_cast<StructDeclStmnt*>(stmnt.get());
+                return (!structDeclStmnt->structDecl->flags(AST::isReachable));
+            }
+            default:
+            {
+                /* Keep all other global statements (e.g. variable declarations are always generated) */
+                return false;
+            }
+        }
+    };
+
+    /*
+    Retain ownership of the detached statements: reachable nodes may still reference into them
+    (e.g. a structure dereferences its unreachable base structure to collect the member type
+    denoters for a struct constructor cast), so they must stay alive, just without emission.
+    */
+    std::vector<StmntPtr> liveStmnts;
+    liveStmnts.reserve(program.globalStmnts.size());
+
+    for (auto& stmnt : program.globalStmnts)
+    {
+        if (IsUnreachable(stmnt))
+            program.prunedGlobalStmnts.push_back(std::move(stmnt));
+        else
+            liveStmnts.push_back(std::move(stmnt));
+    }
+
+    program.globalStmnts = std::move(liveStmnts);
+}
+
 bool GLSLGenerator::MustResolveStruct(StructDecl* ast) const
 {
     return MustResolveStructForTarget(shaderTarget_, ast);
@@ -120,11 +266,7 @@ std::unique_ptr<std::string> GLSLGenerator::SystemValueToKeyword(const IndexedSe
 
 bool GLSLGenerator::IsWrappedIntrinsic(const Intrinsic intrinsic) const
 {
-    static const std::set<Intrinsic> wrappedIntrinsics
-    {
-        Intrinsic::Clip
-    };
-    return (wrappedIntrinsics.find(intrinsic) != wrappedIntrinsics.end());
+    return IntrinsicToGLSL(intrinsic).wrapper;
 }
 
 /* ------- Visit functions ------- */
@@ -162,16 +304,31 @@ IMPLEMENT_VISIT_PROC(CodeBlock)
 
 IMPLEMENT_VISIT_PROC(FunctionCall)
 {
-    if (ast->intrinsic == Intrinsic::Mul)
-        WriteFunctionCallIntrinsicMul(ast);
-    else if (ast->intrinsic == Intrinsic::Rcp)
-        WriteFunctionCallIntrinsicRcp(ast);
-    else if (ast->intrinsic == Intrinsic::Clip && ast->flags(FunctionCall::canInlineIntrinsicWrapper))
-        WriteFunctionCallIntrinsicClip(ast);
-    else if (ast->intrinsic >= Intrinsic::InterlockedAdd && ast->intrinsic <= Intrinsic::InterlockedXor)
-        WriteFunctionCallIntrinsicAtomic(ast);
-    else
-        WriteFunctionCallStandard(ast);
+    /* Dispatch the emission by the argument rewrite rule of the intrinsic (a single dense table load) */
+    switch (IntrinsicToGLSL(ast->intrinsic).argRewrite)
+    {
+        case GLSLIntrinsicEntry::ArgRewrite::Mul:
+            WriteFunctionCallIntrinsicMul(ast);
+            break;
+        case GLSLIntrinsicEntry::ArgRewrite::Rcp:
+            WriteFunctionCallIntrinsicRcp(ast);
+            break;
+        case GLSLIntrinsicEntry::ArgRewrite::Clip:
+            if (ast->flags(FunctionCall::canInlineIntrinsicWrapper))
+            {
+                WriteFunctionCallIntrinsicClip(ast);
+                break;
+            }
+            /* Otherwise the call goes through the generated wrapper function (see IsWrappedIntrinsic) */
+            WriteFunctionCallStandard(ast);
+            break;
+        case GLSLIntrinsicEntry::ArgRewrite::Atomic:
+            WriteFunctionCallIntrinsicAtomic(ast);
+            break;
+        default:
+            WriteFunctionCallStandard(ast);
+            break;
+    }
 }
 
 IMPLEMENT_VISIT_PROC(SwitchCase)
@@ -277,7 +434,9 @@ IMPLEMENT_VISIT_PROC(FunctionDecl)
         else
         {
             Visit(ast->returnType);
-            Write(" " + ast->ident + "(");
+            Write(' ');
+            Write(ast->ident);
+            Write('(');
 
             /* Write parameters */
             for (size_t i = 0; i < ast->parameters.size(); ++i)
@@ -356,7 +515,10 @@ IMPLEMENT_VISIT_PROC(BufferDeclStmnt)
         if (auto slotRegister = Register::GetForTarget(ast->slotRegisters, shaderTarget_))
         {
             if (explicitBinding_)
-                Write(", binding = " + std::to_string(slotRegister->slot));
+            {
+                Write(", binding = ");
+                Write(std::to_string(slotRegister->slot));
+            }
             binding = slotRegister->slot;
         }
 
@@ -369,9 +531,33 @@ IMPLEMENT_VISIT_PROC(BufferDeclStmnt)
     }
     EndLn();
 
+    /*
+    Determine the number of members to write: trailing unreferenced members can be removed without
+    affecting the offsets of the remaining members, while unreferenced members in front of a
+    referenced member must be kept as padding (see Options::trimUniforms)
+    */
+    auto numMembers = ast->members.size();
+
+    if (trimUniforms_)
+    {
+        auto IsMemberReferenced = [](const VarDeclStmntPtr& member)
+        {
+            for (const auto& varDecl : member->varDecls)
+            {
+                if (varDecl->flags(AST::isReachable))
+                    return true;
+            }
+            return false;
+        };
+
+        while (numMembers > 0 && !IsMemberReferenced(ast->members[numMembers - 1]))
+            --numMembers;
+    }
+
     WriteScopeOpen();
     {
-        Visit(ast->members);
+        for (std::size_t i = 0; i < numMembers; ++i)
+            Visit(ast->members[i]);
     }
     WriteScopeClose(false, true);
 
@@ -401,7 +587,11 @@ IMPLEMENT_VISIT_PROC(TextureDeclStmnt)
                 if (auto slotRegister = Register::GetForTarget(texDecl->slotRegisters, shaderTarget_))
                 {
                     if (explicitBinding_)
-                        Write("layout(binding = " + std::to_string(slotRegister->slot) + ") ");
+                    {
+                        Write("layout(binding = ");
+                        Write(std::to_string(slotRegister->slot));
+                        Write(") ");
+                    }
                     binding = slotRegister->slot;
                 }
 
@@ -413,7 +603,10 @@ IMPLEMENT_VISIT_PROC(TextureDeclStmnt)
                 else if (IsUIntType(ast->colorType))
                     Write("u");
 
-                Write(*samplerType + " " + texDecl->ident + ";");
+                Write(samplerType);
+                Write(' ');
+                Write(texDecl->ident);
+                Write(';');
 
                 /* Track output statistics */
                 if (stats_)
@@ -490,7 +683,10 @@ IMPLEMENT_VISIT_PROC(VarDeclStmnt)
     {
         auto keyword = StorageClassToGLSLKeyword(storageClass);
         if (keyword)
-            Write(*keyword + " ");
+        {
+            Write(keyword);
+            Write(' ');
+        }
         else
             Error("not all storage classes or interpolation modifiers can be mapped to GLSL keyword", ast);
     }
@@ -499,7 +695,7 @@ IMPLEMENT_VISIT_PROC(VarDeclStmnt)
     for (const auto& modifier : ast->typeModifiers)
     {
         if (modifier == "const")
-            Write(modifier + " ");
+            Write("const ");
     }
 
     /* Write variable type */
@@ -727,6 +923,10 @@ IMPLEMENT_VISIT_PROC(TypeNameExpr)
 
 IMPLEMENT_VISIT_PROC(TernaryExpr)
 {
+    /* Splice the original source text, if the sub tree was left untouched by the converter */
+    if (WriteSourcePassthroughExpr(ast))
+        return;
+
     Visit(ast->condExpr);
     Write(" ? ");
     Visit(ast->thenExpr);
@@ -736,6 +936,10 @@ IMPLEMENT_VISIT_PROC(TernaryExpr)
 
 IMPLEMENT_VISIT_PROC(BinaryExpr)
 {
+    /* Splice the original source text, if the sub tree was left untouched by the converter */
+    if (WriteSourcePassthroughExpr(ast))
+        return;
+
     Visit(ast->lhsExpr);
     Write(" " + BinaryOpToString(ast->op) + " ");
     Visit(ast->rhsExpr);
@@ -821,6 +1025,14 @@ IMPLEMENT_VISIT_PROC(InitializerExpr)
     Write(" }");
 }
 
+IMPLEMENT_VISIT_PROC(LiteralBlobExpr)
+{
+    /* Write all literal elements through verbatim (see LiteralBlobExpr) */
+    Write("{ ");
+    Write(ast->values);
+    Write(" }");
+}
+
 #undef IMPLEMENT_VISIT_PROC
 
 /* --- Helper functions for code generation --- */
@@ -829,6 +1041,10 @@ IMPLEMENT_VISIT_PROC(InitializerExpr)
 
 void GLSLGenerator::WriteComment(const std::string& text)
 {
+    /* Minified output carries no comments */
+    if (minify_)
+        return;
+
     std::size_t start = 0, end = 0;
 
     while (end < text.size())
@@ -936,29 +1152,16 @@ void GLSLGenerator::WriteScopeClose(bool compact, bool semicolon)
 
 void GLSLGenerator::WriteProgramHeader()
 {
-    try
-    {
-        /* Determine all required GLSL extensions with the GLSL extension agent */
-        GLSLExtensionAgent extensionAgent;
-        auto requiredExtensions = extensionAgent.DetermineRequiredExtensions(
-            *GetProgram(), versionOut_, shaderTarget_, allowExtensions_, explicitBinding_
-        );
-
-        /* Write GLSL version */
-        WriteProgramHeaderVersion(static_cast<int>(versionOut_));
-        Blank();
+    /* Write GLSL version */
+    WriteProgramHeaderVersion(static_cast<int>(versionOut_));
+    Blank();
 
-        /* Write all required extensions */
-        if (!requiredExtensions.empty())
-        {
-            for (const auto& ext : requiredExtensions)
-                WriteProgramHeaderExtension(ext);
-            Blank();
-        }
-    }
-    catch (const std::exception& e)
+    /* Write all required extensions (collected during the AST conversion) */
+    if (!requiredExtensions_.empty())
     {
-        Error(e.what());
+        for (const auto& ext : requiredExtensions_)
+            WriteProgramHeaderExtension(ext);
+        Blank();
     }
 }
 
@@ -1299,7 +1502,7 @@ static TypeDenoterPtr GetTypeDenoterForSuffixVarIdent(const TypeDenoter& lhsType
         /* Get type denoter from vector subscript */
         auto lhsBaseTypeDen = lhsTypeDen.As<BaseTypeDenoter>();
         auto subscriptDataType = SubscriptDataType(lhsBaseTypeDen->dataType, ast->ident);
-        return std::make_shared<BaseTypeDenoter>(subscriptDataType);
+        return GetCanonicalBaseTypeDenoter(subscriptDataType);
     }
     else
     {
@@ -1350,6 +1553,137 @@ void GLSLGenerator::WriteSuffixVarIdentEnd(const TypeDenoter& lhsTypeDen, VarIde
     }
 }
 
+/* --- Source passthrough --- */
+
+// Returns the specified single-line text with all white space characters removed (for the passthrough verification).
+static std::string StripWhiteSpaces(std::string text)
+{
+    text.erase(
+        std::remove_if(
+            text.begin(), text.end(),
+            [](char chr) { return (chr == ' ' || chr == '\t'); }
+        ),
+        text.end()
+    );
+    return text;
+}
+
+bool GLSLGenerator::WriteSourcePassthroughExpr(Expr* ast)
+{
+    /* Minified output collapses white spaces anyway, and the verification itself must emit structurally */
+    if (minify_ || isVerifyingPassthrough_)
+        return false;
+
+    auto sourceCode = GetProgram()->sourceCode.get();
+    if (!sourceCode)
+        return false;
+
+    /* Fetch the original text of the entire sub tree (this rejects areas which span multiple lines) */
+    std::string text;
+    if (!sourceCode->FetchText(ast->area, text) || text.find('\n') != std::string::npos)
+        return false;
+
+    /* Only splice the text if every node of the sub tree would be emitted with its original spelling */
+    if (!IsSourcePassthroughExpr(ast))
+        return false;
+
+    /*
+    The leaf comparison alone is not sufficient: tokens which originate from a macro expansion carry
+    source positions inside the macro definition, so the fetched text is the definition body rather
+    than the expanded expression, and a source area may also reach one token too far (e.g. into the
+    closing ']' of an array dimension). Therefore emit the sub tree structurally first, and only
+    replace that emission by the fetched text if both spell the same expression (ignoring white
+    spaces), i.e. the fetched text round-trips.
+    */
+    const auto mark = OutputMark();
+
+    isVerifyingPassthrough_ = true;
+    Visit(ast);
+    isVerifyingPassthrough_ = false;
+
+    if (StripWhiteSpaces(CapturedOutput(mark)) == StripWhiteSpaces(text))
+    {
+        RollbackOutput(mark);
+        Write(text);
+    }
+
+    return true;
+}
+
+/*
+The sub tree qualifies for the source passthrough if each node either has a language independent
+spelling (operators and brackets), or its output spelling equals its original source text.
+The latter comparison is what detects conversions: an identifier that was renamed (e.g. name
+mangling of reserved words) or a literal whose value was rewritten (e.g. a 'half' suffix)
+no longer matches the text its source area refers to, and converter-generated nodes have no
+valid source area at all.
+*/
+bool GLSLGenerator::IsSourcePassthroughExpr(Expr* ast)
+{
+    switch (ast->Type())
+    {
+        case AST::Types::LiteralExpr:
+        {
+            auto literalExpr = static_cast<LiteralExpr*>(ast);
+            std::string text;
+            return (GetProgram()->sourceCode->FetchText(literalExpr->area, text) && text == literalExpr->value);
+        }
+
+        case AST::Types::VarAccessExpr:
+        {
+            auto varAccessExpr = static_cast<VarAccessExpr*>(ast);
+            auto varIdent = varAccessExpr->varIdent.get();
+
+            /* Only plain reads of a single identifier (no swizzles, array accesses, or assignments) */
+            if (varAccessExpr->assignExpr || !varIdent || varIdent->next || !varIdent->arrayIndices.empty())
+                return false;
+
+            std::string text;
+            return (GetProgram()->sourceCode->FetchText(varIdent->area, text) && text == FinalIdentFromVarIdent(varIdent));
+        }
+
+        case AST::Types::BracketExpr:
+            return IsSourcePassthroughExpr(static_cast<BracketExpr*>(ast)->expr.get());
+
+        case AST::Types::UnaryExpr:
+        {
+            auto unaryExpr = static_cast<UnaryExpr*>(ast);
+            return (unaryExpr->op != UnaryOp::Undefined && IsSourcePassthroughExpr(unaryExpr->expr.get()));
+        }
+
+        case AST::Types::PostUnaryExpr:
+        {
+            auto postUnaryExpr = static_cast<PostUnaryExpr*>(ast);
+            return (postUnaryExpr->op != UnaryOp::Undefined && IsSourcePassthroughExpr(postUnaryExpr->expr.get()));
+        }
+
+        case AST::Types::BinaryExpr:
+        {
+            auto binaryExpr = static_cast<BinaryExpr*>(ast);
+            return
+            (
+                binaryExpr->op != BinaryOp::Undefined &&
+                IsSourcePassthroughExpr(binaryExpr->lhsExpr.get()) &&
+                IsSourcePassthroughExpr(binaryExpr->rhsExpr.get())
+            );
+        }
+
+        case AST::Types::TernaryExpr:
+        {
+            auto ternaryExpr = static_cast<TernaryExpr*>(ast);
+            return
+            (
+                IsSourcePassthroughExpr(ternaryExpr->condExpr.get()) &&
+                IsSourcePassthroughExpr(ternaryExpr->thenExpr.get()) &&
+                IsSourcePassthroughExpr(ternaryExpr->elseExpr.get())
+            );
+        }
+
+        default:
+            return false;
+    }
+}
+
 /* --- Type denoter --- */
 
 void GLSLGenerator::WriteDataType(DataType dataType, const AST* ast)
@@ -1360,7 +1694,7 @@ void GLSLGenerator::WriteDataType(DataType dataType, const AST* ast)
 
     /* Map GLSL data type */
     if (auto keyword = DataTypeToGLSLKeyword(dataType))
-        Write(*keyword);
+        Write(keyword);
     else
         Error("failed to map data type to GLSL keyword", ast);
 }
@@ -1393,7 +1727,7 @@ void GLSLGenerator::WriteTypeDenoter(const TypeDenoter& typeDenoter, const AST*
 
             /* Convert texture type to GLSL sampler type */
             if (auto keyword = BufferTypeToGLSLKeyword(textureType))
-                Write(*keyword);
+                Write(keyword);
             else
                 Error("failed to map texture type to GLSL keyword", ast);
         }
@@ -1647,6 +1981,13 @@ void GLSLGenerator::WriteWrapperIntrinsics()
 
 void GLSLGenerator::WriteWrapperIntrinsicsClip(const IntrinsicUsage& usage)
 {
+    /* Register wrappers in the shared preamble instead of the output code (if enabled) */
+    if (wrapperPreamble_ != nullptr)
+    {
+        RegisterClipWrappersInPreamble(usage);
+        return;
+    }
+
     //TODO: make this boolean optional for the user
     bool writeCompact = true;
 
@@ -1701,6 +2042,59 @@ void GLSLGenerator::WriteWrapperIntrinsicsClip(const IntrinsicUsage& usage)
         Blank();
 }
 
+void GLSLGenerator::RegisterClipWrappersInPreamble(const IntrinsicUsage& usage)
+{
+    for (const auto& argList : usage.argLists)
+    {
+        auto arg0Type = (!argList.argTypes.empty() ? argList.argTypes.front() : DataType::Undefined);
+
+        if (IsScalarType(arg0Type) || IsVectorType(arg0Type))
+        {
+            /* Replace doubles with floats, if doubles are not supported (as in WriteDataType) */
+            if (versionOut_ < OutputShaderVersion::GLSL400)
+                arg0Type = DoubleToFloatDataType(arg0Type);
+
+            auto keyword = DataTypeToGLSLKeyword(arg0Type);
+            if (!keyword)
+            {
+                Error("failed to map data type to GLSL keyword");
+                continue;
+            }
+
+            /* Build wrapper signature, which also keys the preamble entry */
+            std::string signature = "void clip(";
+            signature += keyword;
+            signature += " x)";
+
+            if (wrapperPreamble_->HasWrapper(signature))
+                continue;
+
+            /* Build wrapper function in the compact formatting (all in one line) */
+            std::string code = signature;
+            code += " { if (";
+
+            if (IsScalarType(arg0Type))
+            {
+                code += "x < 0";
+                if (arg0Type == DataType::UInt)
+                    code += 'u';
+                else if (arg0Type == DataType::Float)
+                    code += ".0f";
+            }
+            else
+            {
+                code += "any(lessThan(x, ";
+                code += keyword;
+                code += "(0)))";
+            }
+
+            code += ") { discard; } }\n";
+
+            wrapperPreamble_->AddWrapper(signature, code);
+        }
+    }
+}
+
 /* --- Structure --- */
 
 bool GLSLGenerator::WriteStructDecl(StructDecl* ast, bool writeSemicolon, bool allowNestedStruct)
@@ -1724,7 +2118,8 @@ bool GLSLGenerator::WriteStructDecl(StructDecl* ast, bool writeSemicolon, bool a
     {
         /* Do not end line here with "EndLn" */
         BeginLn();
-        Write(ast->ident + " ");
+        Write(ast->ident);
+        Write(' ');
     }
     return false;
 }
@@ -1736,7 +2131,10 @@ bool GLSLGenerator::WriteStructDeclStandard(StructDecl* ast, bool writeSemicolon
     {
         Write("struct");
         if (!ast->ident.empty())
-            Write(' ' + ast->ident);
+        {
+            Write(' ');
+            Write(ast->ident);
+        }
     }
     EndLn();
 
@@ -1777,7 +2175,12 @@ bool GLSLGenerator::WriteStructDeclInputOutputBlock(StructDecl* ast)
     }
     WriteScopeClose();
 
-    WriteLn(ast->aliasName + ";");
+    BeginLn();
+    {
+        Write(ast->aliasName);
+        Write(';');
+    }
+    EndLn();
 
     return true;
 }
@@ -1827,12 +2230,15 @@ void GLSLGenerator::WriteParameter(VarDeclStmnt* ast)
 {
     /* Write modifiers */
     if (!ast->inputModifier.empty())
-        Write(ast->inputModifier + " ");
+    {
+        Write(ast->inputModifier);
+        Write(' ');
+    }
 
     for (const auto& modifier : ast->typeModifiers)
     {
         if (modifier == "const")
-            Write(modifier + " ");
+            Write("const ");
     }
 
     /* Write parameter type */
@@ -15,6 +15,7 @@
 #include "Token.h"
 #include "ASTEnums.h"
 #include <map>
+#include <set>
 #include <vector>
 
 
@@ -43,6 +44,9 @@ class GLSLGenerator : public Generator
             const ShaderOutput& outputDesc
         ) override;
 
+        // Detaches all global declaration statements from the program which are not reachable from the entry point.
+        void PruneUnreachableGlobalStmnts(Program& program);
+
         // Returns true if the specified AST structure must be resolved.
         bool MustResolveStruct(StructDecl* ast) const;
 
@@ -97,6 +101,7 @@ class GLSLGenerator : public Generator
         DECL_VISIT_PROC( CastExpr          );
         DECL_VISIT_PROC( VarAccessExpr     );
         DECL_VISIT_PROC( InitializerExpr   );
+        DECL_VISIT_PROC( LiteralBlobExpr   );
 
         /* --- Helper functions for code generation --- */
 
@@ -160,6 +165,17 @@ class GLSLGenerator : public Generator
         void WriteSuffixVarIdentBegin(const TypeDenoter& lhsTypeDen, VarIdent* ast);
         void WriteSuffixVarIdentEnd(const TypeDenoter& lhsTypeDen, VarIdent* ast);
 
+        /* --- Source passthrough --- */
+
+        /*
+        Writes the original source text of the specified expression, if its sub tree was left
+        untouched by the converter (see IsSourcePassthroughExpr). Returns false otherwise.
+        */
+        bool WriteSourcePassthroughExpr(Expr* ast);
+
+        // Returns true if each node of the specified expression sub tree would be emitted with its original source spelling.
+        bool IsSourcePassthroughExpr(Expr* ast);
+
         /* --- Type denoter --- */
 
         void WriteDataType(DataType dataType, const AST* ast = nullptr);
@@ -180,6 +196,7 @@ class GLSLGenerator : public Generator
         // Writes all required wrapper functions for referenced intrinsics.
         void WriteWrapperIntrinsics();
         void WriteWrapperIntrinsicsClip(const IntrinsicUsage& usage);
+        void RegisterClipWrappersInPreamble(const IntrinsicUsage& usage);
 
         /* --- Structure --- */
 
@@ -207,16 +224,27 @@ class GLSLGenerator : public Generator
         OutputShaderVersion versionOut_             = OutputShaderVersion::GLSL;
         bool                allowExtensions_        = false;
         bool                explicitBinding_        = false;
+        bool                trimUniforms_           = false;
         bool                preserveComments_       = false;
         bool                allowLineMarks_         = false;
         bool                compactWrappers_        = true;
         bool                newLineOpenScope_       = true;
+        bool                minify_                 = false;
         std::string         nameManglingPrefix_     = "xsc_";
         Statistics*         stats_                  = nullptr;
 
+        // Shared preamble that receives the intrinsic wrapper functions instead of the output code (may be null).
+        WrapperPreamble*    wrapperPreamble_        = nullptr;
+
         bool                isInsideEntryPoint_     = false;
         bool                isInsideInterfaceBlock_ = false;
 
+        // Specifies whether a sub tree is currently emitted to verify a source passthrough (see WriteSourcePassthroughExpr).
+        bool                isVerifyingPassthrough_ = false;
+
+        // Required GLSL extensions, collected during the AST conversion (see GLSLExtensionAgent).
+        std::set<std::string> requiredExtensions_;
+
 };
 
 
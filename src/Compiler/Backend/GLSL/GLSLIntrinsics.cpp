@@ -6,191 +6,238 @@
  */
 
 #include "GLSLIntrinsics.h"
-#include <map>
 
 
 namespace Xsc
 {
 
 
-static std::map<Intrinsic, std::string> GenerateIntrinsicMap()
+static std::vector<GLSLIntrinsicEntry> GenerateIntrinsicTable()
 {
     using T = Intrinsic;
+    using ArgRewrite = GLSLIntrinsicEntry::ArgRewrite;
 
-    return
+    /* One entry per enumerator, so lookups index the table directly (see IntrinsicToGLSL) */
+    std::vector<GLSLIntrinsicEntry> table(static_cast<std::size_t>(T::Texture_SampleLevel_5) + 1);
+
+    auto Keyword = [&table](T intr, const char* keyword)
+    {
+        table[static_cast<std::size_t>(intr)].keyword = keyword;
+    };
+
+    auto Rewrite = [&table](T intr, ArgRewrite argRewrite)
+    {
+        table[static_cast<std::size_t>(intr)].argRewrite = argRewrite;
+    };
+
+    auto Wrapper = [&table](T intr)
     {
-      //{ T::Abort,                             ""                      },
-        { T::Abs,                               "abs"                   },
-        { T::ACos,                              "acos"                  },
-        { T::All,                               "all"                   },
-        { T::AllMemoryBarrier,                  "memoryBarrier"         },
-      //{ T::AllMemoryBarrierWithGroupSync,     "barrier"               }, //???
-        { T::Any,                               "any"                   },
-      //{ T::AsDouble,                          ""                      },
-      //{ T::AsFloat,                           ""                      },
-        { T::ASin,                              "asin"                  },
-      //{ T::AsInt,                             ""                      },
-      //{ T::AsUInt_1,                          ""                      },
-      //{ T::AsUInt_3,                          ""                      },
-        { T::ATan,                              "atan"                  },
-        { T::ATan2,                             "atan"                  },
-        { T::Ceil,                              "ceil"                  },
-      //{ T::CheckAccessFullyMapped,            ""                      },
-        { T::Clamp,                             "clamp"                 },
-      //{ T::Clip,                              ""                      },
-        { T::Cos,                               "cos"                   },
-        { T::CosH,                              "cosh"                  },
-        { T::CountBits,                         ""                      },
-        { T::Cross,                             "cross"                 },
-      //{ T::D3DCOLORtoUBYTE4,                  ""                      },
-        { T::DDX,                               "dFdx"                  },
-        { T::DDXCoarse,                         "dFdxCoarse"            },
-        { T::DDXFine,                           "dFdxFine"              },
-        { T::DDY,                               "dFdy"                  },
-        { T::DDYCoarse,                         "dFdyCoarse"            },
-        { T::DDYFine,                           "dFdyFine"              },
-        { T::Degrees,                           "degrees"               },
-        { T::Determinant,                       "determinant"           },
-      //{ T::DeviceMemoryBarrier,               ""                      }, // memoryBarrier, memoryBarrierImage, memoryBarrierImage, and barrier
-      //{ T::DeviceMemoryBarrierWithGroupSync,  ""                      }, // memoryBarrier, memoryBarrierImage, memoryBarrierImage
-        { T::Distance,                          "distance"              },
-        { T::Dot,                               "dot"                   },
-      //{ T::Dst,                               ""                      },
-      //{ T::ErrorF,                            ""                      },
-        { T::EvaluateAttributeAtCentroid,       "interpolateAtCentroid" },
-        { T::EvaluateAttributeAtSample,         "interpolateAtSample"   },
-        { T::EvaluateAttributeSnapped,          "interpolateAtOffset"   },
-        { T::Exp,                               "exp"                   },
-        { T::Exp2,                              "exp2"                  },
-      //{ T::F16toF32,                          ""                      },
-      //{ T::F32toF16,                          ""                      },
-        { T::FaceForward,                       "faceforward"           },
-        { T::FirstBitHigh,                      "findMSB"               },
-        { T::FirstBitLow,                       "findLSB"               },
-        { T::Floor,                             "floor"                 },
-        { T::FMA,                               "fma"                   },
-        { T::FMod,                              "mod"                   },
-        { T::Frac,                              "fract"                 },
-        { T::FrExp,                             "frexp"                 },
-        { T::FWidth,                            "fwidth"                },
-      //{ T::GetRenderTargetSampleCount,        ""                      },
-      //{ T::GetRenderTargetSamplePosition,     ""                      },
-        { T::GroupMemoryBarrier,                "groupMemoryBarrier"    },
-      //{ T::GroupMemoryBarrierWithGroupSync,   "barrier"               }, // -> groupMemoryBarrier and barrier
-        { T::InterlockedAdd,                    "atomicAdd"             },
-        { T::InterlockedAnd,                    "atomicAnd"             },
-        { T::InterlockedCompareExchange,        "atomicCompSwap"        },
-      //{ T::InterlockedCompareStore,           ""                      },
-        { T::InterlockedExchange,               "atomicExchange"        },
-        { T::InterlockedMax,                    "atomicMax"             },
-        { T::InterlockedMin,                    "atomicMin"             },
-        { T::InterlockedOr,                     "atomicOr"              },
-        { T::InterlockedXor,                    "atomicXor"             },
-      //{ T::IsFinite,                          ""                      },
-        { T::IsInf,                             "isinf"                 },
-        { T::IsNaN,                             "isnan"                 },
-        { T::LdExp,                             "ldexp"                 },
-        { T::Length,                            "length"                },
-        { T::Lerp,                              "mix"                   },
-      //{ T::Lit,                               ""                      },
-        { T::Log,                               "log"                   },
-      //{ T::Log10,                             ""                      },
-        { T::Log2,                              "log2"                  },
-        { T::MAD,                               "fma"                   },
-        { T::Max,                               "max"                   },
-        { T::Min,                               "min"                   },
-        { T::ModF,                              "modf"                  },
-      //{ T::MSAD4,                             ""                      },
-      //{ T::Mul,                               ""                      },
-        { T::Noise,                             "noise"                 },
-        { T::Normalize,                         "normalize"             },
-        { T::Pow,                               "pow"                   },
-      //{ T::PrintF,                            ""                      },
-      //{ T::Process2DQuadTessFactorsAvg,       ""                      },
-      //{ T::Process2DQuadTessFactorsMax,       ""                      },
-      //{ T::Process2DQuadTessFactorsMin,       ""                      },
-      //{ T::ProcessIsolineTessFactors,         ""                      },
-      //{ T::ProcessQuadTessFactorsAvg,         ""                      },
-      //{ T::ProcessQuadTessFactorsMax,         ""                      },
-      //{ T::ProcessQuadTessFactorsMin,         ""                      },
-      //{ T::ProcessTriTessFactorsAvg,          ""                      },
-      //{ T::ProcessTriTessFactorsMax,          ""                      },
-      //{ T::ProcessTriTessFactorsMin,          ""                      },
-        { T::Radians,                           "radians"               },
-      //{ T::Rcp,                               ""                      },
-        { T::Reflect,                           "reflect"               },
-        { T::Refract,                           "refract"               },
-      //{ T::ReverseBits,                       ""                      },
-        { T::Round,                             "round"                 },
-        { T::RSqrt,                             "inversesqrt"           },
-      //{ T::Saturate,                          ""                      },
-        { T::Sign,                              "sign"                  },
-        { T::Sin,                               "sin"                   },
-      //{ T::SinCos,                            ""                      },
-        { T::SinH,                              "sinh"                  },
-        { T::SmoothStep,                        "smoothstep"            },
-        { T::Sqrt,                              "sqrt"                  },
-        { T::Step,                              "step"                  },
-        { T::Tan,                               "tan"                   },
-        { T::TanH,                              "tanh"                  },
-        { T::Tex1D_2,                           "texture"               },
-        { T::Tex1D_4,                           "texture"               },
-        { T::Tex1DBias,                         "texture"               },
-        { T::Tex1DGrad,                         "textureGrad"           },
-        { T::Tex1DLod,                          "textureLod"            },
-        { T::Tex1DProj,                         "textureProj"           },
-        { T::Tex2D_2,                           "texture"               },
-        { T::Tex2D_4,                           "texture"               },
-        { T::Tex2DBias,                         "texture"               },
-        { T::Tex2DGrad,                         "textureGrad"           },
-        { T::Tex2DLod,                          "textureLod"            },
-        { T::Tex2DProj,                         "textureProj"           },
-        { T::Tex3D_2,                           "texture"               },
-        { T::Tex3D_4,                           "texture"               },
-        { T::Tex3DBias,                         "texture"               },
-        { T::Tex3DGrad,                         "textureGrad"           },
-        { T::Tex3DLod,                          "textureLod"            },
-        { T::Tex3DProj,                         "textureProj"           },
-        { T::TexCube_2,                         "texture"               },
-        { T::TexCube_4,                         "texture"               },
-        { T::TexCubeBias,                       "texture"               },
-        { T::TexCubeGrad,                       "textureGrad"           },
-        { T::TexCubeLod,                        "textureLod"            },
-      //{ T::TexCubeProj,                       ""                      },
-        { T::Transpose,                         "transpose"             },
-        { T::Trunc,                             "trunc"                 },
-
-        { T::Texture_GetDimensions,             "textureSize"           },
-        { T::Texture_Load_1,                    "texelFetch"            },
-        { T::Texture_Load_2,                    "texelFetch"            },
-        { T::Texture_Load_3,                    "texelFetchOffset"      },
-        { T::Texture_Sample_2,                  "texture"               },
-        { T::Texture_Sample_3,                  "textureOffset"         },
-      //{ T::Texture_Sample_4,                  ""                      },
-      //{ T::Texture_Sample_5,                  ""                      },
-        { T::Texture_SampleBias_3,              "texture"               },
-        { T::Texture_SampleBias_4,              "textureOffset"         },
-      //{ T::Texture_SampleBias_5,              ""                      },
-      //{ T::Texture_SampleBias_6,              ""                      },
-      //{ T::Texture_SampleCmp_3,               ""                      },
-      //{ T::Texture_SampleCmp_4,               ""                      },
-      //{ T::Texture_SampleCmp_5,               ""                      },
-      //{ T::Texture_SampleCmp_6,               ""                      },
-        { T::Texture_SampleGrad_4,              "textureGrad"           },
-        { T::Texture_SampleGrad_5,              "textureGradOffset"     },
-      //{ T::Texture_SampleGrad_6,              ""                      },
-      //{ T::Texture_SampleGrad_7,              ""                      },
-        { T::Texture_SampleLevel_3,             "textureLod"            },
-        { T::Texture_SampleLevel_4,             "textureLodOffset"      },
-      //{ T::Texture_SampleLevel_5,             ""                      },
+        table[static_cast<std::size_t>(intr)].wrapper = true;
     };
+
+    /* --- GLSL keywords --- */
+
+  //Keyword( T::Abort,                             ""                      );
+    Keyword( T::Abs,                               "abs"                   );
+    Keyword( T::ACos,                              "acos"                  );
+    Keyword( T::All,                               "all"                   );
+    Keyword( T::AllMemoryBarrier,                  "memoryBarrier"         );
+  //Keyword( T::AllMemoryBarrierWithGroupSync,     "barrier"               ); //???
+    Keyword( T::Any,                               "any"                   );
+  //Keyword( T::AsDouble,                          ""                      );
+  //Keyword( T::AsFloat,                           ""                      );
+    Keyword( T::ASin,                              "asin"                  );
+  //Keyword( T::AsInt,                             ""                      );
+  //Keyword( T::AsUInt_1,                          ""                      );
+  //Keyword( T::AsUInt_3,                          ""                      );
+    Keyword( T::ATan,                              "atan"                  );
+    Keyword( T::ATan2,                             "atan"                  );
+    Keyword( T::Ceil,                              "ceil"                  );
+  //Keyword( T::CheckAccessFullyMapped,            ""                      );
+    Keyword( T::Clamp,                             "clamp"                 );
+  //Keyword( T::Clip,                              ""                      );
+    Keyword( T::Cos,                               "cos"                   );
+    Keyword( T::CosH,                              "cosh"                  );
+    Keyword( T::CountBits,                         ""                      );
+    Keyword( T::Cross,                             "cross"                 );
+  //Keyword( T::D3DCOLORtoUBYTE4,                  ""                      );
+    Keyword( T::DDX,                               "dFdx"                  );
+    Keyword( T::DDXCoarse,                         "dFdxCoarse"            );
+    Keyword( T::DDXFine,                           "dFdxFine"              );
+    Keyword( T::DDY,                               "dFdy"                  );
+    Keyword( T::DDYCoarse,                         "dFdyCoarse"            );
+    Keyword( T::DDYFine,                           "dFdyFine"              );
+    Keyword( T::Degrees,                           "degrees"               );
+    Keyword( T::Determinant,                       "determinant"           );
+  //Keyword( T::DeviceMemoryBarrier,               ""                      ); // memoryBarrier, memoryBarrierImage, memoryBarrierImage, and barrier
+  //Keyword( T::DeviceMemoryBarrierWithGroupSync,  ""                      ); // memoryBarrier, memoryBarrierImage, memoryBarrierImage
+    Keyword( T::Distance,                          "distance"              );
+    Keyword( T::Dot,                               "dot"                   );
+  //Keyword( T::Dst,                               ""                      );
+  //Keyword( T::ErrorF,                            ""                      );
+    Keyword( T::EvaluateAttributeAtCentroid,       "interpolateAtCentroid" );
+    Keyword( T::EvaluateAttributeAtSample,         "interpolateAtSample"   );
+    Keyword( T::EvaluateAttributeSnapped,          "interpolateAtOffset"   );
+    Keyword( T::Exp,                               "exp"                   );
+    Keyword( T::Exp2,                              "exp2"                  );
+  //Keyword( T::F16toF32,                          ""                      );
+  //Keyword( T::F32toF16,                          ""                      );
+    Keyword( T::FaceForward,                       "faceforward"           );
+    Keyword( T::FirstBitHigh,                      "findMSB"               );
+    Keyword( T::FirstBitLow,                       "findLSB"               );
+    Keyword( T::Floor,                             "floor"                 );
+    Keyword( T::FMA,                               "fma"                   );
+    Keyword( T::FMod,                              "mod"                   );
+    Keyword( T::Frac,                              "fract"                 );
+    Keyword( T::FrExp,                             "frexp"                 );
+    Keyword( T::FWidth,                            "fwidth"                );
+  //Keyword( T::GetRenderTargetSampleCount,        ""                      );
+  //Keyword( T::GetRenderTargetSamplePosition,     ""                      );
+    Keyword( T::GroupMemoryBarrier,                "groupMemoryBarrier"    );
+  //Keyword( T::GroupMemoryBarrierWithGroupSync,   "barrier"               ); // -> groupMemoryBarrier and barrier
+    Keyword( T::InterlockedAdd,                    "atomicAdd"             );
+    Keyword( T::InterlockedAnd,                    "atomicAnd"             );
+    Keyword( T::InterlockedCompareExchange,        "atomicCompSwap"        );
+  //Keyword( T::InterlockedCompareStore,           ""                      );
+    Keyword( T::InterlockedExchange,               "atomicExchange"        );
+    Keyword( T::InterlockedMax,                    "atomicMax"             );
+    Keyword( T::InterlockedMin,                    "atomicMin"             );
+    Keyword( T::InterlockedOr,                     "atomicOr"              );
+    Keyword( T::InterlockedXor,                    "atomicXor"             );
+  //Keyword( T::IsFinite,                          ""                      );
+    Keyword( T::IsInf,                             "isinf"                 );
+    Keyword( T::IsNaN,                             "isnan"                 );
+    Keyword( T::LdExp,                             "ldexp"                 );
+    Keyword( T::Length,                            "length"                );
+    Keyword( T::Lerp,                              "mix"                   );
+  //Keyword( T::Lit,                               ""                      );
+    Keyword( T::Log,                               "log"                   );
+  //Keyword( T::Log10,                             ""                      );
+    Keyword( T::Log2,                              "log2"                  );
+    Keyword( T::MAD,                               "fma"                   );
+    Keyword( T::Max,                               "max"                   );
+    Keyword( T::Min,                               "min"                   );
+    Keyword( T::ModF,                              "modf"                  );
+  //Keyword( T::MSAD4,                             ""                      );
+  //Keyword( T::Mul,                               ""                      );
+    Keyword( T::Noise,                             "noise"                 );
+    Keyword( T::Normalize,                         "normalize"             );
+    Keyword( T::Pow,                               "pow"                   );
+  //Keyword( T::PrintF,                            ""                      );
+  //Keyword( T::Process2DQuadTessFactorsAvg,       ""                      );
+  //Keyword( T::Process2DQuadTessFactorsMax,       ""                      );
+  //Keyword( T::Process2DQuadTessFactorsMin,       ""                      );
+  //Keyword( T::ProcessIsolineTessFactors,         ""                      );
+  //Keyword( T::ProcessQuadTessFactorsAvg,         ""                      );
+  //Keyword( T::ProcessQuadTessFactorsMax,         ""                      );
+  //Keyword( T::ProcessQuadTessFactorsMin,         ""                      );
+  //Keyword( T::ProcessTriTessFactorsAvg,          ""                      );
+  //Keyword( T::ProcessTriTessFactorsMax,          ""                      );
+  //Keyword( T::ProcessTriTessFactorsMin,          ""                      );
+    Keyword( T::Radians,                           "radians"               );
+  //Keyword( T::Rcp,                               ""                      );
+    Keyword( T::Reflect,                           "reflect"               );
+    Keyword( T::Refract,                           "refract"               );
+  //Keyword( T::ReverseBits,                       ""                      );
+    Keyword( T::Round,                             "round"                 );
+    Keyword( T::RSqrt,                             "inversesqrt"           );
+  //Keyword( T::Saturate,                          ""                      );
+    Keyword( T::Sign,                              "sign"                  );
+    Keyword( T::Sin,                               "sin"                   );
+  //Keyword( T::SinCos,                            ""                      );
+    Keyword( T::SinH,                              "sinh"                  );
+    Keyword( T::SmoothStep,                        "smoothstep"            );
+    Keyword( T::Sqrt,                              "sqrt"                  );
+    Keyword( T::Step,                              "step"                  );
+    Keyword( T::Tan,                               "tan"                   );
+    Keyword( T::TanH,                              "tanh"                  );
+    Keyword( T::Tex1D_2,                           "texture"               );
+    Keyword( T::Tex1D_4,                           "texture"               );
+    Keyword( T::Tex1DBias,                         "texture"               );
+    Keyword( T::Tex1DGrad,                         "textureGrad"           );
+    Keyword( T::Tex1DLod,                          "textureLod"            );
+    Keyword( T::Tex1DProj,                         "textureProj"           );
+    Keyword( T::Tex2D_2,                           "texture"               );
+    Keyword( T::Tex2D_4,                           "texture"               );
+    Keyword( T::Tex2DBias,                         "texture"               );
+    Keyword( T::Tex2DGrad,                         "textureGrad"           );
+    Keyword( T::Tex2DLod,                          "textureLod"            );
+    Keyword( T::Tex2DProj,                         "textureProj"           );
+    Keyword( T::Tex3D_2,                           "texture"               );
+    Keyword( T::Tex3D_4,                           "texture"               );
+    Keyword( T::Tex3DBias,                         "texture"               );
+    Keyword( T::Tex3DGrad,                         "textureGrad"           );
+    Keyword( T::Tex3DLod,                          "textureLod"            );
+    Keyword( T::Tex3DProj,                         "textureProj"           );
+    Keyword( T::TexCube_2,                         "texture"               );
+    Keyword( T::TexCube_4,                         "texture"               );
+    Keyword( T::TexCubeBias,                       "texture"               );
+    Keyword( T::TexCubeGrad,                       "textureGrad"           );
+    Keyword( T::TexCubeLod,                        "textureLod"            );
+  //Keyword( T::TexCubeProj,                       ""                      );
+    Keyword( T::Transpose,                         "transpose"             );
+    Keyword( T::Trunc,                             "trunc"                 );
+
+    Keyword( T::Texture_GetDimensions,             "textureSize"           );
+    Keyword( T::Texture_Load_1,                    "texelFetch"            );
+    Keyword( T::Texture_Load_2,                    "texelFetch"            );
+    Keyword( T::Texture_Load_3,                    "texelFetchOffset"      );
+    Keyword( T::Texture_Sample_2,                  "texture"               );
+    Keyword( T::Texture_Sample_3,                  "textureOffset"         );
+  //Keyword( T::Texture_Sample_4,                  ""                      );
+  //Keyword( T::Texture_Sample_5,                  ""                      );
+    Keyword( T::Texture_SampleBias_3,              "texture"               );
+    Keyword( T::Texture_SampleBias_4,              "textureOffset"         );
+  //Keyword( T::Texture_SampleBias_5,              ""                      );
+  //Keyword( T::Texture_SampleBias_6,              ""                      );
+  //Keyword( T::Texture_SampleCmp_3,               ""                      );
+  //Keyword( T::Texture_SampleCmp_4,               ""                      );
+  //Keyword( T::Texture_SampleCmp_5,               ""                      );
+  //Keyword( T::Texture_SampleCmp_6,               ""                      );
+    Keyword( T::Texture_SampleGrad_4,              "textureGrad"           );
+    Keyword( T::Texture_SampleGrad_5,              "textureGradOffset"     );
+  //Keyword( T::Texture_SampleGrad_6,              ""                      );
+  //Keyword( T::Texture_SampleGrad_7,              ""                      );
+    Keyword( T::Texture_SampleLevel_3,             "textureLod"            );
+    Keyword( T::Texture_SampleLevel_4,             "textureLodOffset"      );
+  //Keyword( T::Texture_SampleLevel_5,             ""                      );
+
+    /* --- Argument rewrite rules --- */
+
+    Rewrite( T::Mul,                        ArgRewrite::Mul    );
+    Rewrite( T::Rcp,                        ArgRewrite::Rcp    );
+    Rewrite( T::Clip,                       ArgRewrite::Clip   );
+
+    Rewrite( T::InterlockedAdd,             ArgRewrite::Atomic );
+    Rewrite( T::InterlockedAnd,             ArgRewrite::Atomic );
+    Rewrite( T::InterlockedCompareExchange, ArgRewrite::Atomic );
+    Rewrite( T::InterlockedCompareStore,    ArgRewrite::Atomic );
+    Rewrite( T::InterlockedExchange,        ArgRewrite::Atomic );
+    Rewrite( T::InterlockedMax,             ArgRewrite::Atomic );
+    Rewrite( T::InterlockedMin,             ArgRewrite::Atomic );
+    Rewrite( T::InterlockedOr,              ArgRewrite::Atomic );
+    Rewrite( T::InterlockedXor,             ArgRewrite::Atomic );
+
+    /* --- Wrapper functions --- */
+
+    Wrapper( T::Clip );
+
+    return table;
+}
+
+const GLSLIntrinsicEntry& IntrinsicToGLSL(const Intrinsic intr)
+{
+    static const auto intrinsicTable = GenerateIntrinsicTable();
+    static const GLSLIntrinsicEntry defaultEntry;
+
+    const auto idx = static_cast<std::size_t>(intr);
+    return (idx < intrinsicTable.size() ? intrinsicTable[idx] : defaultEntry);
 }
 
 const std::string* IntrinsicToGLSLKeyword(const Intrinsic intr)
 {
-    static const auto intrinsicMap = GenerateIntrinsicMap();
-    auto it = intrinsicMap.find(intr);
-    return (it != intrinsicMap.end() ? &(it->second) : nullptr);
+    const auto& entry = IntrinsicToGLSL(intr);
+    return (!entry.keyword.empty() ? &entry.keyword : nullptr);
 }
 
 
@@ -198,4 +245,4 @@ const std::string* IntrinsicToGLSLKeyword(const Intrinsic intr)
 
 
 
-// ================================================================================
\ No newline at end of file
+// ================================================================================
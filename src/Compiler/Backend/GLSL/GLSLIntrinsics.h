@@ -12,13 +12,35 @@
 #include "Token.h"
 #include "ASTEnums.h"
 #include <string>
+#include <vector>
 
 
 namespace Xsc
 {
 
 
-// Returns GLSL keyword for the specified intrinsic.
+// GLSL emission entry for an intrinsic, stored in a dense table indexed by the Intrinsic enum (see IntrinsicToGLSL).
+struct GLSLIntrinsicEntry
+{
+    // Argument rewrite rule an intrinsic call requires during emission.
+    enum class ArgRewrite
+    {
+        None,   // The arguments are emitted unchanged.
+        Mul,    // "mul(a, b)" is emitted as the infix expression "(a) * (b)".
+        Rcp,    // "rcp(x)" is emitted as the division "(1.0 / (x))" of the respective base type.
+        Clip,   // "clip(x)" is emitted as a conditional 'discard', or through a wrapper function if it can not be inlined.
+        Atomic, // "InterlockedX(dst, v, prev)" is emitted as the assignment "prev = atomicX(dst, v)".
+    };
+
+    std::string keyword;                        // GLSL keyword, or empty if the intrinsic has no direct GLSL counterpart.
+    ArgRewrite  argRewrite  = ArgRewrite::None; // Argument rewrite rule for the emission of a call.
+    bool        wrapper     = false;            // True if calls are emitted through a generated wrapper function (see GLSLGenerator::WriteWrapperIntrinsics).
+};
+
+// Returns the GLSL emission entry for the specified intrinsic (a single dense table load).
+const GLSLIntrinsicEntry& IntrinsicToGLSL(const Intrinsic intr);
+
+// Returns GLSL keyword for the specified intrinsic, or null if it has no direct GLSL counterpart.
 const std::string* IntrinsicToGLSLKeyword(const Intrinsic intr);
 
 
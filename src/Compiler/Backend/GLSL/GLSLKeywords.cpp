@@ -1,6 +1,6 @@
 /*
  * GLSLKeywords.cpp
- * 
+ *
  * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
  * See "LICENSE.txt" for license information.
  */
@@ -8,7 +8,6 @@
 #include "GLSLKeywords.h"
 #include "Helper.h"
 #include <set>
-#include <map>
 
 
 namespace Xsc
@@ -21,11 +20,17 @@ https://anteru.net/blog/2016/mapping-between-hlsl-and-glsl/
 https://msdn.microsoft.com/en-us/windows/uwp/gaming/glsl-to-hlsl-reference
 */
 
-template <typename Key, typename Value>
-const Value* MapTypeToKeyword(const std::map<Key, Value>& typeMap, const Key type)
+/*
+The type enums are dense (beginning with 'Undefined' = 0), so the keyword tables are plain arrays
+of string literals indexed by the enum value. They require no initialization code at startup
+(we are spawned as a short-lived process rather frequently), and each lookup during code emission
+is a single indexed access. Null entries denote types without a GLSL counterpart.
+*/
+template <typename T, std::size_t N>
+const char* MapTypeToKeyword(const char* const (&keywordTable)[N], const T type)
 {
-    auto it = typeMap.find(type);
-    return (it != typeMap.end() ? &(it->second) : nullptr);
+    const auto idx = static_cast<std::size_t>(type);
+    return (idx < N ? keywordTable[idx] : nullptr);
 }
 
 /* ------ GLSL Keywords ----- */
@@ -48,137 +53,169 @@ bool IsGLSLKeyword(const std::string& ident)
 
 /* ----- DataType Mapping ----- */
 
-static std::map<DataType, std::string> GenerateDataTypeMap()
+static const char* const g_dataTypeKeywordsGLSL[] =
 {
-    using T = DataType;
-
-    return
-    {
-        { T::Bool,      "bool"   },
-        { T::Int,       "int"    },
-        { T::UInt,      "uint"   },
-        { T::Half,      "float"  },
-        { T::Float,     "float"  },
-        { T::Double,    "double" },
-
-        { T::Bool2,     "bvec2"  },
-        { T::Bool3,     "bvec3"  },
-        { T::Bool4,     "bvec4"  },
-        { T::Int2,      "ivec2"  },
-        { T::Int3,      "ivec3"  },
-        { T::Int4,      "ivec4"  },
-        { T::UInt2,     "uvec2"  },
-        { T::UInt3,     "uvec3"  },
-        { T::UInt4,     "uvec4"  },
-        { T::Half2,     "vec2"   },
-        { T::Half3,     "vec3"   },
-        { T::Half4,     "vec4"   },
-        { T::Float2,    "vec2"   },
-        { T::Float3,    "vec3"   },
-        { T::Float4,    "vec4"   },
-        { T::Double2,   "dvec2"  },
-        { T::Double3,   "dvec3"  },
-        { T::Double4,   "dvec4"  },
-
-        { T::Float2x2,  "mat2"   },
-        { T::Float2x3,  "mat2x3" },
-        { T::Float2x4,  "mat2x4" },
-        { T::Float3x2,  "mat3x2" },
-        { T::Float3x3,  "mat3"   },
-        { T::Float3x4,  "mat3x4" },
-        { T::Float4x2,  "mat4x2" },
-        { T::Float4x3,  "mat4x3" },
-        { T::Float4x4,  "mat4"   },
-        { T::Double2x2, "mat2"   },
-        { T::Double2x3, "mat2x3" },
-        { T::Double2x4, "mat2x4" },
-        { T::Double3x2, "mat3x2" },
-        { T::Double3x3, "mat3"   },
-        { T::Double3x4, "mat3x4" },
-        { T::Double4x2, "mat4x2" },
-        { T::Double4x3, "mat4x3" },
-        { T::Double4x4, "mat4"   },
-    };
-}
+    nullptr,    // Undefined
+    nullptr,    // String
+
+    /* Scalar types */
+    "bool",     // Bool
+    "int",      // Int
+    "uint",     // UInt
+    "float",    // Half
+    "float",    // Float
+    "double",   // Double
+
+    /* Vector types */
+    "bvec2",    // Bool2
+    "bvec3",    // Bool3
+    "bvec4",    // Bool4
+    "ivec2",    // Int2
+    "ivec3",    // Int3
+    "ivec4",    // Int4
+    "uvec2",    // UInt2
+    "uvec3",    // UInt3
+    "uvec4",    // UInt4
+    "vec2",     // Half2
+    "vec3",     // Half3
+    "vec4",     // Half4
+    "vec2",     // Float2
+    "vec3",     // Float3
+    "vec4",     // Float4
+    "dvec2",    // Double2
+    "dvec3",    // Double3
+    "dvec4",    // Double4
+
+    /* Matrix types */
+    nullptr,    // Bool2x2
+    nullptr,    // Bool2x3
+    nullptr,    // Bool2x4
+    nullptr,    // Bool3x2
+    nullptr,    // Bool3x3
+    nullptr,    // Bool3x4
+    nullptr,    // Bool4x2
+    nullptr,    // Bool4x3
+    nullptr,    // Bool4x4
+    nullptr,    // Int2x2
+    nullptr,    // Int2x3
+    nullptr,    // Int2x4
+    nullptr,    // Int3x2
+    nullptr,    // Int3x3
+    nullptr,    // Int3x4
+    nullptr,    // Int4x2
+    nullptr,    // Int4x3
+    nullptr,    // Int4x4
+    nullptr,    // UInt2x2
+    nullptr,    // UInt2x3
+    nullptr,    // UInt2x4
+    nullptr,    // UInt3x2
+    nullptr,    // UInt3x3
+    nullptr,    // UInt3x4
+    nullptr,    // UInt4x2
+    nullptr,    // UInt4x3
+    nullptr,    // UInt4x4
+    nullptr,    // Half2x2
+    nullptr,    // Half2x3
+    nullptr,    // Half2x4
+    nullptr,    // Half3x2
+    nullptr,    // Half3x3
+    nullptr,    // Half3x4
+    nullptr,    // Half4x2
+    nullptr,    // Half4x3
+    nullptr,    // Half4x4
+    "mat2",     // Float2x2
+    "mat2x3",   // Float2x3
+    "mat2x4",   // Float2x4
+    "mat3x2",   // Float3x2
+    "mat3",     // Float3x3
+    "mat3x4",   // Float3x4
+    "mat4x2",   // Float4x2
+    "mat4x3",   // Float4x3
+    "mat4",     // Float4x4
+    "mat2",     // Double2x2
+    "mat2x3",   // Double2x3
+    "mat2x4",   // Double2x4
+    "mat3x2",   // Double3x2
+    "mat3",     // Double3x3
+    "mat3x4",   // Double3x4
+    "mat4x2",   // Double4x2
+    "mat4x3",   // Double4x3
+    "mat4",     // Double4x4
+};
 
-const std::string* DataTypeToGLSLKeyword(const DataType t)
+const char* DataTypeToGLSLKeyword(const DataType t)
 {
-    static const auto typeMap = GenerateDataTypeMap();
-    return MapTypeToKeyword(typeMap, t);
+    return MapTypeToKeyword(g_dataTypeKeywordsGLSL, t);
 }
 
 
 /* ----- StorageClass Mapping ----- */
 
-static std::map<StorageClass, std::string> GenerateStorageClassMap()
+static const char* const g_storageClassKeywordsGLSL[] =
 {
-    using T = StorageClass;
-
-    return
-    {
-        { T::Extern,          "extern"        },
-      //{ T::Precise,         ""              },
-        { T::Shared,          "shared"        },
-        { T::GroupShared,     "shared"        },
-        { T::Static,          "static"        },
-        { T::Uniform,         "uniform"       },
-        { T::Volatile,        "volatile"      },
-
-        { T::NoInterpolation, "flat"          },
-        { T::Linear,          "smooth"        },
-        { T::Centroid,        "centroid"      },
-        { T::NoPerspective,   "noperspective" },
-        { T::Sample,          "sample"        },
-    };
-}
+    nullptr,            // Undefined
+
+    /* Storage classes */
+    "extern",           // Extern
+    nullptr,            // Precise
+    "shared",           // Shared
+    "shared",           // GroupShared
+    "static",           // Static
+    "uniform",          // Uniform
+    "volatile",         // Volatile
+
+    /* Interpolation modifiers */
+    "flat",             // NoInterpolation
+    "smooth",           // Linear
+    "centroid",         // Centroid
+    "noperspective",    // NoPerspective
+    "sample",           // Sample
+};
 
-const std::string* StorageClassToGLSLKeyword(const StorageClass t)
+const char* StorageClassToGLSLKeyword(const StorageClass t)
 {
-    static const auto typeMap = GenerateStorageClassMap();
-    return MapTypeToKeyword(typeMap, t);
+    return MapTypeToKeyword(g_storageClassKeywordsGLSL, t);
 }
 
 
 /* ----- BufferType Mapping ----- */
 
-static std::map<BufferType, std::string> GenerateBufferTypeMap()
+static const char* const g_bufferTypeKeywordsGLSL[] =
 {
-    using T = BufferType;
-
-    return
-    {
-        { T::Buffer,                  "buffer"           },
-        { T::StucturedBuffer,         "buffer"           },
-        { T::ByteAddressBuffer,       "buffer"           },
-
-        { T::RWBuffer,                "buffer"           },
-        { T::RWStucturedBuffer,       "buffer"           },
-        { T::RWByteAddressBuffer,     "buffer"           },
-        { T::AppendStructuredBuffer,  "buffer"           },
-        { T::ConsumeStructuredBuffer, "buffer"           },
-
-      //{ T::RWTexture1D,             ""                 },
-      //{ T::RWTexture1DArray,        ""                 },
-      //{ T::RWTexture2D,             ""                 },
-      //{ T::RWTexture2DArray,        ""                 },
-      //{ T::RWTexture3D,             ""                 },
-
-        { T::Texture1D,               "sampler1D"        },
-        { T::Texture1DArray,          "sampler1DArray"   },
-        { T::Texture2D,               "sampler2D"        },
-        { T::Texture2DArray,          "sampler2DArray"   },
-        { T::Texture3D,               "sampler3D"        },
-        { T::TextureCube,             "samplerCube"      },
-        { T::TextureCubeArray,        "samplerCubeArray" },
-        { T::Texture2DMS,             "sampler2DMS"      },
-        { T::Texture2DMSArray,        "sampler2DMSArray" },
-    };
-}
+    nullptr,                // Undefined
+
+    "buffer",               // Buffer
+    "buffer",               // StucturedBuffer
+    "buffer",               // ByteAddressBuffer
+
+    "buffer",               // RWBuffer
+    "buffer",               // RWStucturedBuffer
+    "buffer",               // RWByteAddressBuffer
+    "buffer",               // AppendStructuredBuffer
+    "buffer",               // ConsumeStructuredBuffer
+
+    nullptr,                // RWTexture1D
+    nullptr,                // RWTexture1DArray
+    nullptr,                // RWTexture2D
+    nullptr,                // RWTexture2DArray
+    nullptr,                // RWTexture3D
+
+    "sampler1D",            // Texture1D
+    "sampler1DArray",       // Texture1DArray
+    "sampler2D",            // Texture2D
+    "sampler2DArray",       // Texture2DArray
+    "sampler3D",            // Texture3D
+    "samplerCube",          // TextureCube
+    "samplerCubeArray",     // TextureCubeArray
+    "sampler2DMS",          // Texture2DMS
+    "sampler2DMSArray",     // Texture2DMSArray
+
+    nullptr,                // GenericTexture
+};
 
-const std::string* BufferTypeToGLSLKeyword(const BufferType t)
+const char* BufferTypeToGLSLKeyword(const BufferType t)
 {
-    static const auto typeMap = GenerateBufferTypeMap();
-    return MapTypeToKeyword(typeMap, t);
+    return MapTypeToKeyword(g_bufferTypeKeywordsGLSL, t);
 }
 
 
@@ -186,61 +223,56 @@ const std::string* BufferTypeToGLSLKeyword(const BufferType t)
 
 struct GLSLSemanticDescriptor
 {
-    inline GLSLSemanticDescriptor(const std::string& keyword, bool hasIndex = false) :
-        keyword { keyword  },
-        hasIndex{ hasIndex }
-    {
-    }
-
-    std::string keyword;
-    bool        hasIndex    = false;
+    const char* keyword;
+    bool        hasIndex;
 };
 
-static std::map<Semantic, GLSLSemanticDescriptor> GenerateSemanticMap()
+static const GLSLSemanticDescriptor g_semanticDescriptorsGLSL[] =
 {
-    using T = Semantic;
-
-    return
-    {
-        { T::ClipDistance,           { "gl_ClipDistance",        true } },
-        { T::CullDistance,           { "gl_CullDistance",        true } }, // if ARB_cull_distance is present
-        { T::Coverage,               { "gl_SampleMask"                } },
-        { T::Depth,                  { "gl_FragDepth"                 } },
-        { T::DepthGreaterEqual,      { "gl_FragDepth"                 } }, // layout(depth_greater) out float gl_FragDepth;
-        { T::DepthLessEqual,         { "gl_FragDepth"                 } }, // layout(depth_less) out float gl_FragDepth;
-        { T::DispatchThreadID,       { "gl_GlobalInvocationID"        } },
-        { T::DomainLocation,         { "gl_TessCoord"                 } },
-        { T::GroupID,                { "gl_WorkGroupID"               } },
-        { T::GroupIndex,             { "gl_LocalInvocationIndex"      } },
-        { T::GroupThreadID,          { "gl_LocalInvocationID"         } },
-        { T::GSInstanceID,           { "gl_InvocationID"              } },
-        { T::InnerCoverage,          { "gl_SampleMaskIn"              } },
-        { T::InsideTessFactor,       { "gl_TessLevelInner"            } },
-        { T::InstanceID,             { "gl_InstanceID"                } }, // gl_InstanceID (GLSL), gl_InstanceIndex (Vulkan)
-        { T::IsFrontFace,            { "gl_FrontFacing"               } },
-        { T::OutputControlPointID,   { "gl_InvocationID"              } },
-        { T::Position,               { "gl_FragCoord"                 } },
-        { T::PrimitiveID,            { "gl_PrimitiveID"               } },
-        { T::RenderTargetArrayIndex, { "gl_Layer"                     } },
-        { T::SampleIndex,            { "gl_SampleID"                  } },
-        { T::StencilRef,             { "gl_FragStencilRef"            } }, // if ARB_shader_stencil_export is present
-        { T::Target,                 { "gl_FragData",            true } }, // only for GLSL 1.10
-        { T::TessFactor,             { "gl_TessLevelOuter"            } },
-        { T::VertexID,               { "gl_VertexID"                  } }, // gl_VertexID (GLSL), gl_VertexIndex (Vulkan)
-        { T::VertexPosition,         { "gl_Position"                  } },
-        { T::ViewportArrayIndex,     { "gl_ViewportIndex"             } },
-    };
-}
+    { nullptr,                    false }, // Undefined
+    { nullptr,                    false }, // UserDefined
+
+    { "gl_ClipDistance",          true  }, // ClipDistance
+    { "gl_CullDistance",          true  }, // CullDistance (if ARB_cull_distance is present)
+    { "gl_SampleMask",            false }, // Coverage
+    { "gl_FragDepth",             false }, // Depth
+    { "gl_FragDepth",             false }, // DepthGreaterEqual: layout(depth_greater) out float gl_FragDepth;
+    { "gl_FragDepth",             false }, // DepthLessEqual: layout(depth_less) out float gl_FragDepth;
+    { "gl_GlobalInvocationID",    false }, // DispatchThreadID
+    { "gl_TessCoord",             false }, // DomainLocation
+    { "gl_WorkGroupID",           false }, // GroupID
+    { "gl_LocalInvocationIndex",  false }, // GroupIndex
+    { "gl_LocalInvocationID",     false }, // GroupThreadID
+    { "gl_InvocationID",          false }, // GSInstanceID
+    { "gl_SampleMaskIn",          false }, // InnerCoverage
+    { "gl_TessLevelInner",        false }, // InsideTessFactor
+    { "gl_InstanceID",            false }, // InstanceID: gl_InstanceID (GLSL), gl_InstanceIndex (Vulkan)
+    { "gl_FrontFacing",           false }, // IsFrontFace
+    { "gl_InvocationID",          false }, // OutputControlPointID
+    { "gl_FragCoord",             false }, // Position
+    { "gl_PrimitiveID",           false }, // PrimitiveID
+    { "gl_Layer",                 false }, // RenderTargetArrayIndex
+    { "gl_SampleID",              false }, // SampleIndex
+    { "gl_FragStencilRef",        false }, // StencilRef (if ARB_shader_stencil_export is present)
+    { "gl_FragData",              true  }, // Target (only for GLSL 1.10)
+    { "gl_TessLevelOuter",        false }, // TessFactor
+    { "gl_VertexID",              false }, // VertexID: gl_VertexID (GLSL), gl_VertexIndex (Vulkan)
+    { "gl_Position",              false }, // VertexPosition
+    { "gl_ViewportIndex",         false }, // ViewportArrayIndex
+};
 
 std::unique_ptr<std::string> SemanticToGLSLKeyword(const IndexedSemantic& semantic)
 {
-    static const auto typeMap = GenerateSemanticMap();
-    if (auto type = MapTypeToKeyword(typeMap, Semantic(semantic)))
+    static const auto numDescs = sizeof(g_semanticDescriptorsGLSL) / sizeof(g_semanticDescriptorsGLSL[0]);
+
+    const auto idx = static_cast<std::size_t>(Semantic(semantic));
+    if (idx < numDescs && g_semanticDescriptorsGLSL[idx].keyword != nullptr)
     {
-        if (type->hasIndex)
-            return MakeUnique<std::string>(type->keyword + "[" + std::to_string(semantic.Index()) + "]");
+        const auto& desc = g_semanticDescriptorsGLSL[idx];
+        if (desc.hasIndex)
+            return MakeUnique<std::string>(desc.keyword + ("[" + std::to_string(semantic.Index()) + "]"));
         else
-            return MakeUnique<std::string>(type->keyword);
+            return MakeUnique<std::string>(desc.keyword);
     }
     return nullptr;
 }
@@ -250,4 +282,4 @@ std::unique_ptr<std::string> SemanticToGLSLKeyword(const IndexedSemantic& semant
 
 
 
-// ================================================================================
\ No newline at end of file
+// ================================================================================
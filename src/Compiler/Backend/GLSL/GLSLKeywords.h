@@ -23,13 +23,13 @@ namespace Xsc
 bool IsGLSLKeyword(const std::string& ident);
 
 // Returns the GLSL keyword for the specified data type or null on failure.
-const std::string* DataTypeToGLSLKeyword(const DataType t);
+const char* DataTypeToGLSLKeyword(const DataType t);
 
 // Returns the GLSL keyword for the specified storage class or null on failure.
-const std::string* StorageClassToGLSLKeyword(const StorageClass t);
+const char* StorageClassToGLSLKeyword(const StorageClass t);
 
 // Returns the GLSL keyword for the specified buffer type or null on failure.
-const std::string* BufferTypeToGLSLKeyword(const BufferType t);
+const char* BufferTypeToGLSLKeyword(const BufferType t);
 
 // Returns the GLSL keyword for the specified semantic.
 std::unique_ptr<std::string> SemanticToGLSLKeyword(const IndexedSemantic& semantic);
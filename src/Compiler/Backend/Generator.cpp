@@ -7,16 +7,121 @@
 
 #include "Generator.h"
 #include "AST.h"
+#include "StaticVisitor.h"
 #include <sstream>
 #include <ctime>
 #include <chrono>
 #include <iomanip>
+#include <atomic>
+#include <algorithm>
 
 
 namespace Xsc
 {
 
 
+/* ----- Output size estimation ----- */
+
+/*
+Estimates the output code size from the program AST, so the output buffer can be reserved once
+before code generation starts. The estimate is the sum of all identifier and literal spellings
+plus a fixed number of bytes per AST node (for keywords, operators, indentation, and new-line
+characters). The byte-per-node ratio is refined from the actually emitted output sizes, which
+the generator records over all previous code generations of the process (see RecordOutputSize).
+*/
+class OutputSizeEstimator : private StaticVisitor<OutputSizeEstimator>
+{
+
+    public:
+
+        // Counts the AST nodes and spelling bytes of the specified program.
+        void CountProgram(Program& program)
+        {
+            Visit(&program);
+        }
+
+        // Returns the number of counted AST nodes.
+        inline std::size_t NumNodes() const
+        {
+            return numNodes_;
+        }
+
+        // Returns the number of counted identifier and literal bytes.
+        inline std::size_t NumSpellingBytes() const
+        {
+            return numSpellingBytes_;
+        }
+
+    private:
+
+        friend StaticVisitorT;
+
+        void OnDispatchNode(AST* ast, void* args)
+        {
+            ++numNodes_;
+        }
+
+        DECL_STATIC_VISIT_PROC( VarIdent )
+        {
+            numSpellingBytes_ += ast->ident.size();
+            STATIC_VISIT_DEFAULT(VarIdent);
+        }
+
+        DECL_STATIC_VISIT_PROC( VarDecl )
+        {
+            numSpellingBytes_ += ast->ident.size();
+            STATIC_VISIT_DEFAULT(VarDecl);
+        }
+
+        DECL_STATIC_VISIT_PROC( FunctionDecl )
+        {
+            numSpellingBytes_ += ast->ident.size();
+            STATIC_VISIT_DEFAULT(FunctionDecl);
+        }
+
+        DECL_STATIC_VISIT_PROC( LiteralExpr )
+        {
+            numSpellingBytes_ += ast->value.size();
+            STATIC_VISIT_DEFAULT(LiteralExpr);
+        }
+
+        /* === Members === */
+
+        std::size_t numNodes_           = 0;
+        std::size_t numSpellingBytes_   = 0;
+
+};
+
+// Running totals over all code generations of the process, to refine the byte-per-node ratio.
+static std::atomic<unsigned long long> g_totalOutputNodes;
+static std::atomic<unsigned long long> g_totalOutputBytes;
+
+// Returns the estimated number of output bytes per AST node (refined from the recorded output sizes).
+static std::size_t BytesPerNode()
+{
+    /* Use the default ratio until enough output has been recorded */
+    static const std::size_t defaultBytesPerNode = 8;
+    static const unsigned long long minRecordedNodes = 1024;
+
+    auto numNodes = g_totalOutputNodes.load();
+    if (numNodes < minRecordedNodes)
+        return defaultBytesPerNode;
+
+    /* Clamp the recorded ratio to a sane range (a degenerated corpus must not spoil the preallocation) */
+    auto ratio = static_cast<std::size_t>(g_totalOutputBytes.load() / numNodes);
+    return std::max(std::size_t(4u), std::min(ratio, std::size_t(64u)));
+}
+
+// Records the actually emitted output size of a code generation, to refine future estimates.
+static void RecordOutputSize(std::size_t numNodes, std::size_t numSpellingBytes, std::size_t numBytes)
+{
+    g_totalOutputNodes.fetch_add(numNodes);
+    g_totalOutputBytes.fetch_add(numBytes > numSpellingBytes ? numBytes - numSpellingBytes : 0);
+}
+
+
+/* ----- Generator class ----- */
+
 Generator::Generator(Log* log) :
     reportHandler_{ "code generation", log }
 {
@@ -27,14 +132,60 @@ bool Generator::GenerateCode(
 {
     /* Store parameters */
     writer_.SetIndent(outputDesc.formatting.indent);
+    writer_.SetMinified(outputDesc.formatting.minify);
+
+    reportHandler_.SetErrorLimit(inputDesc.maxErrors);
 
-    allowBlanks_    = outputDesc.formatting.blanks;
+    allowBlanks_    = (outputDesc.formatting.blanks && !outputDesc.formatting.minify);
     program_        = &program;
 
     try
     {
-        writer_.OutputStream(*outputDesc.sourceCode);
+        if (auto compressor = outputDesc.outputCompressor)
+        {
+            /* Flush the generated code through the compressor in chunks, so the compressed artifact needs no second pass */
+            writer_.OutputCallback(
+                [compressor](const char* chunk, std::size_t size)
+                {
+                    compressor->WriteChunk(chunk, size);
+                },
+                outputDesc.outputChunkSize
+            );
+        }
+        else if (outputDesc.sourceCodeCallback)
+            writer_.OutputCallback(outputDesc.sourceCodeCallback, outputDesc.outputChunkSize);
+        else if (!outputDesc.sourceCodeString)
+            writer_.OutputStream(*outputDesc.sourceCode);
+
+        /* Preallocate the output buffer once, estimated from the size of the program AST */
+        OutputSizeEstimator estimator;
+        estimator.CountProgram(program);
+
+        const auto estimatedSize = estimator.NumSpellingBytes() + estimator.NumNodes() * BytesPerNode();
+        writer_.Reserve(estimatedSize);
+
         GenerateCodePrimary(program, inputDesc, outputDesc);
+
+        /* Record the actual output size, to refine future estimates and to surface the estimate quality */
+        RecordOutputSize(estimator.NumNodes(), estimator.NumSpellingBytes(), writer_.TotalSize());
+
+        if (outputDesc.statistics)
+        {
+            outputDesc.statistics->estimatedOutputSize  = estimatedSize;
+            outputDesc.statistics->actualOutputSize     = writer_.TotalSize();
+        }
+
+        if (outputDesc.compileStats)
+            outputDesc.compileStats->outputBytes = writer_.TotalSize();
+
+        /* Flush the buffered output code (either into the compressor, the chunk callback, the output string, or the output stream) */
+        if (!outputDesc.outputCompressor && !outputDesc.sourceCodeCallback && outputDesc.sourceCodeString)
+            writer_.Flush(*outputDesc.sourceCodeString);
+        else
+            writer_.Flush();
+
+        if (outputDesc.outputCompressor)
+            outputDesc.outputCompressor->Finish();
     }
     catch (const Report& err)
     {
@@ -42,6 +193,11 @@ bool Generator::GenerateCode(
             log->SumitReport(err);
         return false;
     }
+    catch (const ErrorLimitAbort&)
+    {
+        /* The abort report was already submitted (see ShaderInput::maxErrors) */
+        return false;
+    }
 
     return true;
 }
@@ -91,6 +247,21 @@ void Generator::WriteLn(const std::string& text)
     writer_.WriteLine(text);
 }
 
+void Generator::Write(const char* text)
+{
+    writer_.Write(text);
+}
+
+void Generator::Write(char chr)
+{
+    writer_.Write(chr);
+}
+
+void Generator::WriteLn(const char* text)
+{
+    writer_.WriteLine(text);
+}
+
 void Generator::IncIndent()
 {
     writer_.IncIndent();
@@ -117,6 +288,21 @@ void Generator::Blank()
         WriteLn("");
 }
 
+std::size_t Generator::OutputMark() const
+{
+    return writer_.BufferSize();
+}
+
+std::string Generator::CapturedOutput(std::size_t mark) const
+{
+    return writer_.BufferSuffix(mark);
+}
+
+void Generator::RollbackOutput(std::size_t mark)
+{
+    writer_.RollbackBuffer(mark);
+}
+
 std::string Generator::TimePoint() const
 {
     auto currentTime    = std::chrono::system_clock::now();
@@ -55,6 +55,11 @@ class Generator : protected Visitor
         void Write(const std::string& text);
         void WriteLn(const std::string& text);
 
+        /* Overloads for literals, keyword-table entries, and single characters, so no temporary string is constructed */
+        void Write(const char* text);
+        void Write(char chr);
+        void WriteLn(const char* text);
+
         void IncIndent();
         void DecIndent();
         
@@ -63,6 +68,19 @@ class Generator : protected Visitor
 
         void Blank();
 
+        /*
+        Marks the current output position for a speculative emission (see CapturedOutput and RollbackOutput).
+        The mark is only valid while the current line stays open: at a line boundary the buffered output
+        may be flushed in chunks (see CodeWriter::OutputCallback), which invalidates the mark.
+        */
+        std::size_t OutputMark() const;
+
+        // Returns the output written since the specified mark, or an empty string if the mark was invalidated.
+        std::string CapturedOutput(std::size_t mark) const;
+
+        // Discards the output written since the specified mark (no-op if the mark was invalidated).
+        void RollbackOutput(std::size_t mark);
+
         // Returns the current date and time point (can be used in a headline comment).
         std::string TimePoint() const;
 
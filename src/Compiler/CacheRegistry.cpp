@@ -0,0 +1,221 @@
+/*
+ * CacheRegistry.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Xsc/CacheRegistry.h>
+
+#include <algorithm>
+
+
+namespace Xsc
+{
+
+
+CacheRegistry& CacheRegistry::Instance()
+{
+    /* Leaky singleton, so caches registered in static objects never race against static destruction */
+    static auto instance = new CacheRegistry();
+    return *instance;
+}
+
+void CacheRegistry::SetMemoryBudget(std::size_t maxBytes)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    maxBytes_ = maxBytes;
+    AssignEvictionDebts();
+}
+
+std::size_t CacheRegistry::MemoryBudget() const
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    return maxBytes_;
+}
+
+std::size_t CacheRegistry::TotalBytes() const
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    return totalBytes_;
+}
+
+std::vector<CacheRegistry::CacheAccount> CacheRegistry::QueryAccounts() const
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    std::vector<CacheAccount> accounts;
+    accounts.reserve(records_.size());
+
+    for (const auto& record : records_)
+    {
+        CacheAccount account;
+        {
+            account.name             = record.cache->CacheName();
+            account.evictionPriority = record.evictionPriority;
+            account.numEntries       = record.numEntries;
+            account.numBytes         = record.numBytes;
+            account.numEvictions     = record.numEvictions;
+        }
+        accounts.push_back(std::move(account));
+    }
+
+    return accounts;
+}
+
+void CacheRegistry::Register(ManagedCache& cache, int evictionPriority)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    CacheRecord record;
+    {
+        record.cache            = &cache;
+        record.evictionPriority = evictionPriority;
+    }
+    records_.push_back(record);
+}
+
+void CacheRegistry::Unregister(ManagedCache& cache)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    for (auto it = records_.begin(); it != records_.end(); ++it)
+    {
+        if (it->cache == &cache)
+        {
+            totalBytes_ -= std::min(it->numBytes, totalBytes_);
+            records_.erase(it);
+            break;
+        }
+    }
+}
+
+std::uint64_t CacheRegistry::NextAccessTick()
+{
+    return ++accessTick_;
+}
+
+void CacheRegistry::AddEntry(ManagedCache& cache, std::size_t numBytes)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    if (auto record = FindRecord(cache))
+    {
+        ++record->numEntries;
+        record->numBytes += numBytes;
+        totalBytes_ += numBytes;
+        AssignEvictionDebts();
+    }
+}
+
+void CacheRegistry::RemoveEntry(ManagedCache& cache, std::size_t numBytes, bool evicted)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    if (auto record = FindRecord(cache))
+    {
+        record->numEntries -= std::min<std::size_t>(1u, record->numEntries);
+        record->numBytes   -= std::min(numBytes, record->numBytes);
+        totalBytes_        -= std::min(numBytes, totalBytes_);
+
+        if (evicted)
+            ++record->numEvictions;
+    }
+}
+
+void CacheRegistry::ClearEntries(ManagedCache& cache)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    if (auto record = FindRecord(cache))
+    {
+        totalBytes_ -= std::min(record->numBytes, totalBytes_);
+        record->numEntries        = 0;
+        record->numBytes          = 0;
+        record->evictionDebtBytes = 0;
+    }
+}
+
+void CacheRegistry::SettleEvictionDebt(ManagedCache& cache)
+{
+    /* Claim the debt under the lock, but evict outside of it (the eviction reports back via RemoveEntry) */
+    std::size_t debtBytes = 0;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (auto record = FindRecord(cache))
+        {
+            debtBytes                 = record->evictionDebtBytes;
+            record->evictionDebtBytes = 0;
+        }
+    }
+
+    if (debtBytes > 0)
+        cache.EvictOldest(debtBytes);
+}
+
+
+/*
+ * ======= Private: =======
+ */
+
+CacheRegistry::CacheRecord* CacheRegistry::FindRecord(ManagedCache& cache)
+{
+    for (auto& record : records_)
+    {
+        if (record.cache == &cache)
+            return &record;
+    }
+    return nullptr;
+}
+
+void CacheRegistry::AssignEvictionDebts()
+{
+    if (maxBytes_ == 0 || totalBytes_ <= maxBytes_)
+        return;
+
+    /* Determine the excess bytes that are not covered by already assigned debts */
+    auto excessBytes = (totalBytes_ - maxBytes_);
+
+    for (const auto& record : records_)
+        excessBytes -= std::min(record.evictionDebtBytes, excessBytes);
+
+    if (excessBytes == 0)
+        return;
+
+    /* Distribute the excess over the caches: lower eviction priorities first, larger caches first within a priority */
+    std::vector<CacheRecord*> recordsByPriority;
+    recordsByPriority.reserve(records_.size());
+
+    for (auto& record : records_)
+        recordsByPriority.push_back(&record);
+
+    std::stable_sort(
+        recordsByPriority.begin(), recordsByPriority.end(),
+        [](const CacheRecord* lhs, const CacheRecord* rhs)
+        {
+            if (lhs->evictionPriority != rhs->evictionPriority)
+                return (lhs->evictionPriority < rhs->evictionPriority);
+            return (lhs->numBytes > rhs->numBytes);
+        }
+    );
+
+    for (auto record : recordsByPriority)
+    {
+        if (excessBytes == 0)
+            break;
+
+        /* Assign at most the bytes this cache still holds beyond its current debt */
+        const auto assignableBytes = (record->numBytes - std::min(record->evictionDebtBytes, record->numBytes));
+        const auto debtBytes       = std::min(assignableBytes, excessBytes);
+
+        record->evictionDebtBytes += debtBytes;
+        excessBytes               -= debtBytes;
+    }
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
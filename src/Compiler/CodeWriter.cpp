@@ -1,11 +1,13 @@
 /*
  * CodeWriter.cpp
- * 
+ *
  * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
  * See "LICENSE.txt" for license information.
  */
 
 #include "CodeWriter.h"
+#include <algorithm>
+#include <cstring>
 
 
 namespace Xsc
@@ -19,6 +21,25 @@ void CodeWriter::OutputStream(std::ostream& stream)
         throw std::runtime_error("invalid output stream");
 }
 
+void CodeWriter::OutputCallback(const std::function<void(const char*, std::size_t)>& callback, std::size_t chunkSize)
+{
+    callback_   = callback;
+    chunkSize_  = chunkSize;
+}
+
+void CodeWriter::Reserve(std::size_t size)
+{
+    /* With a chunk callback, the buffer never grows much beyond the chunk size */
+    if (callback_)
+        size = std::min(size, chunkSize_ * 2);
+    buffer_.reserve(size);
+}
+
+void CodeWriter::SetMinified(bool enabled)
+{
+    minified_ = enabled;
+}
+
 void CodeWriter::PushOptions(const Options& options)
 {
     optionsStack_.push(options);
@@ -38,9 +59,18 @@ void CodeWriter::BeginLine()
         /* Begin a new line */
         openLine_ = true;
 
-        /* Append indentation */
-        if (CurrentOptions().enableIndent)
-            Out() << FullIndent();
+        if (minified_)
+        {
+            /* Defer directive breaks and token separation until the first character is known */
+            atLineStart_    = true;
+            pendingSpace_   = true;
+            directiveLine_  = false;
+        }
+        else if (CurrentOptions().enableIndent)
+        {
+            /* Append indentation */
+            buffer_ += FullIndent();
+        }
     }
 }
 
@@ -51,13 +81,26 @@ void CodeWriter::EndLine()
     {
         /* End current line */
         openLine_ = false;
-        Out() << '\n';
+
+        /* In minified mode, only preprocessor directives are terminated by a new-line character */
+        if (!minified_ || directiveLine_)
+            buffer_ += '\n';
+
+        if (minified_)
+            pendingSpace_ = false;
+
+        /* Forward the buffered output at line boundaries, so chunks never split a line */
+        if (callback_ && buffer_.size() >= chunkSize_)
+            FlushChunk();
     }
 }
 
 void CodeWriter::Write(const std::string& text)
 {
-    Out() << text;
+    if (minified_)
+        WriteMinified(text.data(), text.size());
+    else
+        buffer_ += text;
 }
 
 void CodeWriter::WriteLine(const std::string& text)
@@ -67,14 +110,139 @@ void CodeWriter::WriteLine(const std::string& text)
     EndLine();
 }
 
+void CodeWriter::Write(const char* text)
+{
+    if (minified_)
+        WriteMinified(text, std::strlen(text));
+    else
+        buffer_ += text;
+}
+
+void CodeWriter::Write(char chr)
+{
+    if (minified_)
+        WriteMinified(&chr, 1);
+    else
+        buffer_ += chr;
+}
+
+void CodeWriter::WriteLine(const char* text)
+{
+    BeginLine();
+    Write(text);
+    EndLine();
+}
+
+void CodeWriter::Flush()
+{
+    if (callback_)
+    {
+        if (!buffer_.empty())
+            FlushChunk();
+    }
+    else if (stream_ && !buffer_.empty())
+        stream_->write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+}
+
+void CodeWriter::Flush(std::string& outputCode)
+{
+    outputCode = std::move(buffer_);
+    buffer_.clear();
+}
+
+std::string CodeWriter::BufferSuffix(std::size_t size) const
+{
+    return (size <= buffer_.size() ? buffer_.substr(size) : std::string());
+}
+
+void CodeWriter::RollbackBuffer(std::size_t size)
+{
+    if (size <= buffer_.size())
+        buffer_.resize(size);
+}
+
 CodeWriter::Options CodeWriter::CurrentOptions() const
 {
     return (!optionsStack_.empty() ? optionsStack_.top() : Options());
 }
 
 
+/*
+ * ======= Private: =======
+ */
+
+void CodeWriter::FlushChunk()
+{
+    /* Retain the last character for the token separation of the minified mode */
+    if (!buffer_.empty())
+        lastChar_ = buffer_.back();
+
+    callback_(buffer_.data(), buffer_.size());
+    totalFlushed_ += buffer_.size();
+    buffer_.clear();
+}
+
+// Returns true if the specified character can be part of an identifier or number token.
+static bool IsTokenChar(char chr)
+{
+    return
+    (
+        ( chr >= 'a' && chr <= 'z' ) ||
+        ( chr >= 'A' && chr <= 'Z' ) ||
+        ( chr >= '0' && chr <= '9' ) ||
+        chr == '_'
+    );
+}
+
+void CodeWriter::WriteMinified(const char* text, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        const auto chr = text[i];
+
+        /* Collapse all white spaces to a pending separator */
+        if (chr == ' ' || chr == '\t' || chr == '\n')
+        {
+            pendingSpace_ = true;
+            continue;
+        }
+
+        if (atLineStart_)
+        {
+            atLineStart_ = false;
+            if (chr == '#')
+            {
+                /* Preprocessor directives must start on their own line */
+                const auto prevChr = (!buffer_.empty() ? buffer_.back() : lastChar_);
+                if (prevChr != '\n' && prevChr != 0)
+                    buffer_ += '\n';
+                directiveLine_ = true;
+                pendingSpace_  = false;
+            }
+        }
+
+        if (pendingSpace_)
+        {
+            /* Keep a single space where the adjacent tokens would otherwise merge
+               (e.g. "else" and "discard", or a binary and a unary minus) */
+            const auto prevChr = (!buffer_.empty() ? buffer_.back() : lastChar_);
+            if ( ( IsTokenChar(prevChr) && IsTokenChar(chr) ) ||
+                 ( prevChr == '-' && chr == '-' ) ||
+                 ( prevChr == '+' && chr == '+' ) )
+            {
+                buffer_ += ' ';
+            }
+            pendingSpace_ = false;
+        }
+
+        buffer_ += chr;
+    }
+}
+
+
 } // /namespace Xsc
 
 
 
-// ================================================================================
\ No newline at end of file
+// ================================================================================
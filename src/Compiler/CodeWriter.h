@@ -1,6 +1,6 @@
 /*
  * CodeWriter.h
- * 
+ *
  * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
  * See "LICENSE.txt" for license information.
  */
@@ -11,19 +11,24 @@
 
 #include <Xsc/IndentHandler.h>
 #include <ostream>
+#include <string>
 #include <stack>
+#include <functional>
 
 
 namespace Xsc
 {
 
 
-// Output code writer.
+/*
+Output code writer. Accumulates the output into an in-memory buffer, which is either flushed
+once at the end of code generation, or incrementally in chunks at line boundaries (see OutputCallback).
+*/
 class CodeWriter : public IndentHandler
 {
-    
+
     public:
-        
+
         struct Options
         {
             Options() = default;
@@ -41,6 +46,17 @@ class CodeWriter : public IndentHandler
         // Throws std::runtime_error If stream is invalid.
         void OutputStream(std::ostream& stream);
 
+        // Redirects the output to the specified chunk callback, which is invoked at line boundaries
+        // whenever at least 'chunkSize' bytes are buffered (takes precedence over the output stream).
+        void OutputCallback(const std::function<void(const char*, std::size_t)>& callback, std::size_t chunkSize);
+
+        // Preallocates the specified number of bytes in the output buffer (e.g. estimated from the input size).
+        void Reserve(std::size_t size);
+
+        // Enables minified output: no indentation, new-lines only after preprocessor directives,
+        // and a single space where adjacent tokens would otherwise merge (see Formatting::minify).
+        void SetMinified(bool enabled);
+
         void PushOptions(const Options& options);
         void PopOptions();
 
@@ -50,13 +66,18 @@ class CodeWriter : public IndentHandler
         void Write(const std::string& text);
         void WriteLine(const std::string& text);
 
-        Options CurrentOptions() const;
+        /* Overloads for literals, keyword-table entries, and single characters, so no temporary string is constructed */
+        void Write(const char* text);
+        void Write(char chr);
+        void WriteLine(const char* text);
 
-        // Returns the output stream.
-        inline std::ostream& Out()
-        {
-            return (*stream_);
-        }
+        // Writes the buffered output to the output stream (see OutputStream) and clears the buffer.
+        void Flush();
+
+        // Moves the buffered output into the specified string and clears the buffer.
+        void Flush(std::string& outputCode);
+
+        Options CurrentOptions() const;
 
         // Returns true if the code writer is currently in an open line (i.e. BeginLine was called without closing EndLine).
         inline bool IsOpenLine() const
@@ -64,14 +85,51 @@ class CodeWriter : public IndentHandler
             return openLine_;
         }
 
+        // Returns the current size (in bytes) of the buffered output.
+        inline std::size_t BufferSize() const
+        {
+            return buffer_.size();
+        }
+
+        // Returns the buffered output written since the specified buffer size (or an empty string if the buffer was flushed in between).
+        std::string BufferSuffix(std::size_t size) const;
+
+        // Discards the buffered output written since the specified buffer size (no-op if the buffer was flushed in between).
+        void RollbackBuffer(std::size_t size);
+
+        // Returns the total size (in bytes) of the output, including all chunks already flushed to the callback.
+        inline std::size_t TotalSize() const
+        {
+            return totalFlushed_ + buffer_.size();
+        }
+
     private:
-        
+
+        // Flushes the buffered output to the chunk callback and clears the buffer.
+        void FlushChunk();
+
+        // Appends the text in minified mode: collapses white spaces, keeping directive breaks and token separation.
+        void WriteMinified(const char* text, std::size_t size);
+
         std::ostream*       stream_         = nullptr;
 
+        std::function<void(const char*, std::size_t)> callback_;
+        std::size_t         chunkSize_      = 0;
+        std::size_t         totalFlushed_   = 0;
+
+        std::string         buffer_;
+
         std::stack<Options> optionsStack_;
 
         bool                openLine_       = false;
 
+        /* Minified mode state (see SetMinified) */
+        bool                minified_       = false;
+        bool                atLineStart_    = false;
+        bool                pendingSpace_   = false;
+        bool                directiveLine_  = false;
+        char                lastChar_       = 0;
+
 };
 
 
@@ -82,4 +140,4 @@ class CodeWriter : public IndentHandler
 
 
 
-// ================================================================================
\ No newline at end of file
+// ================================================================================
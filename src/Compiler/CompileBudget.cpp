@@ -0,0 +1,158 @@
+/*
+ * CompileBudget.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "CompileBudget.h"
+#include "MemoryPool.h"
+#include "ReportHandler.h"
+#include <Xsc/Report.h>
+#include <algorithm>
+#include <string>
+
+
+namespace Xsc
+{
+
+
+static thread_local CompileBudget* activeCompileBudget = nullptr;
+
+CompileBudget* ActiveCompileBudget()
+{
+    return activeCompileBudget;
+}
+
+// Returns the elapsed milliseconds since the specified start time.
+static std::size_t ElapsedMilliseconds(const std::chrono::steady_clock::time_point& startTime)
+{
+    return static_cast<std::size_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count()
+    );
+}
+
+
+/*
+ * CompileBudget class
+ */
+
+CompileBudget::CompileBudget(const ShaderInput& inputDesc) :
+    startTime_      { std::chrono::steady_clock::now() },
+    maxCompileTime_ { inputDesc.maxCompileTime         },
+    maxArenaBytes_  { inputDesc.maxArenaBytes          },
+    maxTokens_      { inputDesc.maxTokens              }
+{
+    /* Schedule the first token checkpoint; the token budget itself must trigger precisely at its boundary */
+    nextCheckpointTokens_ = checkpointInterval_;
+
+    if (maxTokens_ > 0)
+        nextCheckpointTokens_ = std::min(nextCheckpointTokens_, maxTokens_ + 1);
+}
+
+bool CompileBudget::Validate(Log* log)
+{
+    auto exhausted = CheckBudgets();
+
+    if (!exhausted.empty())
+    {
+        /* Submit the report only once: a frontend pass may already have delivered it (see TokenCheckpoint) */
+        if (!reported_)
+        {
+            reported_ = true;
+            if (log)
+                log->SumitReport(Report(Report::Types::Error, exhausted));
+        }
+        return false;
+    }
+
+    return true;
+}
+
+void CompileBudget::TokenCheckpoint()
+{
+    auto exhausted = CheckBudgets();
+
+    if (!exhausted.empty())
+    {
+        /* Unwind silently once the report was delivered, so local error recovery does not submit it again */
+        if (reported_)
+            throw ErrorLimitAbort();
+
+        /* Abort like a scan error: the active frontend pass catches the report, submits it, and fails cleanly */
+        reported_ = true;
+        throw Report(Report::Types::Error, exhausted);
+    }
+
+    nextCheckpointTokens_ = numTokens_ + checkpointInterval_;
+
+    if (maxTokens_ > 0)
+        nextCheckpointTokens_ = std::min(nextCheckpointTokens_, maxTokens_ + 1);
+}
+
+std::string CompileBudget::CheckBudgets() const
+{
+    if (maxTokens_ > 0 && numTokens_ > maxTokens_)
+    {
+        return (
+            "compile budget exceeded: token count (" +
+            std::to_string(numTokens_) + " tokens of " + std::to_string(maxTokens_) + ")"
+        );
+    }
+
+    if (maxCompileTime_ > 0)
+    {
+        const auto elapsed = ElapsedMilliseconds(startTime_);
+        if (elapsed > maxCompileTime_)
+        {
+            return (
+                "compile budget exceeded: wall time (" +
+                std::to_string(elapsed) + "ms of " + std::to_string(maxCompileTime_) + "ms)"
+            );
+        }
+    }
+
+    #ifdef XSC_ENABLE_MEMORY_POOL
+    if (maxArenaBytes_ > 0)
+    {
+        if (auto pool = MemoryPool::Active())
+        {
+            const auto usedBytes = pool->UsedBytes();
+            if (usedBytes > maxArenaBytes_)
+            {
+                return (
+                    "compile budget exceeded: arena memory (" +
+                    std::to_string(usedBytes) + " bytes of " + std::to_string(maxArenaBytes_) + ")"
+                );
+            }
+        }
+    }
+    #endif
+
+    return "";
+}
+
+
+/*
+ * CompileBudgetScope class
+ */
+
+CompileBudgetScope::CompileBudgetScope(const ShaderInput& inputDesc) :
+    budget_   { inputDesc           },
+    previous_ { activeCompileBudget }
+{
+    /* Publish the guard only if a budget is configured, so unbudgeted compiles pay nothing in the token funnel */
+    activeCompileBudget = (budget_.AnyLimit() ? &budget_ : nullptr);
+}
+
+CompileBudgetScope::~CompileBudgetScope()
+{
+    activeCompileBudget = previous_;
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
@@ -0,0 +1,120 @@
+/*
+ * CompileBudget.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_COMPILE_BUDGET_H
+#define XSC_COMPILE_BUDGET_H
+
+
+#include <Xsc/Xsc.h>
+#include <Xsc/Log.h>
+#include <chrono>
+#include <cstddef>
+
+
+namespace Xsc
+{
+
+
+/*
+Budget guard for one compilation (see ShaderInput::maxCompileTime). Pathological inputs — usually
+machine generated shaders with deep macro recursion or enormous expressions — can wedge a compile
+for minutes; the guard aborts such a compile with a "compile budget exceeded" error report instead.
+The budgets are verified at cheap checkpoints: "Validate" runs at the pass boundaries, and the
+frontend token funnel calls "CountToken", which amortizes the wall-time and arena checks over a
+fixed token interval, so the hot path pays one increment and one compare per token.
+*/
+class CompileBudget
+{
+
+    public:
+
+        explicit CompileBudget(const ShaderInput& inputDesc);
+
+        // Returns true if at least one budget is configured, i.e. the guard has to be active.
+        inline bool AnyLimit() const
+        {
+            return (maxCompileTime_ > 0 || maxArenaBytes_ > 0 || maxTokens_ > 0);
+        }
+
+        /*
+        Counts one token served to the frontend against the budgets. Every few thousand tokens the
+        full checkpoint runs, which throws a budget-exceeded report if a budget is exhausted
+        (the report is caught and submitted by the active frontend pass, like any scan error).
+        Once the report was delivered, further checkpoints throw the silent abort signal instead,
+        so passes with local error recovery (e.g. the deferred function bodies) unwind without
+        submitting the report again (see ErrorLimitAbort).
+        */
+        inline void CountToken()
+        {
+            if (++numTokens_ >= nextCheckpointTokens_)
+                TokenCheckpoint();
+        }
+
+        // Verifies all budgets at a pass boundary; submits a budget-exceeded error report and returns false if one is exhausted.
+        bool Validate(Log* log);
+
+    private:
+
+        // Number of tokens between two full checks of the wall-time and arena budgets.
+        static const std::size_t checkpointInterval_ = 16384;
+
+        // Runs the full checkpoint and schedules the next one (see CountToken).
+        void TokenCheckpoint();
+
+        // Returns the description of the first exhausted budget, or an empty string if all budgets hold.
+        std::string CheckBudgets() const;
+
+        std::chrono::steady_clock::time_point   startTime_;
+
+        std::size_t                             maxCompileTime_         = 0; //< in milliseconds
+        std::size_t                             maxArenaBytes_          = 0;
+        std::size_t                             maxTokens_              = 0;
+
+        std::size_t                             numTokens_              = 0;
+        std::size_t                             nextCheckpointTokens_   = 0;
+
+        // True if the budget-exceeded report was already delivered (it must only appear once in the log).
+        bool                                    reported_               = false;
+
+};
+
+/*
+Returns the budget guard of the compilation active on this thread, or null if no budget is
+configured (see CompileBudgetScope). The guard is published through a thread-local pointer
+(like ActiveCompileStats), so the token funnel needs no reference threaded through the scanners.
+*/
+CompileBudget* ActiveCompileBudget();
+
+// RAII scope that makes the budgets of the specified input descriptor the active ones of the current thread.
+class CompileBudgetScope
+{
+
+    public:
+
+        // Activates the budget guard, unless the input descriptor configures no budget (the guard then stays inactive).
+        explicit CompileBudgetScope(const ShaderInput& inputDesc);
+        ~CompileBudgetScope();
+
+        CompileBudgetScope(const CompileBudgetScope&) = delete;
+        CompileBudgetScope& operator = (const CompileBudgetScope&) = delete;
+
+    private:
+
+        CompileBudget   budget_;
+        CompileBudget*  previous_   = nullptr;
+
+};
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,119 @@
+/*
+ * CompileCache.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Xsc/CompileCache.h>
+
+
+namespace Xsc
+{
+
+
+// Eviction priority of the preprocessed source caches: refilling costs one preprocessor run (see CacheRegistry).
+static const int compileCacheEvictionPriority_ = 1;
+
+// Returns the approximate memory footprint of the specified cache entry (string payloads plus container overhead).
+static std::size_t PreProcessedSourceBytes(const CompileCache::PreProcessedSource& source)
+{
+    std::size_t numBytes = sizeof(CompileCache::PreProcessedSource) + source.output.size();
+
+    for (const auto& include : source.includes)
+        numBytes += sizeof(CompileCache::IncludeReference) + include.filename.size();
+
+    for (const auto& macro : source.macros)
+        numBytes += sizeof(std::string) + macro.size();
+
+    return numBytes;
+}
+
+CompileCache::CompileCache()
+{
+    CacheRegistry::Instance().Register(*this, compileCacheEvictionPriority_);
+}
+
+CompileCache::~CompileCache()
+{
+    CacheRegistry::Instance().Unregister(*this);
+}
+
+void CompileCache::Clear()
+{
+    preProcessedSources_.clear();
+    CacheRegistry::Instance().ClearEntries(*this);
+}
+
+const CompileCache::PreProcessedSource* CompileCache::FetchPreProcessedSource(std::uint64_t sourceHash) const
+{
+    auto it = preProcessedSources_.find(sourceHash);
+    if (it != preProcessedSources_.end())
+    {
+        it->second.lastAccess = CacheRegistry::Instance().NextAccessTick();
+        return &(it->second.source);
+    }
+    return nullptr;
+}
+
+void CompileCache::StorePreProcessedSource(std::uint64_t sourceHash, PreProcessedSource&& entry)
+{
+    auto& registry = CacheRegistry::Instance();
+
+    /* Settle a pending eviction debt first, so this cache stays inside its share of the memory budget */
+    registry.SettleEvictionDebt(*this);
+
+    auto it = preProcessedSources_.find(sourceHash);
+    if (it != preProcessedSources_.end())
+    {
+        registry.RemoveEntry(*this, it->second.numBytes, false);
+        preProcessedSources_.erase(it);
+    }
+
+    Entry cacheEntry;
+    {
+        cacheEntry.source     = std::move(entry);
+        cacheEntry.numBytes   = PreProcessedSourceBytes(cacheEntry.source);
+        cacheEntry.lastAccess = registry.NextAccessTick();
+    }
+
+    const auto numBytes = cacheEntry.numBytes;
+    preProcessedSources_[sourceHash] = std::move(cacheEntry);
+
+    registry.AddEntry(*this, numBytes);
+}
+
+const char* CompileCache::CacheName() const
+{
+    return "preprocessed sources";
+}
+
+void CompileCache::EvictOldest(std::size_t bytesToFree)
+{
+    auto& registry = CacheRegistry::Instance();
+
+    std::size_t freedBytes = 0;
+
+    while (freedBytes < bytesToFree && !preProcessedSources_.empty())
+    {
+        /* Find the least recently used entry (linear scan; eviction is rare compared to lookups) */
+        auto oldest = preProcessedSources_.begin();
+
+        for (auto it = preProcessedSources_.begin(); it != preProcessedSources_.end(); ++it)
+        {
+            if (it->second.lastAccess < oldest->second.lastAccess)
+                oldest = it;
+        }
+
+        freedBytes += oldest->second.numBytes;
+        registry.RemoveEntry(*this, oldest->second.numBytes, true);
+        preProcessedSources_.erase(oldest);
+    }
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
@@ -0,0 +1,91 @@
+/*
+ * CompileStats.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "CompileStats.h"
+#include <algorithm>
+
+
+namespace Xsc
+{
+
+
+static thread_local CompileStats* activeCompileStats = nullptr;
+
+CompileStats* ActiveCompileStats()
+{
+    return activeCompileStats;
+}
+
+#ifdef XSC_ENABLE_ALLOC_TRACKING
+
+/*
+The live-bytes counter spans compilations (allocations may outlive a pass or a compile),
+while the active pass entry points into the allocation list of the active statistics.
+*/
+static thread_local std::size_t                     liveTrackedBytes        = 0;
+static thread_local CompileStats::AllocationStats*  activeAllocationStats   = nullptr;
+
+void AllocTrackingBeginStage(const char* stageName)
+{
+    activeAllocationStats = nullptr;
+
+    if (auto stats = activeCompileStats)
+    {
+        CompileStats::AllocationStats entry;
+        entry.stage     = stageName;
+        entry.peakBytes = liveTrackedBytes;
+
+        stats->allocationStats.push_back(entry);
+        activeAllocationStats = &(stats->allocationStats.back());
+    }
+}
+
+void AllocTrackingEndStage()
+{
+    activeAllocationStats = nullptr;
+}
+
+void AllocTrackingOnAlloc(std::size_t numBytes)
+{
+    liveTrackedBytes += numBytes;
+
+    if (auto entry = activeAllocationStats)
+    {
+        ++entry->numAllocations;
+        entry->numBytes += numBytes;
+        entry->peakBytes = std::max(entry->peakBytes, liveTrackedBytes);
+    }
+}
+
+void AllocTrackingOnFree(std::size_t numBytes)
+{
+    liveTrackedBytes -= std::min(numBytes, liveTrackedBytes);
+}
+
+#endif
+
+CompileStatsScope::CompileStatsScope(CompileStats* stats) :
+    previous_{ activeCompileStats }
+{
+    activeCompileStats = stats;
+
+    /* The pass entries of an enclosing scope must not account allocations of this compile */
+    AllocTrackingEndStage();
+}
+
+CompileStatsScope::~CompileStatsScope()
+{
+    activeCompileStats = previous_;
+    AllocTrackingEndStage();
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
@@ -0,0 +1,121 @@
+/*
+ * CompileStats.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_COMPILE_STATS_H
+#define XSC_COMPILE_STATS_H
+
+
+#include <Xsc/Xsc.h>
+
+
+namespace Xsc
+{
+
+
+/*
+Returns the instrumentation statistics of the compilation active on this thread,
+or null if the caller did not request any (see ShaderOutput::compileStats).
+Hot-path counters (e.g. tokens scanned, symbol table fetches) are accumulated through
+this pointer, so passes need not thread a statistics reference through their interfaces.
+*/
+CompileStats* ActiveCompileStats();
+
+/*
+Allocation tracking hooks (see CompileStats::allocationStats). When the compiler is built with
+XSC_ENABLE_ALLOC_TRACKING, the tracked allocators report each allocation to the pass entry opened
+by the last "AllocTrackingBeginStage" call; otherwise all hooks compile to nothing.
+*/
+#ifdef XSC_ENABLE_ALLOC_TRACKING
+
+// Opens a new per-pass allocation entry in the active statistics (see CompileShaderPrimary for the pass boundaries).
+void AllocTrackingBeginStage(const char* stageName);
+
+// Closes the current per-pass allocation entry.
+void AllocTrackingEndStage();
+
+void AllocTrackingOnAlloc(std::size_t numBytes);
+void AllocTrackingOnFree(std::size_t numBytes);
+
+#else
+
+inline void AllocTrackingBeginStage(const char*) {}
+inline void AllocTrackingEndStage() {}
+inline void AllocTrackingOnAlloc(std::size_t) {}
+inline void AllocTrackingOnFree(std::size_t) {}
+
+#endif
+
+// STL compatible allocator adapter that reports all allocations to the allocation tracking hooks.
+template <typename T>
+class TrackingAllocator
+{
+
+    public:
+
+        using value_type = T;
+
+        TrackingAllocator() = default;
+
+        template <typename U>
+        TrackingAllocator(const TrackingAllocator<U>&)
+        {
+        }
+
+        T* allocate(std::size_t count)
+        {
+            AllocTrackingOnAlloc(sizeof(T) * count);
+            return reinterpret_cast<T*>(::operator new (sizeof(T) * count));
+        }
+
+        void deallocate(T* ptr, std::size_t count)
+        {
+            AllocTrackingOnFree(sizeof(T) * count);
+            ::operator delete (ptr);
+        }
+
+};
+
+template <typename T, typename U>
+bool operator == (const TrackingAllocator<T>&, const TrackingAllocator<U>&)
+{
+    return true;
+}
+
+template <typename T, typename U>
+bool operator != (const TrackingAllocator<T>&, const TrackingAllocator<U>&)
+{
+    return false;
+}
+
+// RAII scope that makes the specified statistics the active ones of the current thread (see ActiveCompileStats).
+class CompileStatsScope
+{
+
+    public:
+
+        // Activates the specified statistics; null deactivates the instrumentation for this scope.
+        explicit CompileStatsScope(CompileStats* stats);
+        ~CompileStatsScope();
+
+        CompileStatsScope(const CompileStatsScope&) = delete;
+        CompileStatsScope& operator = (const CompileStatsScope&) = delete;
+
+    private:
+
+        CompileStats* previous_ = nullptr;
+
+};
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,63 @@
+/*
+ * CompilerContext.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Xsc/CompilerContext.h>
+#include <algorithm>
+
+
+namespace Xsc
+{
+
+
+void CompilerContext::Clear()
+{
+    configHash_             = 0;
+    declHashes_.clear();
+    outputCode_.clear();
+    numChangedDeclarations_ = 0;
+    valid_                  = false;
+}
+
+bool CompilerContext::MatchDeclarationHashes(std::uint64_t configHash, const std::vector<std::uint64_t>& declHashes)
+{
+    if (!valid_ || configHash != configHash_)
+    {
+        /* First compilation, or the configuration changed: count all declarations as changed */
+        numChangedDeclarations_ = declHashes.size();
+        return false;
+    }
+
+    /* Count declarations whose hash differs from the retained one (added or removed declarations count as changed) */
+    auto numCommon = std::min(declHashes.size(), declHashes_.size());
+    auto numExtra  = std::max(declHashes.size(), declHashes_.size()) - numCommon;
+
+    std::size_t numChanged = 0;
+    for (std::size_t i = 0; i < numCommon; ++i)
+    {
+        if (declHashes[i] != declHashes_[i])
+            ++numChanged;
+    }
+
+    numChangedDeclarations_ = numChanged + numExtra;
+
+    return (numChangedDeclarations_ == 0);
+}
+
+void CompilerContext::StoreCompilation(std::uint64_t configHash, std::vector<std::uint64_t>&& declHashes, std::string&& outputCode)
+{
+    configHash_ = configHash;
+    declHashes_ = std::move(declHashes);
+    outputCode_ = std::move(outputCode);
+    valid_      = true;
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
@@ -0,0 +1,78 @@
+/*
+ * CompilerInstance.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Xsc/CompilerInstance.h>
+#include "EntryPointCache.h"
+#include "MemoryPool.h"
+#include "StringInterner.h"
+#include "Helper.h"
+
+
+namespace Xsc
+{
+
+
+// Memory retained across compilation calls; the per-compile scopes inside "CompileShader" adopt these objects.
+struct CompilerInstance::State
+{
+    #ifdef XSC_ENABLE_MEMORY_POOL
+    MemoryPool      memoryPool;
+    #endif
+
+    StringInterner  stringInterner;
+    EntryPointCache entryPointCache;
+};
+
+
+CompilerInstance::CompilerInstance() :
+    state_{ MakeUnique<State>() }
+{
+}
+
+CompilerInstance::~CompilerInstance()
+{
+    // dtor for incomplete type "State" must be defined here
+}
+
+bool CompilerInstance::CompileShader(const ShaderInput& inputDesc, const ShaderOutput& outputDesc, Log* log)
+{
+    #ifdef XSC_ENABLE_MEMORY_POOL
+    /* Rewind the retained arena (all objects of the previous compile are dead) and activate it for this call */
+    state_->memoryPool.Reset();
+    MemoryPoolScope memoryPoolScope(state_->memoryPool);
+    #endif
+
+    StringInternerScope stringInternerScope(state_->stringInterner);
+    EntryPointCacheScope entryPointCacheScope(state_->entryPointCache);
+
+    return Xsc::CompileShader(inputDesc, outputDesc, log);
+}
+
+bool CompilerInstance::CompileShader(const ShaderInput& inputDesc, const ShaderOutput& outputDesc, Log* log, CompilerContext& context)
+{
+    #ifdef XSC_ENABLE_MEMORY_POOL
+    state_->memoryPool.Reset();
+    MemoryPoolScope memoryPoolScope(state_->memoryPool);
+    #endif
+
+    StringInternerScope stringInternerScope(state_->stringInterner);
+    EntryPointCacheScope entryPointCacheScope(state_->entryPointCache);
+
+    return Xsc::CompileShader(inputDesc, outputDesc, log, context);
+}
+
+void CompilerInstance::Clear()
+{
+    state_ = MakeUnique<State>();
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
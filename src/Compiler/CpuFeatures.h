@@ -0,0 +1,41 @@
+/*
+ * CpuFeatures.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_CPU_FEATURES_H
+#define XSC_CPU_FEATURES_H
+
+
+namespace Xsc
+{
+
+
+// SIMD feature set of the executing CPU (detected in the "Platform" folder).
+struct CpuFeatures
+{
+    bool sse2   = false;
+    bool sse42  = false;
+    bool avx2   = false;
+    bool neon   = false;
+};
+
+/*
+Returns the SIMD features of the executing CPU. The features are detected once on first use
+and the vectorized kernels are selected through function pointers against this set, so one
+shipped binary takes the fastest available path on every machine (see the character-run
+kernel dispatch in SourceCode.cpp).
+*/
+const CpuFeatures& QueryCpuFeatures();
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,35 @@
+/*
+ * DirectoryListing.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_DIRECTORY_LISTING_H
+#define XSC_DIRECTORY_LISTING_H
+
+
+#include <string>
+#include <vector>
+
+
+namespace Xsc
+{
+
+
+/*
+Reads the names of all entries in the specified directory (implemented in the "Platform" folder).
+Returns false if the directory cannot be read (e.g. it does not exist); the "." and ".."
+entries are omitted, and the names are reported as stored by the filesystem.
+*/
+bool ListDirectory(const std::string& path, std::vector<std::string>& entries);
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
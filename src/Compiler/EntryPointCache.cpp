@@ -0,0 +1,54 @@
+/*
+ * EntryPointCache.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "EntryPointCache.h"
+
+
+namespace Xsc
+{
+
+
+static thread_local EntryPointCache* activeEntryPointCache = nullptr;
+
+EntryPointCache* EntryPointCache::Active()
+{
+    return activeEntryPointCache;
+}
+
+bool EntryPointCache::IsWarm(const std::string& entryPoint, std::uint64_t signatureHash) const
+{
+    auto it = signatures_.find(entryPoint);
+    return (it != signatures_.end() && it->second == signatureHash);
+}
+
+void EntryPointCache::Store(const std::string& entryPoint, std::uint64_t signatureHash)
+{
+    signatures_[entryPoint] = signatureHash;
+}
+
+
+/*
+ * EntryPointCacheScope class
+ */
+
+EntryPointCacheScope::EntryPointCacheScope(EntryPointCache& cache) :
+    previous_{ activeEntryPointCache }
+{
+    activeEntryPointCache = &cache;
+}
+
+EntryPointCacheScope::~EntryPointCacheScope()
+{
+    activeEntryPointCache = previous_;
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
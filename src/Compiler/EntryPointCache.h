@@ -0,0 +1,84 @@
+/*
+ * EntryPointCache.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_ENTRY_POINT_CACHE_H
+#define XSC_ENTRY_POINT_CACHE_H
+
+
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+
+namespace Xsc
+{
+
+
+/*
+Warm entry-point signature cache for multi-permutation compiles.
+Permutation compiles of the same file (differing only in "#define"d body code) re-resolve an identical
+entry-point signature on every call. The analyzer records a hash over the resolved signature (parameter
+and return types including the input/output struct layouts, semantics, and directions) per entry point
+name; when a later compile resolves the same hash, the signature is known to have validated before and
+the analyzer skips its validation diagnostics (see HLSLAnalyzer::AnalyzeEntryPoint). The decoration
+itself (flags and semantic lists) always runs, since each compile builds a fresh AST.
+*/
+class EntryPointCache
+{
+
+    public:
+
+        EntryPointCache() = default;
+
+        EntryPointCache(const EntryPointCache&) = delete;
+        EntryPointCache& operator = (const EntryPointCache&) = delete;
+
+        // Returns the active entry-point cache of the calling thread (may be null, see EntryPointCacheScope).
+        static EntryPointCache* Active();
+
+        // Returns true if the specified signature hash matches the recorded hash for the entry point.
+        bool IsWarm(const std::string& entryPoint, std::uint64_t signatureHash) const;
+
+        // Records the signature hash of a successfully validated entry point.
+        void Store(const std::string& entryPoint, std::uint64_t signatureHash);
+
+    private:
+
+        std::unordered_map<std::string, std::uint64_t> signatures_;
+
+};
+
+
+// Helper class to activate an entry-point cache for the calling thread within a scope (RAII principle).
+class EntryPointCacheScope
+{
+
+    public:
+
+        // Activates the specified external cache (e.g. one retained across compiles by a CompilerInstance).
+        explicit EntryPointCacheScope(EntryPointCache& cache);
+
+        ~EntryPointCacheScope();
+
+        EntryPointCacheScope(const EntryPointCacheScope&) = delete;
+        EntryPointCacheScope& operator = (const EntryPointCacheScope&) = delete;
+
+    private:
+
+        EntryPointCache* previous_ = nullptr;
+
+};
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
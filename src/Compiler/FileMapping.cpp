@@ -0,0 +1,76 @@
+/*
+ * FileMapping.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "FileMapping.h"
+
+#include <utility>
+
+
+namespace Xsc
+{
+
+
+/*
+ * FileMapping class
+ */
+
+FileMapping::FileMapping(const std::string& filename)
+{
+    OpenMapping(filename);
+}
+
+FileMapping::FileMapping(FileMapping&& rhs) :
+    data_           { rhs.data_          },
+    size_           { rhs.size_          },
+    fileHandle_     { rhs.fileHandle_    },
+    mappingHandle_  { rhs.mappingHandle_ }
+{
+    rhs.data_           = nullptr;
+    rhs.size_           = 0;
+    rhs.fileHandle_     = nullptr;
+    rhs.mappingHandle_  = nullptr;
+}
+
+FileMapping::~FileMapping()
+{
+    CloseMapping();
+}
+
+
+/*
+ * FileMappingBuf class
+ */
+
+void FileMappingBuf::SetBuffer(const char* data, std::size_t size)
+{
+    /* Stream buffer is used for reading only, thus the const-cast is safe here */
+    auto buf = const_cast<char*>(data);
+    setg(buf, buf, buf + size);
+}
+
+
+/*
+ * FileMappingStream class
+ */
+
+FileMappingStream::FileMappingStream(FileMapping&& mapping) :
+    std::istream { nullptr              },
+    mapping_     { std::move(mapping)   }
+{
+    if (mapping_.IsValid())
+    {
+        buf_.SetBuffer(mapping_.Data(), mapping_.Size());
+        rdbuf(&buf_);
+    }
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
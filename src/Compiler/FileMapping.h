@@ -0,0 +1,114 @@
+/*
+ * FileMapping.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_FILE_MAPPING_H
+#define XSC_FILE_MAPPING_H
+
+
+#include <istream>
+#include <streambuf>
+#include <string>
+#include <cstddef>
+
+
+namespace Xsc
+{
+
+
+// Read-only memory mapping of a file (implemented in the "Platform" folder).
+class FileMapping
+{
+
+    public:
+
+        FileMapping() = default;
+
+        FileMapping(const FileMapping&) = delete;
+        FileMapping& operator = (const FileMapping&) = delete;
+
+        // Tries to map the specified file into memory (see "IsValid").
+        FileMapping(const std::string& filename);
+
+        FileMapping(FileMapping&& rhs);
+
+        ~FileMapping();
+
+        // Returns true if the file has been mapped successfully.
+        inline bool IsValid() const
+        {
+            return (data_ != nullptr);
+        }
+
+        // Returns a pointer to the mapped file content.
+        inline const char* Data() const
+        {
+            return data_;
+        }
+
+        // Returns the size (in bytes) of the mapped file content.
+        inline std::size_t Size() const
+        {
+            return size_;
+        }
+
+    private:
+
+        /* === Platform specific functions (see "Platform" folder) === */
+
+        void OpenMapping(const std::string& filename);
+        void CloseMapping();
+
+        const char* data_           = nullptr;
+        std::size_t size_           = 0;
+
+        // Platform dependent file and mapping handles (only used by the Win32 implementation).
+        void*       fileHandle_     = nullptr;
+        void*       mappingHandle_  = nullptr;
+
+};
+
+// Stream buffer that serves its get area directly from a file mapping (no buffer copies).
+class FileMappingBuf : public std::streambuf
+{
+
+    public:
+
+        // Sets the get area to the specified read-only buffer.
+        void SetBuffer(const char* data, std::size_t size);
+
+};
+
+// Input stream over a memory mapped file; "SourceCode" borrows the mapped buffer directly.
+class FileMappingStream : public std::istream
+{
+
+    public:
+
+        FileMappingStream(FileMapping&& mapping);
+
+        // Returns the file mapping this stream reads from.
+        inline const FileMapping& GetMapping() const
+        {
+            return mapping_;
+        }
+
+    private:
+
+        FileMapping     mapping_;
+        FileMappingBuf  buf_;
+
+};
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
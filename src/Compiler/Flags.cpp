@@ -0,0 +1,27 @@
+/*
+ * Flags.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "Flags.h"
+
+
+namespace Xsc
+{
+
+
+thread_local unsigned int Flags::generation_ = 0;
+
+void Flags::ClearAll()
+{
+    generation_ = ((generation_ + 1u) & 0x0000ffffu);
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
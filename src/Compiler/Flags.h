@@ -1,6 +1,6 @@
 /*
  * Flags.h
- * 
+ *
  * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
  * See "LICENSE.txt" for license information.
  */
@@ -13,37 +13,69 @@ namespace Xsc
 {
 
 
-// Common flags class.
+/*
+Common flags class with generation semantics.
+The 32-bit storage is split into a 16-bit flag mask (bits 0-15, see the FLAG macro in AST.h)
+and a 16-bit generation tag. An instance whose generation tag differs from the current
+per-thread generation reads as if all of its flags were cleared, so "ClearAll" invalidates
+the flags of every AST node at once without a tree walk (e.g. between multiple target
+emissions over the same decorated AST). All operations are inline and branch-free
+(the staleness check compiles to a conditional move, not a jump).
+*/
 class Flags
 {
-    
+
     public:
-        
+
         Flags() = default;
 
-        inline Flags(unsigned int flags) :
-            bitMask_{ flags }
+        inline Flags(unsigned int flags)
         {
+            *this << flags;
         }
 
         inline Flags& operator << (unsigned int flag)
         {
-            bitMask_ |= flag;
+            const auto current = (generation_ << genShift);
+            if ((bitMask_ & genBits) != current)
+                bitMask_ = current; // Stale generation: drop the old mask and adopt the current generation
+            bitMask_ |= (flag & maskBits);
             return *this;
         }
 
         inline bool operator () (unsigned int flag) const
         {
-            return ((bitMask_ & flag) != 0);
+            return ((Mask() & flag) != 0);
         }
 
         inline operator unsigned int () const
         {
-            return bitMask_;
+            return Mask();
         }
 
+        /*
+        Clears the flags of all instances on the calling thread in O(1) by advancing the
+        per-thread generation. The generation tag is 16 bits wide, so only flags set exactly
+        65536 clears earlier could be observed again; an AST never lives across that many
+        clears (a compile performs at most a handful).
+        */
+        static void ClearAll();
+
     private:
-        
+
+        static const unsigned int maskBits  = 0x0000ffffu;
+        static const unsigned int genBits   = 0xffff0000u;
+        static const unsigned int genShift  = 16u;
+
+        // Returns the flag mask, or 0 if this instance is from an older generation.
+        inline unsigned int Mask() const
+        {
+            const auto valid = ((bitMask_ & genBits) == (generation_ << genShift) ? maskBits : 0u);
+            return (bitMask_ & valid);
+        }
+
+        static thread_local unsigned int generation_;
+
         unsigned int bitMask_ = 0;
 
 };
@@ -56,4 +88,4 @@ class Flags
 
 
 
-// ================================================================================
\ No newline at end of file
+// ================================================================================
@@ -7,6 +7,7 @@
 
 #include "Analyzer.h"
 #include "Exception.h"
+#include "Helper.h"
 
 
 namespace Xsc
@@ -23,6 +24,8 @@ bool Analyzer::DecorateAST(
 {
     /* Decorate program AST */
     sourceCode_ = program.sourceCode.get();
+    reportHandler_.SetWarningsEnabled(outputDesc.options.warnings);
+    reportHandler_.SetErrorLimit(inputDesc.maxErrors);
 
     try
     {
@@ -36,6 +39,10 @@ bool Analyzer::DecorateAST(
     {
         Error(e.what());
     }
+    catch (const ErrorLimitAbort&)
+    {
+        /* The abort report was already submitted (see ShaderInput::maxErrors) */
+    }
 
     return (!reportHandler_.HasErros());
 }
@@ -80,7 +87,7 @@ void Analyzer::Warning(const std::string& msg, const AST* ast)
 
 void Analyzer::WarningOnNullStmnt(const StmntPtr& ast, const std::string& stmntTypeName)
 {
-    if (ast && ast->Type() == AST::Types::NullStmnt)
+    if (WarningEnabled() && ast && ast->Type() == AST::Types::NullStmnt)
         Warning("<" + stmntTypeName + "> statement with empty body", ast.get());
 }
 
@@ -102,7 +109,7 @@ void Analyzer::Register(const std::string& ident, AST* ast)
     {
         symTable_.Register(
             ident,
-            std::make_shared<ASTSymbolOverload>(ident, ast),
+            MakeShared<ASTSymbolOverload>(ident, ast),
             [&](ASTSymbolOverloadPtr& prevSymbol) -> bool
             {
                 return prevSymbol->AddSymbolRef(ast);
@@ -353,7 +360,7 @@ void Analyzer::AnalyzeAliasTypeDenoter(TypeDenoterPtr& typeDenoter, AST* ast)
             if (auto structDecl = symbol->As<StructDecl>())
             {
                 /* Replace type denoter by a struct type denoter */
-                typeDenoter = std::make_shared<StructTypeDenoter>(structDecl);
+                typeDenoter = MakeShared<StructTypeDenoter>(structDecl);
             }
             else if (auto aliasDecl = symbol->As<AliasDecl>())
             {
@@ -61,6 +61,12 @@ class Analyzer : protected Visitor
         void Warning(const std::string& msg, const AST* ast = nullptr);
         void WarningOnNullStmnt(const StmntPtr& ast, const std::string& stmntTypeName);
 
+        // Returns true if warnings are enabled. Consult this before formatting a warning message (see ReportHandler::WarningsEnabled).
+        inline bool WarningEnabled() const
+        {
+            return reportHandler_.WarningsEnabled();
+        }
+
         // Returns the report handler.
         inline ReportHandler& GetReportHandler()
         {
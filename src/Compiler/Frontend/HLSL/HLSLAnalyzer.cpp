@@ -9,6 +9,7 @@
 #include "HLSLIntrinsics.h"
 #include "ConstExprEvaluator.h"
 #include "EndOfScopeAnalyzer.h"
+#include "EntryPointCache.h"
 #include "Exception.h"
 #include "Helper.h"
 
@@ -48,6 +49,9 @@ void HLSLAnalyzer::DecorateASTPrimary(
     program_ = &program;
 
     Visit(&program);
+
+    /* Analyze the deferred function bodies that are referenced from the entry point */
+    AnalyzeDeferredFunctionBodies();
 }
 
 
@@ -115,10 +119,9 @@ IMPLEMENT_VISIT_PROC(FunctionCall)
                 AnalyzeVarIdent(ast->varIdent.get());
 
                 /* Check if the function call refers to an intrinsic */
-                auto intrIt = HLSLIntrinsics().find(ast->varIdent->next->ident);
-                if (intrIt != HLSLIntrinsics().end())
+                if (auto intrEntry = FetchHLSLIntrinsic(ast->varIdent->next->ident))
                 {
-                    auto intrinsic = intrIt->second.intrinsic;
+                    auto intrinsic = intrEntry->intrinsic;
 
                     /* Verify intrinsic for respective object class */
                     switch (ast->varIdent->symbolRef->Type())
@@ -132,7 +135,7 @@ IMPLEMENT_VISIT_PROC(FunctionCall)
                             break;
                     }
 
-                    AnalyzeFunctionCallIntrinsic(ast, intrIt->second);
+                    AnalyzeFunctionCallIntrinsic(ast, *intrEntry);
                 }
                 else
                     AnalyzeFunctionCallStandard(ast);
@@ -140,9 +143,8 @@ IMPLEMENT_VISIT_PROC(FunctionCall)
             else
             {
                 /* Check if the function call refers to an intrinsic */
-                auto intrIt = HLSLIntrinsics().find(ast->varIdent->ident);
-                if (intrIt != HLSLIntrinsics().end())
-                    AnalyzeFunctionCallIntrinsic(ast, intrIt->second);
+                if (auto intrEntry = FetchHLSLIntrinsic(ast->varIdent->ident))
+                    AnalyzeFunctionCallIntrinsic(ast, *intrEntry);
                 else
                     AnalyzeFunctionCallStandard(ast);
             }
@@ -246,7 +248,7 @@ IMPLEMENT_VISIT_PROC(StructDecl)
     PopStructDecl();
 
     /* Report warning if structure is empty */
-    if (ast->NumMembers() == 0)
+    if (WarningEnabled() && ast->NumMembers() == 0)
         Warning("'" + ast->SignatureToString() + "' is completely empty", ast);
 }
 
@@ -286,15 +288,23 @@ IMPLEMENT_VISIT_PROC(FunctionDecl)
         if (isEntryPoint)
             AnalyzeEntryPoint(ast);
 
-        /* Visit function body */
-        PushFunctionDeclLevel(isEntryPoint);
+        if (!isEntryPoint && ast->codeBlock)
         {
-            Visit(ast->codeBlock);
+            /* Defer the body analysis until this function is referenced from the entry point (see AnalyzeDeferredFunctionBodies) */
+            deferredFunctionBodies_.insert(ast);
         }
-        PopFunctionDeclLevel();
+        else
+        {
+            /* Visit function body */
+            PushFunctionDeclLevel(isEntryPoint);
+            {
+                Visit(ast->codeBlock);
+            }
+            PopFunctionDeclLevel();
 
-        /* Analyze last statement of function body ('isEndOfFunction' flag) */
-        AnalyzeEndOfScopes(*ast);
+            /* Analyze last statement of function body ('isEndOfFunction' flag) */
+            AnalyzeEndOfScopes(*ast);
+        }
     }
     CloseScope();
 
@@ -565,13 +575,65 @@ void HLSLAnalyzer::AnalyzeFunctionCallStandard(FunctionCall* ast)
     {
         /* Fetch function declaratino by arguments */
         ast->funcDeclRef = FetchFunctionDecl(ast->varIdent->ident, ast->arguments, ast);
+
+        /* Request the body analysis of the called function */
+        if (ast->funcDeclRef)
+            RequestDeferredFunctionBody(*ast->funcDeclRef);
     }
 }
 
+void HLSLAnalyzer::RequestDeferredFunctionBody(FunctionDecl& funcDecl)
+{
+    auto it = deferredFunctionBodies_.find(&funcDecl);
+    if (it != deferredFunctionBodies_.end())
+    {
+        deferredFunctionBodies_.erase(it);
+        pendingFunctionBodies_.push_back(&funcDecl);
+    }
+}
+
+void HLSLAnalyzer::AnalyzeDeferredFunctionBodies()
+{
+    /* Analyze all pending function bodies at global scope; each of them may request further deferred bodies */
+    while (!pendingFunctionBodies_.empty())
+    {
+        auto funcDecl = pendingFunctionBodies_.back();
+        pendingFunctionBodies_.pop_back();
+
+        GetReportHandler().PushContextDesc(funcDecl->SignatureToString(false));
+
+        OpenScope();
+        {
+            /* Re-register the already analyzed parameters in the body scope */
+            for (auto& param : funcDecl->parameters)
+            {
+                for (auto& varDecl : param->varDecls)
+                    Register(varDecl->ident, varDecl.get());
+            }
+
+            /* Visit function body */
+            PushFunctionDeclLevel(false);
+            {
+                Visit(funcDecl->codeBlock);
+            }
+            PopFunctionDeclLevel();
+
+            /* Analyze last statement of function body ('isEndOfFunction' flag) */
+            AnalyzeEndOfScopes(*funcDecl);
+        }
+        CloseScope();
+
+        GetReportHandler().PopContextDesc();
+    }
+
+    /* All remaining deferred bodies are unreachable from the entry point and stay undecorated */
+    deferredFunctionBodies_.clear();
+}
+
 void HLSLAnalyzer::AnalyzeFunctionCallIntrinsic(FunctionCall* ast, const HLSLIntrinsicEntry& intr)
 {
     /* Check shader input version */
-    if (shaderModel_ < intr.minShaderModel)
+    if (WarningEnabled() && shaderModel_ < intr.minShaderModel)
     {
         Warning(
             "intrinsic '" + ast->varIdent->ToString() + "' requires shader model " + intr.minShaderModel.ToString() +
@@ -643,6 +705,10 @@ void HLSLAnalyzer::AnalyzeVarIdent(VarIdent* varIdent)
 {
     if (varIdent)
     {
+        /* Analyze the array index expressions of the entire identifier chain */
+        for (auto ident = varIdent; ident != nullptr; ident = ident->next.get())
+            Visit(ident->arrayIndices);
+
         try
         {
             auto symbol = Fetch(varIdent->ident);
@@ -731,13 +797,27 @@ void HLSLAnalyzer::AnalyzeEntryPoint(FunctionDecl* funcDecl)
     /* Mark this function declaration with the entry point flag */
     funcDecl->flags << FunctionDecl::isEntryPoint;
 
+    /*
+    Check the warm signature cache (if one is active, e.g. retained by a CompilerInstance):
+    permutation compiles of the same file resolve an identical signature, so a matching hash
+    means the signature validated before and its diagnostics can be skipped
+    */
+    auto cache = EntryPointCache::Active();
+    const auto signatureHash = (cache != nullptr ? EntryPointSignatureHash(funcDecl) : 0ull);
+
+    entryPointWarm_  = (signatureHash != 0 && cache->IsWarm(entryPoint_, signatureHash));
+    entryPointValid_ = true;
+
     /* Analyze all function parameters */
     for (auto& param : funcDecl->parameters)
     {
         if (param->varDecls.size() == 1)
             AnalyzeEntryPointParameter(funcDecl, param.get());
         else
+        {
+            entryPointValid_ = false;
             Error("invalid number of variable declarations in function parameter", param.get());
+        }
     }
 
     /* Analyze return type */
@@ -748,6 +828,10 @@ void HLSLAnalyzer::AnalyzeEntryPoint(FunctionDecl* funcDecl)
         AnalyzeEntryPointStructInOut(funcDecl, structTypeDen->structDeclRef, "", false);
     }
 
+    /* Record the validated signature for subsequent permutation compiles */
+    if (cache != nullptr && signatureHash != 0 && entryPointValid_)
+        cache->Store(entryPoint_, signatureHash);
+
     /* Check if fragment shader use a slightly different screen space (VPOS vs. SV_Position) */
     if (shaderTarget_ == ShaderTarget::FragmentShader && versionIn_ <= InputShaderVersion::HLSL3)
         program_->flags << Program::hasSM3ScreenSpace;
@@ -781,9 +865,20 @@ void HLSLAnalyzer::AnalyzeEntryPointParameterInOut(FunctionDecl* funcDecl, VarDe
         {
             if (varDecl->semantic.IsSystemValue())
                 varDecl->flags << VarDecl::isSystemValue;
+
+            /*
+            A fragment shader input with the position semantic is materialized as the fragment coordinate
+            by the code generation, even when the entry point body never reads it (e.g. an input structure
+            member), so the program flag must be set here and not only at the body references.
+            */
+            if (input && varDecl->semantic == Semantic::Position && shaderTarget_ == ShaderTarget::FragmentShader)
+                program_->flags << Program::isFragCoordUsed;
         }
-        else
+        else if (!entryPointWarm_)
+        {
+            entryPointValid_ = false;
             Error("missing semantic in parameter '" + varDecl->ident + "' of entry point", varDecl);
+        }
 
         /* Add variable declaration to the global input/output semantics */
         if (input)
@@ -818,6 +913,88 @@ void HLSLAnalyzer::AnalyzeEntryPointStructInOut(FunctionDecl* funcDecl, StructDe
         structDecl->flags << StructDecl::isShaderOutput;
 }
 
+std::uint64_t HLSLAnalyzer::EntryPointSignatureHash(FunctionDecl* funcDecl)
+{
+    std::string signature;
+    signature.reserve(256);
+
+    try
+    {
+        /* Include all parameters with their directions (the type denoters derived here are memoized on the nodes) */
+        for (auto& param : funcDecl->parameters)
+        {
+            if (param->varDecls.size() != 1)
+                return 0;
+
+            if (param->IsInput())
+                signature += 'i';
+            if (param->IsOutput())
+                signature += 'o';
+
+            AppendSignatureString(param->varDecls.front().get(), signature);
+        }
+
+        /* Include the return type (and its struct layout) with the return semantic */
+        signature += "->";
+
+        auto returnTypeDen = funcDecl->returnType->typeDenoter->Get();
+        if (auto structTypeDen = returnTypeDen->As<StructTypeDenoter>())
+        {
+            signature += "struct{";
+            if (structTypeDen->structDeclRef)
+            {
+                for (auto& member : structTypeDen->structDeclRef->members)
+                {
+                    for (auto& memberVar : member->varDecls)
+                        AppendSignatureString(memberVar.get(), signature);
+                }
+            }
+            signature += '}';
+        }
+        else
+        {
+            signature += returnTypeDen->ToString();
+            signature += ':';
+            signature += funcDecl->semantic.ToString();
+        }
+    }
+    catch (const std::exception&)
+    {
+        /* A type denoter could not be derived: leave the diagnosis to the regular (cold) analysis */
+        return 0;
+    }
+
+    return HashData(signature.data(), signature.size());
+}
+
+void HLSLAnalyzer::AppendSignatureString(VarDecl* varDecl, std::string& signature)
+{
+    auto varTypeDen = varDecl->GetTypeDenoter()->Get();
+    if (auto structTypeDen = varTypeDen->As<StructTypeDenoter>())
+    {
+        signature += varDecl->ident;
+        signature += ":struct{";
+        if (structTypeDen->structDeclRef)
+        {
+            for (auto& member : structTypeDen->structDeclRef->members)
+            {
+                for (auto& memberVar : member->varDecls)
+                    AppendSignatureString(memberVar.get(), signature);
+            }
+        }
+        signature += '}';
+    }
+    else
+    {
+        signature += varDecl->ident;
+        signature += ':';
+        signature += varTypeDen->ToString();
+        signature += ':';
+        signature += varDecl->semantic.ToString();
+        signature += ';';
+    }
+}
+
 void HLSLAnalyzer::AnalyzeSemantic(IndexedSemantic& semantic)
 {
     if (semantic == Semantic::Position && shaderTarget_ == ShaderTarget::VertexShader)
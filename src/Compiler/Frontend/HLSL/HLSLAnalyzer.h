@@ -14,6 +14,8 @@
 #include "Variant.h"
 #include <Xsc/SamplerState.h>
 #include <map>
+#include <set>
+#include <cstdint>
 
 
 namespace Xsc
@@ -100,10 +102,26 @@ class HLSLAnalyzer : public Analyzer
         void AnalyzeEntryPointParameterInOut(FunctionDecl* funcDecl, VarDecl* varDecl, bool input);
         void AnalyzeEntryPointStructInOut(FunctionDecl* funcDecl, StructDecl* structDecl, const std::string& structAliasName, bool input);
 
+        /*
+        Returns the hash over the resolved entry-point signature (parameter and return types including
+        struct layouts, semantics, and directions), or 0 if the signature can not be hashed
+        (e.g. a type denoter can not be derived yet). See EntryPointCache.
+        */
+        std::uint64_t EntryPointSignatureHash(FunctionDecl* funcDecl);
+        void AppendSignatureString(VarDecl* varDecl, std::string& signature);
+
         void AnalyzeSemantic(IndexedSemantic& semantic);
 
         void AnalyzeEndOfScopes(FunctionDecl& funcDecl);
 
+        /* ----- Deferred function bodies ----- */
+
+        // Moves the function body into the pending queue, if its analysis is still deferred (see AnalyzeDeferredFunctionBodies).
+        void RequestDeferredFunctionBody(FunctionDecl& funcDecl);
+
+        // Analyzes all pending function bodies, i.e. only those that are referenced from the entry point.
+        void AnalyzeDeferredFunctionBodies();
+
         void AnalyzeSamplerValue(SamplerValue* ast, SamplerState& samplerState);
         void AnalyzeSamplerValueFilter(const std::string& value, SamplerState::Filter& filter);
         void AnalyzeSamplerValueTextureAddressMode(const std::string& value, SamplerState::TextureAddressMode& addressMode);
@@ -120,6 +138,14 @@ class HLSLAnalyzer : public Analyzer
         bool                        preferWrappers_ = false;
         Statistics*                 statistics_     = nullptr;
 
+        // Function declarations whose body analysis is deferred until they are referenced from the entry point.
+        std::set<FunctionDecl*>     deferredFunctionBodies_;
+        std::vector<FunctionDecl*>  pendingFunctionBodies_;
+
+        // True if the entry-point signature matched the warm cache, so its validation diagnostics are skipped (see EntryPointCache).
+        bool                        entryPointWarm_ = false;
+        bool                        entryPointValid_ = true;
+
 };
 
 
@@ -9,19 +9,29 @@
 #include "AST.h"
 #include "Helper.h"
 #include "Exception.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <vector>
 
 
 namespace Xsc
 {
 
 
-/* ----- HLSLIntrinsics ----- */
+/* ----- FetchHLSLIntrinsic ----- */
 
-static HLSLIntrinsicsMap GenerateIntrinsicMap()
+struct HLSLIntrinsicRecord
+{
+    const char*         ident;
+    HLSLIntrinsicEntry  entry;
+};
+
+static std::vector<HLSLIntrinsicRecord> GenerateIntrinsicTable()
 {
     using T = Intrinsic;
 
-    return
+    std::vector<HLSLIntrinsicRecord> table
     {
         { "abort",                              { T::Abort,                             4, 0 } },
         { "abs",                                { T::Abs,                               1, 1 } },
@@ -168,12 +178,49 @@ static HLSLIntrinsicsMap GenerateIntrinsicMap()
         { "SampleGrad",                         { T::Texture_SampleGrad_4,              4, 0 } },
         { "SampleLevel",                        { T::Texture_SampleLevel_3,             4, 0 } },
     };
+
+    /* Sort table into strcmp order for the binary search (the listing above is kept in readable order) */
+    std::sort(
+        table.begin(), table.end(),
+        [](const HLSLIntrinsicRecord& lhs, const HLSLIntrinsicRecord& rhs)
+        {
+            return (std::strcmp(lhs.ident, rhs.ident) < 0);
+        }
+    );
+
+    return table;
+}
+
+// Returns the sorted intrinsic table (generated once, immutable afterwards).
+static const std::vector<HLSLIntrinsicRecord>& IntrinsicTable()
+{
+    static const auto intrinsicTable = GenerateIntrinsicTable();
+    return intrinsicTable;
+}
+
+const HLSLIntrinsicEntry* FetchHLSLIntrinsic(const std::string& ident)
+{
+    const auto& intrinsicTable = IntrinsicTable();
+
+    /* Binary search the intrinsic entry in the contiguous table */
+    auto it = std::lower_bound(
+        intrinsicTable.begin(), intrinsicTable.end(), ident.c_str(),
+        [](const HLSLIntrinsicRecord& rec, const char* id)
+        {
+            return (std::strcmp(rec.ident, id) < 0);
+        }
+    );
+
+    if (it != intrinsicTable.end() && std::strcmp(it->ident, ident.c_str()) == 0)
+        return &(it->entry);
+
+    return nullptr;
 }
 
-const HLSLIntrinsicsMap& HLSLIntrinsics()
+void CollectHLSLIntrinsicIdents(std::unordered_set<std::string>& vocabulary)
 {
-    static const HLSLIntrinsicsMap intrinsicMap = GenerateIntrinsicMap();
-    return intrinsicMap;
+    for (const auto& rec : IntrinsicTable())
+        vocabulary.insert(rec.ident);
 }
 
 
@@ -234,7 +281,7 @@ TypeDenoterPtr IntrinsicDescriptor::GetTypeDenoterWithArgs(const std::vector<Exp
     if (dataType_ != DataType::Undefined)
     {
         /* Return fixed base type denoter */
-        return MakeShared<BaseTypeDenoter>(dataType_);
+        return GetCanonicalBaseTypeDenoter(dataType_);
     }
     else if (takeByArgIndex_ != ArgUndefined)
     {
@@ -444,7 +491,7 @@ TypeDenoterPtr GetTypeDenoterForHLSLIntrinsicWithArgs(const Intrinsic intrinsic,
             if (type1->IsVector())
             {
                 auto baseDataType0 = BaseDataType(static_cast<BaseTypeDenoter&>(*type0).dataType);
-                return MakeShared<BaseTypeDenoter>(baseDataType0); // scalar
+                return GetCanonicalBaseTypeDenoter(baseDataType0); // scalar
             }
 
             if (type1->IsMatrix())
@@ -452,7 +499,7 @@ TypeDenoterPtr GetTypeDenoterForHLSLIntrinsicWithArgs(const Intrinsic intrinsic,
                 auto dataType1      = static_cast<BaseTypeDenoter&>(*type1).dataType;
                 auto baseDataType1  = BaseDataType(dataType1);
                 auto matrixTypeDim1 = MatrixTypeDim(dataType1);
-                return MakeShared<BaseTypeDenoter>(VectorDataType(baseDataType1, matrixTypeDim1.second));
+                return GetCanonicalBaseTypeDenoter(VectorDataType(baseDataType1, matrixTypeDim1.second));
             }
         }
 
@@ -466,7 +513,7 @@ TypeDenoterPtr GetTypeDenoterForHLSLIntrinsicWithArgs(const Intrinsic intrinsic,
                 auto dataType0      = static_cast<BaseTypeDenoter&>(*type0).dataType;
                 auto baseDataType0  = BaseDataType(dataType0);
                 auto matrixTypeDim0 = MatrixTypeDim(dataType0);
-                return MakeShared<BaseTypeDenoter>(VectorDataType(baseDataType0, matrixTypeDim0.first));
+                return GetCanonicalBaseTypeDenoter(VectorDataType(baseDataType0, matrixTypeDim0.first));
             }
 
             if (type1->IsMatrix())
@@ -476,7 +523,7 @@ TypeDenoterPtr GetTypeDenoterForHLSLIntrinsicWithArgs(const Intrinsic intrinsic,
                 auto matrixTypeDim0 = MatrixTypeDim(dataType0);
                 auto dataType1      = static_cast<BaseTypeDenoter&>(*type1).dataType;
                 auto matrixTypeDim1 = MatrixTypeDim(dataType1);
-                return MakeShared<BaseTypeDenoter>(MatrixDataType(baseDataType0, matrixTypeDim0.first, matrixTypeDim1.second));
+                return GetCanonicalBaseTypeDenoter(MatrixDataType(baseDataType0, matrixTypeDim0.first, matrixTypeDim1.second));
             }
         }
 
@@ -496,17 +543,29 @@ TypeDenoterPtr GetTypeDenoterForHLSLIntrinsicWithArgs(const Intrinsic intrinsic,
             auto dataType0      = static_cast<BaseTypeDenoter&>(*type0).dataType;
             auto baseDataType0  = BaseDataType(dataType0);
             auto matrixTypeDim0 = MatrixTypeDim(dataType0);
-            return MakeShared<BaseTypeDenoter>(MatrixDataType(baseDataType0, matrixTypeDim0.second, matrixTypeDim0.first));
+            return GetCanonicalBaseTypeDenoter(MatrixDataType(baseDataType0, matrixTypeDim0.second, matrixTypeDim0.first));
         }
 
         RuntimeErr("invalid arguments in intrinsic 'transpose'");
     }
     else
     {
-        /* Get type denoter from intrinsic map */
-        static const auto intrinsicMap = GenerateIntrinsicDescriptorMap();
-        auto it = intrinsicMap.find(intrinsic);
-        if (it != intrinsicMap.end())
+        /* Get type denoter from intrinsic descriptor table (flattened from the generated map, sorted by intrinsic ID) */
+        static const std::vector<std::pair<Intrinsic, IntrinsicDescriptor>> intrinsicDescriptors = [&]()
+        {
+            const auto descMap = GenerateIntrinsicDescriptorMap();
+            return std::vector<std::pair<Intrinsic, IntrinsicDescriptor>>(descMap.begin(), descMap.end());
+        }();
+
+        auto it = std::lower_bound(
+            intrinsicDescriptors.begin(), intrinsicDescriptors.end(), intrinsic,
+            [](const std::pair<Intrinsic, IntrinsicDescriptor>& entry, const Intrinsic id)
+            {
+                return (entry.first < id);
+            }
+        );
+
+        if (it != intrinsicDescriptors.end() && it->first == intrinsic)
             return it->second.GetTypeDenoterWithArgs(args);
         else
             RuntimeErr("failed to derive type denoter for intrinsic");
@@ -12,7 +12,8 @@
 #include "ASTEnums.h"
 #include "ShaderVersion.h"
 #include "TypeDenoter.h"
-#include <map>
+#include <string>
+#include <unordered_set>
 
 
 namespace Xsc
@@ -31,10 +32,14 @@ struct HLSLIntrinsicEntry
     ShaderVersion   minShaderModel;
 };
 
-using HLSLIntrinsicsMap = std::map<std::string, HLSLIntrinsicEntry>;
+/*
+Returns the intrinsic entry (Intrinsic ID and minimum HLSL shader model) for the specified intrinsic name,
+or null if there is no such intrinsic. The lookup is a binary search over a statically sorted table, i.e. allocation-free.
+*/
+const HLSLIntrinsicEntry* FetchHLSLIntrinsic(const std::string& ident);
 
-// Returns the intrinsics map (Intrinsic name -> Intrinsic ID and minimum HLSL shader model).
-const HLSLIntrinsicsMap& HLSLIntrinsics();
+// Inserts the identifiers of all HLSL intrinsics into the specified vocabulary set (see StringInterner).
+void CollectHLSLIntrinsicIdents(std::unordered_set<std::string>& vocabulary);
 
 // Returns a type denoter for the specified intrinsic call and its arguments.
 TypeDenoterPtr GetTypeDenoterForHLSLIntrinsicWithArgs(const Intrinsic intrinsic, const std::vector<ExprPtr>& args);
@@ -16,7 +16,7 @@ namespace Xsc
 
 
 template <typename T>
-T MapKeywordToType(const std::map<std::string, T>& typeMap, const std::string& keyword, const std::string& typeName)
+T MapKeywordToType(const std::unordered_map<std::string, T>& typeMap, const std::string& keyword, const std::string& typeName)
 {
     auto it = typeMap.find(keyword);
     if (it != typeMap.end())
@@ -282,7 +282,7 @@ const KeywordMapType& HLSLKeywords()
 
 /* ----- DataType Mapping ----- */
 
-static std::map<std::string, DataType> GenerateDataTypeMap()
+static std::unordered_map<std::string, DataType> GenerateDataTypeMap()
 {
     using T = DataType;
 
@@ -409,7 +409,7 @@ DataType HLSLKeywordToDataType(const std::string& keyword)
 
 /* ----- StorageClass Mapping ----- */
 
-static std::map<std::string, StorageClass> GenerateStorageClassMap()
+static std::unordered_map<std::string, StorageClass> GenerateStorageClassMap()
 {
     using T = StorageClass;
 
@@ -440,7 +440,7 @@ StorageClass HLSLKeywordToStorageClass(const std::string& keyword)
 
 /* ----- BufferType Mapping ----- */
 
-static std::map<std::string, UniformBufferType> GenerateUniformBufferTypeMap()
+static std::unordered_map<std::string, UniformBufferType> GenerateUniformBufferTypeMap()
 {
     using T = UniformBufferType;
 
@@ -460,7 +460,7 @@ UniformBufferType HLSLKeywordToUniformBufferType(const std::string& keyword)
 
 /* ----- BufferType Mapping ----- */
 
-static std::map<std::string, BufferType> GenerateBufferTypeMap()
+static std::unordered_map<std::string, BufferType> GenerateBufferTypeMap()
 {
     using T = BufferType;
 
@@ -517,38 +517,63 @@ struct HLSLSemanticDescriptor
     bool        hasIndex    = false;
 };
 
-using HLSLSemanticMap = std::vector<std::pair<CiString, HLSLSemanticDescriptor>>;
+using HLSLSemanticMap = std::unordered_map<std::string, HLSLSemanticDescriptor>;
 
-static IndexedSemantic HLSLKeywordToSemanticWithMap(const CiString& ident, const HLSLSemanticMap& semanticMap)
+// Builds a semantic map whose keys are the case-folded semantic names, for a single hashed lookup per identifier.
+static HLSLSemanticMap GenerateSemanticMap(const std::vector<std::pair<const char*, HLSLSemanticDescriptor>>& entries)
 {
-    for (const auto& s : semanticMap)
+    HLSLSemanticMap semanticMap;
+    semanticMap.reserve(entries.size());
+
+    for (const auto& e : entries)
+    {
+        std::string folded = e.first;
+        for (auto& c : folded)
+            c = ToLowerAscii(c);
+        semanticMap.insert({ std::move(folded), e.second });
+    }
+
+    return semanticMap;
+}
+
+static IndexedSemantic HLSLKeywordToSemanticWithMap(const std::string& ident, const HLSLSemanticMap& semanticMap)
+{
+    /* Case-fold the identifier and split off the trailing index digits (e.g. "TEXCOORD3" -> "texcoord" + 3) */
+    std::string folded;
+    folded.reserve(ident.size());
+
+    for (auto c : ident)
+        folded.push_back(ToLowerAscii(c));
+
+    auto baseLen = folded.size();
+    while (baseLen > 0 && folded[baseLen - 1] >= '0' && folded[baseLen - 1] <= '9')
+        --baseLen;
+
+    const auto hasIndexDigits = (baseLen < folded.size());
+
+    auto it = semanticMap.find(hasIndexDigits ? folded.substr(0, baseLen) : folded);
+    if (it != semanticMap.end())
     {
-        if (s.second.hasIndex)
+        if (it->second.hasIndex)
         {
-            /* Does the identifier equal the semantic name without the index? */
-            if (ident.size() >= s.first.size() && ident.compare(0, s.first.size(), s.first) == 0)
-            {
-                /* Is identifier longer than semantic name? */
-                if (ident.size() > s.first.size())
-                {
-                    /* Return semantic with index */
-                    auto index = FromString<int>(ident.substr(s.first.size()).c_str());
-                    return { s.second.semantic, index };
-                }
-                return s.second.semantic;
-            }
+            if (hasIndexDigits)
+                return { it->second.semantic, FromString<int>(folded.substr(baseLen)) };
+            return it->second.semantic;
         }
-        else if (ident == s.first)
-            return s.second.semantic;
+        /* Semantics without index (e.g. "SV_VertexID") must match the identifier entirely */
+        if (!hasIndexDigits)
+            return it->second.semantic;
     }
     return Semantic::UserDefined;
 }
 
-static IndexedSemantic HLSLKeywordToSemanticD3D9(const CiString& ident)
+using HLSLSemanticEntries = std::vector<std::pair<const char*, HLSLSemanticDescriptor>>;
+
+static const HLSLSemanticEntries& SemanticEntriesD3D9()
 {
     using T = Semantic;
 
-    static const HLSLSemanticMap semanticMap
+    static const HLSLSemanticEntries entries
     {
         { "COLOR",    { T::Target,         true } },
         { "DEPTH",    { T::Depth,          true } },
@@ -558,18 +583,25 @@ static IndexedSemantic HLSLKeywordToSemanticD3D9(const CiString& ident)
         //TODO: continue this list ...
     };
 
+    return entries;
+}
+
+static IndexedSemantic HLSLKeywordToSemanticD3D9(const std::string& ident)
+{
+    static const HLSLSemanticMap semanticMap = GenerateSemanticMap(SemanticEntriesD3D9());
+
     /* Has identifier at the the length of the shortest semantic? */
     if (ident.size() >= 4)
         return HLSLKeywordToSemanticWithMap(ident, semanticMap);
     else
-        return IndexedSemantic(std::string(ident.begin(), ident.end()));
+        return IndexedSemantic(ident);
 }
 
-static IndexedSemantic HLSLKeywordToSemanticD3D10(const CiString& ident)
+static const HLSLSemanticEntries& SemanticEntriesD3D10()
 {
     using T = Semantic;
 
-    static const HLSLSemanticMap semanticMap
+    static const HLSLSemanticEntries entries
     {
         { "SV_ClipDistance",           { T::ClipDistance,          true } },
         { "SV_CullDistance",           { T::CullDistance,          true } },
@@ -600,19 +632,41 @@ static IndexedSemantic HLSLKeywordToSemanticD3D10(const CiString& ident)
         { "SV_ViewportArrayIndex",     { T::ViewportArrayIndex          } },
     };
 
-    /* Has identifier at the the length of the shortest semantic? */
-    if (ident.size() >= 8 && ident.compare(0, 3, "SV_") == 0)
+    return entries;
+}
+
+static IndexedSemantic HLSLKeywordToSemanticD3D10(const std::string& ident)
+{
+    static const HLSLSemanticMap semanticMap = GenerateSemanticMap(SemanticEntriesD3D10());
+
+    /* Has identifier at the the length of the shortest semantic, and the (case-insensitive) "SV_" prefix? */
+    if ( ident.size() >= 8 &&
+         ToLowerAscii(ident[0]) == 's' && ToLowerAscii(ident[1]) == 'v' && ident[2] == '_' )
+    {
         return HLSLKeywordToSemanticWithMap(ident, semanticMap);
-    else
-        return IndexedSemantic(std::string(ident.begin(), ident.end()));
+    }
+    return IndexedSemantic(ident);
 }
 
 IndexedSemantic HLSLKeywordToSemantic(const std::string& ident, bool useD3D10Semantics)
 {
     if (useD3D10Semantics)
-        return HLSLKeywordToSemanticD3D10(ToCiString(ident));
+        return HLSLKeywordToSemanticD3D10(ident);
     else
-        return HLSLKeywordToSemanticD3D9(ToCiString(ident));
+        return HLSLKeywordToSemanticD3D9(ident);
+}
+
+void CollectHLSLKeywordIdents(std::unordered_set<std::string>& vocabulary)
+{
+    /* Collect all keywords (type names, control flow, etc.) */
+    for (const auto& keyword : HLSLKeywords())
+        vocabulary.insert(keyword.first);
+
+    /* Collect the system value semantics in their canonical spelling (the semantic lookup itself is case-insensitive) */
+    for (const auto& entry : SemanticEntriesD3D9())
+        vocabulary.insert(entry.first);
+    for (const auto& entry : SemanticEntriesD3D10())
+        vocabulary.insert(entry.first);
 }
 
 
@@ -11,7 +11,8 @@
 
 #include "Token.h"
 #include "ASTEnums.h"
-#include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <string>
 
 
@@ -19,7 +20,7 @@ namespace Xsc
 {
 
 
-using KeywordMapType = std::map<std::string, Token::Types>;
+using KeywordMapType = std::unordered_map<std::string, Token::Types>;
 
 // Returns the keywords map (which is an exception for identifiers).
 const KeywordMapType& HLSLKeywords();
@@ -39,6 +40,9 @@ BufferType HLSLKeywordToBufferType(const std::string& keyword);
 // Returns the semantic for the specified identifier or Semantic::UserDefined if the identifier is not reserved.
 IndexedSemantic HLSLKeywordToSemantic(const std::string& ident, bool useD3D10Semantics = true);
 
+// Inserts all HLSL keywords and the canonical system value semantic names into the specified vocabulary set (see StringInterner).
+void CollectHLSLKeywordIdents(std::unordered_set<std::string>& vocabulary);
+
 
 } // /namespace Xsc
 
@@ -11,6 +11,9 @@
 #include "Helper.h"
 #include "AST.h"
 #include "ASTFactory.h"
+#include "TraceEvents.h"
+#include <atomic>
+#include <thread>
 
 
 namespace Xsc
@@ -37,12 +40,42 @@ types, which are valid in the respective scope.
 HLSLParser::HLSLParser(Log* log) :
     Parser{ log }
 {
+    /* The HLSL grammar is parsed from a pre-lexed token buffer (the pre-processor keeps scanning on demand) */
+    PreLexTokens(true);
 }
 
-ProgramPtr HLSLParser::ParseSource(const SourceCodePtr& source)
+ProgramPtr HLSLParser::ParseSource(const SourceCodePtr& source, bool skipFunctionBodies)
 {
     PushScannerSource(source);
 
+    skipFunctionBodies_ = skipFunctionBodies;
+
+    try
+    {
+        auto ast = ParseProgram(source);
+        return (GetReportHandler().HasErros() ? nullptr : ast);
+    }
+    catch (const Report& err)
+    {
+        if (GetLog())
+            GetLog()->SumitReport(err);
+    }
+    catch (const ErrorLimitAbort&)
+    {
+        /* The abort report was already submitted (see ShaderInput::maxErrors) */
+    }
+
+    return nullptr;
+}
+
+ProgramPtr HLSLParser::ParseTokenString(const TokenPtrString& tokenString, const SourceCodePtr& source, bool skipFunctionBodies)
+{
+    PushScannerPreLexedTokens(tokenString, source);
+
+    /* With the contiguous token buffer, function bodies can be bracketed and parsed in a deferred second phase */
+    deferFunctionBodies_ = true;
+    skipFunctionBodies_  = skipFunctionBodies;
+
     try
     {
         auto ast = ParseProgram(source);
@@ -53,6 +86,10 @@ ProgramPtr HLSLParser::ParseSource(const SourceCodePtr& source)
         if (GetLog())
             GetLog()->SumitReport(err);
     }
+    catch (const ErrorLimitAbort&)
+    {
+        /* The abort report was already submitted (see ShaderInput::maxErrors) */
+    }
 
     return nullptr;
 }
@@ -110,7 +147,7 @@ TypeNameExprPtr HLSLParser::MakeToTypeNameIfLhsOfCastExpr(const ExprPtr& expr)
         {
             /* Convert the variable access into a type name expression */
             auto typeExpr = Make<TypeNameExpr>();
-            typeExpr->typeDenoter = std::make_shared<AliasTypeDenoter>(varAccessExpr->varIdent->ident);
+            typeExpr->typeDenoter = MakeShared<AliasTypeDenoter>(varAccessExpr->varIdent->ident);
             return typeExpr;
         }
     }
@@ -124,7 +161,7 @@ VarTypePtr HLSLParser::MakeVarType(const StructDeclPtr& structDecl)
     auto ast = Make<VarType>();
 
     ast->structDecl     = structDecl;
-    ast->typeDenoter    = std::make_shared<StructTypeDenoter>(structDecl.get());
+    ast->typeDenoter    = MakeShared<StructTypeDenoter>(structDecl.get());
 
     return ast;
 }
@@ -181,6 +218,10 @@ void HLSLParser::CloseScope()
 void HLSLParser::RegisterTypeName(const std::string& ident)
 {
     typeNameSymbolTable_.Register(ident, true, nullptr, false);
+
+    /* Keep the global registration order, to re-establish type name visibility for deferred function bodies */
+    if (deferFunctionBodies_)
+        globalTypeNames_.push_back(ident);
 }
 
 bool HLSLParser::IsRegisteredTypeName(const std::string& ident) const
@@ -237,7 +278,7 @@ ProgramPtr HLSLParser::ParseProgram(const SourceCodePtr& source)
         while (Is(Tokens::Semicolon) || Is(Tokens::Technique))
         {
             if (Is(Tokens::Technique))
-                ParseAndIgnoreTechnique();
+                ParseAndIgnoreTechnique(*ast);
             else
                 AcceptIt();
         }
@@ -250,11 +291,33 @@ ProgramPtr HLSLParser::ParseProgram(const SourceCodePtr& source)
         ParseStmntWithOptionalComment(ast->globalStmnts, std::bind(&HLSLParser::ParseGlobalStmnt, this));
     }
 
+    /* Parse all function bodies that were bracketed during the top-level scan (see ParseFunctionDecl) */
+    ParseDeferredCodeBlocks(source);
+
     CloseScope();
 
     return ast;
 }
 
+void HLSLParser::SkipCodeBlock()
+{
+    /* Skip all tokens of the code block by brace matching, without constructing any AST nodes */
+    std::stack<TokenPtr> braceTknStack;
+
+    braceTknStack.push(Accept(Tokens::LCurly));
+
+    while (!braceTknStack.empty())
+    {
+        if (Is(Tokens::LCurly))
+            braceTknStack.push(Tkn());
+        else if (Is(Tokens::RCurly))
+            braceTknStack.pop();
+        else if (Is(Tokens::EndOfStream))
+            Error("missing closing brace '}' for open code block", braceTknStack.top().get());
+        AcceptIt();
+    }
+}
+
 CodeBlockPtr HLSLParser::ParseCodeBlock()
 {
     auto ast = Make<CodeBlock>();
@@ -387,9 +450,7 @@ AttributePtr HLSLParser::ParseAttribute()
             while (true)
             {
                 ast->arguments.push_back(ParseExpr());
-                if (Is(Tokens::Comma))
-                    AcceptIt();
-                else
+                if (!TryAccept(Tokens::Comma))
                     break;
             }
         }
@@ -489,11 +550,8 @@ PackOffsetPtr HLSLParser::ParsePackOffset(bool parseColon)
 
     ast->registerName = ParseIdent();
 
-    if (Is(Tokens::Dot))
-    {
-        AcceptIt();
+    if (TryAccept(Tokens::Dot))
         ast->vectorComponent = ParseIdent();
-    }
 
     Accept(Tokens::RBracket);
 
@@ -515,9 +573,12 @@ ExprPtr HLSLParser::ParseArrayDimension(bool allowDynamicDimension)
     else
         ast = ParseExpr();
 
+    /* Update the area before the closing ']' is accepted, so it ends at the last expression token */
+    UpdateSourceArea(ast);
+
     Accept(Tokens::RParen);
 
-    return UpdateSourceArea(ast);
+    return ast;
 }
 
 ExprPtr HLSLParser::ParseInitializer()
@@ -690,7 +751,7 @@ AliasDeclPtr HLSLParser::ParseAliasDecl(TypeDenoterPtr typeDenoter)
     if (Is(Tokens::LParen))
     {
         /* Make array type denoter and use input as base type denoter */
-        auto arrayTypeDenoter = std::make_shared<ArrayTypeDenoter>();
+        auto arrayTypeDenoter = MakeShared<ArrayTypeDenoter>();
         {
             arrayTypeDenoter->arrayDims         = ParseArrayDimensionList();
             arrayTypeDenoter->baseTypeDenoter   = typeDenoter;
@@ -768,6 +829,8 @@ StmntPtr HLSLParser::ParseStructDeclOrVarDeclOrFunctionDeclStmnt()
 
 FunctionDeclPtr HLSLParser::ParseFunctionDecl(const VarTypePtr& returnType, const TokenPtr& identTkn)
 {
+    TraceSpan traceSpan("parse function");
+
     auto ast = Make<FunctionDecl>();
 
     if (returnType)
@@ -778,8 +841,7 @@ FunctionDeclPtr HLSLParser::ParseFunctionDecl(const VarTypePtr& returnType, cons
     else
     {
         /* Parse (and ignore) optional 'inline' keyword */
-        if (Is(Tokens::Inline))
-            AcceptIt();
+        TryAccept(Tokens::Inline);
 
         /* Parse function attributes and return type */
         ast->attribs    = ParseAttributeList();
@@ -808,6 +870,16 @@ FunctionDeclPtr HLSLParser::ParseFunctionDecl(const VarTypePtr& returnType, cons
     /* Parse optional function body */
     if (Is(Tokens::Semicolon))
         AcceptIt();
+    else if (deferFunctionBodies_ && Is(Tokens::LCurly))
+    {
+        /* Only bracket the body here; it is parsed in the deferred second phase (see ParseDeferredCodeBlocks) */
+        DeferFunctionBody(*ast);
+    }
+    else if (skipFunctionBodies_ && Is(Tokens::LCurly))
+    {
+        /* Metadata extraction: skip the body, so the declaration remains body-less (see Options::metadataOnly) */
+        SkipCodeBlock();
+    }
     else
     {
         GetReportHandler().PushContextDesc(ast->SignatureToString(false));
@@ -1550,14 +1622,83 @@ ExprPtr HLSLParser::ParseFunctionCallExpr(const VarIdentPtr& varIdent, const Typ
     return expr;
 }
 
-InitializerExprPtr HLSLParser::ParseInitializerExpr()
+ExprPtr HLSLParser::ParseInitializerExpr()
 {
+    /* Try to parse a giant homogeneous literal list as a single blob node (see LiteralBlobExpr) */
+    if (auto blobExpr = TryParseLiteralBlobExpr())
+        return blobExpr;
+
     /* Parse initializer list expression */
     auto ast = Make<InitializerExpr>();
     ast->exprs = ParseInitializerList();
     return UpdateSourceArea(ast);
 }
 
+// Minimum number of literal elements before an initializer list is stored as a blob (see TryParseLiteralBlobExpr).
+static const unsigned int minLiteralBlobElements = 64;
+
+ExprPtr HLSLParser::TryParseLiteralBlobExpr()
+{
+    /* Speculation requires the pre-lexed mode; otherwise fall back to the regular initializer list */
+    if (!CanRollback())
+        return nullptr;
+
+    auto checkpoint = MakeCheckpoint();
+    auto ast        = Make<LiteralBlobExpr>();
+
+    if (!TryAccept(Tokens::LCurly))
+    {
+        RollbackTo(checkpoint);
+        return nullptr;
+    }
+
+    /* Scan flat list of (optionally signed) scalar literals; any other shape bails out to the regular path */
+    while (!Is(Tokens::RCurly))
+    {
+        std::string element;
+
+        /* Parse optional sign prefix */
+        if (IsArithmeticUnaryExpr())
+            element = AcceptIt()->Spell();
+
+        if (!Is(Tokens::BoolLiteral) && !Is(Tokens::IntLiteral) && !Is(Tokens::FloatLiteral))
+        {
+            RollbackTo(checkpoint);
+            return nullptr;
+        }
+
+        /* Derive the blob data type from the first literal (see LiteralBlobExpr::DeriveTypeDenoter) */
+        if (ast->numElements == 0)
+            ast->dataType = TokenToDataType(*Tkn());
+
+        element += AcceptIt()->Spell();
+
+        /* Append literal verbatim, so the generated output is identical to the per-node path */
+        if (!ast->values.empty())
+            ast->values += ", ";
+        ast->values += element;
+        ++ast->numElements;
+
+        /* Parse list separator (a trailing comma before '}' is allowed, as in ParseExprList) */
+        if (!TryAccept(Tokens::Comma) && !Is(Tokens::RCurly))
+        {
+            RollbackTo(checkpoint);
+            return nullptr;
+        }
+    }
+
+    /* Only worthwhile for giant lists; small lists keep their exact per-literal AST nodes */
+    if (ast->numElements < minLiteralBlobElements)
+    {
+        RollbackTo(checkpoint);
+        return nullptr;
+    }
+
+    AcceptIt();
+
+    return UpdateSourceArea(ast);
+}
+
 /* --- Lists --- */
 
 std::vector<VarDeclPtr> HLSLParser::ParseVarDeclList(VarDeclStmnt* declStmntRef, TokenPtr firstIdentTkn)
@@ -1569,9 +1710,7 @@ std::vector<VarDeclPtr> HLSLParser::ParseVarDeclList(VarDeclStmnt* declStmntRef,
     {
         varDecls.push_back(ParseVarDecl(declStmntRef, firstIdentTkn));
         firstIdentTkn = nullptr;
-        if (Is(Tokens::Comma))
-            AcceptIt();
-        else
+        if (!TryAccept(Tokens::Comma))
             break;
     }
 
@@ -1605,9 +1744,7 @@ std::vector<VarDeclStmntPtr> HLSLParser::ParseParameterList()
         while (true)
         {
             parameters.push_back(ParseParameter());
-            if (Is(Tokens::Comma))
-                AcceptIt();
-            else
+            if (!TryAccept(Tokens::Comma))
                 break;
         }
     }
@@ -1828,7 +1965,7 @@ TypeDenoterPtr HLSLParser::ParseTypeDenoter(bool allowVoidType)
         if (Is(Tokens::LParen))
         {
             /* Make array type denoter */
-            auto arrayTypeDenoter = std::make_shared<ArrayTypeDenoter>();
+            auto arrayTypeDenoter = MakeShared<ArrayTypeDenoter>();
             {
                 arrayTypeDenoter->arrayDims         = ParseArrayDimensionList();
                 arrayTypeDenoter->baseTypeDenoter   = typeDenoter;
@@ -1873,7 +2010,7 @@ TypeDenoterPtr HLSLParser::ParseTypeDenoterWithStructDeclOpt(StructDeclPtr& stru
             structDecl = ParseStructDecl(false);
 
             /* Make struct type denoter with reference to the structure of this alias decl */
-            return std::make_shared<StructTypeDenoter>(structDecl.get());
+            return MakeShared<StructTypeDenoter>(structDecl.get());
         }
         else
         {
@@ -1886,12 +2023,12 @@ TypeDenoterPtr HLSLParser::ParseTypeDenoterWithStructDeclOpt(StructDeclPtr& stru
                 structDecl = ParseStructDecl(false, structIdentTkn);
 
                 /* Make struct type denoter with reference to the structure of this alias decl */
-                return std::make_shared<StructTypeDenoter>(structDecl.get());
+                return MakeShared<StructTypeDenoter>(structDecl.get());
             }
             else
             {
                 /* Make struct type denoter without struct decl */
-                return std::make_shared<StructTypeDenoter>(structIdentTkn->Spell());
+                return MakeShared<StructTypeDenoter>(structIdentTkn->Spell());
             }
         }
     }
@@ -1902,7 +2039,7 @@ TypeDenoterPtr HLSLParser::ParseTypeDenoterWithStructDeclOpt(StructDeclPtr& stru
 VoidTypeDenoterPtr HLSLParser::ParseVoidTypeDenoter()
 {
     Accept(Tokens::Void);
-    return std::make_shared<VoidTypeDenoter>();
+    return MakeShared<VoidTypeDenoter>();
 }
 
 BaseTypeDenoterPtr HLSLParser::ParseBaseTypeDenoter()
@@ -1912,9 +2049,7 @@ BaseTypeDenoterPtr HLSLParser::ParseBaseTypeDenoter()
         auto keyword = AcceptIt()->Spell();
 
         /* Make base type denoter by data type keyword */
-        auto typeDenoter = std::make_shared<BaseTypeDenoter>();
-        typeDenoter->dataType = ParseDataType(keyword);
-        return typeDenoter;
+        return GetCanonicalBaseTypeDenoter(ParseDataType(keyword));
     }
     ErrorUnexpected("expected base type denoter", nullptr, true);
     return nullptr;
@@ -1951,10 +2086,7 @@ BaseTypeDenoterPtr HLSLParser::ParseBaseVectorTypeDenoter()
         vectorType = "float4";
 
     /* Make base type denoter by data type keyword */
-    auto typeDenoter = std::make_shared<BaseTypeDenoter>();
-    typeDenoter->dataType = ParseDataType(vectorType);
-
-    return typeDenoter;
+    return GetCanonicalBaseTypeDenoter(ParseDataType(vectorType));
 }
 
 // matrix < ScalarType, '1'-'4', '1'-'4' >;
@@ -1991,17 +2123,14 @@ BaseTypeDenoterPtr HLSLParser::ParseBaseMatrixTypeDenoter()
         matrixType = "float4x4";
 
     /* Make base type denoter by data type keyword */
-    auto typeDenoter = std::make_shared<BaseTypeDenoter>();
-    typeDenoter->dataType = ParseDataType(matrixType);
-
-    return typeDenoter;
+    return GetCanonicalBaseTypeDenoter(ParseDataType(matrixType));
 }
 
 TextureTypeDenoterPtr HLSLParser::ParseTextureTypeDenoter()
 {
     /* Make texture type denoter */
     auto textureType = HLSLKeywordToBufferType(Accept(Tokens::Texture)->Spell());
-    return std::make_shared<TextureTypeDenoter>(textureType);
+    return MakeShared<TextureTypeDenoter>(textureType);
 }
 
 SamplerTypeDenoterPtr HLSLParser::ParseSamplerTypeDenoter()
@@ -2009,20 +2138,19 @@ SamplerTypeDenoterPtr HLSLParser::ParseSamplerTypeDenoter()
     /* Make sampler type denoter */
     //TODO: convert HLSL keyword to sampler type and pass it to the SamplerTypeDenoter
     ParseSamplerType();
-    return std::make_shared<SamplerTypeDenoter>();
+    return MakeShared<SamplerTypeDenoter>();
 }
 
 StructTypeDenoterPtr HLSLParser::ParseStructTypeDenoter()
 {
     /* Parse optional 'struct' keyword */
-    if (Is(Tokens::Struct))
-        AcceptIt();
+    TryAccept(Tokens::Struct);
 
     /* Parse identifier */
     auto ident = ParseIdent();
 
     /* Make struct type denoter */
-    auto typeDenoter = std::make_shared<StructTypeDenoter>(ident);
+    auto typeDenoter = MakeShared<StructTypeDenoter>(ident);
 
     return typeDenoter;
 }
@@ -2034,7 +2162,7 @@ AliasTypeDenoterPtr HLSLParser::ParseAliasTypeDenoter(std::string ident)
         ident = ParseIdent();
 
     /* Make alias type denoter per default (change this to a struct type later) */
-    return std::make_shared<AliasTypeDenoter>(ident);
+    return MakeShared<AliasTypeDenoter>(ident);
 }
 
 Variant HLSLParser::ParseAndEvaluateConstExpr()
@@ -2055,6 +2183,9 @@ Variant HLSLParser::ParseAndEvaluateConstExpr()
     }
     catch (const VarAccessExpr* expr)
     {
+        /* Complete a background scan first (see Parser::Error) */
+        GetScanner().FinishPreLexing();
+
         GetReportHandler().Error(true, "expected constant expression", GetScanner().Source(), expr->area);
     }
 
@@ -2083,13 +2214,17 @@ int HLSLParser::ParseAndEvaluateVectorDimension()
     return value;
 }
 
-void HLSLParser::ParseAndIgnoreTechnique()
+void HLSLParser::ParseAndIgnoreTechnique(Program& program)
 {
     /* Only expect 'technique' keyword */
     Accept(Tokens::Technique);
 
     Warning("techniques are ignored");
 
+    /* Keep the technique identifier, so it can be reported as metadata (see Options::metadataOnly) */
+    if (Is(Tokens::Ident))
+        program.techniqueIdents.push_back(Tkn()->Spell());
+
     /* Ignore all tokens until the first opening brace */
     std::stack<TokenPtr> braceTknStack;
 
@@ -2285,6 +2420,157 @@ void HLSLParser::ParseStmntWithOptionalComment(std::vector<StmntPtr>& stmnts, co
 }
 
 
+/* ------- Deferred function bodies ------- */
+
+/*
+Captures the reports of a worker parser, so they can be replayed
+on the main report handler in declaration order after the join.
+*/
+class DeferredBodyLog : public Log
+{
+
+    public:
+
+        void SumitReport(const Report& report) override
+        {
+            reports.push_back(report);
+        }
+
+        std::vector<Report> reports;
+
+};
+
+void HLSLParser::DeferFunctionBody(FunctionDecl& funcDecl)
+{
+    auto& scanner = GetScanner();
+
+    /* Bracket the function body by brace matching within the pre-lexed token buffer */
+    DeferredCodeBlock entry;
+
+    entry.funcDecl          = (&funcDecl);
+    entry.firstTokenIndex   = scanner.ActiveTokenIndex();
+    entry.lastTokenIndex    = scanner.FindMatchingRCurlyIndex(entry.firstTokenIndex);
+    entry.numTypeNames      = globalTypeNames_.size();
+
+    deferredCodeBlocks_.push_back(entry);
+
+    /* Continue the top-level scan after the function body */
+    scanner.ResumeTokenIndex(entry.lastTokenIndex + 1);
+    AcceptIt();
+}
+
+void HLSLParser::ParseDeferredCodeBlocks(const SourceCodePtr& source)
+{
+    if (deferredCodeBlocks_.empty())
+        return;
+
+    if (skipFunctionBodies_)
+    {
+        /* Metadata extraction: discard the bracketed function bodies; the declarations remain body-less (see Options::metadataOnly) */
+        deferredCodeBlocks_.clear();
+        globalTypeNames_.clear();
+        return;
+    }
+
+    /* Disable deferred mode, so the function bodies are now parsed directly */
+    deferFunctionBodies_ = false;
+
+    auto& topLevelScanner = GetScanner();
+    const auto numBodies = deferredCodeBlocks_.size();
+
+    /* Determine number of worker threads: at most one worker per eight bodies, so small sources are parsed in place */
+    #ifdef XSC_ENABLE_MEMORY_POOL
+    const std::size_t numWorkers = 1; // the global memory pool is not thread safe
+    #else
+    const auto numWorkers = std::min<std::size_t>(std::thread::hardware_concurrency(), numBodies / 8);
+    #endif
+
+    if (numWorkers <= 1)
+    {
+        /* Parse all deferred function bodies within this parser */
+        for (const auto& entry : deferredCodeBlocks_)
+            ParseDeferredCodeBlock(topLevelScanner, source, globalTypeNames_, entry);
+    }
+    else
+    {
+        /* Parse the deferred function bodies across the worker threads, each with its own parser and report capture */
+        std::vector<std::vector<Report>> bodyReports(numBodies);
+        std::atomic<std::size_t> nextBody(0);
+
+        auto ParseBodiesWorker = [&]()
+        {
+            DeferredBodyLog workerLog;
+            HLSLParser workerParser(&workerLog);
+
+            while (true)
+            {
+                const auto bodyIndex = nextBody.fetch_add(1);
+                if (bodyIndex >= numBodies)
+                    break;
+
+                workerParser.ParseDeferredCodeBlock(topLevelScanner, source, globalTypeNames_, deferredCodeBlocks_[bodyIndex]);
+
+                bodyReports[bodyIndex] = std::move(workerLog.reports);
+                workerLog.reports.clear();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(numWorkers);
+
+        for (std::size_t i = 0; i < numWorkers; ++i)
+            workers.emplace_back(ParseBodiesWorker);
+        for (auto& worker : workers)
+            worker.join();
+
+        /* Replay the captured worker reports in declaration order */
+        for (const auto& reports : bodyReports)
+        {
+            for (const auto& report : reports)
+                GetReportHandler().SubmitDeferredReport(report);
+        }
+    }
+
+    deferredCodeBlocks_.clear();
+    globalTypeNames_.clear();
+}
+
+void HLSLParser::ParseDeferredCodeBlock(
+    const Scanner& topLevelScanner, const SourceCodePtr& source,
+    const std::vector<std::string>& typeNames, const DeferredCodeBlock& entry)
+{
+    /* Serve the bracketed token range of the function body with a new scanner */
+    PushScannerPreLexedRange(topLevelScanner, entry.firstTokenIndex, entry.lastTokenIndex, source);
+
+    GetReportHandler().PushContextDesc(entry.funcDecl->SignatureToString(false));
+    {
+        OpenScope();
+
+        /* Re-register the global type names that were visible in front of the function body */
+        for (std::size_t i = 0; i < entry.numTypeNames; ++i)
+            typeNameSymbolTable_.Register(typeNames[i], true, nullptr, false);
+
+        try
+        {
+            localScope_ = true;
+            entry.funcDecl->codeBlock = ParseCodeBlock();
+            localScope_ = false;
+        }
+        catch (const Report& err)
+        {
+            localScope_ = false;
+            if (GetLog())
+                GetLog()->SumitReport(err);
+        }
+
+        CloseScope();
+    }
+    GetReportHandler().PopContextDesc();
+
+    PopScannerSource();
+}
+
+
 } // /namespace Xsc
 
 
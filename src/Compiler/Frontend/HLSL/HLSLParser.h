@@ -34,10 +34,32 @@ class HLSLParser : public Parser
         
         HLSLParser(Log* log = nullptr);
 
-        ProgramPtr ParseSource(const SourceCodePtr& source);
+        /*
+        Parses the specified source code. If 'skipFunctionBodies' is true, function bodies are skipped by
+        brace matching and their declarations remain body-less (see Options::metadataOnly).
+        */
+        ProgramPtr ParseSource(const SourceCodePtr& source, bool skipFunctionBodies = false);
+
+        /*
+        Parses the specified pre-processed token string (see PreProcessor::ProcessToTokenString),
+        so the pre-processor output does not have to be serialized to text and re-scanned;
+        'source' is only used for error line markers.
+        */
+        ProgramPtr ParseTokenString(const TokenPtrString& tokenString, const SourceCodePtr& source, bool skipFunctionBodies = false);
 
     private:
         
+        /* === Structures === */
+
+        // Descriptor of a function body whose parsing has been deferred to the second phase (pre-lexed token mode only).
+        struct DeferredCodeBlock
+        {
+            FunctionDecl*   funcDecl        = nullptr;  // Function declaration that receives the parsed code block.
+            std::size_t     firstTokenIndex = 0;        // Token buffer index of the opening '{'.
+            std::size_t     lastTokenIndex  = 0;        // Token buffer index of the matching '}'.
+            std::size_t     numTypeNames    = 0;        // Number of global type names visible in front of the function body.
+        };
+
         /* === Functions === */
 
         ScannerPtr MakeScanner() override;
@@ -93,6 +115,9 @@ class HLSLParser : public Parser
 
         ProgramPtr                      ParseProgram(const SourceCodePtr& source);
 
+        // Skips a code block by brace matching, without constructing any AST nodes (see Options::metadataOnly).
+        void                            SkipCodeBlock();
+
         CodeBlockPtr                    ParseCodeBlock();
         FunctionCallPtr                 ParseFunctionCall(VarIdentPtr varIdent = nullptr);
         FunctionCallPtr                 ParseFunctionCall(const TypeDenoterPtr& typeDenoter);
@@ -149,7 +174,8 @@ class HLSLParser : public Parser
         ExprPtr                         ParseVarAccessOrFunctionCallExpr();
         VarAccessExprPtr                ParseVarAccessExpr(const VarIdentPtr& varIdent = nullptr);
         ExprPtr                         ParseFunctionCallExpr(const VarIdentPtr& varIdent = nullptr, const TypeDenoterPtr& typeDenoter = nullptr);
-        InitializerExprPtr              ParseInitializerExpr();
+        ExprPtr                         ParseInitializerExpr();
+        ExprPtr                         TryParseLiteralBlobExpr();
 
         std::vector<VarDeclPtr>         ParseVarDeclList(VarDeclStmnt* declStmntRef, TokenPtr firstIdentTkn = nullptr);
         std::vector<VarDeclStmntPtr>    ParseVarDeclStmntList();
@@ -187,7 +213,7 @@ class HLSLParser : public Parser
         int                             ParseAndEvaluateConstExprInt();
         int                             ParseAndEvaluateVectorDimension();
 
-        void                            ParseAndIgnoreTechnique();
+        void                            ParseAndIgnoreTechnique(Program& program);
 
         void                            ParseVarDeclSemantic(VarDecl& varDecl, bool allowPackOffset = true);
         void                            ParseFunctionDeclSemantic(FunctionDecl& funcDecl);
@@ -203,6 +229,20 @@ class HLSLParser : public Parser
 
         void                            ParseStmntWithOptionalComment(std::vector<StmntPtr>& stmnts, const std::function<StmntPtr()>& parseFunction);
 
+        /* ----- Deferred function bodies ----- */
+
+        // Brackets the function body at the current '{' token by brace matching, and defers its parsing (see ParseDeferredCodeBlocks).
+        void                            DeferFunctionBody(FunctionDecl& funcDecl);
+
+        // Parses all deferred function bodies; across worker threads, if enough bodies and hardware threads are available.
+        void                            ParseDeferredCodeBlocks(const SourceCodePtr& source);
+
+        // Parses the single specified deferred function body (also used by the worker parsers of ParseDeferredCodeBlocks).
+        void                            ParseDeferredCodeBlock(
+            const Scanner& topLevelScanner, const SourceCodePtr& source,
+            const std::vector<std::string>& typeNames, const DeferredCodeBlock& entry
+        );
+
         /* === Members === */
 
         using TypeNameSymbolTable = SymbolTable<bool>;
@@ -213,6 +253,18 @@ class HLSLParser : public Parser
         // Symbol table for type name (i.e. structure and typedef identifiers) to detect cast expression, which are not context free.
         TypeNameSymbolTable typeNameSymbolTable_;
 
+        // True, if function bodies are only bracketed during the top-level scan and parsed in a deferred second phase (pre-lexed token mode only).
+        bool                deferFunctionBodies_    = false;
+
+        // True, if function bodies are skipped entirely and their declarations remain body-less (see Options::metadataOnly).
+        bool                skipFunctionBodies_     = false;
+
+        // Function bodies whose parsing has been deferred (in declaration order).
+        std::vector<DeferredCodeBlock> deferredCodeBlocks_;
+
+        // All global type names in registration order, to re-establish their visibility for the deferred function bodies.
+        std::vector<std::string>       globalTypeNames_;
+
 };
 
 
@@ -7,7 +7,9 @@
 
 #include "HLSLScanner.h"
 #include "HLSLKeywords.h"
+#include "Helper.h"
 #include <cctype>
+#include <sstream>
 
 
 namespace Xsc
@@ -24,6 +26,177 @@ TokenPtr HLSLScanner::Next()
     return NextToken(false, false);
 }
 
+// Returns the HLSL token type for single characters the pre-processor types as miscellaneous tokens.
+static Token::Types ReclassifySingleChar(char chr)
+{
+    switch (chr)
+    {
+        case ';': return Token::Types::Semicolon;
+        case '{': return Token::Types::LCurly;
+        case '}': return Token::Types::RCurly;
+        case '[': return Token::Types::LParen;
+        case ']': return Token::Types::RParen;
+        case '=': return Token::Types::AssignOp;
+        default:  return Token::Types::Undefined;
+    }
+}
+
+bool HLSLScanner::PreLexTokenString(const TokenPtrString& tokenString, const SourceCodePtr& source)
+{
+    std::vector<PreLexedToken> tokens;
+    tokens.reserve(tokenString.Size() + 1);
+
+    std::string comment;
+    SourcePosition pos;
+
+    /* Appends the next classified token together with its leading commentary */
+    auto AppendToken = [&tokens, &comment](const TokenPtr& tkn)
+    {
+        tokens.push_back({ tkn, std::move(comment) });
+        comment.clear();
+    };
+
+    /* Operator tokens must be merged with adjacent operator tokens before they can be classified */
+    auto IsOperatorToken = [](const Token& tkn)
+    {
+        auto type = tkn.Type();
+        return (type == Tokens::BinaryOp || type == Tokens::UnaryOp || type == Tokens::Misc);
+    };
+
+    /*
+    Identifier and number tokens which are directly adjacent (i.e. without any white spaces between
+    them) can only result from the '##'-operator: the pre-processor pastes tokens by removing the
+    white spaces between the operands, which merges the spellings only when the output is serialized
+    and re-scanned (see PreProcessor::ExpandMacro), so here the merge must be done explicitly.
+    */
+    auto IsPastedToken = [](const Token& tkn)
+    {
+        auto type = tkn.Type();
+        return (type == Tokens::Ident || type == Tokens::IntLiteral || type == Tokens::FloatLiteral);
+    };
+
+    /* Re-scans the specified concatenated spelling (with terminating new-line), exactly like the serialized text would be scanned */
+    auto ReScanSpelling = [&](const std::string& spell, const SourcePosition& pos)
+    {
+        HLSLScanner reScanner(GetLog());
+        if (reScanner.ScanSource(std::make_shared<SourceCode>(std::make_shared<std::istringstream>(spell + '\n'))))
+        {
+            while (auto reTkn = reScanner.Next())
+            {
+                if (reTkn->Type() == Tokens::EndOfStream)
+                    break;
+                AppendToken(MakeShared<Token>(pos, reTkn->Type(), *reTkn));
+            }
+        }
+    };
+
+    for (auto it = tokenString.begin(); it != tokenString.end(); ++it)
+    {
+        const auto& tkn = *it;
+        pos = tkn->Pos();
+
+        switch (tkn->Type())
+        {
+            case Tokens::WhiteSpaces:
+            case Tokens::NewLines:
+            {
+                /* The HLSL grammar ignores white spaces */
+            }
+            break;
+
+            case Tokens::Comment:
+            {
+                /* Attach commentary to its subsequent token (see Scanner::GetComment) */
+                if (!comment.empty())
+                    comment += '\n';
+                comment += tkn->Spell();
+            }
+            break;
+
+            case Tokens::Ident:
+            case Tokens::IntLiteral:
+            case Tokens::FloatLiteral:
+            {
+                /* Concatenate the maximal run of pasted tokens, and re-scan the merged spelling (see IsPastedToken) */
+                auto next = it;
+                if (++next != tokenString.end() && IsPastedToken(**next))
+                {
+                    auto spell = tkn->Spell();
+                    for (; next != tokenString.end() && IsPastedToken(**next); ++next)
+                    {
+                        spell += (*next)->Spell();
+                        it = next;
+                    }
+                    ReScanSpelling(spell, pos);
+                    break;
+                }
+
+                if (tkn->Type() != Tokens::Ident)
+                {
+                    /* Number literal tokens are typed identically in the HLSL grammar */
+                    AppendToken(tkn);
+                    break;
+                }
+
+                /* Scan reserved words (see ScanIdentifier); look up with a temporary key, so spelling views are not materialized */
+                const std::string spellKey(tkn->SpellData(), tkn->SpellSize());
+
+                auto it = HLSLKeywords().find(spellKey);
+                if (it != HLSLKeywords().end())
+                {
+                    if (it->second == Tokens::Reserved)
+                    {
+                        throw Report(
+                            Report::Types::Error,
+                            "lexical error (" + pos.ToString() + ") : keyword '" + spellKey + "' is reserved for future use"
+                        );
+                    }
+                    AppendToken(MakeShared<Token>(pos, it->second, *tkn));
+                }
+                else
+                    AppendToken(tkn);
+            }
+            break;
+
+            case Tokens::BinaryOp:
+            case Tokens::UnaryOp:
+            case Tokens::Misc:
+            {
+                /*
+                Concatenate the maximal run of adjacent operator tokens, since the pre-processor
+                does not merge compound operators (e.g. it emits "+" "=" for "+=")
+                */
+                auto spell = tkn->Spell();
+                for (auto next = it; ++next != tokenString.end() && IsOperatorToken(**next); it = next)
+                    spell += (*next)->Spell();
+
+                if (spell.size() == 1 && tkn->Type() != Tokens::Misc)
+                {
+                    /* Single operator tokens are typed identically in the HLSL grammar */
+                    AppendToken(tkn);
+                }
+                else if (spell.size() == 1 && ReclassifySingleChar(spell[0]) != Tokens::Undefined)
+                    AppendToken(MakeShared<Token>(pos, ReclassifySingleChar(spell[0]), std::move(spell)));
+                else
+                    ReScanSpelling(spell, pos);
+            }
+            break;
+
+            default:
+            {
+                /* All remaining token types are shared between the two grammars */
+                AppendToken(tkn);
+            }
+            break;
+        }
+    }
+
+    /* Terminate the buffer with the end-of-stream token */
+    AppendToken(MakeShared<Token>(pos, Tokens::EndOfStream));
+
+    return AdoptPreLexedTokens(std::move(tokens), source);
+}
+
 
 /*
  * ======= Private: =======
@@ -168,9 +341,7 @@ TokenPtr HLSLScanner::ScanIdentifier()
     /* Scan identifier string */
     std::string spell;
     spell += TakeIt();
-
-    while (std::isalnum(UChr()) || Is('_'))
-        spell += TakeIt();
+    ScanIdentifierTail(spell);
 
     /* Scan reserved words */
     auto it = HLSLKeywords().find(spell);
@@ -179,11 +350,11 @@ TokenPtr HLSLScanner::ScanIdentifier()
         if (it->second == Token::Types::Reserved)
             Error("keyword '" + spell + "' is reserved for future use");
         else
-            return Make(it->second, spell);
+            return MakeView(it->second, spell);
     }
 
     /* Return as identifier */
-    return Make(Tokens::Ident, spell);
+    return MakeView(Tokens::Ident, spell);
 }
 
 TokenPtr HLSLScanner::ScanAssignShiftRelationOp(const char chr)
@@ -27,8 +27,16 @@ class HLSLScanner : public Scanner
         // Scanns the next token.
         TokenPtr Next() override;
 
+        /*
+        Adopts the specified pre-processor token string as the pre-lexed token buffer:
+        identifiers are classified via the HLSL keyword table, runs of operator tokens are re-scanned
+        (the pre-processor does not merge compound operators like "+="), white spaces are dropped,
+        and comments are attached to their subsequent token (see Scanner::GetComment).
+        */
+        bool PreLexTokenString(const TokenPtrString& tokenString, const SourceCodePtr& source) override;
+
     private:
-        
+
         /* === Functions === */
 
         TokenPtr ScanToken() override;
@@ -8,6 +8,7 @@
 #include "Parser.h"
 #include "AST.h"
 #include <algorithm>
+#include <thread>
 
 
 namespace Xsc
@@ -42,6 +43,9 @@ void Parser::Error(const std::string& msg, const Token* tkn, const HLSLErr error
     if (tkn->Type() == Tokens::EndOfStream)
         breakWithExpection = true;
 
+    /* Complete a background scan first: the report fetches the marked line from the source the producer still scans */
+    GetScanner().FinishPreLexing();
+
     /* Report error with the report handler */
     reportHandler_.Error(breakWithExpection, msg, GetScanner().Source(), GetTokenArea(tkn), errorCode);
 }
@@ -90,6 +94,9 @@ void Parser::ErrorInternal(const std::string& msg, const std::string& procName)
 
 void Parser::Warning(const std::string& msg, const Token* tkn)
 {
+    /* Complete a background scan first (see Error) */
+    GetScanner().FinishPreLexing();
+
     reportHandler_.Warning(false, msg, GetScanner().Source(), GetTokenArea(tkn));
 }
 
@@ -113,17 +120,112 @@ void Parser::PushScannerSource(const SourceCodePtr& source, const std::string& f
 
     scannerStack_.push({ scanner, filename, nullptr });
 
-    /* Start scanning */
-    if (!scanner->ScanSource(source))
-        throw std::runtime_error("failed to scan source code");
+    /*
+    Minimum source size for the scanner/parser overlap (see ConcurrentLexing):
+    below this, the thread start-up outweighs the overlapped scan.
+    */
+    static const std::size_t minConcurrentLexingSize = 65536;
+
+    if ( preLexTokens_ && concurrentLexing_ && source != nullptr &&
+         source->BufferSize() >= minConcurrentLexingSize && std::thread::hardware_concurrency() > 1 )
+    {
+        /* Scan the source on a second thread while this scanner already serves the tokens */
+        auto producerScanner = MakeScanner();
+        if (!producerScanner)
+            throw std::runtime_error("failed to create token scanner");
+
+        if (!producerScanner->ScanSource(source))
+            throw std::runtime_error("failed to scan source code");
+
+        /* Set initial source origin for scanner */
+        producerScanner->Source()->NextSourceOrigin(filename, 0);
+
+        if (!scanner->PreLexSourceConcurrent(producerScanner))
+            throw std::runtime_error("failed to start concurrent token scanner");
+    }
+    else
+    {
+        /* Start scanning */
+        if (!scanner->ScanSource(source))
+            throw std::runtime_error("failed to scan source code");
 
-    /* Set initial source origin for scanner */
-    scanner->Source()->NextSourceOrigin(filename, 0);
+        /* Set initial source origin for scanner */
+        scanner->Source()->NextSourceOrigin(filename, 0);
+
+        /* Lex the entire source into a contiguous token buffer up front (if enabled) */
+        if (preLexTokens_)
+            scanner->PreLexSource();
+    }
 
     /* Accept first token */
     AcceptIt();
 }
 
+void Parser::PushScannerPreLexedTokens(const TokenPtrString& tokenString, const SourceCodePtr& source, const std::string& filename)
+{
+    /* Add current token to previous scanner */
+    if (!scannerStack_.empty())
+        scannerStack_.top().nextToken = tkn_;
+
+    /* Make a new token scanner */
+    auto scanner = MakeScanner();
+    if (!scanner)
+        throw std::runtime_error("failed to create token scanner");
+
+    scannerStack_.push({ scanner, filename, nullptr });
+
+    /* Adopt the pre-lexed tokens instead of scanning the source text */
+    if (!scanner->PreLexTokenString(tokenString, source))
+        throw std::runtime_error("failed to adopt pre-lexed token string");
+
+    /* Accept first token */
+    AcceptIt();
+}
+
+void Parser::PushScannerPreLexedVector(std::vector<TokenPtr>&& tokens, const SourceCodePtr& source, const std::string& filename)
+{
+    /* Add current token to previous scanner */
+    if (!scannerStack_.empty())
+        scannerStack_.top().nextToken = tkn_;
+
+    /* Make a new token scanner */
+    auto scanner = MakeScanner();
+    if (!scanner)
+        throw std::runtime_error("failed to create token scanner");
+
+    scannerStack_.push({ scanner, filename, nullptr });
+
+    /* Adopt the pre-lexed tokens instead of scanning the source text */
+    if (!scanner->AdoptPreLexedVector(std::move(tokens), source))
+        throw std::runtime_error("failed to adopt pre-lexed tokens");
+
+    /* Accept first token */
+    AcceptIt();
+}
+
+void Parser::PushScannerPreLexedRange(
+    const Scanner& scanner, std::size_t firstTokenIndex, std::size_t lastTokenIndex,
+    const SourceCodePtr& source, const std::string& filename)
+{
+    /* Add current token to previous scanner */
+    if (!scannerStack_.empty())
+        scannerStack_.top().nextToken = tkn_;
+
+    /* Make a new token scanner */
+    auto rangeScanner = MakeScanner();
+    if (!rangeScanner)
+        throw std::runtime_error("failed to create token scanner");
+
+    scannerStack_.push({ rangeScanner, filename, nullptr });
+
+    /* Adopt the pre-lexed token range instead of scanning the source text */
+    if (!rangeScanner->AdoptPreLexedRange(scanner, firstTokenIndex, lastTokenIndex, source))
+        throw std::runtime_error("failed to adopt pre-lexed token range");
+
+    /* Load first token directly (the previous scanner may rest on its end-of-stream token) */
+    SetCurrentToken(GetScanner().Next());
+}
+
 bool Parser::PopScannerSource()
 {
     /* Get previous scanner */
@@ -136,7 +238,7 @@ bool Parser::PopScannerSource()
         return false;
 
     /* Reset previous 'next token' */
-    tkn_ = scannerStack_.top().nextToken;
+    SetCurrentToken(scannerStack_.top().nextToken);
 
     return (tkn_ != nullptr);
 }
@@ -178,11 +280,27 @@ TokenPtr Parser::AcceptIt()
 
     /* Scan next token and return previous one */
     auto prevTkn = tkn_;
-    tkn_ = GetScanner().Next();
+    SetCurrentToken(GetScanner().Next());
 
     return prevTkn;
 }
 
+TokenPtr Parser::TryAccept(const Tokens type)
+{
+    return (Is(type) ? AcceptIt() : nullptr);
+}
+
+TokenPtr Parser::TryAccept(const Tokens type, const std::string& spell)
+{
+    return (Is(type, spell) ? AcceptIt() : nullptr);
+}
+
+void Parser::SkipToNextDirective()
+{
+    /* Skip the raw source of the inactive code and make the directive (or end-of-stream) token the current one */
+    SetCurrentToken(GetScanner().SkipToNextDirective());
+}
+
 void Parser::PushTokenString(const TokenPtrString& tokenString)
 {
     /* Push token string onto stack in the scanner and accept first token */
@@ -208,6 +326,31 @@ void Parser::IgnoreNewLines()
         AcceptIt();
 }
 
+/* ----- Speculative parsing ----- */
+
+bool Parser::CanRollback()
+{
+    return GetScanner().CanResumeTokenIndex();
+}
+
+Parser::Checkpoint Parser::MakeCheckpoint()
+{
+    Checkpoint checkpoint;
+    {
+        checkpoint.tokenIndex               = GetScanner().ActiveTokenIndex();
+        checkpoint.unexpectedTokenCounter   = unexpectedTokenCounter_;
+    }
+    return checkpoint;
+}
+
+void Parser::RollbackTo(const Checkpoint& checkpoint)
+{
+    /* Rewind the pre-lexed token buffer and re-fetch the token at the restart point */
+    GetScanner().ResumeTokenIndex(checkpoint.tokenIndex);
+    SetCurrentToken(GetScanner().Next());
+    unexpectedTokenCounter_ = checkpoint.unexpectedTokenCounter;
+}
+
 /* ----- Parsing ----- */
 
 void Parser::PushParsingState(const ParsingState& state)
@@ -225,10 +368,10 @@ Parser::ParsingState Parser::ActiveParsingState() const
     return (parsingStateStack_.empty() ? ParsingState{ false } : parsingStateStack_.top());
 }
 
-// expr: logic_or_expr | ternary_expr;
+// expr: binary_expr | ternary_expr;
 ExprPtr Parser::ParseGenericExpr()
 {
-    auto ast = ParseLogicOrExpr();
+    auto ast = ParseBinaryExpr();
 
     /* Parse optional ternary expression */
     if (Is(Tokens::TernaryOp))
@@ -260,137 +403,87 @@ TernaryExprPtr Parser::ParseTernaryExpr(const ExprPtr& condExpr)
     return UpdateSourceArea(ast);
 }
 
-// expr: expr (operator expr)*;
-ExprPtr Parser::ParseAbstractBinaryExpr(const std::function<ExprPtr()>& parseFunc, const BinaryOpList& binaryOps)
-{
-    /* Parse sub expressions */
-    std::vector<ExprPtr> exprs;
-    std::vector<BinaryOp> ops;
-    std::vector<SourcePosition> opsPos;
-
-    /* Parse primary expression */
-    exprs.push_back(parseFunc());
-
-    while (Is(Tokens::BinaryOp))
+/*
+Returns the binding strength of the specified binary operator (higher binds tighter), or 0 if the
+operator does not participate in binary expressions. The levels mirror the previous recursive-descent
+ladder exactly, including its separate levels for '+' below '-' and for '*' below '/' and '%',
+so the parse trees are unchanged.
+*/
+static int BinaryOpPrecedence(const BinaryOp op)
+{
+    switch (op)
     {
-        /* Parse binary operator */
-        auto op = StringToBinaryOp(Tkn()->Spell());
-
-        if (std::find(binaryOps.begin(), binaryOps.end(), op) == binaryOps.end())
-            break;
-
-        AcceptIt();
-
-        /* Store operator and its source position */
-        ops.push_back(op);
-        opsPos.push_back(GetScanner().PreviousToken()->Pos());
-
-        /* Parse next sub-expression */
-        exprs.push_back(parseFunc());
+        case BinaryOp::LogicalOr:
+            return 1;
+        case BinaryOp::LogicalAnd:
+            return 2;
+        case BinaryOp::Or:
+            return 3;
+        case BinaryOp::Xor:
+            return 4;
+        case BinaryOp::And:
+            return 5;
+        case BinaryOp::Equal:
+        case BinaryOp::NotEqual:
+            return 6;
+        case BinaryOp::Less:
+        case BinaryOp::Greater:
+        case BinaryOp::LessEqual:
+        case BinaryOp::GreaterEqual:
+            return 7;
+        case BinaryOp::LShift:
+        case BinaryOp::RShift:
+            return 8;
+        case BinaryOp::Add:
+            return 9;
+        case BinaryOp::Sub:
+            return 10;
+        case BinaryOp::Mul:
+            return 11;
+        case BinaryOp::Div:
+        case BinaryOp::Mod:
+            return 12;
+        default:
+            return 0;
     }
-
-    /* Build (left-to-rigth) binary expression tree */
-    return BuildBinaryExprTree(exprs, ops, opsPos);
 }
 
-ExprPtr Parser::ParseLogicOrExpr()
+// binary_expr: binary_expr (operator binary_expr)*; parsed by precedence climbing over the operator table.
+ExprPtr Parser::ParseBinaryExpr(int minPrecedence)
 {
-    return ParseAbstractBinaryExpr(std::bind(&Parser::ParseLogicAndExpr, this), { BinaryOp::LogicalOr });
-}
-
-ExprPtr Parser::ParseLogicAndExpr()
-{
-    return ParseAbstractBinaryExpr(std::bind(&Parser::ParseBitwiseOrExpr, this), { BinaryOp::LogicalAnd });
-}
-
-ExprPtr Parser::ParseBitwiseOrExpr()
-{
-    return ParseAbstractBinaryExpr(std::bind(&Parser::ParseBitwiseXOrExpr, this), { BinaryOp::Or });
-}
-
-ExprPtr Parser::ParseBitwiseXOrExpr()
-{
-    return ParseAbstractBinaryExpr(std::bind(&Parser::ParseBitwiseAndExpr, this), { BinaryOp::Xor });
-}
+    /* Parse primary expression as initial left hand side */
+    auto lhsExpr = ParsePrimaryExpr();
 
-ExprPtr Parser::ParseBitwiseAndExpr()
-{
-    return ParseAbstractBinaryExpr(std::bind(&Parser::ParseEqualityExpr, this), { BinaryOp::And });
-}
-
-ExprPtr Parser::ParseEqualityExpr()
-{
-    return ParseAbstractBinaryExpr(std::bind(&Parser::ParseRelationExpr, this), { BinaryOp::Equal, BinaryOp::NotEqual });
-}
-
-ExprPtr Parser::ParseRelationExpr()
-{
-    /* Do not parse '<' and '>' as binary operator while a template is actively being parsed */
-    if (ActiveParsingState().activeTemplate)
-        return ParseAbstractBinaryExpr(std::bind(&Parser::ParseShiftExpr, this), { BinaryOp::LessEqual, BinaryOp::GreaterEqual });
-    else
-        return ParseAbstractBinaryExpr(std::bind(&Parser::ParseShiftExpr, this), { BinaryOp::Less, BinaryOp::LessEqual, BinaryOp::Greater, BinaryOp::GreaterEqual });
-}
-
-ExprPtr Parser::ParseShiftExpr()
-{
-    return ParseAbstractBinaryExpr(std::bind(&Parser::ParseAddExpr, this), { BinaryOp::LShift, BinaryOp::RShift });
-}
-
-ExprPtr Parser::ParseAddExpr()
-{
-    return ParseAbstractBinaryExpr(std::bind(&Parser::ParseSubExpr, this), { BinaryOp::Add });
-}
-
-ExprPtr Parser::ParseSubExpr()
-{
-    return ParseAbstractBinaryExpr(std::bind(&Parser::ParseMulExpr, this), { BinaryOp::Sub });
-}
-
-ExprPtr Parser::ParseMulExpr()
-{
-    return ParseAbstractBinaryExpr(std::bind(&Parser::ParseDivExpr, this), { BinaryOp::Mul });
-}
-
-ExprPtr Parser::ParseDivExpr()
-{
-    return ParseAbstractBinaryExpr(std::bind(&Parser::ParseValueExpr, this), { BinaryOp::Div, BinaryOp::Mod });
-}
+    while (Is(Tokens::BinaryOp))
+    {
+        /* Climb as long as the operator binds at least as tightly as the current level */
+        auto op = StringToBinaryOp(Tkn()->Spell());
 
-ExprPtr Parser::ParseValueExpr()
-{
-    return ParsePrimaryExpr();
-}
+        auto precedence = BinaryOpPrecedence(op);
+        if (precedence < minPrecedence)
+            break;
 
+        /* Do not parse '<' and '>' as binary operator while a template is actively being parsed */
+        if ( ActiveParsingState().activeTemplate &&
+             ( op == BinaryOp::Less || op == BinaryOp::Greater ) )
+        {
+            break;
+        }
 
-/*
- * ======= Private: =======
- */
+        AcceptIt();
 
-ExprPtr Parser::BuildBinaryExprTree(
-    std::vector<ExprPtr>& exprs, std::vector<BinaryOp>& ops, std::vector<SourcePosition>& opsPos)
-{
-    if (exprs.empty())
-        ErrorInternal("sub-expressions must not be empty", __FUNCTION__);
+        /* Store operator source position */
+        auto opPos = GetScanner().PreviousToken()->Pos();
 
-    if (exprs.size() > 1)
-    {
-        if (exprs.size() != ops.size() + 1 || exprs.size() != opsPos.size() + 1)
-            ErrorInternal("sub-expressions and operators have uncorrelated number of elements", __FUNCTION__);
+        /* Parse right hand side with the next tighter level (same level stays left-associative) */
+        auto rhsExpr = ParseBinaryExpr(precedence + 1);
 
+        /* Build binary expression node */
         auto ast = Make<BinaryExpr>();
 
-        /* Build right hand side */
-        ast->rhsExpr    = exprs.back();
-        ast->op         = ops.back();
-        auto opPos      = opsPos.back();
-
-        exprs.pop_back();
-        ops.pop_back();
-        opsPos.pop_back();
-
-        /* Build left hand side of the tree */
-        ast->lhsExpr = BuildBinaryExprTree(exprs, ops, opsPos);
+        ast->lhsExpr    = lhsExpr;
+        ast->op         = op;
+        ast->rhsExpr    = rhsExpr;
 
         /* Update source area */
         UpdateSourceArea(ast, ast->lhsExpr, ast->rhsExpr);
@@ -398,12 +491,17 @@ ExprPtr Parser::BuildBinaryExprTree(
         /* Update pointer offset of source area (to point directly to the operator in a line marker) */
         ast->area.Offset(opPos);
 
-        return ast;
+        lhsExpr = ast;
     }
 
-    return exprs.front();
+    return lhsExpr;
 }
 
+
+/*
+ * ======= Private: =======
+ */
+
 void Parser::IncUnexpectedTokenCounter()
 {
     /* Increment counter */
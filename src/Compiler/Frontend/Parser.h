@@ -34,13 +34,28 @@ class Parser
 {
     
     public:
-        
+
         virtual ~Parser();
 
+        // Sets the maximum number of error reports before the parsing is aborted (see ShaderInput::maxErrors).
+        inline void SetErrorLimit(std::size_t limit)
+        {
+            reportHandler_.SetErrorLimit(limit);
+        }
+
+        /*
+        Enables or disables the scanner/parser overlap for large sources (see ShaderInput::concurrentLexing):
+        if enabled, the pre-lexed token buffer is filled by a second thread while the parsing already runs.
+        Only effective when the tokens are pre-lexed from source text (see PreLexTokens). By default disabled.
+        */
+        inline void ConcurrentLexing(bool enable)
+        {
+            concurrentLexing_ = enable;
+        }
+
     protected:
         
         using Tokens        = Token::Types;
-        using BinaryOpList  = std::initializer_list<BinaryOp>;
 
         struct ParsingState
         {
@@ -69,6 +84,28 @@ class Parser
         virtual ScannerPtr MakeScanner() = 0;
 
         virtual void PushScannerSource(const SourceCodePtr& source, const std::string& filename = "");
+
+        /*
+        Makes a new scanner that serves the specified pre-lexed token string instead of scanning source text
+        (see Scanner::PreLexTokenString); 'source' is only used for error line markers.
+        */
+        void PushScannerPreLexedTokens(const TokenPtrString& tokenString, const SourceCodePtr& source, const std::string& filename = "");
+
+        /*
+        Makes a new scanner that serves the token range [firstTokenIndex, lastTokenIndex] of the pre-lexed
+        token buffer of the specified scanner (see Scanner::AdoptPreLexedRange).
+        */
+        void PushScannerPreLexedRange(
+            const Scanner& scanner, std::size_t firstTokenIndex, std::size_t lastTokenIndex,
+            const SourceCodePtr& source, const std::string& filename = ""
+        );
+
+        /*
+        Makes a new scanner that serves the specified pre-lexed tokens directly,
+        e.g. from a precompiled header module (see Scanner::AdoptPreLexedVector).
+        */
+        void PushScannerPreLexedVector(std::vector<TokenPtr>&& tokens, const SourceCodePtr& source, const std::string& filename = "");
+
         virtual bool PopScannerSource();
 
         ParsingState ActiveParsingState() const;
@@ -83,10 +120,35 @@ class Parser
         TokenPtr Accept(const Tokens type, const std::string& spell);
         virtual TokenPtr AcceptIt();
 
+        // Accepts and returns the current token only if it matches the specified type (and spelling); returns null without reporting an error otherwise.
+        TokenPtr TryAccept(const Tokens type);
+        TokenPtr TryAccept(const Tokens type, const std::string& spell);
+
+        // Skips inactive source code up to the next potential directive line and accepts the token scanned there (see Scanner::SkipToNextDirective).
+        void SkipToNextDirective();
+
         // Pushes the specified token string onto the stack where further tokens will be parsed from the top of the stack.
         void PushTokenString(const TokenPtrString& tokenString);
         void PopTokenString();
 
+        // Enables or disables token pre-lexing: if enabled, each pushed scanner source is lexed into a contiguous token buffer up front.
+        inline void PreLexTokens(bool enable)
+        {
+            preLexTokens_ = enable;
+        }
+
+        // Returns the token the specified number of positions ahead of the current one (pre-lexed mode only; null otherwise).
+        inline TokenPtr PeekToken(std::size_t offset = 1)
+        {
+            return GetScanner().LookAhead(offset);
+        }
+
+        // Returns the type of the token the specified number of positions ahead of the current one, without touching the token objects (see Scanner::LookAheadType).
+        inline Tokens PeekTokenType(std::size_t offset = 1)
+        {
+            return GetScanner().LookAheadType(offset);
+        }
+
         // Ignores the next tokens if they are white spaces and optionally new lines.
         void IgnoreWhiteSpaces(bool includeNewLines = false);//, bool includeComments = true);
         void IgnoreNewLines();
@@ -120,6 +182,28 @@ class Parser
             return ast;
         }
 
+        /* ----- Speculative parsing ----- */
+
+        // Restart point within the pre-lexed token buffer (see MakeCheckpoint).
+        struct Checkpoint
+        {
+            std::size_t     tokenIndex              = 0;
+            unsigned int    unexpectedTokenCounter  = 0;
+        };
+
+        // Returns true if the scanner serves tokens from the pre-lexed buffer, i.e. checkpoints can be taken and rolled back.
+        bool CanRollback();
+
+        // Returns a restart point at the current token; only valid in the pre-lexed mode (see CanRollback).
+        Checkpoint MakeCheckpoint();
+
+        /*
+        Rewinds the scanner to the specified restart point, so all tokens accepted since then are served again.
+        Speculative code between checkpoint and rollback must only match tokens with the non-throwing
+        functions (TryAccept, Is), since submitted reports are not taken back.
+        */
+        void RollbackTo(const Checkpoint& checkpoint);
+
         /* ----- Parsing ----- */
 
         void PushParsingState(const ParsingState& state);
@@ -128,21 +212,12 @@ class Parser
         ExprPtr         ParseGenericExpr();
         TernaryExprPtr  ParseTernaryExpr(const ExprPtr& condExpr);
 
-        ExprPtr         ParseAbstractBinaryExpr(const std::function<ExprPtr()>& parseFunc, const BinaryOpList& binaryOps);
-
-        ExprPtr         ParseLogicOrExpr();
-        ExprPtr         ParseLogicAndExpr();
-        ExprPtr         ParseBitwiseOrExpr();
-        ExprPtr         ParseBitwiseXOrExpr();
-        ExprPtr         ParseBitwiseAndExpr();
-        ExprPtr         ParseEqualityExpr();
-        ExprPtr         ParseRelationExpr();
-        ExprPtr         ParseShiftExpr();
-        ExprPtr         ParseAddExpr();
-        ExprPtr         ParseSubExpr();
-        ExprPtr         ParseMulExpr();
-        ExprPtr         ParseDivExpr();
-        ExprPtr         ParseValueExpr();
+        /*
+        Parses a binary expression by precedence climbing: operators that bind at least as tightly as
+        the specified level are consumed in a loop, so the call depth is bounded by the number of
+        precedence levels instead of growing with the operand count (see BinaryOpPrecedence).
+        */
+        ExprPtr         ParseBinaryExpr(int minPrecedence = 1);
 
         virtual ExprPtr ParsePrimaryExpr() = 0;
 
@@ -173,10 +248,14 @@ class Parser
             return tkn_;
         }
 
-        // Returns the type of the next token.
+        /*
+        Returns the type of the next token. The type is mirrored in a plain member whenever the current
+        token changes (see SetCurrentToken), so the type checks of the parser dispatch (Is, Accept) read
+        a single hot value instead of dereferencing the token object.
+        */
         inline Tokens TknType() const
         {
-            return Tkn()->Type();
+            return tknType_;
         }
 
         // Returns true if the next token is from the specified type.
@@ -204,12 +283,12 @@ class Parser
 
         /* === Functions === */
 
-        // Builds a left-to-right binary-expression tree hierarchy for the specified list of expressions.
-        ExprPtr BuildBinaryExprTree(
-            std::vector<ExprPtr>& exprs,
-            std::vector<BinaryOp>& ops,
-            std::vector<SourcePosition>& opsPos
-        );
+        // Makes the specified token the current one and caches its type (see TknType).
+        inline void SetCurrentToken(const TokenPtr& tkn)
+        {
+            tkn_     = tkn;
+            tknType_ = (tkn != nullptr ? tkn->Type() : Tokens::EndOfStream);
+        }
 
         void IncUnexpectedTokenCounter();
 
@@ -222,6 +301,7 @@ class Parser
 
         Log*                            log_                    = nullptr;
         TokenPtr                        tkn_;
+        Tokens                          tknType_                = Tokens::EndOfStream;
 
         std::stack<ScannerStackEntry>   scannerStack_;
         std::stack<ParsingState>        parsingStateStack_;
@@ -229,6 +309,9 @@ class Parser
         unsigned int                    unexpectedTokenCounter_ = 0;
         const unsigned int              unexpectedTokenLimit_   = 3; //< this should never be less than 1
 
+        bool                            preLexTokens_           = false;
+        bool                            concurrentLexing_       = false;
+
 };
 
 
@@ -7,9 +7,12 @@
 
 #include "PreProcessor.h"
 #include "AST.h"
+#include "CompileStats.h"
 #include "ConstExprEvaluator.h"
 #include "Helper.h"
+#include "IncludeCache.h"
 #include <sstream>
+#include <algorithm>
 
 
 namespace Xsc
@@ -27,6 +30,8 @@ std::unique_ptr<std::iostream> PreProcessor::Process(const SourceCodePtr& input,
     output_         = MakeUnique<std::stringstream>();
     writeLineMarks_ = writeLineMarks;
 
+    PrefetchIncludes(input);
+
     PushScannerSource(input, filename);
 
     try
@@ -39,10 +44,45 @@ std::unique_ptr<std::iostream> PreProcessor::Process(const SourceCodePtr& input,
         if (GetLog())
             GetLog()->SumitReport(err);
     }
+    catch (const ErrorLimitAbort&)
+    {
+        /* The abort report was already submitted (see ShaderInput::maxErrors) */
+    }
 
     return nullptr;
 }
 
+std::unique_ptr<TokenPtrString> PreProcessor::ProcessToTokenString(const SourceCodePtr& input, const std::string& filename)
+{
+    auto output = MakeUnique<TokenPtrString>();
+
+    tokenOutput_    = output.get();
+    writeLineMarks_ = false;
+
+    PrefetchIncludes(input);
+
+    PushScannerSource(input, filename);
+
+    try
+    {
+        ParseProgram();
+        tokenOutput_ = nullptr;
+        return (GetReportHandler().HasErros() ? nullptr : std::move(output));
+    }
+    catch (const Report& err)
+    {
+        if (GetLog())
+            GetLog()->SumitReport(err);
+    }
+    catch (const ErrorLimitAbort&)
+    {
+        /* The abort report was already submitted (see ShaderInput::maxErrors) */
+    }
+
+    tokenOutput_ = nullptr;
+    return nullptr;
+}
+
 std::vector<std::string> PreProcessor::ListDefinedMacroIdents() const
 {
     std::vector<std::string> idents;
@@ -51,9 +91,39 @@ std::vector<std::string> PreProcessor::ListDefinedMacroIdents() const
     for (const auto& macro : macros_)
         idents.push_back(macro.first);
 
+    /* Sort identifiers, since the hashed macro table has no defined iteration order */
+    std::sort(idents.begin(), idents.end());
+
     return idents;
 }
 
+void PreProcessor::PredefineMacro(const std::string& ident, const std::string& value)
+{
+    /* Make new macro symbol */
+    auto macro = std::make_shared<Macro>();
+
+    if (!value.empty())
+    {
+        /* Scan only the value text into the macro's token string (bypasses the '#define'-directive syntax) */
+        PreProcessorScanner valueScanner(GetLog());
+        if (valueScanner.ScanSource(std::make_shared<SourceCode>(std::make_shared<std::istringstream>(value + '\n'))))
+        {
+            for (auto tkn = valueScanner.Next(); tkn && tkn->Type() != Tokens::EndOfStream; tkn = valueScanner.Next())
+                macro->tokenString.PushBack(tkn);
+
+            /* Remove the trailing new-line token again */
+            macro->tokenString.TrimBack();
+        }
+    }
+
+    macros_[ident] = macro;
+}
+
+void PreProcessor::DefineHeaderModule(const std::string& filename, std::vector<TokenPtr>&& tokens)
+{
+    headerModules_[filename] = std::move(tokens);
+}
+
 
 /*
  * ======= Private: =======
@@ -64,8 +134,16 @@ ScannerPtr PreProcessor::MakeScanner()
     return std::make_shared<PreProcessorScanner>(GetLog());
 }
 
+void PreProcessor::PrefetchIncludes(const SourceCodePtr& input) const
+{
+    /* Prefetch the include closure on a background thread, so include reads overlap with parsing */
+    if (input)
+        IncludeCache::Instance().Prefetch(input->Buffer(), input->BufferSize(), includeHandler_.searchPaths);
+}
+
 void PreProcessor::PushScannerSource(const SourceCodePtr& source, const std::string& filename)
 {
+    PushIncludeGuardTrace(filename);
     Parser::PushScannerSource(source, filename);
     GetScanner().Source()->NextSourceOrigin(filename, 0);
     WritePosToLineDirective();
@@ -73,6 +151,7 @@ void PreProcessor::PushScannerSource(const SourceCodePtr& source, const std::str
 
 bool PreProcessor::PopScannerSource()
 {
+    PopIncludeGuardTrace();
     if (Parser::PopScannerSource())
     {
         WritePosToLineDirective();
@@ -115,14 +194,82 @@ PreProcessor::IfBlock PreProcessor::TopIfBlock() const
     return (ifBlockStack_.empty() ? IfBlock() : ifBlockStack_.top());
 }
 
+/* ----- Include guards ----- */
+
+void PreProcessor::PushIncludeGuardTrace(const std::string& filename)
+{
+    IncludeGuard guard;
+    {
+        guard.filename      = filename;
+        guard.entryIfDepth  = ifBlockStack_.size();
+    }
+    includeGuardStack_.push(std::move(guard));
+}
+
+void PreProcessor::PopIncludeGuardTrace()
+{
+    if (!includeGuardStack_.empty())
+    {
+        /* Record a complete include guard, so a repeated inclusion can be skipped (see ParseDirectiveInclude) */
+        const auto& guard = includeGuardStack_.top();
+        if (guard.state == IncludeGuard::States::Closed && !guard.filename.empty())
+            includeGuards_[guard.filename] = guard.macroIdent;
+        includeGuardStack_.pop();
+    }
+}
+
+void PreProcessor::ObserveIncludeGuardDirective(const std::string& directive)
+{
+    if (includeGuardStack_.empty())
+        return;
+
+    auto& guard = includeGuardStack_.top();
+
+    switch (guard.state)
+    {
+        case IncludeGuard::States::Pending:
+            /* Only an '#ifndef'-directive may open the file (adopted as candidate in ParseDirectiveIfndef) */
+            if (directive != "ifndef" || ifBlockStack_.size() != guard.entryIfDepth)
+                guard.state = IncludeGuard::States::Disqualified;
+            break;
+
+        case IncludeGuard::States::Guarded:
+            /* An '#elif'- or '#else'-directive on the guard scope re-activates content when the macro is defined */
+            if (ifBlockStack_.size() == guard.entryIfDepth + 1 && (directive == "elif" || directive == "else"))
+                guard.state = IncludeGuard::States::Disqualified;
+            break;
+
+        case IncludeGuard::States::Closed:
+            /* Any directive after the guard's '#endif' takes effect on a repeated inclusion */
+            guard.state = IncludeGuard::States::Disqualified;
+            break;
+
+        default:
+            break;
+    }
+}
+
+void PreProcessor::DisqualifyIncludeGuard()
+{
+    if (!includeGuardStack_.empty())
+    {
+        auto& guard = includeGuardStack_.top();
+        if (ifBlockStack_.size() <= guard.entryIfDepth)
+            guard.state = IncludeGuard::States::Disqualified;
+    }
+}
+
 TokenPtrString PreProcessor::ExpandMacro(const Macro& macro, const std::vector<TokenPtrString>& arguments)
 {
     TokenPtrString expandedString;
 
     if (macro.parameters.size() > arguments.size())
         return expandedString;
-    
-    auto ExpandTokenString = [&](TokenPtrString::Container::const_iterator& tknIt, const TokenPtrString::Container::const_iterator& tknItEnd) -> bool
+
+    /* Reserve segment storage for the argument splices and the body runs between them up front */
+    expandedString.Reserve(arguments.size() * 2 + 1);
+
+    auto ExpandTokenString = [&](TokenPtrString::RawConstIterator& tknIt, const TokenPtrString::RawConstIterator& tknItEnd) -> bool
     {
         const auto& tkn = **tknIt;
 
@@ -201,10 +348,9 @@ TokenPtrString PreProcessor::ExpandMacro(const Macro& macro, const std::vector<T
         return false;
     };
 
-    const auto& tokens = macro.tokenString.GetTokens();
-    for (auto it = tokens.begin(); it != tokens.end(); ++it)
+    for (auto it = macro.tokenString.begin(); it != macro.tokenString.end(); ++it)
     {
-        if (!ExpandTokenString(it, tokens.end()))
+        if (!ExpandTokenString(it, macro.tokenString.end()))
             expandedString.PushBack(*it);
     }
 
@@ -241,20 +387,24 @@ void PreProcessor::ParseProgram()
                         ParesComment();
                         break;
                     case Tokens::Ident:
+                        DisqualifyIncludeGuard();
                         ParseIdent();
                         break;
                     default:
+                        /* White spaces and new-lines outside the guard scope do not disqualify an include guard */
+                        if (!Is(Tokens::WhiteSpaces) && !Is(Tokens::NewLines))
+                            DisqualifyIncludeGuard();
                         ParseMisc();
                         break;
                 }
             }
             else
             {
-                /* On an inactive if-block: parse only '#if'-directives or skip to next line */
+                /* On an inactive if-block: parse only '#if'-directives or skip the raw source up to the next directive line */
                 if (TknType() == Tokens::Directive)
                     ParseAnyIfDirectiveAndSkipValidation();
                 else
-                    AcceptIt();
+                    SkipToNextDirective();
             }
         }
     }
@@ -276,12 +426,20 @@ void PreProcessor::ParseProgram()
 
 void PreProcessor::ParesComment()
 {
-    Out() << Accept(Tokens::Comment)->Spell();
+    auto tkn = Accept(Tokens::Comment);
+    if (tokenOutput_)
+        tokenOutput_->PushBack(tkn);
+    else
+        Out().write(tkn->SpellData(), static_cast<std::streamsize>(tkn->SpellSize()));
 }
 
 void PreProcessor::ParseIdent()
 {
-    Out() << ParseIdentAsTokenString();
+    auto tokenString = ParseIdentAsTokenString();
+    if (tokenOutput_)
+        tokenOutput_->PushBack(std::move(tokenString));
+    else
+        Out() << tokenString;
 }
 
 TokenPtrString PreProcessor::ParseIdentAsTokenString()
@@ -311,6 +469,10 @@ TokenPtrString PreProcessor::ParseIdentAsTokenString()
         {
             /* Perform macro expansion */
             auto& macro = *it->second;
+
+            if (auto stats = ActiveCompileStats())
+                ++stats->macroExpansions;
+
             if (!macro.parameters.empty())
             {
                 /* Replace identifier to macro with arguments */
@@ -362,7 +524,7 @@ TokenPtrString PreProcessor::ParseIdentArgumentsForMacro(const TokenPtr& identTo
         arg.TrimBack();
         arg.TrimFront();
 
-        arguments.push_back(arg);
+        arguments.push_back(std::move(arg));
 
         if (Is(Tokens::Comma))
             AcceptIt();
@@ -393,7 +555,11 @@ TokenPtrString PreProcessor::ParseIdentArgumentsForMacro(const TokenPtr& identTo
 
 void PreProcessor::ParseMisc()
 {
-    Out() << AcceptIt()->Spell();
+    auto tkn = AcceptIt();
+    if (tokenOutput_)
+        tokenOutput_->PushBack(tkn);
+    else
+        Out().write(tkn->SpellData(), static_cast<std::streamsize>(tkn->SpellSize()));
 }
 
 void PreProcessor::ParseDirective()
@@ -401,6 +567,8 @@ void PreProcessor::ParseDirective()
     /* Parse pre-processor directive */
     auto directive = Accept(Tokens::Directive)->Spell();
 
+    ObserveIncludeGuardDirective(directive);
+
     if (directive == "define")
         ParseDirectiveDefine();
     else if (directive == "undef")
@@ -439,6 +607,8 @@ void PreProcessor::ParseAnyIfDirectiveAndSkipValidation()
     auto tkn = Accept(Tokens::Directive);
     auto directive = tkn->Spell();
 
+    ObserveIncludeGuardDirective(directive);
+
     if (directive == "if")
         ParseDirectiveIf(true);
     else if (directive == "ifdef")
@@ -586,6 +756,21 @@ void PreProcessor::ParseDirectiveInclude()
     /* Check if filename has already been marked as 'once included' */
     if (onceIncluded_.find(filename) == onceIncluded_.end())
     {
+        /* Skip the inclusion entirely when the file's include guard was detected and its macro is (still) defined */
+        auto guardIt = includeGuards_.find(filename);
+        if (guardIt != includeGuards_.end() && IsDefined(guardIt->second))
+            return;
+
+        /* Splice the precompiled token module for this filename, if one was defined */
+        auto moduleIt = headerModules_.find(filename);
+        if (moduleIt != headerModules_.end())
+        {
+            PushIncludeGuardTrace(filename);
+            PushScannerPreLexedVector(std::vector<TokenPtr>(moduleIt->second), nullptr, filename);
+            WritePosToLineDirective();
+            return;
+        }
+
         /* Open source code */
         std::unique_ptr<std::istream> includeStream;
 
@@ -640,7 +825,18 @@ void PreProcessor::ParseDirectiveIfndef(bool skipEvaluation)
     /* Parse identifier */
     IgnoreWhiteSpaces();
     auto ident = Accept(Tokens::Ident)->Spell();
-    
+
+    /* Adopt this '#ifndef' as include-guard candidate when it opens the current file (see IncludeGuard) */
+    if (!includeGuardStack_.empty())
+    {
+        auto& guard = includeGuardStack_.top();
+        if (guard.state == IncludeGuard::States::Pending && ifBlockStack_.size() == guard.entryIfDepth)
+        {
+            guard.macroIdent    = ident;
+            guard.state         = IncludeGuard::States::Guarded;
+        }
+    }
+
     /* Push new if-block activation (with 'not defined' condExpr) */
     PushIfBlock(tkn, !IsDefined(ident));
 }
@@ -724,6 +920,14 @@ void PreProcessor::ParseDirectiveEndif()
 {
     /* Only pop if-block from top of the stack */
     PopIfBlock();
+
+    /* Close the include-guard candidate when this '#endif' returns to the file's entry depth (see IncludeGuard) */
+    if (!includeGuardStack_.empty())
+    {
+        auto& guard = includeGuardStack_.top();
+        if (guard.state == IncludeGuard::States::Guarded && ifBlockStack_.size() == guard.entryIfDepth)
+            guard.state = IncludeGuard::States::Closed;
+    }
 }
 
 // '#' 'pragma' TOKEN-STRING
@@ -808,7 +1012,7 @@ void PreProcessor::ParseDirectiveError()
     /* Convert token string into error message */
     std::string errorMsg;
 
-    for (const auto& tkn : tokenString.GetTokens())
+    for (const auto& tkn : tokenString)
         errorMsg += tkn->Spell();
 
     GetReportHandler().SubmitReport(true, Report::Types::Error, "error", errorMsg, GetScanner().Source(), tkn->Area());
@@ -838,7 +1042,7 @@ ExprPtr PreProcessor::ParsePrimaryExpr()
             /* Parse unary expression */
             auto ast = Make<UnaryExpr>();
             ast->op     = StringToUnaryOp(AcceptIt()->Spell());
-            ast->expr   = ParseValueExpr();
+            ast->expr   = ParsePrimaryExpr();
             return ast;
         }
         break;
@@ -20,8 +20,9 @@
 #include <functional>
 #include <initializer_list>
 #include <stack>
-#include <map>
+#include <unordered_map>
 #include <set>
+#include <map>
 
 
 namespace Xsc
@@ -48,9 +49,26 @@ class PreProcessor : public Parser
             bool writeLineMarks = true
         );
 
-        // Returns a list of all defined macro identifiers after pre-processing.
+        // Returns a list of all defined macro identifiers (in alphabetical order) after pre-processing.
         std::vector<std::string> ListDefinedMacroIdents() const;
 
+        // Defines a macro with the specified identifier and optional value, as if by a heading '#define'-directive.
+        void PredefineMacro(const std::string& ident, const std::string& value = "");
+
+        /*
+        Pre-processes the specified input into a token string instead of output text, so the result can be
+        handed to the parser without being serialized and re-scanned (see HLSLParser::ParseTokenString).
+        Line marks are not written; the tokens keep their original source positions.
+        */
+        std::unique_ptr<TokenPtrString> ProcessToTokenString(const SourceCodePtr& input, const std::string& filename = "");
+
+        /*
+        Defines a precompiled header module for the specified include filename: when an '#include'-directive
+        names this filename, the tokens are spliced into the stream instead of loading and scanning the file
+        (see TokenModule). The tokens must be terminated by the end-of-stream token.
+        */
+        void DefineHeaderModule(const std::string& filename, std::vector<TokenPtr>&& tokens);
+
     private:
         
         /* === Structures === */
@@ -70,6 +88,28 @@ class PreProcessor : public Parser
             bool            expectEndif    = false;
         };
 
+        /*
+        Include-guard detection state of an open source file. A file whose entire content is wrapped
+        in a classic '#ifndef GUARD ... #endif' pattern is recorded on its first read, so a repeated
+        '#include'-directive for the same file can be skipped with a single map lookup while the
+        controlling macro is defined (see ParseDirectiveInclude), instead of re-scanning the file.
+        */
+        struct IncludeGuard
+        {
+            enum class States
+            {
+                Pending,        //< Nothing significant parsed yet; an opening '#ifndef' can still become the guard
+                Guarded,        //< Inside the scope of the guard's '#ifndef'
+                Closed,         //< The guard's '#endif' closed the file; any further significant token disqualifies
+                Disqualified,   //< The file has no include guard that spans its entire content
+            };
+
+            std::string filename;                           //< Filename as spelled in the '#include'-directive
+            std::string macroIdent;                         //< Identifier of the controlling guard macro
+            std::size_t entryIfDepth    = 0;                //< Depth of the if-block stack when the file was entered
+            States      state           = States::Pending;
+        };
+
         using MacroPtr = std::shared_ptr<Macro>;
 
         /* === Functions === */
@@ -79,6 +119,9 @@ class PreProcessor : public Parser
         void PushScannerSource(const SourceCodePtr& source, const std::string& filename = "") override;
         bool PopScannerSource() override;
 
+        // Starts prefetching the include closure of the specified input on a background thread (see IncludeCache::Prefetch).
+        void PrefetchIncludes(const SourceCodePtr& input) const;
+
         // Returns true if the specified symbol is defined.
         bool IsDefined(const std::string& ident) const;
 
@@ -97,6 +140,20 @@ class PreProcessor : public Parser
         // Writes a '#line'-directive to the output with the current source position and filename.
         void WritePosToLineDirective();
 
+        /* ----- Include guards ----- */
+
+        // Starts include-guard detection for a newly opened source file (see IncludeGuard).
+        void PushIncludeGuardTrace(const std::string& filename);
+
+        // Finishes include-guard detection for the closed source file, and records a complete guard.
+        void PopIncludeGuardTrace();
+
+        // Observes the specified directive for the include-guard detection of the current file.
+        void ObserveIncludeGuardDirective(const std::string& directive);
+
+        // Disqualifies the include-guard candidate of the current file, when program text occurs outside the guard scope.
+        void DisqualifyIncludeGuard();
+
         // Returns the output stream as reference.
         inline std::stringstream& Out()
         {
@@ -141,8 +198,20 @@ class PreProcessor : public Parser
 
         std::unique_ptr<std::stringstream>  output_;
 
-        std::map<std::string, MacroPtr>     macros_;
-        std::set<std::string>               onceIncluded_;
+        // Token sink for the token-string output mode (see ProcessToTokenString); null in the textual mode.
+        TokenPtrString*                     tokenOutput_    = nullptr;
+
+        std::unordered_map<std::string, MacroPtr>   macros_;
+        std::set<std::string>                       onceIncluded_;
+
+        // Controlling include-guard macro by filename: a repeated '#include' is skipped while the macro is defined.
+        std::map<std::string, std::string>          includeGuards_;
+
+        // Include-guard detection state per open source file (parallel to the scanner source stack).
+        std::stack<IncludeGuard>                    includeGuardStack_;
+
+        // Precompiled header modules by include filename (see DefineHeaderModule).
+        std::map<std::string, std::vector<TokenPtr>> headerModules_;
 
         /*
         Stack to store the info which if-block in the hierarchy is active.
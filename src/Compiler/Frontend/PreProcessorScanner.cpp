@@ -158,12 +158,10 @@ TokenPtr PreProcessorScanner::ScanIdentifier()
     /* Scan identifier string */
     std::string spell;
     spell += TakeIt();
-
-    while (std::isalnum(UChr()) || Is('_'))
-        spell += TakeIt();
+    ScanIdentifierTail(spell);
 
     /* Return as identifier */
-    return Make(Token::Types::Ident, spell);
+    return MakeView(Token::Types::Ident, spell);
 }
 
 
@@ -6,14 +6,69 @@
  */
 
 #include "Scanner.h"
+#include "CompileStats.h"
+#include "CompileBudget.h"
 #include "Helper.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include <cctype>
+#include <cstring>
 
 
 namespace Xsc
 {
 
 
+/*
+Report sink of the producer thread of a background scan: lexical reports are captured here and
+replayed on the consumer thread when the scan completes, since the real log is not thread safe.
+*/
+class ConcurrentPreLexLog : public Log
+{
+
+    public:
+
+        void SumitReport(const Report& report) override
+        {
+            reports.push_back(report);
+        }
+
+        std::vector<Report> reports;
+
+};
+
+/*
+Shared state of a background scan (see Scanner::PreLexSourceConcurrent). The producer thread scans
+the source into fixed-size token blocks and publishes them through a lock-free single-producer/
+single-consumer ring; the consumer appends the popped blocks to its contiguous pre-lexed buffer, so
+all index-based invariants of the buffer remain single-threaded. The ring capacity bounds how far
+the producer runs ahead, which also keeps the token budgets approximately enforced (the served
+tokens are counted on the consumer side, see NextToken).
+*/
+struct Scanner::ConcurrentPreLexState
+{
+    static const std::size_t blockSize = 256;   //< tokens per published block
+    static const std::size_t ringSize  = 8;     //< blocks in flight
+
+    ScannerPtr                  producer;               //< scanner running on the producer thread
+    ConcurrentPreLexLog         capturedLog;            //< report sink of the producer thread
+    std::vector<PreLexedToken>  blocks[ringSize];       //< ring slots
+    std::atomic<std::size_t>    head;                   //< next slot the consumer pops
+    std::atomic<std::size_t>    tail;                   //< next slot the producer fills
+    std::atomic<bool>           done;                   //< set by the producer after its final publish
+    std::atomic<bool>           stop;                   //< set by the consumer to abort the scan early
+    std::thread                 thread;
+
+    ConcurrentPreLexState() :
+        head{ 0     },
+        tail{ 0     },
+        done{ false },
+        stop{ false }
+    {
+    }
+};
+
 Scanner::Scanner(Log* log) :
     log_{ log }
 {
@@ -21,6 +76,12 @@ Scanner::Scanner(Log* log) :
 
 Scanner::~Scanner()
 {
+    /* Abort a still running background scan (e.g. when the parse was aborted by an exception) */
+    if (concurrentPreLex_ != nullptr)
+    {
+        concurrentPreLex_->stop.store(true, std::memory_order_relaxed);
+        FinishPreLexing();
+    }
 }
 
 bool Scanner::ScanSource(const SourceCodePtr& source)
@@ -35,6 +96,210 @@ bool Scanner::ScanSource(const SourceCodePtr& source)
     return false;
 }
 
+bool Scanner::PreLexSource()
+{
+    if (!source_ || preLexed_)
+        return false;
+
+    /* Scan the entire source into the contiguous token buffer */
+    while (true)
+    {
+        auto tkn = Next();
+        if (!tkn)
+            return false;
+
+        preLexedTypes_.push_back(static_cast<std::uint8_t>(tkn->Type()));
+        preLexedTokens_.push_back({ tkn, comment_ });
+
+        if (tkn->Type() == Tokens::EndOfStream)
+            break;
+    }
+
+    /* Reset token states, so that serving from the buffer starts like a fresh scan */
+    activeToken_.reset();
+    prevToken_.reset();
+    comment_.clear();
+
+    preLexedIndex_  = 0;
+    preLexed_       = true;
+
+    return true;
+}
+
+bool Scanner::PreLexSourceConcurrent(const std::shared_ptr<Scanner>& producerScanner)
+{
+    if (preLexed_ || concurrentPreLex_ != nullptr || !producerScanner || !producerScanner->source_)
+        return false;
+
+    /* Keep the source only for error line markers; it must not be read while the producer still scans it (see FinishPreLexing) */
+    source_ = producerScanner->GetSharedSource();
+
+    /* Route the producer reports into the capture log (the real log is replayed into on completion) */
+    concurrentPreLex_.reset(new ConcurrentPreLexState());
+    concurrentPreLex_->producer = producerScanner;
+    producerScanner->log_ = &(concurrentPreLex_->capturedLog);
+
+    /* Start the producer thread and serve tokens from the (growing) buffer right away */
+    concurrentPreLex_->thread = std::thread(Scanner::ConcurrentPreLexProducer, std::ref(*concurrentPreLex_));
+
+    activeToken_.reset();
+    prevToken_.reset();
+    comment_.clear();
+
+    preLexedIndex_  = 0;
+    preLexed_       = true;
+
+    return true;
+}
+
+void Scanner::FinishPreLexing()
+{
+    if (concurrentPreLex_ == nullptr)
+        return;
+
+    auto& state = *concurrentPreLex_;
+
+    /* Drain every remaining block, so the producer never starves on a full ring */
+    DrainPreLexedBlocks(std::size_t(-1));
+
+    if (state.thread.joinable())
+        state.thread.join();
+
+    /* Replay the reports captured on the producer thread */
+    if (log_ != nullptr)
+    {
+        for (const auto& report : state.capturedLog.reports)
+            log_->SumitReport(report);
+    }
+
+    concurrentPreLex_.reset();
+
+    /* Terminate the buffer if the scan was aborted before the end of the stream (see ~Scanner) */
+    if (preLexedTokens_.empty() || preLexedTokens_.back().token->Type() != Tokens::EndOfStream)
+    {
+        auto pos = (preLexedTokens_.empty() ? SourcePosition() : preLexedTokens_.back().token->Pos());
+        preLexedTypes_.push_back(static_cast<std::uint8_t>(Tokens::EndOfStream));
+        preLexedTokens_.push_back({ std::make_shared<Token>(pos, Tokens::EndOfStream), "" });
+    }
+}
+
+bool Scanner::PreLexTokenString(const TokenPtrString& /*tokenString*/, const SourceCodePtr& /*source*/)
+{
+    return false;
+}
+
+TokenPtr Scanner::LookAhead(std::size_t offset) const
+{
+    if (!preLexed_ || preLexedIndex_ == 0)
+        return nullptr;
+
+    /* The block drain is logically a cache fill of the buffer, so the lookahead remains const (see PreLexSourceConcurrent) */
+    if (concurrentPreLex_ != nullptr)
+        const_cast<Scanner*>(this)->DrainPreLexedBlocks(preLexedIndex_ - 1 + offset);
+
+    /* Offset 0 denotes the active token (the last one served by "Next") */
+    auto activeIdx = std::min(preLexedIndex_, preLexedTokens_.size()) - 1;
+    return preLexedTokens_[std::min(activeIdx + offset, preLexedTokens_.size() - 1)].token;
+}
+
+Token::Types Scanner::LookAheadType(std::size_t offset) const
+{
+    if (!preLexed_ || preLexedIndex_ == 0)
+        return Tokens::EndOfStream;
+
+    /* The block drain is logically a cache fill of the buffer, so the lookahead remains const (see PreLexSourceConcurrent) */
+    if (concurrentPreLex_ != nullptr)
+        const_cast<Scanner*>(this)->DrainPreLexedBlocks(preLexedIndex_ - 1 + offset);
+
+    /* Offset 0 denotes the active token (the last one served by "Next") */
+    auto activeIdx = std::min(preLexedIndex_, preLexedTypes_.size()) - 1;
+    return static_cast<Tokens>(preLexedTypes_[std::min(activeIdx + offset, preLexedTypes_.size() - 1)]);
+}
+
+bool Scanner::AdoptPreLexedRange(const Scanner& scanner, std::size_t firstTokenIndex, std::size_t lastTokenIndex, const SourceCodePtr& source)
+{
+    /* The adopted buffer must be complete; a still running background scan of the source scanner is finished first */
+    if (scanner.concurrentPreLex_ != nullptr)
+        const_cast<Scanner&>(scanner).FinishPreLexing();
+
+    if (!scanner.preLexed_ || firstTokenIndex > lastTokenIndex || lastTokenIndex >= scanner.preLexedTokens_.size())
+        return false;
+
+    /* Copy the token range and terminate it with a synthesized end-of-stream token */
+    std::vector<PreLexedToken> tokens;
+    tokens.reserve(lastTokenIndex - firstTokenIndex + 2);
+
+    tokens.insert(
+        tokens.end(),
+        scanner.preLexedTokens_.begin() + firstTokenIndex,
+        scanner.preLexedTokens_.begin() + lastTokenIndex + 1
+    );
+    tokens.push_back({ std::make_shared<Token>(tokens.back().token->Pos(), Tokens::EndOfStream), "" });
+
+    return AdoptPreLexedTokens(std::move(tokens), source);
+}
+
+bool Scanner::AdoptPreLexedVector(std::vector<TokenPtr>&& tokens, const SourceCodePtr& source)
+{
+    if (tokens.empty())
+        return false;
+
+    /* Wrap the tokens into buffer entries (commentaries are contained as tokens, not as attached strings) */
+    std::vector<PreLexedToken> entries;
+    entries.reserve(tokens.size());
+
+    for (auto& tkn : tokens)
+        entries.push_back({ std::move(tkn), "" });
+
+    return AdoptPreLexedTokens(std::move(entries), source);
+}
+
+std::size_t Scanner::ActiveTokenIndex() const
+{
+    return (preLexedIndex_ > 0 ? preLexedIndex_ - 1 : 0);
+}
+
+std::size_t Scanner::FindMatchingRCurlyIndex(std::size_t lCurlyIndex) const
+{
+    std::size_t depth = 0;
+
+    /* Match the braces on the dense type array; the token objects themselves are never touched */
+    const auto lCurly = static_cast<std::uint8_t>(Tokens::LCurly);
+    const auto rCurly = static_cast<std::uint8_t>(Tokens::RCurly);
+
+    for (auto i = lCurlyIndex; ; ++i)
+    {
+        /* Wait for the background scan to publish the next token (a cache fill of the buffer, see LookAhead) */
+        if (concurrentPreLex_ != nullptr)
+            const_cast<Scanner*>(this)->DrainPreLexedBlocks(i + 1);
+
+        if (i + 1 >= preLexedTypes_.size())
+            break;
+
+        auto type = preLexedTypes_[i];
+        if (type == lCurly)
+            ++depth;
+        else if (type == rCurly)
+        {
+            if (--depth == 0)
+                return i;
+        }
+    }
+
+    /* Unmatched: return the end-of-stream index */
+    return (preLexedTokens_.empty() ? 0 : preLexedTokens_.size() - 1);
+}
+
+void Scanner::ResumeTokenIndex(std::size_t tokenIndex)
+{
+    /* Wait for the background scan to publish the target token (see PreLexSourceConcurrent) */
+    if (concurrentPreLex_ != nullptr)
+        DrainPreLexedBlocks(tokenIndex);
+
+    if (preLexed_ && !preLexedTokens_.empty())
+        preLexedIndex_ = std::min(tokenIndex, preLexedTokens_.size() - 1);
+}
+
 void Scanner::PushTokenString(const TokenPtrString& tokenString)
 {
     tokenStringItStack_.push(tokenString.Begin());
@@ -45,6 +310,33 @@ void Scanner::PopTokenString()
     tokenStringItStack_.pop();
 }
 
+bool Scanner::AdoptPreLexedTokens(std::vector<PreLexedToken>&& tokens, const SourceCodePtr& source)
+{
+    if (preLexed_ || tokens.empty() || tokens.back().token->Type() != Tokens::EndOfStream)
+        return false;
+
+    /* Keep the source only for error line markers; no characters are scanned from it */
+    source_         = source;
+    preLexedTokens_ = std::move(tokens);
+
+    /* Mirror the token types in the dense type array (see FindMatchingRCurlyIndex) */
+    preLexedTypes_.clear();
+    preLexedTypes_.reserve(preLexedTokens_.size());
+
+    for (const auto& entry : preLexedTokens_)
+        preLexedTypes_.push_back(static_cast<std::uint8_t>(entry.token->Type()));
+
+    /* Reset token states, so that serving from the buffer starts like a fresh scan */
+    activeToken_.reset();
+    prevToken_.reset();
+    comment_.clear();
+
+    preLexedIndex_  = 0;
+    preLexed_       = true;
+
+    return true;
+}
+
 TokenPtrString::ConstIterator Scanner::TopTokenStringIterator() const
 {
     return (!tokenStringItStack_.empty() ? tokenStringItStack_.top() : TokenPtrString::ConstIterator());
@@ -60,6 +352,17 @@ TokenPtr Scanner::PreviousToken() const
     return prevToken_;
 }
 
+TokenPtr Scanner::SkipToNextDirective()
+{
+    /* Fall back to regular scanning when the tokens are not served from the raw source */
+    if (preLexed_ || !tokenStringItStack_.empty() || source_ == nullptr || chr_ == 0)
+        return Next();
+
+    /* Skip the raw source text up to the next potential directive line and re-enter regular scanning there */
+    chr_ = source_->NextAfterInactiveCode();
+    return Next();
+}
+
 
 /*
  * ======= Protected: =======
@@ -79,6 +382,27 @@ TokenPtr Scanner::NextToken(bool scanComments, bool scanWhiteSpaces)
         auto& tokenStringIt = tokenStringItStack_.top();
         tkn = *(tokenStringIt++);
     }
+    else if (preLexed_)
+    {
+        /* Wait for the background scan to publish the next token (see PreLexSourceConcurrent) */
+        if (concurrentPreLex_ != nullptr)
+            DrainPreLexedBlocks(preLexedIndex_);
+
+        /* Serve next token from the pre-lexed buffer, and restore comment and position states */
+        const auto& entry = preLexedTokens_[std::min(preLexedIndex_, preLexedTokens_.size() - 1)];
+
+        comment_        = entry.comment;
+        nextStartPos_   = entry.token->Pos();
+        tkn             = entry.token;
+
+        /* Stay on the end-of-stream token once it has been reached */
+        if (preLexedIndex_ < preLexedTokens_.size())
+            ++preLexedIndex_;
+
+        /* The end of the stream completes the background scan: join the producer and replay its reports */
+        if (concurrentPreLex_ != nullptr && tkn->Type() == Tokens::EndOfStream)
+            FinishPreLexing();
+    }
     else
     {
         /* Scan next token from token sub-scanner */
@@ -88,6 +412,13 @@ TokenPtr Scanner::NextToken(bool scanComments, bool scanWhiteSpaces)
     /* Store new active token */
     activeToken_ = tkn;
 
+    if (auto stats = ActiveCompileStats())
+        ++stats->numTokens;
+
+    /* Count the served token against the compile budgets (see ShaderInput::maxTokens) */
+    if (auto budget = ActiveCompileBudget())
+        budget->CountToken();
+
     return tkn;
 }
 
@@ -180,6 +511,9 @@ void Scanner::StoreStartPos()
 {
     /* Store current source position as start position for the next token */
     nextStartPos_ = source_->Pos();
+
+    /* Store buffer offset of the current character as token start offset (see MakeView) */
+    tokenStartOffset_ = source_->OffsetOfLastChar();
 }
 
 char Scanner::Take(char chr)
@@ -222,6 +556,23 @@ TokenPtr Scanner::Make(const Token::Types& type, std::string& spell, const Sourc
     return MakeShared<Token>(pos, type, std::move(spell));
 }
 
+TokenPtr Scanner::MakeView(const Token::Types& type, std::string& spell)
+{
+    if (source_ != nullptr && source_->HasPersistentBuffer())
+    {
+        /* Verify that the buffer maps the spelling verbatim at the token start offset (e.g. not across a line boundary) */
+        const auto buffer = source_->Buffer();
+
+        if ( tokenStartOffset_ < source_->BufferSize()                                      &&
+             spell.size()      <= source_->BufferSize() - tokenStartOffset_                 &&
+             std::memcmp(buffer + tokenStartOffset_, spell.data(), spell.size()) == 0 )
+        {
+            return MakeShared<Token>(Pos(), type, buffer + tokenStartOffset_, spell.size());
+        }
+    }
+    return MakeShared<Token>(Pos(), type, std::move(spell));
+}
+
 /* ----- Report Handling ----- */
 
 [[noreturn]]
@@ -255,7 +606,10 @@ void Scanner::Ignore(const std::function<bool(char)>& pred)
 void Scanner::IgnoreWhiteSpaces(bool includeNewLines)
 {
     while ( std::isspace(UChr()) && ( includeNewLines || !IsNewLine() ) )
-        TakeIt();
+    {
+        /* Skip the subsequent white-space run with the bulk kernel of the source code */
+        chr_ = source_->NextAfterWhiteSpaces();
+    }
 }
 
 TokenPtr Scanner::ScanWhiteSpaces(bool includeNewLines)
@@ -274,7 +628,10 @@ TokenPtr Scanner::ScanWhiteSpaces(bool includeNewLines)
 
     /* Scan other white spaces */
     while ( std::isspace(UChr()) && ( includeNewLines || !IsNewLine() ) )
-        spell += TakeIt();
+    {
+        spell += chr_;
+        chr_ = source_->NextAfterWhiteSpaces(&spell);
+    }
 
     return Make(Tokens::WhiteSpaces, spell);
 }
@@ -286,7 +643,10 @@ TokenPtr Scanner::ScanCommentLine(bool scanComments)
     TakeIt(); // Ignore second '/' from commentary line beginning
 
     while (!Is('\n'))
-        spell += TakeIt();
+    {
+        spell += chr_;
+        chr_ = source_->NextAfterCommentLineTail(spell);
+    }
 
     /* Store commentary string */
     AppendComment(spell);
@@ -321,7 +681,10 @@ TokenPtr Scanner::ScanCommentBlock(bool scanComments)
                 spell += '*';
         }
         else
-            spell += TakeIt();
+        {
+            spell += chr_;
+            chr_ = source_->NextAfterCommentBlockTail(spell);
+        }
     }
 
     /* Store commentary string */
@@ -347,7 +710,7 @@ TokenPtr Scanner::ScanStringLiteral()
     
     spell += Take('\"');
 
-    return Make(Tokens::StringLiteral, spell);
+    return MakeView(Tokens::StringLiteral, spell);
 }
 
 // see https://msdn.microsoft.com/de-de/library/windows/desktop/bb509567(v=vs.85).aspx
@@ -418,7 +781,7 @@ TokenPtr Scanner::ScanNumber(bool startWithDot)
     }
 
     /* Create number token */
-    return Make(type, spell);
+    return MakeView(type, spell);
 }
 
 TokenPtr Scanner::ScanNumberOrDot()
@@ -447,16 +810,120 @@ bool Scanner::ScanDigitSequence(std::string& spell)
     bool result = (std::isdigit(UChr()) != 0);
 
     while (std::isdigit(UChr()))
-        spell += TakeIt();
+    {
+        spell += chr_;
+        chr_ = source_->NextAfterDigitTail(spell);
+    }
 
     return result;
 }
 
+void Scanner::ScanIdentifierTail(std::string& spell)
+{
+    while ( std::isalnum(UChr()) || Is('_') )
+    {
+        spell += chr_;
+        chr_ = source_->NextAfterIdentifierTail(spell);
+    }
+}
+
 
 /*
  * ======= Private: =======
  */
 
+void Scanner::ConcurrentPreLexProducer(ConcurrentPreLexState& state)
+{
+    auto& producer = *state.producer;
+
+    std::vector<PreLexedToken> block;
+    block.reserve(ConcurrentPreLexState::blockSize);
+
+    /* Publishes the accumulated block into the next free ring slot; returns false when the consumer aborted the scan */
+    auto PublishBlock = [&state, &block]() -> bool
+    {
+        const auto tail = state.tail.load(std::memory_order_relaxed);
+
+        /* Wait until a ring slot is free (this bounds how far the producer runs ahead) */
+        while (tail - state.head.load(std::memory_order_acquire) >= ConcurrentPreLexState::ringSize)
+        {
+            if (state.stop.load(std::memory_order_relaxed))
+                return false;
+            std::this_thread::yield();
+        }
+
+        state.blocks[tail % ConcurrentPreLexState::ringSize] = std::move(block);
+        state.tail.store(tail + 1, std::memory_order_release);
+
+        block.clear();
+        block.reserve(ConcurrentPreLexState::blockSize);
+
+        return true;
+    };
+
+    try
+    {
+        while (!state.stop.load(std::memory_order_relaxed))
+        {
+            auto tkn = producer.Next();
+            if (!tkn)
+                break;
+
+            block.push_back({ tkn, producer.GetComment() });
+
+            const auto endOfStream = (tkn->Type() == Tokens::EndOfStream);
+
+            if (endOfStream || block.size() >= ConcurrentPreLexState::blockSize)
+            {
+                if (!PublishBlock() || endOfStream)
+                    break;
+            }
+        }
+    }
+    catch (...)
+    {
+        /* Unexpected producer failure (e.g. out of memory): terminate the stream, the consumer appends the end-of-stream token */
+    }
+
+    if (!block.empty())
+        PublishBlock();
+
+    state.done.store(true, std::memory_order_release);
+}
+
+void Scanner::DrainPreLexedBlocks(std::size_t tokenIndex)
+{
+    auto& state = *concurrentPreLex_;
+
+    while (preLexedTokens_.size() <= tokenIndex)
+    {
+        const auto head = state.head.load(std::memory_order_relaxed);
+
+        if (head != state.tail.load(std::memory_order_acquire))
+        {
+            /* Append the published block to the contiguous buffer (only this thread touches the buffer) */
+            auto& block = state.blocks[head % ConcurrentPreLexState::ringSize];
+
+            for (auto& entry : block)
+            {
+                preLexedTypes_.push_back(static_cast<std::uint8_t>(entry.token->Type()));
+                preLexedTokens_.push_back(std::move(entry));
+            }
+
+            block.clear();
+            state.head.store(head + 1, std::memory_order_release);
+        }
+        else if (state.done.load(std::memory_order_acquire))
+        {
+            /* Re-check the ring once more: the final block may have been published just before the done flag */
+            if (head == state.tail.load(std::memory_order_acquire))
+                break;
+        }
+        else
+            std::this_thread::yield();
+    }
+}
+
 void Scanner::AppendComment(const std::string& s)
 {
     if (commentFirstLine_)
@@ -17,7 +17,11 @@
 #include "TokenString.h"
 
 #include <string>
+#include <vector>
+#include <stack>
 #include <functional>
+#include <memory>
+#include <cstdint>
 
 
 namespace Xsc
@@ -36,6 +40,70 @@ class Scanner
         // Starts scanning the specified source code.
         bool ScanSource(const SourceCodePtr& source);
 
+        /*
+        Scans the entire source up front into a contiguous token buffer,
+        so that "Next" serves the tokens by index and arbitrary lookahead becomes index arithmetic (see LookAhead).
+        */
+        bool PreLexSource();
+
+        /*
+        Like "PreLexSource", but the scanning runs on a second thread while this scanner already serves the
+        tokens: the specified producer scanner (which must have started scanning the source) fills a lock-free
+        single-producer/single-consumer ring of token blocks, and this scanner appends the published blocks to
+        the contiguous token buffer on demand, so character classification overlaps with AST construction.
+        Lexical reports of the producer thread are captured and replayed when the scan completes; consumers
+        that read the source text (e.g. error line markers) must call "FinishPreLexing" first.
+        */
+        bool PreLexSourceConcurrent(const std::shared_ptr<Scanner>& producerScanner);
+
+        // Runs a background scan to completion (see PreLexSourceConcurrent); no-op when none is in flight.
+        void FinishPreLexing();
+
+        // Returns the pre-lexed token N positions ahead of the active token, or null if pre-lexing is disabled (see PreLexSource).
+        TokenPtr LookAhead(std::size_t offset) const;
+
+        /*
+        Returns the type of the pre-lexed token N positions ahead of the active token, reading only the dense
+        type array instead of dereferencing the token objects (see LookAhead); offset 0 denotes the active token.
+        Returns the end-of-stream type if pre-lexing is disabled.
+        */
+        Token::Types LookAheadType(std::size_t offset) const;
+
+        /*
+        Adopts the specified token string (e.g. the pre-processor output) as the pre-lexed token buffer,
+        so the tokens do not have to be serialized to text and re-scanned. The optional source is only
+        kept for error line markers. The base scanner cannot classify foreign tokens and always returns
+        false; see HLSLScanner for an implementation.
+        */
+        virtual bool PreLexTokenString(const TokenPtrString& tokenString, const SourceCodePtr& source);
+
+        /*
+        Adopts the token range [firstTokenIndex, lastTokenIndex] of the pre-lexed token buffer of the specified
+        scanner, terminated by a synthesized end-of-stream token (e.g. to re-parse a bracketed function body).
+        */
+        bool AdoptPreLexedRange(const Scanner& scanner, std::size_t firstTokenIndex, std::size_t lastTokenIndex, const SourceCodePtr& source);
+
+        /*
+        Adopts the specified tokens (terminated by the end-of-stream token) as the pre-lexed token buffer,
+        e.g. from a precompiled header module (see TokenModule). The optional source is only kept for error line markers.
+        */
+        bool AdoptPreLexedVector(std::vector<TokenPtr>&& tokens, const SourceCodePtr& source);
+
+        // Returns the pre-lexed token buffer index of the active token (see ActiveToken); only valid in pre-lexed mode.
+        std::size_t ActiveTokenIndex() const;
+
+        // Returns the buffer index of the '}' token that matches the '{' token at the specified buffer index, or the end-of-stream index if unmatched.
+        std::size_t FindMatchingRCurlyIndex(std::size_t lCurlyIndex) const;
+
+        // Continues serving tokens at the specified pre-lexed token buffer index (e.g. to skip a bracketed function body).
+        void ResumeTokenIndex(std::size_t tokenIndex);
+
+        // Returns true if the tokens are served from the pre-lexed buffer and no token string is in flight, i.e. "ResumeTokenIndex" can rewind (see Parser::MakeCheckpoint).
+        inline bool CanResumeTokenIndex() const
+        {
+            return (preLexed_ && tokenStringItStack_.empty());
+        }
+
         // Pushes the specified token string onto the stack where further tokens will be parsed from the top of the stack.
         void PushTokenString(const TokenPtrString& tokenString);
         void PopTokenString();
@@ -46,6 +114,14 @@ class Scanner
         // Scanes the source code for the next token
         virtual TokenPtr Next() = 0;
 
+        /*
+        Skips the raw source text up to the next potential directive line without constructing tokens for
+        the skipped characters (see SourceCode::NextAfterInactiveCode), and returns the token scanned there
+        (i.e. a directive or the end-of-stream token). Falls back to "Next" when the tokens are not served
+        from the raw source (i.e. in the pre-lexed mode or while a token string is on the stack).
+        */
+        TokenPtr SkipToNextDirective();
+
         // Returns the token previously returned by the "Next" function.
         TokenPtr ActiveToken() const;
 
@@ -76,14 +152,31 @@ class Scanner
             return comment_;
         }
 
+        // Returns the report log of this scanner.
+        inline Log* GetLog() const
+        {
+            return log_;
+        }
+
     protected:
-        
+
         using Tokens = Token::Types;
 
+        /* === Structures === */
+
+        struct PreLexedToken
+        {
+            TokenPtr    token;
+            std::string comment;    //< commentary string in front of this token
+        };
+
         /* === Functions === */
 
         TokenPtr NextToken(bool scanComments, bool scanWhiteSpaces);
 
+        // Adopts the specified tokens as the pre-lexed token buffer; the last token must be the end-of-stream token.
+        bool AdoptPreLexedTokens(std::vector<PreLexedToken>&& tokens, const SourceCodePtr& source);
+
         void StoreStartPos();
 
         virtual TokenPtr ScanToken() = 0;
@@ -95,6 +188,13 @@ class Scanner
         TokenPtr Make(const Token::Types& type, std::string& spell, bool takeChr = false);
         TokenPtr Make(const Token::Types& type, std::string& spell, const SourcePosition& pos, bool takeChr = false);
 
+        /*
+        Makes a new token whose spelling is stored as view into the source buffer instead of an owned copy
+        (see Token::Spell), if the buffer is persistent (see SourceCode::MarkPersistentBuffer) and maps the
+        spelling verbatim at the stored token start offset; falls back to "Make" otherwise.
+        */
+        TokenPtr MakeView(const Token::Types& type, std::string& spell);
+
         /* ----- Report Handling ----- */
 
         [[noreturn]]
@@ -122,6 +222,9 @@ class Scanner
 
         bool        ScanDigitSequence(std::string& spell);
 
+        // Scans the identifier tail (i.e. alphanumeric and '_' characters) and appends it to the specified spelling.
+        void        ScanIdentifierTail(std::string& spell);
+
         /* ----- Helper functions ----- */
 
         // Returns true if the next character is a new-line character (i.e. '\n' or '\r').
@@ -150,6 +253,11 @@ class Scanner
 
     private:
 
+        /* === Structures === */
+
+        // Shared state of a background scan: the token block ring and the producer thread (see PreLexSourceConcurrent).
+        struct ConcurrentPreLexState;
+
         /* === Functions === */
 
         TokenPtr NextTokenScan(bool scanComments, bool scanWhiteSpaces);
@@ -157,6 +265,12 @@ class Scanner
         void AppendComment(const std::string& s);
         void AppendMultiLineComment(const std::string& s);
 
+        // Producer loop of the background scan; runs on the worker thread and only touches the shared state.
+        static void ConcurrentPreLexProducer(ConcurrentPreLexState& state);
+
+        // Appends published token blocks to the pre-lexed buffer until it covers the specified index (or the scan is complete).
+        void DrainPreLexedBlocks(std::size_t tokenIndex);
+
         /* === Members === */
 
         SourceCodePtr                               source_;
@@ -165,11 +279,25 @@ class Scanner
         Log*                                        log_                = nullptr;
 
         SourcePosition                              nextStartPos_;
+        std::size_t                                 tokenStartOffset_   = 0;
         TokenPtr                                    activeToken_;
         TokenPtr                                    prevToken_;
 
         std::stack<TokenPtrString::ConstIterator>   tokenStringItStack_;
 
+        /*
+        Contiguous token buffer for the pre-lexed mode (see PreLexSource). The token types are mirrored
+        in a parallel byte array, so type-driven scans (e.g. FindMatchingRCurlyIndex, LookAheadType)
+        touch one dense cache line per 64 tokens instead of dereferencing each token object.
+        */
+        std::vector<PreLexedToken>                  preLexedTokens_;
+        std::vector<std::uint8_t>                   preLexedTypes_;
+        std::size_t                                 preLexedIndex_      = 0;
+        bool                                        preLexed_           = false;
+
+        // State of the background scan, or null when the tokens are complete (see PreLexSourceConcurrent).
+        std::unique_ptr<ConcurrentPreLexState>      concurrentPreLex_;
+
         // Active commentary string (in front of the next token).
         std::string                                 comment_;
         unsigned int                                commentStartPos_    = 0;
@@ -0,0 +1,131 @@
+/*
+ * TokenModule.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TokenModule.h"
+#include "Helper.h"
+#include <cstring>
+#include <cstdint>
+
+
+namespace Xsc
+{
+
+
+/*
+ * Internal members
+ */
+
+static const std::uint32_t tokenModuleMagic_    = 0x4d545358; // "XSTM"
+static const std::uint32_t tokenModuleVersion_  = 1;
+
+
+/*
+ * Internal functions
+ */
+
+template <typename T>
+static void WriteValue(std::ostream& stream, const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+static bool ReadValue(const char*& data, const char* dataEnd, T& value)
+{
+    if (static_cast<std::size_t>(dataEnd - data) < sizeof(value))
+        return false;
+
+    std::memcpy(&value, data, sizeof(value));
+    data += sizeof(value);
+
+    return true;
+}
+
+
+/*
+ * TokenModule class
+ */
+
+bool TokenModule::Write(const std::vector<TokenPtr>& tokens, std::ostream& stream)
+{
+    if (tokens.empty() || tokens.back()->Type() != Token::Types::EndOfStream)
+        return false;
+
+    WriteValue(stream, tokenModuleMagic_);
+    WriteValue(stream, tokenModuleVersion_);
+    WriteValue(stream, static_cast<std::uint32_t>(tokens.size()));
+
+    for (const auto& tkn : tokens)
+    {
+        WriteValue(stream, static_cast<std::uint8_t>(tkn->Type()));
+        WriteValue(stream, static_cast<std::uint32_t>(tkn->Pos().Row()));
+        WriteValue(stream, static_cast<std::uint32_t>(tkn->Pos().Column()));
+        WriteValue(stream, static_cast<std::uint32_t>(tkn->Spell().size()));
+        stream.write(tkn->Spell().data(), static_cast<std::streamsize>(tkn->Spell().size()));
+    }
+
+    return stream.good();
+}
+
+std::vector<TokenPtr> TokenModule::Read(const char* data, std::size_t size, const std::string& filename)
+{
+    std::vector<TokenPtr> tokens;
+
+    auto dataEnd = data + size;
+
+    /* Read and validate module header */
+    std::uint32_t magic = 0, version = 0, numTokens = 0;
+
+    if ( !ReadValue(data, dataEnd, magic    ) || magic   != tokenModuleMagic_   ||
+         !ReadValue(data, dataEnd, version  ) || version != tokenModuleVersion_ ||
+         !ReadValue(data, dataEnd, numTokens) || numTokens == 0 )
+    {
+        return tokens;
+    }
+
+    /* All tokens of the module share one source origin (only used for error line markers) */
+    auto origin = SourceOrigin::Intern(filename, 0);
+
+    tokens.reserve(numTokens);
+
+    for (std::uint32_t i = 0; i < numTokens; ++i)
+    {
+        std::uint8_t    type        = 0;
+        std::uint32_t   row         = 0,
+                        column      = 0,
+                        spellSize   = 0;
+
+        if ( !ReadValue(data, dataEnd, type) || type > static_cast<std::uint8_t>(Token::Types::EndOfStream) ||
+             !ReadValue(data, dataEnd, row) ||
+             !ReadValue(data, dataEnd, column) ||
+             !ReadValue(data, dataEnd, spellSize) ||
+             static_cast<std::size_t>(dataEnd - data) < spellSize )
+        {
+            /* Malformed module: discard everything */
+            tokens.clear();
+            return tokens;
+        }
+
+        SourcePosition pos(row, column, origin);
+
+        tokens.push_back(MakeShared<Token>(pos, static_cast<Token::Types>(type), std::string(data, spellSize)));
+        data += spellSize;
+    }
+
+    /* The module must end with the end-of-stream token (see AdoptPreLexedTokens) */
+    if (tokens.back()->Type() != Token::Types::EndOfStream)
+        tokens.clear();
+
+    return tokens;
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
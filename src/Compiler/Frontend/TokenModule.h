@@ -0,0 +1,54 @@
+/*
+ * TokenModule.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_TOKEN_MODULE_H
+#define XSC_TOKEN_MODULE_H
+
+
+#include "Token.h"
+
+#include <ostream>
+#include <vector>
+#include <string>
+
+
+namespace Xsc
+{
+
+
+/*
+Binary reader/writer for pre-lexed token streams, used for precompiled header modules (see PrecompileHeader).
+The format is an internal build artifact: it is not portable across library versions or byte orders.
+*/
+class TokenModule
+{
+
+    public:
+
+        TokenModule() = delete;
+
+        // Writes the specified token stream (terminated by the end-of-stream token) as a binary module; returns false on stream failure.
+        static bool Write(const std::vector<TokenPtr>& tokens, std::ostream& stream);
+
+        /*
+        Reads a binary token module from the specified memory buffer, constructing the tokens with the
+        active memory pool (if any); the filename is attached as source origin for error line markers.
+        Returns an empty vector if the module is malformed.
+        */
+        static std::vector<TokenPtr> Read(const char* data, std::size_t size, const std::string& filename);
+
+};
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
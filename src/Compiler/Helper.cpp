@@ -7,12 +7,177 @@
 
 #include "Helper.h"
 #include <algorithm>
+#include <cstdlib>
 
 
 namespace Xsc
 {
 
 
+/*
+ * Internal functions
+ */
+
+// Parses an optional sign and a decimal or hexadecimal ("0x"/"0X" prefixed) digit sequence; stops at the first foreign character.
+static unsigned long long ParseIntLiteral(const std::string& s, bool& negative)
+{
+    std::size_t i = 0;
+
+    negative = false;
+    if (i < s.size() && (s[i] == '+' || s[i] == '-'))
+        negative = (s[i++] == '-');
+
+    unsigned long long value = 0;
+
+    if (i + 1 < s.size() && s[i] == '0' && (s[i + 1] == 'x' || s[i + 1] == 'X'))
+    {
+        /* Parse hexadecimal digit sequence */
+        for (i += 2; i < s.size(); ++i)
+        {
+            auto c = s[i];
+            if (c >= '0' && c <= '9')
+                value = value * 16u + static_cast<unsigned long long>(c - '0');
+            else if (c >= 'a' && c <= 'f')
+                value = value * 16u + static_cast<unsigned long long>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F')
+                value = value * 16u + static_cast<unsigned long long>(c - 'A' + 10);
+            else
+                break;
+        }
+    }
+    else
+    {
+        /* Parse decimal digit sequence */
+        for (; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i)
+            value = value * 10u + static_cast<unsigned long long>(s[i] - '0');
+    }
+
+    return value;
+}
+
+/*
+Parses a decimal floating-point literal. When the significand fits exactly into the 53 mantissa bits
+and the decimal exponent is covered by an exactly representable power of ten, a single multiplication
+or division yields the correctly rounded result; otherwise the conversion falls back to "strtod",
+so the result is always identical to the stream-based conversion.
+*/
+static double ParseRealLiteral(const std::string& s)
+{
+    /* Exactly representable powers of ten (10^22 is the largest one) */
+    static const double pow10[] =
+    {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10,
+        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    std::size_t i = 0;
+
+    auto negative = false;
+    if (i < s.size() && (s[i] == '+' || s[i] == '-'))
+        negative = (s[i++] == '-');
+
+    /* Accumulate the significand; bail out to "strtod" when it no longer fits into 64 bits */
+    unsigned long long mantissa = 0;
+    int exponent = 0;
+
+    for (; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i)
+    {
+        if (mantissa > (~0ull - 9u) / 10u)
+            return std::strtod(s.c_str(), nullptr);
+        mantissa = mantissa * 10u + static_cast<unsigned long long>(s[i] - '0');
+    }
+
+    if (i < s.size() && s[i] == '.')
+    {
+        for (++i; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i)
+        {
+            if (mantissa > (~0ull - 9u) / 10u)
+                return std::strtod(s.c_str(), nullptr);
+            mantissa = mantissa * 10u + static_cast<unsigned long long>(s[i] - '0');
+            --exponent;
+        }
+    }
+
+    if (i < s.size() && (s[i] == 'e' || s[i] == 'E'))
+    {
+        ++i;
+        auto expNegative = false;
+        if (i < s.size() && (s[i] == '+' || s[i] == '-'))
+            expNegative = (s[i++] == '-');
+
+        int expValue = 0;
+        for (; i < s.size() && s[i] >= '0' && s[i] <= '9' && expValue < 1000; ++i)
+            expValue = expValue * 10 + (s[i] - '0');
+
+        exponent += (expNegative ? -expValue : expValue);
+    }
+
+    /* Fast path: exact significand scaled by an exact power of ten is correctly rounded */
+    if (mantissa < (1ull << 53) && exponent >= -22 && exponent <= 22)
+    {
+        auto value = static_cast<double>(mantissa);
+        if (exponent > 0)
+            value *= pow10[exponent];
+        else if (exponent < 0)
+            value /= pow10[-exponent];
+        return (negative ? -value : value);
+    }
+
+    return std::strtod(s.c_str(), nullptr);
+}
+
+
+/*
+ * Global functions
+ */
+
+template <> long long FromString<long long>(const std::string& s)
+{
+    bool negative = false;
+    auto value = ParseIntLiteral(s, negative);
+    return (negative ? -static_cast<long long>(value) : static_cast<long long>(value));
+}
+
+template <> unsigned int FromString<unsigned int>(const std::string& s)
+{
+    bool negative = false;
+    auto value = static_cast<unsigned int>(ParseIntLiteral(s, negative));
+    return (negative ? 0u - value : value);
+}
+
+template <> int FromString<int>(const std::string& s)
+{
+    return static_cast<int>(FromString<long long>(s));
+}
+
+template <> float FromString<float>(const std::string& s)
+{
+    return static_cast<float>(ParseRealLiteral(s));
+}
+
+template <> double FromString<double>(const std::string& s)
+{
+    return ParseRealLiteral(s);
+}
+
+std::uint64_t HashData(const char* data, std::size_t size)
+{
+    /* 64-bit FNV-1a offset basis */
+    return HashData(data, size, 14695981039346656037ull);
+}
+
+std::uint64_t HashData(const char* data, std::size_t size, std::uint64_t hash)
+{
+    /* 64-bit FNV-1a */
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= static_cast<std::uint64_t>(static_cast<unsigned char>(data[i]));
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
 std::string ToLower(const std::string& s)
 {
     std::string t;
@@ -9,12 +9,16 @@
 #define XSC_HELPER_H
 
 
+#include "MemoryPool.h"
+#include "CompileStats.h"
+
 #include <string>
 #include <sstream>
 #include <cmath>
 #include <type_traits>
 #include <memory>
 #include <algorithm>
+#include <cstdint>
 
 
 namespace Xsc
@@ -31,8 +35,12 @@ std::unique_ptr<T> MakeUnique(Args&&... args)
 template <typename T, typename... Args>
 std::shared_ptr<T> MakeShared(Args&&... args)
 {
-    #ifdef XSC_ENABLE_MEMORY_POOL
-    return std::shared_ptr<T>(new T(std::forward<Args>(args)...));
+    #if defined XSC_ENABLE_MEMORY_POOL
+    /* Fuse object and shared_ptr control block into a single pool allocation */
+    return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+    #elif defined XSC_ENABLE_ALLOC_TRACKING
+    /* Without the memory pool, count the AST and token allocations individually */
+    return std::allocate_shared<T>(TrackingAllocator<T>(), std::forward<Args>(args)...);
     #else
     return std::make_shared<T>(std::forward<Args>(args)...);
     #endif
@@ -49,6 +57,18 @@ T FromString(const std::string& s)
     return value;
 }
 
+/*
+Fast specializations for the literal-decoding hot path: decimal and hexadecimal integers and
+decimal floating-point numbers are converted directly, without the locale and stream-state overhead
+of the generic conversion. Like the stream extraction, the conversion stops at the first character
+that does not belong to the number, so trailing type suffixes (e.g. "1.5f", "0u") are ignored.
+*/
+template <> long long FromString<long long>(const std::string& s);
+template <> unsigned int FromString<unsigned int>(const std::string& s);
+template <> int FromString<int>(const std::string& s);
+template <> float FromString<float>(const std::string& s);
+template <> double FromString<double>(const std::string& s);
+
 // Removes all entries from the specified container which are equal to the specified type.
 template <typename Cont, typename Value>
 void EraseAll(Cont& container, Value value)
@@ -69,6 +89,12 @@ void EraseAllIf(Cont& container, Pred pred)
     );
 }
 
+// Computes a 64-bit FNV-1a content hash for the specified data.
+std::uint64_t HashData(const char* data, std::size_t size);
+
+// Computes a 64-bit FNV-1a content hash for the specified data, chained onto the specified previous hash value.
+std::uint64_t HashData(const char* data, std::size_t size, std::uint64_t hash);
+
 // Converts the specified strin to lower case.
 std::string ToLower(const std::string& s);
 
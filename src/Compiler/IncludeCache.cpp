@@ -0,0 +1,531 @@
+/*
+ * IncludeCache.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "IncludeCache.h"
+#include "DirectoryListing.h"
+#include "Helper.h"
+
+#include <fstream>
+#include <iterator>
+#include <cstring>
+#include <thread>
+#include <condition_variable>
+#include <deque>
+#include <set>
+
+
+namespace Xsc
+{
+
+
+/* ----- Include prefetching ----- */
+
+// Include directive candidate found by the directive-only scan (see ScanIncludeCandidates).
+struct IncludeCandidate
+{
+    std::string filename;
+    bool        useSearchPathsFirst;    // true for the '<...>' directive form (see IncludeHandler::Include)
+};
+
+// Job for the background prefetch worker: the include candidates of one source, with its search paths.
+struct PrefetchJob
+{
+    std::vector<IncludeCandidate>   candidates;
+    std::vector<std::string>        searchPaths;
+};
+
+/*
+Scans the source for include directives without running the preprocessor: per line, optional white
+spaces, '#', optional white spaces, "include", and a quoted or angle-bracketed filename. Directives
+inside comment blocks or excluded conditional branches are accepted as false candidates (see Prefetch).
+*/
+static void ScanIncludeCandidates(const char* data, std::size_t size, std::vector<IncludeCandidate>& candidates)
+{
+    for (std::size_t i = 0; i < size;)
+    {
+        /* Skip white spaces at the line start */
+        while (i < size && ( data[i] == ' ' || data[i] == '\t' || data[i] == '\r' ))
+            ++i;
+
+        if (i < size && data[i] == '#')
+        {
+            ++i;
+            while (i < size && ( data[i] == ' ' || data[i] == '\t' ))
+                ++i;
+
+            if (i + 7 <= size && std::memcmp(data + i, "include", 7) == 0)
+            {
+                i += 7;
+                while (i < size && ( data[i] == ' ' || data[i] == '\t' ))
+                    ++i;
+
+                if (i < size && ( data[i] == '\"' || data[i] == '<' ))
+                {
+                    const auto useSearchPathsFirst  = (data[i] == '<');
+                    const auto closeChr             = (useSearchPathsFirst ? '>' : '\"');
+                    ++i;
+
+                    std::string filename;
+                    while (i < size && data[i] != closeChr && data[i] != '\n')
+                        filename += data[i++];
+
+                    if (i < size && data[i] == closeChr && !filename.empty())
+                        candidates.push_back({ std::move(filename), useSearchPathsFirst });
+                }
+            }
+        }
+
+        /* Advance to the next line */
+        auto newLine = (i < size ? reinterpret_cast<const char*>(std::memchr(data + i, '\n', size - i)) : nullptr);
+        i = (newLine != nullptr ? static_cast<std::size_t>(newLine - data) + 1 : size);
+    }
+}
+
+// Background worker that loads prefetch jobs into the include cache (see IncludeCache::Prefetch).
+class IncludePrefetcher
+{
+
+    public:
+
+        static IncludePrefetcher& Instance()
+        {
+            /* Leaky singleton, so the detached worker thread never races against static destruction */
+            static auto instance = new IncludePrefetcher();
+            return *instance;
+        }
+
+        // Enqueues the specified job and starts the worker thread on first use.
+        void Enqueue(PrefetchJob&& job)
+        {
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                jobs_.push_back(std::move(job));
+
+                if (!workerStarted_)
+                {
+                    std::thread(&IncludePrefetcher::RunWorker, this).detach();
+                    workerStarted_ = true;
+                }
+            }
+            condVar_.notify_one();
+        }
+
+    private:
+
+        IncludePrefetcher() = default;
+
+        void RunWorker()
+        {
+            for (;;)
+            {
+                PrefetchJob job;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    condVar_.wait(lock, [this]() { return !jobs_.empty(); });
+                    job = std::move(jobs_.front());
+                    jobs_.pop_front();
+                }
+                ProcessJob(job);
+            }
+        }
+
+        void ProcessJob(const PrefetchJob& job)
+        {
+            /* Load the include closure breadth-first (the visited set bounds cyclic includes) */
+            std::set<std::string>        visited;
+            std::deque<IncludeCandidate> pending(job.candidates.begin(), job.candidates.end());
+
+            while (!pending.empty())
+            {
+                auto candidate = std::move(pending.front());
+                pending.pop_front();
+
+                if (!visited.insert(candidate.filename).second)
+                    continue;
+
+                if (auto content = IncludeCache::Instance().Resolve(candidate.filename, candidate.useSearchPathsFirst, job.searchPaths))
+                {
+                    /* Scan the loaded content for nested include directives */
+                    std::vector<IncludeCandidate> nested;
+                    ScanIncludeCandidates(content->data(), content->size(), nested);
+
+                    for (auto& nestedCandidate : nested)
+                        pending.push_back(std::move(nestedCandidate));
+                }
+            }
+        }
+
+        std::mutex              mutex_;
+        std::condition_variable condVar_;
+        std::deque<PrefetchJob> jobs_;
+        bool                    workerStarted_ = false;
+
+};
+
+
+/*
+ * IncludeCache class
+ */
+
+// Eviction priority of the include file cache: refilling only costs a file read, so these entries are drained first (see CacheRegistry).
+static const int includeCacheEvictionPriority_ = 0;
+
+// Returns the approximate memory footprint of one cached file (path and content plus container overhead).
+static std::size_t IncludeEntryBytes(const std::string& path, const std::string& content)
+{
+    return (sizeof(std::string) * 2 + path.size() + content.size());
+}
+
+IncludeCache::IncludeCache()
+{
+    CacheRegistry::Instance().Register(*this, includeCacheEvictionPriority_);
+}
+
+IncludeCache& IncludeCache::Instance()
+{
+    /* Leaky singleton, so the background prefetch worker never races against static destruction (see IncludePrefetcher) */
+    static auto instance = new IncludeCache();
+    return *instance;
+}
+
+// Reads the entire file content, or returns null if the file cannot be read.
+static std::shared_ptr<const std::string> LoadFileContent(const std::string& path)
+{
+    /* Try to memory map the file first, to read it with a single copy */
+    FileMapping mapping(path);
+    if (mapping.IsValid())
+        return std::make_shared<const std::string>(mapping.Data(), mapping.Size());
+
+    /* Fall back to standard file stream (e.g. for empty or non-regular files) */
+    std::ifstream stream(path);
+    if (!stream.good())
+        return nullptr;
+
+    return std::make_shared<const std::string>(
+        std::istreambuf_iterator<char>(stream),
+        std::istreambuf_iterator<char>()
+    );
+}
+
+std::shared_ptr<const std::string> IncludeCache::FetchOrLoad(const std::string& path)
+{
+    auto& registry = CacheRegistry::Instance();
+
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+
+        /* Consult the virtual file overlay first, so in-memory buffers shadow files on disk */
+        auto itVirtual = virtualFiles_.find(path);
+        if (itVirtual != virtualFiles_.end())
+            return itVirtual->second;
+
+        auto it = files_.find(path);
+        if (it != files_.end())
+        {
+            it->second.lastAccess = registry.NextAccessTick();
+            return it->second.content;
+        }
+    }
+
+    /* Settle a pending eviction debt before growing the cache (safe from any thread, since this cache synchronizes itself) */
+    registry.SettleEvictionDebt(*this);
+
+    /* Load file outside the lock, so slow reads do not stall concurrent compiles */
+    auto content = LoadFileContent(path);
+
+    if (content)
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+
+        auto it = files_.find(path);
+        if (it == files_.end())
+        {
+            files_[path] = { content, registry.NextAccessTick() };
+            registry.AddEntry(*this, IncludeEntryBytes(path, *content));
+        }
+    }
+
+    return content;
+}
+
+// Splits the specified path into its directory part (empty for plain filenames) and its entry name.
+static void SplitPath(const std::string& path, std::string& directory, std::string& entryName)
+{
+    auto pos = path.find_last_of("/\\");
+    if (pos == std::string::npos)
+    {
+        directory.clear();
+        entryName = path;
+    }
+    else
+    {
+        directory = (pos == 0 ? path.substr(0, 1) : path.substr(0, pos));
+        entryName = path.substr(pos + 1);
+    }
+}
+
+// Builds the resolution cache key over the include name, the directive form, and the search path list.
+static std::string ResolutionKey(const std::string& filename, bool useSearchPathsFirst, const std::vector<std::string>& searchPaths)
+{
+    /* Filenames cannot contain new-line characters, so they make an unambiguous separator */
+    std::string key = (useSearchPathsFirst ? "<" : "\"");
+    key += filename;
+
+    for (const auto& path : searchPaths)
+    {
+        key += '\n';
+        key += path;
+    }
+
+    return key;
+}
+
+std::shared_ptr<const std::string> IncludeCache::Resolve(
+    const std::string& filename, bool useSearchPathsFirst, const std::vector<std::string>& searchPaths)
+{
+    const auto key = ResolutionKey(filename, useSearchPathsFirst, searchPaths);
+
+    /* Consult the resolution cache first, so repeated includes skip the search path walk entirely */
+    std::string resolvedPath;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        auto it = resolutions_.find(key);
+        if (it != resolutions_.end())
+            resolvedPath = it->second;
+    }
+
+    if (!resolvedPath.empty())
+    {
+        if (auto content = FetchOrLoad(resolvedPath))
+            return content;
+
+        /* The resolved file vanished -> drop the stale entry and walk the search paths again */
+        std::lock_guard<std::mutex> guard(mutex_);
+        resolutions_.erase(key);
+    }
+
+    auto memoize = [&](const std::string& path, std::shared_ptr<const std::string> content) -> std::shared_ptr<const std::string>
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        resolutions_[key] = path;
+        return content;
+    };
+
+    /* Walk the candidate paths with the same ordering as the default include handler (see IncludeHandler::Include) */
+    if (!useSearchPathsFirst)
+    {
+        if (auto content = ProbeFile(filename))
+            return memoize(filename, content);
+    }
+
+    for (const auto& path : searchPaths)
+    {
+        if (!path.empty())
+        {
+            std::string s = path;
+            if (path.back() != '/' && path.back() != '\\')
+                s += '/';
+            s += filename;
+
+            if (auto content = ProbeFile(s))
+                return memoize(s, content);
+        }
+    }
+
+    if (useSearchPathsFirst)
+    {
+        if (auto content = ProbeFile(filename))
+            return memoize(filename, content);
+    }
+
+    return nullptr;
+}
+
+void IncludeCache::Prefetch(const char* sourceText, std::size_t sourceSize, const std::vector<std::string>& searchPaths)
+{
+    if (sourceText == nullptr || sourceSize == 0)
+        return;
+
+    /* Scan for include candidates synchronously (cheap, single pass) and load them on the background worker */
+    PrefetchJob job;
+    ScanIncludeCandidates(sourceText, sourceSize, job.candidates);
+
+    if (!job.candidates.empty())
+    {
+        job.searchPaths = searchPaths;
+        IncludePrefetcher::Instance().Enqueue(std::move(job));
+    }
+}
+
+void IncludeCache::StoreVirtualFile(const std::string& path, std::string&& content)
+{
+    /* The previous content is only released here; compiles that fetched it keep reading their consistent snapshot */
+    auto contentPtr = std::make_shared<const std::string>(std::move(content));
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    virtualFiles_[path] = std::move(contentPtr);
+}
+
+void IncludeCache::RemoveVirtualFile(const std::string& path)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (path.empty())
+        virtualFiles_.clear();
+    else
+        virtualFiles_.erase(path);
+}
+
+void IncludeCache::Invalidate(const std::string& path)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    auto it = files_.find(path);
+    if (it != files_.end())
+    {
+        CacheRegistry::Instance().RemoveEntry(*this, IncludeEntryBytes(path, *(it->second.content)), false);
+        files_.erase(it);
+    }
+
+    /* Drop the listing of the containing directory and all resolutions onto the path, so both are re-evaluated */
+    std::string directory, entryName;
+    SplitPath(path, directory, entryName);
+    dirListings_.erase(directory);
+
+    for (auto itRes = resolutions_.begin(); itRes != resolutions_.end();)
+    {
+        if (itRes->second == path)
+            itRes = resolutions_.erase(itRes);
+        else
+            ++itRes;
+    }
+}
+
+void IncludeCache::Clear()
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    files_.clear();
+    resolutions_.clear();
+    dirListings_.clear();
+    CacheRegistry::Instance().ClearEntries(*this);
+}
+
+std::shared_ptr<const std::string> IncludeCache::ProbeFile(const std::string& path)
+{
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+
+        /* Virtual files and cached contents are served without consulting the directory listing */
+        auto itVirtual = virtualFiles_.find(path);
+        if (itVirtual != virtualFiles_.end())
+            return itVirtual->second;
+
+        auto it = files_.find(path);
+        if (it != files_.end())
+        {
+            it->second.lastAccess = CacheRegistry::Instance().NextAccessTick();
+            return it->second.content;
+        }
+    }
+
+    /* Answer the miss from the cached directory listing, so repeated failed probes do not touch the filesystem */
+    if (KnownAbsent(path))
+        return nullptr;
+
+    return FetchOrLoad(path);
+}
+
+bool IncludeCache::KnownAbsent(const std::string& path)
+{
+    /*
+    The membership test lowercases both sides, so a case-insensitive filesystem can never
+    produce a false absence; a false presence only costs the single probe it avoided.
+    */
+    std::string directory, entryName;
+    SplitPath(path, directory, entryName);
+
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        auto it = dirListings_.find(directory);
+        if (it != dirListings_.end())
+            return (it->second.valid && it->second.entries.find(ToLower(entryName)) == it->second.entries.end());
+    }
+
+    /* List the directory outside the lock, so slow listings do not stall concurrent compiles */
+    DirListing listing;
+
+    std::vector<std::string> entries;
+    if (ListDirectory(directory, entries))
+    {
+        /* An unreadable directory is recorded as invalid listing, so its files are still probed directly */
+        listing.valid = true;
+        for (const auto& entry : entries)
+            listing.entries.insert(ToLower(entry));
+    }
+
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    auto& stored = dirListings_[directory];
+    stored = std::move(listing);
+
+    return (stored.valid && stored.entries.find(ToLower(entryName)) == stored.entries.end());
+}
+
+const char* IncludeCache::CacheName() const
+{
+    return "include files";
+}
+
+void IncludeCache::EvictOldest(std::size_t bytesToFree)
+{
+    auto& registry = CacheRegistry::Instance();
+
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    std::size_t freedBytes = 0;
+
+    while (freedBytes < bytesToFree && !files_.empty())
+    {
+        /* Find the least recently used entry (linear scan; eviction is rare compared to lookups) */
+        auto oldest = files_.begin();
+
+        for (auto it = files_.begin(); it != files_.end(); ++it)
+        {
+            if (it->second.lastAccess < oldest->second.lastAccess)
+                oldest = it;
+        }
+
+        /* Drop the map entry; compiles that fetched the content keep reading their consistent snapshot */
+        const auto numBytes = IncludeEntryBytes(oldest->first, *(oldest->second.content));
+
+        freedBytes += numBytes;
+        registry.RemoveEntry(*this, numBytes, true);
+        files_.erase(oldest);
+    }
+}
+
+
+/*
+ * IncludeCacheStream class
+ */
+
+IncludeCacheStream::IncludeCacheStream(const std::shared_ptr<const std::string>& content) :
+    std::istream { nullptr },
+    content_     { content }
+{
+    if (content_)
+    {
+        buf_.SetBuffer(content_->data(), content_->size());
+        rdbuf(&buf_);
+    }
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
@@ -0,0 +1,146 @@
+/*
+ * IncludeCache.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_INCLUDE_CACHE_H
+#define XSC_INCLUDE_CACHE_H
+
+
+#include "FileMapping.h"
+
+#include <Xsc/CacheRegistry.h>
+
+#include <istream>
+#include <string>
+#include <map>
+#include <set>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace Xsc
+{
+
+
+/*
+Process-lifetime cache of loaded include files, shared across all compiles (thread-safe).
+The loaded files are governed by the global memory budget with the lowest eviction priority,
+since refilling only costs a file read; the virtual file overlay is host-owned and never
+evicted (see CacheRegistry).
+*/
+class IncludeCache : public ManagedCache
+{
+
+    public:
+
+        static IncludeCache& Instance();
+
+        // Returns the content of the specified file (loaded at most once per process), or null if the file cannot be read.
+        std::shared_ptr<const std::string> FetchOrLoad(const std::string& path);
+
+        /*
+        Resolves the specified include directive to its file content, probing the search paths in
+        the same order as the default include handler (see IncludeHandler::Include). The resolution
+        is memoized per (include name, directive form, search path list), and misses are answered
+        from cached directory listings, so an include that probes several search paths does not pay
+        repeated failed filesystem accesses (e.g. on network filesystems). Returns null if the
+        include cannot be resolved. Use "Invalidate" or "Clear" when files are added on disk, since
+        the directory listings live as long as the file cache.
+        */
+        std::shared_ptr<const std::string> Resolve(
+            const std::string& filename, bool useSearchPathsFirst, const std::vector<std::string>& searchPaths
+        );
+
+        // Registers the specified in-memory content as virtual file for the path, consulted before the cache and before disk.
+        void StoreVirtualFile(const std::string& path, std::string&& content);
+
+        // Removes the virtual file for the specified path, or all virtual files if the path is empty.
+        void RemoveVirtualFile(const std::string& path);
+
+        /*
+        Asynchronously loads the include files referenced by the specified source into the cache.
+        The source is scanned for include directives only (cheap, without running the preprocessor),
+        and the candidate files and their nested includes are read on a background worker thread,
+        so they are already in memory when the preprocessor reaches the corresponding "#include"
+        directives (see PreProcessor). False candidates (e.g. directives inside comment blocks or
+        excluded conditional branches) only cause a wasted read attempt and never affect correctness.
+        */
+        void Prefetch(const char* sourceText, std::size_t sourceSize, const std::vector<std::string>& searchPaths);
+
+        // Removes the entry for the specified path, so it is re-read on the next include.
+        void Invalidate(const std::string& path);
+
+        // Removes all entries from the cache.
+        void Clear();
+
+        /* --- Internal use by the cache registry --- */
+
+        const char* CacheName() const override;
+        void EvictOldest(std::size_t bytesToFree) override;
+
+    private:
+
+        // Cached file content with its access stamp for the LRU order (see CacheRegistry).
+        struct Entry
+        {
+            std::shared_ptr<const std::string>  content;
+            std::uint64_t                       lastAccess  = 0;
+        };
+
+        // Cached listing of one directory, with the entry names lowercased for the membership test (see KnownAbsent).
+        struct DirListing
+        {
+            bool                    valid   = false;    // False if the directory could not be read; such listings are not consulted.
+            std::set<std::string>   entries;
+        };
+
+        IncludeCache();
+
+        // Probes a single candidate path, consulting the directory listing cache before touching the filesystem.
+        std::shared_ptr<const std::string> ProbeFile(const std::string& path);
+
+        // Returns true if the cached directory listing proves the specified file to be absent.
+        bool KnownAbsent(const std::string& path);
+
+        std::mutex                                                  mutex_;
+        std::map<std::string, Entry>                                files_;
+        std::map<std::string, std::shared_ptr<const std::string>>   virtualFiles_;
+        std::map<std::string, std::string>                          resolutions_;
+        std::map<std::string, DirListing>                           dirListings_;
+
+};
+
+// Input stream over a cached include source; "SourceCode" borrows the buffer directly.
+class IncludeCacheStream : public std::istream
+{
+
+    public:
+
+        IncludeCacheStream(const std::shared_ptr<const std::string>& content);
+
+        // Returns the cached file content this stream reads from.
+        inline const std::string& Content() const
+        {
+            return *content_;
+        }
+
+    private:
+
+        std::shared_ptr<const std::string>  content_;
+        FileMappingBuf                      buf_;
+
+};
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
@@ -8,6 +8,8 @@
 #include <Xsc/IncludeHandler.h>
 #include <fstream>
 #include "Exception.h"
+#include "IncludeCache.h"
+#include "TraceEvents.h"
 
 
 namespace Xsc
@@ -18,47 +20,31 @@ IncludeHandler::~IncludeHandler()
 {
 }
 
-static std::unique_ptr<std::istream> ReadFile(const std::string& filename)
+void IncludeHandler::InvalidateCache(const std::string& path)
 {
-    auto stream = std::unique_ptr<std::istream>(new std::ifstream(filename));
-    return (stream->good() ? std::move(stream) : nullptr);
+    if (path.empty())
+        IncludeCache::Instance().Clear();
+    else
+        IncludeCache::Instance().Invalidate(path);
+}
+
+void IncludeHandler::SetVirtualFile(const std::string& path, std::string content)
+{
+    IncludeCache::Instance().StoreVirtualFile(path, std::move(content));
+}
+
+void IncludeHandler::RemoveVirtualFile(const std::string& path)
+{
+    IncludeCache::Instance().RemoveVirtualFile(path);
 }
 
 std::unique_ptr<std::istream> IncludeHandler::Include(const std::string& filename, bool useSearchPathsFirst)
 {
-    if (!useSearchPathsFirst)
-    {
-        /* Read file from relative path */
-        auto file = ReadFile(filename);
-        if (file)
-            return file;
-    }
-    
-    /* Search file in search paths */
-    for (const auto& path : searchPaths)
-    {
-        if (!path.empty())
-        {
-            /* Get complete filename */
-            std::string s = path;
-            if (path.back() != '/' && path.back() != '\\')
-                s += '/';
-            s += filename;
-
-            /* Read file from current path */
-            auto file = ReadFile(s);
-            if (file)
-                return file;
-        }
-    }
-
-    if (useSearchPathsFirst)
-    {
-        /* Read file from relative path */
-        auto file = ReadFile(filename);
-        if (file)
-            return file;
-    }
+    TraceSpan traceSpan("include", filename);
+
+    /* Resolve through the process-lifetime include cache, which memoizes the search path walk and failed probes */
+    if (auto content = IncludeCache::Instance().Resolve(filename, useSearchPathsFirst, searchPaths))
+        return std::unique_ptr<std::istream>(new IncludeCacheStream(content));
 
     RuntimeErr("failed to include file: \"" + filename + "\"");
 }
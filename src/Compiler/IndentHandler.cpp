@@ -15,29 +15,35 @@ namespace Xsc
 IndentHandler::IndentHandler(const std::string& initialIndent) :
     indent_{ initialIndent }
 {
+    /* Materialize the prefix for the outermost level (further levels are appended on demand) */
+    indentTable_.push_back("");
 }
 
 void IndentHandler::SetIndent(const std::string& indent)
 {
-    indent_ = indent;
+    if (indent_ != indent)
+    {
+        indent_ = indent;
+
+        /* Rebuild the materialized prefixes with the new indentation string */
+        indentTable_.resize(1);
+        while (indentTable_.size() <= indentLevel_)
+            indentTable_.push_back(indentTable_.back() + indent_);
+    }
 }
 
 void IndentHandler::IncIndent()
 {
-    /* Appemnd indentation string and store current size */
-    indentFull_ += indent_;
-    indentStack_.push(indent_.size());
+    /* Materialize the prefix for this level once; all subsequent lines reuse it */
+    ++indentLevel_;
+    if (indentLevel_ >= indentTable_.size())
+        indentTable_.push_back(indentTable_.back() + indent_);
 }
 
 void IndentHandler::DecIndent()
 {
-    if (!indentStack_.empty())
-    {
-        /* Reduce indentation string by previous size */
-        auto size = indentStack_.top();
-        indentFull_.resize(indentFull_.size() - size);
-        indentStack_.pop();
-    }
+    if (indentLevel_ > 0)
+        --indentLevel_;
 }
 
 
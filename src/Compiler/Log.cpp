@@ -9,6 +9,7 @@
 #include <Xsc/ConsoleManip.h>
 #include <iostream>
 #include <algorithm>
+#include <mutex>
 
 
 namespace Xsc
@@ -19,30 +20,84 @@ namespace Xsc
  * StdLog class
  */
 
+/* Global print mutex, so concurrent "PrintAll" flushes do not interleave on the standard output */
+static std::mutex g_printMutex;
+
 void StdLog::SumitReport(const Report& report)
 {
+    std::lock_guard<std::mutex> guard(reportMutex_);
+
+    /* Select report list by type */
+    IndentReportList* reports = nullptr;
+
     switch (report.Type())
     {
         case Report::Types::Info:
-            infos_.push_back({ FullIndent(), report });
+            reports = &infos_;
             break;
         case Report::Types::Warning:
-            warnings_.push_back({ FullIndent(), report });
+            reports = &warnings_;
             break;
         case Report::Types::Error:
-            errors_.push_back({ FullIndent(), report });
+            reports = &errors_;
             break;
     }
+
+    if (reports == nullptr)
+        return;
+
+    if (dedupReports_)
+    {
+        /* Count repeated reports only once (their line markers are then never fetched or printed) */
+        std::string key;
+        key.reserve(report.Context().size() + report.Message().size() + 2);
+        key += static_cast<char>(report.Type());
+        key += report.Context();
+        key += '\n';
+        key += report.Message();
+
+        auto it = dedupIndices_.find(key);
+        if (it != dedupIndices_.end())
+        {
+            ++((*reports)[it->second].occurrences);
+            return;
+        }
+
+        dedupIndices_[std::move(key)] = reports->size();
+    }
+
+    reports->push_back({ FullIndent(), report, 1 });
 }
 
 void StdLog::PrintAll(bool verbose, bool warnings)
 {
-    PrintAndClearReports(infos_, verbose);
+    /* Move the buffered reports out, so submission from other threads is not blocked while printing */
+    IndentReportList infos, warningReports, errors;
+    {
+        std::lock_guard<std::mutex> guard(reportMutex_);
+        infos           = std::move(infos_);
+        warningReports  = std::move(warnings_);
+        errors          = std::move(errors_);
+        infos_.clear();
+        warnings_.clear();
+        errors_.clear();
+        dedupIndices_.clear();
+    }
+
+    /* Print the entire flush as one uninterrupted block.
+       The print functions only append to the stream buffer (color transitions are embedded,
+       or the platform backend flushes before a console state change), so the standard
+       output is flushed once per report batch instead of once per line. */
+    std::lock_guard<std::mutex> printGuard(g_printMutex);
+
+    PrintAndClearReports(infos, verbose);
 
     if (warnings)
-        PrintAndClearReports(warnings_, verbose, (warnings_.size() == 1 ? "WARNING" : "WARNINGS"));
+        PrintAndClearReports(warningReports, verbose, (warningReports.size() == 1 ? "WARNING" : "WARNINGS"));
 
-    PrintAndClearReports(errors_, verbose, (errors_.size() == 1 ? "ERROR": "ERRORS"));
+    PrintAndClearReports(errors, verbose, (errors.size() == 1 ? "ERROR": "ERRORS"));
+
+    std::cout.flush();
 }
 
 using Colors = ConsoleManip::ColorFlags;
@@ -84,7 +139,7 @@ static void PrintMultiLineString(const std::string& s, const std::string& indent
             start = end;
         }
 
-        std::cout << std::endl;
+        std::cout << '\n';
 
         useNewLineIndent = true;
     }
@@ -113,6 +168,10 @@ void StdLog::PrintReport(const IndentReport& r, bool verbose)
     else
         PrintMultiLineString(msg, r.indent);
 
+    /* Print occurrence count of deduplicated reports */
+    if (r.occurrences > 1)
+        std::cout << r.indent << "(occurred " << r.occurrences << " times)" << '\n';
+
     if (!verbose)
         return;
     
@@ -142,19 +201,19 @@ void StdLog::PrintReport(const IndentReport& r, bool verbose)
             else
                 std::cout << line;
 
-            std::cout << std::endl;
+            std::cout << '\n';
         }
 
         /* Print line marker */
         {
             ConsoleManip::ScopedColor highlight(std::cout, Colors::Cyan);
-            std::cout << r.indent << marker << std::endl;
+            std::cout << r.indent << marker << '\n';
         }
     }
 
     /* Print optional hints */
     for (const auto& hint : r.report.GetHints())
-        std::cout << r.indent << hint << std::endl;
+        std::cout << r.indent << hint << '\n';
 }
 
 void StdLog::PrintAndClearReports(IndentReportList& reports, bool verbose, const std::string& headline)
@@ -165,8 +224,8 @@ void StdLog::PrintAndClearReports(IndentReportList& reports, bool verbose, const
         if (!headline.empty())
         {
             auto s = std::to_string(reports.size()) + " " + headline;
-            std::cout << s << std::endl;
-            std::cout << std::string(s.size(), '-') << std::endl;
+            std::cout << s << '\n';
+            std::cout << std::string(s.size(), '-') << '\n';
         }
 
         /* Print and clear reports */
@@ -8,6 +8,18 @@
 #ifdef XSC_ENABLE_MEMORY_POOL
 
 #include "MemoryPool.h"
+#include "CompileStats.h"
+#include <cstddef>
+#include <new>
+
+#ifdef XSC_ENABLE_LARGE_PAGES
+#   if defined(_WIN32)
+#       include <windows.h>
+#   elif defined(__linux__)
+#       include <cstdlib>
+#       include <sys/mman.h>
+#   endif
+#endif
 
 
 namespace Xsc
@@ -18,16 +30,19 @@ namespace Xsc
  * MemoryPool
  */
 
-MemoryPool& MemoryPool::Instance()
+// Active pool of the current thread, so concurrent compiles never share an arena.
+static thread_local MemoryPool* activeMemoryPool = nullptr;
+
+MemoryPool* MemoryPool::Active()
 {
-    static MemoryPool instance;
-    return instance;
+    return activeMemoryPool;
 }
 
 void* MemoryPool::Alloc(std::size_t count)
 {
-    if (count > pageSize_)
-        throw std::bad_alloc();
+    /* Round allocation size up, so that subsequent allocations remain aligned */
+    static const std::size_t alignment = alignof(std::max_align_t);
+    count = (count + alignment - 1) / alignment * alignment;
 
     if (pages_.empty())
         NewPage();
@@ -37,14 +52,19 @@ void* MemoryPool::Alloc(std::size_t count)
 
     if (!ptr)
     {
-        /* Make new page if previous one is full */
-        NewPage();
+        /* Make new page if previous one is full (or a dedicated page for an oversized allocation) */
+        if (count > pageSize_)
+            pages_.emplace_back(MemoryPage(count));
+        else
+            NewPage();
         ptr = ActivePage().Alloc(count);
     }
 
     if (!ptr)
         throw std::bad_alloc();
 
+    AllocTrackingOnAlloc(count);
+
     return ptr;
 }
 
@@ -53,10 +73,110 @@ void MemoryPool::Free(void* ptr)
     // currently do nothing
 }
 
+MemoryPool::~MemoryPool()
+{
+    /* Report the dropped arena memory, so the live-bytes tracking spans whole compiles correctly */
+    AllocTrackingOnFree(UsedBytes());
+}
+
+void MemoryPool::Reset()
+{
+    AllocTrackingOnFree(UsedBytes());
+
+    if (pages_.size() > 1)
+    {
+        /* Replace all pages by a single page with the accumulated capacity, so the steady state is one allocation */
+        std::size_t totalSize = 0;
+        for (const auto& page : pages_)
+            totalSize += page.Size();
+
+        pages_.clear();
+        pages_.emplace_back(MemoryPage(totalSize));
+    }
+    else if (!pages_.empty())
+        ActivePage().Rewind();
+}
+
+MemoryPool::Marker MemoryPool::Mark() const
+{
+    Marker marker;
+
+    marker.numPages     = pages_.size();
+    marker.pageUsed     = (pages_.empty() ? 0 : pages_.back().Used());
+    marker.nextPageSize = pageSize_;
+
+    return marker;
+}
+
+void MemoryPool::RewindTo(const Marker& marker)
+{
+    std::size_t freedBytes      = 0;
+    std::size_t freedCapacity   = 0;
+
+    /* Drop the pages allocated after the marker */
+    while (pages_.size() > marker.numPages)
+    {
+        freedBytes      += pages_.back().Used();
+        freedCapacity   += pages_.back().Size();
+        pages_.pop_back();
+    }
+
+    /* Rewind the page the marker points into */
+    if (!pages_.empty() && pages_.size() == marker.numPages)
+    {
+        auto& page = pages_.back();
+        freedBytes += (page.Used() - marker.pageUsed);
+        page.RewindTo(marker.pageUsed);
+    }
+
+    /* Fold the freed capacity into the next page size, so the following pass allocates it back in few pages */
+    pageSize_ = marker.nextPageSize;
+    while (pageSize_ < freedCapacity && pageSize_ < maxPageSize_)
+        pageSize_ <<= 1;
+
+    AllocTrackingOnFree(freedBytes);
+}
+
+void MemoryPool::ReserveForInput(std::size_t inputSize)
+{
+    /* A pool retained across compiles keeps its learned capacity (see Reset) */
+    if (!pages_.empty() || inputSize == 0)
+        return;
+
+    /* The AST weighs a small multiple of the source text; start with a page covering the estimate */
+    const auto estimate = inputSize * 4;
+
+    auto size = minPageSize_;
+    while (size < estimate && size < maxPageSize_)
+        size <<= 1;
+
+    pageSize_ = size;
+}
+
+std::size_t MemoryPool::UsedBytes() const
+{
+    std::size_t usedBytes = 0;
+    for (const auto& page : pages_)
+        usedBytes += page.Used();
+    return usedBytes;
+}
+
+std::size_t MemoryPool::CapacityBytes() const
+{
+    std::size_t capacity = 0;
+    for (const auto& page : pages_)
+        capacity += page.Size();
+    return capacity;
+}
+
 //private
 void MemoryPool::NewPage()
 {
     pages_.emplace_back(MemoryPage(pageSize_));
+
+    /* Grow the next page geometrically, so a large AST spans few contiguous blocks */
+    if (pageSize_ < maxPageSize_)
+        pageSize_ <<= 1;
 }
 
 //Private
@@ -66,6 +186,34 @@ MemoryPool::MemoryPage& MemoryPool::ActivePage()
 }
 
 
+/*
+ * MemoryPoolScope
+ */
+
+MemoryPoolScope::MemoryPoolScope()
+{
+    /* Adopt the enclosing pool if one is already active (e.g. retained by a CompilerInstance) */
+    if (activeMemoryPool == nullptr)
+    {
+        activeMemoryPool    = &pool_;
+        activated_          = true;
+    }
+}
+
+MemoryPoolScope::MemoryPoolScope(MemoryPool& pool) :
+    previous_   { activeMemoryPool },
+    activated_  { true             }
+{
+    activeMemoryPool = &pool;
+}
+
+MemoryPoolScope::~MemoryPoolScope()
+{
+    if (activated_)
+        activeMemoryPool = previous_;
+}
+
+
 /*
  * MemoryPage
  */
@@ -73,21 +221,28 @@ MemoryPool::MemoryPage& MemoryPool::ActivePage()
 MemoryPool::MemoryPage::MemoryPage(std::size_t size) :
     size_{ size }
 {
-    buffer_ = std::unique_ptr<char[]>(new char[size]);
+    buffer_ = AllocBuffer(size, largeBacking_);
 }
 
 MemoryPool::MemoryPage::MemoryPage(MemoryPage&& rhs) :
-    size_   { rhs.size_              },
-    ptr_    { rhs.ptr_               },
-    buffer_ { std::move(rhs.buffer_) }
+    size_           { rhs.size_         },
+    ptr_            { rhs.ptr_          },
+    buffer_         { rhs.buffer_       },
+    largeBacking_   { rhs.largeBacking_ }
 {
+    rhs.buffer_ = nullptr;
+}
+
+MemoryPool::MemoryPage::~MemoryPage()
+{
+    FreeBuffer(buffer_, largeBacking_);
 }
 
 void* MemoryPool::MemoryPage::Alloc(std::size_t count)
 {
-    if (ptr_ + count < size_)
+    if (ptr_ + count <= size_)
     {
-        auto p = buffer_.get() + ptr_;
+        auto p = buffer_ + ptr_;
         ptr_ += count;
         return p;
     }
@@ -95,6 +250,76 @@ void* MemoryPool::MemoryPage::Alloc(std::size_t count)
         return nullptr;
 }
 
+#ifdef XSC_ENABLE_LARGE_PAGES
+
+static const std::size_t hugePageSize = 2097152;
+
+char* MemoryPool::MemoryPage::AllocBuffer(std::size_t size, bool& largeBacking)
+{
+    if (size >= hugePageSize)
+    {
+        #if defined(_WIN32)
+
+        /* Try explicit large pages first (requires the lock-pages-in-memory privilege) */
+        auto buffer = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (!buffer)
+            buffer = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (buffer)
+        {
+            largeBacking = true;
+            return reinterpret_cast<char*>(buffer);
+        }
+
+        #elif defined(__linux__)
+
+        /* Align the buffer to the huge-page size, so transparent huge pages can back it */
+        void* buffer = nullptr;
+        if (posix_memalign(&buffer, hugePageSize, size) == 0)
+        {
+            madvise(buffer, size, MADV_HUGEPAGE);
+            largeBacking = true;
+            return reinterpret_cast<char*>(buffer);
+        }
+
+        #endif
+    }
+
+    largeBacking = false;
+    return new char[size];
+}
+
+void MemoryPool::MemoryPage::FreeBuffer(char* buffer, bool largeBacking)
+{
+    if (buffer)
+    {
+        if (largeBacking)
+        {
+            #if defined(_WIN32)
+            VirtualFree(buffer, 0, MEM_RELEASE);
+            #elif defined(__linux__)
+            std::free(buffer);
+            #endif
+        }
+        else
+            delete[] buffer;
+    }
+}
+
+#else
+
+char* MemoryPool::MemoryPage::AllocBuffer(std::size_t size, bool& largeBacking)
+{
+    largeBacking = false;
+    return new char[size];
+}
+
+void MemoryPool::MemoryPage::FreeBuffer(char* buffer, bool)
+{
+    delete[] buffer;
+}
+
+#endif
+
 
 } // /namespace Xsc
 
@@ -1,6 +1,6 @@
 /*
  * MemoryPool.h
- * 
+ *
  * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
  * See "LICENSE.txt" for license information.
  */
@@ -11,6 +11,7 @@
 #ifdef XSC_ENABLE_MEMORY_POOL
 
 
+#include "CompileStats.h"
 #include <list>
 #include <memory>
 
@@ -19,19 +20,72 @@ namespace Xsc
 {
 
 
+/*
+Per-compilation memory arena; all memory is released in one go when the pool is destroyed.
+Since the recursive descent parser allocates AST nodes as it descends, the arena holds them
+in pre-order (children directly after their parents), so AST traversals in the backend
+passes stream memory nearly linearly. Pages grow geometrically to keep a large AST in few
+contiguous blocks.
+*/
 class MemoryPool
 {
 
     public:
 
-        static MemoryPool& Instance();
+        MemoryPool() = default;
+        ~MemoryPool();
+
+        MemoryPool(const MemoryPool&) = delete;
+        MemoryPool& operator = (const MemoryPool&) = delete;
+
+        // Returns the active pool of the current thread (see "MemoryPoolScope"), or null if there is none.
+        static MemoryPool* Active();
 
         void* Alloc(std::size_t count);
         void Free(void* ptr);
 
-    private:
+        // Rewinds the pool for reuse, retaining the accumulated page capacity; all previously allocated objects must be dead.
+        void Reset();
 
-        MemoryPool() = default;
+        // Opaque arena position for the checkpoint/rewind semantics (see Mark).
+        struct Marker
+        {
+            std::size_t numPages        = 0;
+            std::size_t pageUsed        = 0;
+            std::size_t nextPageSize    = 0;
+        };
+
+        // Returns a marker for the current arena position (see RewindTo).
+        Marker Mark() const;
+
+        /*
+        Rewinds the arena to the specified marker, releasing every allocation made after it in one go.
+        Only valid when all objects allocated after the marker are dead (e.g. the complete AST of an
+        already emitted shader variant); the released page capacity is folded into the next page size,
+        so the following pass allocates it back in few pages.
+        */
+        void RewindTo(const Marker& marker);
+
+        /*
+        Chooses the first page size from the specified input size (in bytes), so tiny shaders do not
+        waste a big page and a large AST starts with large pages instead of growing through small ones.
+        Ignored once the pool holds pages, i.e. a pool retained across compiles keeps its learned capacity.
+        */
+        void ReserveForInput(std::size_t inputSize);
+
+        // Returns the number of bytes allocated from this pool (across all pages).
+        std::size_t UsedBytes() const;
+
+        // Returns the total page capacity of this pool in bytes.
+        std::size_t CapacityBytes() const;
+
+        // Returns the number of pages of this pool.
+        inline std::size_t NumPages() const
+        {
+            return pages_.size();
+        }
+
+    private:
 
         class MemoryPage
         {
@@ -40,25 +94,160 @@ class MemoryPool
 
                 MemoryPage(std::size_t size);
                 MemoryPage(MemoryPage&& rhs);
+                ~MemoryPage();
+
+                MemoryPage(const MemoryPage&) = delete;
+                MemoryPage& operator = (const MemoryPage&) = delete;
 
                 void* Alloc(std::size_t count);
 
+                // Rewinds the page, so its entire capacity can be allocated again.
+                inline void Rewind()
+                {
+                    ptr_ = 0;
+                }
+
+                // Rewinds the page to the specified allocation offset (see MemoryPool::RewindTo).
+                inline void RewindTo(std::size_t used)
+                {
+                    ptr_ = used;
+                }
+
+                // Returns the capacity of this page (in bytes).
+                inline std::size_t Size() const
+                {
+                    return size_;
+                }
+
+                // Returns the number of bytes allocated from this page.
+                inline std::size_t Used() const
+                {
+                    return ptr_;
+                }
+
             private:
 
-                std::size_t             size_   = 0;
-                std::size_t             ptr_    = 0;
-                std::unique_ptr<char[]> buffer_;
+                /*
+                Allocates the page buffer; pages of at least huge-page size are backed by huge pages
+                when built with the XSC_LARGE_PAGES option, so a large AST walks through few TLB entries.
+                */
+                static char* AllocBuffer(std::size_t size, bool& largeBacking);
+                static void FreeBuffer(char* buffer, bool largeBacking);
+
+                std::size_t size_           = 0;
+                std::size_t ptr_            = 0;
+                char*       buffer_         = nullptr;
+                bool        largeBacking_   = false;
 
         };
 
         void NewPage();
         MemoryPage& ActivePage();
 
-        std::size_t             pageSize_   = 16384;
+        static const std::size_t minPageSize_ = 16384;
+
+        #ifdef XSC_ENABLE_LARGE_PAGES
+        static const std::size_t maxPageSize_ = 2097152; // one x86-64 huge page
+        #else
+        static const std::size_t maxPageSize_ = 1048576;
+        #endif
+
+        // Size of the next page; doubles with each new page (up to "maxPageSize_"), so large ASTs span few pages.
+        std::size_t             pageSize_   = minPageSize_;
         std::list<MemoryPage>   pages_;
-    
+
 };
 
+// RAII scope that owns a per-compile memory pool and makes it the active pool of the current thread.
+class MemoryPoolScope
+{
+
+    public:
+
+        // Activates the own pool, unless an enclosing scope already activated one (which is then adopted).
+        MemoryPoolScope();
+
+        // Activates the specified external pool (e.g. one retained across compiles by a CompilerInstance).
+        explicit MemoryPoolScope(MemoryPool& pool);
+
+        ~MemoryPoolScope();
+
+        MemoryPoolScope(const MemoryPoolScope&) = delete;
+        MemoryPoolScope& operator = (const MemoryPoolScope&) = delete;
+
+    private:
+
+        MemoryPool  pool_;
+        MemoryPool* previous_   = nullptr;
+        bool        activated_  = false;
+
+};
+
+
+// STL compatible allocator adapter, to allocate objects (e.g. tokens) from the active memory pool.
+// Falls back to the global allocator when no pool is active on the constructing thread.
+template <typename T>
+class PoolAllocator
+{
+
+    public:
+
+        using value_type = T;
+
+        PoolAllocator() :
+            pool_{ MemoryPool::Active() }
+        {
+        }
+
+        template <typename U>
+        PoolAllocator(const PoolAllocator<U>& rhs) :
+            pool_{ rhs.Pool() }
+        {
+        }
+
+        T* allocate(std::size_t count)
+        {
+            if (pool_)
+                return reinterpret_cast<T*>(pool_->Alloc(sizeof(T) * count));
+
+            /* Heap fallback; pool allocations are tracked inside the pool itself */
+            AllocTrackingOnAlloc(sizeof(T) * count);
+            return reinterpret_cast<T*>(::operator new (sizeof(T) * count));
+        }
+
+        void deallocate(T* ptr, std::size_t count)
+        {
+            /* Pool memory is released in one go when the pool is destroyed */
+            if (!pool_)
+            {
+                AllocTrackingOnFree(sizeof(T) * count);
+                ::operator delete (ptr);
+            }
+        }
+
+        inline MemoryPool* Pool() const
+        {
+            return pool_;
+        }
+
+    private:
+
+        MemoryPool* pool_ = nullptr;
+
+};
+
+template <typename T, typename U>
+bool operator == (const PoolAllocator<T>& lhs, const PoolAllocator<U>& rhs)
+{
+    return (lhs.Pool() == rhs.Pool());
+}
+
+template <typename T, typename U>
+bool operator != (const PoolAllocator<T>& lhs, const PoolAllocator<U>& rhs)
+{
+    return (lhs.Pool() != rhs.Pool());
+}
+
 
 } // /namespace Xsc
 
@@ -69,4 +258,4 @@ class MemoryPool
 
 
 
-// ================================================================================
\ No newline at end of file
+// ================================================================================
@@ -0,0 +1,171 @@
+/*
+ * OutputCache.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Xsc/OutputCache.h>
+
+#include <fstream>
+#include <iterator>
+
+
+namespace Xsc
+{
+
+
+/*
+ * MemoryOutputCache class
+ */
+
+// Eviction priority of the in-memory output caches: refilling costs a full compilation, so these entries are kept longest (see CacheRegistry).
+static const int outputCacheEvictionPriority_ = 2;
+
+// Returns the approximate memory footprint of one cache entry (blob payload plus container overhead).
+static std::size_t OutputEntryBytes(const std::string& blob)
+{
+    return (sizeof(std::uint64_t) + sizeof(std::string) + blob.size());
+}
+
+MemoryOutputCache::MemoryOutputCache()
+{
+    CacheRegistry::Instance().Register(*this, outputCacheEvictionPriority_);
+}
+
+MemoryOutputCache::~MemoryOutputCache()
+{
+    CacheRegistry::Instance().Unregister(*this);
+}
+
+bool MemoryOutputCache::Fetch(std::uint64_t key, std::string& entry)
+{
+    auto it = entries_.find(key);
+    if (it != entries_.end())
+    {
+        it->second.lastAccess = CacheRegistry::Instance().NextAccessTick();
+        entry = it->second.blob;
+        return true;
+    }
+    return false;
+}
+
+void MemoryOutputCache::Store(std::uint64_t key, const std::string& entry)
+{
+    auto& registry = CacheRegistry::Instance();
+
+    /* Settle a pending eviction debt first, so this cache stays inside its share of the memory budget */
+    registry.SettleEvictionDebt(*this);
+
+    auto it = entries_.find(key);
+    if (it != entries_.end())
+    {
+        registry.RemoveEntry(*this, OutputEntryBytes(it->second.blob), false);
+        entries_.erase(it);
+    }
+
+    Entry cacheEntry;
+    {
+        cacheEntry.blob       = entry;
+        cacheEntry.lastAccess = registry.NextAccessTick();
+    }
+    entries_[key] = std::move(cacheEntry);
+
+    registry.AddEntry(*this, OutputEntryBytes(entry));
+}
+
+void MemoryOutputCache::Clear()
+{
+    entries_.clear();
+    CacheRegistry::Instance().ClearEntries(*this);
+}
+
+const char* MemoryOutputCache::CacheName() const
+{
+    return "output blobs";
+}
+
+void MemoryOutputCache::EvictOldest(std::size_t bytesToFree)
+{
+    auto& registry = CacheRegistry::Instance();
+
+    std::size_t freedBytes = 0;
+
+    while (freedBytes < bytesToFree && !entries_.empty())
+    {
+        /* Find the least recently used entry (linear scan; eviction is rare compared to lookups) */
+        auto oldest = entries_.begin();
+
+        for (auto it = entries_.begin(); it != entries_.end(); ++it)
+        {
+            if (it->second.lastAccess < oldest->second.lastAccess)
+                oldest = it;
+        }
+
+        const auto numBytes = OutputEntryBytes(oldest->second.blob);
+
+        freedBytes += numBytes;
+        registry.RemoveEntry(*this, numBytes, true);
+        entries_.erase(oldest);
+    }
+}
+
+
+/*
+ * FileOutputCache class
+ */
+
+FileOutputCache::FileOutputCache(const std::string& directory) :
+    directory_{ directory }
+{
+}
+
+bool FileOutputCache::Fetch(std::uint64_t key, std::string& entry)
+{
+    std::ifstream file(EntryPath(key), std::ios::binary);
+    if (!file.good())
+        return false;
+
+    entry.assign(
+        std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>()
+    );
+
+    return !entry.empty();
+}
+
+void FileOutputCache::Store(std::uint64_t key, const std::string& entry)
+{
+    /* A failed write leaves no usable entry behind and only costs a recompilation */
+    std::ofstream file(EntryPath(key), std::ios::binary | std::ios::trunc);
+    if (file.good())
+        file.write(entry.data(), static_cast<std::streamsize>(entry.size()));
+}
+
+
+/*
+ * ======= Private: =======
+ */
+
+//private
+std::string FileOutputCache::EntryPath(std::uint64_t key) const
+{
+    static const char* hexDigits = "0123456789abcdef";
+
+    std::string path = directory_;
+    if (!path.empty() && path.back() != '/' && path.back() != '\\')
+        path += '/';
+
+    for (int i = 15; i >= 0; --i)
+        path += hexDigits[(key >> (i * 4)) & 0xf];
+    path += ".xoc";
+
+    return path;
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
@@ -0,0 +1,29 @@
+/*
+ * OutputCompressor.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Xsc/OutputCompressor.h>
+
+
+namespace Xsc
+{
+
+
+OutputCompressor::~OutputCompressor()
+{
+}
+
+void OutputCompressor::Finish()
+{
+    /* The default implementation has no end-of-stream frame to write */
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
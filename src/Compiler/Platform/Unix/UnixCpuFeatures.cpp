@@ -0,0 +1,81 @@
+/*
+ * UnixCpuFeatures.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "../../CpuFeatures.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+
+namespace Xsc
+{
+
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// Returns the extended control register 0, i.e. which register states the OS saves on context switches.
+static unsigned int QueryXCR0()
+{
+    unsigned int eax = 0, edx = 0;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return eax;
+}
+
+static CpuFeatures DetectCpuFeatures()
+{
+    CpuFeatures features;
+
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0)
+    {
+        features.sse2  = ((edx & (1u << 26)) != 0);
+        features.sse42 = ((ecx & (1u << 20)) != 0);
+
+        /* AVX requires OS support for the extended register states (OSXSAVE, and XMM/YMM state in XCR0) */
+        const auto osxsave = ((ecx & (1u << 27)) != 0);
+        const auto avx     = ((ecx & (1u << 28)) != 0);
+
+        if (osxsave && avx && (QueryXCR0() & 0x6u) == 0x6u)
+        {
+            if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) != 0)
+                features.avx2 = ((ebx & (1u << 5)) != 0);
+        }
+    }
+
+    return features;
+}
+
+#else
+
+static CpuFeatures DetectCpuFeatures()
+{
+    CpuFeatures features;
+
+    /* NEON availability is a compile-time property here (mandatory on AArch64) */
+    #if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(__aarch64__)
+    features.neon = true;
+    #endif
+
+    return features;
+}
+
+#endif
+
+const CpuFeatures& QueryCpuFeatures()
+{
+    static const CpuFeatures features = DetectCpuFeatures();
+    return features;
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
@@ -0,0 +1,40 @@
+/*
+ * UnixDirectoryListing.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "../../DirectoryListing.h"
+
+#include <dirent.h>
+#include <cstring>
+
+
+namespace Xsc
+{
+
+
+bool ListDirectory(const std::string& path, std::vector<std::string>& entries)
+{
+    auto dir = opendir(path.empty() ? "." : path.c_str());
+    if (!dir)
+        return false;
+
+    while (auto entry = readdir(dir))
+    {
+        if (std::strcmp(entry->d_name, ".") != 0 && std::strcmp(entry->d_name, "..") != 0)
+            entries.push_back(entry->d_name);
+    }
+
+    closedir(dir);
+
+    return true;
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
@@ -0,0 +1,60 @@
+/*
+ * UnixFileMapping.cpp
+ *
+ * This file is part of the "HLSL Translator" (Copyright (c) 2014 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "../../FileMapping.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+namespace Xsc
+{
+
+
+void FileMapping::OpenMapping(const std::string& filename)
+{
+    /* Open file for reading only */
+    auto fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    /* Map regular, non-empty files only; every other case falls back to stream reading */
+    struct stat fileInfo;
+    if (fstat(fd, &fileInfo) == 0 && S_ISREG(fileInfo.st_mode) && fileInfo.st_size > 0)
+    {
+        auto size = static_cast<std::size_t>(fileInfo.st_size);
+        auto addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (addr != MAP_FAILED)
+        {
+            data_ = reinterpret_cast<const char*>(addr);
+            size_ = size;
+        }
+    }
+
+    /* Mapping (if any) remains valid after the descriptor is closed */
+    close(fd);
+}
+
+void FileMapping::CloseMapping()
+{
+    if (data_ != nullptr)
+    {
+        munmap(const_cast<char*>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
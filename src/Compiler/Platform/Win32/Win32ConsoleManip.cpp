@@ -117,11 +117,14 @@ void ScreenBufferInfo::Pop()
  * Public functions
  */
 
-void PushColor(std::ostream&, long front)
+void PushColor(std::ostream& stream, long front)
 {
     if (!IsEnabled())
         return;
 
+    /* Write out pending buffered text before the console state changes */
+    stream.flush();
+
     /* Push color attribute onto stack */
     g_screenBufferInfo.Push();
 
@@ -141,11 +144,14 @@ void PushColor(std::ostream&, long front)
     SetConsoleTextAttribute(StdOut(), attrib);
 }
 
-void PushColor(std::ostream&, long front, long back)
+void PushColor(std::ostream& stream, long front, long back)
 {
     if (!IsEnabled())
         return;
 
+    /* Write out pending buffered text before the console state changes */
+    stream.flush();
+
     /* Push color attribute onto stack */
     g_screenBufferInfo.Push();
 
@@ -166,10 +172,14 @@ void PushColor(std::ostream&, long front, long back)
     SetConsoleTextAttribute(StdOut(), attrib);
 }
 
-void PopColor(std::ostream&)
+void PopColor(std::ostream& stream)
 {
     if (IsEnabled())
+    {
+        /* Write out pending buffered text before the console state changes */
+        stream.flush();
         g_screenBufferInfo.Pop();
+    }
 }
 
 
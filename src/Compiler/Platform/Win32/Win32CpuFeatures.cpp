@@ -0,0 +1,78 @@
+/*
+ * Win32CpuFeatures.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "../../CpuFeatures.h"
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+
+
+namespace Xsc
+{
+
+
+#if defined(_M_X64) || defined(_M_IX86)
+
+static CpuFeatures DetectCpuFeatures()
+{
+    CpuFeatures features;
+
+    int info[4] = { 0, 0, 0, 0 };
+
+    __cpuid(info, 0);
+    const auto maxLeaf = info[0];
+
+    if (maxLeaf >= 1)
+    {
+        __cpuid(info, 1);
+
+        features.sse2  = ((info[3] & (1 << 26)) != 0);
+        features.sse42 = ((info[2] & (1 << 20)) != 0);
+
+        /* AVX requires OS support for the extended register states (OSXSAVE, and XMM/YMM state in XCR0) */
+        const auto osxsave = ((info[2] & (1 << 27)) != 0);
+        const auto avx     = ((info[2] & (1 << 28)) != 0);
+
+        if (osxsave && avx && (_xgetbv(0) & 0x6u) == 0x6u && maxLeaf >= 7)
+        {
+            __cpuidex(info, 7, 0);
+            features.avx2 = ((info[1] & (1 << 5)) != 0);
+        }
+    }
+
+    return features;
+}
+
+#else
+
+static CpuFeatures DetectCpuFeatures()
+{
+    CpuFeatures features;
+
+    /* NEON availability is a compile-time property here (mandatory on AArch64) */
+    #if defined(_M_ARM64) || defined(_M_ARM)
+    features.neon = true;
+    #endif
+
+    return features;
+}
+
+#endif
+
+const CpuFeatures& QueryCpuFeatures()
+{
+    static const CpuFeatures features = DetectCpuFeatures();
+    return features;
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
@@ -0,0 +1,48 @@
+/*
+ * Win32DirectoryListing.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "../../DirectoryListing.h"
+
+#include <Windows.h>
+#include <cstring>
+
+
+namespace Xsc
+{
+
+
+bool ListDirectory(const std::string& path, std::vector<std::string>& entries)
+{
+    auto pattern = (path.empty() ? std::string(".") : path);
+    if (pattern.back() != '/' && pattern.back() != '\\')
+        pattern += '\\';
+    pattern += '*';
+
+    WIN32_FIND_DATAA findData;
+    auto findHandle = FindFirstFileA(pattern.c_str(), &findData);
+
+    if (findHandle == INVALID_HANDLE_VALUE)
+        return false;
+
+    do
+    {
+        if (std::strcmp(findData.cFileName, ".") != 0 && std::strcmp(findData.cFileName, "..") != 0)
+            entries.push_back(findData.cFileName);
+    }
+    while (FindNextFileA(findHandle, &findData) != FALSE);
+
+    FindClose(findHandle);
+
+    return true;
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
@@ -0,0 +1,76 @@
+/*
+ * Win32FileMapping.cpp
+ *
+ * This file is part of the "HLSL Translator" (Copyright (c) 2014 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "../../FileMapping.h"
+
+#include <Windows.h>
+
+
+namespace Xsc
+{
+
+
+void FileMapping::OpenMapping(const std::string& filename)
+{
+    /* Open file for reading only */
+    auto fileHandle = CreateFileA(
+        filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr
+    );
+
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        return;
+
+    /* Map non-empty files only; every other case falls back to stream reading */
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(fileHandle, &fileSize) != FALSE && fileSize.QuadPart > 0)
+    {
+        auto mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mappingHandle != nullptr)
+        {
+            auto addr = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+            if (addr != nullptr)
+            {
+                data_           = reinterpret_cast<const char*>(addr);
+                size_           = static_cast<std::size_t>(fileSize.QuadPart);
+                fileHandle_     = fileHandle;
+                mappingHandle_  = mappingHandle;
+                return;
+            }
+            CloseHandle(mappingHandle);
+        }
+    }
+
+    CloseHandle(fileHandle);
+}
+
+void FileMapping::CloseMapping()
+{
+    if (data_ != nullptr)
+    {
+        UnmapViewOfFile(const_cast<char*>(data_));
+        data_ = nullptr;
+        size_ = 0;
+    }
+    if (mappingHandle_ != nullptr)
+    {
+        CloseHandle(reinterpret_cast<HANDLE>(mappingHandle_));
+        mappingHandle_ = nullptr;
+    }
+    if (fileHandle_ != nullptr)
+    {
+        CloseHandle(reinterpret_cast<HANDLE>(fileHandle_));
+        fileHandle_ = nullptr;
+    }
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
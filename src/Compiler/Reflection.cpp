@@ -0,0 +1,310 @@
+/*
+ * Reflection.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Xsc/Reflection.h>
+#include <cstdint>
+
+
+namespace Xsc
+{
+
+namespace Reflection
+{
+
+
+/*
+Binary blob format (all integers little-endian):
+  char[4]   magic number "XSCR"
+  uint16    format version
+  section   constant buffers: uint32 count, per entry { string name, int32 binding, uint32 field count, per field { string name, string type, uint8 referenced } }
+  section   resources:        uint32 count, per entry { string name, string type, int32 binding }
+  section   samplers:         uint32 count, per entry { string name, int32 binding }
+  section   input attributes: uint32 count, per entry { string name, string type, string semantic }
+  section   output attributes (same layout as input attributes)
+  section   function costs:   uint32 count, per entry { string name, uint8 entryPoint,
+                              uint32 aluOps, uint32 transcendentalOps, uint32 textureFetches,
+                              uint32 branches, uint32 maxLoopDepth, uint32 totalCost }
+Strings are stored as uint16 length followed by the character data (no terminator).
+*/
+
+static const char*          magicNumber_    = "XSCR";
+static const std::uint16_t  formatVersion_  = 3;
+
+
+/* ----- Serialization ----- */
+
+static void WriteUInt8(std::ostream& stream, std::uint8_t value)
+{
+    const char byte = static_cast<char>(value);
+    stream.write(&byte, 1);
+}
+
+static void WriteUInt16(std::ostream& stream, std::uint16_t value)
+{
+    char bytes[2] = { static_cast<char>(value & 0xff), static_cast<char>((value >> 8) & 0xff) };
+    stream.write(bytes, 2);
+}
+
+static void WriteUInt32(std::ostream& stream, std::uint32_t value)
+{
+    char bytes[4] =
+    {
+        static_cast<char>( value         & 0xff),
+        static_cast<char>((value >>  8u) & 0xff),
+        static_cast<char>((value >> 16u) & 0xff),
+        static_cast<char>((value >> 24u) & 0xff),
+    };
+    stream.write(bytes, 4);
+}
+
+static void WriteInt32(std::ostream& stream, std::int32_t value)
+{
+    WriteUInt32(stream, static_cast<std::uint32_t>(value));
+}
+
+static void WriteString(std::ostream& stream, const std::string& s)
+{
+    WriteUInt16(stream, static_cast<std::uint16_t>(s.size()));
+    stream.write(s.data(), static_cast<std::streamsize>(s.size()));
+}
+
+void SerializeReflection(const ReflectionData& reflection, std::ostream& stream)
+{
+    /* Write header */
+    stream.write(magicNumber_, 4);
+    WriteUInt16(stream, formatVersion_);
+
+    /* Write constant buffers */
+    WriteUInt32(stream, static_cast<std::uint32_t>(reflection.constantBuffers.size()));
+    for (const auto& constantBuffer : reflection.constantBuffers)
+    {
+        WriteString(stream, constantBuffer.name);
+        WriteInt32(stream, constantBuffer.binding);
+
+        WriteUInt32(stream, static_cast<std::uint32_t>(constantBuffer.fields.size()));
+        for (const auto& field : constantBuffer.fields)
+        {
+            WriteString(stream, field.name);
+            WriteString(stream, field.type);
+            WriteUInt8(stream, field.referenced ? 1 : 0);
+        }
+    }
+
+    /* Write resources */
+    WriteUInt32(stream, static_cast<std::uint32_t>(reflection.resources.size()));
+    for (const auto& resource : reflection.resources)
+    {
+        WriteString(stream, resource.name);
+        WriteString(stream, resource.type);
+        WriteInt32(stream, resource.binding);
+    }
+
+    /* Write samplers */
+    WriteUInt32(stream, static_cast<std::uint32_t>(reflection.samplers.size()));
+    for (const auto& sampler : reflection.samplers)
+    {
+        WriteString(stream, sampler.name);
+        WriteInt32(stream, sampler.binding);
+    }
+
+    /* Write input and output attributes */
+    for (const auto attributes : { &reflection.inputAttributes, &reflection.outputAttributes })
+    {
+        WriteUInt32(stream, static_cast<std::uint32_t>(attributes->size()));
+        for (const auto& attrib : *attributes)
+        {
+            WriteString(stream, attrib.name);
+            WriteString(stream, attrib.type);
+            WriteString(stream, attrib.semantic);
+        }
+    }
+
+    /* Write function costs */
+    WriteUInt32(stream, static_cast<std::uint32_t>(reflection.functionCosts.size()));
+    for (const auto& cost : reflection.functionCosts)
+    {
+        WriteString(stream, cost.name);
+        WriteUInt8(stream, cost.entryPoint ? 1 : 0);
+        WriteUInt32(stream, static_cast<std::uint32_t>(cost.numAluOps));
+        WriteUInt32(stream, static_cast<std::uint32_t>(cost.numTranscendentalOps));
+        WriteUInt32(stream, static_cast<std::uint32_t>(cost.numTextureFetches));
+        WriteUInt32(stream, static_cast<std::uint32_t>(cost.numBranches));
+        WriteUInt32(stream, static_cast<std::uint32_t>(cost.maxLoopDepth));
+        WriteUInt32(stream, static_cast<std::uint32_t>(cost.totalCost));
+    }
+}
+
+
+/* ----- Deserialization ----- */
+
+static bool ReadUInt8(std::istream& stream, std::uint8_t& value)
+{
+    char byte = 0;
+    stream.read(&byte, 1);
+    value = static_cast<std::uint8_t>(byte);
+    return stream.good();
+}
+
+static bool ReadUInt16(std::istream& stream, std::uint16_t& value)
+{
+    char bytes[2];
+    stream.read(bytes, 2);
+    value = static_cast<std::uint16_t>(
+        (static_cast<std::uint16_t>(static_cast<unsigned char>(bytes[0]))) |
+        (static_cast<std::uint16_t>(static_cast<unsigned char>(bytes[1])) << 8u)
+    );
+    return stream.good();
+}
+
+static bool ReadUInt32(std::istream& stream, std::uint32_t& value)
+{
+    char bytes[4];
+    stream.read(bytes, 4);
+    value =
+        ( static_cast<std::uint32_t>(static_cast<unsigned char>(bytes[0]))        ) |
+        ( static_cast<std::uint32_t>(static_cast<unsigned char>(bytes[1])) <<  8u ) |
+        ( static_cast<std::uint32_t>(static_cast<unsigned char>(bytes[2])) << 16u ) |
+        ( static_cast<std::uint32_t>(static_cast<unsigned char>(bytes[3])) << 24u );
+    return stream.good();
+}
+
+static bool ReadInt32(std::istream& stream, int& value)
+{
+    std::uint32_t u = 0;
+    if (!ReadUInt32(stream, u))
+        return false;
+    value = static_cast<std::int32_t>(u);
+    return true;
+}
+
+static bool ReadString(std::istream& stream, std::string& s)
+{
+    std::uint16_t length = 0;
+    if (!ReadUInt16(stream, length))
+        return false;
+
+    s.resize(length);
+    if (length > 0)
+        stream.read(&s[0], length);
+
+    return stream.good();
+}
+
+bool DeserializeReflection(std::istream& stream, ReflectionData& reflection)
+{
+    reflection = ReflectionData();
+
+    /* Read and verify header */
+    char magic[4];
+    stream.read(magic, 4);
+
+    if (!stream.good() || std::string(magic, 4) != magicNumber_)
+        return false;
+
+    std::uint16_t version = 0;
+    if (!ReadUInt16(stream, version) || version != formatVersion_)
+        return false;
+
+    /* Read constant buffers */
+    std::uint32_t count = 0;
+    if (!ReadUInt32(stream, count))
+        return false;
+
+    reflection.constantBuffers.resize(count);
+    for (auto& constantBuffer : reflection.constantBuffers)
+    {
+        if (!ReadString(stream, constantBuffer.name) || !ReadInt32(stream, constantBuffer.binding))
+            return false;
+
+        std::uint32_t numFields = 0;
+        if (!ReadUInt32(stream, numFields))
+            return false;
+
+        constantBuffer.fields.resize(numFields);
+        for (auto& field : constantBuffer.fields)
+        {
+            std::uint8_t referenced = 0;
+            if (!ReadString(stream, field.name) || !ReadString(stream, field.type) || !ReadUInt8(stream, referenced))
+                return false;
+            field.referenced = (referenced != 0);
+        }
+    }
+
+    /* Read resources */
+    if (!ReadUInt32(stream, count))
+        return false;
+
+    reflection.resources.resize(count);
+    for (auto& resource : reflection.resources)
+    {
+        if (!ReadString(stream, resource.name) || !ReadString(stream, resource.type) || !ReadInt32(stream, resource.binding))
+            return false;
+    }
+
+    /* Read samplers */
+    if (!ReadUInt32(stream, count))
+        return false;
+
+    reflection.samplers.resize(count);
+    for (auto& sampler : reflection.samplers)
+    {
+        if (!ReadString(stream, sampler.name) || !ReadInt32(stream, sampler.binding))
+            return false;
+    }
+
+    /* Read input and output attributes */
+    for (auto attributes : { &reflection.inputAttributes, &reflection.outputAttributes })
+    {
+        if (!ReadUInt32(stream, count))
+            return false;
+
+        attributes->resize(count);
+        for (auto& attrib : *attributes)
+        {
+            if (!ReadString(stream, attrib.name) || !ReadString(stream, attrib.type) || !ReadString(stream, attrib.semantic))
+                return false;
+        }
+    }
+
+    /* Read function costs */
+    if (!ReadUInt32(stream, count))
+        return false;
+
+    reflection.functionCosts.resize(count);
+    for (auto& cost : reflection.functionCosts)
+    {
+        std::uint8_t entryPoint = 0;
+        if (!ReadString(stream, cost.name) || !ReadUInt8(stream, entryPoint))
+            return false;
+        cost.entryPoint = (entryPoint != 0);
+
+        std::uint32_t values[6] = { 0, 0, 0, 0, 0, 0 };
+        for (auto& value : values)
+        {
+            if (!ReadUInt32(stream, value))
+                return false;
+        }
+
+        cost.numAluOps            = values[0];
+        cost.numTranscendentalOps = values[1];
+        cost.numTextureFetches    = values[2];
+        cost.numBranches          = values[3];
+        cost.maxLoopDepth         = values[4];
+        cost.totalCost            = values[5];
+    }
+
+    return true;
+}
+
+
+} // /namespace Reflection
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
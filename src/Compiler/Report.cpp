@@ -12,6 +12,19 @@ namespace Xsc
 {
 
 
+/*
+ * ReportLineMarker class
+ */
+
+ReportLineMarker::~ReportLineMarker()
+{
+}
+
+
+/*
+ * Report class
+ */
+
 Report::Report(const Types type, const std::string& message, const std::string& context) :
     type_   { type    },
     context_{ context },
@@ -31,6 +44,14 @@ Report::Report(const Types type, const std::string& message, const std::string&
         line_.pop_back();
 }
 
+Report::Report(const Types type, const std::string& message, const std::shared_ptr<ReportLineMarker>& lineMarker, const std::string& context) :
+    type_       { type       },
+    context_    { context    },
+    message_    { message    },
+    lineMarker_ { lineMarker }
+{
+}
+
 const char* Report::what() const throw()
 {
     return message_.c_str();
@@ -41,6 +62,47 @@ void Report::TakeHints(std::vector<std::string>&& hints)
     hints_ = std::move(hints);
 }
 
+const std::string& Report::Line() const
+{
+    ResolveLineMarker();
+    return line_;
+}
+
+const std::string& Report::Marker() const
+{
+    ResolveLineMarker();
+    return marker_;
+}
+
+bool Report::HasLine() const
+{
+    ResolveLineMarker();
+    return (!line_.empty());
+}
+
+
+/*
+ * ======= Private: =======
+ */
+
+void Report::ResolveLineMarker() const
+{
+    if (lineMarker_)
+    {
+        std::string line, marker;
+        if (lineMarker_->FetchLineMarker(line, marker))
+        {
+            line_   = std::move(line);
+            marker_ = std::move(marker);
+
+            /* Remove new-line characters from end of source line */
+            while ( !line_.empty() && ( line_.back() == '\n' || line_.back() == '\r' ) )
+                line_.pop_back();
+        }
+        lineMarker_.reset();
+    }
+}
+
 
 } // /namespace Xsc
 
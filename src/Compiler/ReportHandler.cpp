@@ -8,6 +8,7 @@
 #include "ReportHandler.h"
 #include "SourceCode.h"
 #include <vector>
+#include <mutex>
 
 
 namespace Xsc
@@ -25,11 +26,42 @@ ErrorCode::ErrorCode(const HLSLErr errorCode)
 }
 
 
+/*
+ * LazyLineMarker class
+ */
+
+// Fetches the line marker of a report from the source code on first access, retaining the source (see Report::Line).
+class LazyLineMarker : public ReportLineMarker
+{
+
+    public:
+
+        LazyLineMarker(const std::shared_ptr<SourceCode>& sourceCode, const SourceArea& area) :
+            sourceCode_ { sourceCode },
+            area_       { area       }
+        {
+        }
+
+        bool FetchLineMarker(std::string& line, std::string& marker) override
+        {
+            return sourceCode_->FetchLineMarker(area_, line, marker);
+        }
+
+    private:
+
+        std::shared_ptr<SourceCode> sourceCode_;
+        SourceArea                  area_;
+
+};
+
+
 /*
  * ReportHandler class
  */
 
-static std::vector<std::string> g_hintQueue;
+/* Global hint queue with mutex, since reports may be produced on worker threads (e.g. deferred function-body parsing) */
+static std::vector<std::string>  g_hintQueue;
+static std::mutex                g_hintQueueMutex;
 
 ReportHandler::ReportHandler(const std::string& reportTypeName, Log* log) :
     reportTypeName_ { reportTypeName },
@@ -46,16 +78,21 @@ void ReportHandler::Error(
 void ReportHandler::Warning(
     bool breakWithExpection, const std::string& msg, SourceCode* sourceCode, const SourceArea& area, const ErrorCode& errorCode)
 {
-    SubmitReport(breakWithExpection, Report::Types::Warning, "warning", msg, sourceCode, area, errorCode);
+    if (warningsEnabled_)
+        SubmitReport(breakWithExpection, Report::Types::Warning, "warning", msg, sourceCode, area, errorCode);
 }
 
 void ReportHandler::SubmitReport(
     bool breakWithExpection, const Report::Types type, const std::string& typeName,
     const std::string& msg, SourceCode* sourceCode, const SourceArea& area, const ErrorCode& errorCode)
 {
+    /* Drop suppressed warnings before any message formatting */
+    if (type == Report::Types::Warning && !warningsEnabled_)
+        return;
+
     /* Initialize output message */
     auto outputMsg = typeName;
-    
+
     if (type == Report::Types::Error)
         hasErrors_ = true;
 
@@ -80,13 +117,31 @@ void ReportHandler::SubmitReport(
     auto report = MakeReport(type, outputMsg, sourceCode, area);
 
     /* Move hint queue into report */
-    report.TakeHints(std::move(g_hintQueue));
+    {
+        std::lock_guard<std::mutex> guard(g_hintQueueMutex);
+        report.TakeHints(std::move(g_hintQueue));
+    }
 
     /* Either throw or submit report */
     if (breakWithExpection)
         throw report;
     else if (log_)
         log_->SumitReport(report);
+
+    if (type == Report::Types::Error)
+        CountErrorAgainstLimit();
+}
+
+void ReportHandler::SubmitDeferredReport(const Report& report)
+{
+    if (report.Type() == Report::Types::Warning && !warningsEnabled_)
+        return;
+    if (report.Type() == Report::Types::Error)
+        hasErrors_ = true;
+    if (log_)
+        log_->SumitReport(report);
+    if (report.Type() == Report::Types::Error)
+        CountErrorAgainstLimit();
 }
 
 void ReportHandler::PushContextDesc(const std::string& contextDesc)
@@ -101,6 +156,7 @@ void ReportHandler::PopContextDesc()
 
 void ReportHandler::HintForNextReport(const std::string& hint)
 {
+    std::lock_guard<std::mutex> guard(g_hintQueueMutex);
     g_hintQueue.push_back(hint);
 }
 
@@ -109,6 +165,17 @@ void ReportHandler::HintForNextReport(const std::string& hint)
  * ======= Private: =======
  */
 
+void ReportHandler::CountErrorAgainstLimit()
+{
+    if (errorLimit_ > 0 && numErrors_ < errorLimit_ && ++numErrors_ == errorLimit_)
+    {
+        /* Abort the current pass; further cascading errors would not add information (see ShaderInput::maxErrors) */
+        if (log_)
+            log_->SumitReport(Report(Report::Types::Error, "too many errors; aborting compilation"));
+        throw ErrorLimitAbort();
+    }
+}
+
 Report ReportHandler::MakeReport(
     const Report::Types type, const std::string& msg, SourceCode* sourceCode, const SourceArea& area)
 {
@@ -121,15 +188,9 @@ Report ReportHandler::MakeReport(
         contextDesc += "':";
     }
 
-    /* Make report with parameters */
+    /* Make report with parameters (the line marker is fetched deferred, on first access) */
     if (sourceCode != nullptr && area.Length() > 0)
-    {
-        std::string line, marker;
-        if (sourceCode->FetchLineMarker(area, line, marker))
-            return Report(type, msg, line, marker, contextDesc);
-        else
-            return Report(type, msg, contextDesc);
-    }
+        return Report(type, msg, std::make_shared<LazyLineMarker>(sourceCode->shared_from_this(), area), contextDesc);
     else
         return Report(type, msg, contextDesc);
 }
@@ -45,6 +45,15 @@ class ErrorCode
 
 };
 
+/*
+Abort signal thrown when the error limit is hit (see ReportHandler::SetErrorLimit).
+Deliberately not derived from std::exception, so it passes through the local error
+recovery handlers of the passes and unwinds straight to the pass entry point.
+*/
+class ErrorLimitAbort
+{
+};
+
 // Report handler class for simpler error and warning handling.
 class ReportHandler
 {
@@ -79,12 +88,42 @@ class ReportHandler
             const ErrorCode& errorCode = ErrorCode()
         );
 
+        // Submits the specified report that was already produced by another report handler (e.g. on a worker thread).
+        void SubmitDeferredReport(const Report& report);
+
+        // Enables or disables the submission of warning reports. By default enabled.
+        inline void SetWarningsEnabled(bool enabled)
+        {
+            warningsEnabled_ = enabled;
+        }
+
+        /*
+        Returns true if warning reports are submitted.
+        Hot call sites should consult this before formatting a warning message,
+        so suppressed warnings cost a single branch instead of string allocations.
+        */
+        inline bool WarningsEnabled() const
+        {
+            return warningsEnabled_;
+        }
+
         // Returns true if any errors have been submitted.
         inline bool HasErros() const
         {
             return hasErrors_;
         }
 
+        /*
+        Sets the maximum number of error reports. Zero means unlimited (the default).
+        When the limit is hit, a final "too many errors" report is submitted and an
+        ErrorLimitAbort is thrown, so the current pass stops cleanly instead of
+        analyzing a doomed compile to the end (see ShaderInput::maxErrors).
+        */
+        inline void SetErrorLimit(std::size_t limit)
+        {
+            errorLimit_ = limit;
+        }
+
         // Pushes the specified context description string onto the stack. The top most description will be added to the next report message.
         void PushContextDesc(const std::string& contextDesc);
         void PopContextDesc();
@@ -106,8 +145,15 @@ class ReportHandler
 
         std::string             reportTypeName_;
 
+        // Counts the error and throws the "too many errors" report when the error limit is hit (see SetErrorLimit).
+        void CountErrorAgainstLimit();
+
         Log*                    log_                = nullptr;
         bool                    hasErrors_          = false;
+        bool                    warningsEnabled_    = true;
+
+        std::size_t             errorLimit_         = 0;
+        std::size_t             numErrors_          = 0;
 
         std::stack<std::string> contextDescStack_;
 
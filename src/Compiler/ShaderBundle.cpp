@@ -0,0 +1,382 @@
+/*
+ * ShaderBundle.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Xsc/ShaderBundle.h>
+
+#include "Helper.h"
+
+#include <fstream>
+#include <vector>
+#include <unordered_map>
+#include <cstring>
+
+
+namespace Xsc
+{
+
+
+/*
+Archive layout (native byte order, fixed-width fields, so the index can be read
+directly on a memory-mapped file):
+
+    Header          { u32 magic; u32 numShaders; u32 numBlobs; u32 reserved; }
+    ShaderRecord    { u64 nameOffset; u32 nameSize; u32 codeBlob; u32 reflectionBlob; u32 reserved; }  * numShaders
+    BlobRecord      { u64 offset; u64 size; u64 contentHash; }                                         * numBlobs
+    data section    (entry names, then the deduplicated blob contents)
+
+Shader records are sorted by name (lexicographic, unsigned bytes), so lookups can
+binary search the index. Blob indices refer into the blob table; identical contents
+share one blob across all entries. All offsets are absolute from the archive start.
+*/
+
+// Magic number of shader bundle archives ("XSB1").
+static const std::uint32_t shaderBundleMagic_ = 0x58534231;
+
+// Blob index denoting an absent blob (e.g. an entry without reflection data).
+static const std::uint32_t invalidBlobIndex_ = 0xffffffff;
+
+struct ShaderBundleHeader
+{
+    std::uint32_t magic;
+    std::uint32_t numShaders;
+    std::uint32_t numBlobs;
+    std::uint32_t reserved;
+};
+
+struct ShaderBundleShaderRecord
+{
+    std::uint64_t nameOffset;
+    std::uint32_t nameSize;
+    std::uint32_t codeBlob;
+    std::uint32_t reflectionBlob;
+    std::uint32_t reserved;
+};
+
+struct ShaderBundleBlobRecord
+{
+    std::uint64_t offset;
+    std::uint64_t size;
+    std::uint64_t contentHash;
+};
+
+
+/*
+ * ShaderBundle class
+ */
+
+void ShaderBundle::AddShader(const std::string& name, std::string code, std::string reflection)
+{
+    auto& entry = entries_[name];
+    entry.code       = std::move(code);
+    entry.reflection = std::move(reflection);
+}
+
+bool ShaderBundle::Load(const std::string& filename, bool ignoreMissingFile)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.good())
+        return ignoreMissingFile;
+
+    const std::string content(
+        (std::istreambuf_iterator<char>(file)),
+        std::istreambuf_iterator<char>()
+    );
+
+    ShaderBundleView view;
+    if (!view.Parse(content.data(), content.size()))
+        return false;
+
+    for (std::size_t i = 0; i < view.NumShaders(); ++i)
+    {
+        ShaderBundleView::Shader shader;
+        view.GetShader(i, shader);
+
+        AddShader(
+            std::string(shader.name, shader.nameSize),
+            std::string(shader.code, shader.codeSize),
+            (shader.reflection != nullptr ? std::string(shader.reflection, shader.reflectionSize) : std::string())
+        );
+    }
+
+    return true;
+}
+
+void ShaderBundle::Write(std::ostream& stream) const
+{
+    /* Assign content-addressed blob indices, so identical contents are stored only once */
+    std::vector<const std::string*>                             blobs;
+    std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> blobIndices;
+
+    auto InternBlob = [&](const std::string& content) -> std::uint32_t
+    {
+        const auto hash = HashData(content.data(), content.size());
+
+        auto& candidates = blobIndices[hash];
+        for (auto index : candidates)
+        {
+            /* Compare the contents, so a hash collision never merges different blobs */
+            if (*blobs[index] == content)
+                return index;
+        }
+
+        const auto index = static_cast<std::uint32_t>(blobs.size());
+        blobs.push_back(&content);
+        candidates.push_back(index);
+        return index;
+    };
+
+    std::vector<ShaderBundleShaderRecord> shaderRecords;
+    shaderRecords.reserve(entries_.size());
+
+    for (const auto& entry : entries_)
+    {
+        ShaderBundleShaderRecord record;
+        {
+            record.nameOffset       = 0;
+            record.nameSize         = static_cast<std::uint32_t>(entry.first.size());
+            record.codeBlob         = InternBlob(entry.second.code);
+            record.reflectionBlob   = (entry.second.reflection.empty() ? invalidBlobIndex_ : InternBlob(entry.second.reflection));
+            record.reserved         = 0;
+        }
+        shaderRecords.push_back(record);
+    }
+
+    /* Lay out the data section: entry names first, then the blob contents */
+    auto dataOffset = static_cast<std::uint64_t>(
+        sizeof(ShaderBundleHeader) +
+        sizeof(ShaderBundleShaderRecord) * shaderRecords.size() +
+        sizeof(ShaderBundleBlobRecord) * blobs.size()
+    );
+
+    std::size_t i = 0;
+    for (const auto& entry : entries_)
+    {
+        shaderRecords[i++].nameOffset = dataOffset;
+        dataOffset += entry.first.size();
+    }
+
+    std::vector<ShaderBundleBlobRecord> blobRecords;
+    blobRecords.reserve(blobs.size());
+
+    for (const auto* blob : blobs)
+    {
+        ShaderBundleBlobRecord record;
+        {
+            record.offset       = dataOffset;
+            record.size         = blob->size();
+            record.contentHash  = HashData(blob->data(), blob->size());
+        }
+        blobRecords.push_back(record);
+        dataOffset += blob->size();
+    }
+
+    /* Write header and index */
+    ShaderBundleHeader header;
+    {
+        header.magic        = shaderBundleMagic_;
+        header.numShaders   = static_cast<std::uint32_t>(shaderRecords.size());
+        header.numBlobs     = static_cast<std::uint32_t>(blobRecords.size());
+        header.reserved     = 0;
+    }
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const auto& record : shaderRecords)
+        stream.write(reinterpret_cast<const char*>(&record), sizeof(record));
+
+    for (const auto& record : blobRecords)
+        stream.write(reinterpret_cast<const char*>(&record), sizeof(record));
+
+    /* Write data section in the laid-out order */
+    for (const auto& entry : entries_)
+        stream.write(entry.first.data(), static_cast<std::streamsize>(entry.first.size()));
+
+    for (const auto* blob : blobs)
+        stream.write(blob->data(), static_cast<std::streamsize>(blob->size()));
+}
+
+bool ShaderBundle::Save(const std::string& filename) const
+{
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.good())
+        return false;
+
+    Write(file);
+
+    return file.good();
+}
+
+void ShaderBundle::Clear()
+{
+    entries_.clear();
+}
+
+std::size_t ShaderBundle::NumShaders() const
+{
+    return entries_.size();
+}
+
+bool ShaderBundle::Empty() const
+{
+    return entries_.empty();
+}
+
+
+/*
+ * ShaderBundleView class
+ */
+
+// Returns true if the specified range lies entirely within the parsed buffer.
+static bool InBounds(std::uint64_t offset, std::uint64_t size, std::size_t bufferSize)
+{
+    return (offset <= bufferSize && size <= bufferSize - offset);
+}
+
+bool ShaderBundleView::Parse(const char* data, std::size_t size)
+{
+    data_       = nullptr;
+    size_       = 0;
+    numShaders_ = 0;
+    numBlobs_   = 0;
+
+    if (data == nullptr || size < sizeof(ShaderBundleHeader))
+        return false;
+
+    ShaderBundleHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (header.magic != shaderBundleMagic_)
+        return false;
+
+    /* Validate that the index tables lie within the buffer */
+    const auto indexSize =
+    (
+        sizeof(ShaderBundleHeader) +
+        sizeof(ShaderBundleShaderRecord) * static_cast<std::uint64_t>(header.numShaders) +
+        sizeof(ShaderBundleBlobRecord) * static_cast<std::uint64_t>(header.numBlobs)
+    );
+
+    if (!InBounds(0, indexSize, size))
+        return false;
+
+    data_       = data;
+    size_       = size;
+    numShaders_ = header.numShaders;
+    numBlobs_   = header.numBlobs;
+
+    /* Validate that all records refer into the buffer, so lookups need no further bounds checks */
+    for (std::size_t i = 0; i < numShaders_; ++i)
+    {
+        Shader shader;
+        if (!GetShader(i, shader))
+        {
+            data_ = nullptr;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::size_t ShaderBundleView::NumShaders() const
+{
+    return (data_ != nullptr ? numShaders_ : 0);
+}
+
+// Fetches the blob record with the specified index, or returns false for an invalid index.
+static bool FetchBlobRecord(const char* data, std::uint32_t numShaders, std::uint32_t numBlobs, std::uint32_t index, ShaderBundleBlobRecord& record)
+{
+    if (index >= numBlobs)
+        return false;
+
+    std::memcpy(
+        &record,
+        data + sizeof(ShaderBundleHeader) + sizeof(ShaderBundleShaderRecord) * numShaders + sizeof(ShaderBundleBlobRecord) * index,
+        sizeof(record)
+    );
+
+    return true;
+}
+
+bool ShaderBundleView::GetShader(std::size_t index, Shader& shader) const
+{
+    if (data_ == nullptr || index >= numShaders_)
+        return false;
+
+    ShaderBundleShaderRecord record;
+    std::memcpy(&record, data_ + sizeof(ShaderBundleHeader) + sizeof(record) * index, sizeof(record));
+
+    if (!InBounds(record.nameOffset, record.nameSize, size_))
+        return false;
+
+    ShaderBundleBlobRecord codeBlob;
+    if (!FetchBlobRecord(data_, numShaders_, numBlobs_, record.codeBlob, codeBlob) || !InBounds(codeBlob.offset, codeBlob.size, size_))
+        return false;
+
+    shader.name     = data_ + record.nameOffset;
+    shader.nameSize = record.nameSize;
+    shader.code     = data_ + codeBlob.offset;
+    shader.codeSize = static_cast<std::size_t>(codeBlob.size);
+
+    if (record.reflectionBlob != invalidBlobIndex_)
+    {
+        ShaderBundleBlobRecord reflectionBlob;
+        if (!FetchBlobRecord(data_, numShaders_, numBlobs_, record.reflectionBlob, reflectionBlob) || !InBounds(reflectionBlob.offset, reflectionBlob.size, size_))
+            return false;
+
+        shader.reflection       = data_ + reflectionBlob.offset;
+        shader.reflectionSize   = static_cast<std::size_t>(reflectionBlob.size);
+    }
+    else
+    {
+        shader.reflection       = nullptr;
+        shader.reflectionSize   = 0;
+    }
+
+    return true;
+}
+
+bool ShaderBundleView::FindShader(const std::string& name, Shader& shader) const
+{
+    /* Binary search over the name-sorted shader records */
+    std::size_t first = 0, last = NumShaders();
+
+    while (first < last)
+    {
+        const auto middle = first + (last - first) / 2;
+
+        Shader candidate;
+        if (!GetShader(middle, candidate))
+            return false;
+
+        const auto commonSize = std::min<std::size_t>(candidate.nameSize, name.size());
+        auto order = std::memcmp(candidate.name, name.data(), commonSize);
+
+        if (order == 0)
+        {
+            if (candidate.nameSize == name.size())
+            {
+                shader = candidate;
+                return true;
+            }
+            order = (candidate.nameSize < name.size() ? -1 : 1);
+        }
+
+        if (order < 0)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+
+    return false;
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
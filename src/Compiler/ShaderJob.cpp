@@ -0,0 +1,559 @@
+/*
+ * ShaderJob.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Xsc/ShaderJob.h>
+#include <Xsc/IncludeHandler.h>
+#include <Xsc/Reflection.h>
+
+#include "Helper.h"
+
+#include <sstream>
+#include <cstdint>
+
+
+namespace Xsc
+{
+
+
+/*
+Job and result format (native byte order, version 1):
+
+    u32 magic; u32 version;
+    followed by the fields in declaration order. Strings are u64 size + bytes,
+    lists are u32 count + elements, booleans are one byte, enumerations are u32.
+
+The format is rejected on decode when the magic or version does not match, so a
+worker running an older compiler refuses a newer job instead of misreading it.
+*/
+
+// Magic numbers of serialized jobs ("XSJB") and job results ("XSJR").
+static const std::uint32_t shaderJobMagic_       = 0x58534a42;
+static const std::uint32_t shaderJobResultMagic_ = 0x58534a52;
+
+// Version of the job and result formats.
+static const std::uint32_t shaderJobVersion_     = 1;
+
+// Sanity limits, so a malformed stream is rejected instead of allocating absurd amounts of memory.
+static const std::uint64_t maxJobStringSize_     = 0x40000000; // 1 GiB
+static const std::uint32_t maxJobListCount_      = 0x00100000; // 1M elements
+
+
+/* ----- Encoding primitives ----- */
+
+static void WriteU8(std::ostream& stream, std::uint8_t value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void WriteU32(std::ostream& stream, std::uint32_t value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void WriteU64(std::ostream& stream, std::uint64_t value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void WriteBool(std::ostream& stream, bool value)
+{
+    WriteU8(stream, value ? 1 : 0);
+}
+
+static void WriteString(std::ostream& stream, const std::string& value)
+{
+    WriteU64(stream, value.size());
+    stream.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+static void WriteStringList(std::ostream& stream, const std::vector<std::string>& values)
+{
+    WriteU32(stream, static_cast<std::uint32_t>(values.size()));
+    for (const auto& value : values)
+        WriteString(stream, value);
+}
+
+static void WriteBindingList(std::ostream& stream, const std::vector<Statistics::Binding>& bindings)
+{
+    WriteU32(stream, static_cast<std::uint32_t>(bindings.size()));
+    for (const auto& binding : bindings)
+    {
+        WriteString(stream, binding.ident);
+        WriteU32(stream, static_cast<std::uint32_t>(binding.location));
+    }
+}
+
+
+/* ----- Decoding primitives ----- */
+
+static bool ReadU8(std::istream& stream, std::uint8_t& value)
+{
+    stream.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return stream.good();
+}
+
+static bool ReadU32(std::istream& stream, std::uint32_t& value)
+{
+    stream.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return stream.good();
+}
+
+static bool ReadU64(std::istream& stream, std::uint64_t& value)
+{
+    stream.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return stream.good();
+}
+
+static bool ReadBool(std::istream& stream, bool& value)
+{
+    std::uint8_t byte = 0;
+    if (!ReadU8(stream, byte))
+        return false;
+    value = (byte != 0);
+    return true;
+}
+
+static bool ReadString(std::istream& stream, std::string& value)
+{
+    std::uint64_t size = 0;
+    if (!ReadU64(stream, size) || size > maxJobStringSize_)
+        return false;
+
+    value.resize(static_cast<std::size_t>(size));
+    stream.read(&value[0], static_cast<std::streamsize>(size));
+    return (size == 0 || stream.good());
+}
+
+static bool ReadListCount(std::istream& stream, std::uint32_t& count)
+{
+    return (ReadU32(stream, count) && count <= maxJobListCount_);
+}
+
+static bool ReadStringList(std::istream& stream, std::vector<std::string>& values)
+{
+    std::uint32_t count = 0;
+    if (!ReadListCount(stream, count))
+        return false;
+
+    values.resize(count);
+    for (auto& value : values)
+    {
+        if (!ReadString(stream, value))
+            return false;
+    }
+    return true;
+}
+
+static bool ReadBindingList(std::istream& stream, std::vector<Statistics::Binding>& bindings)
+{
+    std::uint32_t count = 0;
+    if (!ReadListCount(stream, count))
+        return false;
+
+    bindings.resize(count);
+    for (auto& binding : bindings)
+    {
+        std::uint32_t location = 0;
+        if (!ReadString(stream, binding.ident) || !ReadU32(stream, location))
+            return false;
+        binding.location = static_cast<int>(location);
+    }
+    return true;
+}
+
+
+/* ----- Job encoding ----- */
+
+XSC_EXPORT std::uint64_t ShaderJobFingerprint(const ShaderJob& job)
+{
+    /* Chain the source content hash onto the define-set hash, like the compile cache key (see DefineSetFingerprint) */
+    std::uint64_t hash = HashData(nullptr, 0);
+
+    for (const auto& macro : job.predefinedMacros)
+    {
+        hash = HashData(macro.ident.c_str(), macro.ident.size() + 1, hash);
+        hash = HashData(macro.value.c_str(), macro.value.size() + 1, hash);
+    }
+
+    return HashData(job.source.data(), job.source.size(), hash);
+}
+
+XSC_EXPORT void EncodeShaderJob(const ShaderJob& job, std::ostream& stream)
+{
+    WriteU32(stream, shaderJobMagic_);
+    WriteU32(stream, shaderJobVersion_);
+
+    /* Write input settings */
+    WriteString(stream, job.filename);
+    WriteString(stream, job.source);
+    WriteU32(stream, static_cast<std::uint32_t>(job.inputVersion));
+    WriteString(stream, job.entryPoint);
+    WriteU32(stream, static_cast<std::uint32_t>(job.shaderTarget));
+
+    WriteU32(stream, static_cast<std::uint32_t>(job.predefinedMacros.size()));
+    for (const auto& macro : job.predefinedMacros)
+    {
+        WriteString(stream, macro.ident);
+        WriteString(stream, macro.value);
+    }
+
+    WriteStringList(stream, job.searchPaths);
+
+    /* Write output settings */
+    WriteU32(stream, static_cast<std::uint32_t>(job.outputVersion));
+
+    WriteString(stream, job.formatting.indent);
+    WriteString(stream, job.formatting.prefix);
+    WriteBool(stream, job.formatting.blanks);
+    WriteBool(stream, job.formatting.lineMarks);
+    WriteBool(stream, job.formatting.compactWrappers);
+    WriteBool(stream, job.formatting.newLineOpenScope);
+    WriteBool(stream, job.formatting.minify);
+
+    WriteBool(stream, job.options.warnings);
+    WriteBool(stream, job.options.optimize);
+    WriteBool(stream, job.options.preprocessOnly);
+    WriteBool(stream, job.options.validateOnly);
+    WriteBool(stream, job.options.metadataOnly);
+    WriteBool(stream, job.options.allowExtensions);
+    WriteBool(stream, job.options.explicitBinding);
+    WriteBool(stream, job.options.trimUniforms);
+    WriteBool(stream, job.options.preserveComments);
+    WriteBool(stream, job.options.preferWrappers);
+    WriteBool(stream, job.options.deterministicOutput);
+    WriteBool(stream, job.options.showAST);
+    WriteBool(stream, job.options.showTimes);
+
+    /* Write fingerprints */
+    WriteU64(stream, job.sourceFingerprint);
+
+    WriteU32(stream, static_cast<std::uint32_t>(job.includes.size()));
+    for (const auto& ref : job.includes)
+    {
+        WriteString(stream, ref.filename);
+        WriteU64(stream, ref.contentHash);
+        WriteBool(stream, ref.useSearchPathsFirst);
+    }
+}
+
+XSC_EXPORT bool DecodeShaderJob(ShaderJob& job, std::istream& stream)
+{
+    std::uint32_t magic = 0, version = 0;
+    if (!ReadU32(stream, magic) || magic != shaderJobMagic_ || !ReadU32(stream, version) || version != shaderJobVersion_)
+        return false;
+
+    std::uint32_t inputVersion = 0, shaderTarget = 0, outputVersion = 0, count = 0;
+
+    /* Read input settings */
+    if (!ReadString(stream, job.filename) || !ReadString(stream, job.source) || !ReadU32(stream, inputVersion))
+        return false;
+    if (!ReadString(stream, job.entryPoint) || !ReadU32(stream, shaderTarget))
+        return false;
+
+    job.inputVersion = static_cast<InputShaderVersion>(inputVersion);
+    job.shaderTarget = static_cast<ShaderTarget>(shaderTarget);
+
+    if (!ReadListCount(stream, count))
+        return false;
+
+    job.predefinedMacros.resize(count);
+    for (auto& macro : job.predefinedMacros)
+    {
+        if (!ReadString(stream, macro.ident) || !ReadString(stream, macro.value))
+            return false;
+    }
+
+    if (!ReadStringList(stream, job.searchPaths))
+        return false;
+
+    /* Read output settings */
+    if (!ReadU32(stream, outputVersion))
+        return false;
+
+    job.outputVersion = static_cast<OutputShaderVersion>(outputVersion);
+
+    if (!ReadString(stream, job.formatting.indent) || !ReadString(stream, job.formatting.prefix))
+        return false;
+
+    if ( !ReadBool(stream, job.formatting.blanks          ) ||
+         !ReadBool(stream, job.formatting.lineMarks       ) ||
+         !ReadBool(stream, job.formatting.compactWrappers ) ||
+         !ReadBool(stream, job.formatting.newLineOpenScope) ||
+         !ReadBool(stream, job.formatting.minify          ) )
+    {
+        return false;
+    }
+
+    if ( !ReadBool(stream, job.options.warnings           ) ||
+         !ReadBool(stream, job.options.optimize           ) ||
+         !ReadBool(stream, job.options.preprocessOnly     ) ||
+         !ReadBool(stream, job.options.validateOnly       ) ||
+         !ReadBool(stream, job.options.metadataOnly       ) ||
+         !ReadBool(stream, job.options.allowExtensions    ) ||
+         !ReadBool(stream, job.options.explicitBinding    ) ||
+         !ReadBool(stream, job.options.trimUniforms       ) ||
+         !ReadBool(stream, job.options.preserveComments   ) ||
+         !ReadBool(stream, job.options.preferWrappers     ) ||
+         !ReadBool(stream, job.options.deterministicOutput) ||
+         !ReadBool(stream, job.options.showAST            ) ||
+         !ReadBool(stream, job.options.showTimes          ) )
+    {
+        return false;
+    }
+
+    /* Read fingerprints */
+    if (!ReadU64(stream, job.sourceFingerprint) || !ReadListCount(stream, count))
+        return false;
+
+    job.includes.resize(count);
+    for (auto& ref : job.includes)
+    {
+        if (!ReadString(stream, ref.filename) || !ReadU64(stream, ref.contentHash) || !ReadBool(stream, ref.useSearchPathsFirst))
+            return false;
+    }
+
+    return true;
+}
+
+
+/* ----- Result encoding ----- */
+
+XSC_EXPORT void EncodeShaderJobResult(const ShaderJobResult& result, std::ostream& stream)
+{
+    WriteU32(stream, shaderJobResultMagic_);
+    WriteU32(stream, shaderJobVersion_);
+
+    WriteBool(stream, result.succeeded);
+    WriteString(stream, result.code);
+    WriteString(stream, result.reflection);
+
+    /* Write reports with their resolved line markers */
+    WriteU32(stream, static_cast<std::uint32_t>(result.reports.size()));
+    for (const auto& report : result.reports)
+    {
+        WriteU8(stream, static_cast<std::uint8_t>(report.Type()));
+        WriteString(stream, report.Context());
+        WriteString(stream, report.Message());
+        WriteBool(stream, report.HasLine());
+        if (report.HasLine())
+        {
+            WriteString(stream, report.Line());
+            WriteString(stream, report.Marker());
+        }
+        WriteStringList(stream, report.GetHints());
+    }
+
+    /* Write statistics (static sampler states are not transported) */
+    WriteStringList(stream, result.statistics.macros);
+    WriteBindingList(stream, result.statistics.textures);
+    WriteBindingList(stream, result.statistics.constantBuffers);
+    WriteBindingList(stream, result.statistics.fragmentTargets);
+    WriteStringList(stream, result.statistics.techniques);
+    WriteStringList(stream, result.statistics.entryPoints);
+    WriteU64(stream, result.statistics.estimatedOutputSize);
+    WriteU64(stream, result.statistics.actualOutputSize);
+}
+
+XSC_EXPORT bool DecodeShaderJobResult(ShaderJobResult& result, std::istream& stream)
+{
+    std::uint32_t magic = 0, version = 0;
+    if (!ReadU32(stream, magic) || magic != shaderJobResultMagic_ || !ReadU32(stream, version) || version != shaderJobVersion_)
+        return false;
+
+    if (!ReadBool(stream, result.succeeded) || !ReadString(stream, result.code) || !ReadString(stream, result.reflection))
+        return false;
+
+    /* Read reports */
+    std::uint32_t numReports = 0;
+    if (!ReadListCount(stream, numReports))
+        return false;
+
+    result.reports.clear();
+    result.reports.reserve(numReports);
+
+    for (std::uint32_t i = 0; i < numReports; ++i)
+    {
+        std::uint8_t type = 0;
+        std::string context, message, line, marker;
+        bool hasLine = false;
+        std::vector<std::string> hints;
+
+        if (!ReadU8(stream, type) || !ReadString(stream, context) || !ReadString(stream, message) || !ReadBool(stream, hasLine))
+            return false;
+        if (hasLine && (!ReadString(stream, line) || !ReadString(stream, marker)))
+            return false;
+        if (!ReadStringList(stream, hints))
+            return false;
+
+        auto report = (
+            hasLine
+                ? Report(static_cast<Report::Types>(type), message, line, marker, context)
+                : Report(static_cast<Report::Types>(type), message, context)
+        );
+        report.TakeHints(std::move(hints));
+
+        result.reports.push_back(std::move(report));
+    }
+
+    /* Read statistics */
+    std::uint64_t estimatedOutputSize = 0, actualOutputSize = 0;
+
+    if ( !ReadStringList (stream, result.statistics.macros         ) ||
+         !ReadBindingList(stream, result.statistics.textures       ) ||
+         !ReadBindingList(stream, result.statistics.constantBuffers) ||
+         !ReadBindingList(stream, result.statistics.fragmentTargets) ||
+         !ReadStringList (stream, result.statistics.techniques     ) ||
+         !ReadStringList (stream, result.statistics.entryPoints    ) ||
+         !ReadU64        (stream, estimatedOutputSize              ) ||
+         !ReadU64        (stream, actualOutputSize                 ) )
+    {
+        return false;
+    }
+
+    result.statistics.estimatedOutputSize = static_cast<std::size_t>(estimatedOutputSize);
+    result.statistics.actualOutputSize    = static_cast<std::size_t>(actualOutputSize);
+
+    return true;
+}
+
+
+/* ----- Job execution ----- */
+
+// Log that captures all reports for the job result (with resolved line markers) and forwards them to an optional client log.
+class ShaderJobLog : public Log
+{
+
+    public:
+
+        ShaderJobLog(std::vector<Report>& reports, Log* forwardLog) :
+            reports_    { reports    },
+            forwardLog_ { forwardLog }
+        {
+        }
+
+        void SumitReport(const Report& report) override
+        {
+            /* Resolve the line marker now, so the captured report does not refer into the source code of the job */
+            auto resolved = (
+                report.HasLine()
+                    ? Report(report.Type(), report.Message(), report.Line(), report.Marker(), report.Context())
+                    : Report(report.Type(), report.Message(), report.Context())
+            );
+            resolved.TakeHints(std::vector<std::string>(report.GetHints()));
+
+            reports_.push_back(std::move(resolved));
+
+            if (forwardLog_ != nullptr)
+                forwardLog_->SumitReport(report);
+        }
+
+    private:
+
+        std::vector<Report>&    reports_;
+        Log*                    forwardLog_;
+
+};
+
+XSC_EXPORT bool ExecuteShaderJob(const ShaderJob& job, ShaderJobResult& result, Log* log)
+{
+    result = ShaderJobResult();
+
+    ShaderJobLog jobLog(result.reports, log);
+
+    auto SubmitError = [&](const std::string& msg)
+    {
+        jobLog.SumitReport(Report(Report::Types::Error, msg));
+    };
+
+    /* Validate the source fingerprint (when filled in), so a corrupted job fails before any compilation stage runs */
+    if (job.sourceFingerprint != 0 && ShaderJobFingerprint(job) != job.sourceFingerprint)
+    {
+        SubmitError("source fingerprint mismatch in shader job \"" + job.filename + "\"");
+        return false;
+    }
+
+    IncludeHandler includeHandler;
+    includeHandler.searchPaths = job.searchPaths;
+
+    /* Validate the include closure against the local include tree (when filled in) */
+    for (const auto& ref : job.includes)
+    {
+        try
+        {
+            auto stream = includeHandler.Include(ref.filename, ref.useSearchPathsFirst);
+
+            const std::string content(
+                (std::istreambuf_iterator<char>(*stream)),
+                std::istreambuf_iterator<char>()
+            );
+
+            if (HashData(content.data(), content.size()) != ref.contentHash)
+            {
+                SubmitError("include file \"" + ref.filename + "\" does not match the fingerprint of shader job \"" + job.filename + "\"");
+                return false;
+            }
+        }
+        catch (const std::exception&)
+        {
+            SubmitError("failed to read include file: \"" + ref.filename + "\"");
+            return false;
+        }
+    }
+
+    /* Initialize input and output descriptors from the job */
+    ShaderInput inputDesc;
+    {
+        inputDesc.filename              = job.filename;
+        inputDesc.sourceCodeBuffer      = job.source.data();
+        inputDesc.sourceCodeBufferSize  = job.source.size();
+        inputDesc.shaderVersion         = job.inputVersion;
+        inputDesc.entryPoint            = job.entryPoint;
+        inputDesc.shaderTarget          = job.shaderTarget;
+        inputDesc.includeHandler        = &includeHandler;
+        inputDesc.predefinedMacros      = job.predefinedMacros;
+    }
+
+    Reflection::ReflectionData reflection;
+    const auto captureReflection = (!job.options.preprocessOnly && !job.options.validateOnly && !job.options.metadataOnly);
+
+    ShaderOutput outputDesc;
+    {
+        outputDesc.sourceCodeString = &result.code;
+        outputDesc.shaderVersion    = job.outputVersion;
+        outputDesc.formatting       = job.formatting;
+        outputDesc.options          = job.options;
+        outputDesc.statistics       = &result.statistics;
+        outputDesc.reflectionData   = (captureReflection ? &reflection : nullptr);
+    }
+
+    try
+    {
+        result.succeeded = CompileShader(inputDesc, outputDesc, &jobLog);
+    }
+    catch (const std::exception& err)
+    {
+        SubmitError(err.what());
+        return false;
+    }
+
+    /* Serialize the reflection data into the result blob */
+    if (result.succeeded && captureReflection)
+    {
+        std::stringstream reflectionStream;
+        Reflection::SerializeReflection(reflection, reflectionStream);
+        result.reflection = reflectionStream.str();
+    }
+
+    return result.succeeded;
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
@@ -1,26 +1,404 @@
 /*
  * SourceCode.cpp
- * 
+ *
  * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
  * See "LICENSE.txt" for license information.
  */
 
 #include "SourceCode.h"
+#include "FileMapping.h"
+#include "IncludeCache.h"
+#include "CpuFeatures.h"
 #include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iterator>
 
 
 namespace Xsc
 {
 
 
+/*
+ * ----- Character-run kernels -----
+ *
+ * The scanners spend a large fraction of the compile time skipping white spaces and collecting
+ * identifier, number, and comment runs one character at a time. The following kernels classify
+ * 16 characters at once with SSE2 where available (with a scalar fallback otherwise), and return
+ * the length of the matching run at the front of the specified character range.
+ *
+ * On top of the compile-time SSE2 baseline, AVX2 variants (32 characters at once) are selected
+ * at startup through a function-pointer table against the detected CPU features, so one shipped
+ * binary takes the fastest lexing path on every machine (see CpuFeatures).
+ */
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define XSC_CHAR_RUN_KERNELS_SSE2
+#endif
+
+/*
+The AVX2 variants are compiled wherever the compiler can emit AVX2 instructions for individual
+functions (per-function target attribute on GCC/Clang, always on MSVC), independently of the
+architecture flags of the build; they are only called when the executing CPU reports AVX2.
+*/
+#ifdef XSC_CHAR_RUN_KERNELS_SSE2
+#   if defined(__AVX2__) || defined(_MSC_VER)
+#       define XSC_CHAR_RUN_KERNELS_AVX2
+#       define XSC_AVX2_KERNEL
+#   elif defined(__GNUC__) || defined(__clang__)
+#       define XSC_CHAR_RUN_KERNELS_AVX2
+#       define XSC_AVX2_KERNEL __attribute__((target("avx2")))
+#   endif
+#endif
+
+#ifdef XSC_CHAR_RUN_KERNELS_AVX2
+
+#include <immintrin.h>
+
+#elif defined XSC_CHAR_RUN_KERNELS_SSE2
+
+#include <emmintrin.h>
+
+#endif
+
+#ifdef XSC_CHAR_RUN_KERNELS_SSE2
+
+// Returns the index of the first zero bit in the 16-bit match mask.
+static std::size_t FirstZeroBitIndex(unsigned int mask)
+{
+    std::size_t i = 0;
+    while ((mask & 1u) != 0)
+    {
+        mask >>= 1u;
+        ++i;
+    }
+    return i;
+}
+
+// Returns the match mask of all characters within the specified (inclusive) character range.
+static inline __m128i MatchCharRange(const __m128i& chars, char low, char high)
+{
+    return _mm_and_si128(
+        _mm_cmpgt_epi8(chars, _mm_set1_epi8(low - 1)),
+        _mm_cmpgt_epi8(_mm_set1_epi8(high + 1), chars)
+    );
+}
+
+#endif
+
+// Kernel for white spaces, except new-line characters (which terminate the current line).
+static std::size_t WhiteSpaceRunLength(const char* data, std::size_t size)
+{
+    std::size_t i = 0;
+
+    #ifdef XSC_CHAR_RUN_KERNELS_SSE2
+
+    while (i + 16 <= size)
+    {
+        const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+        auto match = _mm_or_si128(
+            _mm_cmpeq_epi8(chars, _mm_set1_epi8(' ')),
+            _mm_cmpeq_epi8(chars, _mm_set1_epi8('\t'))
+        );
+        match = _mm_or_si128(match, _mm_cmpeq_epi8(chars, _mm_set1_epi8('\v')));
+        match = _mm_or_si128(match, _mm_cmpeq_epi8(chars, _mm_set1_epi8('\f')));
+
+        const auto mask = static_cast<unsigned int>(_mm_movemask_epi8(match));
+        if (mask != 0xFFFF)
+            return i + FirstZeroBitIndex(mask);
+
+        i += 16;
+    }
+
+    #endif
+
+    while (i < size && ( data[i] == ' ' || data[i] == '\t' || data[i] == '\v' || data[i] == '\f' ))
+        ++i;
+
+    return i;
+}
+
+// Kernel for identifier characters (i.e. alphanumeric or '_').
+static std::size_t IdentifierRunLength(const char* data, std::size_t size)
+{
+    std::size_t i = 0;
+
+    #ifdef XSC_CHAR_RUN_KERNELS_SSE2
+
+    while (i + 16 <= size)
+    {
+        const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+        auto match = _mm_or_si128(
+            MatchCharRange(chars, '0', '9'),
+            _mm_or_si128(MatchCharRange(chars, 'A', 'Z'), MatchCharRange(chars, 'a', 'z'))
+        );
+        match = _mm_or_si128(match, _mm_cmpeq_epi8(chars, _mm_set1_epi8('_')));
+
+        const auto mask = static_cast<unsigned int>(_mm_movemask_epi8(match));
+        if (mask != 0xFFFF)
+            return i + FirstZeroBitIndex(mask);
+
+        i += 16;
+    }
+
+    #endif
+
+    while (i < size && ( std::isalnum(static_cast<unsigned char>(data[i])) || data[i] == '_' ))
+        ++i;
+
+    return i;
+}
+
+// Kernel for decimal digits.
+static std::size_t DigitRunLength(const char* data, std::size_t size)
+{
+    std::size_t i = 0;
+
+    #ifdef XSC_CHAR_RUN_KERNELS_SSE2
+
+    while (i + 16 <= size)
+    {
+        const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+        const auto mask = static_cast<unsigned int>(_mm_movemask_epi8(MatchCharRange(chars, '0', '9')));
+        if (mask != 0xFFFF)
+            return i + FirstZeroBitIndex(mask);
+
+        i += 16;
+    }
+
+    #endif
+
+    while (i < size && std::isdigit(static_cast<unsigned char>(data[i])))
+        ++i;
+
+    return i;
+}
+
+// Kernel for a comment line tail, i.e. all characters up to the next new-line character.
+static std::size_t CommentLineRunLength(const char* data, std::size_t size)
+{
+    auto newLine = reinterpret_cast<const char*>(std::memchr(data, '\n', size));
+    return (newLine != nullptr ? static_cast<std::size_t>(newLine - data) : size);
+}
+
+// Kernel for a comment block tail, i.e. all characters up to the next '*' character (a potential block ending).
+static std::size_t CommentBlockRunLength(const char* data, std::size_t size)
+{
+    std::size_t i = 0;
+
+    #ifdef XSC_CHAR_RUN_KERNELS_SSE2
+
+    while (i + 16 <= size)
+    {
+        const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+        const auto mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8('*'))));
+        if (mask != 0)
+            return i + FirstZeroBitIndex(~mask & 0xFFFF);
+
+        i += 16;
+    }
+
+    #endif
+
+    while (i < size && data[i] != '*')
+        ++i;
+
+    return i;
+}
+
+#ifdef XSC_CHAR_RUN_KERNELS_AVX2
+
+// Returns the match mask of all characters within the specified (inclusive) character range.
+static inline XSC_AVX2_KERNEL __m256i MatchCharRange256(const __m256i& chars, char low, char high)
+{
+    return _mm256_and_si256(
+        _mm256_cmpgt_epi8(chars, _mm256_set1_epi8(low - 1)),
+        _mm256_cmpgt_epi8(_mm256_set1_epi8(high + 1), chars)
+    );
+}
+
+// AVX2 variant of WhiteSpaceRunLength (32 characters at once; the tail runs through the baseline kernel).
+static XSC_AVX2_KERNEL std::size_t WhiteSpaceRunLengthAVX2(const char* data, std::size_t size)
+{
+    std::size_t i = 0;
+
+    while (i + 32 <= size)
+    {
+        const auto chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+
+        auto match = _mm256_or_si256(
+            _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(' ')),
+            _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('\t'))
+        );
+        match = _mm256_or_si256(match, _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('\v')));
+        match = _mm256_or_si256(match, _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('\f')));
+
+        const auto mask = static_cast<unsigned int>(_mm256_movemask_epi8(match));
+        if (mask != 0xFFFFFFFFu)
+            return i + FirstZeroBitIndex(mask);
+
+        i += 32;
+    }
+
+    return i + WhiteSpaceRunLength(data + i, size - i);
+}
+
+// AVX2 variant of IdentifierRunLength (32 characters at once; the tail runs through the baseline kernel).
+static XSC_AVX2_KERNEL std::size_t IdentifierRunLengthAVX2(const char* data, std::size_t size)
+{
+    std::size_t i = 0;
+
+    while (i + 32 <= size)
+    {
+        const auto chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+
+        auto match = _mm256_or_si256(
+            MatchCharRange256(chars, '0', '9'),
+            _mm256_or_si256(MatchCharRange256(chars, 'A', 'Z'), MatchCharRange256(chars, 'a', 'z'))
+        );
+        match = _mm256_or_si256(match, _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('_')));
+
+        const auto mask = static_cast<unsigned int>(_mm256_movemask_epi8(match));
+        if (mask != 0xFFFFFFFFu)
+            return i + FirstZeroBitIndex(mask);
+
+        i += 32;
+    }
+
+    return i + IdentifierRunLength(data + i, size - i);
+}
+
+// AVX2 variant of DigitRunLength (32 characters at once; the tail runs through the baseline kernel).
+static XSC_AVX2_KERNEL std::size_t DigitRunLengthAVX2(const char* data, std::size_t size)
+{
+    std::size_t i = 0;
+
+    while (i + 32 <= size)
+    {
+        const auto chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+
+        const auto mask = static_cast<unsigned int>(_mm256_movemask_epi8(MatchCharRange256(chars, '0', '9')));
+        if (mask != 0xFFFFFFFFu)
+            return i + FirstZeroBitIndex(mask);
+
+        i += 32;
+    }
+
+    return i + DigitRunLength(data + i, size - i);
+}
+
+// AVX2 variant of CommentBlockRunLength (32 characters at once; the tail runs through the baseline kernel).
+static XSC_AVX2_KERNEL std::size_t CommentBlockRunLengthAVX2(const char* data, std::size_t size)
+{
+    std::size_t i = 0;
+
+    while (i + 32 <= size)
+    {
+        const auto chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+
+        const auto mask = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8('*'))));
+        if (mask != 0)
+            return i + FirstZeroBitIndex(~mask);
+
+        i += 32;
+    }
+
+    return i + CommentBlockRunLength(data + i, size - i);
+}
+
+#endif
+
+/* ----- Character-run kernel dispatch ----- */
+
+using CharRunKernel = std::size_t (*)(const char* data, std::size_t size);
+
+// Function-pointer table of the selected character-run kernels (see CpuFeatures).
+struct CharRunKernels
+{
+    CharRunKernel whiteSpace;
+    CharRunKernel identifier;
+    CharRunKernel digit;
+    CharRunKernel commentLine;
+    CharRunKernel commentBlock;
+};
+
+static CharRunKernels SelectCharRunKernels()
+{
+    CharRunKernels kernels =
+    {
+        WhiteSpaceRunLength,
+        IdentifierRunLength,
+        DigitRunLength,
+        CommentLineRunLength,
+        CommentBlockRunLength,
+    };
+
+    #ifdef XSC_CHAR_RUN_KERNELS_AVX2
+
+    if (QueryCpuFeatures().avx2)
+    {
+        kernels.whiteSpace   = WhiteSpaceRunLengthAVX2;
+        kernels.identifier   = IdentifierRunLengthAVX2;
+        kernels.digit        = DigitRunLengthAVX2;
+        kernels.commentBlock = CommentBlockRunLengthAVX2;
+    }
+
+    #endif
+
+    return kernels;
+}
+
+// Selected once at startup, so every compile thread reads the same immutable table.
+static const CharRunKernels charRunKernels_ = SelectCharRunKernels();
+
+
 SourceCode::SourceCode(const std::shared_ptr<std::istream>& stream) :
     stream_{ stream }
 {
+    if (stream_ != nullptr && stream_->good())
+    {
+        if (auto mappedStream = dynamic_cast<FileMappingStream*>(stream_.get()))
+        {
+            /* Borrow mapped file content directly (the stream keeps the mapping alive) */
+            data_ = mappedStream->GetMapping().Data();
+            size_ = mappedStream->GetMapping().Size();
+        }
+        else if (auto cachedStream = dynamic_cast<IncludeCacheStream*>(stream_.get()))
+        {
+            /* Borrow cached file content directly (the stream keeps the content alive) */
+            data_ = cachedStream->Content().data();
+            size_ = cachedStream->Content().size();
+
+            /* The include cache retains the content for the process lifetime, so token spelling views remain valid */
+            persistentBuffer_ = true;
+        }
+        else
+        {
+            /* Read entire stream into the contiguous source buffer */
+            content_.assign(std::istreambuf_iterator<char>(*stream_), std::istreambuf_iterator<char>());
+            data_ = content_.data();
+            size_ = content_.size();
+        }
+    }
+    else
+        exhausted_ = true;
+}
+
+SourceCode::SourceCode(const char* sourceBuffer, std::size_t bufferSize) :
+    data_{ sourceBuffer },
+    size_{ bufferSize   }
+{
+    if (data_ == nullptr)
+        exhausted_ = true;
 }
 
 bool SourceCode::IsValid() const
 {
-    return (stream_ != nullptr && stream_->good());
+    return (!exhausted_);
 }
 
 char SourceCode::Next()
@@ -29,23 +407,15 @@ char SourceCode::Next()
         return 0;
 
     /* Check if reader is at end-of-line */
-    while (pos_.Column() >= currentLine_.size())
+    while (pos_.Column() >= lineEnd_ - lineStart_)
     {
-        /* Read new line in source file */
-        std::getline(*stream_, currentLine_);
-        currentLine_ += '\n';
-        pos_.IncRow();
-
-        /* Store current line for later reports */
-        lines_.push_back(currentLine_);
-
-        /* Check if end-of-file is reached */
-        if (stream_->eof())
+        /* Scan next line in source buffer */
+        if (!AdvanceLine())
             return 0;
     }
 
     /* Increment column and return current character */
-    auto chr = currentLine_[pos_.Column()];
+    auto chr = data_[lineStart_ + pos_.Column()];
     pos_.IncColumn();
 
     return chr;
@@ -101,14 +471,126 @@ bool SourceCode::FetchLineMarker(const SourceArea& area, std::string& line, std:
     return false;
 }
 
-void SourceCode::NextSourceOrigin(const std::string& filename, int lineOffset)
+bool SourceCode::FetchText(const SourceArea& area, std::string& text) const
+{
+    if (!area.IsValid() || data_ == nullptr)
+        return false;
+
+    /* Map the area position onto the contiguous source buffer (via the line-offset index) */
+    const auto& pos = area.Pos();
+    if (pos.Row() == 0 || pos.Column() == 0)
+        return false;
+
+    auto rowIndex = static_cast<std::size_t>(pos.Row()) - 1;
+    if (rowIndex >= lineOffsets_.size())
+        return false;
+
+    auto start  = lineOffsets_[rowIndex] + (pos.Column() - 1);
+    auto length = static_cast<std::size_t>(area.Length());
+
+    /* Reject areas which exceed the buffer (e.g. areas spanning multiple lines have an unknown length) */
+    if (start >= size_ || length > size_ - start)
+        return false;
+
+    text.assign(data_ + start, length);
+    return true;
+}
+
+/* ----- Bulk scanning ----- */
+
+char SourceCode::NextAfterWhiteSpaces(std::string* spell)
+{
+    ConsumeRun(charRunKernels_.whiteSpace, spell);
+    return Next();
+}
+
+char SourceCode::NextAfterIdentifierTail(std::string& spell)
 {
-    auto origin = std::make_shared<SourceOrigin>();
+    ConsumeRun(charRunKernels_.identifier, &spell);
+    return Next();
+}
+
+char SourceCode::NextAfterDigitTail(std::string& spell)
+{
+    ConsumeRun(charRunKernels_.digit, &spell);
+    return Next();
+}
+
+char SourceCode::NextAfterCommentLineTail(std::string& spell)
+{
+    ConsumeRun(charRunKernels_.commentLine, &spell);
+    return Next();
+}
+
+char SourceCode::NextAfterCommentBlockTail(std::string& spell)
+{
+    ConsumeRun(charRunKernels_.commentBlock, &spell);
+    return Next();
+}
+
+char SourceCode::NextAfterInactiveCode()
+{
+    if (!IsValid() || exhausted_)
+        return 0;
+
+    /* Start at the most recently returned character (the scanner look-ahead) */
+    auto offset         = OffsetOfLastChar();
+    auto inCommentBlock = false;
+
+    for (;;)
     {
-        origin->filename    = filename;
-        origin->lineOffset  = lineOffset;
+        if (!inCommentBlock)
+        {
+            /* Check for a potential directive line: only white spaces between the line start and a '#' at or behind the start offset */
+            auto i = lineStart_;
+            while (i < lineEnd_ && ( data_[i] == ' ' || data_[i] == '\t' || data_[i] == '\r' ))
+                ++i;
+
+            if (i >= offset && i < lineEnd_ && data_[i] == '#')
+            {
+                /* Consume the '#' character and resume regular scanning behind it */
+                pos_.IncColumn(static_cast<unsigned int>(i + 1 - lineStart_) - pos_.Column());
+                return data_[i];
+            }
+        }
+
+        /* Track block comments in the skipped text, so a '#' inside a comment does not end the skip */
+        for (auto i = offset; i < lineEnd_; ++i)
+        {
+            if (inCommentBlock)
+            {
+                if (data_[i] == '*' && i + 1 < lineEnd_ && data_[i + 1] == '/')
+                {
+                    inCommentBlock = false;
+                    ++i;
+                }
+            }
+            else if (data_[i] == '/' && i + 1 < lineEnd_)
+            {
+                if (data_[i + 1] == '*')
+                {
+                    inCommentBlock = true;
+                    ++i;
+                }
+                else if (data_[i + 1] == '/')
+                {
+                    /* A line comment suppresses the line remainder */
+                    break;
+                }
+            }
+        }
+
+        /* Scan next line in the source buffer */
+        if (!AdvanceLine())
+            return 0;
+
+        offset = lineStart_;
     }
-    pos_.SetOrigin(origin);
+}
+
+void SourceCode::NextSourceOrigin(const std::string& filename, int lineOffset)
+{
+    pos_.SetOrigin(SourceOrigin::Intern(filename, lineOffset));
 }
 
 
@@ -116,9 +598,73 @@ void SourceCode::NextSourceOrigin(const std::string& filename, int lineOffset)
  * ======= Private: =======
  */
 
+void SourceCode::ConsumeRun(std::size_t (*runLength)(const char*, std::size_t), std::string* spell)
+{
+    if (!exhausted_)
+    {
+        const auto col      = static_cast<std::size_t>(pos_.Column());
+        const auto lineSize = lineEnd_ - lineStart_;
+
+        if (col < lineSize)
+        {
+            const auto count = runLength(data_ + lineStart_ + col, lineSize - col);
+            if (count > 0)
+            {
+                if (spell != nullptr)
+                    spell->append(data_ + lineStart_ + col, count);
+                pos_.IncColumn(static_cast<unsigned int>(count));
+            }
+        }
+    }
+}
+
 std::string SourceCode::GetLine(std::size_t lineIndex) const
 {
-    return (lineIndex < lines_.size() ? lines_[lineIndex] : "");
+    if (lineIndex < lineOffsets_.size())
+    {
+        /* Reconstruct line (with implicit new-line character) from line-offset index */
+        auto start = lineOffsets_[lineIndex];
+        auto end = (lineIndex + 1 < lineOffsets_.size() ? lineOffsets_[lineIndex + 1] : lineEnd_);
+
+        auto line = std::string(data_ + start, end - start);
+        if (line.empty() || line.back() != '\n')
+            line += '\n';
+
+        return line;
+    }
+    return "";
+}
+
+bool SourceCode::AdvanceLine()
+{
+    /* Store line start in index for later reports */
+    auto start = lineEnd_;
+    lineOffsets_.push_back(start);
+    pos_.IncRow();
+
+    /* Find end of next line in source buffer */
+    auto newLine = (start < size_ ? reinterpret_cast<const char*>(std::memchr(data_ + start, '\n', size_ - start)) : nullptr);
+
+    if (newLine == nullptr)
+    {
+        /* Check if end-of-file is reached */
+        lineStart_  = start;
+        lineEnd_    = size_;
+        exhausted_  = true;
+
+        currentLine_.assign(data_ + start, lineEnd_ - start);
+        currentLine_ += '\n';
+
+        return false;
+    }
+
+    /* Set current line boundaries (including new-line character) */
+    lineStart_  = start;
+    lineEnd_    = static_cast<std::size_t>(newLine - data_) + 1;
+
+    currentLine_.assign(data_ + lineStart_, lineEnd_ - lineStart_);
+
+    return true;
 }
 
 
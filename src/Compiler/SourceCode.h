@@ -1,6 +1,6 @@
 /*
  * SourceCode.h
- * 
+ *
  * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
  * See "LICENSE.txt" for license information.
  */
@@ -21,14 +21,17 @@ namespace Xsc
 {
 
 
-// Source code stream class.
-class SourceCode
+// Source code stream class. Instances are always shared-owned, so reports can retain the source for deferred line markers.
+class SourceCode : public std::enable_shared_from_this<SourceCode>
 {
-    
+
     public:
-        
+
         SourceCode(const std::shared_ptr<std::istream>& stream);
 
+        // Serves source code directly from the specified read-only buffer (no copy is made; the buffer must outlive this object).
+        SourceCode(const char* sourceBuffer, std::size_t bufferSize);
+
         // Returns true if this is a valid source code stream.
         bool IsValid() const;
 
@@ -38,6 +41,41 @@ class SourceCode
         // Fetches the line with the marker string of the specified source position.
         bool FetchLineMarker(const SourceArea& area, std::string& line, std::string& marker);
 
+        // Fetches the original text of the specified source area from the contiguous source buffer. Returns false if the area can not be mapped.
+        bool FetchText(const SourceArea& area, std::string& text) const;
+
+        /* ----- Bulk scanning ----- */
+
+        /*
+        The following functions consume an entire character run from the contiguous source buffer at once
+        (see the character-run kernels in SourceCode.cpp), and then return the next character (like "Next").
+        They never cross a line boundary, so the line bookkeeping remains with "Next".
+        */
+
+        // Skips the longest run of white spaces (excluding new-line characters), and optionally appends it to the output spelling.
+        char NextAfterWhiteSpaces(std::string* spell = nullptr);
+
+        // Appends the longest run of identifier characters (i.e. alphanumeric or '_') to the output spelling.
+        char NextAfterIdentifierTail(std::string& spell);
+
+        // Appends the longest run of decimal digits to the output spelling.
+        char NextAfterDigitTail(std::string& spell);
+
+        // Appends all remaining characters of the current line (excluding the new-line character) to the output spelling.
+        char NextAfterCommentLineTail(std::string& spell);
+
+        // Appends all characters up to (but not including) the next '*' character or the line end to the output spelling.
+        char NextAfterCommentBlockTail(std::string& spell);
+
+        /*
+        Skips all characters of inactive code up to the next line whose first non-white-space character is '#'
+        (a potential directive line), and then returns that '#' character (like "Next"), or 0 if the end-of-file
+        has been reached first. Unlike the character-run functions above, the skip crosses line boundaries (the
+        line bookkeeping is maintained via "AdvanceLine"). Block comments in the skipped text are tracked, so a
+        '#' inside a comment does not end the skip (see the inactive-code fast path in PreProcessor).
+        */
+        char NextAfterInactiveCode();
+
         // Sets the new source origin for the current source position (see "Pos()").
         void NextSourceOrigin(const std::string& filename, int lineOffset);
 
@@ -59,16 +97,71 @@ class SourceCode
             return currentLine_;
         }
 
+        // Returns the entire source content as contiguous buffer (may be null for an invalid source).
+        inline const char* Buffer() const
+        {
+            return data_;
+        }
+
+        // Returns the size (in bytes) of the entire source content.
+        inline std::size_t BufferSize() const
+        {
+            return size_;
+        }
+
+        // Returns the buffer offset of the most recently returned character (see "Next"); only valid after at least one character has been read.
+        inline std::size_t OffsetOfLastChar() const
+        {
+            return (lineStart_ + pos_.Column() - 1);
+        }
+
+        /*
+        Marks the source buffer as persistent, i.e. the buffer bytes outlive all tokens scanned from this source
+        (e.g. the main input source, which is retained for the entire compilation). The scanners only store token
+        spellings as views into persistent buffers (see Scanner::MakeView).
+        */
+        inline void MarkPersistentBuffer()
+        {
+            persistentBuffer_ = true;
+        }
+
+        // Returns true if the source buffer is persistent (see MarkPersistentBuffer).
+        inline bool HasPersistentBuffer() const
+        {
+            return persistentBuffer_;
+        }
+
     protected:
-        
+
         SourceCode() = default;
 
         // Returns the line (if it has already been read) by the zero-based line index.
         std::string GetLine(std::size_t lineIndex) const;
 
+        // Consumes the character run at the current position within the current line, classified by the specified kernel.
+        void ConsumeRun(std::size_t (*runLength)(const char*, std::size_t), std::string* spell);
+
+        // Scans the next line in the source buffer. Returns false if the end-of-file has been reached.
+        bool AdvanceLine();
+
         std::shared_ptr<std::istream>   stream_;
+
+        // Contiguous source buffer, to serve "Next()" without per-character stream reads.
+        // Points either into "content_", or into an external buffer (e.g. a memory mapped file).
+        const char*                     data_           = nullptr;
+        std::size_t                     size_           = 0;
+
+        // Owned source storage (only used when reading from a generic stream).
+        std::string                     content_;
         std::string                     currentLine_;
-        std::vector<std::string>        lines_;
+
+        // Offset of each line start within "content_" (zero-based line index).
+        std::vector<std::size_t>        lineOffsets_;
+        std::size_t                     lineStart_      = 0;
+        std::size_t                     lineEnd_        = 0;
+        bool                            exhausted_      = false;
+        bool                            persistentBuffer_ = false;
+
         SourcePosition                  pos_;
 
 };
@@ -83,4 +176,4 @@ using SourceCodePtr = std::shared_ptr<SourceCode>;
 
 
 
-// ================================================================================
\ No newline at end of file
+// ================================================================================
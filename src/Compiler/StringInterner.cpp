@@ -0,0 +1,136 @@
+/*
+ * StringInterner.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "StringInterner.h"
+#include "HLSLKeywords.h"
+#include "HLSLIntrinsics.h"
+#include <atomic>
+#include <mutex>
+
+
+namespace Xsc
+{
+
+
+/*
+ * Active interner of the calling thread (each compile activates its own interner, see StringInternerScope)
+ */
+
+static thread_local StringInterner* activeStringInterner = nullptr;
+
+StringInterner* StringInterner::Active()
+{
+    return activeStringInterner;
+}
+
+
+/*
+ * Process-wide vocabulary snapshot (see StringInterner::SharedVocabulary)
+ */
+
+// Identifiers registered by the host application before the snapshot is built (see AppendSharedVocabulary).
+static std::vector<std::string>  pendingSharedVocabulary;
+static std::mutex                pendingSharedVocabularyMutex;
+static std::atomic<bool>         sharedVocabularyBuilt(false);
+
+static std::unordered_set<std::string> GenerateSharedVocabulary()
+{
+    std::unordered_set<std::string> vocabulary;
+
+    /* Collect the stable HLSL vocabulary: keywords, semantic names, and intrinsic identifiers */
+    CollectHLSLKeywordIdents(vocabulary);
+    CollectHLSLIntrinsicIdents(vocabulary);
+
+    /* Adopt the identifiers registered by the host application; further registrations are rejected from here on */
+    std::lock_guard<std::mutex> guard(pendingSharedVocabularyMutex);
+
+    for (const auto& ident : pendingSharedVocabulary)
+        vocabulary.insert(ident);
+
+    pendingSharedVocabulary.clear();
+    sharedVocabularyBuilt = true;
+
+    return vocabulary;
+}
+
+const std::unordered_set<std::string>& StringInterner::SharedVocabulary()
+{
+    /* Magic static: built once under the compiler-generated guard, then read lock-free by all threads */
+    static const std::unordered_set<std::string> vocabulary = GenerateSharedVocabulary();
+    return vocabulary;
+}
+
+bool StringInterner::AppendSharedVocabulary(const std::vector<std::string>& idents)
+{
+    std::lock_guard<std::mutex> guard(pendingSharedVocabularyMutex);
+
+    if (sharedVocabularyBuilt)
+        return false;
+
+    pendingSharedVocabulary.insert(pendingSharedVocabulary.end(), idents.begin(), idents.end());
+    return true;
+}
+
+const std::string* StringInterner::Intern(const std::string& str)
+{
+    /* Serve the immutable process-wide snapshot first: shared warm cache across all worker threads */
+    const auto& vocabulary = SharedVocabulary();
+
+    auto it = vocabulary.find(str);
+    if (it != vocabulary.end())
+        return &(*it);
+
+    /* Novel string: fall through into the per-compile table */
+    return &(*strings_.insert(str).first);
+}
+
+const std::string* StringInterner::Find(const std::string& str) const
+{
+    const auto& vocabulary = SharedVocabulary();
+
+    auto it = vocabulary.find(str);
+    if (it != vocabulary.end())
+        return &(*it);
+
+    auto it2 = strings_.find(str);
+    return (it2 != strings_.end() ? &(*it2) : nullptr);
+}
+
+
+/*
+ * StringInternerScope class
+ */
+
+StringInternerScope::StringInternerScope()
+{
+    /* Adopt the enclosing interner if one is already active (e.g. retained by a CompilerInstance) */
+    if (activeStringInterner == nullptr)
+    {
+        activeStringInterner    = &interner_;
+        activated_              = true;
+    }
+}
+
+StringInternerScope::StringInternerScope(StringInterner& interner) :
+    previous_   { activeStringInterner },
+    activated_  { true                 }
+{
+    activeStringInterner = &interner;
+}
+
+StringInternerScope::~StringInternerScope()
+{
+    if (activated_)
+        activeStringInterner = previous_;
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
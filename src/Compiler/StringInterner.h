@@ -0,0 +1,97 @@
+/*
+ * StringInterner.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_STRING_INTERNER_H
+#define XSC_STRING_INTERNER_H
+
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+
+namespace Xsc
+{
+
+
+/*
+Two-tier string interning table: a process-lifetime read-only snapshot holds the stable vocabulary
+(HLSL keywords, intrinsic names, system value semantics, and whatever the host application registers
+via "AppendSharedVocabulary"); it is built once and immutable afterwards, so all worker threads of a
+compile server share its warm lookup structures lock-free. Only novel strings fall through into the
+per-compile table, which stores each distinct string once and hands out stable references.
+*/
+class StringInterner
+{
+
+    public:
+
+        StringInterner() = default;
+
+        StringInterner(const StringInterner&) = delete;
+        StringInterner& operator = (const StringInterner&) = delete;
+
+        // Returns the active string interner of the calling thread (may be null, see StringInternerScope).
+        static StringInterner* Active();
+
+        /*
+        Registers additional identifiers for the process-wide vocabulary snapshot (e.g. the stable
+        identifier vocabulary of the host engine). Returns false if the snapshot was already built,
+        i.e. this must be called before the first compilation; later calls have no effect.
+        */
+        static bool AppendSharedVocabulary(const std::vector<std::string>& idents);
+
+        // Returns the stable pooled reference for the specified string (inserts the string on first use).
+        const std::string* Intern(const std::string& str);
+
+        // Returns the pooled reference for the specified string, or null if the string has not been interned yet.
+        const std::string* Find(const std::string& str) const;
+
+    private:
+
+        // Returns the process-wide read-only vocabulary snapshot (built on first access, immutable afterwards).
+        static const std::unordered_set<std::string>& SharedVocabulary();
+
+        std::unordered_set<std::string> strings_;
+
+};
+
+
+// Helper class to activate a string interner for the calling thread within a scope (RAII principle).
+class StringInternerScope
+{
+
+    public:
+
+        // Activates the own interner, unless an enclosing scope already activated one (which is then adopted).
+        StringInternerScope();
+
+        // Activates the specified external interner (e.g. one retained across compiles by a CompilerInstance).
+        explicit StringInternerScope(StringInterner& interner);
+
+        ~StringInternerScope();
+
+        StringInternerScope(const StringInternerScope&) = delete;
+        StringInternerScope& operator = (const StringInternerScope&) = delete;
+
+    private:
+
+        StringInterner  interner_;
+        StringInterner* previous_   = nullptr;
+        bool            activated_  = false;
+
+};
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
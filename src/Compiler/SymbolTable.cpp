@@ -9,6 +9,7 @@
 #include "Exception.h"
 #include "ReportHandler.h"
 #include <algorithm>
+#include <cstdint>
 
 
 namespace Xsc
@@ -55,6 +56,9 @@ bool ASTSymbolOverload::AddSymbolRef(AST* ast)
     /* Add AST reference to list */
     refs_.push_back(ast);
 
+    /* A new overload invalidates all previously cached call resolutions */
+    resolveCache_.clear();
+
     return true;
 }
 
@@ -107,6 +111,13 @@ FunctionDecl* ASTSymbolOverload::FetchFunctionDecl(const std::vector<TypeDenoter
     if (refs_.front()->Type() != AST::Types::FunctionDecl)
         RuntimeErr("identifier '" + ident_ + "' does not name a function");
 
+    /* Check if the same argument types have been resolved before (see resolveCache_) */
+    auto fingerprint = ArgumentTypeFingerprint(argTypeDenoters);
+
+    auto cacheIt = resolveCache_.find(fingerprint);
+    if (cacheIt != resolveCache_.end())
+        return cacheIt->second;
+
     /* Validate number of arguments for function call */
     const auto numArgs = argTypeDenoters.size();
 
@@ -172,6 +183,9 @@ FunctionDecl* ASTSymbolOverload::FetchFunctionDecl(const std::vector<TypeDenoter
         );
     }
 
+    /* Cache the resolution for repeated calls with the same argument types (errors are never cached) */
+    resolveCache_[std::move(fingerprint)] = funcDeclCandidates.front();
+
     return funcDeclCandidates.front();
 }
 
@@ -209,6 +223,39 @@ bool ASTSymbolOverload::MatchFunctionDeclWithArgs(
     return false;
 }
 
+static void AppendTypeFingerprint(std::string& fingerprint, const TypeDenoter& typeDen)
+{
+    const auto& aliased = typeDen.GetAliased();
+
+    /* Append the compact type-id (type kind and primary payload) as raw bytes */
+    const auto typeId = aliased.TypeId();
+    fingerprint.append(reinterpret_cast<const char*>(&typeId), sizeof(typeId));
+
+    if (auto structTypeDen = aliased.As<StructTypeDenoter>())
+    {
+        /* Distinguish equally named structures from different scopes by their declaration reference */
+        const auto declRef = reinterpret_cast<std::uintptr_t>(structTypeDen->structDeclRef);
+        fingerprint.append(reinterpret_cast<const char*>(&declRef), sizeof(declRef));
+    }
+    else if (auto arrayTypeDen = aliased.As<ArrayTypeDenoter>())
+    {
+        /* The dimension count is part of the type-id; encode the element type recursively */
+        if (arrayTypeDen->baseTypeDenoter)
+            AppendTypeFingerprint(fingerprint, *arrayTypeDen->baseTypeDenoter);
+    }
+}
+
+std::string ASTSymbolOverload::ArgumentTypeFingerprint(const std::vector<TypeDenoterPtr>& typeDens)
+{
+    std::string fingerprint;
+    fingerprint.reserve(typeDens.size() * (sizeof(std::uint32_t) + sizeof(std::uintptr_t)));
+
+    for (const auto& typeDen : typeDens)
+        AppendTypeFingerprint(fingerprint, *typeDen);
+
+    return fingerprint;
+}
+
 
 } // /namespace Xsc
 
@@ -10,7 +10,9 @@
 
 
 #include "AST.h"
-#include <map>
+#include "CompileStats.h"
+#include "StringInterner.h"
+#include <unordered_map>
 #include <string>
 #include <stack>
 #include <vector>
@@ -57,18 +59,21 @@ class SymbolTable
         // Opens a new scope.
         void OpenScope()
         {
-            scopeStack_.push({});
+            scopeOffsets_.push_back(registeredIdents_.size());
         }
 
         // Closes the active scope.
         void CloseScope()
         {
-            if (!scopeStack_.empty())
+            if (!scopeOffsets_.empty())
             {
-                /* Remove all symbols from the table which are in the current scope */
-                for (const auto& ident : scopeStack_.top())
+                /* Remove all symbols from the table which are in the current scope (see scope-undo log) */
+                for (auto i = scopeOffsets_.back(); i < registeredIdents_.size(); ++i)
                 {
-                    auto it = symTable_.find(ident);
+                    /* Evict cached resolutions, since they may revert to an outer scope symbol (see fetchCache_) */
+                    fetchCache_.erase(registeredIdents_[i]);
+
+                    auto it = symTable_.find(registeredIdents_[i]);
                     if (it != symTable_.end())
                     {
                         /* Remove symbol from the top most scope level */
@@ -80,7 +85,8 @@ class SymbolTable
                         }
                     }
                 }
-                scopeStack_.pop();
+                registeredIdents_.resize(scopeOffsets_.back());
+                scopeOffsets_.pop_back();
             }
         }
 
@@ -91,13 +97,19 @@ class SymbolTable
         bool Register(const std::string& ident, SymbolType symbol, const OnOverrideProc& overrideProc = nullptr, bool throwOnFailure = true)
         {
             /* Validate input parameters */
-            if (scopeStack_.empty())
+            if (scopeOffsets_.empty())
                 throw std::runtime_error("no active scope to register symbol");
             if (ident.empty())
                 return false;
 
+            /* Intern identifier to get its stable key (see StringInterner) */
+            auto identRef = GetInterner().Intern(ident);
+
+            /* Evict the cached resolution, since the new symbol shadows or overrides it (see fetchCache_) */
+            fetchCache_.erase(identRef);
+
             /* Check if identifier was already registered in the current scope */
-            auto it = symTable_.find(ident);
+            auto it = symTable_.find(identRef);
             if (it != symTable_.end() && !it->second.empty())
             {
                 auto& entry = it->second.top();
@@ -114,8 +126,8 @@ class SymbolTable
             }
 
             /* Register new identifier */
-            symTable_[ident].push({ symbol, ScopeLevel() });
-            scopeStack_.top().push_back(ident);
+            symTable_[identRef].push({ symbol, ScopeLevel() });
+            registeredIdents_.push_back(identRef);
 
             return true;
         }
@@ -126,17 +138,39 @@ class SymbolTable
         */
         SymbolType Fetch(const std::string& ident) const
         {
-            auto it = symTable_.find(ident);
-            if (it != symTable_.end() && !it->second.empty())
-                return it->second.top().symbol;
-            else
-                return GenericDefaultValue<SymbolType>::Get();
+            if (auto stats = ActiveCompileStats())
+                ++stats->symbolTableFetches;
+
+            /* If the identifier was never interned, no symbol with this name can be registered */
+            if (auto identRef = GetInterner().Find(ident))
+            {
+                /* Serve repeated lookups from the resolution cache (see fetchCache_) */
+                auto cacheIt = fetchCache_.find(identRef);
+                if (cacheIt != fetchCache_.end())
+                {
+                    if (auto stats = ActiveCompileStats())
+                        ++stats->symbolTableCacheHits;
+                    return cacheIt->second;
+                }
+
+                /* Resolve the symbol from the scope stack and cache the resolution (including unresolved identifiers) */
+                auto it = symTable_.find(identRef);
+                auto symbol = (
+                    it != symTable_.end() && !it->second.empty()
+                        ? it->second.top().symbol
+                        : GenericDefaultValue<SymbolType>::Get()
+                );
+
+                fetchCache_[identRef] = symbol;
+                return symbol;
+            }
+            return GenericDefaultValue<SymbolType>::Get();
         }
 
         // Returns current scope level.
         std::size_t ScopeLevel() const
         {
-            return scopeStack_.size();
+            return scopeOffsets_.size();
         }
 
     private:
@@ -147,14 +181,37 @@ class SymbolTable
             std::size_t scopeLevel;
         };
 
-        // Stores the scope stack for all identifiers.
-        std::map<std::string, std::stack<Symbol>>   symTable_;
+        // Returns the interner used for the symbol keys: the active per-compile interner, or a table-local fallback.
+        StringInterner& GetInterner() const
+        {
+            auto active = StringInterner::Active();
+            return (active != nullptr ? *active : interner_);
+        }
 
         /*
-        Stores all identifiers for the current stack.
-        All these identifiers will be removed from "symTable_" when a scope will be closed.
+        Stores the scope stack for all identifiers.
+        The keys are interned string references, so hashing and comparison work on plain pointers.
         */
-        std::stack<std::vector<std::string>>        scopeStack_;
+        std::unordered_map<const std::string*, std::stack<Symbol>>  symTable_;
+
+        /*
+        Flat scope-undo log: all registered identifiers in order of registration.
+        All identifiers of the current scope will be removed from "symTable_" when the scope will be closed.
+        */
+        std::vector<const std::string*>                             registeredIdents_;
+
+        // Start offsets into the scope-undo log, one for each open scope.
+        std::vector<std::size_t>                                    scopeOffsets_;
+
+        /*
+        Resolution cache for repeated fetches of the same identifier (e.g. intrinsics and common uniforms
+        are resolved thousands of times per shader). Entries are evicted when a registered symbol shadows
+        or overrides them, and when closing a scope removes the resolved symbol.
+        */
+        mutable std::unordered_map<const std::string*, SymbolType>  fetchCache_;
+
+        // Fallback interner when no per-compile interner is active.
+        mutable StringInterner                                      interner_;
 
 };
 
@@ -201,9 +258,19 @@ class ASTSymbolOverload
             bool implicitTypeConversion
         );
 
+        // Returns a canonical fingerprint string for the specified argument type denoter list (see resolveCache_).
+        static std::string ArgumentTypeFingerprint(const std::vector<TypeDenoterPtr>& typeDens);
+
         std::string         ident_;
         std::vector<AST*>   refs_;
 
+        /*
+        Overload resolution cache: function declaration by argument type fingerprint, so a repeated call
+        with the same argument types re-uses the previous resolution instead of matching all candidates
+        again (see FetchFunctionDecl). Invalidated whenever a new overload is added (see AddSymbolRef).
+        */
+        std::unordered_map<std::string, FunctionDecl*> resolveCache_;
+
 };
 
 using ASTSymbolOverloadPtr = std::shared_ptr<ASTSymbolOverload>;
@@ -0,0 +1,81 @@
+/*
+ * ThreadPool.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "ThreadPool.h"
+#include <algorithm>
+
+
+namespace Xsc
+{
+
+
+ThreadPool& ThreadPool::Instance()
+{
+    static ThreadPool instance;
+    return instance;
+}
+
+void ThreadPool::Enqueue(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> guard { mutex_ };
+        jobs_.push(std::move(job));
+    }
+    jobSubmitted_.notify_one();
+}
+
+
+/*
+ * ======= Private: =======
+ */
+
+ThreadPool::ThreadPool()
+{
+    auto numWorkers = std::max(1u, std::thread::hardware_concurrency());
+
+    workers_.reserve(numWorkers);
+    for (unsigned int i = 0; i < numWorkers; ++i)
+        workers_.emplace_back(std::thread(&ThreadPool::WorkerMain, this));
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> guard { mutex_ };
+        quit_ = true;
+    }
+    jobSubmitted_.notify_all();
+
+    for (auto& worker : workers_)
+        worker.join();
+}
+
+void ThreadPool::WorkerMain()
+{
+    for (;;)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock { mutex_ };
+            jobSubmitted_.wait(lock, [this]() { return (quit_ || !jobs_.empty()); });
+
+            if (jobs_.empty())
+                return;
+
+            job = std::move(jobs_.front());
+            jobs_.pop();
+        }
+        job();
+    }
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
@@ -0,0 +1,63 @@
+/*
+ * ThreadPool.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_THREAD_POOL_H
+#define XSC_THREAD_POOL_H
+
+
+#include <functional>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+
+namespace Xsc
+{
+
+
+// Lazily started worker-thread pool for background compilations (see CompileShaderAsync).
+class ThreadPool
+{
+
+    public:
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator = (const ThreadPool&) = delete;
+
+        // Returns the process-wide thread pool instance (started on first use).
+        static ThreadPool& Instance();
+
+        // Enqueues the specified job; it runs on the next free worker thread.
+        void Enqueue(std::function<void()> job);
+
+    private:
+
+        ThreadPool();
+        ~ThreadPool();
+
+        void WorkerMain();
+
+        std::vector<std::thread>            workers_;
+        std::queue<std::function<void()>>   jobs_;
+
+        std::mutex                          mutex_;
+        std::condition_variable             jobSubmitted_;
+        bool                                quit_           = false;
+
+};
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,186 @@
+/*
+ * TraceEvents.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TraceEvents.h"
+
+#ifdef XSC_ENABLE_TRACE_EVENTS
+
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+
+namespace Xsc
+{
+
+
+using TraceClock = std::chrono::steady_clock;
+
+// Completed or still open trace span (the duration is filled when the span is closed).
+struct TraceEventEntry
+{
+    const char*             name;
+    std::string             detail;
+    TraceClock::time_point  start;
+    TraceClock::duration    duration;
+};
+
+// Collected spans of one compilation, written as Chrome trace-event JSON on completion (see TraceSessionScope).
+class TraceSession
+{
+
+    public:
+
+        explicit TraceSession(std::ostream& stream) :
+            stream_ { stream             },
+            origin_ { TraceClock::now()  }
+        {
+        }
+
+        ~TraceSession()
+        {
+            /* Close any spans left open (e.g. after an error or cancellation), then write the collected events */
+            EndAllSpans();
+            Write();
+        }
+
+        void BeginSpan(const char* name, const std::string& detail)
+        {
+            openSpans_.push_back(events_.size());
+            events_.push_back({ name, detail, TraceClock::now(), TraceClock::duration::zero() });
+        }
+
+        void EndSpan()
+        {
+            if (!openSpans_.empty())
+            {
+                auto& entry = events_[openSpans_.back()];
+                entry.duration = TraceClock::now() - entry.start;
+                openSpans_.pop_back();
+            }
+        }
+
+        void EndAllSpans()
+        {
+            while (!openSpans_.empty())
+                EndSpan();
+        }
+
+    private:
+
+        static std::string EscapeString(const std::string& s)
+        {
+            std::string result;
+            result.reserve(s.size());
+            for (auto c : s)
+            {
+                if (c == '"' || c == '\\')
+                    result += '\\';
+                result += c;
+            }
+            return result;
+        }
+
+        void Write()
+        {
+            auto MicrosecondsSinceOrigin = [this](const TraceClock::time_point& timePoint)
+            {
+                return std::chrono::duration_cast<std::chrono::microseconds>(timePoint - origin_).count();
+            };
+
+            const auto threadID = std::hash<std::thread::id>()(std::this_thread::get_id()) % 0xffff;
+
+            stream_ << "{\"traceEvents\":[";
+
+            for (std::size_t i = 0; i < events_.size(); ++i)
+            {
+                const auto& entry = events_[i];
+
+                if (i > 0)
+                    stream_ << ',';
+
+                stream_
+                    << "\n{\"name\":\"" << entry.name << "\""
+                    << ",\"ph\":\"X\""
+                    << ",\"ts\":" << MicrosecondsSinceOrigin(entry.start)
+                    << ",\"dur\":" << std::chrono::duration_cast<std::chrono::microseconds>(entry.duration).count()
+                    << ",\"pid\":0"
+                    << ",\"tid\":" << threadID;
+
+                if (!entry.detail.empty())
+                    stream_ << ",\"args\":{\"detail\":\"" << EscapeString(entry.detail) << "\"}";
+
+                stream_ << '}';
+            }
+
+            stream_ << "\n]}\n";
+        }
+
+        std::ostream&                   stream_;
+        TraceClock::time_point          origin_;
+        std::vector<TraceEventEntry>    events_;
+        std::vector<std::size_t>        openSpans_;
+
+};
+
+static thread_local TraceSession* activeTraceSession = nullptr;
+
+void TraceSpanBegin(const char* name)
+{
+    if (auto session = activeTraceSession)
+        session->BeginSpan(name, "");
+}
+
+void TraceSpanBegin(const char* name, const std::string& detail)
+{
+    if (auto session = activeTraceSession)
+        session->BeginSpan(name, detail);
+}
+
+void TraceSpanEnd()
+{
+    if (auto session = activeTraceSession)
+        session->EndSpan();
+}
+
+void TraceStageBegin(const char* name)
+{
+    if (auto session = activeTraceSession)
+    {
+        /* Stages are strictly sequential at the top level, so close everything the previous stage left open */
+        session->EndAllSpans();
+        session->BeginSpan(name, "");
+    }
+}
+
+void TraceStageEnd()
+{
+    if (auto session = activeTraceSession)
+        session->EndAllSpans();
+}
+
+TraceSessionScope::TraceSessionScope(std::ostream* stream)
+{
+    previous_ = activeTraceSession;
+    activeTraceSession = (stream != nullptr ? new TraceSession(*stream) : nullptr);
+}
+
+TraceSessionScope::~TraceSessionScope()
+{
+    delete activeTraceSession;
+    activeTraceSession = reinterpret_cast<TraceSession*>(previous_);
+}
+
+
+} // /namespace Xsc
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,122 @@
+/*
+ * TraceEvents.h
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef XSC_TRACE_EVENTS_H
+#define XSC_TRACE_EVENTS_H
+
+
+#include <ostream>
+#include <string>
+
+
+namespace Xsc
+{
+
+
+/*
+Chrome "trace_event" instrumentation (see ShaderOutput::traceOutput). When the compiler is built
+with XSC_TRACE_EVENTS, the pipeline stages and the per-pass instrumentation points record spans
+into the session active on this thread, and the session writes them as trace-event JSON on
+completion; otherwise all hooks compile to nothing.
+*/
+#ifdef XSC_ENABLE_TRACE_EVENTS
+
+// Opens a span in the active trace session; spans nest and must be closed in reverse order.
+void TraceSpanBegin(const char* name);
+void TraceSpanBegin(const char* name, const std::string& detail);
+
+// Closes the innermost open span.
+void TraceSpanEnd();
+
+// Opens a pipeline stage span, closing the previous stage and any spans still open within it (see CompileShaderPrimary).
+void TraceStageBegin(const char* name);
+
+// Closes the current stage span.
+void TraceStageEnd();
+
+#else
+
+inline void TraceSpanBegin(const char*) {}
+inline void TraceSpanBegin(const char*, const std::string&) {}
+inline void TraceSpanEnd() {}
+inline void TraceStageBegin(const char*) {}
+inline void TraceStageEnd() {}
+
+#endif
+
+// RAII scope that records one trace span (compiles to nothing without XSC_TRACE_EVENTS).
+class TraceSpan
+{
+
+    public:
+
+        explicit TraceSpan(const char* name)
+        {
+            TraceSpanBegin(name);
+        }
+
+        TraceSpan(const char* name, const std::string& detail)
+        {
+            TraceSpanBegin(name, detail);
+        }
+
+        ~TraceSpan()
+        {
+            TraceSpanEnd();
+        }
+
+        TraceSpan(const TraceSpan&) = delete;
+        TraceSpan& operator = (const TraceSpan&) = delete;
+
+};
+
+/*
+RAII scope that makes a trace session writing to the specified stream the active one of
+the current thread. A null stream deactivates the instrumentation for this scope. The
+collected spans are written as trace-event JSON when the scope is left, with any spans
+still open (e.g. after an error) closed at that point.
+*/
+class TraceSessionScope
+{
+
+    public:
+
+        explicit TraceSessionScope(std::ostream* stream);
+        ~TraceSessionScope();
+
+        TraceSessionScope(const TraceSessionScope&) = delete;
+        TraceSessionScope& operator = (const TraceSessionScope&) = delete;
+
+    #ifdef XSC_ENABLE_TRACE_EVENTS
+    private:
+
+        void* previous_ = nullptr;
+    #endif
+
+};
+
+#ifndef XSC_ENABLE_TRACE_EVENTS
+
+inline TraceSessionScope::TraceSessionScope(std::ostream*)
+{
+}
+
+inline TraceSessionScope::~TraceSessionScope()
+{
+}
+
+#endif
+
+
+} // /namespace Xsc
+
+
+#endif
+
+
+
+// ================================================================================
@@ -7,7 +7,9 @@
 
 #include "Variant.h"
 #include "Helper.h"
+#include <cmath>
 #include <sstream>
+#include <stdexcept>
 
 
 namespace Xsc
@@ -36,20 +38,75 @@ Variant::Variant(RealType value) :
 {
 }
 
-#define IMPLEMENT_VARIANT_OP(OP)    \
-    switch (type_)                  \
-    {                               \
-        case Types::Bool:           \
-            /* dummy case block */; \
-            break;                  \
-        case Types::Int:            \
-            int_ OP rhs.int_;       \
-            break;                  \
-        case Types::Real:           \
-            real_ OP rhs.real_;     \
-            break;                  \
-    }                               \
-    return *this                    \
+Variant::Variant(const VecType& value, std::size_t vecSize) :
+    type_   { Types::RealVec },
+    vec_    { value          },
+    vecSize_{ vecSize        }
+{
+}
+
+/*
+Promotes both operands to a common type before an arithmetic operation:
+mixed scalar operands are promoted to the "larger" type (bool -> int -> real),
+and a scalar operand is broadcast to the dimension of a vector operand.
+*/
+static void PromoteOperands(Variant& lhs, Variant& rhs)
+{
+    if (lhs.Type() == Variant::Types::RealVec || rhs.Type() == Variant::Types::RealVec)
+    {
+        if (lhs.Type() != Variant::Types::RealVec)
+        {
+            /* Broadcast left-hand-side scalar to vector */
+            Variant::VecType vec = {{ }};
+            vec.fill(lhs.ToReal());
+            lhs = Variant(vec, rhs.VecSize());
+        }
+        else if (rhs.Type() != Variant::Types::RealVec)
+        {
+            /* Broadcast right-hand-side scalar to vector */
+            Variant::VecType vec = {{ }};
+            vec.fill(rhs.ToReal());
+            rhs = Variant(vec, lhs.VecSize());
+        }
+        else if (lhs.VecSize() != rhs.VecSize())
+            throw std::runtime_error("vector dimension mismatch of variant types");
+    }
+    else if (lhs.Type() == Variant::Types::Real || rhs.Type() == Variant::Types::Real)
+    {
+        lhs.ToReal();
+        rhs.ToReal();
+    }
+    else if (lhs.Type() == Variant::Types::Int || rhs.Type() == Variant::Types::Int)
+    {
+        lhs.ToInt();
+        rhs.ToInt();
+    }
+}
+
+/*
+The loops over the inline component array have a fixed upper bound and no branches,
+so the compiler can vectorize them.
+*/
+#define IMPLEMENT_VARIANT_OP(OP)                        \
+    auto rhsCopy = rhs;                                 \
+    PromoteOperands(*this, rhsCopy);                    \
+    switch (type_)                                      \
+    {                                                   \
+        case Types::Bool:                               \
+            /* dummy case block */;                     \
+            break;                                      \
+        case Types::Int:                                \
+            int_ OP rhsCopy.int_;                       \
+            break;                                      \
+        case Types::Real:                               \
+            real_ OP rhsCopy.real_;                     \
+            break;                                      \
+        case Types::RealVec:                            \
+            for (std::size_t i = 0; i < vecSize_; ++i)  \
+                vec_[i] OP rhsCopy.vec_[i];             \
+            break;                                      \
+    }                                                   \
+    return *this                                        \
 
 #define IMPLEMENT_VARIANT_BITWISE_OP(OP)    \
     switch (type_)                          \
@@ -80,12 +137,52 @@ Variant& Variant::operator *= (const Variant& rhs)
 
 Variant& Variant::operator /= (const Variant& rhs)
 {
-    IMPLEMENT_VARIANT_OP(/=);
+    auto rhsCopy = rhs;
+    PromoteOperands(*this, rhsCopy);
+    switch (type_)
+    {
+        case Types::Bool:
+            // dummy case block
+            break;
+        case Types::Int:
+            if (rhsCopy.int_ == 0)
+                throw std::runtime_error("division by zero in variant expression");
+            int_ /= rhsCopy.int_;
+            break;
+        case Types::Real:
+            real_ /= rhsCopy.real_;
+            break;
+        case Types::RealVec:
+            for (std::size_t i = 0; i < vecSize_; ++i)
+                vec_[i] /= rhsCopy.vec_[i];
+            break;
+    }
+    return *this;
 }
 
 Variant& Variant::operator %= (const Variant& rhs)
 {
-    IMPLEMENT_VARIANT_BITWISE_OP(%=);
+    auto rhsCopy = rhs;
+    PromoteOperands(*this, rhsCopy);
+    switch (type_)
+    {
+        case Types::Bool:
+            // dummy case block
+            break;
+        case Types::Int:
+            if (rhsCopy.int_ == 0)
+                throw std::runtime_error("division by zero in variant expression");
+            int_ %= rhsCopy.int_;
+            break;
+        case Types::Real:
+            real_ = std::fmod(real_, rhsCopy.real_);
+            break;
+        case Types::RealVec:
+            for (std::size_t i = 0; i < vecSize_; ++i)
+                vec_[i] = std::fmod(vec_[i], rhsCopy.vec_[i]);
+            break;
+    }
+    return *this;
 }
 
 Variant& Variant::operator |= (const Variant& rhs)
@@ -129,6 +226,10 @@ Variant& Variant::operator ++ ()
         case Types::Real:
             ++real_;
             break;
+        case Types::RealVec:
+            for (std::size_t i = 0; i < vecSize_; ++i)
+                vec_[i] += RealType(1);
+            break;
     }
     return *this;
 }
@@ -146,6 +247,10 @@ Variant& Variant::operator -- ()
         case Types::Real:
             --real_;
             break;
+        case Types::RealVec:
+            for (std::size_t i = 0; i < vecSize_; ++i)
+                vec_[i] -= RealType(1);
+            break;
     }
     return *this;
 }
@@ -165,6 +270,10 @@ Variant Variant::operator - ()
         case Types::Real:
             result.real_ = -real_;
             break;
+        case Types::RealVec:
+            for (std::size_t i = 0; i < vecSize_; ++i)
+                result.vec_[i] = -vec_[i];
+            break;
     }
 
     return result;
@@ -179,6 +288,8 @@ Variant Variant::operator ~ ()
         case Types::Int:
             result.int_ = ~int_;
             break;
+        case Types::RealVec:
+            throw std::runtime_error("illegal operator '~' for vector variant");
         default:
             // dummy case block
             break;
@@ -202,6 +313,8 @@ Variant Variant::operator ! ()
         case Types::Real:
             result.real_ = !real_;
             break;
+        case Types::RealVec:
+            throw std::runtime_error("illegal operator '!' for vector variant");
     }
 
     return result;
@@ -222,6 +335,8 @@ Variant::BoolType Variant::ToBool()
             type_ = Types::Bool;
             bool_ = (real_ != 0.0f);
             break;
+        case Types::RealVec:
+            throw std::runtime_error("can not convert vector variant to scalar type");
     }
     return bool_;
 }
@@ -241,6 +356,8 @@ Variant::IntType Variant::ToInt()
             type_ = Types::Int;
             int_ = static_cast<IntType>(real_);
             break;
+        case Types::RealVec:
+            throw std::runtime_error("can not convert vector variant to scalar type");
     }
     return int_;
 }
@@ -260,6 +377,8 @@ Variant::RealType Variant::ToReal()
         case Types::Real:
             // dummy case block
             break;
+        case Types::RealVec:
+            throw std::runtime_error("can not convert vector variant to scalar type");
     }
     return real_;
 }
@@ -268,6 +387,9 @@ int Variant::CompareWith(const Variant& rhs) const
 {
     auto cmp = rhs;
 
+    if (type_ == Types::RealVec || cmp.Type() == Types::RealVec)
+        throw std::runtime_error("illegal comparison of vector variant");
+
     switch (type_)
     {
         case Types::Bool:
@@ -319,7 +441,16 @@ Variant Variant::ParseFrom(const std::string& s)
 static std::string RealToString(Variant::RealType v)
 {
     auto s = std::to_string(v);
-    s.erase(s.find_last_not_of('0') + 2, std::string::npos);
+
+    /* Trim the trailing zeros, but keep one digit after the decimal point (e.g. "0.500000" -> "0.5", "1.000000" -> "1.0") */
+    auto end = s.find_last_not_of('0');
+    if (end != std::string::npos)
+    {
+        if (s[end] == '.')
+            ++end;
+        s.erase(end + 1, std::string::npos);
+    }
+
     return s;
 }
 
@@ -333,6 +464,17 @@ std::string Variant::ToString() const
             return std::to_string(Int());
         case Types::Real:
             return RealToString(Real());
+        case Types::RealVec:
+        {
+            std::string s;
+            for (std::size_t i = 0; i < VecSize(); ++i)
+            {
+                if (i > 0)
+                    s += ", ";
+                s += RealToString(vec_[i]);
+            }
+            return s;
+        }
     }
     return "";
 }
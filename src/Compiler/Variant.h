@@ -10,13 +10,20 @@
 
 
 #include "Visitor.h"
+#include <array>
+#include <cstddef>
 
 
 namespace Xsc
 {
 
 
-// Helper class to simply cast expressions between boolean, float, and integral types.
+/*
+Helper class to simply cast expressions between boolean, float, and integral types.
+Vector and matrix constants are stored component-wise in fixed inline storage (no heap allocation),
+and all arithmetic operators work component-wise on them (with scalar broadcasting),
+which matches the semantics of the HLSL operators on vectors and matrices.
+*/
 class Variant
 {
 
@@ -26,11 +33,15 @@ class Variant
         using IntType = long long;
         using RealType = double;
 
+        // Inline storage for vector and matrix constants (up to 4x4 components).
+        using VecType = std::array<RealType, 16>;
+
         enum class Types
         {
             Bool,
             Int,
             Real,
+            RealVec,
         };
 
         Variant() = default;
@@ -38,6 +49,7 @@ class Variant
         Variant(BoolType value);
         Variant(IntType value);
         Variant(RealType value);
+        Variant(const VecType& value, std::size_t vecSize);
 
         Variant& operator = (const Variant& rhs) = default;
         Variant& operator += (const Variant& rhs);
@@ -57,6 +69,10 @@ class Variant
         Variant operator ~ ();
         Variant operator ! ();
 
+        /*
+        Converts this variant to the respective scalar type.
+        Throws an std::runtime_error if this variant holds a vector constant.
+        */
         BoolType ToBool();
         IntType ToInt();
         RealType ToReal();
@@ -79,6 +95,17 @@ class Variant
             return real_;
         }
 
+        inline const VecType& Vec() const
+        {
+            return vec_;
+        }
+
+        // Returns the number of components of a vector constant (or 0 for scalar variants).
+        inline std::size_t VecSize() const
+        {
+            return vecSize_;
+        }
+
         // Returns the current internal type of this variant.
         inline Types Type() const
         {
@@ -91,11 +118,13 @@ class Variant
 
     private:
 
-        Types       type_   = Types::Int;
-        BoolType    bool_   = false;
-        IntType     int_    = 0;
-        RealType    real_   = 0.0;
-    
+        Types       type_       = Types::Int;
+        BoolType    bool_       = false;
+        IntType     int_        = 0;
+        RealType    real_       = 0.0;
+        VecType     vec_        = {{ }};
+        std::size_t vecSize_    = 0;
+
 };
 
 
@@ -0,0 +1,130 @@
+/*
+ * WrapperPreamble.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Xsc/WrapperPreamble.h>
+
+#include <fstream>
+#include <sstream>
+
+
+namespace Xsc
+{
+
+
+/*
+Preamble file layout: plain GLSL text, where each wrapper is preceded by a marker comment
+carrying its registration key:
+
+    // xsc wrapper: <key>
+    <wrapper code lines until the next marker>
+
+The markers make the file self-describing, so "Load" can merge the wrappers of a previous
+tool invocation without a separate index, and a runtime loader can still prepend the file
+to a shader source as-is (the markers are ordinary line comments).
+*/
+
+// Marker comment prefix preceding each wrapper in a preamble file.
+static const char* wrapperMarkerPrefix_ = "// xsc wrapper: ";
+
+
+bool WrapperPreamble::AddWrapper(const std::string& key, const std::string& code)
+{
+    std::lock_guard<std::mutex> guard(wrappersMutex_);
+
+    /* Register wrapper only once; the code of a registered wrapper is never replaced */
+    return wrappers_.insert({ key, code }).second;
+}
+
+bool WrapperPreamble::HasWrapper(const std::string& key) const
+{
+    std::lock_guard<std::mutex> guard(wrappersMutex_);
+    return (wrappers_.find(key) != wrappers_.end());
+}
+
+bool WrapperPreamble::Load(const std::string& filename, bool ignoreMissingFile)
+{
+    std::ifstream file(filename);
+    if (!file.good())
+        return ignoreMissingFile;
+
+    /* Scan the file for wrapper markers; the code of a wrapper runs until the next marker */
+    const std::string markerPrefix = wrapperMarkerPrefix_;
+
+    std::string key, code, line;
+
+    auto FlushWrapper = [&]()
+    {
+        if (!key.empty())
+            AddWrapper(key, code);
+        key.clear();
+        code.clear();
+    };
+
+    while (std::getline(file, line))
+    {
+        if (line.compare(0, markerPrefix.size(), markerPrefix) == 0)
+        {
+            FlushWrapper();
+            key = line.substr(markerPrefix.size());
+        }
+        else if (!key.empty() && !line.empty())
+            code += line + '\n';
+    }
+
+    FlushWrapper();
+
+    return true;
+}
+
+void WrapperPreamble::Write(std::ostream& stream) const
+{
+    std::lock_guard<std::mutex> guard(wrappersMutex_);
+
+    for (const auto& wrapper : wrappers_)
+    {
+        stream << wrapperMarkerPrefix_ << wrapper.first << '\n';
+        stream << wrapper.second;
+        if (!wrapper.second.empty() && wrapper.second.back() != '\n')
+            stream << '\n';
+    }
+}
+
+bool WrapperPreamble::Save(const std::string& filename) const
+{
+    std::ofstream file(filename);
+    if (!file.good())
+        return false;
+
+    Write(file);
+
+    return file.good();
+}
+
+void WrapperPreamble::Clear()
+{
+    std::lock_guard<std::mutex> guard(wrappersMutex_);
+    wrappers_.clear();
+}
+
+std::size_t WrapperPreamble::NumWrappers() const
+{
+    std::lock_guard<std::mutex> guard(wrappersMutex_);
+    return wrappers_.size();
+}
+
+bool WrapperPreamble::Empty() const
+{
+    std::lock_guard<std::mutex> guard(wrappersMutex_);
+    return wrappers_.empty();
+}
+
+
+} // /namespace Xsc
+
+
+
+// ================================================================================
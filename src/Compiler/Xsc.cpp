@@ -6,17 +6,37 @@
  */
 
 #include <Xsc/Xsc.h>
+#include <Xsc/ShaderUnit.h>
+#include <Xsc/CompilerInstance.h>
 #include "PreProcessor.h"
 #include "HLSLParser.h"
 #include "HLSLAnalyzer.h"
 #include "GLSLGenerator.h"
 #include "Optimizer.h"
 #include "ASTPrinter.h"
+#include "ASTSerializer.h"
+#include "FileMapping.h"
+#include "IncludeCache.h"
+#include "TokenModule.h"
+#include "PreProcessorScanner.h"
+#include "StringInterner.h"
+#include "CompileStats.h"
+#include "CompileBudget.h"
+#include "TraceEvents.h"
+#include "StaticVisitor.h"
+#include "Helper.h"
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <cstring>
+#include "ThreadPool.h"
 #include <chrono>
 #include <array>
+#include <iterator>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 
 
 namespace Xsc
@@ -30,8 +50,1689 @@ namespace Xsc
 using Time      = std::chrono::system_clock;
 using TimePoint = std::chrono::time_point<std::chrono::system_clock>;
 
+// Returns the content hash of the specified include stream (without consuming a memory mapped stream).
+static std::uint64_t HashIncludeStream(std::unique_ptr<std::istream>& stream)
+{
+    if (auto mappedStream = dynamic_cast<FileMappingStream*>(stream.get()))
+        return HashData(mappedStream->GetMapping().Data(), mappedStream->GetMapping().Size());
+
+    if (auto cachedStream = dynamic_cast<IncludeCacheStream*>(stream.get()))
+        return HashData(cachedStream->Content().data(), cachedStream->Content().size());
+
+    /* Read stream content once, hash it, and replace the (now consumed) stream by a string copy */
+    std::string content
+    {
+        std::istreambuf_iterator<char>(*stream),
+        std::istreambuf_iterator<char>()
+    };
+
+    auto hash = HashData(content.data(), content.size());
+    stream = MakeUnique<std::istringstream>(content);
+
+    return hash;
+}
+
+// Include handler wrapper that records the include closure (filename and content hash) for the compile cache.
+class CacheIncludeHandler : public IncludeHandler
+{
+
+    public:
+
+        CacheIncludeHandler(IncludeHandler& handler, std::vector<CompileCache::IncludeReference>& includes) :
+            handler_  { handler  },
+            includes_ { includes }
+        {
+        }
+
+        std::unique_ptr<std::istream> Include(const std::string& filename, bool useSearchPathsFirst) override
+        {
+            auto stream = handler_.Include(filename, useSearchPathsFirst);
+
+            CompileCache::IncludeReference ref;
+            {
+                ref.filename            = filename;
+                ref.contentHash         = HashIncludeStream(stream);
+                ref.useSearchPathsFirst = useSearchPathsFirst;
+            }
+            includes_.push_back(std::move(ref));
+
+            return stream;
+        }
+
+    private:
+
+        IncludeHandler&                                 handler_;
+        std::vector<CompileCache::IncludeReference>&    includes_;
+
+};
+
+// Returns true if the specified include closure is still up-to-date.
+static bool ValidateIncludeClosure(const std::vector<CompileCache::IncludeReference>& includes, IncludeHandler& includeHandler)
+{
+    for (const auto& ref : includes)
+    {
+        try
+        {
+            auto stream = includeHandler.Include(ref.filename, ref.useSearchPathsFirst);
+            if (!stream || HashIncludeStream(stream) != ref.contentHash)
+                return false;
+        }
+        catch (const std::exception&)
+        {
+            /* Include file no longer available */
+            return false;
+        }
+    }
+    return true;
+}
+
+// Loads the precompiled header modules of the input descriptor and defines them in the preprocessor (see PrecompileHeader).
+static void DefineHeaderModules(PreProcessor& preProcessor, const ShaderInput& inputDesc, Log* log)
+{
+    for (const auto& module : inputDesc.headerModules)
+    {
+        /* Module files are cached across compiles; the tokens are constructed per compile (see TokenModule::Read) */
+        if (auto content = IncludeCache::Instance().FetchOrLoad(module.second))
+        {
+            auto tokens = TokenModule::Read(content->data(), content->size(), module.first);
+            if (!tokens.empty())
+            {
+                preProcessor.DefineHeaderModule(module.first, std::move(tokens));
+                continue;
+            }
+        }
+        if (log)
+            log->SumitReport(Report(Report::Types::Warning, "failed to load precompiled header module \"" + module.second + "\""));
+    }
+}
+
+// Runs the preprocessor for the specified input, or fetches its cached output (see CompileCache).
+static std::unique_ptr<std::iostream> PreProcessInput(
+    const ShaderInput& inputDesc, Log* log, std::vector<std::string>* macros,
+    std::vector<CompileCache::IncludeReference>* dependencies)
+{
+    std::unique_ptr<IncludeHandler> stdIncludeHandler;
+    if (!inputDesc.includeHandler)
+        stdIncludeHandler = std::unique_ptr<IncludeHandler>(new IncludeHandler());
+
+    auto& includeHandler = (inputDesc.includeHandler != nullptr ? *inputDesc.includeHandler : *stdIncludeHandler);
+
+    auto inputSource = (
+        inputDesc.sourceCodeBuffer != nullptr
+            ? std::make_shared<SourceCode>(inputDesc.sourceCodeBuffer, inputDesc.sourceCodeBufferSize)
+            : std::make_shared<SourceCode>(inputDesc.sourceCode)
+    );
+
+    /* The input source outlives all tokens scanned from it, so token spellings can be stored as views */
+    inputSource->MarkPersistentBuffer();
+
+    std::uint64_t sourceHash = 0;
+
+    if (inputDesc.cache)
+    {
+        /* Try to fetch preprocessed source from cache (validated against the include closure) */
+        /* Chain the source content hash onto the define-set fingerprint, since both determine the preprocessed output */
+        sourceHash = HashData(inputSource->Buffer(), inputSource->BufferSize(), DefineSetFingerprint(inputDesc));
+
+        if (auto entry = inputDesc.cache->FetchPreProcessedSource(sourceHash))
+        {
+            if (ValidateIncludeClosure(entry->includes, includeHandler))
+            {
+                if (macros)
+                    *macros = entry->macros;
+                if (dependencies)
+                    *dependencies = entry->includes;
+                return MakeUnique<std::stringstream>(entry->output);
+            }
+        }
+    }
+
+    std::vector<CompileCache::IncludeReference> includes;
+    CacheIncludeHandler cacheIncludeHandler(includeHandler, includes);
+
+    PreProcessor preProcessor(
+        ( inputDesc.cache != nullptr || dependencies != nullptr
+            ? static_cast<IncludeHandler&>(cacheIncludeHandler)
+            : includeHandler ),
+        log
+    );
+
+    preProcessor.SetErrorLimit(inputDesc.maxErrors);
+
+    /* Predefine macros from the input descriptor */
+    for (const auto& macro : inputDesc.predefinedMacros)
+        preProcessor.PredefineMacro(macro.ident, macro.value);
+
+    /* Define precompiled header modules from the input descriptor */
+    DefineHeaderModules(preProcessor, inputDesc, log);
+
+    auto processedInput = preProcessor.Process(inputSource, inputDesc.filename);
+
+    if (macros)
+        *macros = preProcessor.ListDefinedMacroIdents();
+
+    /* Report the include closure before it is moved into the cache entry */
+    if (processedInput && dependencies)
+        *dependencies = includes;
+
+    if (processedInput && inputDesc.cache)
+    {
+        /* Store preprocessed output in cache */
+        if (auto outputStream = dynamic_cast<std::stringstream*>(processedInput.get()))
+        {
+            CompileCache::PreProcessedSource entry;
+            {
+                entry.includes  = std::move(includes);
+                entry.macros    = preProcessor.ListDefinedMacroIdents();
+                entry.output    = outputStream->str();
+            }
+            inputDesc.cache->StorePreProcessedSource(sourceHash, std::move(entry));
+        }
+    }
+
+    return processedInput;
+}
+
+// Runs the preprocessor into a token string, which can be parsed without serialization and re-scanning (see HLSLParser::ParseTokenString).
+static std::unique_ptr<TokenPtrString> PreProcessInputTokens(
+    const ShaderInput& inputDesc, Log* log, std::vector<std::string>* macros, SourceCodePtr& inputSource,
+    std::vector<CompileCache::IncludeReference>* dependencies)
+{
+    std::unique_ptr<IncludeHandler> stdIncludeHandler;
+    if (!inputDesc.includeHandler)
+        stdIncludeHandler = std::unique_ptr<IncludeHandler>(new IncludeHandler());
+
+    auto& includeHandler = (inputDesc.includeHandler != nullptr ? *inputDesc.includeHandler : *stdIncludeHandler);
+
+    inputSource = (
+        inputDesc.sourceCodeBuffer != nullptr
+            ? std::make_shared<SourceCode>(inputDesc.sourceCodeBuffer, inputDesc.sourceCodeBufferSize)
+            : std::make_shared<SourceCode>(inputDesc.sourceCode)
+    );
+
+    /* The caller retains the input source for the entire compilation, so token spellings can be stored as views */
+    inputSource->MarkPersistentBuffer();
+
+    /* Record the include closure only on demand, since hashing the include streams is not free */
+    std::vector<CompileCache::IncludeReference> includes;
+    CacheIncludeHandler cacheIncludeHandler(includeHandler, includes);
+
+    PreProcessor preProcessor(
+        (dependencies != nullptr ? static_cast<IncludeHandler&>(cacheIncludeHandler) : includeHandler),
+        log
+    );
+
+    preProcessor.SetErrorLimit(inputDesc.maxErrors);
+
+    /* Predefine macros from the input descriptor */
+    for (const auto& macro : inputDesc.predefinedMacros)
+        preProcessor.PredefineMacro(macro.ident, macro.value);
+
+    /* Define precompiled header modules from the input descriptor */
+    DefineHeaderModules(preProcessor, inputDesc, log);
+
+    auto processedTokens = preProcessor.ProcessToTokenString(inputSource, inputDesc.filename);
+
+    if (macros)
+        *macros = preProcessor.ListDefinedMacroIdents();
+
+    if (processedTokens && dependencies)
+        *dependencies = std::move(includes);
+
+    return processedTokens;
+}
+
+// Splits the preprocessed token string into top-level declarations and returns a content hash per declaration (see CompilerContext).
+static std::vector<std::uint64_t> HashTopLevelDeclarations(const TokenPtrString& tokenString, bool includeComments)
+{
+    std::vector<std::uint64_t> declHashes;
+
+    auto hash           = HashData(nullptr, 0);
+    auto emptyDecl      = true;
+    std::size_t depth   = 0;
+
+    for (const auto& tkn : tokenString)
+    {
+        auto type = tkn->Type();
+
+        /* Skip formatting tokens, so white-space edits do not influence the declaration hashes */
+        if (type == Token::Types::WhiteSpaces || type == Token::Types::NewLines)
+            continue;
+        if (type == Token::Types::Comment && !includeComments)
+            continue;
+
+        /* Chain the token type and spelling onto the declaration hash (the null terminator keeps the encoding unambiguous) */
+        /* (read the spelling via SpellData, so spelling views are not materialized just for hashing) */
+        char typeEncoding = static_cast<char>(type);
+        hash = HashData(&typeEncoding, 1, hash);
+        hash = HashData(tkn->SpellData(), tkn->SpellSize(), hash);
+        hash = HashData("", 1, hash);
+        emptyDecl = false;
+
+        /* A ';' or a matched '}' at the global scope terminates the current declaration */
+        /* (the preprocessor classifies punctuation as 'Misc' tokens, so compare by spelling) */
+        if (type != Token::Types::Comment && type != Token::Types::StringLiteral)
+        {
+            const auto chr = (tkn->SpellSize() == 1 ? tkn->SpellData()[0] : '\0');
+
+            if (chr == '{')
+                ++depth;
+            else if (chr == '}' && depth > 0)
+                --depth;
+
+            if (depth == 0 && (chr == ';' || chr == '}'))
+            {
+                declHashes.push_back(hash);
+                hash        = HashData(nullptr, 0);
+                emptyDecl   = true;
+            }
+        }
+    }
+
+    /* Append trailing tokens that do not form a complete declaration (the parser reports those later) */
+    if (!emptyDecl)
+        declHashes.push_back(hash);
+
+    return declHashes;
+}
+
+// Returns a content hash over the configuration that determines the generated output (the declaration hashes cover the preprocessed code itself).
+static std::uint64_t ContextConfigHash(const ShaderInput& inputDesc, const ShaderOutput& outputDesc)
+{
+    auto hash = HashData(nullptr, 0);
+
+    hash = HashData(inputDesc.entryPoint.c_str(), inputDesc.entryPoint.size() + 1, hash);
+    hash = HashData(outputDesc.formatting.indent.c_str(), outputDesc.formatting.indent.size() + 1, hash);
+    hash = HashData(outputDesc.formatting.prefix.c_str(), outputDesc.formatting.prefix.size() + 1, hash);
+
+    const std::uint32_t scalars[] =
+    {
+        static_cast<std::uint32_t>(inputDesc.shaderTarget),
+        static_cast<std::uint32_t>(inputDesc.shaderVersion),
+        static_cast<std::uint32_t>(outputDesc.shaderVersion),
+    };
+    hash = HashData(reinterpret_cast<const char*>(scalars), sizeof(scalars), hash);
+
+    const char flags[] =
+    {
+        static_cast<char>(outputDesc.formatting.blanks),
+        static_cast<char>(outputDesc.formatting.lineMarks),
+        static_cast<char>(outputDesc.formatting.compactWrappers),
+        static_cast<char>(outputDesc.formatting.newLineOpenScope),
+        static_cast<char>(outputDesc.options.optimize),
+        static_cast<char>(outputDesc.options.allowExtensions),
+        static_cast<char>(outputDesc.options.explicitBinding),
+        static_cast<char>(outputDesc.options.preserveComments),
+        static_cast<char>(outputDesc.options.preferWrappers),
+    };
+    hash = HashData(flags, sizeof(flags), hash);
+
+    return hash;
+}
+
+// Writes the retained output code of an incremental compilation to the requested output target.
+static bool WriteRetainedOutput(const std::string& outputCode, const ShaderOutput& outputDesc)
+{
+    if (outputDesc.outputCompressor)
+    {
+        outputDesc.outputCompressor->WriteChunk(outputCode.data(), outputCode.size());
+        outputDesc.outputCompressor->Finish();
+    }
+    else if (outputDesc.sourceCodeCallback)
+        outputDesc.sourceCodeCallback(outputCode.data(), outputCode.size());
+    else if (outputDesc.sourceCodeString)
+        *outputDesc.sourceCodeString = outputCode;
+    else
+        (*outputDesc.sourceCode) << outputCode;
+    return true;
+}
+
+// Returns true if cancellation of an asynchronous compilation has been requested (see CompileShaderAsync).
+#ifdef XSC_ENABLE_MEMORY_POOL
+
+// Returns the size of the input source in bytes, or 0 if it cannot be determined cheaply (see MemoryPool::ReserveForInput).
+static std::size_t EstimateInputSize(const ShaderInput& inputDesc)
+{
+    if (inputDesc.sourceCodeBuffer != nullptr)
+        return inputDesc.sourceCodeBufferSize;
+
+    if (inputDesc.sourceCode)
+    {
+        /* Measure a seekable stream without consuming it */
+        auto& stream = *inputDesc.sourceCode;
+
+        const auto pos = stream.tellg();
+        if (pos != std::streampos(-1))
+        {
+            stream.seekg(0, std::ios::end);
+            const auto end = stream.tellg();
+            stream.seekg(pos);
+
+            if (end != std::streampos(-1) && end >= pos)
+                return static_cast<std::size_t>(end - pos);
+        }
+    }
+
+    return 0;
+}
+
+#endif
+
+static bool IsCancelled(const std::atomic<bool>* cancelToken)
+{
+    return (cancelToken != nullptr && cancelToken->load());
+}
+
+/* ----- Output cache ----- */
+
+// Deserialized output cache entry: include closure, generated code, and reflection blob (see OutputCacheStore).
+struct OutputCacheEntry
+{
+    std::vector<CompileCache::IncludeReference> includes;
+    std::string                                 outputCode;
+    std::string                                 reflection;
+};
+
+// Magic number and format version of output cache entries ("XOC1").
+static const std::uint32_t outputCacheMagic_ = 0x584f4331;
+
+template <typename T>
+static void OutputCacheAppend(std::string& blob, const T& value)
+{
+    blob.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void OutputCacheAppendString(std::string& blob, const std::string& s)
+{
+    OutputCacheAppend(blob, static_cast<std::uint32_t>(s.size()));
+    blob.append(s);
+}
+
+template <typename T>
+static bool OutputCacheRead(const char*& data, const char* dataEnd, T& value)
+{
+    if (static_cast<std::size_t>(dataEnd - data) < sizeof(T))
+        return false;
+    std::memcpy(&value, data, sizeof(T));
+    data += sizeof(T);
+    return true;
+}
+
+static bool OutputCacheReadString(const char*& data, const char* dataEnd, std::string& s)
+{
+    std::uint32_t size = 0;
+    if (!OutputCacheRead(data, dataEnd, size) || static_cast<std::size_t>(dataEnd - data) < size)
+        return false;
+    s.assign(data, size);
+    data += size;
+    return true;
+}
+
+// Serializes the specified output cache entry into an opaque binary blob (see OutputCacheStore).
+static std::string SerializeOutputCacheEntry(const OutputCacheEntry& entry)
+{
+    std::string blob;
+    blob.reserve(entry.outputCode.size() + entry.reflection.size() + 64);
+
+    OutputCacheAppend(blob, outputCacheMagic_);
+    OutputCacheAppend(blob, static_cast<std::uint32_t>(entry.includes.size()));
+
+    for (const auto& ref : entry.includes)
+    {
+        OutputCacheAppend(blob, ref.contentHash);
+        OutputCacheAppend(blob, static_cast<std::uint8_t>(ref.useSearchPathsFirst ? 1 : 0));
+        OutputCacheAppendString(blob, ref.filename);
+    }
+
+    OutputCacheAppendString(blob, entry.outputCode);
+    OutputCacheAppendString(blob, entry.reflection);
+
+    return blob;
+}
+
+// Deserializes an output cache entry. Returns false for a malformed blob (e.g. a truncated cache file).
+static bool DeserializeOutputCacheEntry(const std::string& blob, OutputCacheEntry& entry)
+{
+    auto data    = blob.data();
+    auto dataEnd = data + blob.size();
+
+    std::uint32_t magic = 0, numIncludes = 0;
+
+    if ( !OutputCacheRead(data, dataEnd, magic) || magic != outputCacheMagic_ ||
+         !OutputCacheRead(data, dataEnd, numIncludes) )
+    {
+        return false;
+    }
+
+    entry.includes.reserve(std::min<std::size_t>(numIncludes, 256));
+
+    for (std::uint32_t i = 0; i < numIncludes; ++i)
+    {
+        CompileCache::IncludeReference ref;
+        std::uint8_t useSearchPathsFirst = 0;
+
+        if ( !OutputCacheRead(data, dataEnd, ref.contentHash) ||
+             !OutputCacheRead(data, dataEnd, useSearchPathsFirst) ||
+             !OutputCacheReadString(data, dataEnd, ref.filename) )
+        {
+            return false;
+        }
+
+        ref.useSearchPathsFirst = (useSearchPathsFirst != 0);
+        entry.includes.push_back(std::move(ref));
+    }
+
+    return
+    (
+        OutputCacheReadString(data, dataEnd, entry.outputCode) &&
+        OutputCacheReadString(data, dataEnd, entry.reflection)
+    );
+}
+
+// Returns the output cache key: a fingerprint over the source code, the predefined macro set, and the output configuration.
+static std::uint64_t OutputCacheKey(
+    const char* source, std::size_t sourceSize, const ShaderInput& inputDesc, const ShaderOutput& outputDesc)
+{
+    const std::uint64_t configHashes[] =
+    {
+        ContextConfigHash(inputDesc, outputDesc),
+        DefineSetFingerprint(inputDesc),
+    };
+
+    auto key = HashData(reinterpret_cast<const char*>(configHashes), sizeof(configHashes));
+
+    return HashData(source, sourceSize, key);
+}
+
+// Returns the name of the specified AST node type (see CompileStats::astNodeCounts).
+static const char* ASTTypeToString(const AST::Types type)
+{
+    switch (type)
+    {
+        case AST::Types::Program:           return "Program";
+        case AST::Types::CodeBlock:         return "CodeBlock";
+        case AST::Types::FunctionCall:      return "FunctionCall";
+        case AST::Types::Attribute:         return "Attribute";
+        case AST::Types::SwitchCase:        return "SwitchCase";
+        case AST::Types::SamplerValue:      return "SamplerValue";
+        case AST::Types::Register:          return "Register";
+        case AST::Types::PackOffset:        return "PackOffset";
+        case AST::Types::VarType:           return "VarType";
+        case AST::Types::VarIdent:          return "VarIdent";
+        case AST::Types::VarDecl:           return "VarDecl";
+        case AST::Types::TextureDecl:       return "TextureDecl";
+        case AST::Types::SamplerDecl:       return "SamplerDecl";
+        case AST::Types::StructDecl:        return "StructDecl";
+        case AST::Types::AliasDecl:         return "AliasDecl";
+        case AST::Types::FunctionDecl:      return "FunctionDecl";
+        case AST::Types::VarDeclStmnt:      return "VarDeclStmnt";
+        case AST::Types::BufferDeclStmnt:   return "BufferDeclStmnt";
+        case AST::Types::TextureDeclStmnt:  return "TextureDeclStmnt";
+        case AST::Types::SamplerDeclStmnt:  return "SamplerDeclStmnt";
+        case AST::Types::StructDeclStmnt:   return "StructDeclStmnt";
+        case AST::Types::AliasDeclStmnt:    return "AliasDeclStmnt";
+        case AST::Types::NullStmnt:         return "NullStmnt";
+        case AST::Types::CodeBlockStmnt:    return "CodeBlockStmnt";
+        case AST::Types::ForLoopStmnt:      return "ForLoopStmnt";
+        case AST::Types::WhileLoopStmnt:    return "WhileLoopStmnt";
+        case AST::Types::DoWhileLoopStmnt:  return "DoWhileLoopStmnt";
+        case AST::Types::IfStmnt:           return "IfStmnt";
+        case AST::Types::ElseStmnt:         return "ElseStmnt";
+        case AST::Types::SwitchStmnt:       return "SwitchStmnt";
+        case AST::Types::ExprStmnt:         return "ExprStmnt";
+        case AST::Types::ReturnStmnt:       return "ReturnStmnt";
+        case AST::Types::CtrlTransferStmnt: return "CtrlTransferStmnt";
+        case AST::Types::NullExpr:          return "NullExpr";
+        case AST::Types::ListExpr:          return "ListExpr";
+        case AST::Types::LiteralExpr:       return "LiteralExpr";
+        case AST::Types::TypeNameExpr:      return "TypeNameExpr";
+        case AST::Types::TernaryExpr:       return "TernaryExpr";
+        case AST::Types::BinaryExpr:        return "BinaryExpr";
+        case AST::Types::UnaryExpr:         return "UnaryExpr";
+        case AST::Types::PostUnaryExpr:     return "PostUnaryExpr";
+        case AST::Types::FunctionCallExpr:  return "FunctionCallExpr";
+        case AST::Types::BracketExpr:       return "BracketExpr";
+        case AST::Types::SuffixExpr:        return "SuffixExpr";
+        case AST::Types::ArrayAccessExpr:   return "ArrayAccessExpr";
+        case AST::Types::CastExpr:          return "CastExpr";
+        case AST::Types::VarAccessExpr:     return "VarAccessExpr";
+        case AST::Types::InitializerExpr:   return "InitializerExpr";
+        case AST::Types::LiteralBlobExpr:   return "LiteralBlobExpr";
+    }
+    return "";
+}
+
+// Counts the AST nodes by their type name (see CompileStats::astNodeCounts).
+class ASTNodeCounter : private StaticVisitor<ASTNodeCounter>
+{
+
+    public:
+
+        void CountNodes(Program& program, std::map<std::string, std::size_t>& nodeCounts)
+        {
+            nodeCounts_ = &nodeCounts;
+            Visit(&program);
+        }
+
+    private:
+
+        friend StaticVisitorT;
+
+        void OnDispatchNode(AST* ast, void* args)
+        {
+            ++(*nodeCounts_)[ASTTypeToString(ast->Type())];
+        }
+
+        std::map<std::string, std::size_t>* nodeCounts_ = nullptr;
+
+};
+
 static bool CompileShaderPrimary(
-    const ShaderInput& inputDesc, const ShaderOutput& outputDesc, Log* log, std::array<TimePoint, 6>& timePoints)
+    const ShaderInput& inputDesc, const ShaderOutput& outputDesc, Log* log,
+    std::array<TimePoint, 6>& timePoints, CompilerContext* context = nullptr,
+    const std::atomic<bool>* cancelToken = nullptr)
+{
+    auto SubmitError = [log](const char* msg)
+    {
+        if (log)
+            log->SumitReport(Report(Report::Types::Error, msg));
+        return false;
+    };
+
+    #ifdef XSC_ENABLE_MEMORY_POOL
+    /* All tokens and AST nodes of this compile are allocated from one arena, which is dropped at the end of this scope */
+    MemoryPoolScope memoryPoolScope;
+
+    if (auto pool = MemoryPool::Active())
+        pool->ReserveForInput(EstimateInputSize(inputDesc));
+    #endif
+
+    /* All identifiers of this compile share one interning table (see SymbolTable) */
+    StringInternerScope stringInternerScope;
+
+    /* Accumulate hot-path counters while the caller requests instrumentation (see ActiveCompileStats) */
+    CompileStatsScope compileStatsScope(outputDesc.compileStats);
+
+    /* Guard the compile budgets while the caller configures any (see ShaderInput::maxCompileTime) */
+    CompileBudgetScope compileBudgetScope(inputDesc);
+
+    auto ValidateBudget = [log]()
+    {
+        if (auto budget = ActiveCompileBudget())
+            return budget->Validate(log);
+        return true;
+    };
+
+    /* Record trace-event spans while the caller requests them (see ShaderOutput::traceOutput) */
+    TraceSessionScope traceSessionScope(outputDesc.traceOutput);
+
+    /* Validate arguments */
+    if (!inputDesc.sourceCode && !inputDesc.sourceCodeBuffer)
+        throw std::invalid_argument("input stream must not be null");
+    if (!outputDesc.sourceCode && !outputDesc.sourceCodeString && !outputDesc.sourceCodeCallback && !outputDesc.outputCompressor)
+        throw std::invalid_argument("output stream must not be null");
+
+    if (outputDesc.shaderVersion == OutputShaderVersion::GLSL110)
+        throw std::invalid_argument("output shader version 'GLSL 1.10' is not supported");
+    if (outputDesc.shaderVersion == OutputShaderVersion::GLSL120)
+        throw std::invalid_argument("output shader version 'GLSL 1.20' is not supported");
+
+    /* With a compiler context, generate into a retained buffer, so unchanged recompilations can reuse the output */
+    std::string retainedOutput;
+    auto activeOutputDesc = outputDesc;
+
+    if ( context != nullptr && !outputDesc.options.preprocessOnly &&
+         !outputDesc.options.validateOnly && !outputDesc.options.metadataOnly && inputDesc.cache == nullptr )
+    {
+        /* Generate into the retained buffer; the requested output target (including a chunk callback or compressor) is served from it afterwards */
+        activeOutputDesc.sourceCodeString   = &retainedOutput;
+        activeOutputDesc.sourceCodeCallback = nullptr;
+        activeOutputDesc.outputCompressor   = nullptr;
+    }
+    else
+        context = nullptr;
+
+    std::uint64_t               contextConfigHash = 0;
+    std::vector<std::uint64_t>  contextDeclHashes;
+
+    /* Pre-process input code */
+    timePoints[0] = Time::now();
+    AllocTrackingBeginStage("preprocess");
+    TraceStageBegin("preprocess");
+
+    std::vector<std::string> macros;
+    auto macrosPtr = (outputDesc.statistics != nullptr ? &macros : nullptr);
+
+    ProgramPtr program;
+
+    if (!outputDesc.options.preprocessOnly && !inputDesc.cache)
+    {
+        /* Pipe the preprocessed tokens straight to the parser, without serializing them to text */
+        SourceCodePtr inputSource;
+        auto processedTokens = PreProcessInputTokens(inputDesc, log, macrosPtr, inputSource, outputDesc.includeDependencies);
+
+        if (outputDesc.statistics)
+            outputDesc.statistics->macros = std::move(macros);
+
+        if (!processedTokens)
+            return SubmitError("preprocessing input code failed");
+
+        if (context)
+        {
+            /* Reuse the retained output if no top-level declaration of the preprocessed code changed */
+            contextConfigHash = ContextConfigHash(inputDesc, outputDesc);
+            contextDeclHashes = HashTopLevelDeclarations(*processedTokens, outputDesc.options.preserveComments);
+
+            if (context->MatchDeclarationHashes(contextConfigHash, contextDeclHashes))
+                return WriteRetainedOutput(context->RetainedOutput(), outputDesc);
+        }
+
+        /* Stop an abandoned compile at the pass boundary, so its memory is released quickly */
+        if (IsCancelled(cancelToken))
+            return false;
+
+        /* Parse HLSL input code */
+        timePoints[1] = Time::now();
+        AllocTrackingBeginStage("parse");
+        TraceStageBegin("parse");
+
+        HLSLParser parser(log);
+        parser.SetErrorLimit(inputDesc.maxErrors);
+        program = parser.ParseTokenString(*processedTokens, inputSource, outputDesc.options.metadataOnly);
+    }
+    else
+    {
+        /* Textual path: the preprocessed output itself is requested, or the compile cache stores it as text */
+        auto processedInput = PreProcessInput(inputDesc, log, macrosPtr, outputDesc.includeDependencies);
+
+        if (outputDesc.statistics)
+            outputDesc.statistics->macros = std::move(macros);
+
+        if (!processedInput)
+            return SubmitError("preprocessing input code failed");
+
+        if (outputDesc.options.preprocessOnly)
+        {
+            if (outputDesc.outputCompressor || outputDesc.sourceCodeCallback)
+            {
+                std::string processedSource;
+                if (auto outputStream = dynamic_cast<std::stringstream*>(processedInput.get()))
+                    processedSource = outputStream->str();
+                else
+                    processedSource.assign(std::istreambuf_iterator<char>(*processedInput), std::istreambuf_iterator<char>());
+
+                if (outputDesc.outputCompressor)
+                {
+                    outputDesc.outputCompressor->WriteChunk(processedSource.data(), processedSource.size());
+                    outputDesc.outputCompressor->Finish();
+                }
+                else
+                    outputDesc.sourceCodeCallback(processedSource.data(), processedSource.size());
+            }
+            else if (outputDesc.sourceCodeString)
+            {
+                if (auto outputStream = dynamic_cast<std::stringstream*>(processedInput.get()))
+                    *outputDesc.sourceCodeString = outputStream->str();
+                else
+                    outputDesc.sourceCodeString->assign(std::istreambuf_iterator<char>(*processedInput), std::istreambuf_iterator<char>());
+            }
+            else
+                (*outputDesc.sourceCode) << processedInput->rdbuf();
+            return true;
+        }
+
+        /* Parse HLSL input code */
+        timePoints[1] = Time::now();
+        AllocTrackingBeginStage("parse");
+        TraceStageBegin("parse");
+
+        HLSLParser parser(log);
+        parser.SetErrorLimit(inputDesc.maxErrors);
+        parser.ConcurrentLexing(inputDesc.concurrentLexing);
+
+        auto processedSourceCode = std::make_shared<SourceCode>(std::move(processedInput));
+
+        /* The parsed source is retained by the program for deferred reports, so token spellings can be stored as views */
+        processedSourceCode->MarkPersistentBuffer();
+
+        program = parser.ParseSource(processedSourceCode, outputDesc.options.metadataOnly);
+    }
+
+    if (!program)
+        return SubmitError("parsing input code failed");
+
+    if (IsCancelled(cancelToken))
+        return false;
+
+    /* Verify the compile budgets at the pass boundary (see ShaderInput::maxCompileTime) */
+    if (!ValidateBudget())
+        return false;
+
+    /* Small context analysis */
+    timePoints[2] = Time::now();
+    AllocTrackingBeginStage("analyze");
+    TraceStageBegin("analyze");
+
+    HLSLAnalyzer analyzer(log);
+    auto analyzerResult = analyzer.DecorateAST(*program, inputDesc, outputDesc);
+
+    /* Print AST */
+    if (outputDesc.options.showAST && log)
+    {
+        ASTPrinter printer;
+        printer.PrintAST(program.get(), *log);
+    }
+
+    /* Dump AST in binary form (see ShaderOutput::astDumpOutput) */
+    if (outputDesc.astDumpOutput)
+    {
+        ASTSerializer serializer;
+        serializer.SerializeAST(program.get(), *outputDesc.astDumpOutput);
+    }
+
+    if (!analyzerResult)
+        return SubmitError("analyzing input code failed");
+
+    if (IsCancelled(cancelToken))
+        return false;
+
+    if (!ValidateBudget())
+        return false;
+
+    timePoints[3] = Time::now();
+
+    if (outputDesc.options.metadataOnly)
+    {
+        /* Metadata extraction: stop the pipeline after context analysis (see Options::metadataOnly) */
+        if (auto statistics = outputDesc.statistics)
+        {
+            statistics->techniques = program->techniqueIdents;
+
+            /* Report all global functions as entry-point candidates (the sampler states were already collected by the analyzer) */
+            for (const auto& stmnt : program->globalStmnts)
+            {
+                if (stmnt->Type() == AST::Types::FunctionDecl)
+                    statistics->entryPoints.push_back(static_cast<FunctionDecl*>(stmnt.get())->ident);
+            }
+        }
+
+        timePoints[4] = timePoints[3];
+        timePoints[5] = timePoints[3];
+    }
+    else if (outputDesc.options.validateOnly)
+    {
+        /* Frontend-only validation: stop the pipeline after context analysis (see Options::validateOnly) */
+        /* Still verify the entry point here, since its absence is otherwise first reported by the code generator */
+        if (program->entryPointRef == nullptr)
+        {
+            if (log)
+                log->SumitReport(Report(Report::Types::Error, "entry point \"" + inputDesc.entryPoint + "\" not found"));
+            return false;
+        }
+
+        timePoints[4] = timePoints[3];
+        timePoints[5] = timePoints[3];
+    }
+    else
+    {
+        /* Optimize AST */
+        AllocTrackingBeginStage("optimize");
+        TraceStageBegin("optimize");
+
+        if (outputDesc.options.optimize)
+        {
+            Optimizer optimizer;
+            optimizer.Optimize(*program, outputDesc.formatting.prefix);
+        }
+
+        if (!ValidateBudget())
+            return false;
+
+        /* Generate GLSL output code */
+        timePoints[4] = Time::now();
+        AllocTrackingBeginStage("generate");
+        TraceStageBegin("generate");
+
+        GLSLGenerator generator(log);
+        if (!generator.GenerateCode(*program, inputDesc, activeOutputDesc, log))
+            return SubmitError("generating output code failed");
+
+        timePoints[5] = Time::now();
+    }
+
+    AllocTrackingEndStage();
+    TraceStageEnd();
+
+    /* Fill instrumentation statistics */
+    if (auto stats = outputDesc.compileStats)
+    {
+        ASTNodeCounter nodeCounter;
+        nodeCounter.CountNodes(*program, stats->astNodeCounts);
+
+        auto PassTime = [&timePoints](std::size_t startPoint, std::size_t endPoint)
+        {
+            return static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(timePoints[endPoint] - timePoints[startPoint]).count()
+            );
+        };
+
+        stats->preProcessingTime    = PassTime(0, 1);
+        stats->parsingTime          = PassTime(1, 2);
+        stats->analysisTime         = PassTime(2, 3);
+        stats->optimizationTime     = PassTime(3, 4);
+        stats->generationTime       = PassTime(4, 5);
+
+        #ifdef XSC_ENABLE_MEMORY_POOL
+        if (auto pool = MemoryPool::Active())
+        {
+            stats->arenaBytes           = pool->UsedBytes();
+            stats->arenaPages           = pool->NumPages();
+            stats->arenaCapacityBytes   = pool->CapacityBytes();
+        }
+        #endif
+    }
+
+    /* Retain the generated output in the context and forward it to the requested output target */
+    if (context)
+    {
+        context->StoreCompilation(contextConfigHash, std::move(contextDeclHashes), std::move(retainedOutput));
+        WriteRetainedOutput(context->RetainedOutput(), outputDesc);
+    }
+
+    return true;
+}
+
+// Serializes the report submission of concurrent emission passes which share one log.
+class SynchronizedLog : public Log
+{
+
+    public:
+
+        SynchronizedLog(Log* host, std::mutex& mutex) :
+            host_  { host  },
+            mutex_ { mutex }
+        {
+        }
+
+        void SumitReport(const Report& report) override
+        {
+            std::lock_guard<std::mutex> guard { mutex_ };
+            host_->SumitReport(report);
+        }
+
+    private:
+
+        Log*        host_ = nullptr;
+        std::mutex& mutex_;
+
+};
+
+/*
+Materializes the memoized type denoter of every typed AST node (see TypedAST::GetTypeDenoter),
+so concurrent emission passes only read the memo instead of racing to derive it.
+*/
+class TypeDenoterMaterializer : private StaticVisitor<TypeDenoterMaterializer>
+{
+
+    public:
+
+        void MaterializeTypes(Program& program)
+        {
+            Visit(&program);
+        }
+
+    private:
+
+        friend StaticVisitorT;
+
+        void OnDispatchNode(AST* ast, void* args)
+        {
+            if (auto typedAST = dynamic_cast<TypedAST*>(ast))
+            {
+                try
+                {
+                    typedAST->GetTypeDenoter();
+                }
+                catch (const std::exception&)
+                {
+                    /* Undecorated nodes are derived (and reported) during emission */
+                }
+            }
+        }
+
+};
+
+static bool CompileShaderVariantsPrimary(
+    const ShaderInput& inputDesc, std::vector<ShaderOutput>& outputDescs, Log* log)
+{
+    auto SubmitError = [log](const char* msg)
+    {
+        if (log)
+            log->SumitReport(Report(Report::Types::Error, msg));
+        return false;
+    };
+
+    #ifdef XSC_ENABLE_MEMORY_POOL
+    /* All tokens and AST nodes of this compile are allocated from one arena, which is dropped at the end of this scope */
+    MemoryPoolScope memoryPoolScope;
+
+    if (auto pool = MemoryPool::Active())
+        pool->ReserveForInput(EstimateInputSize(inputDesc));
+    #endif
+
+    /* All identifiers of this compile share one interning table (see SymbolTable) */
+    StringInternerScope stringInternerScope;
+
+    /* Guard the compile budgets while the caller configures any; the frontend token funnel performs the checks */
+    CompileBudgetScope compileBudgetScope(inputDesc);
+
+    /* Validate arguments */
+    if (!inputDesc.sourceCode && !inputDesc.sourceCodeBuffer)
+        throw std::invalid_argument("input stream must not be null");
+
+    for (const auto& outputDesc : outputDescs)
+    {
+        if (!outputDesc.sourceCode && !outputDesc.sourceCodeString)
+            throw std::invalid_argument("output stream must not be null");
+        if (outputDesc.shaderVersion == OutputShaderVersion::GLSL110)
+            throw std::invalid_argument("output shader version 'GLSL 1.10' is not supported");
+        if (outputDesc.shaderVersion == OutputShaderVersion::GLSL120)
+            throw std::invalid_argument("output shader version 'GLSL 1.20' is not supported");
+    }
+
+    /* Pre-process input code once for all variants (the include closure is shared, too) */
+    auto dependenciesRequested = false;
+    for (const auto& outputDesc : outputDescs)
+        dependenciesRequested = (dependenciesRequested || outputDesc.includeDependencies != nullptr);
+
+    std::vector<std::string> macros;
+    std::vector<CompileCache::IncludeReference> includeDependencies;
+
+    auto processedInput = PreProcessInput(
+        inputDesc, log, &macros, (dependenciesRequested ? &includeDependencies : nullptr)
+    );
+
+    if (!processedInput)
+        return SubmitError("preprocessing input code failed");
+
+    auto onlyPreProcess = true;
+
+    for (auto& outputDesc : outputDescs)
+    {
+        if (outputDesc.statistics)
+            outputDesc.statistics->macros = macros;
+
+        if (outputDesc.includeDependencies)
+            *outputDesc.includeDependencies = includeDependencies;
+
+        if (outputDesc.options.preprocessOnly)
+        {
+            /* Write preprocessed output for this variant (without consuming the stream) */
+            if (auto outputStream = dynamic_cast<std::stringstream*>(processedInput.get()))
+            {
+                if (outputDesc.sourceCodeCallback)
+                {
+                    const auto processedSource = outputStream->str();
+                    outputDesc.sourceCodeCallback(processedSource.data(), processedSource.size());
+                }
+                else if (outputDesc.sourceCodeString)
+                    *outputDesc.sourceCodeString = outputStream->str();
+                else
+                    (*outputDesc.sourceCode) << outputStream->str();
+            }
+        }
+        else
+            onlyPreProcess = false;
+    }
+
+    if (onlyPreProcess)
+        return true;
+
+    /*
+    Keep preprocessed source as contiguous buffer: the expensive preprocessing
+    (include resolution and macro expansion) is shared across all variants.
+    */
+    std::string processedSource;
+    if (auto outputStream = dynamic_cast<std::stringstream*>(processedInput.get()))
+        processedSource = outputStream->str();
+    else
+        processedSource.assign(std::istreambuf_iterator<char>(*processedInput), std::istreambuf_iterator<char>());
+
+    /* Collect all variants that require code generation */
+    std::vector<ShaderOutput*> codeVariants;
+    for (auto& outputDesc : outputDescs)
+    {
+        if (!outputDesc.options.preprocessOnly)
+            codeVariants.push_back(&outputDesc);
+    }
+
+    /*
+    The decorated AST can only be shared across variants when they agree on all options
+    that shape the AST itself (the output shader version does not, see GLSLGenerator::GenerateCodePrimary).
+    */
+    auto canShareProgram = true;
+    for (auto outputDesc : codeVariants)
+    {
+        const auto& first = *codeVariants.front();
+        if ( outputDesc->options.optimize       != first.options.optimize       ||
+             outputDesc->options.preferWrappers != first.options.preferWrappers ||
+             outputDesc->formatting.prefix      != first.formatting.prefix )
+        {
+            canShareProgram = false;
+            break;
+        }
+    }
+
+    if (!canShareProgram)
+    {
+        /* Parse, analyze, optimize, and generate code for each variant from its own AST */
+        auto CompileVariantFromOwnAST = [&](ShaderOutput& outputDesc) -> bool
+        {
+            HLSLParser parser(log);
+            parser.SetErrorLimit(inputDesc.maxErrors);
+            parser.ConcurrentLexing(inputDesc.concurrentLexing);
+
+            auto sourceCode = std::make_shared<SourceCode>(processedSource.data(), processedSource.size());
+
+            /* The preprocessed source outlives all variant compilations, so token spellings can be stored as views */
+            sourceCode->MarkPersistentBuffer();
+
+            auto program = parser.ParseSource(sourceCode);
+
+            if (!program)
+                return SubmitError("parsing input code failed");
+
+            HLSLAnalyzer analyzer(log);
+            if (!analyzer.DecorateAST(*program, inputDesc, outputDesc))
+                return SubmitError("analyzing input code failed");
+
+            /* Print AST */
+            if (outputDesc.options.showAST && log)
+            {
+                ASTPrinter printer;
+                printer.PrintAST(program.get(), *log);
+            }
+
+            /* Dump AST in binary form (see ShaderOutput::astDumpOutput) */
+            if (outputDesc.astDumpOutput)
+            {
+                ASTSerializer serializer;
+                serializer.SerializeAST(program.get(), *outputDesc.astDumpOutput);
+            }
+
+            if (outputDesc.options.optimize)
+            {
+                Optimizer optimizer;
+                optimizer.Optimize(*program, outputDesc.formatting.prefix);
+            }
+
+            GLSLGenerator generator(log);
+            if (!generator.GenerateCode(*program, inputDesc, outputDesc, log))
+                return SubmitError("generating output code failed");
+
+            return true;
+        };
+
+        auto result = true;
+
+        for (auto outputDescRef : codeVariants)
+        {
+            #ifdef XSC_ENABLE_MEMORY_POOL
+
+            /*
+            The entire AST of one variant is dead once its code is emitted (the output went into heap
+            strings and streams): checkpoint the arena before the variant and rewind it afterwards,
+            so the peak arena memory stays at one variant instead of the sum over all variants.
+            */
+            auto pool = MemoryPool::Active();
+            const auto arenaMarker = (pool != nullptr ? pool->Mark() : MemoryPool::Marker());
+
+            #endif
+
+            if (!CompileVariantFromOwnAST(*outputDescRef))
+                result = false;
+
+            #ifdef XSC_ENABLE_MEMORY_POOL
+
+            if (pool != nullptr)
+                pool->RewindTo(arenaMarker);
+
+            #endif
+        }
+
+        return result;
+    }
+
+    /* Parse and analyze input code once for all variants */
+    auto& primaryDesc = *codeVariants.front();
+
+    HLSLParser parser(log);
+    parser.SetErrorLimit(inputDesc.maxErrors);
+    parser.ConcurrentLexing(inputDesc.concurrentLexing);
+
+    auto sharedSourceCode = std::make_shared<SourceCode>(processedSource.data(), processedSource.size());
+
+    /* The preprocessed source outlives all variant compilations, so token spellings can be stored as views */
+    sharedSourceCode->MarkPersistentBuffer();
+
+    auto program = parser.ParseSource(sharedSourceCode);
+
+    if (!program)
+        return SubmitError("parsing input code failed");
+
+    HLSLAnalyzer analyzer(log);
+    if (!analyzer.DecorateAST(*program, inputDesc, primaryDesc))
+        return SubmitError("analyzing input code failed");
+
+    /* Forward the sampler-state statistics to the remaining variants, since the analysis ran only once */
+    if (primaryDesc.statistics)
+    {
+        for (std::size_t i = 1; i < codeVariants.size(); ++i)
+        {
+            if (auto statistics = codeVariants[i]->statistics)
+                statistics->samplerStates = primaryDesc.statistics->samplerStates;
+        }
+    }
+
+    /* Print AST */
+    if (primaryDesc.options.showAST && log)
+    {
+        ASTPrinter printer;
+        printer.PrintAST(program.get(), *log);
+    }
+
+    /* Dump AST in binary form (see ShaderOutput::astDumpOutput) */
+    if (primaryDesc.astDumpOutput)
+    {
+        ASTSerializer serializer;
+        serializer.SerializeAST(program.get(), *primaryDesc.astDumpOutput);
+    }
+
+    if (primaryDesc.options.optimize)
+    {
+        Optimizer optimizer;
+        optimizer.Optimize(*program, primaryDesc.formatting.prefix);
+    }
+
+    /* Emit the primary variant; this converts the program for GLSL code generation (see Program::isConvertedGLSL) */
+    auto result = true;
+    {
+        GLSLGenerator generator(log);
+        if (!generator.GenerateCode(*program, inputDesc, primaryDesc, log))
+            result = SubmitError("generating output code failed");
+    }
+
+    if (codeVariants.size() > 1 && result)
+    {
+        /* Materialize all type denoters, so the concurrent emission passes only read the (now frozen) AST */
+        TypeDenoterMaterializer materializer;
+        materializer.MaterializeTypes(*program);
+
+        /* Emit all remaining variants concurrently from the shared program */
+        std::mutex logMutex;
+        SynchronizedLog sharedLog(log, logMutex);
+        auto sharedLogRef = (log != nullptr ? &sharedLog : nullptr);
+
+        std::atomic_bool emissionFailed;
+        emissionFailed = false;
+
+        std::vector<std::thread> workerThreads;
+        workerThreads.reserve(codeVariants.size() - 1);
+
+        for (std::size_t i = 1; i < codeVariants.size(); ++i)
+        {
+            auto outputDescRef = codeVariants[i];
+            workerThreads.emplace_back(
+                [&, outputDescRef]()
+                {
+                    GLSLGenerator generator(static_cast<Log*>(sharedLogRef));
+                    if (!generator.GenerateCode(*program, inputDesc, *outputDescRef, sharedLogRef))
+                        emissionFailed = true;
+                }
+            );
+        }
+
+        for (auto& thread : workerThreads)
+            thread.join();
+
+        if (emissionFailed)
+            result = SubmitError("generating output code failed");
+    }
+
+    return result;
+}
+
+// Sorts the binding statistics by their binding locations.
+static void SortStatistics(Statistics* statistics)
+{
+    if (statistics)
+    {
+        auto SortStats = [](std::vector<Statistics::Binding>& objects)
+        {
+            std::sort(
+                objects.begin(), objects.end(),
+                [](const Statistics::Binding& lhs, const Statistics::Binding& rhs)
+                {
+                    return (lhs.location < rhs.location);
+                }
+            );
+        };
+
+        SortStats(statistics->textures);
+        SortStats(statistics->constantBuffers);
+        SortStats(statistics->fragmentTargets);
+    }
+}
+
+
+// Serves the compilation from the output cache, or compiles and stores the result (see OutputCacheStore).
+static bool CompileShaderWithOutputCache(
+    const ShaderInput& inputDesc, const ShaderOutput& outputDesc, Log* log,
+    std::array<TimePoint, 6>& timePoints, CompilerContext* context,
+    const std::atomic<bool>* cancelToken)
+{
+    /* Validate the output target up front, since a cache hit bypasses the primary compile function */
+    if (!outputDesc.sourceCode && !outputDesc.sourceCodeString && !outputDesc.sourceCodeCallback && !outputDesc.outputCompressor)
+        throw std::invalid_argument("output stream must not be null");
+
+    /* Materialize the source content once, so it can be fingerprinted and then compiled without re-reading */
+    std::string sourceContent;
+    auto inputDescCopy = inputDesc;
+
+    if (inputDesc.sourceCodeBuffer == nullptr)
+    {
+        if (!inputDesc.sourceCode)
+            throw std::invalid_argument("input stream must not be null");
+
+        sourceContent.assign(
+            std::istreambuf_iterator<char>(*inputDesc.sourceCode),
+            std::istreambuf_iterator<char>()
+        );
+
+        inputDescCopy.sourceCodeBuffer      = sourceContent.data();
+        inputDescCopy.sourceCodeBufferSize  = sourceContent.size();
+        inputDescCopy.sourceCode            = nullptr;
+    }
+
+    const auto key = OutputCacheKey(
+        inputDescCopy.sourceCodeBuffer, inputDescCopy.sourceCodeBufferSize, inputDesc, outputDesc
+    );
+
+    std::unique_ptr<IncludeHandler> stdIncludeHandler;
+    if (!inputDesc.includeHandler)
+        stdIncludeHandler = std::unique_ptr<IncludeHandler>(new IncludeHandler());
+
+    auto& includeHandler = (inputDesc.includeHandler != nullptr ? *inputDesc.includeHandler : *stdIncludeHandler);
+
+    /* Try to serve the compilation from the cache (validated against the include closure) */
+    std::string blob;
+
+    if (inputDesc.outputCache->Fetch(key, blob))
+    {
+        OutputCacheEntry entry;
+
+        auto upToDate =
+        (
+            DeserializeOutputCacheEntry(blob, entry) &&
+            ValidateIncludeClosure(entry.includes, includeHandler)
+        );
+
+        if (upToDate && outputDesc.reflectionData != nullptr)
+        {
+            std::istringstream reflectionStream(entry.reflection);
+            upToDate = Reflection::DeserializeReflection(reflectionStream, *outputDesc.reflectionData);
+        }
+
+        if (upToDate)
+            return WriteRetainedOutput(entry.outputCode, outputDesc);
+    }
+
+    /* Compile into a retained buffer and record the include closure for later validation */
+    OutputCacheEntry entry;
+    CacheIncludeHandler cacheIncludeHandler(includeHandler, entry.includes);
+
+    inputDescCopy.includeHandler    = &cacheIncludeHandler;
+    inputDescCopy.outputCache       = nullptr;
+
+    Reflection::ReflectionData reflection;
+    auto outputDescCopy = outputDesc;
+
+    outputDescCopy.sourceCodeString     = &entry.outputCode;
+    outputDescCopy.sourceCodeCallback   = nullptr;
+    outputDescCopy.outputCompressor     = nullptr;
+    outputDescCopy.reflectionData       = &reflection;
+
+    if (!CompileShaderPrimary(inputDescCopy, outputDescCopy, log, timePoints, context, cancelToken))
+        return false;
+
+    /* Serialize and store the entry, then serve the requested output target from the retained buffer */
+    std::ostringstream reflectionStream;
+    Reflection::SerializeReflection(reflection, reflectionStream);
+    entry.reflection = reflectionStream.str();
+
+    inputDesc.outputCache->Store(key, SerializeOutputCacheEntry(entry));
+
+    if (outputDesc.reflectionData != nullptr)
+        *outputDesc.reflectionData = std::move(reflection);
+
+    return WriteRetainedOutput(entry.outputCode, outputDesc);
+}
+
+static bool CompileShaderExtern(
+    const ShaderInput& inputDesc, const ShaderOutput& outputDesc, Log* log,
+    CompilerContext* context, const std::atomic<bool>* cancelToken = nullptr)
+{
+    std::array<TimePoint, 6> timePoints;
+
+    /* Make copy of output descriptor to support validation without output stream */
+    std::stringstream dummyOutputStream;
+
+    auto outputDescCopy = outputDesc;
+
+    if (outputDescCopy.options.validateOnly || outputDescCopy.options.metadataOnly)
+        outputDescCopy.sourceCode = &dummyOutputStream;
+
+    /* Compile shader with primary function, optionally through the output cache */
+    auto result = false;
+
+    if ( inputDesc.outputCache != nullptr &&
+         !outputDescCopy.options.preprocessOnly && !outputDescCopy.options.validateOnly )
+    {
+        result = CompileShaderWithOutputCache(inputDesc, outputDescCopy, log, timePoints, context, cancelToken);
+    }
+    else
+        result = CompileShaderPrimary(inputDesc, outputDescCopy, log, timePoints, context, cancelToken);
+
+    /* Sort statistics */
+    SortStatistics(outputDescCopy.statistics);
+
+    /* Show timings */
+    if (outputDescCopy.options.showTimes && log)
+    {
+        auto PrintTimePoint = [log](const std::string& processName, const TimePoint startTime, const TimePoint endTime)
+        {
+            auto duration = (endTime > startTime ? std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::duration<float>(endTime - startTime)).count() : 0ll);
+            log->SumitReport(Report(Report::Types::Info, "timing " + processName + std::to_string(duration) + " ms"));
+        };
+
+        PrintTimePoint("pre-processing:   ", timePoints[0], timePoints[1]);
+        PrintTimePoint("parsing:          ", timePoints[1], timePoints[2]);
+        PrintTimePoint("context analysis: ", timePoints[2], timePoints[3]);
+        PrintTimePoint("optimization:     ", timePoints[3], timePoints[4]);
+        PrintTimePoint("code generation:  ", timePoints[4], timePoints[5]);
+    }
+
+    return result;
+}
+
+
+/*
+ * Public functions
+ */
+
+XSC_EXPORT bool CompileShader(const ShaderInput& inputDesc, const ShaderOutput& outputDesc, Log* log)
+{
+    return CompileShaderExtern(inputDesc, outputDesc, log, nullptr);
+}
+
+XSC_EXPORT bool CompileShader(const ShaderInput& inputDesc, const ShaderOutput& outputDesc, Log* log, CompilerContext& context)
+{
+    return CompileShaderExtern(inputDesc, outputDesc, log, &context);
+}
+
+/*
+ * CompilationHandle
+ */
+
+struct CompilationHandle::State
+{
+    std::atomic<bool>       cancelled { false };
+    bool                    finished  = false;
+    bool                    result    = false;
+
+    std::mutex              mutex;
+    std::condition_variable finishedCondition;
+};
+
+CompilationHandle::CompilationHandle(const std::shared_ptr<State>& state) :
+    state_{ state }
+{
+}
+
+bool CompilationHandle::Wait()
+{
+    if (state_)
+    {
+        std::unique_lock<std::mutex> lock { state_->mutex };
+        state_->finishedCondition.wait(lock, [this]() { return state_->finished; });
+        return state_->result;
+    }
+    return false;
+}
+
+bool CompilationHandle::Finished() const
+{
+    if (state_)
+    {
+        std::lock_guard<std::mutex> guard { state_->mutex };
+        return state_->finished;
+    }
+    return true;
+}
+
+void CompilationHandle::Cancel()
+{
+    if (state_)
+        state_->cancelled = true;
+}
+
+bool CompilationHandle::Cancelled() const
+{
+    return (state_ != nullptr && state_->cancelled);
+}
+
+XSC_EXPORT bool PrecompileHeader(const ShaderInput& inputDesc, std::ostream& moduleStream, Log* log)
+{
+    /* Validate arguments */
+    if (!inputDesc.sourceCode && !inputDesc.sourceCodeBuffer)
+        throw std::invalid_argument("input stream must not be null");
+
+    auto inputSource = (
+        inputDesc.sourceCodeBuffer != nullptr
+            ? std::make_shared<SourceCode>(inputDesc.sourceCodeBuffer, inputDesc.sourceCodeBufferSize)
+            : std::make_shared<SourceCode>(inputDesc.sourceCode)
+    );
+
+    /* The input source outlives the scanned tokens, so token spellings can be stored as views */
+    inputSource->MarkPersistentBuffer();
+
+    /* Scan the header into a token stream, including the end-of-stream token */
+    PreProcessorScanner scanner(log);
+
+    if (!scanner.ScanSource(inputSource))
+        return false;
+
+    std::vector<TokenPtr> tokens;
+
+    try
+    {
+        for (;;)
+        {
+            auto tkn = scanner.Next();
+            if (!tkn)
+                return false;
+
+            tokens.push_back(tkn);
+
+            if (tkn->Type() == Token::Types::EndOfStream)
+                break;
+        }
+    }
+    catch (const Report& err)
+    {
+        if (log)
+            log->SumitReport(err);
+        return false;
+    }
+
+    return TokenModule::Write(tokens, moduleStream);
+}
+
+XSC_EXPORT CompilationHandle CompileShaderAsync(const ShaderInput& inputDesc, const ShaderOutput& outputDesc, Log* log)
+{
+    auto state = std::make_shared<CompilationHandle::State>();
+
+    /* Copy the descriptors into the job; the streams and strings they reference remain owned by the caller */
+    ThreadPool::Instance().Enqueue(
+        [state, inputDesc, outputDesc, log]()
+        {
+            bool result = false;
+
+            if (!state->cancelled)
+            {
+                try
+                {
+                    result = CompileShaderExtern(inputDesc, outputDesc, log, nullptr, &state->cancelled);
+                }
+                catch (const std::exception& err)
+                {
+                    if (log)
+                        log->SumitReport(Report(Report::Types::Error, err.what()));
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> guard { state->mutex };
+                state->result   = result;
+                state->finished = true;
+            }
+            state->finishedCondition.notify_all();
+        }
+    );
+
+    return CompilationHandle(state);
+}
+
+XSC_EXPORT bool CompileShaderVariants(
+    const ShaderInput& inputDesc, const std::vector<ShaderOutput>& outputDescs, Log* log)
+{
+    /* Make copies of the output descriptors to support validation without output streams */
+    std::stringstream dummyOutputStream;
+
+    auto outputDescsCopy = outputDescs;
+
+    for (auto& outputDesc : outputDescsCopy)
+    {
+        if (outputDesc.options.validateOnly || outputDesc.options.metadataOnly)
+            outputDesc.sourceCode = &dummyOutputStream;
+    }
+
+    /* Compile all shader variants with primary function */
+    auto result = CompileShaderVariantsPrimary(inputDesc, outputDescsCopy, log);
+
+    /* Sort statistics */
+    for (auto& outputDesc : outputDescsCopy)
+        SortStatistics(outputDesc.statistics);
+
+    return result;
+}
+
+/*
+ * ShaderUnit class
+ */
+
+struct ShaderUnit::State
+{
+    #ifdef XSC_ENABLE_MEMORY_POOL
+    // Arena holding the tokens and AST of this unit; declared first, so it outlives the objects allocated from it.
+    MemoryPool      memoryPool;
+    #endif
+
+    // Interning table used while the unit is parsed.
+    StringInterner  stringInterner;
+
+    // Filename of the unit (as specified in the shader input descriptor).
+    std::string     filename;
+
+    // Retained pre-processed token stream of the unit, shared into every linked compilation (see CompileLinkedShader).
+    TokenPtrString  tokens;
+
+    // Pre-processed source the token spellings refer into.
+    SourceCodePtr   source;
+
+    // The unit's own parsed program (undecorated); its syntax errors are reported once, when the unit is parsed.
+    ProgramPtr      program;
+};
+
+ShaderUnit::ShaderUnit() :
+    state_{ MakeUnique<State>() }
+{
+}
+
+ShaderUnit::~ShaderUnit()
+{
+    // dtor for incomplete type "State" must be defined here
+}
+
+const std::string& ShaderUnit::Filename() const
+{
+    return state_->filename;
+}
+
+ShaderUnit::State& ShaderUnit::GetState()
+{
+    return *state_;
+}
+
+const ShaderUnit::State& ShaderUnit::GetState() const
+{
+    return *state_;
+}
+
+XSC_EXPORT ShaderUnitPtr ParseShaderUnit(const ShaderInput& inputDesc, Log* log)
+{
+    /* Validate arguments */
+    if (!inputDesc.sourceCode && !inputDesc.sourceCodeBuffer)
+        throw std::invalid_argument("input stream must not be null");
+
+    ShaderUnitPtr unit(new ShaderUnit());
+    auto& state = unit->GetState();
+
+    #ifdef XSC_ENABLE_MEMORY_POOL
+    /* Allocate the tokens and AST of this unit from its own retained arena */
+    MemoryPoolScope memoryPoolScope(state.memoryPool);
+
+    if (auto pool = MemoryPool::Active())
+        pool->ReserveForInput(EstimateInputSize(inputDesc));
+    #endif
+
+    StringInternerScope stringInternerScope(state.stringInterner);
+
+    /* Pre-process the unit into a token string (include resolution and macro expansion run only here) */
+    SourceCodePtr inputSource;
+    auto processedTokens = PreProcessInputTokens(inputDesc, log, nullptr, inputSource, nullptr);
+
+    if (!processedTokens)
+        return nullptr;
+
+    /* Parse the unit into its own program, so its syntax errors are reported once and not once per combination */
+    HLSLParser parser(log);
+    parser.SetErrorLimit(inputDesc.maxErrors);
+
+    auto program = parser.ParseTokenString(*processedTokens, inputSource);
+    if (!program)
+        return nullptr;
+
+    state.filename  = inputDesc.filename;
+    state.tokens    = std::move(*processedTokens);
+    state.source    = inputSource;
+    state.program   = program;
+
+    return unit;
+}
+
+XSC_EXPORT bool CompileLinkedShader(
+    const std::vector<ShaderUnit*>& units, const ShaderInput& inputDesc, const ShaderOutput& outputDesc, Log* log)
 {
     auto SubmitError = [log](const char* msg)
     {
@@ -41,9 +1742,17 @@ static bool CompileShaderPrimary(
     };
 
     /* Validate arguments */
-    if (!inputDesc.sourceCode)
-        throw std::invalid_argument("input stream must not be null");
-    if (!outputDesc.sourceCode)
+    if (units.empty())
+        throw std::invalid_argument("shader unit list must not be empty");
+
+    for (auto unit : units)
+    {
+        if (unit == nullptr)
+            throw std::invalid_argument("shader unit must not be null");
+    }
+
+    if ( !outputDesc.sourceCode && !outputDesc.sourceCodeString && !outputDesc.sourceCodeCallback &&
+         !outputDesc.outputCompressor && !outputDesc.options.validateOnly )
         throw std::invalid_argument("output stream must not be null");
 
     if (outputDesc.shaderVersion == OutputShaderVersion::GLSL110)
@@ -51,46 +1760,41 @@ static bool CompileShaderPrimary(
     if (outputDesc.shaderVersion == OutputShaderVersion::GLSL120)
         throw std::invalid_argument("output shader version 'GLSL 1.20' is not supported");
 
-    /* Pre-process input code */
-    timePoints[0] = Time::now();
-
-    std::unique_ptr<IncludeHandler> stdIncludeHandler;
-    if (!inputDesc.includeHandler)
-        stdIncludeHandler = std::unique_ptr<IncludeHandler>(new IncludeHandler());
+    #ifdef XSC_ENABLE_MEMORY_POOL
+    /* All AST nodes of this combination are allocated from one arena, which is dropped at the end of this scope */
+    MemoryPoolScope memoryPoolScope;
+    #endif
 
-    PreProcessor preProcessor(
-        (inputDesc.includeHandler != nullptr ? *inputDesc.includeHandler : *stdIncludeHandler),
-        log
-    );
+    /* All identifiers of this combination share one interning table (see SymbolTable) */
+    StringInternerScope stringInternerScope;
 
-    auto processedInput = preProcessor.Process(
-        std::make_shared<SourceCode>(inputDesc.sourceCode),
-        inputDesc.filename
-    );
+    /* Accumulate hot-path counters while the caller requests instrumentation (see ActiveCompileStats) */
+    CompileStatsScope compileStatsScope(outputDesc.compileStats);
 
-    if (outputDesc.statistics)
-        outputDesc.statistics->macros = preProcessor.ListDefinedMacroIdents();
+    /* Record trace-event spans while the caller requests them (see ShaderOutput::traceOutput) */
+    TraceSessionScope traceSessionScope(outputDesc.traceOutput);
 
-    if (!processedInput)
-        return SubmitError("preprocessing input code failed");
+    /* Merge the retained token streams of all units by sharing their token pools, without copying the tokens */
+    TokenPtrString mergedTokens;
 
-    if (outputDesc.options.preprocessOnly)
-    {
-        (*outputDesc.sourceCode) << processedInput->rdbuf();
-        return true;
-    }
+    for (auto unit : units)
+        mergedTokens.PushBack(unit->GetState().tokens);
 
-    /* Parse HLSL input code */
-    timePoints[1] = Time::now();
+    /* Parse the merged stream into one combined program */
+    TraceStageBegin("parse");
 
     HLSLParser parser(log);
-    auto program = parser.ParseSource(std::make_shared<SourceCode>(std::move(processedInput)));
+    parser.SetErrorLimit(inputDesc.maxErrors);
 
+    auto program = parser.ParseTokenString(mergedTokens, units.front()->GetState().source);
     if (!program)
-        return SubmitError("parsing input code failed");
+        return SubmitError("parsing linked shader units failed");
 
-    /* Small context analysis */
-    timePoints[2] = Time::now();
+    /*
+    Analyze the combined program: all global declarations are registered in one shared symbol
+    environment here, which resolves cross-unit references exactly like in a concatenated source
+    */
+    TraceStageBegin("analyze");
 
     HLSLAnalyzer analyzer(log);
     auto analyzerResult = analyzer.DecorateAST(*program, inputDesc, outputDesc);
@@ -102,86 +1806,142 @@ static bool CompileShaderPrimary(
         printer.PrintAST(program.get(), *log);
     }
 
-    if (!analyzerResult)
-        return SubmitError("analyzing input code failed");
+    /* Dump AST in binary form (see ShaderOutput::astDumpOutput) */
+    if (outputDesc.astDumpOutput)
+    {
+        ASTSerializer serializer;
+        serializer.SerializeAST(program.get(), *outputDesc.astDumpOutput);
+    }
 
-    /* Optimize AST */
-    timePoints[3] = Time::now();
+    if (!analyzerResult)
+        return SubmitError("analyzing linked shader units failed");
 
-    if (outputDesc.options.optimize)
+    if (outputDesc.options.validateOnly)
     {
-        Optimizer optimizer;
-        optimizer.Optimize(*program);
+        /* Still verify the entry point here, since its absence is otherwise first reported by the code generator */
+        if (program->entryPointRef == nullptr)
+        {
+            if (log)
+                log->SumitReport(Report(Report::Types::Error, "entry point \"" + inputDesc.entryPoint + "\" not found"));
+            return false;
+        }
     }
+    else
+    {
+        /* Optimize AST */
+        TraceStageBegin("optimize");
+
+        if (outputDesc.options.optimize)
+        {
+            Optimizer optimizer;
+            optimizer.Optimize(*program, outputDesc.formatting.prefix);
+        }
 
-    /* Generate GLSL output code */
-    timePoints[4] = Time::now();
+        /* Generate GLSL output code */
+        TraceStageBegin("generate");
 
-    GLSLGenerator generator(log);
-    if (!generator.GenerateCode(*program, inputDesc, outputDesc, log))
-        return SubmitError("generating output code failed");
+        GLSLGenerator generator(log);
+        if (!generator.GenerateCode(*program, inputDesc, outputDesc, log))
+            return SubmitError("generating output code failed");
+    }
+
+    TraceStageEnd();
 
-    timePoints[5] = Time::now();
+    SortStatistics(outputDesc.statistics);
 
     return true;
 }
 
-
 /*
- * Public functions
- */
+Small built-in shader for the warm-up compile. It exercises every pipeline stage, so all lazily
+initialized tables are touched: macro expansion in the preprocessor, the scanner keyword tables,
+overload resolution, semantics, and intrinsics in the analyzer, and the GLSL keyword and
+intrinsic tables of the backend.
+*/
+static const char* warmupShaderSource_ =
+(
+    "#define WARMUP_SCALE 0.5\n"
+    "Texture2D warmupTex : register(t0);\n"
+    "SamplerState warmupSampler : register(s0);\n"
+    "cbuffer WarmupSettings : register(b0) { float4x4 wvpMatrix; float4 tint; };\n"
+    "struct WarmupVertexIn { float3 position : POSITION; float2 texCoord : TEXCOORD0; };\n"
+    "struct WarmupVertexOut { float4 position : SV_Position; float2 texCoord : TEXCOORD0; };\n"
+    "WarmupVertexOut VS(WarmupVertexIn inp) {\n"
+    "    WarmupVertexOut outp;\n"
+    "    outp.position = mul(wvpMatrix, float4(inp.position, 1));\n"
+    "    outp.texCoord = inp.texCoord * WARMUP_SCALE;\n"
+    "    return outp;\n"
+    "}\n"
+    "float4 PS(WarmupVertexOut inp) : SV_Target {\n"
+    "    float4 color = warmupTex.Sample(warmupSampler, inp.texCoord);\n"
+    "    clip(color.a - 0.5);\n"
+    "    return saturate(color * tint) + sin(color.x);\n"
+    "}\n"
+);
 
-XSC_EXPORT bool CompileShader(const ShaderInput& inputDesc, const ShaderOutput& outputDesc, Log* log)
+XSC_EXPORT bool Warmup(CompilerInstance* instance)
 {
-    std::array<TimePoint, 6> timePoints;
+    struct WarmupStage
+    {
+        const char*     entryPoint;
+        ShaderTarget    shaderTarget;
+    };
 
-    /* Make copy of output descriptor to support validation without output stream */
-    std::stringstream dummyOutputStream;
+    static const WarmupStage stages[] =
+    {
+        { "VS", ShaderTarget::VertexShader   },
+        { "PS", ShaderTarget::FragmentShader },
+    };
 
-    auto outputDescCopy = outputDesc;
+    bool succeeded = true;
 
-    if (outputDescCopy.options.validateOnly)
-        outputDescCopy.sourceCode = &dummyOutputStream;
+    for (const auto& stage : stages)
+    {
+        ShaderInput inputDesc;
+        {
+            inputDesc.filename              = "<warmup>";
+            inputDesc.sourceCodeBuffer      = warmupShaderSource_;
+            inputDesc.sourceCodeBufferSize  = std::strlen(warmupShaderSource_);
+            inputDesc.entryPoint            = stage.entryPoint;
+            inputDesc.shaderTarget          = stage.shaderTarget;
+        }
 
-    /* Compile shader with primary function */
-    auto result = CompileShaderPrimary(inputDesc, outputDescCopy, log, timePoints);
+        std::string outputCode;
 
-    /* Sort statistics */
-    if (outputDescCopy.statistics)
-    {
-        auto SortStats = [](std::vector<Statistics::Binding>& objects)
+        ShaderOutput outputDesc;
         {
-            std::sort(
-                objects.begin(), objects.end(),
-                [](const Statistics::Binding& lhs, const Statistics::Binding& rhs)
-                {
-                    return (lhs.location < rhs.location);
-                }
-            );
-        };
+            outputDesc.sourceCodeString     = &outputCode;
+            outputDesc.options.optimize     = true;
+        }
 
-        SortStats(outputDescCopy.statistics->textures);
-        SortStats(outputDescCopy.statistics->constantBuffers);
-        SortStats(outputDescCopy.statistics->fragmentTargets);
+        try
+        {
+            if (instance != nullptr)
+                succeeded = instance->CompileShader(inputDesc, outputDesc) && succeeded;
+            else
+                succeeded = CompileShader(inputDesc, outputDesc) && succeeded;
+        }
+        catch (const std::exception&)
+        {
+            succeeded = false;
+        }
     }
 
-    /* Show timings */
-    if (outputDescCopy.options.showTimes && log)
-    {
-        auto PrintTimePoint = [log](const std::string& processName, const TimePoint startTime, const TimePoint endTime)
-        {
-            auto duration = (endTime > startTime ? std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::duration<float>(endTime - startTime)).count() : 0ll);
-            log->SumitReport(Report(Report::Types::Info, "timing " + processName + std::to_string(duration) + " ms"));
-        };
+    return succeeded;
+}
 
-        PrintTimePoint("pre-processing:   ", timePoints[0], timePoints[1]);
-        PrintTimePoint("parsing:          ", timePoints[1], timePoints[2]);
-        PrintTimePoint("context analysis: ", timePoints[2], timePoints[3]);
-        PrintTimePoint("optimization:     ", timePoints[3], timePoints[4]);
-        PrintTimePoint("code generation:  ", timePoints[4], timePoints[5]);
+XSC_EXPORT std::uint64_t DefineSetFingerprint(const ShaderInput& inputDesc)
+{
+    /* Chain an FNV-1a hash over all identifiers and values (the null terminators keep the encoding unambiguous) */
+    std::uint64_t fingerprint = HashData(nullptr, 0);
+
+    for (const auto& macro : inputDesc.predefinedMacros)
+    {
+        fingerprint = HashData(macro.ident.c_str(), macro.ident.size() + 1, fingerprint);
+        fingerprint = HashData(macro.value.c_str(), macro.value.size() + 1, fingerprint);
     }
 
-    return result;
+    return fingerprint;
 }
 
 XSC_EXPORT std::string TargetToString(const ShaderTarget target)
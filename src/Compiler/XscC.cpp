@@ -0,0 +1,197 @@
+/*
+ * XscC.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Xsc/XscC.h>
+#include <Xsc/Xsc.h>
+#include <Xsc/IncludeHandler.h>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+
+
+namespace
+{
+
+
+// Collects all reports as plain text lines, so the C caller needs no log interface.
+class BufferLog : public Xsc::Log
+{
+
+    public:
+
+        void SumitReport(const Xsc::Report& report) override
+        {
+            if (!report.Context().empty())
+                AppendLine(report.Context());
+
+            AppendLine(report.Message());
+
+            if (!report.Line().empty())
+            {
+                AppendLine(report.Line());
+                AppendLine(report.Marker());
+            }
+
+            for (const auto& hint : report.GetHints())
+                AppendLine(hint);
+        }
+
+        // Returns the collected report text ('\n' separated lines).
+        inline const std::string& Text() const
+        {
+            return text_;
+        }
+
+    private:
+
+        void AppendLine(const std::string& line)
+        {
+            text_ += line;
+            text_ += '\n';
+        }
+
+        std::string text_;
+
+};
+
+// Returns a malloc-allocated copy of the specified string (null terminated), owned by the caller.
+char* AllocBuffer(const std::string& str)
+{
+    auto buffer = reinterpret_cast<char*>(std::malloc(str.size() + 1));
+    if (buffer)
+    {
+        std::memcpy(buffer, str.data(), str.size());
+        buffer[str.size()] = '\0';
+    }
+    return buffer;
+}
+
+
+} // /anonymous namespace
+
+
+XSC_EXPORT int XscCompileShader(
+    const struct XscShaderInput* input, const struct XscShaderOutput* output, struct XscShaderResult* result)
+{
+    /* Fill the result structure on every return path, so "XscFreeShaderResult" is always safe */
+    if (result)
+    {
+        result->code        = nullptr;
+        result->codeSize    = 0;
+        result->report      = nullptr;
+        result->reportSize  = 0;
+    }
+
+    if (!input || !output || !result || !input->sourceCode || !input->entryPoint)
+        return XSC_RESULT_INVALID_ARGUMENT;
+
+    try
+    {
+        /* Fill the C++ input descriptor; the source buffer is referenced without a copy */
+        Xsc::ShaderInput inputDesc;
+
+        if (input->filename)
+            inputDesc.filename = input->filename;
+
+        inputDesc.sourceCodeBuffer      = input->sourceCode;
+        inputDesc.sourceCodeBufferSize  = input->sourceCodeSize;
+        inputDesc.entryPoint            = input->entryPoint;
+        inputDesc.shaderTarget          = static_cast<Xsc::ShaderTarget>(input->shaderTarget);
+        inputDesc.shaderVersion         = static_cast<Xsc::InputShaderVersion>(input->inputVersion);
+
+        if (input->macros)
+        {
+            inputDesc.predefinedMacros.reserve(input->numMacros);
+            for (size_t i = 0; i < input->numMacros; ++i)
+            {
+                const auto& macro = input->macros[i];
+                inputDesc.predefinedMacros.push_back({ macro.ident, (macro.value != nullptr ? macro.value : "") });
+            }
+        }
+
+        Xsc::IncludeHandler includeHandler;
+        if (input->includePaths)
+        {
+            for (size_t i = 0; i < input->numIncludePaths; ++i)
+                includeHandler.searchPaths.push_back(input->includePaths[i]);
+            inputDesc.includeHandler = &includeHandler;
+        }
+
+        /* Fill the C++ output descriptor; the code is generated into a string, which is handed over to the caller */
+        std::string code;
+
+        Xsc::ShaderOutput outputDesc;
+
+        outputDesc.sourceCodeString = &code;
+        outputDesc.shaderVersion    =
+        (
+            output->outputVersion == XSC_OUTPUT_GLSL_AUTO
+                ? Xsc::OutputShaderVersion::GLSL
+                : static_cast<Xsc::OutputShaderVersion>(output->outputVersion)
+        );
+
+        auto& options = outputDesc.options;
+        options.optimize            = ((output->options & XSC_OPTION_OPTIMIZE         ) != 0);
+        options.allowExtensions     = ((output->options & XSC_OPTION_ALLOW_EXTENSIONS ) != 0);
+        options.explicitBinding     = ((output->options & XSC_OPTION_EXPLICIT_BINDING ) != 0);
+        options.preserveComments    = ((output->options & XSC_OPTION_PRESERVE_COMMENTS) != 0);
+        options.preprocessOnly      = ((output->options & XSC_OPTION_PREPROCESS_ONLY  ) != 0);
+        options.validateOnly        = ((output->options & XSC_OPTION_VALIDATE_ONLY    ) != 0);
+
+        if (output->namePrefix)
+            outputDesc.formatting.prefix = output->namePrefix;
+
+        /* Compile and hand the buffers over to the caller */
+        BufferLog log;
+        auto succeeded = Xsc::CompileShader(inputDesc, outputDesc, &log);
+
+        if (!log.Text().empty())
+        {
+            result->report      = AllocBuffer(log.Text());
+            result->reportSize  = log.Text().size();
+        }
+
+        if (!succeeded)
+            return XSC_RESULT_COMPILE_FAILED;
+
+        result->code        = AllocBuffer(code);
+        result->codeSize    = code.size();
+
+        return XSC_RESULT_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        /* No exception may cross the C boundary; report it through the result buffer */
+        const std::string message = e.what();
+        result->report      = AllocBuffer(message);
+        result->reportSize  = message.size();
+        return XSC_RESULT_INTERNAL_ERROR;
+    }
+    catch (...)
+    {
+        return XSC_RESULT_INTERNAL_ERROR;
+    }
+}
+
+XSC_EXPORT void XscFreeShaderResult(struct XscShaderResult* result)
+{
+    if (result)
+    {
+        std::free(result->code);
+        std::free(result->report);
+
+        result->code        = nullptr;
+        result->codeSize    = 0;
+        result->report      = nullptr;
+        result->reportSize  = 0;
+    }
+}
+
+
+
+// ================================================================================
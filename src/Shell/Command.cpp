@@ -10,6 +10,7 @@
 #include "Shell.h"
 #include "Helper.h"
 #include <Xsc/ConsoleManip.h>
+#include <Xsc/CacheRegistry.h>
 #include <map>
 #include <fstream>
 #include <sstream>
@@ -236,6 +237,106 @@ void OutputCommand::Run(CommandLine& cmdLine, ShellState& state)
 }
 
 
+/*
+ * DependencyCommand class
+ */
+
+std::vector<Command::Identifier> DependencyCommand::Idents() const
+{
+    return { { "-MD" }, { "--dependencies" } };
+}
+
+HelpDescriptor DependencyCommand::Help() const
+{
+    return { "-MD, --dependencies FILE", "Write make-style dependency file (use '*' for the output filename)" };
+}
+
+void DependencyCommand::Run(CommandLine& cmdLine, ShellState& state)
+{
+    state.dependencyFilename = cmdLine.Accept();
+}
+
+
+/*
+ * BundleCommand class
+ */
+
+std::vector<Command::Identifier> BundleCommand::Idents() const
+{
+    return { { "-B" }, { "--bundle" } };
+}
+
+HelpDescriptor BundleCommand::Help() const
+{
+    return { "-B, --bundle FILE", "Append compiled outputs and reflection blobs to the shader bundle archive FILE" };
+}
+
+void BundleCommand::Run(CommandLine& cmdLine, ShellState& state)
+{
+    state.bundleFilename = cmdLine.Accept();
+}
+
+
+/*
+ * PreambleCommand class
+ */
+
+std::vector<Command::Identifier> PreambleCommand::Idents() const
+{
+    return { { "--preamble" } };
+}
+
+HelpDescriptor PreambleCommand::Help() const
+{
+    return { "--preamble FILE", "Emit intrinsic wrapper functions once into the shared preamble unit FILE instead of into each output" };
+}
+
+void PreambleCommand::Run(CommandLine& cmdLine, ShellState& state)
+{
+    state.preambleFilename = cmdLine.Accept();
+}
+
+
+/*
+ * TraceCommand class
+ */
+
+std::vector<Command::Identifier> TraceCommand::Idents() const
+{
+    return { { "--trace" } };
+}
+
+HelpDescriptor TraceCommand::Help() const
+{
+    return { "--trace FILE", "Write Chrome trace-event JSON for 'chrome://tracing' (requires the XSC_TRACE_EVENTS build option)" };
+}
+
+void TraceCommand::Run(CommandLine& cmdLine, ShellState& state)
+{
+    state.traceFilename = cmdLine.Accept();
+}
+
+
+/*
+ * MinifyCommand class
+ */
+
+std::vector<Command::Identifier> MinifyCommand::Idents() const
+{
+    return { { "--minify" } };
+}
+
+HelpDescriptor MinifyCommand::Help() const
+{
+    return { "--minify [ON/OFF]", "Minified output: no comments, indentation, or blank lines; default=OFF" };
+}
+
+void MinifyCommand::Run(CommandLine& cmdLine, ShellState& state)
+{
+    state.outputDesc.formatting.minify = cmdLine.AcceptBoolean(true);
+}
+
+
 /*
  * WarnCommand class
  */
@@ -504,6 +605,20 @@ void PresettingCommand::Run(CommandLine& cmdLine, ShellState& state)
         Shell::Instance()->ExecuteCommandLine(preset.cmdLine);
     };
 
+    auto RunAllPresettings = [&](std::vector<Presetting>& presets)
+    {
+        /* Run all presettings as one batch, so compatible jobs share their parsed and analyzed AST */
+        std::vector<CommandLine> cmdLines;
+
+        for (auto& preset : presets)
+        {
+            std::cout << "run presetting: \"" << preset.title << "\"" << std::endl;
+            cmdLines.push_back(preset.cmdLine);
+        }
+
+        Shell::Instance()->ExecutePresettings(cmdLines);
+    };
+
     std::vector<Presetting> presettings;
 
     static const char commentChar = '#';
@@ -551,8 +666,7 @@ void PresettingCommand::Run(CommandLine& cmdLine, ShellState& state)
         if (idx == 0)
         {
             /* Run all presettings */
-            for (auto& preset : presettings)
-                RunPresetting(preset);
+            RunAllPresettings(presettings);
         }
         else if (idx > 0)
         {
@@ -613,6 +727,9 @@ void HelpCommand::Run(CommandLine& cmdLine, ShellState& state)
 
     CommandFactory::Instance().GetHelpPrinter().PrintAll(std::cout, 2);
 
+    std::cout << "Remarks:" << std::endl;
+    std::cout << "  Arguments can also be read from a response file: xsc @FILE" << std::endl;
+    std::cout << "  Input filenames may contain the wildcards '*' and '?': xsc -T vert Shaders/*.hlsl" << std::endl;
     std::cout << "Example:" << std::endl;
     std::cout << "  xsc -E VS -T vert Example.hlsl -E PS -T frag Example.hlsl" << std::endl;
     std::cout << "   -> Output files: 'Example.VS.vert', and 'Example.PS.frag'" << std::endl;
@@ -735,6 +852,54 @@ void ValidateCommand::Run(CommandLine& cmdLine, ShellState& state)
 }
 
 
+/*
+ * MetadataCommand class
+ */
+
+std::vector<Command::Identifier> MetadataCommand::Idents() const
+{
+    return { { "--metadata-only" } };
+}
+
+HelpDescriptor MetadataCommand::Help() const
+{
+    return
+    {
+        "--metadata-only [" + CommandLine::GetBooleanOption() + "]",
+        "Enables/disables to only extract shader metadata; default=" + CommandLine::GetBooleanFalse()
+    };
+}
+
+void MetadataCommand::Run(CommandLine& cmdLine, ShellState& state)
+{
+    state.outputDesc.options.metadataOnly = cmdLine.AcceptBoolean(true);
+}
+
+
+/*
+ * MaxErrorsCommand class
+ */
+
+std::vector<Command::Identifier> MaxErrorsCommand::Idents() const
+{
+    return { { "--max-errors" } };
+}
+
+HelpDescriptor MaxErrorsCommand::Help() const
+{
+    return
+    {
+        "--max-errors COUNT",
+        "Aborts the current compilation pass after COUNT errors; 0 means unlimited (default)"
+    };
+}
+
+void MaxErrorsCommand::Run(CommandLine& cmdLine, ShellState& state)
+{
+    state.inputDesc.maxErrors = static_cast<std::size_t>(std::stoul(cmdLine.Accept()));
+}
+
+
 /*
  * BindingCommand class
  */
@@ -759,6 +924,30 @@ void BindingCommand::Run(CommandLine& cmdLine, ShellState& state)
 }
 
 
+/*
+ * TrimUniformsCommand class
+ */
+
+std::vector<Command::Identifier> TrimUniformsCommand::Idents() const
+{
+    return { { "--trim-uniforms" } };
+}
+
+HelpDescriptor TrimUniformsCommand::Help() const
+{
+    return
+    {
+        "--trim-uniforms [" + CommandLine::GetBooleanOption() + "]",
+        "Enables/disables removal of unreferenced trailing constant buffer members; default=" + CommandLine::GetBooleanFalse()
+    };
+}
+
+void TrimUniformsCommand::Run(CommandLine& cmdLine, ShellState& state)
+{
+    state.outputDesc.options.trimUniforms = cmdLine.AcceptBoolean(true);
+}
+
+
 /*
  * CommentCommand class
  */
@@ -807,6 +996,338 @@ void WrapperCommand::Run(CommandLine& cmdLine, ShellState& state)
 }
 
 
+/*
+ * JobsCommand class
+ */
+
+std::vector<Command::Identifier> JobsCommand::Idents() const
+{
+    return { { "-j" }, { "--jobs" } };
+}
+
+HelpDescriptor JobsCommand::Help() const
+{
+    return { "-j, --jobs N", "Compiles the input files with N parallel worker threads; default=1" };
+}
+
+void JobsCommand::Run(CommandLine& cmdLine, ShellState& state)
+{
+    auto value = cmdLine.Accept();
+    try
+    {
+        state.numThreads = static_cast<std::size_t>(std::stoul(value));
+    }
+    catch (const std::exception&)
+    {
+        throw std::invalid_argument("invalid number of jobs '" + value + "'");
+    }
+}
+
+
+/*
+ * ServerCommand class
+ */
+
+std::vector<Command::Identifier> ServerCommand::Idents() const
+{
+    return { { "--server" } };
+}
+
+HelpDescriptor ServerCommand::Help() const
+{
+    return
+    {
+        "--server", "Runs the shell as a resident compile server; reads one command line per line from stdin",
+        "Keeps caches warm across jobs; prints \"" + std::string(Shell::GetServerSentinel()) + "\" after each job. "
+        "With -j N, a scheduler dispatches the job lines to N warm worker threads (see --priority); "
+        "the control line \"stats\" prints the queue depth and latency figures"
+    };
+}
+
+void ServerCommand::Run(CommandLine& cmdLine, ShellState& state)
+{
+    state.serverMode = true;
+}
+
+
+/*
+ * WatchCommand class
+ */
+
+std::vector<Command::Identifier> WatchCommand::Idents() const
+{
+    return { { "--watch" } };
+}
+
+HelpDescriptor WatchCommand::Help() const
+{
+    return
+    {
+        "--watch", "Watches the input files and their includes, recompiling whenever one changes on disk",
+        "Must appear before the input files; terminate with Ctrl+C"
+    };
+}
+
+void WatchCommand::Run(CommandLine& cmdLine, ShellState& state)
+{
+    state.watchMode = true;
+}
+
+
+/*
+ * JobModeCommand class
+ */
+
+std::vector<Command::Identifier> JobModeCommand::Idents() const
+{
+    return { { "--job" } };
+}
+
+HelpDescriptor JobModeCommand::Help() const
+{
+    return
+    {
+        "--job", "Treats each input file as a serialized compile job: executes it and writes the result blob to '<FILE>.result'",
+        "Must appear before the input files; includes are fingerprint-checked against the local include tree"
+    };
+}
+
+void JobModeCommand::Run(CommandLine& cmdLine, ShellState& state)
+{
+    state.jobMode = true;
+}
+
+
+/*
+ * EmitJobCommand class
+ */
+
+std::vector<Command::Identifier> EmitJobCommand::Idents() const
+{
+    return { { "--emit-job" } };
+}
+
+HelpDescriptor EmitJobCommand::Help() const
+{
+    return
+    {
+        "--emit-job FILE", "Serializes each compilation into the compile job file FILE instead of compiling (use '*' for the output filename)",
+        "The job carries the source and the fingerprints of its include closure, but not the include files"
+    };
+}
+
+void EmitJobCommand::Run(CommandLine& cmdLine, ShellState& state)
+{
+    state.emitJobFilename = cmdLine.Accept();
+}
+
+
+/*
+ * DeterministicCommand class
+ */
+
+std::vector<Command::Identifier> DeterministicCommand::Idents() const
+{
+    return { { "--deterministic" } };
+}
+
+HelpDescriptor DeterministicCommand::Help() const
+{
+    return
+    {
+        "--deterministic [" + CommandLine::GetBooleanOption() + "]",
+        "Enables/disables byte-identical output for identical inputs (omits the timestamp comment); default=" + CommandLine::GetBooleanFalse()
+    };
+}
+
+void DeterministicCommand::Run(CommandLine& cmdLine, ShellState& state)
+{
+    state.outputDesc.options.deterministicOutput = cmdLine.AcceptBoolean(true);
+}
+
+
+/*
+ * DumpASTCommand class
+ */
+
+std::vector<Command::Identifier> DumpASTCommand::Idents() const
+{
+    return { { "--dump-ast" } };
+}
+
+HelpDescriptor DumpASTCommand::Help() const
+{
+    return
+    {
+        "--dump-ast FILE", "Writes a binary dump of the AST to the file FILE (use '*' for the output filename)",
+        "The dump contains fixed-width node records in pre-order and an interned string table, for analysis tooling"
+    };
+}
+
+void DumpASTCommand::Run(CommandLine& cmdLine, ShellState& state)
+{
+    state.astDumpFilename = cmdLine.Accept();
+}
+
+
+/*
+ * PriorityCommand class
+ */
+
+std::vector<Command::Identifier> PriorityCommand::Idents() const
+{
+    return { { "--priority" } };
+}
+
+HelpDescriptor PriorityCommand::Help() const
+{
+    return
+    {
+        "--priority CLASS", "Schedules the job in the priority class CLASS ('interactive' or 'batch') of the server scheduler; default='interactive'",
+        "Interactive jobs are dispatched before batch jobs; only effective with --server and -j N"
+    };
+}
+
+void PriorityCommand::Run(CommandLine& cmdLine, ShellState& state)
+{
+    auto value = cmdLine.Accept();
+    if (value == "interactive")
+        state.batchPriority = false;
+    else if (value == "batch")
+        state.batchPriority = true;
+    else
+        throw std::invalid_argument("invalid priority class '" + value + "'");
+}
+
+
+/*
+ * ClientCommand class
+ */
+
+std::vector<Command::Identifier> ClientCommand::Idents() const
+{
+    return { { "--client" } };
+}
+
+HelpDescriptor ClientCommand::Help() const
+{
+    return
+    {
+        "--client NAME", "Tags the job with the client name NAME for the fairness policy of the server scheduler",
+        "Queued jobs of the same priority class are dispatched round-robin over the client names"
+    };
+}
+
+void ClientCommand::Run(CommandLine& cmdLine, ShellState& state)
+{
+    state.serverClient = cmdLine.Accept();
+}
+
+
+/*
+ * BudgetCommand class
+ */
+
+std::vector<Command::Identifier> BudgetCommand::Idents() const
+{
+    return { { "--budget" } };
+}
+
+HelpDescriptor BudgetCommand::Help() const
+{
+    return
+    {
+        "--budget TYPE=VALUE", "Sets a compile budget: TYPE is 'time' (in ms), 'arena' (in bytes), 'tokens', or 'cache' (in bytes); default=unlimited",
+        "An exceeded budget aborts the compilation with a \"compile budget exceeded\" error report; "
+        "the 'cache' type instead sets the global memory budget over all long-lived caches, "
+        "which evicts their least recently used entries (see the \"stats\" control line of the server mode)"
+    };
+}
+
+void BudgetCommand::Run(CommandLine& cmdLine, ShellState& state)
+{
+    auto arg = cmdLine.Accept();
+
+    const auto pos = arg.find('=');
+    if (pos == std::string::npos)
+        throw std::invalid_argument("expected 'TYPE=VALUE' in command '--budget'");
+
+    const auto type     = arg.substr(0, pos);
+    const auto valueStr = arg.substr(pos + 1);
+
+    std::size_t value = 0;
+    try
+    {
+        value = static_cast<std::size_t>(std::stoull(valueStr));
+    }
+    catch (const std::exception&)
+    {
+        throw std::invalid_argument("invalid budget value '" + valueStr + "'");
+    }
+
+    if (type == "time")
+        state.inputDesc.maxCompileTime = value;
+    else if (type == "arena")
+        state.inputDesc.maxArenaBytes = value;
+    else if (type == "tokens")
+        state.inputDesc.maxTokens = value;
+    else if (type == "cache")
+        CacheRegistry::Instance().SetMemoryBudget(value);
+    else
+        throw std::invalid_argument("invalid budget type '" + type + "'");
+}
+
+
+/*
+ * PipelineCommand class
+ */
+
+std::vector<Command::Identifier> PipelineCommand::Idents() const
+{
+    return { { "--pipeline" } };
+}
+
+HelpDescriptor PipelineCommand::Help() const
+{
+    return
+    {
+        "--pipeline [" + CommandLine::GetBooleanOption() + "]",
+        "Pipelines the sequential batch compilation; default=" + CommandLine::GetBooleanFalse(),
+        "A background I/O thread reads the input files ahead of the compiler and flushes completed outputs, "
+        "hiding the file I/O latency of small-shader batches; with -j N the worker threads already overlap their I/O"
+    };
+}
+
+void PipelineCommand::Run(CommandLine& cmdLine, ShellState& state)
+{
+    state.pipelineMode = cmdLine.AcceptBoolean(true);
+}
+
+
+/*
+ * ConcurrentLexCommand class
+ */
+
+std::vector<Command::Identifier> ConcurrentLexCommand::Idents() const
+{
+    return { { "--concurrent-lex" } };
+}
+
+HelpDescriptor ConcurrentLexCommand::Help() const
+{
+    return
+    {
+        "--concurrent-lex [ON/OFF]", "Lexes large sources on a second thread while the parser already runs; default=OFF",
+        "This helps single huge sources, where the parallel worker threads of '--jobs' offer no parallelism"
+    };
+}
+
+void ConcurrentLexCommand::Run(CommandLine& cmdLine, ShellState& state)
+{
+    state.inputDesc.concurrentLexing = cmdLine.AcceptBoolean(true);
+}
+
+
 } // /namespace Util
 
 } // /namespace Xsc
@@ -75,6 +75,11 @@ DECL_SHELL_COMMAND( VersionOutCommand  );
 DECL_SHELL_COMMAND( IndentCommand      );
 DECL_SHELL_COMMAND( PrefixCommand      );
 DECL_SHELL_COMMAND( OutputCommand      );
+DECL_SHELL_COMMAND( DependencyCommand  );
+DECL_SHELL_COMMAND( BundleCommand      );
+DECL_SHELL_COMMAND( PreambleCommand    );
+DECL_SHELL_COMMAND( TraceCommand       );
+DECL_SHELL_COMMAND( MinifyCommand      );
 DECL_SHELL_COMMAND( WarnCommand        );
 DECL_SHELL_COMMAND( BlanksCommand      );
 DECL_SHELL_COMMAND( LineMarksCommand   );
@@ -92,9 +97,24 @@ DECL_SHELL_COMMAND( VerboseCommand     );
 DECL_SHELL_COMMAND( OptimizeCommand    );
 DECL_SHELL_COMMAND( ExtensionCommand   );
 DECL_SHELL_COMMAND( ValidateCommand    );
+DECL_SHELL_COMMAND( MetadataCommand    );
+DECL_SHELL_COMMAND( MaxErrorsCommand   );
 DECL_SHELL_COMMAND( BindingCommand     );
+DECL_SHELL_COMMAND( TrimUniformsCommand );
 DECL_SHELL_COMMAND( CommentCommand     );
 DECL_SHELL_COMMAND( WrapperCommand     );
+DECL_SHELL_COMMAND( JobsCommand        );
+DECL_SHELL_COMMAND( ServerCommand      );
+DECL_SHELL_COMMAND( WatchCommand       );
+DECL_SHELL_COMMAND( JobModeCommand     );
+DECL_SHELL_COMMAND( EmitJobCommand     );
+DECL_SHELL_COMMAND( DeterministicCommand );
+DECL_SHELL_COMMAND( DumpASTCommand     );
+DECL_SHELL_COMMAND( PriorityCommand    );
+DECL_SHELL_COMMAND( ClientCommand      );
+DECL_SHELL_COMMAND( BudgetCommand      );
+DECL_SHELL_COMMAND( PipelineCommand    );
+DECL_SHELL_COMMAND( ConcurrentLexCommand );
 
 #undef DECL_SHELL_COMMAND
 
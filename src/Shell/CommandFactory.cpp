@@ -24,20 +24,28 @@ const CommandFactory& CommandFactory::Instance()
 
 Command* CommandFactory::Get(const std::string& name, Command::Identifier* cmdIdent) const
 {
-    for (const auto& cmd : commands_)
+    /* Most commands match by their exact name */
+    auto it = commandLookup_.find(name);
+    if (it != commandLookup_.end())
     {
-        for (const auto& ident : cmd->Idents())
+        if (cmdIdent)
+            *cmdIdent = it->second.second;
+        return it->second.first;
+    }
+
+    /* Commands with an included value match by prefix (e.g. "-DNAME=VALUE") */
+    for (const auto& entry : prefixLookup_)
+    {
+        const auto& ident = entry.second;
+        auto identLen = ident.name.size();
+        if (name.size() >= identLen && name.compare(0, identLen, ident.name) == 0)
         {
-            auto identLen = ident.name.size();
-            if ( ( !ident.includesValue && name == ident.name ) ||
-                 ( ident.includesValue && name.size() >= identLen && name.substr(0, identLen) == ident.name ) )
-            {
-                if (cmdIdent)
-                    *cmdIdent = ident;
-                return cmd.get();
-            }
+            if (cmdIdent)
+                *cmdIdent = ident;
+            return entry.first;
         }
     }
+
     return nullptr;
 }
 
@@ -57,6 +65,11 @@ CommandFactory::CommandFactory()
         IndentCommand,
         PrefixCommand,
         OutputCommand,
+        DependencyCommand,
+        BundleCommand,
+        PreambleCommand,
+        TraceCommand,
+        MinifyCommand,
         WarnCommand,
         BlanksCommand,
         LineMarksCommand,
@@ -74,9 +87,24 @@ CommandFactory::CommandFactory()
         OptimizeCommand,
         ExtensionCommand,
         ValidateCommand,
+        MetadataCommand,
+        MaxErrorsCommand,
         BindingCommand,
+        TrimUniformsCommand,
         CommentCommand,
-        WrapperCommand
+        WrapperCommand,
+        JobsCommand,
+        ServerCommand,
+        WatchCommand,
+        JobModeCommand,
+        EmitJobCommand,
+        DeterministicCommand,
+        DumpASTCommand,
+        PriorityCommand,
+        ClientCommand,
+        BudgetCommand,
+        PipelineCommand,
+        ConcurrentLexCommand
     >();
 }
 
@@ -85,6 +113,16 @@ void CommandFactory::MakeCommand(Args&&... args)
 {
     auto cmd = std::unique_ptr<T>(new T(std::forward<Args>(args)...));
     helpPrinter_.AppendCommandHelp(*cmd);
+
+    /* Register all identifiers in the dispatch tables, so "Get" needs no linear search over all commands */
+    for (const auto& ident : cmd->Idents())
+    {
+        if (ident.includesValue)
+            prefixLookup_.push_back({ cmd.get(), ident });
+        else
+            commandLookup_[ident.name] = { cmd.get(), ident };
+    }
+
     commands_.emplace_back(std::move(cmd));
 }
 
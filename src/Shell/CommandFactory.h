@@ -11,7 +11,9 @@
 
 #include "Command.h"
 #include "HelpPrinter.h"
+#include <map>
 #include <memory>
+#include <utility>
 #include <vector>
 
 
@@ -59,9 +61,15 @@ class CommandFactory
         template <typename FirstCommand, typename... NextCommands>
         void MakeStandardCommandsNext();
 
-        std::vector<std::unique_ptr<Command>>   commands_;
+        std::vector<std::unique_ptr<Command>>                           commands_;
 
-        HelpPrinter                             helpPrinter_;
+        // Exact-match lookup table for all identifiers without an included value (see Get).
+        std::map<std::string, std::pair<Command*, Command::Identifier>> commandLookup_;
+
+        // Identifiers whose value is included in the command name; these require a prefix match (e.g. "-DNAME=VALUE").
+        std::vector<std::pair<Command*, Command::Identifier>>           prefixLookup_;
+
+        HelpPrinter                                                     helpPrinter_;
 
 };
 
@@ -6,8 +6,16 @@
  */
 
 #include "CommandLine.h"
+#include <algorithm>
+#include <fstream>
 #include <stdexcept>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
 
 namespace Xsc
 {
@@ -16,45 +24,60 @@ namespace Util
 {
 
 
+// Returns true if the specified string matches the wildcard pattern ('*' matches any sequence, '?' any single character).
+static bool MatchWildcard(const std::string& pattern, const std::string& str)
+{
+    std::size_t p = 0, s = 0;
+    std::size_t starP = std::string::npos, starS = 0;
+
+    while (s < str.size())
+    {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == str[s]))
+        {
+            /* Single character matched */
+            ++p;
+            ++s;
+        }
+        else if (p < pattern.size() && pattern[p] == '*')
+        {
+            /* Remember the star, and first try to match it with an empty sequence */
+            starP = p++;
+            starS = s;
+        }
+        else if (starP != std::string::npos)
+        {
+            /* Backtrack to the last star, and extend its sequence by one character */
+            p = starP + 1;
+            s = ++starS;
+        }
+        else
+            return false;
+    }
+
+    /* Only trailing stars may remain in the pattern */
+    while (p < pattern.size() && pattern[p] == '*')
+        ++p;
+
+    return (p == pattern.size());
+}
+
 CommandLine::CommandLine(int argc, char** argv)
 {
     for (int i = 0; i < argc; ++i)
         args_.push_back(std::string(argv[i]));
+    ExpandArguments();
 }
 
 CommandLine::CommandLine(const std::vector<std::string>& args)
 {
     args_.insert(args_.end(), args.begin(), args.end());
+    ExpandArguments();
 }
 
 CommandLine::CommandLine(const std::string& line)
 {
-    /* Parse command line arguments */
-    std::size_t start = 0, end = 0;
-    while (start < line.size())
-    {
-        start = line.find_first_not_of(' ', end);
-        if (start >= line.size())
-            break;
-
-        if (line[start] == '\"')
-        {
-            end = line.find('\"', start + 1);
-            if (end != std::string::npos)
-            {
-                args_.push_back(line.substr(start + 1, end - start - 1));
-                ++end;
-            }
-        }
-        else
-        {
-            end = line.find(' ', start + 1);
-            if (end != std::string::npos)
-                args_.push_back(line.substr(start, end - start));
-            else
-                args_.push_back(line.substr(start));
-        }
-    }
+    TokenizeLine(line, args_);
+    ExpandArguments();
 }
 
 std::string CommandLine::Get() const
@@ -128,6 +151,141 @@ const std::string CommandLine::GetBooleanOption()
 }
 
 
+/*
+ * ======= Private: =======
+ */
+
+void CommandLine::TokenizeLine(const std::string& line, std::list<std::string>& args)
+{
+    /* Parse command line arguments */
+    std::size_t start = 0, end = 0;
+    while (start < line.size())
+    {
+        start = line.find_first_not_of(' ', end);
+        if (start >= line.size())
+            break;
+
+        if (line[start] == '\"')
+        {
+            end = line.find('\"', start + 1);
+            if (end != std::string::npos)
+            {
+                args.push_back(line.substr(start + 1, end - start - 1));
+                ++end;
+            }
+        }
+        else
+        {
+            end = line.find(' ', start + 1);
+            if (end != std::string::npos)
+                args.push_back(line.substr(start, end - start));
+            else
+                args.push_back(line.substr(start));
+        }
+    }
+}
+
+std::list<std::string> CommandLine::ReadResponseFile(const std::string& filename)
+{
+    std::ifstream file(filename);
+    if (!file.good())
+        throw std::invalid_argument("failed to read response file: \"" + filename + "\"");
+
+    std::list<std::string> args;
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        /* Tabs separate arguments just like spaces do */
+        std::replace(line.begin(), line.end(), '\t', ' ');
+
+        /* Skip blank and comment lines */
+        auto start = line.find_first_not_of(' ');
+        if (start == std::string::npos || line[start] == '#')
+            continue;
+
+        TokenizeLine(line, args);
+    }
+
+    return args;
+}
+
+std::list<std::string> CommandLine::ExpandWildcards(const std::string& pattern)
+{
+    /* Only the filename part may contain wildcards; the directory part is used verbatim */
+    auto delimPos = pattern.find_last_of("/\\");
+    auto prefix = (delimPos == std::string::npos ? std::string() : pattern.substr(0, delimPos + 1));
+    auto filePattern = (delimPos == std::string::npos ? pattern : pattern.substr(delimPos + 1));
+
+    std::vector<std::string> matches;
+
+    #ifdef _WIN32
+
+    WIN32_FIND_DATAA findData;
+    auto findHandle = FindFirstFileA((prefix + "*").c_str(), &findData);
+    if (findHandle != INVALID_HANDLE_VALUE)
+    {
+        do
+        {
+            std::string name = findData.cFileName;
+            if (name != "." && name != ".." && MatchWildcard(filePattern, name))
+                matches.push_back(prefix + name);
+        }
+        while (FindNextFileA(findHandle, &findData) != FALSE);
+        FindClose(findHandle);
+    }
+
+    #else
+
+    if (auto directory = opendir(prefix.empty() ? "." : prefix.c_str()))
+    {
+        while (auto entry = readdir(directory))
+        {
+            std::string name = entry->d_name;
+            if (name != "." && name != ".." && MatchWildcard(filePattern, name))
+                matches.push_back(prefix + name);
+        }
+        closedir(directory);
+    }
+
+    #endif
+
+    /* Sort the matches, so the processing order is independent of the directory layout */
+    std::sort(matches.begin(), matches.end());
+
+    return std::list<std::string>(matches.begin(), matches.end());
+}
+
+void CommandLine::ExpandArguments()
+{
+    std::size_t numResponseFiles = 0;
+
+    for (auto it = args_.begin(); it != args_.end();)
+    {
+        const auto& arg = *it;
+        if (arg.size() >= 2 && arg.front() == '@')
+        {
+            /* Guard against self referencing response files */
+            if (++numResponseFiles > 128)
+                throw std::invalid_argument("too many nested response files");
+
+            /* Replace the "@FILE" argument by the file content, and rescan the inserted arguments (they may nest) */
+            auto expanded = ReadResponseFile(arg.substr(1));
+            it = args_.erase(it);
+
+            if (!expanded.empty())
+            {
+                auto firstInserted = expanded.begin();
+                args_.splice(it, expanded);
+                it = firstInserted;
+            }
+        }
+        else
+            ++it;
+    }
+}
+
+
 
 } // /namespace Util
 
@@ -30,6 +30,13 @@ class CommandLine
         CommandLine(const CommandLine&) = default;
         CommandLine& operator = (const CommandLine&) = default;
 
+        /*
+        All constructors expand response file arguments in place: "@FILE" is replaced by the arguments
+        read from the file FILE (line oriented; '#' starts a comment line). This keeps huge batch
+        invocations below the OS argument limits. Wildcard patterns are NOT expanded here, since only
+        the shell knows which arguments are input filenames (see ExpandWildcards); an option value
+        (e.g. the output filename, where '*' is a placeholder) must stay verbatim.
+        */
         CommandLine(int argc, char** argv);
         CommandLine(const std::vector<std::string>& args);
         explicit CommandLine(const std::string& line);
@@ -70,8 +77,20 @@ class CommandLine
         // Returns the value command line argument for a boolean value (e.g. "ON/OFF").
         static const std::string GetBooleanOption();
 
+        // Returns the sorted list of filenames matching the specified wildcard pattern ('*', '?'), or an empty list if nothing matches.
+        static std::list<std::string> ExpandWildcards(const std::string& pattern);
+
     private:
 
+        // Appends all arguments of the specified text line to the argument list (quoted arguments may contain spaces).
+        static void TokenizeLine(const std::string& line, std::list<std::string>& args);
+
+        // Returns the argument list read from the specified response file (see ExpandArguments).
+        static std::list<std::string> ReadResponseFile(const std::string& filename);
+
+        // Expands response files ("@FILE") within the argument list (see constructors).
+        void ExpandArguments();
+
         std::list<std::string> args_;
 
 };
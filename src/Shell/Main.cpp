@@ -50,8 +50,25 @@ int main(int argc, char** argv)
     }
 
     /* Execute command line from program arguments */
-    CommandLine cmdLine(argc - 1, argv + 1);
-    shell.ExecuteCommandLine(cmdLine);
+    try
+    {
+        CommandLine cmdLine(argc - 1, argv + 1);
+        shell.ExecuteCommandLine(cmdLine);
+    }
+    catch (const std::exception& e)
+    {
+        /* A broken response file is reported before any command runs */
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    /* Enter the resident server loop (if enabled), reading job command lines from stdin */
+    if (shell.ServerModeEnabled())
+        shell.RunServer(std::cin);
+
+    /* Enter the watch loop (if enabled), recompiling the input files whenever they change on disk */
+    if (shell.WatchModeEnabled())
+        shell.RunWatchLoop();
 
     /* Wait for user (if enabled) */
     shell.WaitForUser();
@@ -8,11 +8,20 @@
 #include "Shell.h"
 #include "CommandFactory.h"
 #include "Helper.h"
+#include <Xsc/ShaderJob.h>
+#include <Xsc/CacheRegistry.h>
 #include <iostream>
 #include <sstream>
 #include <fstream>
 #include <algorithm>
 #include <cmath>
+#include <thread>
+#include <atomic>
+#include <set>
+#include <chrono>
+#include <deque>
+#include <condition_variable>
+#include <sys/stat.h>
 
 #ifdef _WIN32
 #include <conio.h>
@@ -42,6 +51,73 @@ static void PrintBackdoorEasterEgg(std::ostream& output)
 
 #endif
 
+// Returns the modification timestamp of the specified file, or 0 if the file cannot be accessed.
+static std::uint64_t FileModificationTime(const std::string& filename)
+{
+    #ifdef _WIN32
+    struct _stat info;
+    if (_stat(filename.c_str(), &info) == 0)
+        return static_cast<std::uint64_t>(info.st_mtime);
+    #else
+    struct stat info;
+    if (stat(filename.c_str(), &info) == 0)
+        return static_cast<std::uint64_t>(info.st_mtime);
+    #endif
+    return 0;
+}
+
+// Include handler that records the resolved filename of each included file (for the watch mode).
+class TrackingIncludeHandler : public IncludeHandler
+{
+
+    public:
+
+        std::unique_ptr<std::istream> Include(const std::string& filename, bool useSearchPathsFirst) override
+        {
+            RecordResolvedFilename(filename, useSearchPathsFirst);
+            return IncludeHandler::Include(filename, useSearchPathsFirst);
+        }
+
+        // Resolved filenames of all included files, in inclusion order.
+        std::vector<std::string> includedFiles;
+
+    private:
+
+        // Mirrors the resolution order of the base implementation: the first existing candidate is the file that is read.
+        void RecordResolvedFilename(const std::string& filename, bool useSearchPathsFirst)
+        {
+            std::vector<std::string> candidates;
+
+            if (!useSearchPathsFirst)
+                candidates.push_back(filename);
+
+            for (const auto& path : searchPaths)
+            {
+                if (!path.empty())
+                {
+                    std::string s = path;
+                    if (path.back() != '/' && path.back() != '\\')
+                        s += '/';
+                    s += filename;
+                    candidates.push_back(s);
+                }
+            }
+
+            if (useSearchPathsFirst)
+                candidates.push_back(filename);
+
+            for (const auto& candidate : candidates)
+            {
+                if (FileModificationTime(candidate) != 0)
+                {
+                    includedFiles.push_back(candidate);
+                    break;
+                }
+            }
+        }
+
+};
+
 Shell* Shell::instance_ = nullptr;
 
 Shell::Shell(std::ostream& output) :
@@ -107,6 +183,29 @@ void Shell::ExecuteCommandLine(CommandLine& cmdLine)
             }
             else
             {
+                /*
+                Expand wildcards only for positional input filenames: arguments consumed as option
+                values (e.g. the output filename, where '*' is the placeholder for the input filename)
+                must stay verbatim. An unmatched pattern is kept, so it is reported like any missing file.
+                */
+                if (cmdName.find_first_of("*?") != std::string::npos)
+                {
+                    auto matches = CommandLine::ExpandWildcards(cmdName);
+                    if (!matches.empty())
+                    {
+                        /*
+                        Compile all matched files with the same option state (e.g. the entry point and
+                        the output filename apply to every match), and reset it only after the last one
+                        */
+                        for (const auto& filename : matches)
+                            Compile(filename);
+
+                        state_.outputFilename.clear();
+                        state_.inputDesc.entryPoint.clear();
+                        continue;
+                    }
+                }
+
                 /* Compile specified shader file */
                 Compile(cmdName);
 
@@ -121,6 +220,203 @@ void Shell::ExecuteCommandLine(CommandLine& cmdLine)
         /* Print error message */
         std::cerr << e.what() << std::endl;
     }
+
+    /* Compile all queued files (only filled in parallel mode) */
+    FlushCompileQueue();
+
+    /* Update the bundle archive and the wrapper preamble (if enabled) */
+    SaveBundle();
+    SavePreamble();
+}
+
+// Returns a key that identifies the complete frontend state of a compile job; only jobs with equal keys may share an AST.
+static std::string MakeJobGroupKey(const ShellState& state, const std::string& filename)
+{
+    std::stringstream key;
+
+    key << filename << '\n';
+    key << state.inputDesc.entryPoint << '\n';
+    key << static_cast<int>(state.inputDesc.shaderTarget) << '\n';
+    key << static_cast<int>(state.inputDesc.shaderVersion) << '\n';
+
+    for (const auto& macro : state.predefinedMacros)
+        key << "#define " << macro.ident << '=' << macro.value << '\n';
+
+    for (const auto& path : state.searchPaths)
+        key << "#include " << path << '\n';
+
+    return key.str();
+}
+
+void Shell::ExecutePresettings(std::vector<CommandLine>& cmdLines)
+{
+    /* Execute all presetting command lines, recording the compile jobs instead of running them */
+    collectJobs_ = true;
+
+    for (auto& cmdLine : cmdLines)
+        ExecuteCommandLine(cmdLine);
+
+    collectJobs_ = false;
+
+    auto jobs = std::move(collectedJobs_);
+    collectedJobs_.clear();
+
+    /* Group jobs whose complete frontend state matches, preserving the order of first appearance;
+       each group is parsed and analyzed once, and all its variants are emitted from the shared AST */
+    std::vector<std::pair<std::string, std::vector<CompileJob>>> jobGroups;
+
+    for (auto& job : jobs)
+    {
+        auto key = MakeJobGroupKey(job.state, job.filename);
+
+        auto it = std::find_if(
+            jobGroups.begin(), jobGroups.end(),
+            [&key](const std::pair<std::string, std::vector<CompileJob>>& group)
+            {
+                return (group.first == key);
+            }
+        );
+
+        if (it == jobGroups.end())
+        {
+            jobGroups.push_back({ std::move(key), {} });
+            it = jobGroups.end() - 1;
+        }
+
+        it->second.push_back(std::move(job));
+    }
+
+    for (auto& group : jobGroups)
+        RunCompileJobGroup(group.second);
+
+    /* Update the bundle archive and the wrapper preamble (if enabled) */
+    SaveBundle();
+    SavePreamble();
+}
+
+bool Shell::ServerModeEnabled() const
+{
+    return state_.serverMode;
+}
+
+// Prints the cache accounts against the global memory budget (see CacheRegistry).
+static void PrintCacheStats(std::ostream& output)
+{
+    auto& cacheRegistry = CacheRegistry::Instance();
+
+    output << "cache statistics: " << cacheRegistry.TotalBytes() << " bytes total";
+    if (cacheRegistry.MemoryBudget() > 0)
+        output << " (budget " << cacheRegistry.MemoryBudget() << " bytes)";
+    output << std::endl;
+
+    for (const auto& account : cacheRegistry.QueryAccounts())
+    {
+        output
+            << "  " << account.name << ": " << account.numEntries << " entries, "
+            << account.numBytes << " bytes, " << account.numEvictions << " evictions" << std::endl;
+    }
+}
+
+void Shell::RunServer(std::istream& input)
+{
+    /* Dispatch the job lines to worker threads, if the parallel mode was enabled as well (see JobsCommand) */
+    if (state_.numThreads > 1)
+    {
+        RunServerScheduler(input);
+        return;
+    }
+
+    /* Options from the initial command line (e.g. include paths) form the base state of every job */
+    const auto baseState = state_;
+
+    std::string line;
+    while (std::getline(input, line))
+    {
+        if (line.empty())
+            continue;
+
+        /* Terminate the server on request of the client */
+        if (line == "exit" || line == "quit")
+            break;
+
+        /* Report the cache accounts on request of the client (the queue figures only exist in the scheduler mode) */
+        if (line == "stats")
+        {
+            PrintCacheStats(output);
+            output << GetServerSentinel() << std::endl;
+            continue;
+        }
+
+        /* Execute each line as a self-contained command line, starting over from the base state,
+           so options of one job never leak into the next one */
+        try
+        {
+            CommandLine cmdLine(line);
+            ExecuteCommandLine(cmdLine);
+        }
+        catch (const std::exception& e)
+        {
+            /* A broken response file must not terminate the server; report it like any other job failure */
+            std::cerr << e.what() << std::endl;
+        }
+        state_ = baseState;
+
+        /* Emit the framing line, so the client can detect job completion on the stream */
+        output << GetServerSentinel() << std::endl;
+    }
+}
+
+const char* Shell::GetServerSentinel()
+{
+    return "< job done >";
+}
+
+bool Shell::WatchModeEnabled() const
+{
+    return state_.watchMode;
+}
+
+void Shell::RunWatchLoop()
+{
+    if (watchQueue_.empty())
+    {
+        output << "no input files to watch" << std::endl;
+        return;
+    }
+
+    /* Initial compilation also gathers the include closure of each input file */
+    for (auto& watchedJob : watchQueue_)
+        CompileWatchedJob(watchedJob);
+
+    std::size_t numFiles = 0;
+    for (const auto& watchedJob : watchQueue_)
+        numFiles += watchedJob.timestamps.size();
+
+    output << "watching " << numFiles << " file(s) for changes ..." << std::endl;
+
+    while (true)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+
+        for (auto& watchedJob : watchQueue_)
+        {
+            /* Determine if the input file or any file of its include closure changed on disk */
+            bool outOfDate = false;
+
+            for (const auto& it : watchedJob.timestamps)
+            {
+                if (FileModificationTime(it.first) != it.second)
+                {
+                    /* Drop the stale cache entry, so the next inclusion re-reads the file */
+                    IncludeHandler::InvalidateCache(it.first);
+                    outOfDate = true;
+                }
+            }
+
+            if (outOfDate)
+                CompileWatchedJob(watchedJob);
+        }
+    }
 }
 
 void Shell::WaitForUser()
@@ -162,117 +458,1210 @@ static std::string TargetToExtension(const ShaderTarget shaderTarget)
     return "glsl";
 }
 
-std::string Shell::GetDefaultOutputFilename(const std::string& filename)
+std::string Shell::GetDefaultOutputFilename(const ShellState& state, const std::string& filename)
 {
-    return (ExtractFilename(filename) + "." + state_.inputDesc.entryPoint + "." + TargetToExtension(state_.inputDesc.shaderTarget));
+    return (ExtractFilename(filename) + "." + state.inputDesc.entryPoint + "." + TargetToExtension(state.inputDesc.shaderTarget));
 }
 
-void Shell::Compile(const std::string& filename)
+// A job line of the server scheduler, stamped with its submission time for the latency figures.
+struct ServerJob
 {
-    const auto  defaultOutputFilename   = GetDefaultOutputFilename(filename);
-    auto        outputFilename          = state_.outputFilename;
+    std::string                             line;
+    std::chrono::steady_clock::time_point   submitTime;
+};
 
-    if (outputFilename.empty())
-        outputFilename = defaultOutputFilename;
-    else
-        Replace(outputFilename, "*", defaultOutputFilename);
+/*
+One priority class of the server scheduler: per-client FIFO queues with a round-robin cursor
+(so a chatty client cannot starve the jobs of the other clients), and the latency figures of the
+class. All functions must be called with the scheduler mutex held.
+*/
+class ServerJobQueue
+{
 
-    try
-    {
-        /* Add pre-defined macros at the top of the input stream */
-        auto inputStream = std::make_shared<std::stringstream>();
-        
-        for (const auto& macro : state_.predefinedMacros)
+    public:
+
+        // Appends the job to the FIFO queue of the specified client.
+        void Enqueue(const std::string& client, ServerJob&& job)
         {
-            *inputStream << "#define " << macro.ident;
-            if (!macro.value.empty())
-                *inputStream << ' ' << macro.value;
-            *inputStream << std::endl;
+            auto it = std::find_if(
+                clientQueues_.begin(), clientQueues_.end(),
+                [&client](const ClientQueue& queue)
+                {
+                    return (queue.client == client);
+                }
+            );
+
+            if (it == clientQueues_.end())
+            {
+                clientQueues_.push_back({ client, {} });
+                it = clientQueues_.end() - 1;
+            }
+
+            it->jobs.push_back(std::move(job));
+            ++depth_;
         }
 
-        /* Open input stream */
-        state_.inputDesc.filename = filename;
+        // Removes the front job of the next client in round-robin order; returns false if the class is empty.
+        bool Dequeue(ServerJob& job)
+        {
+            if (depth_ == 0)
+                return false;
 
-        std::ifstream inputFile(filename);
-        if (!inputFile.good())
-            throw std::runtime_error("failed to read file: \"" + filename + "\"");
+            for (std::size_t i = 0; i < clientQueues_.size(); ++i)
+            {
+                auto& queue = clientQueues_[(clientCursor_ + i) % clientQueues_.size()];
+                if (!queue.jobs.empty())
+                {
+                    job = std::move(queue.jobs.front());
+                    queue.jobs.pop_front();
+                    --depth_;
 
-        *inputStream << inputFile.rdbuf();
+                    /* Continue with the next client, so each client gets one job per rotation */
+                    clientCursor_ = (clientCursor_ + i + 1) % clientQueues_.size();
 
-        std::stringstream outputStream;
+                    /* Record the queueing latency of the job */
+                    const auto waited = std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - job.submitTime
+                    );
+                    waitTimes_.push_back(static_cast<double>(waited.count()) / 1000.0);
 
-        /* Initialize input and output descriptors */
-        state_.inputDesc.sourceCode  = inputStream;
-        state_.outputDesc.sourceCode = &outputStream;
+                    return true;
+                }
+            }
 
-        /* Final setup before compilation */
-        StdLog          log;
-        IncludeHandler  includeHandler;
-        Statistics      stats;
-        
-        includeHandler.searchPaths = state_.searchPaths;
-        state_.inputDesc.includeHandler = &includeHandler;
+            return false;
+        }
 
-        if (state_.showStats)
-            state_.outputDesc.statistics = &stats;
+        // Returns the number of queued jobs of this class.
+        inline std::size_t Depth() const
+        {
+            return depth_;
+        }
 
-        /* Show compilation/validation status */
-        if (state_.outputDesc.options.validateOnly)
-            output << "validate \"" << filename << '\"' << std::endl;
-        else
-            output << "compile \"" << filename << "\" to \"" << outputFilename << '\"' << std::endl;
+        // Prints the queue depth and the queueing latency percentiles of this class.
+        void PrintStats(std::ostream& output, const std::string& title) const
+        {
+            output << title << ": depth=" << depth_ << ", dispatched=" << waitTimes_.size();
 
-        /* Compile shader file */
-        auto result = CompileShader(state_.inputDesc, state_.outputDesc, &log);
+            if (!waitTimes_.empty())
+            {
+                auto sorted = waitTimes_;
+                std::sort(sorted.begin(), sorted.end());
 
-        /* Print all reports to the log output */
-        log.PrintAll(state_.verbose, state_.outputDesc.options.warnings);
+                auto Percentile = [&sorted](double p)
+                {
+                    return sorted[static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1) / 100.0 + 0.5)];
+                };
 
-        if (result)
+                output
+                    << ", wait p50=" << Percentile(50.0) << "ms"
+                    << ", p99=" << Percentile(99.0) << "ms"
+                    << ", max=" << sorted.back() << "ms";
+            }
+
+            output << std::endl;
+        }
+
+    private:
+
+        struct ClientQueue
+        {
+            std::string             client;
+            std::deque<ServerJob>   jobs;
+        };
+
+        std::vector<ClientQueue>    clientQueues_;
+        std::size_t                 clientCursor_   = 0;
+        std::size_t                 depth_          = 0;
+
+        // Queueing latency of each dispatched job in milliseconds.
+        std::vector<double>         waitTimes_;
+
+};
+
+/*
+Returns the scheduling tags of the specified job line. The tags are needed at submission time
+(i.e. before the job line is parsed by a worker), so only tags written directly on the line are
+recognized, not tags inside a response file.
+*/
+static void ScanServerJobTags(const std::string& line, bool& batchPriority, std::string& client)
+{
+    std::istringstream stream(line);
+    std::string arg;
+
+    while (stream >> arg)
+    {
+        if (arg == "--priority")
+        {
+            if (stream >> arg)
+                batchPriority = (arg == "batch");
+        }
+        else if (arg == "--client")
+            stream >> client;
+    }
+}
+
+void Shell::RunServerScheduler(std::istream& input)
+{
+    /* Options from the initial command line (e.g. include paths) form the base state of every job */
+    const auto baseState    = state_;
+    const auto numWorkers   = state_.numThreads;
+
+    /*
+    Cap the number of concurrent batch jobs below the worker count, so one worker is always free
+    for the next interactive job while the batch queue saturates the remaining cores.
+    */
+    const auto maxBatchJobs = (numWorkers > 1 ? numWorkers - 1 : numWorkers);
+
+    std::mutex              schedulerMutex;
+    std::condition_variable jobsAvailable;
+    ServerJobQueue          interactiveQueue, batchQueue;
+    std::size_t             activeBatchJobs = 0;
+    bool                    terminating     = false;
+
+    std::mutex              outputMutex;
+
+    auto worker = [&]()
+    {
+        /* Warm compiler instance of this worker: its retained memory (and the include cache it shares) stays hot across jobs */
+        CompilerInstance compilerInstance;
+
+        while (true)
         {
-            if (!state_.outputDesc.options.validateOnly)
+            ServerJob   job;
+            bool        isBatchJob = false;
+
+            /* Fetch the next job: interactive jobs first, batch jobs only within their concurrency cap */
             {
-                output << "compilation successful" << std::endl;
+                std::unique_lock<std::mutex> lock(schedulerMutex);
 
-                /* Write result to output stream only on success */
-                std::ofstream outputFile(outputFilename);
-                if (outputFile.good())
-                    outputFile << outputStream.rdbuf();
+                jobsAvailable.wait(
+                    lock,
+                    [&]()
+                    {
+                        return
+                        (
+                            interactiveQueue.Depth() > 0 ||
+                            (batchQueue.Depth() > 0 && activeBatchJobs < maxBatchJobs) ||
+                            terminating
+                        );
+                    }
+                );
+
+                if (interactiveQueue.Dequeue(job))
+                    isBatchJob = false;
+                else if (activeBatchJobs < maxBatchJobs && batchQueue.Dequeue(job))
+                {
+                    isBatchJob = true;
+                    ++activeBatchJobs;
+                }
+                else if (terminating)
+                    break;
                 else
-                    throw std::runtime_error("failed to write file: \"" + filename + "\"");
+                    continue;
             }
-            else
-                output << "validation successful" << std::endl;
+
+            ExecuteServerJobLine(job.line, baseState, compilerInstance, outputMutex);
+
+            if (isBatchJob)
+            {
+                std::lock_guard<std::mutex> lock(schedulerMutex);
+                --activeBatchJobs;
+            }
+
+            /* A finished batch job frees a batch slot, and the drain on termination must re-check the queues */
+            jobsAvailable.notify_all();
         }
-        else
+    };
+
+    std::vector<std::thread> workerThreads;
+    for (std::size_t i = 0; i < numWorkers; ++i)
+        workerThreads.emplace_back(worker);
+
+    /* Read the job lines and feed the scheduler; control lines are handled inline */
+    std::string line;
+    while (std::getline(input, line))
+    {
+        if (line.empty())
+            continue;
+
+        /* Terminate the server on request of the client (queued jobs are still drained) */
+        if (line == "exit" || line == "quit")
+            break;
+
+        /* Report the scheduling figures on request of the client */
+        if (line == "stats")
         {
-            if (state_.outputDesc.options.validateOnly)
-                output << "validation failed" << std::endl;
-            else
-                output << "compilation failed" << std::endl;
+            std::lock_guard<std::mutex> schedulerLock(schedulerMutex);
+            std::lock_guard<std::mutex> outputLock(outputMutex);
+
+            output << "server queue statistics:" << std::endl;
+            interactiveQueue.PrintStats(output, "  interactive");
+            batchQueue.PrintStats(output, "  batch");
+
+            PrintCacheStats(output);
+            output << GetServerSentinel() << std::endl;
+            continue;
         }
 
-        /* Show output statistics (if enabled) */
-        if (state_.showStats)
-            ShowStats(stats);
+        /* Classify the job line up front, since the scheduling tags are needed at submission time */
+        auto batchPriority  = baseState.batchPriority;
+        auto client         = baseState.serverClient;
+
+        ScanServerJobTags(line, batchPriority, client);
+
+        {
+            std::lock_guard<std::mutex> lock(schedulerMutex);
+            auto& queue = (batchPriority ? batchQueue : interactiveQueue);
+            queue.Enqueue(client, { line, std::chrono::steady_clock::now() });
+        }
+        jobsAvailable.notify_one();
     }
-    catch (const std::exception& err)
+
+    /* Drain the remaining jobs and join the workers */
     {
-        /* Print error message */
-        output << err.what() << std::endl;
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        terminating = true;
     }
+    jobsAvailable.notify_all();
+
+    for (auto& thread : workerThreads)
+        thread.join();
 }
 
-void Shell::ShowStats(const Statistics& stats)
+void Shell::ExecuteServerJobLine(const std::string& line, ShellState state, CompilerInstance& compilerInstance, std::mutex& outputMutex)
 {
-    output << "statistics:" << std::endl;
-    indentHandler_.IncIndent();
+    try
     {
-        ShowStatsFor( stats.macros,          "macros"                   );
-        ShowStatsFor( stats.textures,        "texture bindings"         );
-        ShowStatsFor( stats.constantBuffers, "constant buffer bindings" );
-        ShowStatsFor( stats.fragmentTargets, "fragment target bindings" );
-        ShowStatsFor( stats.samplerStates,   "sampler states"           );
+        CommandLine cmdLine(line);
+
+        /* Dispatch the commands of the job line against the local state snapshot, so concurrent jobs never see each other's options */
+        while (!cmdLine.ReachedEnd())
+        {
+            /* Get next command */
+            auto cmdName = cmdLine.Accept();
+
+            Command::Identifier cmdIdent;
+            auto cmd = CommandFactory::Instance().Get(cmdName, &cmdIdent);
+
+            if (cmd)
+            {
+                /* Check if value is included within the command name */
+                if (cmdIdent.includesValue)
+                {
+                    if (cmdName.size() > cmdIdent.name.size())
+                        cmdLine.Insert(cmdName.substr(cmdIdent.name.size()));
+                    else
+                        throw std::invalid_argument("missing value in command '" + cmdIdent.name + "'");
+                }
+
+                /* Run command */
+                cmd->Run(cmdLine, state);
+            }
+            else
+            {
+                /* Compile the file with the warm compiler instance of this worker */
+                RunCompileJob({ state, cmdName }, &outputMutex, nullptr, &compilerInstance);
+
+                /* Reset output filename and entry point */
+                state.outputFilename.clear();
+                state.inputDesc.entryPoint.clear();
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        /* A broken job line must not terminate a worker; report it like any other job failure */
+        std::lock_guard<std::mutex> guard(outputMutex);
+        std::cerr << e.what() << std::endl;
+    }
+
+    /* Emit the framing line, so the client can detect job completion on the stream */
+    std::lock_guard<std::mutex> guard(outputMutex);
+    output << GetServerSentinel() << std::endl;
+}
+
+void Shell::Compile(const std::string& filename)
+{
+    if (state_.jobMode)
+    {
+        /* Execute the input file as a serialized compile job (see JobModeCommand) */
+        ExecuteSerializedJob(filename);
+    }
+    else if (!state_.emitJobFilename.empty())
+    {
+        /* Serialize the compilation into a job file instead of compiling (see EmitJobCommand) */
+        EmitJobFile({ state_, filename });
+    }
+    else if (collectJobs_)
+    {
+        /* Record the job for grouped execution (see ExecutePresettings) */
+        collectedJobs_.push_back({ state_, filename });
+    }
+    else if (state_.watchMode)
+    {
+        /* Defer to the watch loop, which performs the initial compilation and tracks the include closure */
+        watchQueue_.push_back({ { state_, filename }, {} });
+    }
+    else if (state_.numThreads > 1 || state_.pipelineMode)
+    {
+        /* Queue the file for the worker threads or the pipelined batch loop; snapshot the current state,
+           since subsequent commands may modify it before the queue is flushed */
+        compileQueue_.push_back({ state_, filename });
+    }
+    else
+        RunCompileJob({ state_, filename });
+}
+
+void Shell::ExecuteSerializedJob(const std::string& filename)
+{
+    try
+    {
+        /* Decode the job file */
+        std::ifstream jobFile(filename, std::ios::binary);
+        if (!jobFile.good())
+            throw std::runtime_error("failed to read file: \"" + filename + "\"");
+
+        ShaderJob shaderJob;
+        if (!DecodeShaderJob(shaderJob, jobFile))
+            throw std::runtime_error("failed to decode compile job: \"" + filename + "\"");
+
+        const auto resultFilename = filename + ".result";
+
+        output << "execute job \"" << filename << "\" to \"" << resultFilename << '\"' << std::endl;
+
+        /* Execute the job; the include fingerprints are validated against the local include tree */
+        StdLog          log;
+        ShaderJobResult result;
+
+        ExecuteShaderJob(shaderJob, result, &log);
+
+        log.PrintAll(state_.verbose, shaderJob.options.warnings);
+
+        /* Write the result blob, also for failed jobs, so the submitting machine receives the reports */
+        std::ofstream resultFile(resultFilename, std::ios::binary);
+        if (!resultFile.good())
+            throw std::runtime_error("failed to write file: \"" + resultFilename + "\"");
+
+        EncodeShaderJobResult(result, resultFile);
+
+        if (result.succeeded)
+            output << "compilation successful" << std::endl;
+        else
+            output << "compilation failed" << std::endl;
+
+        if (state_.showStats)
+            ShowStats(result.statistics);
+    }
+    catch (const std::exception& err)
+    {
+        output << err.what() << std::endl;
+    }
+}
+
+void Shell::EmitJobFile(CompileJob job)
+{
+    auto&       state                   = job.state;
+    const auto& filename                = job.filename;
+
+    const auto  defaultOutputFilename   = GetDefaultOutputFilename(state, filename);
+    auto        outputFilename          = state.outputFilename;
+
+    if (outputFilename.empty())
+        outputFilename = defaultOutputFilename;
+    else
+        Replace(outputFilename, "*", defaultOutputFilename);
+
+    auto jobFilename = state.emitJobFilename;
+    Replace(jobFilename, "*", outputFilename);
+
+    try
+    {
+        /* Read the complete source text into the job (the predefined macros travel separately) */
+        std::ifstream inputFile(filename);
+        if (!inputFile.good())
+            throw std::runtime_error("failed to read file: \"" + filename + "\"");
+
+        ShaderJob shaderJob;
+
+        shaderJob.filename      = filename;
+        shaderJob.source.assign(std::istreambuf_iterator<char>(inputFile), std::istreambuf_iterator<char>());
+        shaderJob.inputVersion  = state.inputDesc.shaderVersion;
+        shaderJob.entryPoint    = state.inputDesc.entryPoint;
+        shaderJob.shaderTarget  = state.inputDesc.shaderTarget;
+        shaderJob.searchPaths   = state.searchPaths;
+        shaderJob.outputVersion = state.outputDesc.shaderVersion;
+        shaderJob.formatting    = state.outputDesc.formatting;
+        shaderJob.options       = state.outputDesc.options;
+
+        for (const auto& macro : state.predefinedMacros)
+        {
+            Xsc::PredefinedMacro jobMacro;
+            {
+                jobMacro.ident = macro.ident;
+                jobMacro.value = macro.value;
+            }
+            shaderJob.predefinedMacros.push_back(std::move(jobMacro));
+        }
+
+        shaderJob.sourceFingerprint = ShaderJobFingerprint(shaderJob);
+
+        output << "emit job \"" << filename << "\" to \"" << jobFilename << '\"' << std::endl;
+
+        /* Pre-process the source once locally, so the include closure of the job is fingerprinted */
+        StdLog log;
+
+        IncludeHandler includeHandler;
+        includeHandler.searchPaths = state.searchPaths;
+
+        ShaderInput inputDesc;
+        {
+            inputDesc.filename              = filename;
+            inputDesc.sourceCodeBuffer      = shaderJob.source.data();
+            inputDesc.sourceCodeBufferSize  = shaderJob.source.size();
+            inputDesc.shaderVersion         = shaderJob.inputVersion;
+            inputDesc.includeHandler        = &includeHandler;
+            inputDesc.predefinedMacros      = shaderJob.predefinedMacros;
+        }
+
+        std::string discardedOutput;
+
+        ShaderOutput outputDesc;
+        {
+            outputDesc.sourceCodeString         = &discardedOutput;
+            outputDesc.options.preprocessOnly   = true;
+            outputDesc.includeDependencies      = &shaderJob.includes;
+        }
+
+        const auto result = CompileShader(inputDesc, outputDesc, &log);
+
+        log.PrintAll(state.verbose, state.outputDesc.options.warnings);
+
+        if (!result)
+        {
+            output << "job emission failed" << std::endl;
+            return;
+        }
+
+        /* Write the job file */
+        std::ofstream jobFile(jobFilename, std::ios::binary);
+        if (!jobFile.good())
+            throw std::runtime_error("failed to write file: \"" + jobFilename + "\"");
+
+        EncodeShaderJob(shaderJob, jobFile);
+    }
+    catch (const std::exception& err)
+    {
+        output << err.what() << std::endl;
+    }
+}
+
+/*
+Asynchronous output writer of the pipelined batch loop: completed outputs flush to disk on a
+background thread while the next file compiles (see PipelineCommand).
+*/
+class OutputFlusher
+{
+
+    public:
+
+        OutputFlusher()
+        {
+            thread_ = std::thread(&OutputFlusher::WriteLoop, this);
+        }
+
+        ~OutputFlusher()
+        {
+            if (thread_.joinable())
+                Finish();
+        }
+
+        // Queues the content for a background write to the specified file.
+        void Enqueue(std::string filename, std::string content)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                pendingWrites_.push_back({ std::move(filename), std::move(content) });
+            }
+            pendingChanged_.notify_one();
+        }
+
+        // Drains the queued writes and joins the writer thread; returns the filenames of the writes that failed.
+        std::vector<std::string> Finish()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                finished_ = true;
+            }
+            pendingChanged_.notify_one();
+            thread_.join();
+            return std::move(failedFilenames_);
+        }
+
+    private:
+
+        struct PendingWrite
+        {
+            std::string filename;
+            std::string content;
+        };
+
+        void WriteLoop()
+        {
+            while (true)
+            {
+                PendingWrite write;
+
+                /* Fetch the next pending write; terminate once the queue is drained and no more writes can arrive */
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+
+                    pendingChanged_.wait(
+                        lock,
+                        [this]()
+                        {
+                            return (!pendingWrites_.empty() || finished_);
+                        }
+                    );
+
+                    if (pendingWrites_.empty())
+                        break;
+
+                    write = std::move(pendingWrites_.front());
+                    pendingWrites_.pop_front();
+                }
+
+                std::ofstream outputFile(write.filename);
+                if (outputFile.good())
+                    outputFile << write.content;
+                else
+                    failedFilenames_.push_back(std::move(write.filename));
+            }
+        }
+
+        std::mutex                  mutex_;
+        std::condition_variable     pendingChanged_;
+        std::deque<PendingWrite>    pendingWrites_;
+        bool                        finished_       = false;
+
+        // Failed writes; only touched by the writer thread until it is joined (see Finish).
+        std::vector<std::string>    failedFilenames_;
+
+        std::thread                 thread_;
+
+};
+
+void Shell::RunCompileJob(
+    CompileJob job, std::mutex* outputMutex, std::vector<std::string>* trackedIncludes, CompilerInstance* compilerInstance,
+    const std::string* prefetchedSource, OutputFlusher* outputFlusher)
+{
+    auto&       state                   = job.state;
+    const auto& filename                = job.filename;
+
+    const auto  defaultOutputFilename   = GetDefaultOutputFilename(state, filename);
+    auto        outputFilename          = state.outputFilename;
+
+    if (outputFilename.empty())
+        outputFilename = defaultOutputFilename;
+    else
+        Replace(outputFilename, "*", defaultOutputFilename);
+
+    try
+    {
+        /* Add pre-defined macros at the top of the input stream */
+        auto inputStream = std::make_shared<std::stringstream>();
+
+        for (const auto& macro : state.predefinedMacros)
+        {
+            *inputStream << "#define " << macro.ident;
+            if (!macro.value.empty())
+                *inputStream << ' ' << macro.value;
+            *inputStream << std::endl;
+        }
+
+        /* Open input stream */
+        state.inputDesc.filename = filename;
+
+        if (prefetchedSource)
+        {
+            /* Use the file content the read-ahead thread already fetched (see PipelineCommand) */
+            *inputStream << *prefetchedSource;
+        }
+        else
+        {
+            std::ifstream inputFile(filename);
+            if (!inputFile.good())
+                throw std::runtime_error("failed to read file: \"" + filename + "\"");
+
+            *inputStream << inputFile.rdbuf();
+        }
+
+        std::stringstream outputStream;
+
+        /* Initialize input and output descriptors */
+        state.inputDesc.sourceCode  = inputStream;
+        state.outputDesc.sourceCode = &outputStream;
+
+        /* Final setup before compilation */
+        StdLog                  log;
+        TrackingIncludeHandler  includeHandler;
+        Statistics              stats;
+
+        includeHandler.searchPaths = state.searchPaths;
+        state.inputDesc.includeHandler = &includeHandler;
+
+        if (state.showStats)
+            state.outputDesc.statistics = &stats;
+
+        /* Capture reflection data for the bundle archive (if enabled) */
+        Reflection::ReflectionData reflection;
+        auto reflectionPtr = (!state.bundleFilename.empty() ? &reflection : nullptr);
+        state.outputDesc.reflectionData = reflectionPtr;
+
+        /* Route intrinsic wrapper functions into the shared preamble unit (if enabled) */
+        if (!state.preambleFilename.empty())
+            AttachPreamble(state);
+
+        /* Open Chrome trace-event output file (if enabled; see ShaderOutput::traceOutput) */
+        std::ofstream traceFile;
+        if (!state.traceFilename.empty())
+        {
+            traceFile.open(state.traceFilename);
+            if (!traceFile.good())
+                throw std::runtime_error("failed to write file: \"" + state.traceFilename + "\"");
+            state.outputDesc.traceOutput = &traceFile;
+        }
+
+        /* Open binary AST dump output file (if enabled; see ShaderOutput::astDumpOutput) */
+        std::ofstream astDumpFile;
+        if (!state.astDumpFilename.empty())
+        {
+            auto astDumpFilename = state.astDumpFilename;
+            Replace(astDumpFilename, "*", outputFilename);
+
+            astDumpFile.open(astDumpFilename, std::ios::binary);
+            if (!astDumpFile.good())
+                throw std::runtime_error("failed to write file: \"" + astDumpFilename + "\"");
+            state.outputDesc.astDumpOutput = &astDumpFile;
+        }
+
+        bool result = false;
+
+        if (outputMutex)
+        {
+            /* Compile first, then print the entire report block at once,
+               so the output of parallel jobs does not interleave */
+            if (compilerInstance)
+                result = compilerInstance->CompileShader(state.inputDesc, state.outputDesc, &log);
+            else
+                result = CompileShader(state.inputDesc, state.outputDesc, &log);
+
+            std::lock_guard<std::mutex> guard(*outputMutex);
+            PrintCompileStatus(state, filename, outputFilename);
+            FinishCompileJob(state, filename, outputFilename, log, result, stats, outputStream, reflectionPtr, outputFlusher);
+        }
+        else
+        {
+            /* Show compilation/validation status */
+            PrintCompileStatus(state, filename, outputFilename);
+
+            /* Compile shader file */
+            if (compilerInstance)
+                result = compilerInstance->CompileShader(state.inputDesc, state.outputDesc, &log);
+            else
+                result = CompileShader(state.inputDesc, state.outputDesc, &log);
+
+            FinishCompileJob(state, filename, outputFilename, log, result, stats, outputStream, reflectionPtr, outputFlusher);
+        }
+
+        /* Write the resolved include closure as make-style dependency file (if enabled) */
+        if (result && !state.dependencyFilename.empty())
+            WriteDependencyFile(state, filename, outputFilename, includeHandler.includedFiles);
+
+        /* Report the resolved include closure (only requested by the watch mode) */
+        if (trackedIncludes)
+            *trackedIncludes = includeHandler.includedFiles;
+    }
+    catch (const std::exception& err)
+    {
+        /* Print error message */
+        if (outputMutex)
+        {
+            std::lock_guard<std::mutex> guard(*outputMutex);
+            output << err.what() << std::endl;
+        }
+        else
+            output << err.what() << std::endl;
+    }
+}
+
+void Shell::PrintCompileStatus(const ShellState& state, const std::string& filename, const std::string& outputFilename)
+{
+    if (state.outputDesc.options.metadataOnly)
+        output << "extract metadata \"" << filename << '\"' << std::endl;
+    else if (state.outputDesc.options.validateOnly)
+        output << "validate \"" << filename << '\"' << std::endl;
+    else
+        output << "compile \"" << filename << "\" to \"" << outputFilename << '\"' << std::endl;
+}
+
+void Shell::FinishCompileJob(
+    const ShellState& state, const std::string& filename, const std::string& outputFilename,
+    StdLog& log, bool result, const Statistics& stats, std::stringstream& outputStream,
+    const Reflection::ReflectionData* reflection, OutputFlusher* outputFlusher)
+{
+    /* Print all reports to the log output */
+    log.PrintAll(state.verbose, state.outputDesc.options.warnings);
+
+    if (result)
+    {
+        if (!state.outputDesc.options.validateOnly && !state.outputDesc.options.metadataOnly)
+        {
+            output << "compilation successful" << std::endl;
+
+            /* Write result only on success: into the bundle archive, or to its own output file */
+            if (!state.bundleFilename.empty())
+                AddToBundle(state, outputFilename, outputStream, reflection);
+            else if (outputFlusher)
+            {
+                /* Flush the output on the background writer thread (see PipelineCommand) */
+                outputFlusher->Enqueue(outputFilename, outputStream.str());
+            }
+            else
+            {
+                std::ofstream outputFile(outputFilename);
+                if (outputFile.good())
+                    outputFile << outputStream.rdbuf();
+                else
+                    output << "failed to write file: \"" << filename << '\"' << std::endl;
+            }
+        }
+        else if (state.outputDesc.options.metadataOnly)
+            output << "metadata extraction successful" << std::endl;
+        else
+            output << "validation successful" << std::endl;
+    }
+    else
+    {
+        if (state.outputDesc.options.metadataOnly)
+            output << "metadata extraction failed" << std::endl;
+        else if (state.outputDesc.options.validateOnly)
+            output << "validation failed" << std::endl;
+        else
+            output << "compilation failed" << std::endl;
+    }
+
+    /* Show output statistics (if enabled) */
+    if (state.showStats)
+        ShowStats(stats);
+}
+
+// Escapes the specified path for a make-style dependency file (spaces separate prerequisites there).
+static std::string EscapeDependencyPath(const std::string& path)
+{
+    std::string s;
+    s.reserve(path.size());
+
+    for (auto chr : path)
+    {
+        if (chr == ' ' || chr == '#')
+            s += '\\';
+        else if (chr == '$')
+            s += '$';
+        s += chr;
+    }
+
+    return s;
+}
+
+void Shell::WriteDependencyFile(
+    const ShellState& state, const std::string& filename, const std::string& outputFilename,
+    const std::vector<std::string>& includedFiles)
+{
+    auto dependencyFilename = state.dependencyFilename;
+    Replace(dependencyFilename, "*", outputFilename);
+
+    std::ofstream dependencyFile(dependencyFilename);
+    if (!dependencyFile.good())
+    {
+        output << "failed to write file: \"" << dependencyFilename << '\"' << std::endl;
+        return;
+    }
+
+    /* Write the output target with the input file and its include closure as prerequisites */
+    dependencyFile << EscapeDependencyPath(outputFilename) << ": " << EscapeDependencyPath(filename);
+
+    /* List each include file only once, even when it was included multiple times */
+    std::set<std::string> written;
+
+    for (const auto& file : includedFiles)
+    {
+        if (written.insert(file).second)
+            dependencyFile << " \\\n  " << EscapeDependencyPath(file);
+    }
+
+    dependencyFile << '\n';
+}
+
+void Shell::AddToBundle(
+    const ShellState& state, const std::string& outputFilename,
+    std::stringstream& outputStream, const Reflection::ReflectionData* reflection)
+{
+    /* Serialize the reflection blob outside the lock */
+    std::string reflectionBlob;
+
+    if (reflection != nullptr)
+    {
+        std::ostringstream blobStream;
+        Reflection::SerializeReflection(*reflection, blobStream);
+        reflectionBlob = blobStream.str();
+    }
+
+    std::lock_guard<std::mutex> guard(bundleMutex_);
+
+    /* The first bundled job fixes the archive and merges its previous entries (if the file exists) */
+    if (bundleFilename_.empty())
+    {
+        bundleFilename_ = state.bundleFilename;
+        if (!bundle_.Load(bundleFilename_))
+            output << "failed to read bundle archive: \"" << bundleFilename_ << '\"' << std::endl;
+    }
+
+    bundle_.AddShader(outputFilename, outputStream.str(), std::move(reflectionBlob));
+    bundleDirty_ = true;
+}
+
+void Shell::SaveBundle()
+{
+    std::lock_guard<std::mutex> guard(bundleMutex_);
+
+    if (bundleDirty_)
+    {
+        if (bundle_.Save(bundleFilename_))
+            output << "bundle archive written: \"" << bundleFilename_ << "\" (" << bundle_.NumShaders() << " shaders)" << std::endl;
+        else
+            output << "failed to write bundle archive: \"" << bundleFilename_ << '\"' << std::endl;
+
+        bundleDirty_ = false;
+    }
+}
+
+void Shell::AttachPreamble(ShellState& state)
+{
+    std::lock_guard<std::mutex> guard(preambleMutex_);
+
+    /* The first preamble job fixes the filename and merges the wrappers of a previous invocation (if the file exists) */
+    if (preambleFilename_.empty())
+    {
+        preambleFilename_ = state.preambleFilename;
+        if (!preamble_.Load(preambleFilename_))
+            output << "failed to read wrapper preamble: \"" << preambleFilename_ << '\"' << std::endl;
+        preambleSavedCount_ = preamble_.NumWrappers();
+    }
+
+    state.outputDesc.wrapperPreamble = &preamble_;
+}
+
+void Shell::SavePreamble()
+{
+    std::lock_guard<std::mutex> guard(preambleMutex_);
+
+    if (!preambleFilename_.empty() && preamble_.NumWrappers() != preambleSavedCount_)
+    {
+        if (preamble_.Save(preambleFilename_))
+            output << "wrapper preamble written: \"" << preambleFilename_ << "\" (" << preamble_.NumWrappers() << " wrappers)" << std::endl;
+        else
+            output << "failed to write wrapper preamble: \"" << preambleFilename_ << '\"' << std::endl;
+
+        preambleSavedCount_ = preamble_.NumWrappers();
+    }
+}
+
+void Shell::RunCompileJobGroup(const std::vector<CompileJob>& jobs)
+{
+    /* The common case of a single job needs no variant machinery */
+    if (jobs.size() == 1)
+    {
+        RunCompileJob(jobs.front());
+        return;
+    }
+
+    auto        state       = jobs.front().state;
+    const auto& filename    = jobs.front().filename;
+
+    try
+    {
+        /* Add pre-defined macros at the top of the input stream */
+        auto inputStream = std::make_shared<std::stringstream>();
+
+        for (const auto& macro : state.predefinedMacros)
+        {
+            *inputStream << "#define " << macro.ident;
+            if (!macro.value.empty())
+                *inputStream << ' ' << macro.value;
+            *inputStream << std::endl;
+        }
+
+        /* Open input stream */
+        state.inputDesc.filename = filename;
+
+        std::ifstream inputFile(filename);
+        if (!inputFile.good())
+            throw std::runtime_error("failed to read file: \"" + filename + "\"");
+
+        *inputStream << inputFile.rdbuf();
+
+        state.inputDesc.sourceCode = inputStream;
+
+        /* Final setup before compilation (variant jobs share the log, so repeated reports are only counted) */
+        StdLog                  log;
+        TrackingIncludeHandler  includeHandler;
+
+        log.SetReportDeduplication(true);
+
+        includeHandler.searchPaths = state.searchPaths;
+        state.inputDesc.includeHandler = &includeHandler;
+
+        /* Initialize one output descriptor (with its own output stream) per job */
+        std::vector<ShaderOutput>                       outputDescs;
+        std::vector<std::unique_ptr<std::stringstream>> outputStreams;
+        std::vector<std::string>                        outputFilenames;
+        std::vector<Statistics>                         statsList(jobs.size());
+        std::vector<Reflection::ReflectionData>         reflections(jobs.size());
+
+        for (std::size_t i = 0; i < jobs.size(); ++i)
+        {
+            const auto& jobState = jobs[i].state;
+
+            const auto defaultOutputFilename = GetDefaultOutputFilename(jobState, filename);
+
+            auto outputFilename = jobState.outputFilename;
+            if (outputFilename.empty())
+                outputFilename = defaultOutputFilename;
+            else
+                Replace(outputFilename, "*", defaultOutputFilename);
+
+            outputFilenames.push_back(outputFilename);
+            outputStreams.emplace_back(MakeUnique<std::stringstream>());
+
+            auto outputDesc = jobState.outputDesc;
+            outputDesc.sourceCode = outputStreams.back().get();
+
+            if (jobState.showStats)
+                outputDesc.statistics = &statsList[i];
+
+            if (!jobState.bundleFilename.empty())
+                outputDesc.reflectionData = &reflections[i];
+
+            outputDescs.push_back(outputDesc);
+
+            PrintCompileStatus(jobState, filename, outputFilename);
+        }
+
+        /* Compile all variants from the shared AST */
+        auto result = CompileShaderVariants(state.inputDesc, outputDescs, &log);
+
+        if (result)
+        {
+            /* Write each variant to its output file (the log is cleared when the first job prints it) */
+            for (std::size_t i = 0; i < jobs.size(); ++i)
+                FinishCompileJob(jobs[i].state, filename, outputFilenames[i], log, result, statsList[i], *outputStreams[i], &reflections[i]);
+
+            /* Write make-style dependency files (the include closure is shared by all variants) */
+            for (std::size_t i = 0; i < jobs.size(); ++i)
+            {
+                if (!jobs[i].state.dependencyFilename.empty())
+                    WriteDependencyFile(jobs[i].state, filename, outputFilenames[i], includeHandler.includedFiles);
+            }
+        }
+        else
+        {
+            /* At least one variant failed; re-run the jobs individually, so each job reports its own result */
+            log.PrintAll(state.verbose, state.outputDesc.options.warnings);
+
+            for (const auto& job : jobs)
+                RunCompileJob(job);
+        }
+    }
+    catch (const std::exception& err)
+    {
+        /* Print error message */
+        output << err.what() << std::endl;
+    }
+}
+
+void Shell::CompileWatchedJob(WatchedJob& watchedJob)
+{
+    std::vector<std::string> includedFiles;
+    RunCompileJob(watchedJob.job, nullptr, &includedFiles);
+
+    /* Re-record the modification timestamps of the input file and its include closure */
+    watchedJob.timestamps.clear();
+    watchedJob.timestamps[watchedJob.job.filename] = FileModificationTime(watchedJob.job.filename);
+
+    for (const auto& file : includedFiles)
+        watchedJob.timestamps[file] = FileModificationTime(file);
+
+    /* Update the bundle archive and the wrapper preamble (if enabled) */
+    SaveBundle();
+    SavePreamble();
+}
+
+void Shell::FlushCompileQueue()
+{
+    if (compileQueue_.empty())
+        return;
+
+    /* Without parallel workers, the pipelined batch loop overlaps the file I/O with the compilation instead */
+    if (state_.numThreads <= 1)
+    {
+        FlushPipelinedQueue();
+        return;
+    }
+
+    auto numThreads = std::min(state_.numThreads, compileQueue_.size());
+
+    /* Each worker thread steals the next pending job from the shared queue */
+    std::atomic<std::size_t> nextJob;
+    nextJob.store(0);
+
+    std::mutex outputMutex;
+
+    auto worker = [&]()
+    {
+        while (true)
+        {
+            auto jobIndex = nextJob.fetch_add(1);
+            if (jobIndex >= compileQueue_.size())
+                break;
+            RunCompileJob(compileQueue_[jobIndex], &outputMutex);
+        }
+    };
+
+    /* Spawn the worker threads; the main thread participates as well */
+    std::vector<std::thread> workerThreads;
+    for (std::size_t i = 1; i < numThreads; ++i)
+        workerThreads.emplace_back(worker);
+
+    worker();
+
+    for (auto& thread : workerThreads)
+        thread.join();
+
+    compileQueue_.clear();
+}
+
+void Shell::FlushPipelinedQueue()
+{
+    struct PrefetchedFile
+    {
+        std::string content;
+        bool        valid   = false;
+    };
+
+    std::vector<PrefetchedFile> prefetched(compileQueue_.size());
+
+    std::mutex              prefetchMutex;
+    std::condition_variable prefetchChanged;
+    std::size_t             numPrefetched   = 0;
+    std::size_t             numConsumed     = 0;
+
+    /* Keep at most two files ahead of the compiler, so the read-ahead stays memory-bounded */
+    static const std::size_t maxReadAhead = 2;
+
+    auto prefetcher = [&]()
+    {
+        for (std::size_t i = 0; i < compileQueue_.size(); ++i)
+        {
+            /* Wait until the read-ahead window has room for the next file */
+            {
+                std::unique_lock<std::mutex> lock(prefetchMutex);
+                prefetchChanged.wait(
+                    lock,
+                    [&]()
+                    {
+                        return (i < numConsumed + maxReadAhead);
+                    }
+                );
+            }
+
+            /* Fetch the file content; a failed read falls through to the compiler, which reports it like before */
+            std::ifstream inputFile(compileQueue_[i].filename);
+            if (inputFile.good())
+            {
+                prefetched[i].content.assign(std::istreambuf_iterator<char>(inputFile), std::istreambuf_iterator<char>());
+                prefetched[i].valid = true;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(prefetchMutex);
+                ++numPrefetched;
+            }
+            prefetchChanged.notify_one();
+        }
+    };
+
+    OutputFlusher outputFlusher;
+    std::thread prefetchThread(prefetcher);
+
+    for (std::size_t i = 0; i < compileQueue_.size(); ++i)
+    {
+        /* Wait for the read-ahead of this file (usually already fetched during the previous compile) */
+        {
+            std::unique_lock<std::mutex> lock(prefetchMutex);
+            prefetchChanged.wait(
+                lock,
+                [&]()
+                {
+                    return (numPrefetched > i);
+                }
+            );
+        }
+
+        RunCompileJob(
+            compileQueue_[i], nullptr, nullptr, nullptr,
+            (prefetched[i].valid ? &prefetched[i].content : nullptr), &outputFlusher
+        );
+
+        /* Release the fetched content and open the read-ahead window for the next file */
+        prefetched[i].content.clear();
+        {
+            std::lock_guard<std::mutex> lock(prefetchMutex);
+            ++numConsumed;
+        }
+        prefetchChanged.notify_one();
+    }
+
+    prefetchThread.join();
+
+    /* Drain the background writes and report the failed ones */
+    for (const auto& filename : outputFlusher.Finish())
+        output << "failed to write file: \"" << filename << '\"' << std::endl;
+
+    compileQueue_.clear();
+}
+
+void Shell::ShowStats(const Statistics& stats)
+{
+    output << "statistics:" << std::endl;
+    indentHandler_.IncIndent();
+    {
+        ShowStatsFor( stats.macros,          "macros"                   );
+        ShowStatsFor( stats.textures,        "texture bindings"         );
+        ShowStatsFor( stats.constantBuffers, "constant buffer bindings" );
+        ShowStatsFor( stats.fragmentTargets, "fragment target bindings" );
+        ShowStatsFor( stats.samplerStates,   "sampler states"           );
+        ShowStatsFor( stats.techniques,      "techniques"               );
+        ShowStatsFor( stats.entryPoints,     "entry points"             );
+
+        /* Print output buffer counters (to verify the quality of the output size estimate) */
+        output << indentHandler_.FullIndent() << "output buffer:" << std::endl;
+        indentHandler_.IncIndent();
+        {
+            output << indentHandler_.FullIndent() << "estimated size: " << stats.estimatedOutputSize << " bytes" << std::endl;
+            output << indentHandler_.FullIndent() << "actual size:    " << stats.actualOutputSize << " bytes" << std::endl;
+        }
+        indentHandler_.DecIndent();
     }
     indentHandler_.DecIndent();
 }
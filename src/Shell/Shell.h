@@ -11,9 +11,18 @@
 
 #include <Xsc/IndentHandler.h>
 #include <Xsc/SamplerState.h>
+#include <Xsc/ShaderBundle.h>
+#include <Xsc/WrapperPreamble.h>
+#include <Xsc/CompilerInstance.h>
 #include "ShellState.h"
 #include "CommandLine.h"
 #include <ostream>
+#include <istream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <cstdint>
 
 
 namespace Xsc
@@ -23,6 +32,9 @@ namespace Util
 {
 
 
+// Asynchronous output writer of the pipelined batch loop (see PipelineCommand).
+class OutputFlusher;
+
 // The shell is the main class of the command line tool for the compiler.
 class Shell
 {
@@ -36,16 +48,96 @@ class Shell
 
         void ExecuteCommandLine(CommandLine& cmdLine);
 
+        // Executes the presetting command lines as one batch, sharing frontend work between compatible jobs (see PresettingCommand).
+        void ExecutePresettings(std::vector<CommandLine>& cmdLines);
+
+        // Returns true if the server mode was enabled on the command line (see ServerCommand).
+        bool ServerModeEnabled() const;
+
+        // Runs the resident server loop: executes one command line per input line, until EOF or an "exit" line.
+        void RunServer(std::istream& input);
+
+        // Returns the framing line that is printed after each server job, so clients can detect job completion.
+        static const char* GetServerSentinel();
+
+        // Returns true if the watch mode was enabled on the command line (see WatchCommand).
+        bool WatchModeEnabled() const;
+
+        // Runs the watch loop: recompiles each input file whenever it or one of its includes changes on disk.
+        void RunWatchLoop();
+
         void WaitForUser();
 
         std::ostream& output;
 
     private:
 
-        std::string GetDefaultOutputFilename(const std::string& filename);
+        // A single shader file compilation, with a snapshot of the shell state at the time the file was specified.
+        struct CompileJob
+        {
+            ShellState  state;
+            std::string filename;
+        };
+
+        // A watched compilation with the modification timestamps of its input file and include closure (see WatchCommand).
+        struct WatchedJob
+        {
+            CompileJob                              job;
+            std::map<std::string, std::uint64_t>    timestamps;
+        };
+
+        static std::string GetDefaultOutputFilename(const ShellState& state, const std::string& filename);
 
         void Compile(const std::string& filename);
 
+        void ExecuteSerializedJob(const std::string& filename);
+        void EmitJobFile(CompileJob job);
+
+        /*
+        Runs the server loop with the priority scheduler: worker threads with warm compiler instances
+        execute the queued job lines, interactive jobs first (see PriorityCommand).
+        */
+        void RunServerScheduler(std::istream& input);
+
+        // Executes one job line of the server scheduler against a snapshot of the base state, compiling with the specified warm instance.
+        void ExecuteServerJobLine(const std::string& line, ShellState state, CompilerInstance& compilerInstance, std::mutex& outputMutex);
+
+        void RunCompileJob(
+            CompileJob job, std::mutex* outputMutex = nullptr, std::vector<std::string>* trackedIncludes = nullptr,
+            CompilerInstance* compilerInstance = nullptr, const std::string* prefetchedSource = nullptr,
+            OutputFlusher* outputFlusher = nullptr
+        );
+        void RunCompileJobGroup(const std::vector<CompileJob>& jobs);
+        void FlushCompileQueue();
+
+        /*
+        Runs the queued jobs as a pipeline: a read-ahead thread fetches the input files ahead of the
+        compiler and a writer thread flushes the completed outputs, while this thread compiles
+        (see PipelineCommand).
+        */
+        void FlushPipelinedQueue();
+
+        void CompileWatchedJob(WatchedJob& watchedJob);
+
+        void PrintCompileStatus(const ShellState& state, const std::string& filename, const std::string& outputFilename);
+        void FinishCompileJob(
+            const ShellState& state, const std::string& filename, const std::string& outputFilename,
+            StdLog& log, bool result, const Statistics& stats, std::stringstream& outputStream,
+            const Reflection::ReflectionData* reflection = nullptr, OutputFlusher* outputFlusher = nullptr
+        );
+        void WriteDependencyFile(
+            const ShellState& state, const std::string& filename, const std::string& outputFilename,
+            const std::vector<std::string>& includedFiles
+        );
+        void AddToBundle(
+            const ShellState& state, const std::string& outputFilename,
+            std::stringstream& outputStream, const Reflection::ReflectionData* reflection
+        );
+        void SaveBundle();
+
+        void AttachPreamble(ShellState& state);
+        void SavePreamble();
+
         void ShowStats(const Statistics& stats);
         void ShowStatsFor(const std::vector<Statistics::Binding>& objects, const std::string& title);
         void ShowStatsFor(const std::vector<std::string>& idents, const std::string& title);
@@ -54,6 +146,42 @@ class Shell
         ShellState      state_;
         IndentHandler   indentHandler_;
 
+        // Pending compilation jobs for the parallel mode (see JobsCommand).
+        std::vector<CompileJob> compileQueue_;
+
+        // Watched compilation jobs for the watch mode (see WatchCommand).
+        std::vector<WatchedJob> watchQueue_;
+
+        // When enabled, "Compile" only records the jobs for grouped execution (see ExecutePresettings).
+        bool                    collectJobs_    = false;
+
+        // Jobs recorded for grouped execution.
+        std::vector<CompileJob> collectedJobs_;
+
+        // Shader bundle archive that collects the compiled outputs (see BundleCommand).
+        ShaderBundle            bundle_;
+
+        // Filename of the bundle archive; the first bundled job fixes it for the session.
+        std::string             bundleFilename_;
+
+        // True if the bundle has entries that are not saved to the archive file yet.
+        bool                    bundleDirty_    = false;
+
+        // Guards the bundle against concurrent jobs of the parallel mode (see JobsCommand).
+        std::mutex              bundleMutex_;
+
+        // Shared preamble of intrinsic wrapper functions (see PreambleCommand).
+        WrapperPreamble         preamble_;
+
+        // Filename of the preamble unit; the first preamble job fixes it for the session.
+        std::string             preambleFilename_;
+
+        // Number of wrappers the preamble file was last saved with, so unchanged preambles are not rewritten.
+        std::size_t             preambleSavedCount_ = 0;
+
+        // Guards the preamble filename and save counter (registration itself is synchronized by the preamble).
+        std::mutex              preambleMutex_;
+
         static Shell*   instance_;
 
 };
@@ -36,6 +36,24 @@ struct ShellState
     // Output filename (hint).
     std::string                     outputFilename;
 
+    // Filename for the make-style dependency file (empty to disable).
+    std::string                     dependencyFilename;
+
+    // Filename of the shader bundle archive that receives the compiled outputs (empty to write one file per output).
+    std::string                     bundleFilename;
+
+    // Filename of the shared preamble unit that receives the intrinsic wrapper functions (empty to write them inline).
+    std::string                     preambleFilename;
+
+    // Filename for the Chrome trace-event JSON output (empty to disable; requires the XSC_TRACE_EVENTS build option).
+    std::string                     traceFilename;
+
+    // Filename of the serialized compile job that receives each compilation instead of executing it (empty to compile).
+    std::string                     emitJobFilename;
+
+    // Filename for the binary AST dump output (empty to disable).
+    std::string                     astDumpFilename;
+
     // Predefined macros for the preprocessor
     std::vector<PredefinedMacro>    predefinedMacros;
 
@@ -50,6 +68,27 @@ struct ShellState
 
     // Show shader output statistics after compilation.
     bool                            showStats           = false;
+
+    // Number of worker threads for parallel compilation (0 and 1 mean sequential).
+    std::size_t                     numThreads          = 0;
+
+    // Pipeline the sequential batch loop: read input files ahead and flush outputs on a background I/O thread (see PipelineCommand).
+    bool                            pipelineMode        = false;
+
+    // Run the shell as a resident compile server, reading job command lines from the standard input.
+    bool                            serverMode          = false;
+
+    // Schedule the job in the batch priority class of the server scheduler; interactive jobs are dispatched first (see PriorityCommand).
+    bool                            batchPriority       = false;
+
+    // Client name for the fairness policy of the server scheduler; queued jobs rotate over the client names (see ClientCommand).
+    std::string                     serverClient;
+
+    // Watch the input files and their include closure, recompiling whenever one of them changes on disk.
+    bool                            watchMode           = false;
+
+    // Treat each input file as a serialized compile job: execute it and write its result blob.
+    bool                            jobMode             = false;
 };
 
 
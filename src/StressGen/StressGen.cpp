@@ -0,0 +1,297 @@
+/*
+ * StressGen.cpp
+ *
+ * This file is part of the XShaderCompiler project (Copyright (c) 2014-2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+/*
+Synthetic stress corpus generator: synthesizes HLSL shaders with controllable knobs
+(function count, expression depth, macro expansion factor, include fan-out), so that
+'xsc_bench' can chart scaling curves beyond the sizes of the hand-written test corpus.
+The output is deterministic for a fixed seed, so generated corpora are reproducible
+across machines and CI runs.
+*/
+
+/* ----- Generator options ----- */
+
+struct Options
+{
+    std::string     outputDir   = ".";          // Directory the generated files are written to.
+    std::string     name        = "stress";     // Base name of the generated files ("<name>.hlsl" and "<name>.incN.h").
+    std::size_t     functions   = 64;           // Number of generated helper functions.
+    std::size_t     exprDepth   = 8;            // Nesting depth of the expression chain in each function body.
+    std::size_t     macroFactor = 0;            // Number of macro doubling levels (expansion grows with 2^N).
+    std::size_t     includes    = 0;            // Number of include files the helper functions are distributed over.
+    unsigned int    seed        = 1;            // Seed of the deterministic random sequence.
+};
+
+/* ----- Deterministic random sequence ----- */
+
+// Plain LCG instead of <random>, so the generated corpus is identical across standard library implementations.
+static unsigned int g_randomState = 1;
+
+static unsigned int NextRandom()
+{
+    g_randomState = g_randomState * 1664525u + 1013904223u;
+    return (g_randomState >> 16);
+}
+
+/* ----- Source synthesis ----- */
+
+static std::string FunctionName(std::size_t index)
+{
+    return "StressFunc" + std::to_string(index);
+}
+
+static std::string GenerateExprLeaf(std::size_t macroFactor)
+{
+    switch (NextRandom() % 3)
+    {
+        case 0:
+            return "x";
+        case 1:
+            return std::to_string(NextRandom() % 8) + "." + std::to_string(NextRandom() % 10);
+        default:
+            return (macroFactor > 0 ? "XSG_M" + std::to_string(macroFactor - 1) + "(x)" : "(x * 0.5)");
+    }
+}
+
+// Returns a right-leaning expression chain of the specified depth (built iteratively, so its size stays linear in the depth).
+static std::string GenerateExprChain(std::size_t depth, std::size_t macroFactor)
+{
+    static const char* operators[] = { "+", "-", "*" };
+
+    auto expr = GenerateExprLeaf(macroFactor);
+
+    for (std::size_t i = 0; i < depth; ++i)
+        expr = "(" + GenerateExprLeaf(macroFactor) + " " + operators[NextRandom() % 3] + " " + expr + ")";
+
+    return expr;
+}
+
+// Appends the definition of the specified helper function; each function calls its predecessor to keep the whole chain live.
+static void GenerateFunction(std::ostream& stream, std::size_t index, const Options& options)
+{
+    stream << "float " << FunctionName(index) << "(float x)" << std::endl;
+    stream << "{" << std::endl;
+
+    if (index > 0)
+        stream << "    x += " << FunctionName(index - 1) << "(x);" << std::endl;
+
+    stream << "    return " << GenerateExprChain(options.exprDepth, options.macroFactor) << ";" << std::endl;
+    stream << "}" << std::endl;
+    stream << std::endl;
+}
+
+// Appends the macro doubling ladder: each level expands to two instances of the previous one, so expansion grows with 2^N.
+static void GenerateMacros(std::ostream& stream, std::size_t macroFactor)
+{
+    if (macroFactor == 0)
+        return;
+
+    stream << "#define XSG_SCALE(x) ((x) * 0.999 + 0.001)" << std::endl;
+    stream << "#define XSG_M0(x) XSG_SCALE(x)" << std::endl;
+
+    for (std::size_t i = 1; i < macroFactor; ++i)
+    {
+        stream
+            << "#define XSG_M" << i << "(x) XSG_M" << (i - 1)
+            << "(XSG_M" << (i - 1) << "(x))" << std::endl;
+    }
+
+    stream << std::endl;
+}
+
+static bool WriteTextFile(const std::string& filename, const std::string& content)
+{
+    std::ofstream file(filename);
+
+    if (!file.good())
+        return false;
+
+    file << content;
+    return file.good();
+}
+
+/*
+Generates the corpus entry "<name>.hlsl" (plus its include files) into the output directory.
+The helper functions are distributed over the include files in contiguous, ordered chunks,
+since each function calls its predecessor.
+*/
+static bool GenerateCorpusEntry(const Options& options)
+{
+    g_randomState = options.seed;
+
+    /* Distribute the leading functions over the include files */
+    std::size_t functionsPerInclude = 0;
+
+    if (options.includes > 0)
+        functionsPerInclude = options.functions / (options.includes + 1);
+
+    std::size_t nextFunction = 0;
+
+    for (std::size_t i = 0; i < options.includes; ++i)
+    {
+        std::ostringstream stream;
+
+        stream << "// Generated by xsc_stressgen (seed " << options.seed << ")" << std::endl;
+        stream << std::endl;
+
+        for (std::size_t j = 0; j < functionsPerInclude && nextFunction < options.functions; ++j)
+            GenerateFunction(stream, nextFunction++, options);
+
+        const auto filename = options.outputDir + "/" + options.name + ".inc" + std::to_string(i) + ".h";
+
+        if (!WriteTextFile(filename, stream.str()))
+        {
+            std::cerr << "failed to write file: \"" << filename << "\"" << std::endl;
+            return false;
+        }
+    }
+
+    /* Generate the main file with the remaining functions and the entry points */
+    std::ostringstream stream;
+
+    stream << "// Generated by xsc_stressgen (seed " << options.seed << ")" << std::endl;
+    stream << "// functions: " << options.functions << ", expression depth: " << options.exprDepth;
+    stream << ", macro factor: " << options.macroFactor << ", includes: " << options.includes << std::endl;
+    stream << std::endl;
+
+    GenerateMacros(stream, options.macroFactor);
+
+    for (std::size_t i = 0; i < options.includes; ++i)
+        stream << "#include \"" << options.name << ".inc" << i << ".h\"" << std::endl;
+
+    if (options.includes > 0)
+        stream << std::endl;
+
+    while (nextFunction < options.functions)
+        GenerateFunction(stream, nextFunction++, options);
+
+    const auto lastFunction = (options.functions > 0 ? FunctionName(options.functions - 1) + "(pos.x)" : "pos.x");
+
+    stream << "float4 VS(float4 pos : POSITION) : SV_Position" << std::endl;
+    stream << "{" << std::endl;
+    stream << "    float x = " << lastFunction << ";" << std::endl;
+    stream << "    return float4(x, x, x, 1.0);" << std::endl;
+    stream << "}" << std::endl;
+    stream << std::endl;
+    stream << "float4 PS(float4 pos : SV_Position) : SV_Target" << std::endl;
+    stream << "{" << std::endl;
+    stream << "    float x = " << (options.functions > 0 ? FunctionName(options.functions - 1) + "(pos.x)" : "pos.x") << ";" << std::endl;
+    stream << "    return float4(x, x, x, 1.0);" << std::endl;
+    stream << "}" << std::endl;
+
+    const auto filename = options.outputDir + "/" + options.name + ".hlsl";
+    const auto content = stream.str();
+
+    if (!WriteTextFile(filename, content))
+    {
+        std::cerr << "failed to write file: \"" << filename << "\"" << std::endl;
+        return false;
+    }
+
+    std::cout
+        << "generated \"" << filename << "\" (" << content.size() << " bytes, "
+        << options.functions << " functions, " << options.includes << " includes)" << std::endl;
+
+    return true;
+}
+
+/* ----- Program entry ----- */
+
+static void PrintUsage()
+{
+    std::cout << "Usage:" << std::endl;
+    std::cout << "  xsc_stressgen [OPTIONS]" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  -o DIR ............. Output directory of the generated files (default '.')" << std::endl;
+    std::cout << "  --name NAME ........ Base name of the generated files (default 'stress')" << std::endl;
+    std::cout << "  --functions N ...... Number of generated helper functions (default 64)" << std::endl;
+    std::cout << "  --expr-depth N ..... Nesting depth of the expression chain per function (default 8)" << std::endl;
+    std::cout << "  --macro-factor N ... Macro doubling levels; expansion grows with 2^N (default 0)" << std::endl;
+    std::cout << "  --includes N ....... Number of include files the functions are spread over (default 0)" << std::endl;
+    std::cout << "  --seed N ........... Seed of the deterministic random sequence (default 1)" << std::endl;
+    std::cout << "  --help ............. Prints this help text" << std::endl;
+    std::cout << "Remarks:" << std::endl;
+    std::cout << "  Generates '<name>.hlsl' (with 'VS' and 'PS' entry points) and '<name>.incN.h'" << std::endl;
+    std::cout << "  include files, to be compiled with 'xsc -I DIR' or benchmarked with 'xsc_bench'." << std::endl;
+}
+
+static bool ParseSizeArgument(int argc, char** argv, int& i, std::size_t& value)
+{
+    if (i + 1 >= argc)
+        return false;
+    value = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        bool ok = true;
+
+        if (arg == "--help" || arg == "-h")
+        {
+            PrintUsage();
+            return 0;
+        }
+        else if (arg == "-o")
+        {
+            if ((ok = (i + 1 < argc)) == true)
+                options.outputDir = argv[++i];
+        }
+        else if (arg == "--name")
+        {
+            if ((ok = (i + 1 < argc)) == true)
+                options.name = argv[++i];
+        }
+        else if (arg == "--functions")
+            ok = ParseSizeArgument(argc, argv, i, options.functions);
+        else if (arg == "--expr-depth")
+            ok = ParseSizeArgument(argc, argv, i, options.exprDepth);
+        else if (arg == "--macro-factor")
+            ok = ParseSizeArgument(argc, argv, i, options.macroFactor);
+        else if (arg == "--includes")
+            ok = ParseSizeArgument(argc, argv, i, options.includes);
+        else if (arg == "--seed")
+        {
+            std::size_t seed = 0;
+            ok = ParseSizeArgument(argc, argv, i, seed);
+            options.seed = static_cast<unsigned int>(seed);
+        }
+        else
+        {
+            std::cerr << "unknown option: \"" << arg << "\" (see --help)" << std::endl;
+            return 1;
+        }
+
+        if (!ok)
+        {
+            std::cerr << "missing argument for option: \"" << arg << "\"" << std::endl;
+            return 1;
+        }
+    }
+
+    if (!GenerateCorpusEntry(options))
+        return 2;
+
+    return 0;
+}
+
+
+
+// ================================================================================